@@ -51,6 +51,26 @@ struct GlobalAligner : public SingleRefAlignerBase<ScoreType>
         const SymIter refBegin, const SymIter refEnd,
         AlignmentResult<ScoreType>& result) const;
 
+    /// returns the same alignment path of query to reference as align(), restricting most of the search to a
+    /// diagonal band of the alignment matrix
+    ///
+    /// the band includes all paths with at most bandOffset net query/reference indel (or clipped) positions beyond
+    /// the query/reference length difference. The banded search is repeated with a wider band, up to maxBandOffset,
+    /// until the banded result can be proven to be the highest scoring path with the same backtrace as the full
+    /// search. If this fails the full alignment matrix is searched.
+    ///
+    /// banding is only used with the isRequireEdgeDeletion option, which anchors the query to the start of the
+    /// reference, otherwise this is equivalent to align()
+    ///
+    /// \param maxBandOffset maximum band offset to search before falling back to the full alignment matrix
+    template <typename SymIter>
+    void
+    alignBanded(
+        const SymIter queryBegin, const SymIter queryEnd,
+        const SymIter refBegin, const SymIter refEnd,
+        const unsigned maxBandOffset,
+        AlignmentResult<ScoreType>& result) const;
+
 private:
 
     // insert and delete are for query wrt reference
@@ -113,11 +133,89 @@ private:
         code_t ins : 2;
     };
 
-    // add the matrices here to reduce allocations over many alignment calls:
+    /// backtrace pointers for cells within a diagonal band of the alignment matrix, where diagonal
+    /// offset is (queryIndex - refIndex)
+    struct BandedPtrMatrix
+    {
+        void
+        resize(
+            const unsigned refSize,
+            const int minOffset,
+            const int maxOffset)
+        {
+            assert(minOffset <= maxOffset);
+            _minOffset=minOffset;
+            _bandWidth=(maxOffset-minOffset)+1;
+            _data.resize((refSize+1)*_bandWidth);
+        }
+
+        PtrVal&
+        val(const unsigned queryIndex,
+            const unsigned refIndex)
+        {
+            return _data[getIndex(queryIndex,refIndex)];
+        }
+
+        const PtrVal&
+        val(const unsigned queryIndex,
+            const unsigned refIndex) const
+        {
+            return _data[getIndex(queryIndex,refIndex)];
+        }
+
+    private:
+        unsigned
+        getIndex(
+            const unsigned queryIndex,
+            const unsigned refIndex) const
+        {
+            const int bandIndex(static_cast<int>(queryIndex)-static_cast<int>(refIndex)-_minOffset);
+            assert((bandIndex >= 0) && (bandIndex < static_cast<int>(_bandWidth)));
+            return (refIndex*_bandWidth+bandIndex);
+        }
+
+        int _minOffset = 0;
+        unsigned _bandWidth = 0;
+        std::vector<PtrVal> _data;
+    };
+
     typedef std::vector<ScoreVal> ScoreVec;
+
+    /// score used for disallowed alignment states
+    static const ScoreType badVal;
+
+    /// update all states of one cell of the alignment matrix
+    ///
+    /// \param diagScore scores of the cell at (queryIndex-1,refIndex-1)
+    /// \param refPrevScore scores of the cell at (queryIndex,refIndex-1)
+    /// \param queryPrevScore scores of the cell at (queryIndex-1,refIndex)
+    void
+    updateCell(
+        const bool isMatch,
+        const bool isFirstRef,
+        const bool isFirstQuery,
+        const ScoreVal& diagScore,
+        const ScoreVal& refPrevScore,
+        const ScoreVal& queryPrevScore,
+        ScoreVal& headScore,
+        PtrVal& headPtr) const;
+
+    /// run the banded search once for a single band offset
+    ///
+    /// \return true if the result is proven to match the full alignment
+    template <typename SymIter>
+    bool
+    alignBand(
+        const SymIter queryBegin, const SymIter queryEnd,
+        const SymIter refBegin, const SymIter refEnd,
+        const unsigned bandOffset,
+        AlignmentResult<ScoreType>& result) const;
+
+    // add the matrices here to reduce allocations over many alignment calls:
     mutable ScoreVec _score1;
     mutable ScoreVec _score2;
     mutable basic_matrix<PtrVal> _ptrMat;
+    mutable BandedPtrMatrix _bandPtrMat;
 };
 
 
@@ -21,7 +21,10 @@
 /// derived from ELAND implementation by Tony Cox
 
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <cstdlib>
 
 #ifdef DEBUG_ALN
 #include "blt_util/log.hh"
@@ -30,6 +33,58 @@
 
 
 
+template <typename ScoreType>
+const ScoreType GlobalAligner<ScoreType>::badVal(-10000);
+
+
+
+template <typename ScoreType>
+void
+GlobalAligner<ScoreType>::
+updateCell(
+    const bool isMatch,
+    const bool isFirstRef,
+    const bool isFirstQuery,
+    const ScoreVal& diagScore,
+    const ScoreVal& refPrevScore,
+    const ScoreVal& queryPrevScore,
+    ScoreVal& headScore,
+    PtrVal& headPtr) const
+{
+    const AlignmentScores<ScoreType>& scores(this->getScores());
+
+    // update match
+    headPtr.match = this->max3(
+                        headScore.match,
+                        diagScore.match,
+                        diagScore.del,
+                        diagScore.ins);
+
+    headScore.match += (isMatch ? scores.match : scores.mismatch);
+
+    // update delete
+    headPtr.del = this->max3(
+                      headScore.del,
+                      refPrevScore.match + scores.open,
+                      refPrevScore.del,
+                      refPrevScore.ins + scores.insertDelete);
+
+    headScore.del += scores.extend;
+    if (isFirstRef) headScore.del = badVal;
+
+    // update insert
+    headPtr.ins = this->max3(
+                      headScore.ins,
+                      queryPrevScore.match + scores.open,
+                      badVal,
+                      queryPrevScore.ins);
+
+    headScore.ins += scores.extend;
+    if (isFirstQuery) headScore.ins = badVal;
+}
+
+
+
 template <typename ScoreType>
 template <typename SymIter>
 void
@@ -56,8 +111,6 @@ align(
     ScoreVec* thisSV(&_score1);
     ScoreVec* prevSV(&_score2);
 
-    static const ScoreType badVal(-10000);
-
 #if 0
     auto safeScore = [&] (const int score) -> ScoreType
     {
@@ -132,45 +185,11 @@ align(
             unsigned queryIndex(0);
             for (SymIter queryIter(queryBegin); queryIter != queryEnd; ++queryIter, ++queryIndex)
             {
-                // update match
                 ScoreVal& headScore((*thisSV)[queryIndex+1]);
                 PtrVal& headPtr(_ptrMat.val(queryIndex+1,refIndex+1));
-                {
-                    const ScoreVal& sval((*prevSV)[queryIndex]);
-                    headPtr.match = this->max3(
-                                        headScore.match,
-                                        sval.match,
-                                        sval.del,
-                                        sval.ins);
-
-                    headScore.match += ((*queryIter==*refIter) ? scores.match : scores.mismatch);
-                }
-
-                // update delete
-                {
-                    const ScoreVal& sval((*prevSV)[queryIndex+1]);
-                    headPtr.del = this->max3(
-                                      headScore.del,
-                                      sval.match + scores.open,
-                                      sval.del,
-                                      sval.ins + scores.insertDelete);
-
-                    headScore.del += scores.extend;
-                    if (0==refIndex) headScore.del = badVal;
-                }
-
-                // update insert
-                {
-                    const ScoreVal& sval((*thisSV)[queryIndex]);
-                    headPtr.ins = this->max3(
-                                      headScore.ins,
-                                      sval.match + scores.open,
-                                      badVal,
-                                      sval.ins);
-
-                    headScore.ins += scores.extend;
-                    if (0==queryIndex) headScore.ins = badVal;
-                }
+                updateCell((*queryIter==*refIter), (0==refIndex), (0==queryIndex),
+                           (*prevSV)[queryIndex], (*prevSV)[queryIndex+1], (*thisSV)[queryIndex],
+                           headScore, headPtr);
 
 #ifdef DEBUG_ALN
                 log_os << "i1i2: " << queryIndex+1 << " " << refIndex+1 << "\n";
@@ -234,3 +253,202 @@ align(
         btrace, result);
 }
 
+
+
+
+template <typename ScoreType>
+template <typename SymIter>
+bool
+GlobalAligner<ScoreType>::
+alignBand(
+    const SymIter queryBegin, const SymIter queryEnd,
+    const SymIter refBegin, const SymIter refEnd,
+    const unsigned bandOffset,
+    AlignmentResult<ScoreType>& result) const
+{
+    result.clear();
+
+    const AlignmentScores<ScoreType>& scores(this->getScores());
+    assert(scores.isRequireEdgeDeletion);
+
+    const int querySize(std::distance(queryBegin, queryEnd));
+    const int refSize(std::distance(refBegin, refEnd));
+
+    // the band is the range of diagonal offsets (queryIndex - refIndex) searched for each reference position:
+    const int sizeDiff(querySize-refSize);
+    const int minOffset(std::min(0,sizeDiff)-static_cast<int>(bandOffset));
+    const int maxOffset(std::max(0,sizeDiff)+static_cast<int>(bandOffset));
+
+    _score1.resize(querySize+1);
+    _score2.resize(querySize+1);
+    _bandPtrMat.resize(refSize, minOffset, maxOffset);
+
+    ScoreVec* thisSV(&_score1);
+    ScoreVec* prevSV(&_score2);
+
+    ScoreVal badScore;
+    badScore.match = badVal;
+    badScore.del = badVal;
+    badScore.ins = badVal;
+
+    // first query index in band for reference index refIndex, and one past the last:
+    auto getBandBegin = [&](const int refIndex)
+    {
+        return std::max(0, refIndex+minOffset);
+    };
+    auto getBandEnd = [&](const int refIndex)
+    {
+        return std::min(querySize, refIndex+maxOffset)+1;
+    };
+
+    // initialize the first reference column as in align(), cells outside of the band are set to badVal:
+    {
+        const int bandEnd(getBandEnd(0));
+        for (int queryIndex(0); queryIndex<bandEnd; queryIndex++)
+        {
+            PtrVal& headPtr(_bandPtrMat.val(queryIndex,0));
+            ScoreVal& val((*thisSV)[queryIndex]);
+            headPtr.match = AlignState::MATCH;
+            val.match = queryIndex * scores.offEdge;
+            headPtr.del = AlignState::MATCH;
+            val.del = badVal;
+            if (not scores.isAllowEdgeInsertion)
+            {
+                headPtr.ins = AlignState::MATCH;
+                val.ins = badVal;
+            }
+            else
+            {
+                headPtr.ins = AlignState::INSERT;
+                val.ins = scores.open + (queryIndex * scores.extend);
+            }
+        }
+        if (bandEnd <= querySize) (*thisSV)[bandEnd] = badScore;
+    }
+
+    {
+        int refIndex(0);
+        for (SymIter refIter(refBegin); refIter != refEnd; ++refIter, ++refIndex)
+        {
+            std::swap(thisSV,prevSV);
+
+            const int bandBegin(getBandBegin(refIndex+1));
+            const int bandEnd(getBandEnd(refIndex+1));
+
+            if (0 == bandBegin)
+            {
+                // require start from delete state
+                PtrVal& headPtr(_bandPtrMat.val(0,refIndex+1));
+                ScoreVal& val((*thisSV)[0]);
+                headPtr.match = AlignState::MATCH;
+                val.match = badVal;
+                headPtr.del = AlignState::DELETE;
+                val.del = scores.open + ((refIndex+1) * scores.extend);
+                headPtr.ins = AlignState::MATCH;
+                val.ins = badVal;
+            }
+            else
+            {
+                (*thisSV)[bandBegin-1] = badScore;
+            }
+
+            int queryIndex(std::max(1,bandBegin)-1);
+            SymIter queryIter(queryBegin);
+            std::advance(queryIter, queryIndex);
+            for (; (queryIndex+1)<bandEnd; ++queryIter, ++queryIndex)
+            {
+                ScoreVal& headScore((*thisSV)[queryIndex+1]);
+                PtrVal& headPtr(_bandPtrMat.val(queryIndex+1,refIndex+1));
+                updateCell((*queryIter==*refIter), (0==refIndex), (0==queryIndex),
+                           (*prevSV)[queryIndex], (*prevSV)[queryIndex+1], (*thisSV)[queryIndex],
+                           headScore, headPtr);
+            }
+
+            if (bandEnd <= querySize) (*thisSV)[bandEnd] = badScore;
+        }
+    }
+
+    BackTrace<ScoreType> btrace;
+
+    // the band always includes the cell at (querySize,refSize):
+    {
+        const ScoreVal& sval((*thisSV)[querySize]);
+        updateBacktrace(sval.match,refSize,querySize,btrace, AlignState::MATCH);
+        updateBacktrace(sval.del,refSize,querySize,btrace, AlignState::DELETE);
+        if (scores.isAllowEdgeInsertion)
+        {
+            updateBacktrace(sval.ins,refSize,querySize,btrace, AlignState::INSERT);
+        }
+    }
+
+    for (int queryIndex(getBandBegin(refSize)); queryIndex<querySize; queryIndex++)
+    {
+        const ScoreVal& sval((*thisSV)[queryIndex]);
+        const ScoreType thisMax(sval.match + (querySize-queryIndex) * scores.offEdge);
+        updateBacktrace(thisMax,refSize,queryIndex,btrace);
+    }
+
+    // Any path through a cell outside of the band includes at least minOutsideLength inserted, deleted or clipped
+    // positions, each of which scores no more than maxGapScore. Such a path also has no more than
+    // (querySize+refSize-minOutsideLength)/2 aligned positions. If the banded result scores higher than this bound
+    // then all paths outside of the band score less than the banded result, and none of them can change the
+    // backtrace.
+    //
+    const int64_t maxGapScore(std::max(scores.extend, scores.offEdge));
+    const int64_t maxAlignedScore(std::max(0, static_cast<int>(std::max(scores.match, scores.mismatch))));
+    const int64_t minOutsideLength(std::abs(sizeDiff)+2*(static_cast<int64_t>(bandOffset)+1));
+    const int64_t maxOutsideScore(maxAlignedScore*((querySize+refSize-minOutsideLength)/2) +
+                                  maxGapScore*minOutsideLength);
+
+    if (static_cast<int64_t>(btrace.max) <= maxOutsideScore) return false;
+
+    this->backTraceAlignment(
+        queryBegin, queryEnd,
+        refBegin, refEnd,
+        querySize, refSize,
+        _bandPtrMat,
+        btrace, result);
+
+    return true;
+}
+
+
+
+template <typename ScoreType>
+template <typename SymIter>
+void
+GlobalAligner<ScoreType>::
+alignBanded(
+    const SymIter queryBegin, const SymIter queryEnd,
+    const SymIter refBegin, const SymIter refEnd,
+    const unsigned maxBandOffset,
+    AlignmentResult<ScoreType>& result) const
+{
+    const AlignmentScores<ScoreType>& scores(this->getScores());
+
+    // the out-of-band score bound requires that no path can gain score from a gap or off-edge position:
+    const bool isBandable(scores.isRequireEdgeDeletion &&
+                          (scores.open <= 0) && (scores.extend < 0) && (scores.offEdge < 0) &&
+                          (scores.insertDelete <= 0));
+
+    if (isBandable)
+    {
+        const unsigned querySize(std::distance(queryBegin, queryEnd));
+        const unsigned refSize(std::distance(refBegin, refEnd));
+        const unsigned fullBandOffset(std::max(querySize, refSize));
+
+        // start from a narrow band, which is sufficient for most closely matching sequences:
+        static const unsigned minBandOffset(2);
+        static const unsigned bandOffsetFactor(4);
+
+        unsigned bandOffset(std::min(minBandOffset, maxBandOffset));
+        while (bandOffset < fullBandOffset)
+        {
+            if (alignBand(queryBegin, queryEnd, refBegin, refEnd, bandOffset, result)) return;
+            if (bandOffset >= maxBandOffset) break;
+            bandOffset = std::min(bandOffset*bandOffsetFactor, maxBandOffset);
+        }
+    }
+
+    align(queryBegin, queryEnd, refBegin, refEnd, result);
+}
@@ -28,6 +28,7 @@
 
 #include "blt_util/align_path.hh"
 
+#include <random>
 #include <string>
 
 
@@ -351,4 +352,128 @@ BOOST_AUTO_TEST_CASE( test_GlobalAlignerNoClipEdgeIndelInsertDelete )
 }
 
 
+/// create a randomly mutated copy of ref, with a mix of SNVs, indels and repeat expansions/contractions
+static
+std::string
+mutateSequence(
+    const std::string& ref,
+    std::mt19937& rng)
+{
+    static const char bases[] = "ACGT";
+    std::uniform_int_distribution<unsigned> baseDist(0,3);
+    std::uniform_int_distribution<unsigned> eventDist(0,39);
+    std::uniform_int_distribution<unsigned> lengthDist(1,12);
+
+    std::string seq;
+    for (unsigned refIndex(0); refIndex<ref.size(); ++refIndex)
+    {
+        const unsigned event(eventDist(rng));
+        if      (event == 0)
+        {
+            seq.push_back(bases[baseDist(rng)]);
+        }
+        else if (event == 1)
+        {
+            // deletion:
+            refIndex += lengthDist(rng);
+        }
+        else if (event == 2)
+        {
+            // insertion:
+            const unsigned length(lengthDist(rng));
+            for (unsigned i(0); i<length; ++i) seq.push_back(bases[baseDist(rng)]);
+            seq.push_back(ref[refIndex]);
+        }
+        else if (event == 3)
+        {
+            // duplicate the preceding reference sequence:
+            const unsigned length(std::min(lengthDist(rng),refIndex+1));
+            seq += ref.substr(refIndex+1-length,length);
+            seq.push_back(ref[refIndex]);
+        }
+        else
+        {
+            seq.push_back(ref[refIndex]);
+        }
+    }
+    if (seq.empty()) seq.push_back(bases[baseDist(rng)]);
+    return seq;
+}
+
+
+
+/// check that banded and full alignment results are identical for random sequences
+static
+void
+testBandedAlignerEquivalence(
+    const AlignmentScores<score_t>& scores)
+{
+    static const unsigned maxBandOffsets[] = { 0, 1, 8, 50 };
+    static const unsigned caseCount(300);
+
+    GlobalAligner<score_t> aligner(scores);
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<unsigned> baseDist(0,3);
+    std::uniform_int_distribution<unsigned> sizeDist(1,150);
+    std::uniform_int_distribution<unsigned> repeatUnitDist(1,4);
+
+    for (unsigned caseIndex(0); caseIndex<caseCount; ++caseIndex)
+    {
+        // build random references with a mixture of unique and tandem repeat sequence:
+        const unsigned refSize(sizeDist(rng));
+        const unsigned repeatUnitSize((caseIndex%2 == 0) ? refSize : repeatUnitDist(rng));
+        std::string refSeq;
+        for (unsigned refIndex(0); refIndex<refSize; ++refIndex)
+        {
+            refSeq.push_back((refIndex<repeatUnitSize) ? "ACGT"[baseDist(rng)] : refSeq[refIndex-repeatUnitSize]);
+        }
+        const std::string& ref(refSeq);
+        const std::string seq(mutateSequence(ref,rng));
+
+        AlignmentResult<score_t> expect;
+        aligner.align(seq.begin(),seq.end(),ref.begin(),ref.end(),expect);
+
+        for (const unsigned maxBandOffset : maxBandOffsets)
+        {
+            AlignmentResult<score_t> result;
+            aligner.alignBanded(seq.begin(),seq.end(),ref.begin(),ref.end(),maxBandOffset,result);
+
+            BOOST_REQUIRE_EQUAL(result.score,expect.score);
+            BOOST_REQUIRE_EQUAL(result.align.beginPos,expect.align.beginPos);
+            BOOST_REQUIRE_EQUAL(apath_to_cigar(result.align.apath),apath_to_cigar(expect.align.apath));
+        }
+    }
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_GlobalAlignerBandedEquivalence )
+{
+    // active region haplotype alignment scores:
+    testBandedAlignerEquivalence(AlignmentScores<score_t>(1, -4, -5, -1, -100, -5, true, true));
+
+    testBandedAlignerEquivalence(AlignmentScores<score_t>(2, -4, -5, -1, -4, 0, false, true));
+
+    // banding is not used without isRequireEdgeDeletion, but results should still be identical:
+    testBandedAlignerEquivalence(AlignmentScores<score_t>(2, -4, -5, -1, -4));
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_GlobalAlignerBandedLargeIndel )
+{
+    // a large deletion can't be found in a narrow band, so the aligner should fall back to the full search:
+    static const std::string seq("ACGTTGCAAGGCTTAACCGGATCG");
+    static const std::string ref("ACGTTGCAAGGCTTCATGCATGCATGCATGCATGCAACCGGATCG");
+
+    AlignmentScores<score_t> scores(1, -4, -5, -1, -100, -5, true, true);
+    GlobalAligner<score_t> aligner(scores);
+    AlignmentResult<score_t> result;
+    aligner.alignBanded(seq.begin(),seq.end(),ref.begin(),ref.end(),4,result);
+
+    BOOST_REQUIRE_EQUAL(apath_to_cigar(result.align.apath),"14=21D10=");
+    BOOST_REQUIRE_EQUAL(result.align.beginPos,0);
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,105 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#include "CSMOptions.hh"
+
+#include "blt_util/log.hh"
+#include "common/ProgramUtil.hh"
+#include "options/optionsUtil.hh"
+
+#include "boost/program_options.hpp"
+
+#include <iostream>
+
+
+
+static
+void
+usage(
+    std::ostream& os,
+    const illumina::Program& prog,
+    const boost::program_options::options_description& visible,
+    const char* msg = nullptr)
+{
+    usage(os, prog, visible, "Convert json variant scoring models to the binary scoring model format", "", msg);
+}
+
+
+
+void
+parseCSMOptions(
+    const illumina::Program& prog,
+    int argc, char* argv[],
+    CSMOptions& opt)
+{
+    namespace po = boost::program_options;
+    po::options_description req("configuration");
+
+    req.add_options()
+    ("model-file", po::value(&opt.jsonModelFilename),
+     "input json scoring model file (required)")
+    ("output-file", po::value(&opt.outputFilename),
+     "binary scoring model output file")
+    ("check-binary-file", po::value(&opt.checkBinaryFilename),
+     "instead of converting, check that this binary scoring model file was converted from the input json file");
+
+    po::options_description help("help");
+    help.add_options()
+    ("help,h","print this message");
+
+    po::options_description visible("options");
+    visible.add(req).add(help);
+
+    bool po_parse_fail(false);
+    po::variables_map vm;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, visible,
+                                         po::command_line_style::unix_style ^ po::command_line_style::allow_short), vm);
+        po::notify(vm);
+    }
+    catch (const boost::program_options::error& e)
+    {
+        log_os << "\nERROR: Exception thrown by option parser: " << e.what() << "\n";
+        po_parse_fail=true;
+    }
+
+    if ((argc<=1) || (vm.count("help")) || po_parse_fail)
+    {
+        usage(log_os,prog,visible);
+    }
+
+    std::string errorMsg;
+    if      (checkStandardizeInputFile(opt.jsonModelFilename, "json scoring model", errorMsg))
+    {
+    }
+    else if (opt.outputFilename.empty() == opt.checkBinaryFilename.empty())
+    {
+        errorMsg = "Must specify exactly one of output-file or check-binary-file";
+    }
+    else if ((! opt.checkBinaryFilename.empty()) and
+             checkStandardizeInputFile(opt.checkBinaryFilename, "binary scoring model", errorMsg))
+    {
+    }
+
+    if (! errorMsg.empty())
+    {
+        usage(log_os, prog, visible, errorMsg.c_str());
+    }
+}
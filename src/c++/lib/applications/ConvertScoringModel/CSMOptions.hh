@@ -0,0 +1,44 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#pragma once
+
+#include "common/Program.hh"
+
+#include <string>
+
+
+struct CSMOptions
+{
+    /// input json scoring model file
+    std::string jsonModelFilename;
+
+    /// binary scoring model output file
+    std::string outputFilename;
+
+    /// if set, check that this binary scoring model file was converted from the json model instead of converting
+    std::string checkBinaryFilename;
+};
+
+
+void
+parseCSMOptions(
+    const illumina::Program& prog,
+    int argc, char* argv[],
+    CSMOptions& opt);
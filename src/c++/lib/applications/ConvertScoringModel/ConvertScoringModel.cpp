@@ -0,0 +1,68 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#include "ConvertScoringModel.hh"
+#include "CSMOptions.hh"
+
+#include "blt_util/Fnv1aChecksum.hh"
+#include "calibration/BinaryScoringModelFile.hh"
+#include "common/Exceptions.hh"
+
+#include <sstream>
+
+
+
+static
+void
+checkBinaryModel(const CSMOptions& opt)
+{
+    uint64_t jsonSize(0);
+    const uint64_t jsonChecksum(getFileChecksum(opt.jsonModelFilename, jsonSize));
+
+    const BinaryScoringModelFile binaryModel(opt.checkBinaryFilename);
+    const auto& header(binaryModel.header());
+    if ((header.sourceChecksum != jsonChecksum) or (header.sourceSize != jsonSize))
+    {
+        using namespace illumina::common;
+
+        std::ostringstream oss;
+        oss << "ERROR: binary scoring model file '" << opt.checkBinaryFilename
+            << "' was not converted from json scoring model file '" << opt.jsonModelFilename << "'";
+        BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+    }
+}
+
+
+
+void
+ConvertScoringModel::
+runInternal(int argc, char* argv[]) const
+{
+    CSMOptions opt;
+
+    parseCSMOptions(*this,argc,argv,opt);
+    if (opt.checkBinaryFilename.empty())
+    {
+        convertScoringModelFile(opt.jsonModelFilename, opt.outputFilename);
+    }
+    else
+    {
+        checkBinaryModel(opt);
+    }
+}
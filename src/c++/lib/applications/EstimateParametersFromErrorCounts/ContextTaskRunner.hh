@@ -0,0 +1,67 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#pragma once
+
+#include "blt_util/log.hh"
+#include "blt_util/OrderedTaskRunner.hh"
+
+#include <sstream>
+#include <vector>
+
+
+/// fit a model to each context of an error counts table as an independent task
+///
+/// Contexts are estimated concurrently on threadCount workers, but the report and log output of each
+/// context are written to os and log_os in context order, so that output does not depend on the
+/// thread count.
+///
+/// \param[in] reportContext called as reportContext(contextInfo, reportStream, logStream), where the
+///                          streams buffer the output of a single context
+template <typename ErrorCounts, typename ReportContext>
+void
+runContextTasks(
+    const ErrorCounts& counts,
+    const unsigned threadCount,
+    std::ostream& os,
+    const ReportContext& reportContext)
+{
+    std::vector<typename ErrorCounts::const_iterator> contexts;
+    for (auto iter(counts.begin()); iter != counts.end(); ++iter)
+    {
+        contexts.push_back(iter);
+    }
+
+    auto runContext = [&](const unsigned /*workerIndex*/, const unsigned contextIndex, TaskOutput& taskOutput)
+    {
+        std::ostringstream reportStream;
+        std::ostringstream logStream;
+        reportContext(*contexts[contextIndex], reportStream, logStream);
+        taskOutput = { reportStream.str(), logStream.str() };
+    };
+
+    auto writeContext = [&](const TaskOutput& taskOutput)
+    {
+        log_os << taskOutput[1];
+        os << taskOutput[0];
+    };
+
+    runOrderedTasks(threadCount, contexts.size(), runContext, writeContext);
+}
@@ -70,6 +70,8 @@ parseEPECOptions(
      modelTypeHelp.str().c_str())
     ("model", po::value(&opt.modelIndex)->default_value(opt.modelIndex),
      "select which model of a given type to run")
+    ("threads", po::value(&opt.threadCount)->default_value(opt.threadCount),
+     "number of contexts to estimate in parallel")
     ;
 
     po::options_description help("help");
@@ -124,5 +126,9 @@ parseEPECOptions(
     {
         usage(log_os,prog,visible,"Counts file does not exist");
     }
+    if (opt.threadCount < 1)
+    {
+        usage(log_os,prog,visible,"Thread count must be at least 1");
+    }
 }
 
@@ -56,23 +56,23 @@ runEPEC(
         }
         else if (opt.modelIndex == 2)
         {
-            indelModelVariantAndIndyError(counts);
+            indelModelVariantAndIndyError(counts, opt.threadCount);
         }
         else if (opt.modelIndex == 3)
         {
-            indelModelVariantAndBinomialMixtureError(counts);
+            indelModelVariantAndBinomialMixtureError(counts, opt.threadCount);
         }
         else if (opt.modelIndex == 4)
         {
-            indelModelVariantAndIndyErrorNoOverlap(counts);
+            indelModelVariantAndIndyErrorNoOverlap(counts, opt.threadCount);
         }
         else if (opt.modelIndex == 5)
         {
-            indelModelVariantAndBinomialMixtureErrorNoOverlap(counts);
+            indelModelVariantAndBinomialMixtureErrorNoOverlap(counts, opt.threadCount);
         }
         else if (opt.modelIndex == 6)
         {
-            indelModelVariantAndBetaBinomialError(counts);
+            indelModelVariantAndBetaBinomialError(counts, opt.threadCount);
         }
         else
         {
@@ -87,11 +87,11 @@ runEPEC(
         }
         else if (opt.modelIndex == 2)
         {
-            snvModelVariantAndIndyError(counts);
+            snvModelVariantAndIndyError(counts, opt.threadCount);
         }
         else if (opt.modelIndex == 3)
         {
-            snvModelVariantAndBinomialMixtureError(counts);
+            snvModelVariantAndBinomialMixtureError(counts, opt.threadCount);
         }
         else
         {
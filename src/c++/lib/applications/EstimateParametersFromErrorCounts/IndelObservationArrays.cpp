@@ -0,0 +1,91 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "IndelObservationArrays.hh"
+
+#include <cassert>
+
+
+
+void
+IndelObservationArrays::
+set(const std::vector<ExportedIndelObservations>& observations)
+{
+    std::vector<double>* arrays[] = { &repeatCount, &ref, &insert, &del, &maxAlt, &remainingInsert, &remainingDelete,
+                                      &maxAlt2, &remainingInsert2, &remainingDelete2
+                                    };
+    for (std::vector<double>* array : arrays)
+    {
+        array->clear();
+        array->reserve(observations.size());
+    }
+
+    for (const ExportedIndelObservations& obs : observations)
+    {
+        unsigned maxIndex(0);
+        for (unsigned altIndex(1); altIndex<INDEL_SIGNAL_TYPE::SIZE; ++altIndex)
+        {
+            if (obs.altObservations[altIndex] > obs.altObservations[maxIndex]) maxIndex = altIndex;
+        }
+
+        assert(INDEL_SIGNAL_TYPE::SIZE>1);
+        unsigned maxIndex2(maxIndex==0 ? 1 : 0);
+        for (unsigned altIndex(maxIndex2+1); altIndex<INDEL_SIGNAL_TYPE::SIZE; ++altIndex)
+        {
+            if (altIndex==maxIndex) continue;
+            if (obs.altObservations[altIndex] > obs.altObservations[maxIndex2]) maxIndex2 = altIndex;
+        }
+
+        unsigned insertObservations(0);
+        unsigned remainingInsertObservations(0);
+        unsigned remainingInsertObservations2(0);
+        for (unsigned altIndex(INDEL_SIGNAL_TYPE::INSERT_1); altIndex<INDEL_SIGNAL_TYPE::DELETE_1; ++altIndex)
+        {
+            insertObservations += obs.altObservations[altIndex];
+            if (altIndex==maxIndex) continue;
+            remainingInsertObservations += obs.altObservations[altIndex];
+            if (altIndex==maxIndex2) continue;
+            remainingInsertObservations2 += obs.altObservations[altIndex];
+        }
+
+        unsigned deleteObservations(0);
+        unsigned remainingDeleteObservations(0);
+        unsigned remainingDeleteObservations2(0);
+        for (unsigned altIndex(INDEL_SIGNAL_TYPE::DELETE_1); altIndex<INDEL_SIGNAL_TYPE::SIZE; ++altIndex)
+        {
+            deleteObservations += obs.altObservations[altIndex];
+            if (altIndex==maxIndex) continue;
+            remainingDeleteObservations += obs.altObservations[altIndex];
+            if (altIndex==maxIndex2) continue;
+            remainingDeleteObservations2 += obs.altObservations[altIndex];
+        }
+
+        repeatCount.push_back(obs.repeatCount);
+        ref.push_back(obs.refObservations);
+        insert.push_back(insertObservations);
+        del.push_back(deleteObservations);
+        maxAlt.push_back(obs.altObservations[maxIndex]);
+        remainingInsert.push_back(remainingInsertObservations);
+        remainingDelete.push_back(remainingDeleteObservations);
+        maxAlt2.push_back(obs.altObservations[maxIndex2]);
+        remainingInsert2.push_back(remainingInsertObservations2);
+        remainingDelete2.push_back(remainingDeleteObservations2);
+    }
+}
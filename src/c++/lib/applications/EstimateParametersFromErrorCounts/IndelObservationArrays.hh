@@ -0,0 +1,65 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#pragma once
+
+#include "errorAnalysis/IndelErrorCounts.hh"
+
+#include <vector>
+
+
+/// the parameter independent totals of each indel observation pattern in one context, stored as one
+/// contiguous array per value
+///
+/// The indel error models evaluate the context likelihood many times during minimization. Summarizing
+/// the observations once up front reduces each evaluation to a single pass over flat arrays.
+///
+struct IndelObservationArrays
+{
+    void
+    set(const std::vector<ExportedIndelObservations>& observations);
+
+    unsigned
+    size() const
+    {
+        return repeatCount.size();
+    }
+
+    /// number of times each observation pattern occurs in the context
+    std::vector<double> repeatCount;
+
+    std::vector<double> ref;
+
+    /// total alt observations of all insertion and deletion types
+    std::vector<double> insert;
+    std::vector<double> del;
+
+    /// observations of the most frequent alt signal, and the insertion and deletion observations left
+    /// after this signal is excluded
+    std::vector<double> maxAlt;
+    std::vector<double> remainingInsert;
+    std::vector<double> remainingDelete;
+
+    /// observations of the second most frequent alt signal, and the insertion and deletion observations left
+    /// after both of the most frequent signals are excluded
+    std::vector<double> maxAlt2;
+    std::vector<double> remainingInsert2;
+    std::vector<double> remainingDelete2;
+};
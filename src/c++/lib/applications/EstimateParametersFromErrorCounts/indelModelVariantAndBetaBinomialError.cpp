@@ -23,6 +23,8 @@
 ///
 
 #include "indelModelVariantAndBetaBinomialError.hh"
+#include "ContextTaskRunner.hh"
+#include "IndelObservationArrays.hh"
 
 #include "blt_util/log.hh"
 #include "blt_util/math_util.hh"
@@ -86,12 +88,10 @@ getObsLogLhood(
     const double indelErrorAlpha,
     const double indelErrorBeta,
     const double indelBetaDenom,
-    const bool isInsert,
     /*    const double logNoIndelRefRate, */
-    const ExportedIndelObservations& obs)
+    const double indelObservations,
+    const double refObservations)
 {
-    static const double log0(-std::numeric_limits<double>::infinity());
-
     static const double homAltRate(0.99);
     static const double hetAltRate(0.5);
 
@@ -99,40 +99,16 @@ getObsLogLhood(
     static const double logHomRefRate(std::log(1.-homAltRate));
     static const double logHetRate(std::log(hetAltRate));
 
-    unsigned totalIndelObservations(0);
-
-    if (isInsert)
-    {
-        for (unsigned altIndex(INDEL_SIGNAL_TYPE::INSERT_1); altIndex<INDEL_SIGNAL_TYPE::DELETE_1; ++altIndex)
-        {
-            totalIndelObservations += obs.altObservations[altIndex];
-        }
-    }
-    else
-    {
-        for (unsigned altIndex(INDEL_SIGNAL_TYPE::DELETE_1); altIndex<INDEL_SIGNAL_TYPE::SIZE; ++altIndex)
-        {
-            totalIndelObservations += obs.altObservations[altIndex];
-        }
-    }
-
     // get lhood of homref GT:
-    double noindel(log0);
-    {
-        noindel = std::log(boost::math::beta((totalIndelObservations+indelErrorAlpha),
-                                             (obs.refObservations+indelErrorBeta))
-                           /indelBetaDenom);
-    }
+    const double noindel(std::log(boost::math::beta((indelObservations+indelErrorAlpha),
+                                                    (refObservations+indelErrorBeta))
+                                  /indelBetaDenom));
 
     // get lhood of het and hom GT:
-    double het(log0);
-    double hom(log0);
-    {
-        het = logHetRate*(obs.refObservations+totalIndelObservations);
+    const double het(logHetRate*(refObservations+indelObservations));
 
-        hom = (logHomAltRate*totalIndelObservations +
-               logHomRefRate*obs.refObservations);
-    }
+    const double hom(logHomAltRate*indelObservations +
+                     logHomRefRate*refObservations);
 
     const double mix = log_sum( log_sum(logHomPrior+hom,logHetPrior+het), logNoIndelPrior+noindel);
 
@@ -144,7 +120,7 @@ getObsLogLhood(
 static
 double
 contextLogLhood(
-    const std::vector<ExportedIndelObservations>& observations,
+    const IndelObservationArrays& obs,
     const double logIndelErrorMean,
     const double logIndelErrorConcentration,
     const bool isInsert,
@@ -182,18 +158,21 @@ contextLogLhood(
     // we haven't set this up for very good numerical stability, so the bounds on alpha/beta are fairly tight:
     assert((indelBetaDenom > 0.) && "Can't process proposed beta distribution parameters");
 
+    const std::vector<double>& indelObservations(isInsert ? obs.insert : obs.del);
+
     double logLhood(0.);
-    for (const auto& obs : observations)
+    const unsigned obsCount(obs.size());
+    for (unsigned obsIndex(0); obsIndex<obsCount; ++obsIndex)
     {
         const double mix(getObsLogLhood(logHomPrior, logHetPrior, logNoIndelPrior,
                                         indelErrorAlpha, indelErrorBeta, indelBetaDenom,
-                                        isInsert, obs));
+                                        indelObservations[obsIndex], obs.ref[obsIndex]));
 
 #ifdef DEBUG_MODEL4
-        log_os << "MODEL4: loghood obs: mix/delta: " << mix << " " << (mix*obs.repeatCount) << "\n";
+        log_os << "MODEL4: loghood obs: mix/delta: " << mix << " " << (mix*obs.repeatCount[obsIndex]) << "\n";
 #endif
 
-        logLhood += (mix*obs.repeatCount);
+        logLhood += (mix*obs.repeatCount[obsIndex]);
     }
 
     checkSaneVal(logLhood);
@@ -213,7 +192,7 @@ struct error_minfunc_model4 : public codemin::minfunc_interface<double>
 {
     explicit
     error_minfunc_model4(
-        const std::vector<ExportedIndelObservations>& observations,
+        const IndelObservationArrays& observations,
         const bool isInsert,
         const bool isLockTheta = false)
         : _obs(observations), _isInsert(isInsert), _isLockTheta(isLockTheta)
@@ -312,7 +291,7 @@ struct error_minfunc_model4 : public codemin::minfunc_interface<double>
     static const double maxLogRate;
 
 private:
-    const std::vector<ExportedIndelObservations>& _obs;
+    const IndelObservationArrays& _obs;
     bool _isInsert;
     bool _isLockTheta;
     double _params[MIN_PARAMS4::SIZE];
@@ -415,6 +394,9 @@ reportExtendedContext(
     getAltSigTotal(observations, INDEL_SIGNAL_TYPE::DELETE_1, INDEL_SIGNAL_TYPE::SIZE, sigDeleteTotal);
 
 
+    IndelObservationArrays observationArrays;
+    observationArrays.set(observations);
+
     // initialize conjugate direction minimizer settings and minimize lhood...
     //
     for (unsigned indelTypeIndex(0); indelTypeIndex<2; ++indelTypeIndex)
@@ -446,7 +428,7 @@ reportExtendedContext(
 
             double start_tol(end_tol);
             double final_dlh;
-            error_minfunc_model4 errFunc(observations, isInsert, isLockTheta);
+            error_minfunc_model4 errFunc(observationArrays, isInsert, isLockTheta);
 
             codemin::minimize_conj_direction(minParams,conjDir,errFunc,start_tol,end_tol,line_tol,
                                              x_all_loghood,iter,final_dlh,max_iter);
@@ -472,7 +454,8 @@ reportExtendedContext(
 
 void
 indelModelVariantAndBetaBinomialError(
-    const SequenceErrorCounts& counts)
+    const SequenceErrorCounts& counts,
+    const unsigned threadCount)
 {
     const bool isLockTheta(false);
 
@@ -480,19 +463,21 @@ indelModelVariantAndBetaBinomialError(
 
     ros << "context, excludedLoci, nonExcludedLoci, usedLoci, refReads, altReads, iter, lhood, alpha, beta, mean, concentration, theta\n";
 
-    std::vector<ExportedIndelObservations> observations;
-    for (const auto& contextInfo : counts.getIndelCounts())
+    auto reportContext = [&](const IndelErrorCounts::const_iterator::value_type& contextInfo, std::ostream& os, std::ostream& logOs)
     {
         const auto& context(contextInfo.first);
         const auto& data(contextInfo.second);
 
-        //if (context.repeatCount != 15) continue;
+        //if (context.repeatCount != 15) return;
 
+        std::vector<ExportedIndelObservations> observations;
         data.exportObservations(observations);
 
-        if (observations.empty()) continue;
+        if (observations.empty()) return;
 
-        log_os << "INFO: computing rates for context: " << context << "\n";
-        reportExtendedContext(isLockTheta, context, observations, data, ros);
-    }
+        logOs << "INFO: computing rates for context: " << context << "\n";
+        reportExtendedContext(isLockTheta, context, observations, data, os);
+    };
+
+    runContextTasks(counts.getIndelCounts(), threadCount, ros, reportContext);
 }
@@ -31,4 +31,5 @@
 ///
 void
 indelModelVariantAndBetaBinomialError(
-    const SequenceErrorCounts& counts);
+    const SequenceErrorCounts& counts,
+    const unsigned threadCount);
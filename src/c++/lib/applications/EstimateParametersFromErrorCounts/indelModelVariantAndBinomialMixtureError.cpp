@@ -26,6 +26,8 @@
 #include "blt_util/math_util.hh"
 #include "blt_util/prob_util.hh"
 #include "indelModelVariantAndBinomialMixtureError.hh"
+#include "ContextTaskRunner.hh"
+#include "IndelObservationArrays.hh"
 
 //#define CODEMIN_DEBUG
 #define CODEMIN_USE_BOOST
@@ -64,10 +66,9 @@ getObsLogLhood(
     const double logInsertErrorRate,
     const double logDeleteErrorRate,
     const double logNoIndelRefRate,
-    const ExportedIndelObservations& obs)
+    const IndelObservationArrays& obs,
+    const unsigned obsIndex)
 {
-    static const double log0(-std::numeric_limits<double>::infinity());
-
     static const double homAltRate(0.99);
     static const double hetAltRate(0.5);
 
@@ -76,97 +77,31 @@ getObsLogLhood(
     static const double logHetRate(std::log(hetAltRate));
 
     // get lhood of homref GT:
-    double noindel(log0);
-    {
-        unsigned totalInsertObservations(0);
-        for (unsigned altIndex(INDEL_SIGNAL_TYPE::INSERT_1); altIndex<INDEL_SIGNAL_TYPE::DELETE_1; ++altIndex)
-        {
-            totalInsertObservations += obs.altObservations[altIndex];
-        }
-
-        unsigned totalDeleteObservations(0);
-        for (unsigned altIndex(INDEL_SIGNAL_TYPE::DELETE_1); altIndex<INDEL_SIGNAL_TYPE::SIZE; ++altIndex)
-        {
-            totalDeleteObservations += obs.altObservations[altIndex];
-        }
-
-        noindel = (
-                      logInsertErrorRate*totalInsertObservations +
-                      logDeleteErrorRate*totalDeleteObservations +
-                      logNoIndelRefRate*obs.refObservations);
-    }
-
-    unsigned maxIndex(0);
-    for (unsigned altIndex(1); altIndex<INDEL_SIGNAL_TYPE::SIZE; ++altIndex)
-    {
-        if (obs.altObservations[altIndex] > obs.altObservations[maxIndex]) maxIndex = altIndex;
-    }
-
-    // get lhood of het and hom GT:
-    double het(log0);
-    double hom(log0);
-    {
-        // approximate that the most frequent observations is the only potential variant allele:
-
-        unsigned remainingInsertObservations(0);
-        for (unsigned altIndex(INDEL_SIGNAL_TYPE::INSERT_1); altIndex<INDEL_SIGNAL_TYPE::DELETE_1; ++altIndex)
-        {
-            if (altIndex==maxIndex) continue;
-            remainingInsertObservations += obs.altObservations[altIndex];
-        }
-
-        unsigned remainingDeleteObservations(0);
-        for (unsigned altIndex(INDEL_SIGNAL_TYPE::DELETE_1); altIndex<INDEL_SIGNAL_TYPE::SIZE; ++altIndex)
-        {
-            if (altIndex==maxIndex) continue;
-            remainingDeleteObservations += obs.altObservations[altIndex];
-        }
-
-        // compute lhood of het/hom states given that maxIndex is the variant allele:
-        het =(logHetRate*(obs.refObservations+obs.altObservations[maxIndex]) +
-              logInsertErrorRate*remainingInsertObservations +
-              logDeleteErrorRate*remainingDeleteObservations);
-
-        hom = (logHomAltRate*obs.altObservations[maxIndex] +
-               logHomRefRate*obs.refObservations +
-               logInsertErrorRate*remainingInsertObservations +
-               logDeleteErrorRate*remainingDeleteObservations);
-    }
-
-    // get lhood of althet GT:
-    double althet(log0);
-    {
-        // approximate that the two most frequent observations are the only potential variant alleles:
-        assert(INDEL_SIGNAL_TYPE::SIZE>1);
-        unsigned maxIndex2(maxIndex==0 ? 1 : 0);
-        for (unsigned altIndex(maxIndex2+1); altIndex<INDEL_SIGNAL_TYPE::SIZE; ++altIndex)
-        {
-            if (altIndex==maxIndex) continue;
-            if (obs.altObservations[altIndex] > obs.altObservations[maxIndex2]) maxIndex2 = altIndex;
-        }
-
-        unsigned remainingInsertObservations(0);
-        for (unsigned altIndex(INDEL_SIGNAL_TYPE::INSERT_1); altIndex<INDEL_SIGNAL_TYPE::DELETE_1; ++altIndex)
-        {
-            if (altIndex==maxIndex) continue;
-            if (altIndex==maxIndex2) continue;
-            remainingInsertObservations += obs.altObservations[altIndex];
-        }
-
-        unsigned remainingDeleteObservations(0);
-        for (unsigned altIndex(INDEL_SIGNAL_TYPE::DELETE_1); altIndex<INDEL_SIGNAL_TYPE::SIZE; ++altIndex)
-        {
-            if (altIndex==maxIndex) continue;
-            if (altIndex==maxIndex2) continue;
-            remainingDeleteObservations += obs.altObservations[altIndex];
-        }
-
-        // compute lhood of het/hom states given that maxIndex is the variant allele:
-        althet =(logHetRate*(obs.altObservations[maxIndex]+obs.altObservations[maxIndex2]) +
-                 logHomRefRate*obs.refObservations +
-                 logInsertErrorRate*remainingInsertObservations +
-                 logDeleteErrorRate*remainingDeleteObservations);
-    }
+    const double noindel(
+        logInsertErrorRate*obs.insert[obsIndex] +
+        logDeleteErrorRate*obs.del[obsIndex] +
+        logNoIndelRefRate*obs.ref[obsIndex]);
+
+    // get lhood of het and hom GT, approximating that the most frequent observation is the only
+    // potential variant allele:
+    const double het(
+        logHetRate*(obs.ref[obsIndex]+obs.maxAlt[obsIndex]) +
+        logInsertErrorRate*obs.remainingInsert[obsIndex] +
+        logDeleteErrorRate*obs.remainingDelete[obsIndex]);
+
+    const double hom(
+        logHomAltRate*obs.maxAlt[obsIndex] +
+        logHomRefRate*obs.ref[obsIndex] +
+        logInsertErrorRate*obs.remainingInsert[obsIndex] +
+        logDeleteErrorRate*obs.remainingDelete[obsIndex]);
+
+    // get lhood of althet GT, approximating that the two most frequent observations are the only
+    // potential variant alleles:
+    const double althet(
+        logHetRate*(obs.maxAlt[obsIndex]+obs.maxAlt2[obsIndex]) +
+        logHomRefRate*obs.ref[obsIndex] +
+        logInsertErrorRate*obs.remainingInsert2[obsIndex] +
+        logDeleteErrorRate*obs.remainingDelete2[obsIndex]);
 
     return log_sum( log_sum(logHomPrior+hom,logHetPrior+het), log_sum(logNoIndelPrior+noindel,logAltHetPrior+althet) );
 }
@@ -176,7 +111,7 @@ getObsLogLhood(
 static
 double
 contextLogLhood(
-    const std::vector<ExportedIndelObservations>& observations,
+    const IndelObservationArrays& obs,
     const double logInsertErrorRate,
     const double logDeleteErrorRate,
     const double logNoisyLocusRate,
@@ -207,20 +142,21 @@ contextLogLhood(
     static const double logCleanLocusRefRate(std::log(1-cleanLocusIndelRate));
 
     double logLhood(0.);
-    for (const auto& obs : observations)
+    const unsigned obsCount(obs.size());
+    for (unsigned obsIndex(0); obsIndex<obsCount; ++obsIndex)
     {
         const double noisyMix(getObsLogLhood(logHomPrior, logHetPrior, logAltHetPrior, logNoIndelPrior,
-                                             logInsertErrorRate, logDeleteErrorRate, logNoIndelRefRate, obs));
+                                             logInsertErrorRate, logDeleteErrorRate, logNoIndelRefRate, obs, obsIndex));
         const double cleanMix(getObsLogLhood(logHomPrior, logHetPrior, logAltHetPrior, logNoIndelPrior,
-                                             logCleanLocusIndelRate, logCleanLocusIndelRate, logCleanLocusRefRate, obs));
+                                             logCleanLocusIndelRate, logCleanLocusIndelRate, logCleanLocusRefRate, obs, obsIndex));
 
         const double mix(log_sum(logCleanLocusRate+cleanMix,logNoisyLocusRate+noisyMix));
 
 #ifdef DEBUG_MODEL3
-        log_os << "MODEL3: loghood obs: noisy/clean/mix/delta: " << noisyMix << " " << cleanMix << " " << mix << " " << (mix*obs.repeatCount) << "\n";
+        log_os << "MODEL3: loghood obs: noisy/clean/mix/delta: " << noisyMix << " " << cleanMix << " " << mix << " " << (mix*obs.repeatCount[obsIndex]) << "\n";
 #endif
 
-        logLhood += (mix*obs.repeatCount);
+        logLhood += (mix*obs.repeatCount[obsIndex]);
     }
 
 #ifdef DEBUG_MODEL3
@@ -235,7 +171,7 @@ struct error_minfunc_model3 : public codemin::minfunc_interface<double>
 {
     explicit
     error_minfunc_model3(
-        const std::vector<ExportedIndelObservations>& observations,
+        const IndelObservationArrays& observations,
         const bool isLockTheta = false)
         : _obs(observations), _isLockTheta(isLockTheta)
     {}
@@ -335,7 +271,7 @@ struct error_minfunc_model3 : public codemin::minfunc_interface<double>
     static const double maxLogLocusRate;
 
 private:
-    const std::vector<ExportedIndelObservations>& _obs;
+    const IndelObservationArrays& _obs;
     bool _isLockTheta;
     double _params[MIN_PARAMS3::SIZE];
 };
@@ -459,7 +395,9 @@ reportExtendedContext(
 
         double start_tol(end_tol);
         double final_dlh;
-        error_minfunc_model3 errFunc(observations,isLockTheta);
+        IndelObservationArrays observationArrays;
+        observationArrays.set(observations);
+        error_minfunc_model3 errFunc(observationArrays,isLockTheta);
 
         codemin::minimize_conj_direction(minParams,conjDir,errFunc,start_tol,end_tol,line_tol,
                                          x_all_loghood,iter,final_dlh,max_iter);
@@ -487,7 +425,8 @@ reportExtendedContext(
 
 void
 indelModelVariantAndBinomialMixtureError(
-    const SequenceErrorCounts& counts)
+    const SequenceErrorCounts& counts,
+    const unsigned threadCount)
 {
     const bool isLockTheta(false);
 
@@ -495,17 +434,19 @@ indelModelVariantAndBinomialMixtureError(
 
     ros << "context, excludedLoci, nonExcludedLoci, usedLoci, refReads, altReads, iter, lhood, errorRate, theta, noisyLocusRate\n";
 
-    std::vector<ExportedIndelObservations> observations;
-    for (const auto& contextInfo : counts.getIndelCounts())
+    auto reportContext = [&](const IndelErrorCounts::const_iterator::value_type& contextInfo, std::ostream& os, std::ostream& logOs)
     {
         const auto& context(contextInfo.first);
         const auto& data(contextInfo.second);
 
+        std::vector<ExportedIndelObservations> observations;
         data.exportObservations(observations);
 
-        if (observations.empty()) continue;
+        if (observations.empty()) return;
 
-        log_os << "INFO: computing rates for context: " << context << "\n";
-        reportExtendedContext(isLockTheta, context, observations, data, ros);
-    }
+        logOs << "INFO: computing rates for context: " << context << "\n";
+        reportExtendedContext(isLockTheta, context, observations, data, os);
+    };
+
+    runContextTasks(counts.getIndelCounts(), threadCount, ros, reportContext);
 }
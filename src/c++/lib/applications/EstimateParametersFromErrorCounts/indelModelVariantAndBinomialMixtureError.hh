@@ -31,4 +31,5 @@
 ///
 void
 indelModelVariantAndBinomialMixtureError(
-    const SequenceErrorCounts& counts);
+    const SequenceErrorCounts& counts,
+    const unsigned threadCount);
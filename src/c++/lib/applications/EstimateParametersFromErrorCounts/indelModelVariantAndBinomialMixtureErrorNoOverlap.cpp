@@ -23,6 +23,8 @@
 ///
 
 #include "indelModelVariantAndBinomialMixtureErrorNoOverlap.hh"
+#include "ContextTaskRunner.hh"
+#include "IndelObservationArrays.hh"
 
 #include "blt_util/log.hh"
 #include "blt_util/math_util.hh"
@@ -64,8 +66,8 @@ getObsLogLhood(
     const double logNoIndelPrior,
     const double logIndelErrorRate,
     const double logNoIndelRefRate,
-    const bool isInsert,
-    const ExportedIndelObservations& obs)
+    const double indelObservations,
+    const double refObservations)
 {
     static const double homAltRate(0.99);
     static const double hetAltRate(0.5);
@@ -74,30 +76,14 @@ getObsLogLhood(
     static const double logHomRefRate(std::log(1.-homAltRate));
     static const double logHetRate(std::log(hetAltRate));
 
-    unsigned totalIndelObservations(0);
-    if (isInsert)
-    {
-        for (unsigned altIndex(INDEL_SIGNAL_TYPE::INSERT_1); altIndex<INDEL_SIGNAL_TYPE::DELETE_1; ++altIndex)
-        {
-            totalIndelObservations += obs.altObservations[altIndex];
-        }
-    }
-    else
-    {
-        for (unsigned altIndex(INDEL_SIGNAL_TYPE::DELETE_1); altIndex<INDEL_SIGNAL_TYPE::SIZE; ++altIndex)
-        {
-            totalIndelObservations += obs.altObservations[altIndex];
-        }
-    }
-
     // get lhood of homref GT:
-    const double noindel(logIndelErrorRate*totalIndelObservations +
-                         logNoIndelRefRate*obs.refObservations);
+    const double noindel(logIndelErrorRate*indelObservations +
+                         logNoIndelRefRate*refObservations);
 
     // get lhood of het and hom GT:
-    const double het(logHetRate*(obs.refObservations+totalIndelObservations));
+    const double het(logHetRate*(refObservations+indelObservations));
 
-    const double hom(logHomAltRate*totalIndelObservations + logHomRefRate*obs.refObservations);
+    const double hom(logHomAltRate*indelObservations + logHomRefRate*refObservations);
 
     return log_sum( log_sum(logHomPrior+hom,logHetPrior+het), logNoIndelPrior+noindel );
 }
@@ -107,7 +93,7 @@ getObsLogLhood(
 static
 double
 contextLogLhood(
-    const std::vector<ExportedIndelObservations>& observations,
+    const IndelObservationArrays& obs,
     const double logIndelErrorRate,
     const double logNoisyLocusRate,
     const bool isInsert,
@@ -134,21 +120,26 @@ contextLogLhood(
     static const double logCleanLocusIndelRate(std::log(cleanLocusIndelErrorRate));
     static const double logCleanLocusRefRate(std::log(1-cleanLocusIndelErrorRate));
 
+    const std::vector<double>& indelObservations(isInsert ? obs.insert : obs.del);
+
     double logLhood(0.);
-    for (const auto& obs : observations)
+    const unsigned obsCount(obs.size());
+    for (unsigned obsIndex(0); obsIndex<obsCount; ++obsIndex)
     {
         const double noisyMix(getObsLogLhood(logHomPrior, logHetPrior, logNoIndelPrior,
-                                             logIndelErrorRate, logNoIndelRefRate, isInsert, obs));
+                                             logIndelErrorRate, logNoIndelRefRate,
+                                             indelObservations[obsIndex], obs.ref[obsIndex]));
         const double cleanMix(getObsLogLhood(logHomPrior, logHetPrior, logNoIndelPrior,
-                                             logCleanLocusIndelRate, logCleanLocusRefRate, isInsert, obs));
+                                             logCleanLocusIndelRate, logCleanLocusRefRate,
+                                             indelObservations[obsIndex], obs.ref[obsIndex]));
 
         const double mix(log_sum(logCleanLocusRate+cleanMix,logNoisyLocusRate+noisyMix));
 
 #ifdef DEBUG_MODEL3
-        log_os << "MODEL3: loghood obs: noisy/clean/mix/delta: " << noisyMix << " " << cleanMix << " " << mix << " " << (mix*obs.repeatCount) << "\n";
+        log_os << "MODEL3: loghood obs: noisy/clean/mix/delta: " << noisyMix << " " << cleanMix << " " << mix << " " << (mix*obs.repeatCount[obsIndex]) << "\n";
 #endif
 
-        logLhood += (mix*obs.repeatCount);
+        logLhood += (mix*obs.repeatCount[obsIndex]);
     }
 
 #ifdef DEBUG_MODEL3
@@ -163,7 +154,7 @@ struct error_minfunc_model3 : public codemin::minfunc_interface<double>
 {
     explicit
     error_minfunc_model3(
-        const std::vector<ExportedIndelObservations>& observations,
+        const IndelObservationArrays& observations,
         const bool isInsert,
         const bool isLockTheta = false)
         : _obs(observations),
@@ -266,7 +257,7 @@ struct error_minfunc_model3 : public codemin::minfunc_interface<double>
     static const double maxLogLocusRate;
 
 private:
-    const std::vector<ExportedIndelObservations>& _obs;
+    const IndelObservationArrays& _obs;
     bool _isInsert;
     bool _isLockTheta;
     double _params[MIN_PARAMS3::SIZE];
@@ -366,6 +357,9 @@ reportExtendedContext(
     getAltSigTotal(observations, INDEL_SIGNAL_TYPE::DELETE_1, INDEL_SIGNAL_TYPE::SIZE, sigDeleteTotal);
 
 
+    IndelObservationArrays observationArrays;
+    observationArrays.set(observations);
+
     // initialize conjugate direction minimizer settings and minimize lhood...
     //
     for (unsigned indelTypeIndex(0); indelTypeIndex<2; ++indelTypeIndex)
@@ -397,7 +391,7 @@ reportExtendedContext(
 
             double start_tol(end_tol);
             double final_dlh;
-            error_minfunc_model3 errFunc(observations, isInsert, isLockTheta);
+            error_minfunc_model3 errFunc(observationArrays, isInsert, isLockTheta);
 
             codemin::minimize_conj_direction(minParams,conjDir,errFunc,start_tol,end_tol,line_tol,
                                              x_all_loghood,iter,final_dlh,max_iter);
@@ -424,7 +418,8 @@ reportExtendedContext(
 
 void
 indelModelVariantAndBinomialMixtureErrorNoOverlap(
-    const SequenceErrorCounts& counts)
+    const SequenceErrorCounts& counts,
+    const unsigned threadCount)
 {
     const bool isLockTheta(false);
 
@@ -432,17 +427,19 @@ indelModelVariantAndBinomialMixtureErrorNoOverlap(
 
     ros << "context, excludedLoci, nonExcludedLoci, usedLoci, refReads, altReads, iter, lhood, noisyErrorRate, cleanErrorRate, noisyLocusRate, simpleErrorRate, theta, \n";
 
-    std::vector<ExportedIndelObservations> observations;
-    for (const auto& contextInfo : counts.getIndelCounts())
+    auto reportContext = [&](const IndelErrorCounts::const_iterator::value_type& contextInfo, std::ostream& os, std::ostream& logOs)
     {
         const auto& context(contextInfo.first);
         const auto& data(contextInfo.second);
 
+        std::vector<ExportedIndelObservations> observations;
         data.exportObservations(observations);
 
-        if (observations.empty()) continue;
+        if (observations.empty()) return;
 
-        log_os << "INFO: computing rates for context: " << context << "\n";
-        reportExtendedContext(isLockTheta, context, observations, data, ros);
-    }
+        logOs << "INFO: computing rates for context: " << context << "\n";
+        reportExtendedContext(isLockTheta, context, observations, data, os);
+    };
+
+    runContextTasks(counts.getIndelCounts(), threadCount, ros, reportContext);
 }
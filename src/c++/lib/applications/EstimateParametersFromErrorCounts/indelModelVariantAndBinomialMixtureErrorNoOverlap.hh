@@ -33,4 +33,5 @@
 /// alleles at one locus
 void
 indelModelVariantAndBinomialMixtureErrorNoOverlap(
-    const SequenceErrorCounts& counts);
+    const SequenceErrorCounts& counts,
+    const unsigned threadCount);
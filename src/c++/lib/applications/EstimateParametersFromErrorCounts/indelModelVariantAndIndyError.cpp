@@ -23,6 +23,8 @@
 ///
 
 #include "indelModelVariantAndIndyError.hh"
+#include "ContextTaskRunner.hh"
+#include "IndelObservationArrays.hh"
 
 #include "blt_util/math_util.hh"
 #include "blt_util/prob_util.hh"
@@ -52,7 +54,7 @@ enum index_t
 static
 double
 contextLogLhood(
-    const std::vector<ExportedIndelObservations>& observations,
+    const IndelObservationArrays& obs,
     const double logInsertErrorRate,
     const double logDeleteErrorRate,
     const double logTheta)
@@ -64,7 +66,6 @@ contextLogLhood(
     static const double logHomRefRate(std::log(1.-homAltRate));
     static const double logHetRate(std::log(hetAltRate));
 
-    static const double log0(-std::numeric_limits<double>::infinity());
     static const double log2(std::log(2));
     const double logHomPrior(logTheta-log2);
     const double logHetPrior(logTheta);
@@ -75,107 +76,40 @@ contextLogLhood(
     const double logNoIndelRefRate(std::log(1-std::exp(logInsertErrorRate))+std::log(1-std::exp(logDeleteErrorRate)));
 
     double logLhood(0.);
-    for (const auto& obs : observations)
+    const unsigned obsCount(obs.size());
+    for (unsigned obsIndex(0); obsIndex<obsCount; ++obsIndex)
     {
         // get lhood of homref GT:
-        double noindel(log0);
-        {
-            unsigned totalInsertObservations(0);
-            for (unsigned altIndex(INDEL_SIGNAL_TYPE::INSERT_1); altIndex<INDEL_SIGNAL_TYPE::DELETE_1; ++altIndex)
-            {
-                totalInsertObservations += obs.altObservations[altIndex];
-            }
-
-            unsigned totalDeleteObservations(0);
-            for (unsigned altIndex(INDEL_SIGNAL_TYPE::DELETE_1); altIndex<INDEL_SIGNAL_TYPE::SIZE; ++altIndex)
-            {
-                totalDeleteObservations += obs.altObservations[altIndex];
-            }
-
-            noindel = (
-                          logInsertErrorRate*totalInsertObservations +
-                          logDeleteErrorRate*totalDeleteObservations +
-                          logNoIndelRefRate*obs.refObservations);
-        }
-
-        unsigned maxIndex(0);
-        for (unsigned altIndex(1); altIndex<INDEL_SIGNAL_TYPE::SIZE; ++altIndex)
-        {
-            if (obs.altObservations[altIndex] > obs.altObservations[maxIndex]) maxIndex = altIndex;
-        }
-
-        // get lhood of het and hom GT:
-        double het(log0);
-        double hom(log0);
-        {
-            // approximate that the most frequent observations is the only potential variant allele:
-
-            unsigned remainingInsertObservations(0);
-            for (unsigned altIndex(INDEL_SIGNAL_TYPE::INSERT_1); altIndex<INDEL_SIGNAL_TYPE::DELETE_1; ++altIndex)
-            {
-                if (altIndex==maxIndex) continue;
-                remainingInsertObservations += obs.altObservations[altIndex];
-            }
-
-            unsigned remainingDeleteObservations(0);
-            for (unsigned altIndex(INDEL_SIGNAL_TYPE::DELETE_1); altIndex<INDEL_SIGNAL_TYPE::SIZE; ++altIndex)
-            {
-                if (altIndex==maxIndex) continue;
-                remainingDeleteObservations += obs.altObservations[altIndex];
-            }
-
-            // compute lhood of het/hom states given that maxIndex is the variant allele:
-            het =(logHetRate*(obs.refObservations+obs.altObservations[maxIndex]) +
-                  logInsertErrorRate*remainingInsertObservations +
-                  logDeleteErrorRate*remainingDeleteObservations);
-
-            hom = (logHomAltRate*obs.altObservations[maxIndex] +
-                   logHomRefRate*obs.refObservations +
-                   logInsertErrorRate*remainingInsertObservations +
-                   logDeleteErrorRate*remainingDeleteObservations);
-        }
-
-        // get lhood of althet GT:
-        double althet(log0);
-        {
-            // approximate that the two most frequent observations are the only potential variant alleles:
-            assert(INDEL_SIGNAL_TYPE::SIZE>1);
-            unsigned maxIndex2(maxIndex==0 ? 1 : 0);
-            for (unsigned altIndex(maxIndex2+1); altIndex<INDEL_SIGNAL_TYPE::SIZE; ++altIndex)
-            {
-                if (altIndex==maxIndex) continue;
-                if (obs.altObservations[altIndex] > obs.altObservations[maxIndex2]) maxIndex2 = altIndex;
-            }
-
-            unsigned remainingInsertObservations(0);
-            for (unsigned altIndex(INDEL_SIGNAL_TYPE::INSERT_1); altIndex<INDEL_SIGNAL_TYPE::DELETE_1; ++altIndex)
-            {
-                if (altIndex==maxIndex) continue;
-                if (altIndex==maxIndex2) continue;
-                remainingInsertObservations += obs.altObservations[altIndex];
-            }
-
-            unsigned remainingDeleteObservations(0);
-            for (unsigned altIndex(INDEL_SIGNAL_TYPE::DELETE_1); altIndex<INDEL_SIGNAL_TYPE::SIZE; ++altIndex)
-            {
-                if (altIndex==maxIndex) continue;
-                if (altIndex==maxIndex2) continue;
-                remainingDeleteObservations += obs.altObservations[altIndex];
-            }
-
-            // compute lhood of het/hom states given that maxIndex is the variant allele:
-            althet =(logHetRate*(obs.altObservations[maxIndex]+obs.altObservations[maxIndex2]) +
-                     logHomRefRate*obs.refObservations +
-                     logInsertErrorRate*remainingInsertObservations +
-                     logDeleteErrorRate*remainingDeleteObservations);
-        }
-
-
+        const double noindel(
+            logInsertErrorRate*obs.insert[obsIndex] +
+            logDeleteErrorRate*obs.del[obsIndex] +
+            logNoIndelRefRate*obs.ref[obsIndex]);
+
+        // get lhood of het and hom GT, approximating that the most frequent observation is the only
+        // potential variant allele:
+        const double het(
+            logHetRate*(obs.ref[obsIndex]+obs.maxAlt[obsIndex]) +
+            logInsertErrorRate*obs.remainingInsert[obsIndex] +
+            logDeleteErrorRate*obs.remainingDelete[obsIndex]);
+
+        const double hom(
+            logHomAltRate*obs.maxAlt[obsIndex] +
+            logHomRefRate*obs.ref[obsIndex] +
+            logInsertErrorRate*obs.remainingInsert[obsIndex] +
+            logDeleteErrorRate*obs.remainingDelete[obsIndex]);
+
+        // get lhood of althet GT, approximating that the two most frequent observations are the only
+        // potential variant alleles:
+        const double althet(
+            logHetRate*(obs.maxAlt[obsIndex]+obs.maxAlt2[obsIndex]) +
+            logHomRefRate*obs.ref[obsIndex] +
+            logInsertErrorRate*obs.remainingInsert2[obsIndex] +
+            logDeleteErrorRate*obs.remainingDelete2[obsIndex]);
 
         /// TODO: generalize log_sum to N values...
         const double mix(log_sum( log_sum(logHomPrior+hom,logHetPrior+het), log_sum(logNoIndelPrior+noindel,logAltHetPrior+althet) ));
 
-        logLhood += (mix*obs.repeatCount);
+        logLhood += (mix*obs.repeatCount[obsIndex]);
     }
 
     return logLhood;
@@ -186,7 +120,7 @@ struct error_minfunc : public codemin::minfunc_interface<double>
 {
     explicit
     error_minfunc(
-        const std::vector<ExportedIndelObservations>& observations,
+        const IndelObservationArrays& observations,
         const bool isLockTheta = false)
         : _obs(observations), _isLockTheta(isLockTheta)
     {}
@@ -268,7 +202,7 @@ struct error_minfunc : public codemin::minfunc_interface<double>
     static const double defaultLogTheta;
 
 private:
-    const std::vector<ExportedIndelObservations>& _obs;
+    const IndelObservationArrays& _obs;
     bool _isLockTheta;
     double _params[MIN_PARAMS::SIZE];
 };
@@ -384,7 +318,9 @@ reportExtendedContext(
 
         double start_tol(end_tol);
         double final_dlh;
-        error_minfunc errFunc(observations,isLockTheta);
+        IndelObservationArrays observationArrays;
+        observationArrays.set(observations);
+        error_minfunc errFunc(observationArrays,isLockTheta);
 
         codemin::minimize_conj_direction(minParams,conjDir,errFunc,start_tol,end_tol,line_tol,
                                          x_all_loghood,iter,final_dlh,max_iter);
@@ -411,7 +347,8 @@ reportExtendedContext(
 
 void
 indelModelVariantAndIndyError(
-    const SequenceErrorCounts& counts)
+    const SequenceErrorCounts& counts,
+    const unsigned threadCount)
 {
     const bool isLockTheta(false);
 
@@ -419,17 +356,19 @@ indelModelVariantAndIndyError(
 
     ros << "context, excludedLoci, nonExcludedLoci, usedLoci, refReads, altReads, iter, lhood, rate, theta\n";
 
-    std::vector<ExportedIndelObservations> observations;
-    for (const auto& contextInfo : counts.getIndelCounts())
+    auto reportContext = [&](const IndelErrorCounts::const_iterator::value_type& contextInfo, std::ostream& os, std::ostream& logOs)
     {
         const auto& context(contextInfo.first);
         const auto& data(contextInfo.second);
 
+        std::vector<ExportedIndelObservations> observations;
         data.exportObservations(observations);
 
-        if (observations.empty()) continue;
+        if (observations.empty()) return;
 
-        std::cerr << "INFO: computing rates for context: " << context << "\n";
-        reportExtendedContext(isLockTheta, context, observations, data, ros);
-    }
+        logOs << "INFO: computing rates for context: " << context << "\n";
+        reportExtendedContext(isLockTheta, context, observations, data, os);
+    };
+
+    runContextTasks(counts.getIndelCounts(), threadCount, ros, reportContext);
 }
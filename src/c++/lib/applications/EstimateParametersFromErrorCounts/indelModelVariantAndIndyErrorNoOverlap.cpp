@@ -25,6 +25,8 @@
 #include "blt_util/math_util.hh"
 #include "blt_util/prob_util.hh"
 #include "indelModelVariantAndIndyErrorNoOverlap.hh"
+#include "ContextTaskRunner.hh"
+#include "IndelObservationArrays.hh"
 
 #define CODEMIN_USE_BOOST
 #include "minimize_conj_direction.h"
@@ -50,7 +52,7 @@ enum index_t
 static
 double
 contextLogLhood(
-    const std::vector<ExportedIndelObservations>& observations,
+    const IndelObservationArrays& obs,
     const double logIndelErrorRate,
     const bool isInsert,
     const double logTheta)
@@ -70,39 +72,26 @@ contextLogLhood(
 
     const double logNoIndelRefRate(std::log1p(-std::exp(logIndelErrorRate)));
 
+    const std::vector<double>& indelObservations(isInsert ? obs.insert : obs.del);
+
     double logLhood(0.);
-    for (const auto& obs : observations)
+    const unsigned obsCount(obs.size());
+    for (unsigned obsIndex(0); obsIndex<obsCount; ++obsIndex)
     {
-        unsigned totalIndelObservations(0);
-        if (isInsert)
-        {
-            for (unsigned altIndex(INDEL_SIGNAL_TYPE::INSERT_1); altIndex<INDEL_SIGNAL_TYPE::DELETE_1; ++altIndex)
-            {
-                totalIndelObservations += obs.altObservations[altIndex];
-            }
-        }
-        else
-        {
-            for (unsigned altIndex(INDEL_SIGNAL_TYPE::DELETE_1); altIndex<INDEL_SIGNAL_TYPE::SIZE; ++altIndex)
-            {
-                totalIndelObservations += obs.altObservations[altIndex];
-            }
-        }
-
         // get lhood of homref GT:
-        const double noindel(logIndelErrorRate*totalIndelObservations +
-                             logNoIndelRefRate*obs.refObservations);
+        const double noindel(logIndelErrorRate*indelObservations[obsIndex] +
+                             logNoIndelRefRate*obs.ref[obsIndex]);
 
         // get lhood of het and hom GT:
-        const double het(logHetRate*(obs.refObservations+totalIndelObservations));
+        const double het(logHetRate*(obs.ref[obsIndex]+indelObservations[obsIndex]));
 
-        const double hom(logHomAltRate* +totalIndelObservations +
-                         logHomRefRate*obs.refObservations);
+        const double hom(logHomAltRate*indelObservations[obsIndex] +
+                         logHomRefRate*obs.ref[obsIndex]);
 
         /// TODO: generalize log_sum to N values...
         const double mix(log_sum( log_sum(logHomPrior+hom,logHetPrior+het), logNoIndelPrior+noindel ));
 
-        logLhood += (mix*obs.repeatCount);
+        logLhood += (mix*obs.repeatCount[obsIndex]);
     }
 
     return logLhood;
@@ -113,7 +102,7 @@ struct error_minfunc : public codemin::minfunc_interface<double>
 {
     explicit
     error_minfunc(
-        const std::vector<ExportedIndelObservations>& observations,
+        const IndelObservationArrays& observations,
         const bool isInsert,
         const bool isLockTheta = false)
         : _obs(observations),
@@ -188,7 +177,7 @@ struct error_minfunc : public codemin::minfunc_interface<double>
     static const double defaultLogTheta;
 
 private:
-    const std::vector<ExportedIndelObservations>& _obs;
+    const IndelObservationArrays& _obs;
     bool _isInsert;
     bool _isLockTheta;
     double _params[MIN_PARAMS::SIZE];
@@ -277,6 +266,9 @@ reportExtendedContext(
     getAltSigTotal(observations, INDEL_SIGNAL_TYPE::DELETE_1, INDEL_SIGNAL_TYPE::SIZE, sigDeleteTotal);
 
 
+    IndelObservationArrays observationArrays;
+    observationArrays.set(observations);
+
     // initialize conjugate direction minimizer settings and minimize lhood...
     //
     for (unsigned indelTypeIndex(0); indelTypeIndex<2; ++indelTypeIndex)
@@ -308,7 +300,7 @@ reportExtendedContext(
 
             double start_tol(end_tol);
             double final_dlh;
-            error_minfunc errFunc(observations, isInsert, isLockTheta);
+            error_minfunc errFunc(observationArrays, isInsert, isLockTheta);
 
             codemin::minimize_conj_direction(minParams,conjDir,errFunc,start_tol,end_tol,line_tol,
                                              x_all_loghood,iter,final_dlh,max_iter);
@@ -334,7 +326,8 @@ reportExtendedContext(
 
 void
 indelModelVariantAndIndyErrorNoOverlap(
-    const SequenceErrorCounts& counts)
+    const SequenceErrorCounts& counts,
+    const unsigned threadCount)
 {
     const bool isLockTheta(false);
 
@@ -342,17 +335,19 @@ indelModelVariantAndIndyErrorNoOverlap(
 
     ros << "context, excludedLoci, nonExcludedLoci, usedLoci, refReads, altReads, iter, lhood, rate, theta\n";
 
-    std::vector<ExportedIndelObservations> observations;
-    for (const auto& contextInfo : counts.getIndelCounts())
+    auto reportContext = [&](const IndelErrorCounts::const_iterator::value_type& contextInfo, std::ostream& os, std::ostream& logOs)
     {
         const auto& context(contextInfo.first);
         const auto& data(contextInfo.second);
 
+        std::vector<ExportedIndelObservations> observations;
         data.exportObservations(observations);
 
-        if (observations.empty()) continue;
+        if (observations.empty()) return;
 
-        std::cerr << "INFO: computing rates for context: " << context << "\n";
-        reportExtendedContext(isLockTheta, context, observations, data, ros);
-    }
+        logOs << "INFO: computing rates for context: " << context << "\n";
+        reportExtendedContext(isLockTheta, context, observations, data, os);
+    };
+
+    runContextTasks(counts.getIndelCounts(), threadCount, ros, reportContext);
 }
@@ -33,4 +33,5 @@
 /// alleles at one locus
 void
 indelModelVariantAndIndyErrorNoOverlap(
-    const SequenceErrorCounts& counts);
+    const SequenceErrorCounts& counts,
+    const unsigned threadCount);
@@ -23,6 +23,7 @@
 ///
 
 #include "snvModelVariantAndBinomialMixtureError.hh"
+#include "ContextTaskRunner.hh"
 
 #include "blt_util/log.hh"
 #include "blt_util/math_util.hh"
@@ -599,7 +600,8 @@ reportExtendedContext(
 
 void
 snvModelVariantAndBinomialMixtureError(
-    const SequenceErrorCounts& counts)
+    const SequenceErrorCounts& counts,
+    const unsigned threadCount)
 {
     const bool isFreeCleanLocusError(false);
     const bool isLockTheta(true);
@@ -608,11 +610,13 @@ snvModelVariantAndBinomialMixtureError(
 
     ros << "context, qual, excludedLoci, nonExcludedLoci, usedLoci, refReads, altReads, iter, lhood, noisyErrorRate, cleanErrorRate, cleanErrorFactor, noisyLocusRate, simpleErrorRate, expectErrorRate, theta\n";
 
-    for (const auto& contextInfo : counts.getBaseCounts())
+    auto reportContext = [&](const BaseErrorCounts::const_iterator::value_type& contextInfo, std::ostream& os, std::ostream& /*logOs*/)
     {
         const auto& context(contextInfo.first);
         const auto& data(contextInfo.second);
 
-        reportExtendedContext(isFreeCleanLocusError,isLockTheta, context, data, ros);
-    }
+        reportExtendedContext(isFreeCleanLocusError,isLockTheta, context, data, os);
+    };
+
+    runContextTasks(counts.getBaseCounts(), threadCount, ros, reportContext);
 }
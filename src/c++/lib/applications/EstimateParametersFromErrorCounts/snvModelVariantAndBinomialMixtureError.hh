@@ -29,4 +29,5 @@
 
 void
 snvModelVariantAndBinomialMixtureError(
-    const SequenceErrorCounts& counts);
+    const SequenceErrorCounts& counts,
+    const unsigned threadCount);
@@ -23,6 +23,7 @@
 ///
 
 #include "snvModelVariantAndIndyError.hh"
+#include "ContextTaskRunner.hh"
 
 #include "blt_util/math_util.hh"
 #include "blt_util/prob_util.hh"
@@ -341,7 +342,8 @@ reportExtendedContext(
 
 void
 snvModelVariantAndIndyError(
-    const SequenceErrorCounts& counts)
+    const SequenceErrorCounts& counts,
+    const unsigned threadCount)
 {
     const bool isLockTheta(false);
 
@@ -349,11 +351,13 @@ snvModelVariantAndIndyError(
 
     ros << "context, qual, excludedLoci, nonExcludedLoci, usedLoci, refReads, altReads, iter, lhood, errorRate, expectErrorRate, theta\n";
 
-    for (const auto& contextInfo : counts.getBaseCounts())
+    auto reportContext = [&](const BaseErrorCounts::const_iterator::value_type& contextInfo, std::ostream& os, std::ostream& /*logOs*/)
     {
         const auto& context(contextInfo.first);
         const auto& data(contextInfo.second);
 
-        reportExtendedContext(isLockTheta, context, data, ros);
-    }
+        reportExtendedContext(isLockTheta, context, data, os);
+    };
+
+    runContextTasks(counts.getBaseCounts(), threadCount, ros, reportContext);
 }
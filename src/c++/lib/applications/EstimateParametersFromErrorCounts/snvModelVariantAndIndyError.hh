@@ -30,4 +30,5 @@
 /// model data as a mixture of variants and an independent error process
 void
 snvModelVariantAndIndyError(
-    const SequenceErrorCounts& counts);
+    const SequenceErrorCounts& counts,
+    const unsigned threadCount);
@@ -61,6 +61,11 @@ parseChromDepthOptions(
      "chromosome name. May be supplied more than once. At least one entry required.")
     ("output-file", po::value(&opt.outputFilename),
      "write stats to filename (default: stdout)")
+    ("sample-windows", po::value(&opt.isSampleWindows)->zero_tokens(),
+     "estimate depth from windows sampled at random through the alignment file index, stopping once the "
+     "confidence interval on the median depth is narrow enough")
+    ("threads", po::value(&opt.threadCount)->default_value(opt.threadCount),
+     "number of chromosomes to estimate in parallel")
     ;
 
     po::options_description help("help");
@@ -107,6 +112,10 @@ parseChromDepthOptions(
     {
         errorMsg = "Need at least one chromosome name";
     }
+    else if (opt.threadCount < 1)
+    {
+        errorMsg = "Thread count must be at least 1";
+    }
     else
     {
         for (const std::string& chrom : opt.chromNames)
@@ -32,6 +32,12 @@ struct ChromDepthOptions
     std::string alignmentFilename;
     std::vector<std::string> chromNames;
     std::string outputFilename;
+
+    /// estimate depth from randomly sampled windows instead of scanning segments until the estimate is stable
+    bool isSampleWindows = false;
+
+    /// number of chromosomes to estimate in parallel
+    unsigned threadCount = 1;
 };
 
 
@@ -23,12 +23,14 @@
 #include "ReadChromDepthUtil.hh"
 
 #include "blt_util/log.hh"
+#include "blt_util/OrderedTaskRunner.hh"
 #include "common/OutStream.hh"
 
 #include <cstdlib>
 
 #include <iomanip>
 #include <iostream>
+#include <sstream>
 
 
 
@@ -41,19 +43,32 @@ getChromDepth(const ChromDepthOptions& opt)
         OutStream outs(opt.outputFilename);
     }
 
-    std::vector<double> chromDepth;
-    for (const std::string& chrom : opt.chromNames)
+    // each chromosome is estimated from its own alignment file stream, so chromosomes can run in parallel:
+    auto runChrom = [&](const unsigned /*workerIndex*/, const unsigned chromIndex, TaskOutput& chromOutput)
     {
-        chromDepth.push_back(readChromDepthFromAlignment(opt.alignmentFilename, chrom));
-    }
+        const std::string& chrom(opt.chromNames[chromIndex]);
+        const double chromDepth(opt.isSampleWindows ?
+                                readSampledChromDepthFromAlignment(opt.alignmentFilename, chrom) :
+                                readChromDepthFromAlignment(opt.alignmentFilename, chrom));
+
+        std::ostringstream oss;
+        oss << chrom << "\t" << std::fixed << std::setprecision(2) << chromDepth << "\n";
+        chromOutput.assign(1, oss.str());
+    };
+
+    std::vector<std::string> chromDepthLines;
+    auto writeChrom = [&](const TaskOutput& chromOutput)
+    {
+        chromDepthLines.push_back(chromOutput[0]);
+    };
+
+    runOrderedTasks(opt.threadCount, opt.chromNames.size(), runChrom, writeChrom);
 
     OutStream outs(opt.outputFilename);
     std::ostream& os(outs.getStream());
-
-    const unsigned chromCount(opt.chromNames.size());
-    for (unsigned chromIndex(0); chromIndex<chromCount; ++chromIndex)
+    for (const std::string& line : chromDepthLines)
     {
-        os << opt.chromNames[chromIndex] << "\t" << std::fixed << std::setprecision(2) << chromDepth[chromIndex] << "\n";
+        os << line;
     }
 }
 
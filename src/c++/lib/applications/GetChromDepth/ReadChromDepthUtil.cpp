@@ -34,7 +34,10 @@
 #include "starling_common/starling_read_filter_shared.hh"
 
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <random>
 #include <sstream>
 
 
@@ -360,14 +363,14 @@ getChromSegments(
 
 
 
-double
-readChromDepthFromAlignment(
+/// \return the htslib contig index of chromName, throws if it is not found in the alignment file header
+static
+int32_t
+getChromIndex(
     const std::string& statsAlignmentFile,
+    const bam_header_info& bamHeader,
     const std::string& chromName)
 {
-    bam_streamer read_stream(statsAlignmentFile.c_str());
-    const bam_header_info bamHeader(read_stream.get_header());
-
     const auto& chromToIndex(bamHeader.chrom_to_index);
     const auto chromIter(chromToIndex.find(chromName));
     if (chromIter == chromToIndex.end())
@@ -379,7 +382,20 @@ readChromDepthFromAlignment(
         BOOST_THROW_EXCEPTION(LogicException(oss.str()));
     }
 
-    const int32_t chromIndex(chromIter->second);
+    return chromIter->second;
+}
+
+
+
+double
+readChromDepthFromAlignment(
+    const std::string& statsAlignmentFile,
+    const std::string& chromName)
+{
+    bam_streamer read_stream(statsAlignmentFile.c_str());
+    const bam_header_info bamHeader(read_stream.get_header());
+
+    const int32_t chromIndex(getChromIndex(statsAlignmentFile, bamHeader, chromName));
 
     const unsigned chromSize(bamHeader.chrom_data[chromIndex].length);
     unsigned segmentSize(2000000);
@@ -501,3 +517,148 @@ readChromDepthFromAlignment(
 
     return cdTracker.getDepth();
 }
+
+
+
+/// track the median depth of a chromosome from a series of sampled windows
+///
+/// as in DepthTracker, all reads are assumed to align perfectly in place, and zero depth is removed before
+/// computing the median
+///
+struct SampledDepthTracker
+{
+    /// add the depth of all positions in the zero-indexed window [beginPos,endPos) from reads in the
+    /// current region of readStream
+    void
+    addWindow(
+        const pos_t beginPos,
+        const pos_t endPos,
+        bam_streamer& readStream)
+    {
+        assert(beginPos < endPos);
+        const unsigned windowSize(endPos-beginPos);
+
+        // depth change at each window position, read ends falling after the window are dropped:
+        _depthChange.assign(windowSize+1,0);
+
+        bool isWindowRead(false);
+        while (readStream.next())
+        {
+            const bam_record& bamRead(*(readStream.get_record_ptr()));
+            const pos_t readBeginPos(bamRead.pos()-1);
+            const pos_t readEndPos(readBeginPos+bamRead.read_size());
+            if ((readEndPos <= beginPos) || (readBeginPos >= endPos)) continue;
+
+            isWindowRead=true;
+
+            const READ_FILTER_TYPE::index_t filterId(starling_read_filter_shared(bamRead));
+            if (filterId != READ_FILTER_TYPE::NONE) continue;
+
+            _depthChange[std::max(readBeginPos,beginPos)-beginPos]++;
+            _depthChange[std::min(readEndPos,endPos)-beginPos]--;
+        }
+
+        // windows without reads are skipped so that large gaps in the assembly do not count towards convergence:
+        if (! isWindowRead) return;
+
+        int depth(0);
+        for (unsigned windowPos(0); windowPos<windowSize; ++windowPos)
+        {
+            depth += _depthChange[windowPos];
+            assert(depth >= 0);
+            _mtrack.addObs(depth);
+        }
+        _windowCount++;
+    }
+
+    /// \return true if the confidence interval for the median depth is no wider than the target width
+    ///
+    /// Positions within a window are strongly correlated, so each window is treated as a single observation
+    /// when finding the confidence interval from the quantiles around the median.
+    bool
+    isMedianConverged() const
+    {
+        static const unsigned minWindowCount(20);
+        static const double zScore(1.96);
+        static const double relativeWidth(0.05);
+        static const double minWidth(1.0);
+
+        if (_windowCount < minWindowCount) return false;
+        if (_mtrack.getNonZeroObsCount() == 0) return false;
+
+        const double halfWidth(zScore*0.5/std::sqrt(static_cast<double>(_windowCount)));
+        const unsigned lowDepth(_mtrack.getQuantile(std::max(0.5-halfWidth,0.)));
+        const unsigned highDepth(_mtrack.getQuantile(std::min(0.5+halfWidth,1.)));
+        const double maxWidth(std::max(minWidth, relativeWidth*getDepth()));
+        return ((highDepth-lowDepth) <= maxWidth);
+    }
+
+    double
+    getDepth() const
+    {
+        return _mtrack.getMedian();
+    }
+
+    unsigned
+    getWindowCount() const
+    {
+        return _windowCount;
+    }
+
+private:
+    std::vector<int> _depthChange;
+    MedianDepthTracker _mtrack;
+    unsigned _windowCount = 0;
+};
+
+
+
+double
+readSampledChromDepthFromAlignment(
+    const std::string& statsAlignmentFile,
+    const std::string& chromName)
+{
+    bam_streamer read_stream(statsAlignmentFile.c_str());
+    const bam_header_info bamHeader(read_stream.get_header());
+
+    const int32_t chromIndex(getChromIndex(statsAlignmentFile, bamHeader, chromName));
+    const pos_t chromSize(bamHeader.chrom_data[chromIndex].length);
+
+    static const pos_t windowSize(10000);
+    std::vector<pos_t> windowStartPos;
+    for (pos_t startPos(0); startPos<chromSize; startPos += windowSize)
+    {
+        windowStartPos.push_back(startPos);
+    }
+
+    // shuffle the window order with a fixed seed so that the sample does not change between runs:
+    {
+        std::mt19937 rng(windowStartPos.size());
+        for (unsigned windowIndex(windowStartPos.size()); windowIndex>1; --windowIndex)
+        {
+            std::swap(windowStartPos[windowIndex-1], windowStartPos[rng() % windowIndex]);
+        }
+    }
+
+    SampledDepthTracker sdTracker;
+
+    static const unsigned convergenceCheckWindowCount(10);
+    for (const pos_t startPos : windowStartPos)
+    {
+        const pos_t endPos(std::min(startPos+windowSize,chromSize));
+        read_stream.resetRegion(chromIndex, startPos, endPos);
+        const unsigned lastWindowCount(sdTracker.getWindowCount());
+        sdTracker.addWindow(startPos, endPos, read_stream);
+
+        if (sdTracker.getWindowCount() == lastWindowCount) continue;
+        if ((sdTracker.getWindowCount() % convergenceCheckWindowCount) != 0) continue;
+        if (sdTracker.isMedianConverged()) break;
+    }
+
+#ifdef DEBUG_DPS
+    log_os << "Sampled depth for chrom: " << chromName << " windows: " << sdTracker.getWindowCount()
+           << " depth: " << sdTracker.getDepth() << "\n";
+#endif
+
+    return sdTracker.getDepth();
+}
@@ -30,7 +30,20 @@
 /// fast chrom depth estimator for BAM/CRAM files
 ///
 /// return average chromosome depth
+/// estimate the median depth of a chromosome by scanning reads from segments distributed across the chromosome
+/// until the depth estimate stops changing
 double
 readChromDepthFromAlignment(
     const std::string& statsAlignmentFile,
     const std::string& chromName);
+
+/// estimate the median depth of a chromosome from fixed-size windows sampled in random order through the
+/// alignment file index
+///
+/// Windows are sampled until a confidence interval on the median depth is narrow enough, or the whole
+/// chromosome has been sampled. Window order is seeded deterministically, so that repeated runs over the
+/// same alignment file produce the same estimate.
+double
+readSampledChromDepthFromAlignment(
+    const std::string& statsAlignmentFile,
+    const std::string& chromName);
@@ -0,0 +1,181 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "BalancedSegmentUtil.hh"
+
+#include <algorithm>
+#include <cassert>
+
+
+
+/// allocate totalCount segments to contigs by largest remainder of each contig's share, such that every contig
+/// gets at least one segment and no more segments than it has windows
+///
+static
+void
+allocateSegmentCounts(
+    const std::vector<double>& shares,
+    const std::vector<unsigned>& maxCounts,
+    const uint64_t totalCount,
+    std::vector<unsigned>& counts)
+{
+    const unsigned contigCount(shares.size());
+    counts.resize(contigCount);
+    uint64_t allocatedCount(0);
+    for (unsigned contigIndex(0); contigIndex<contigCount; ++contigIndex)
+    {
+        counts[contigIndex] = std::min(maxCounts[contigIndex], std::max(1u, static_cast<unsigned>(shares[contigIndex])));
+        allocatedCount += counts[contigIndex];
+    }
+
+    // remove segments from the contigs furthest above their share, then add segments to the contigs furthest below:
+    while (allocatedCount > totalCount)
+    {
+        int bestIndex(-1);
+        for (unsigned contigIndex(0); contigIndex<contigCount; ++contigIndex)
+        {
+            if (counts[contigIndex] <= 1) continue;
+            if ((bestIndex < 0) ||
+                ((counts[contigIndex] - shares[contigIndex]) > (counts[bestIndex] - shares[bestIndex])))
+            {
+                bestIndex = contigIndex;
+            }
+        }
+        if (bestIndex < 0) break;
+        counts[bestIndex]--;
+        allocatedCount--;
+    }
+
+    while (allocatedCount < totalCount)
+    {
+        int bestIndex(-1);
+        for (unsigned contigIndex(0); contigIndex<contigCount; ++contigIndex)
+        {
+            if (counts[contigIndex] >= maxCounts[contigIndex]) continue;
+            if ((bestIndex < 0) ||
+                ((shares[contigIndex] - counts[contigIndex]) > (shares[bestIndex] - counts[bestIndex])))
+            {
+                bestIndex = contigIndex;
+            }
+        }
+        if (bestIndex < 0) break;
+        counts[bestIndex]++;
+        allocatedCount++;
+    }
+}
+
+
+
+void
+getBalancedSegments(
+    const std::vector<AlignmentIndexDensity::Contig>& contigs,
+    const unsigned windowSize,
+    const unsigned targetSegmentSize,
+    const double baseWorkFraction,
+    std::vector<GenomeSegment>& segments)
+{
+    assert(windowSize > 0);
+    assert(targetSegmentSize > 0);
+
+    segments.clear();
+
+    uint64_t totalLength(0);
+    uint64_t uniformSegmentCount(0);
+    double totalBytes(0);
+    for (const AlignmentIndexDensity::Contig& contig : contigs)
+    {
+        if (contig.length == 0) continue;
+        totalLength += contig.length;
+        uniformSegmentCount += 1 + ((contig.length-1) / targetSegmentSize);
+        for (const double bytes : contig.windowBytes)
+        {
+            totalBytes += bytes;
+        }
+    }
+
+    if (totalLength == 0) return;
+
+    // without any alignment data this reduces to balancing segment length:
+    const double positionWork((totalBytes > 0.) ? (baseWorkFraction * totalBytes / totalLength) : 1.);
+    const double totalWork(totalBytes + positionWork * totalLength);
+    const double targetWork(totalWork / uniformSegmentCount);
+
+    // allocate segments to contigs in proportion to their work:
+    std::vector<double> contigShares;
+    std::vector<unsigned> contigWindowCounts;
+    for (const AlignmentIndexDensity::Contig& contig : contigs)
+    {
+        if (contig.length == 0) continue;
+        assert(contig.windowBytes.size() == ((contig.length + windowSize - 1) / windowSize));
+
+        double contigBytes(0);
+        for (const double bytes : contig.windowBytes)
+        {
+            contigBytes += bytes;
+        }
+        contigShares.push_back((contigBytes + positionWork*contig.length) / targetWork);
+        contigWindowCounts.push_back(contig.windowBytes.size());
+    }
+
+    std::vector<unsigned> contigSegmentCounts;
+    allocateSegmentCounts(contigShares, contigWindowCounts, uniformSegmentCount, contigSegmentCounts);
+
+    std::vector<double> cumulativeWork;
+    unsigned contigIndex(0);
+    for (const AlignmentIndexDensity::Contig& contig : contigs)
+    {
+        if (contig.length == 0) continue;
+
+        // cumulative work at each window boundary of the contig:
+        const unsigned windowCount(contig.windowBytes.size());
+        cumulativeWork.assign(1, 0.);
+        for (unsigned windowIndex(0); windowIndex<windowCount; ++windowIndex)
+        {
+            const unsigned windowLength(std::min(windowSize, contig.length - windowIndex*windowSize));
+            cumulativeWork.push_back(cumulativeWork.back() + contig.windowBytes[windowIndex] + positionWork*windowLength);
+        }
+
+        // split the contig into segments of equal work, cutting at the window boundary closest to each threshold:
+        const unsigned contigSegmentCount(contigSegmentCounts[contigIndex++]);
+        const double segmentWork(cumulativeWork.back() / contigSegmentCount);
+
+        unsigned segmentBeginPos(0);
+        unsigned lastBoundaryIndex(0);
+        for (unsigned segmentIndex(1); segmentIndex<contigSegmentCount; ++segmentIndex)
+        {
+            const double threshold(segmentIndex * segmentWork);
+            unsigned boundaryIndex(std::lower_bound(cumulativeWork.begin(), cumulativeWork.end(), threshold) - cumulativeWork.begin());
+            if ((boundaryIndex > 0) && ((cumulativeWork[boundaryIndex] - threshold) > (threshold - cumulativeWork[boundaryIndex-1])))
+            {
+                boundaryIndex--;
+            }
+
+            // keep every segment non-empty, leaving at least one window for each segment still to be cut:
+            boundaryIndex = std::max(boundaryIndex, lastBoundaryIndex+1);
+            boundaryIndex = std::min(boundaryIndex, windowCount - (contigSegmentCount - segmentIndex));
+
+            const unsigned segmentEndPos(boundaryIndex * windowSize);
+            segments.push_back({contig.name, segmentBeginPos, segmentEndPos});
+            segmentBeginPos = segmentEndPos;
+            lastBoundaryIndex = boundaryIndex;
+        }
+        segments.push_back({contig.name, segmentBeginPos, contig.length});
+    }
+}
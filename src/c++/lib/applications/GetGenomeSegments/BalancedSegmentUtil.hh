@@ -0,0 +1,52 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#pragma once
+
+#include "htsapi/AlignmentIndexDensity.hh"
+
+#include <string>
+#include <vector>
+
+
+/// a zero-indexed, half-open contig interval
+struct GenomeSegment
+{
+    std::string chrom;
+    unsigned beginPos;
+    unsigned endPos;
+};
+
+
+/// split contigs into segments with approximately equal estimated work
+///
+/// The work of each window is its estimated alignment bytes, plus a per-position cost equal to baseWorkFraction
+/// times the mean bytes per position over all contigs, which stands in for work that is independent of read
+/// depth. The total work is split into as many segments as a uniform segmentation of each contig into
+/// segments no larger than targetSegmentSize would produce, given that windowSize is not larger than
+/// targetSegmentSize. Segments never span contigs and are only cut at window boundaries.
+///
+void
+getBalancedSegments(
+    const std::vector<AlignmentIndexDensity::Contig>& contigs,
+    const unsigned windowSize,
+    const unsigned targetSegmentSize,
+    const double baseWorkFraction,
+    std::vector<GenomeSegment>& segments);
@@ -0,0 +1,68 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "GetGenomeSegments.hh"
+#include "BalancedSegmentUtil.hh"
+#include "GetGenomeSegmentsOptions.hh"
+
+#include "common/OutStream.hh"
+#include "htsapi/AlignmentIndexDensity.hh"
+
+#include <iostream>
+
+
+
+static
+void
+getGenomeSegments(const GetGenomeSegmentsOptions& opt)
+{
+    // check that we have write permission on the output file early:
+    {
+        OutStream outs(opt.outputFilename);
+    }
+
+    AlignmentIndexDensity density(opt.windowSize);
+    for (const std::string& alignmentFilename : opt.alignmentFilenames)
+    {
+        density.addAlignmentFile(alignmentFilename);
+    }
+
+    std::vector<GenomeSegment> segments;
+    getBalancedSegments(density.getContigs(), density.getWindowSize(), opt.segmentSize, opt.baseWorkFraction, segments);
+
+    OutStream outs(opt.outputFilename);
+    std::ostream& os(outs.getStream());
+    for (const GenomeSegment& segment : segments)
+    {
+        os << segment.chrom << "\t" << segment.beginPos << "\t" << segment.endPos << "\n";
+    }
+}
+
+
+
+void
+GetGenomeSegments::
+runInternal(int argc, char* argv[]) const
+{
+    GetGenomeSegmentsOptions opt;
+
+    parseGetGenomeSegmentsOptions(*this,argc,argv,opt);
+    getGenomeSegments(opt);
+}
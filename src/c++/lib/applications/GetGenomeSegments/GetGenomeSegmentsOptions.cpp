@@ -0,0 +1,137 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+
+#include "GetGenomeSegmentsOptions.hh"
+
+#include "blt_util/log.hh"
+#include "common/ProgramUtil.hh"
+#include "options/optionsUtil.hh"
+
+#include "boost/program_options.hpp"
+
+#include <iostream>
+
+typedef std::vector<std::string> files_t;
+
+
+static
+void
+usage(
+    std::ostream& os,
+    const illumina::Program& prog,
+    const boost::program_options::options_description& visible,
+    const char* msg = nullptr)
+{
+    usage(os, prog, visible, "split the genome into segments with balanced alignment data", " [ > output ]", msg);
+}
+
+
+
+void
+parseGetGenomeSegmentsOptions(
+    const illumina::Program& prog,
+    int argc, char* argv[],
+    GetGenomeSegmentsOptions& opt)
+{
+    namespace po = boost::program_options;
+    po::options_description req("configuration");
+    req.add_options()
+    ("align-file", po::value<files_t>(),
+     "alignment file in BAM or CRAM format, the file must be indexed. May be supplied more than once. "
+     "At least one entry required.")
+    ("output-file", po::value(&opt.outputFilename),
+     "write segments in BED format to filename (default: stdout)")
+    ("segment-size", po::value(&opt.segmentSize)->default_value(opt.segmentSize),
+     "the genome is split into the same number of segments as a uniform split of each contig into segments "
+     "no larger than this size")
+    ("window-size", po::value(&opt.windowSize)->default_value(opt.windowSize),
+     "size of the windows in which alignment data is estimated, segments are only cut at window boundaries")
+    ("base-work-fraction", po::value(&opt.baseWorkFraction)->default_value(opt.baseWorkFraction),
+     "work assigned to each position independent of its alignment data, as a fraction of the mean "
+     "alignment data per position")
+    ;
+
+    po::options_description help("help");
+    help.add_options()
+    ("help,h","print this message");
+
+    po::options_description visible("options");
+    visible.add(req).add(help);
+
+    bool po_parse_fail(false);
+    po::variables_map vm;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, visible,
+                                         po::command_line_style::unix_style ^ po::command_line_style::allow_short), vm);
+        po::notify(vm);
+    }
+    catch (const boost::program_options::error& e)     // todo:: find out what is the more specific exception class thrown by program options
+    {
+        log_os << "\nERROR: Exception thrown by option parser: " << e.what() << "\n";
+        po_parse_fail=true;
+    }
+
+    if ((argc<=1) || (vm.count("help")) || po_parse_fail)
+    {
+        usage(log_os,prog,visible);
+    }
+
+    if (vm.count("align-file"))
+    {
+        opt.alignmentFilenames=(boost::any_cast<files_t>(vm["align-file"].value()));
+    }
+
+    std::string errorMsg;
+    if (opt.alignmentFilenames.empty())
+    {
+        errorMsg = "Need at least one alignment file";
+    }
+    else if (opt.windowSize < 1)
+    {
+        errorMsg = "Window size must be at least 1";
+    }
+    else if (opt.segmentSize < 1)
+    {
+        errorMsg = "Segment size must be at least 1";
+    }
+    else if (opt.windowSize > opt.segmentSize)
+    {
+        errorMsg = "Window size must not be larger than the segment size";
+    }
+    else if (opt.baseWorkFraction < 0.)
+    {
+        errorMsg = "Base work fraction must not be negative";
+    }
+    else
+    {
+        for (std::string& alignmentFilename : opt.alignmentFilenames)
+        {
+            if (checkStandardizeInputFile(alignmentFilename, "alignment", errorMsg)) break;
+        }
+    }
+
+    if (! errorMsg.empty())
+    {
+        usage(log_os, prog, visible, errorMsg.c_str());
+    }
+}
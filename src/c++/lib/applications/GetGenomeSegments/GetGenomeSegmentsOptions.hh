@@ -0,0 +1,49 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#pragma once
+
+#include "common/Program.hh"
+
+#include <string>
+#include <vector>
+
+
+struct GetGenomeSegmentsOptions
+{
+    std::vector<std::string> alignmentFilenames;
+    std::string outputFilename;
+
+    /// resolution of the alignment density estimate
+    unsigned windowSize = 16384;
+
+    /// the number of segments produced matches a uniform segmentation of this size
+    unsigned segmentSize = 12000000;
+
+    /// the depth independent work of each position, as a fraction of the mean estimated bytes per position
+    double baseWorkFraction = 0.1;
+};
+
+
+void
+parseGetGenomeSegmentsOptions(
+    const illumina::Program& prog,
+    int argc, char* argv[],
+    GetGenomeSegmentsOptions& opt);
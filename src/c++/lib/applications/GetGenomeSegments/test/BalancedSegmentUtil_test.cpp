@@ -0,0 +1,135 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "boost/test/unit_test.hpp"
+
+#include "BalancedSegmentUtil.hh"
+
+
+BOOST_AUTO_TEST_SUITE( BalancedSegmentUtil_test )
+
+
+static
+AlignmentIndexDensity::Contig
+getContig(
+    const std::string& name,
+    const unsigned length,
+    const std::vector<double>& windowBytes)
+{
+    AlignmentIndexDensity::Contig contig;
+    contig.name = name;
+    contig.length = length;
+    contig.windowBytes = windowBytes;
+    return contig;
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_uniformDensity )
+{
+    // without alignment data, the segmentation should match a uniform split:
+    const std::vector<AlignmentIndexDensity::Contig> contigs =
+    {
+        getContig("chr1", 1000, std::vector<double>(10, 0.)),
+        getContig("chr2", 450, std::vector<double>(5, 0.))
+    };
+
+    std::vector<GenomeSegment> segments;
+    getBalancedSegments(contigs, 100, 500, 0.1, segments);
+
+    BOOST_REQUIRE_EQUAL(segments.size(), 3u);
+    BOOST_REQUIRE_EQUAL(segments[0].chrom, "chr1");
+    BOOST_REQUIRE_EQUAL(segments[0].beginPos, 0u);
+    BOOST_REQUIRE_EQUAL(segments[0].endPos, 500u);
+    BOOST_REQUIRE_EQUAL(segments[1].beginPos, 500u);
+    BOOST_REQUIRE_EQUAL(segments[1].endPos, 1000u);
+    BOOST_REQUIRE_EQUAL(segments[2].chrom, "chr2");
+    BOOST_REQUIRE_EQUAL(segments[2].beginPos, 0u);
+    BOOST_REQUIRE_EQUAL(segments[2].endPos, 450u);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_skewedDensity )
+{
+    // a dense region at the start of the contig should get shorter segments:
+    std::vector<double> windowBytes(10, 10.);
+    windowBytes[0] = 400.;
+    windowBytes[1] = 400.;
+    const std::vector<AlignmentIndexDensity::Contig> contigs = { getContig("chr1", 1000, windowBytes) };
+
+    std::vector<GenomeSegment> segments;
+    getBalancedSegments(contigs, 100, 500, 0., segments);
+
+    BOOST_REQUIRE_EQUAL(segments.size(), 2u);
+    BOOST_REQUIRE_EQUAL(segments[0].beginPos, 0u);
+    BOOST_REQUIRE_EQUAL(segments[0].endPos, 100u);
+    BOOST_REQUIRE_EQUAL(segments[1].beginPos, 100u);
+    BOOST_REQUIRE_EQUAL(segments[1].endPos, 1000u);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_segmentCountMatchesUniform )
+{
+    // two contigs with 1.5 segments of work each and one contig without work should still produce the three
+    // segments of a uniform split, rather than rounding each contig's count independently:
+    const std::vector<AlignmentIndexDensity::Contig> contigs =
+    {
+        getContig("chr1", 1000, std::vector<double>(10, 15.)),
+        getContig("chr2", 1000, std::vector<double>(10, 15.)),
+        getContig("chr3", 1000, std::vector<double>(10, 0.))
+    };
+
+    std::vector<GenomeSegment> segments;
+    getBalancedSegments(contigs, 100, 1000, 0., segments);
+
+    BOOST_REQUIRE_EQUAL(segments.size(), 3u);
+    for (unsigned segmentIndex(0); segmentIndex<3; ++segmentIndex)
+    {
+        BOOST_REQUIRE_EQUAL(segments[segmentIndex].beginPos, 0u);
+        BOOST_REQUIRE_EQUAL(segments[segmentIndex].endPos, 1000u);
+    }
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_shortContigSegmentCount )
+{
+    // a dense contig with fewer windows than its share of segments gives the remainder to other contigs:
+    std::vector<double> windowBytes(20, 1.);
+    const std::vector<AlignmentIndexDensity::Contig> contigs =
+    {
+        getContig("chr1", 200, std::vector<double>(2, 1000.)),
+        getContig("chr2", 2000, windowBytes)
+    };
+
+    std::vector<GenomeSegment> segments;
+    getBalancedSegments(contigs, 100, 200, 0., segments);
+
+    BOOST_REQUIRE_EQUAL(segments.size(), 11u);
+    BOOST_REQUIRE_EQUAL(segments[0].endPos, 100u);
+    BOOST_REQUIRE_EQUAL(segments[1].beginPos, 100u);
+    BOOST_REQUIRE_EQUAL(segments[1].endPos, 200u);
+    BOOST_REQUIRE_EQUAL(segments.back().chrom, "chr2");
+    BOOST_REQUIRE_EQUAL(segments.back().endPos, 2000u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -70,9 +70,9 @@ processTrueIndelVariantRecord(
     ///
 
     // N.B. ignoring SNPs and indels with multiple alts for now
-    if (vcfr.is_indel() && vcfr.alt.size() == 1)
+    if (vcfr.is_indel() && vcfr.getAltCount() == 1)
     {
-        const unsigned altCount(vcfr.alt.size());
+        const unsigned altCount(vcfr.getAltCount());
 
         for (unsigned altIndex(0); altIndex<altCount; ++altIndex)
         {
@@ -120,7 +120,8 @@ getSequenceErrorCountsRun(
     std::vector<std::reference_wrapper<const bam_hdr_t>> bamHeaders;
     {
         std::vector<unsigned> registrationIndices(opt.alignFileOpt.alignmentFilename.size(), 0);
-        bamHeaders = registerAlignments(opt.alignFileOpt.alignmentFilename, registrationIndices, streamData);
+        bamHeaders = registerAlignments(opt.alignFileOpt.alignmentFilename, registrationIndices, streamData,
+                                        opt.isAlignmentPrefetch);
 
         assert(not bamHeaders.empty());
         const bam_hdr_t& referenceHeader(bamHeaders.front());
@@ -0,0 +1,118 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#include "MBSOptions.hh"
+
+#include "blt_util/log.hh"
+#include "common/ProgramUtil.hh"
+
+#include "boost/filesystem.hpp"
+#include "boost/program_options.hpp"
+
+#include <iostream>
+#include <set>
+#include <sstream>
+
+
+
+static
+void
+usage(
+    std::ostream& os,
+    const illumina::Program& prog,
+    const boost::program_options::options_description& visible,
+    const char* msg = nullptr)
+{
+    usage(os, prog, visible, "Merge BGZF segment files and their index fragments into a tabix indexed file", "", msg);
+}
+
+
+
+void
+parseMBSOptions(
+    const illumina::Program& prog,
+    int argc, char* argv[],
+    MBSOptions& opt)
+{
+    namespace po = boost::program_options;
+    po::options_description req("configuration");
+
+    req.add_options()
+    ("segment-file", po::value(&opt.segmentFilenames),
+     "input BGZF segment file, segments are merged in the order given (may be specified multiple times)")
+    ("output-file", po::value(&opt.outputFilename),
+     "merged output file, the tabix index is written to this filename with a '.tbi' extension (required)")
+    ("header-cmdline", po::value(&opt.headerCmdline),
+     "replace the value of the '##cmdline' header line in the merged output");
+
+    po::options_description help("help");
+    help.add_options()
+    ("help,h","print this message");
+
+    po::options_description visible("options");
+    visible.add(req).add(help);
+
+    bool po_parse_fail(false);
+    po::variables_map vm;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, visible,
+                                         po::command_line_style::unix_style ^ po::command_line_style::allow_short), vm);
+        po::notify(vm);
+    }
+    catch (const boost::program_options::error& e)
+    {
+        log_os << "\nERROR: Exception thrown by option parser: " << e.what() << "\n";
+        po_parse_fail=true;
+    }
+
+    if ((argc<=1) || (vm.count("help")) || po_parse_fail)
+    {
+        usage(log_os,prog,visible);
+    }
+
+    if (opt.segmentFilenames.empty())
+    {
+        usage(log_os,prog,visible, "Must specify at least 1 input segment file");
+    }
+
+    std::set<std::string> dupCheck;
+    for (const std::string& segmentFilename : opt.segmentFilenames)
+    {
+        if (! boost::filesystem::exists(segmentFilename))
+        {
+            std::ostringstream oss;
+            oss << "Segment file does not exist: '" << segmentFilename << "'";
+            usage(log_os,prog,visible,oss.str().c_str());
+        }
+
+        if (dupCheck.find(segmentFilename) != dupCheck.end())
+        {
+            std::ostringstream oss;
+            oss << "Same segment file submitted multiple times: '" << segmentFilename << "'";
+            usage(log_os,prog,visible,oss.str().c_str());
+        }
+        dupCheck.insert(segmentFilename);
+    }
+
+    if (opt.outputFilename.empty())
+    {
+        usage(log_os,prog,visible, "Must specify merged output file");
+    }
+}
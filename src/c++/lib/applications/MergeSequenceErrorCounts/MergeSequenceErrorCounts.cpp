@@ -24,10 +24,13 @@
 
 #include "MergeSequenceErrorCounts.hh"
 #include "MSECOptions.hh"
-#include "errorAnalysis/SequenceErrorCounts.hh"
+#include "errorAnalysis/SequenceErrorCountsFile.hh"
 
+#include "common/Exceptions.hh"
 #include "common/OutStream.hh"
 
+#include <sstream>
+
 
 
 static
@@ -39,24 +42,20 @@ runMSEC(const MSECOptions& opt)
         OutStream outs(opt.outputFilename);
     }
 
-    SequenceErrorCounts mergedCounts;
-    bool isFirst(true);
     for (const std::string& countsFilename : opt.countsFilename)
     {
-        if (isFirst)
-        {
-            mergedCounts.load(countsFilename.c_str());
-            isFirst=false;
-        }
-        else
+        if (not isSequenceErrorCountsFile(countsFilename))
         {
-            SequenceErrorCounts inputCounts;
-            inputCounts.load(countsFilename.c_str());
-            mergedCounts.merge(inputCounts);
+            using namespace illumina::common;
+
+            std::ostringstream oss;
+            oss << "ERROR: Input counts file '" << countsFilename << "' is not in the current sequence error counts"
+                << " format, older files can be updated with ConvertSequenceErrorCounts";
+            BOOST_THROW_EXCEPTION(LogicException(oss.str()));
         }
     }
 
-    mergedCounts.save(opt.outputFilename.c_str());
+    mergeSequenceErrorCountsFiles(opt.countsFilename, opt.outputFilename);
 }
 
 
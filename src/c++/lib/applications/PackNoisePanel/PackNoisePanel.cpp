@@ -0,0 +1,177 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#include "PackNoisePanel.hh"
+#include "PNPOptions.hh"
+
+#include "htsapi/vcf_streamer.hh"
+#include "strelka_common/SiteNoiseTrackWriter.hh"
+
+#include <memory>
+#include <set>
+
+
+
+namespace
+{
+
+/// iterate through the SNV site noise of one noise panel vcf for one contig at a time
+///
+struct NoiseVcfReader
+{
+    explicit
+    NoiseVcfReader(const std::string& filename)
+        : _stream(filename.c_str(), nullptr)
+    {}
+
+    std::vector<std::string>
+    getContigNames() const
+    {
+        return _stream.getIndexSequenceNames();
+    }
+
+    void
+    resetContig(const std::string& contigName)
+    {
+        _stream.resetRegion(contigName.c_str());
+        next();
+    }
+
+    /// \return true if the current contig has more site noise
+    bool
+    isNoise() const
+    {
+        return _isNoise;
+    }
+
+    pos_t
+    getPos() const
+    {
+        return _pos;
+    }
+
+    const SiteNoise&
+    getSiteNoise() const
+    {
+        return _sn;
+    }
+
+    /// advance to the next SNV record, only SNVs are read from a noise vcf by strelka
+    void
+    next()
+    {
+        _isNoise = false;
+        while (_stream.next())
+        {
+            const vcf_record& vcfRecord(*_stream.get_record_ptr());
+            if (not vcfRecord.is_snv()) continue;
+
+            _pos = (vcfRecord.pos - 1);
+            _sn.clear();
+            set_noise_from_vcf(vcfRecord.line, _sn);
+            _isNoise = true;
+            break;
+        }
+    }
+
+private:
+    vcf_streamer _stream;
+    bool _isNoise = false;
+    pos_t _pos = 0;
+    SiteNoise _sn;
+};
+
+}
+
+
+
+/// merge site noise from all panel files in position order, where the noise from a later record at the same
+/// position replaces earlier noise, matching how strelka combines the records of several noise vcfs
+static
+void
+packNoisePanel(
+    const std::vector<std::string>& noiseVcfFilenames,
+    const std::string& outputFilename)
+{
+    std::vector<std::unique_ptr<NoiseVcfReader>> readers;
+    std::vector<std::string> contigNames;
+    std::set<std::string> contigNameSet;
+    for (const std::string& noiseVcfFilename : noiseVcfFilenames)
+    {
+        readers.emplace_back(new NoiseVcfReader(noiseVcfFilename));
+        for (const std::string& contigName : readers.back()->getContigNames())
+        {
+            if (contigNameSet.insert(contigName).second) contigNames.push_back(contigName);
+        }
+    }
+
+    SiteNoiseTrackWriter writer(outputFilename);
+    for (const std::string& contigName : contigNames)
+    {
+        for (auto& reader : readers)
+        {
+            reader->resetContig(contigName);
+        }
+
+        bool isLastNoise(false);
+        pos_t lastPos(0);
+        SiteNoise lastSiteNoise;
+        while (true)
+        {
+            // the first reader with the lowest position is next in merge order:
+            NoiseVcfReader* nextReaderPtr(nullptr);
+            for (auto& reader : readers)
+            {
+                if (not reader->isNoise()) continue;
+                if ((nullptr == nextReaderPtr) or (reader->getPos() < nextReaderPtr->getPos()))
+                {
+                    nextReaderPtr = reader.get();
+                }
+            }
+            if (nullptr == nextReaderPtr) break;
+
+            if (isLastNoise and (nextReaderPtr->getPos() != lastPos))
+            {
+                writer.addSiteNoise(contigName, lastPos, lastSiteNoise);
+            }
+            isLastNoise = true;
+            lastPos = nextReaderPtr->getPos();
+            lastSiteNoise = nextReaderPtr->getSiteNoise();
+            nextReaderPtr->next();
+        }
+
+        if (isLastNoise)
+        {
+            writer.addSiteNoise(contigName, lastPos, lastSiteNoise);
+        }
+    }
+    writer.finalize();
+}
+
+
+
+void
+PackNoisePanel::
+runInternal(int argc, char* argv[]) const
+{
+    PNPOptions opt;
+
+    parsePNPOptions(*this,argc,argv,opt);
+    packNoisePanel(opt.noiseVcfFilenames, opt.outputFilename);
+}
@@ -23,7 +23,7 @@
 ///
 
 #include "denovo_snv_caller.hh"
-#include "denovo_snv_grid_states.hh"
+#include "denovo_snv_transmission.hh"
 #include "blt_util/math_util.hh"
 #include "blt_util/prob_util.hh"
 #include "blt_util/qscore.hh"
@@ -42,118 +42,6 @@
 
 
 
-typedef std::array<blt_float_t,DIGT_DGRID::SIZE> dsnv_state_t;
-
-
-
-namespace TRANSMISSION_STATE
-{
-// "ERROR" represents a de-novo event that is incredibly unlikely (multiple events)
-//  -- we could also put it in the denovo state and just use the denovo prior
-// squared to get the same result -- then the dominant term would actually be the
-// probably of an erroneous copy number observation in the sample instead.
-enum index_t
-{
-    INHERITED,
-    DENOVO,
-    ERROR,
-    SIZE
-};
-
-#ifdef DENOVO_SNV_DEBUG2
-static
-const char*
-getLabel(
-    const index_t idx)
-{
-    switch (idx)
-    {
-    case INHERITED:
-        return "INHERITED";
-    case DENOVO:
-        return "DENOVO";
-    case ERROR:
-        return "ERROR";
-    default:
-        assert(false && "Unknown transmission state");
-        return nullptr;
-    }
-}
-#endif
-
-// temporary fixed priors:
-static
-double
-getPrior(
-    const index_t idx)
-{
-    // as currently defined background exp is I: 15/27 E: 2/27 D: 10/27 -- compared to drate this doesn't matter
-    static const double lndrate(std::log(1e-6));
-    static const double noiserate(std::log(1e-7));
-    switch (idx)
-    {
-    case INHERITED:
-        return 0.;
-    case DENOVO:
-        return lndrate;
-    case ERROR:
-        return noiserate;
-    default:
-        assert(false && "Undefined inheritance state");
-        return 0.;
-    }
-}
-
-static const unsigned alleleCount(2);
-typedef std::array<uint8_t,alleleCount> alleleSet_t;
-
-static
-unsigned
-getTransmissionErrorCount(
-    const alleleSet_t& pA,
-    const alleleSet_t& pB,
-    const alleleSet_t& c)
-{
-    unsigned val(0);
-    if ((c[0] != pA[0]) && (c[0] != pA[1])) val += 1;
-    if ((c[1] != pB[0]) && (c[1] != pB[1])) val += 1;
-    return val;
-}
-
-static
-index_t
-get_state(
-    const unsigned parent0GT,
-    const unsigned parent1GT,
-    const unsigned probandGT)
-{
-    alleleSet_t parent0Alleles;
-    alleleSet_t parent1Alleles;
-    alleleSet_t probandAlleles;
-    for (unsigned alleleIndex(0); alleleIndex<alleleCount; ++alleleIndex)
-    {
-        parent0Alleles[alleleIndex] = DIGT::get_allele(parent0GT,alleleIndex);
-        parent1Alleles[alleleIndex] = DIGT::get_allele(parent1GT,alleleIndex);
-        probandAlleles[alleleIndex] = DIGT::get_allele(probandGT,alleleIndex);
-    }
-    const unsigned errorCount(std::min(getTransmissionErrorCount(parent0Alleles,parent1Alleles,probandAlleles),getTransmissionErrorCount(parent1Alleles,parent0Alleles,probandAlleles)));
-    switch (errorCount)
-    {
-    case 0:
-        return INHERITED;
-    case 1:
-        return DENOVO;
-    case 2:
-        return ERROR;
-    default:
-        assert(false && "Unexpected error count value");
-        return ERROR;
-    }
-}
-}
-
-
-
 template <typename Iter>
 typename std::iterator_traits<Iter>::difference_type
 max_element_index(Iter b, Iter e)
@@ -182,9 +70,6 @@ struct DenovoResultMaker
         const unsigned probandIndex(sinfo.getTypeIndexList(PROBAND)[0]);
         const std::vector<unsigned>& parentIndices(sinfo.getTypeIndexList(PARENT));
 
-        static const double lnzero(-std::numeric_limits<double>::infinity());
-        std::fill(stateLhood.begin(),stateLhood.end(),lnzero);
-
         // partial brute force enumeration of all parent-child genotypes:
         //  find max_gt from parents and children, translate this into a candidate allele pool
         //   enumerate all genotypes in all samples from the candidate allele pool only.
@@ -210,38 +95,8 @@ struct DenovoResultMaker
 
         }
 
-        auto isFilterGT = [&](const unsigned gt)
-        {
-            return (! (max_alleles[DIGT::get_allele(gt,0)] && max_alleles[DIGT::get_allele(gt,1)]));
-        };
-
-        for (unsigned parent0GT(0); parent0GT<DIGT::SIZE; ++parent0GT)
-        {
-            if (isFilterGT(parent0GT)) continue;
-            for (unsigned parent1GT(0); parent1GT<DIGT::SIZE; ++parent1GT)
-            {
-                if (isFilterGT(parent1GT)) continue;
-                for (unsigned probandGT(0); probandGT<DIGT::SIZE; ++probandGT)
-                {
-                    if (isFilterGT(probandGT)) continue;
-
-
-                    const double pedigreeLhood = sampleLhood[parentIndices[0]][parent0GT] + sampleLhood[parentIndices[1]][parent1GT] + sampleLhood[probandIndex][probandGT];
-                    const TRANSMISSION_STATE::index_t tran(TRANSMISSION_STATE::get_state(parent0GT,parent1GT,probandGT));
-#ifdef DENOVO_SNV_DEBUG
-                    {
-                        using namespace TRANSMISSION_STATE;
-                        log_os << "p0gt/p1/c: "
-                               << DIGT::label(parent0GT) << "(" << parent0GT << ")"
-                               << DIGT::label(parent1GT) << " "
-                               << DIGT::label(probandGT) << "\n";
-//							   " trans_state: " << getLabel(tran) << " lhood: " << pedigreeLhood << "\n";
-                    }
-#endif
-                    stateLhood[tran] = log_sum(stateLhood[tran],pedigreeLhood);
-                }
-            }
-        }
+        getTrioTransmissionStateLhood(sampleLhood[parentIndices[0]], sampleLhood[parentIndices[1]],
+                                      sampleLhood[probandIndex], max_alleles, stateLhood);
         processStateLhood(rs);
 
 
@@ -261,35 +116,10 @@ struct DenovoResultMaker
         const unsigned probandIndex(sinfo.getTypeIndexList(PROBAND)[0]);
         const std::vector<unsigned>& parentIndices(sinfo.getTypeIndexList(PARENT));
 
-        auto isFilterGT = [&](const unsigned gt)
-        {
-            return (! (max_alleles[DIGT::get_allele(gt,0)] && max_alleles[DIGT::get_allele(gt,1)]));
-        };
-
         // apart from the regular genotype analysis, we go through a bunch of noise states and
         // dump these into the "error' transmission state
-        //
-        // these are all non-standard allele frequencies shared among all samples --
-        // 99% of the time this is meant to catch low-frequency alt noise shared in all three
-        // samples (if all were sequenced to a very high depth) but spuriously more prevalent
-        // in the proband due to low-depth sampling issues:
-        static const unsigned ratioCount(DIGT_DGRID::HET_RES*2);
-        for (unsigned hetIndex(0); hetIndex<(DIGT::HET_SIZE); hetIndex++)
-        {
-            const unsigned hetGT(hetIndex+N_BASE);
-            if (isFilterGT(hetGT)) continue;
-            for (unsigned ratioIndex(0); ratioIndex<ratioCount; ++ratioIndex)
-            {
-                const unsigned noiseState(DIGT::SIZE+(ratioIndex*DIGT::HET_SIZE)+hetIndex);
-                const double errorLhood =
-                    sampleLhood[parentIndices[0]][noiseState] +
-                    sampleLhood[parentIndices[1]][noiseState] +
-                    sampleLhood[probandIndex][noiseState];
-
-                using namespace TRANSMISSION_STATE;
-                stateLhood[ERROR] = log_sum(stateLhood[ERROR], errorLhood);
-            }
-        }
+        addTrioSharedNoiseLhood(sampleLhood[parentIndices[0]], sampleLhood[parentIndices[1]],
+                                sampleLhood[probandIndex], max_alleles, stateLhood);
 
         processStateLhood(rs);
 
@@ -300,15 +130,16 @@ struct DenovoResultMaker
     processStateLhood(
         denovo_snv_call::result_set& rs) const
     {
+        const TrioTransmissionTable& table(TrioTransmissionTable::get());
         std::array<double,TRANSMISSION_STATE::SIZE> statePprob;
         for (unsigned tstate(0); tstate<TRANSMISSION_STATE::SIZE; ++tstate)
         {
-            statePprob[tstate] = stateLhood[tstate] + TRANSMISSION_STATE::getPrior(static_cast<TRANSMISSION_STATE::index_t>(tstate));
-#ifdef DENOVO_SNV_DEBUG2
             const TRANSMISSION_STATE::index_t tidx(static_cast<TRANSMISSION_STATE::index_t>(tstate));
+            statePprob[tstate] = stateLhood[tstate] + table.getLnPrior(tidx);
+#ifdef DENOVO_SNV_DEBUG2
             log_os << "denovo state pprob/lhood/prior: " << TRANSMISSION_STATE::getLabel(tidx)
                    << " " << statePprob[tstate] << " " << stateLhood[tstate]
-                   << " " << TRANSMISSION_STATE::getPrior(tidx) << "\n";
+                   << " " << table.getLnPrior(tidx) << "\n";
 #endif
         }
 
@@ -0,0 +1,296 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \author Chris Saunders
+/// \author Morten Kallberg
+///
+
+
+#include "denovo_snv_transmission.hh"
+#include "blt_util/math_util.hh"
+
+#include <cassert>
+#include <cmath>
+
+#include <algorithm>
+#include <limits>
+
+
+
+namespace TRANSMISSION_STATE
+{
+
+const char*
+getLabel(
+    const index_t idx)
+{
+    switch (idx)
+    {
+    case INHERITED:
+        return "INHERITED";
+    case DENOVO:
+        return "DENOVO";
+    case ERROR:
+        return "ERROR";
+    default:
+        assert(false && "Unknown transmission state");
+        return nullptr;
+    }
+}
+
+// temporary fixed priors:
+static
+double
+getPrior(
+    const index_t idx)
+{
+    // as currently defined background exp is I: 15/27 E: 2/27 D: 10/27 -- compared to drate this doesn't matter
+    static const double lndrate(std::log(1e-6));
+    static const double noiserate(std::log(1e-7));
+    switch (idx)
+    {
+    case INHERITED:
+        return 0.;
+    case DENOVO:
+        return lndrate;
+    case ERROR:
+        return noiserate;
+    default:
+        assert(false && "Undefined inheritance state");
+        return 0.;
+    }
+}
+
+static const unsigned alleleCount(2);
+typedef std::array<uint8_t,alleleCount> alleleSet_t;
+
+static
+unsigned
+getTransmissionErrorCount(
+    const alleleSet_t& pA,
+    const alleleSet_t& pB,
+    const alleleSet_t& c)
+{
+    unsigned val(0);
+    if ((c[0] != pA[0]) && (c[0] != pA[1])) val += 1;
+    if ((c[1] != pB[0]) && (c[1] != pB[1])) val += 1;
+    return val;
+}
+
+static
+index_t
+get_state(
+    const unsigned parent0GT,
+    const unsigned parent1GT,
+    const unsigned probandGT)
+{
+    alleleSet_t parent0Alleles;
+    alleleSet_t parent1Alleles;
+    alleleSet_t probandAlleles;
+    for (unsigned alleleIndex(0); alleleIndex<alleleCount; ++alleleIndex)
+    {
+        parent0Alleles[alleleIndex] = DIGT::get_allele(parent0GT,alleleIndex);
+        parent1Alleles[alleleIndex] = DIGT::get_allele(parent1GT,alleleIndex);
+        probandAlleles[alleleIndex] = DIGT::get_allele(probandGT,alleleIndex);
+    }
+    const unsigned errorCount(std::min(getTransmissionErrorCount(parent0Alleles,parent1Alleles,probandAlleles),getTransmissionErrorCount(parent1Alleles,parent0Alleles,probandAlleles)));
+    switch (errorCount)
+    {
+    case 0:
+        return INHERITED;
+    case 1:
+        return DENOVO;
+    case 2:
+        return ERROR;
+    default:
+        assert(false && "Unexpected error count value");
+        return ERROR;
+    }
+}
+}
+
+
+
+TrioTransmissionTable::
+TrioTransmissionTable()
+{
+    using namespace TRANSMISSION_STATE;
+
+    for (unsigned parent0GT(0); parent0GT<DIGT::SIZE; ++parent0GT)
+    {
+        for (unsigned parent1GT(0); parent1GT<DIGT::SIZE; ++parent1GT)
+        {
+            const unsigned parentIndex(getParentIndex(parent0GT,parent1GT));
+            for (auto& indicator : _stateIndicator[parentIndex])
+            {
+                indicator.fill(0.);
+            }
+            for (unsigned probandGT(0); probandGT<DIGT::SIZE; ++probandGT)
+            {
+                const index_t state(get_state(parent0GT,parent1GT,probandGT));
+                _state[parentIndex][probandGT] = state;
+                _stateIndicator[parentIndex][state][probandGT] = 1.;
+            }
+        }
+    }
+
+    for (unsigned state(0); state<SIZE; ++state)
+    {
+        _lnPrior[state] = getPrior(static_cast<index_t>(state));
+    }
+}
+
+
+
+const TrioTransmissionTable&
+TrioTransmissionTable::
+get()
+{
+    static const TrioTransmissionTable table;
+    return table;
+}
+
+
+
+/// convert genotype log likelihoods into likelihoods scaled to the most likely candidate genotype, with
+/// genotypes containing non-candidate alleles set to zero
+///
+/// \return log of the scaling factor
+static
+double
+getScaledGenotypeLhood(
+    const dsnv_state_t& lhood,
+    const std::array<bool,N_BASE>& candidateAlleles,
+    TrioTransmissionTable::proband_gt_vector_t& scaledLhood)
+{
+    std::array<bool,DIGT::SIZE> isCandidateGT;
+    double maxLhood(-std::numeric_limits<double>::infinity());
+    for (unsigned gt(0); gt<DIGT::SIZE; ++gt)
+    {
+        isCandidateGT[gt] = (candidateAlleles[DIGT::get_allele(gt,0)] && candidateAlleles[DIGT::get_allele(gt,1)]);
+        if (isCandidateGT[gt]) maxLhood = std::max(maxLhood, static_cast<double>(lhood[gt]));
+    }
+    assert(maxLhood > -std::numeric_limits<double>::infinity());
+
+    for (unsigned gt(0); gt<DIGT::SIZE; ++gt)
+    {
+        scaledLhood[gt] = (isCandidateGT[gt] ? std::exp(lhood[gt]-maxLhood) : 0.);
+    }
+    return maxLhood;
+}
+
+
+
+void
+getTrioTransmissionStateLhood(
+    const dsnv_state_t& parent0Lhood,
+    const dsnv_state_t& parent1Lhood,
+    const dsnv_state_t& probandLhood,
+    const std::array<bool,N_BASE>& candidateAlleles,
+    std::array<double,TRANSMISSION_STATE::SIZE>& stateLhood)
+{
+    using namespace TRANSMISSION_STATE;
+
+    const TrioTransmissionTable& table(TrioTransmissionTable::get());
+
+    // the pedigree likelihood of each genotype combination is the product of the sample likelihoods, so
+    // the log-sum-exp over all combinations in each state can be factored into a scale term per sample and a
+    // sum over products of the scaled likelihoods:
+    TrioTransmissionTable::proband_gt_vector_t parent0Scaled;
+    TrioTransmissionTable::proband_gt_vector_t parent1Scaled;
+    TrioTransmissionTable::proband_gt_vector_t probandScaled;
+    const double lnScale(getScaledGenotypeLhood(parent0Lhood, candidateAlleles, parent0Scaled) +
+                         getScaledGenotypeLhood(parent1Lhood, candidateAlleles, parent1Scaled) +
+                         getScaledGenotypeLhood(probandLhood, candidateAlleles, probandScaled));
+
+    std::array<double,SIZE> stateSum;
+    stateSum.fill(0.);
+    for (unsigned parent0GT(0); parent0GT<DIGT::SIZE; ++parent0GT)
+    {
+        if (parent0Scaled[parent0GT] <= 0.) continue;
+        for (unsigned parent1GT(0); parent1GT<DIGT::SIZE; ++parent1GT)
+        {
+            const double parentLhood(parent0Scaled[parent0GT]*parent1Scaled[parent1GT]);
+            if (parentLhood <= 0.) continue;
+            for (unsigned state(0); state<SIZE; ++state)
+            {
+                const auto& indicator(table.getStateIndicator(parent0GT,parent1GT,static_cast<index_t>(state)));
+                double probandStateLhood(0.);
+                for (unsigned probandGT(0); probandGT<DIGT::SIZE; ++probandGT)
+                {
+                    probandStateLhood += indicator[probandGT]*probandScaled[probandGT];
+                }
+                stateSum[state] += parentLhood*probandStateLhood;
+            }
+        }
+    }
+
+    for (unsigned state(0); state<SIZE; ++state)
+    {
+        stateLhood[state] = ((stateSum[state] > 0.) ?
+                             (lnScale + std::log(stateSum[state])) :
+                             -std::numeric_limits<double>::infinity());
+    }
+}
+
+
+
+void
+addTrioSharedNoiseLhood(
+    const dsnv_state_t& parent0Lhood,
+    const dsnv_state_t& parent1Lhood,
+    const dsnv_state_t& probandLhood,
+    const std::array<bool,N_BASE>& candidateAlleles,
+    std::array<double,TRANSMISSION_STATE::SIZE>& stateLhood)
+{
+    // these are all non-standard allele frequencies shared among all samples --
+    // 99% of the time this is meant to catch low-frequency alt noise shared in all three
+    // samples (if all were sequenced to a very high depth) but spuriously more prevalent
+    // in the proband due to low-depth sampling issues:
+    static const unsigned ratioCount(DIGT_DGRID::HET_RES*2);
+    std::array<double,DIGT::HET_SIZE*ratioCount> noiseLhood;
+    unsigned noiseCount(0);
+    double maxNoiseLhood(-std::numeric_limits<double>::infinity());
+    for (unsigned hetIndex(0); hetIndex<(DIGT::HET_SIZE); hetIndex++)
+    {
+        const unsigned hetGT(hetIndex+N_BASE);
+        if (! (candidateAlleles[DIGT::get_allele(hetGT,0)] && candidateAlleles[DIGT::get_allele(hetGT,1)])) continue;
+        for (unsigned ratioIndex(0); ratioIndex<ratioCount; ++ratioIndex)
+        {
+            const unsigned noiseState(DIGT::SIZE+(ratioIndex*DIGT::HET_SIZE)+hetIndex);
+            const double errorLhood =
+                parent0Lhood[noiseState] +
+                parent1Lhood[noiseState] +
+                probandLhood[noiseState];
+            noiseLhood[noiseCount++] = errorLhood;
+            maxNoiseLhood = std::max(maxNoiseLhood, errorLhood);
+        }
+    }
+    if (noiseCount == 0) return;
+
+    double noiseSum(0.);
+    for (unsigned noiseIndex(0); noiseIndex<noiseCount; ++noiseIndex)
+    {
+        noiseSum += std::exp(noiseLhood[noiseIndex]-maxNoiseLhood);
+    }
+
+    using namespace TRANSMISSION_STATE;
+    stateLhood[ERROR] = log_sum(stateLhood[ERROR], (maxNoiseLhood + std::log(noiseSum)));
+}
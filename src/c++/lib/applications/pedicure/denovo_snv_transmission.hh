@@ -0,0 +1,140 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \author Chris Saunders
+/// \author Morten Kallberg
+///
+
+#pragma once
+
+#include "denovo_snv_grid_states.hh"
+#include "blt_util/blt_types.hh"
+
+#include <array>
+
+
+typedef std::array<blt_float_t,DIGT_DGRID::SIZE> dsnv_state_t;
+
+
+
+namespace TRANSMISSION_STATE
+{
+// "ERROR" represents a de-novo event that is incredibly unlikely (multiple events)
+//  -- we could also put it in the denovo state and just use the denovo prior
+// squared to get the same result -- then the dominant term would actually be the
+// probably of an erroneous copy number observation in the sample instead.
+enum index_t
+{
+    INHERITED,
+    DENOVO,
+    ERROR,
+    SIZE
+};
+
+const char*
+getLabel(
+    const index_t idx);
+}
+
+
+
+/// transmission state and prior of every parent0, parent1 and proband diploid genotype combination
+///
+/// the table is computed once, and is laid out so that the likelihood of each transmission state can be summed
+/// over all proband genotypes as a fixed length dot product
+///
+struct TrioTransmissionTable
+{
+    typedef std::array<double,DIGT::SIZE> proband_gt_vector_t;
+
+    /// \return the shared table instance
+    static
+    const TrioTransmissionTable&
+    get();
+
+    TRANSMISSION_STATE::index_t
+    getState(
+        const unsigned parent0GT,
+        const unsigned parent1GT,
+        const unsigned probandGT) const
+    {
+        return static_cast<TRANSMISSION_STATE::index_t>(_state[getParentIndex(parent0GT,parent1GT)][probandGT]);
+    }
+
+    /// \return a vector over proband genotypes which is 1 where the genotype produces state from the parent
+    /// genotypes and 0 otherwise
+    const proband_gt_vector_t&
+    getStateIndicator(
+        const unsigned parent0GT,
+        const unsigned parent1GT,
+        const TRANSMISSION_STATE::index_t state) const
+    {
+        return _stateIndicator[getParentIndex(parent0GT,parent1GT)][state];
+    }
+
+    /// \return log prior of the transmission state
+    double
+    getLnPrior(const TRANSMISSION_STATE::index_t state) const
+    {
+        return _lnPrior[state];
+    }
+
+private:
+    TrioTransmissionTable();
+
+    static
+    unsigned
+    getParentIndex(
+        const unsigned parent0GT,
+        const unsigned parent1GT)
+    {
+        return (parent0GT*DIGT::SIZE + parent1GT);
+    }
+
+    static const unsigned parentGTPairCount = DIGT::SIZE*DIGT::SIZE;
+
+    std::array<std::array<uint8_t,DIGT::SIZE>,parentGTPairCount> _state;
+    std::array<std::array<proband_gt_vector_t,TRANSMISSION_STATE::SIZE>,parentGTPairCount> _stateIndicator;
+    std::array<double,TRANSMISSION_STATE::SIZE> _lnPrior;
+};
+
+
+
+/// sum the likelihood of each transmission state over all trio genotypes built from the candidate alleles
+///
+/// \param[out] stateLhood log likelihood of each transmission state, -inf for states with no likelihood within
+///                        the double precision range of the most likely genotype combination
+void
+getTrioTransmissionStateLhood(
+    const dsnv_state_t& parent0Lhood,
+    const dsnv_state_t& parent1Lhood,
+    const dsnv_state_t& probandLhood,
+    const std::array<bool,N_BASE>& candidateAlleles,
+    std::array<double,TRANSMISSION_STATE::SIZE>& stateLhood);
+
+/// add the likelihood of allele frequency noise states shared by all samples of the trio to the ERROR
+/// transmission state
+void
+addTrioSharedNoiseLhood(
+    const dsnv_state_t& parent0Lhood,
+    const dsnv_state_t& parent1Lhood,
+    const dsnv_state_t& probandLhood,
+    const std::array<bool,N_BASE>& candidateAlleles,
+    std::array<double,TRANSMISSION_STATE::SIZE>& stateLhood);
@@ -80,7 +80,8 @@ pedicure_run(
         {
             registrationIndices.push_back(sampleIndex);
         }
-        bamHeaders = registerAlignments(opt.alignFileOpt.alignmentFilename, registrationIndices, streamData);
+        bamHeaders = registerAlignments(opt.alignFileOpt.alignmentFilename, registrationIndices, streamData,
+                                        opt.isAlignmentPrefetch);
 
         assert(not bamHeaders.empty());
 
@@ -172,4 +173,6 @@ pedicure_run(
         }
     }
     sppr.reset();
+
+    segmentStatMan.addReadRealignmentStats(sppr.getReadRealignmentStats());
 }
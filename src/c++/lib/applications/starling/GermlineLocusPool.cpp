@@ -0,0 +1,59 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "GermlineLocusPool.hh"
+
+#include <typeinfo>
+
+
+
+std::unique_ptr<GermlineDiploidSiteLocusInfo>
+GermlineLocusPool::
+getDiploidSite(
+    const pos_t pos,
+    const uint8_t refBaseIndex,
+    const bool isForcedOutput)
+{
+    if (_freeDiploidSites.empty())
+    {
+        return std::unique_ptr<GermlineDiploidSiteLocusInfo>(
+                   new GermlineDiploidSiteLocusInfo(_gvcfDerivedOptions, _sampleCount, pos, refBaseIndex, isForcedOutput));
+    }
+
+    std::unique_ptr<GermlineDiploidSiteLocusInfo> locusPtr(std::move(_freeDiploidSites.back()));
+    _freeDiploidSites.pop_back();
+    locusPtr->reset(pos, refBaseIndex, isForcedOutput);
+    return locusPtr;
+}
+
+
+
+void
+GermlineLocusPool::
+release(std::unique_ptr<GermlineSiteLocusInfo> locusPtr)
+{
+    if (not locusPtr) return;
+
+    // only recycle the exact type handed out by this pool:
+    if (typeid(*locusPtr) != typeid(GermlineDiploidSiteLocusInfo)) return;
+    if (locusPtr->getSampleCount() != _sampleCount) return;
+
+    _freeDiploidSites.emplace_back(static_cast<GermlineDiploidSiteLocusInfo*>(locusPtr.release()));
+}
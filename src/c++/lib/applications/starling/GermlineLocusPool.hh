@@ -0,0 +1,68 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#pragma once
+
+#include "gvcf_locus_info.hh"
+
+#include <memory>
+#include <vector>
+
+
+/// free list of germline site locus objects shared by the producer and the final stage of the variant pipeline
+///
+/// A site locus is created for nearly every reference position, so instead of deleting each locus at the
+/// end of the pipeline it is returned here and reset for a later position. This recycles both the locus
+/// allocation and the capacity of its per-sample and per-allele vectors.
+///
+struct GermlineLocusPool
+{
+    GermlineLocusPool(
+        const gvcf_deriv_options& gvcfDerivedOptions,
+        const unsigned sampleCount)
+        : _gvcfDerivedOptions(gvcfDerivedOptions),
+          _sampleCount(sampleCount)
+    {}
+
+    /// get a site locus in the same state as a newly constructed locus with these arguments
+    std::unique_ptr<GermlineDiploidSiteLocusInfo>
+    getDiploidSite(
+        const pos_t pos,
+        const uint8_t refBaseIndex,
+        const bool isForcedOutput = false);
+
+    /// return a site locus to the pool
+    ///
+    /// loci of any type other than GermlineDiploidSiteLocusInfo are deleted
+    void
+    release(std::unique_ptr<GermlineSiteLocusInfo> locusPtr);
+
+    /// number of site loci available for reuse
+    unsigned
+    getFreeSiteCount() const
+    {
+        return _freeDiploidSites.size();
+    }
+
+private:
+    const gvcf_deriv_options& _gvcfDerivedOptions;
+    const unsigned _sampleCount;
+    std::vector<std::unique_ptr<GermlineDiploidSiteLocusInfo>> _freeDiploidSites;
+};
@@ -236,16 +236,16 @@ classify_indel(
 
 void
 ScoringModelManager::
-default_classify_site(
-    const unsigned sampleIndex,
+default_classify_site_sample_shared(
+    const int gqx,
     const unsigned allSampleLocusDepth,
-    GermlineSiteLocusInfo& locus) const
+    const unsigned n_used_calls,
+    const unsigned n_unused_calls,
+    GermlineFilterKeeper& filters) const
 {
-    LocusSampleInfo& sampleInfo(locus.getSample(sampleIndex));
-
     if (_opt.is_min_gqx)
     {
-        if (sampleInfo.gqx < _opt.min_gqx) sampleInfo.filters.set(GERMLINE_VARIANT_VCF_FILTERS::LowGQX);
+        if (gqx < _opt.min_gqx) filters.set(GERMLINE_VARIANT_VCF_FILTERS::LowGQX);
     }
     if (_dopt.is_max_depth())
     {
@@ -253,7 +253,7 @@ default_classify_site(
         {
             if (allSampleLocusDepth > _maxChromDepth)
             {
-                sampleInfo.filters.set(GERMLINE_VARIANT_VCF_FILTERS::HighDepth);
+                filters.set(GERMLINE_VARIANT_VCF_FILTERS::HighDepth);
             }
         }
     }
@@ -261,11 +261,28 @@ default_classify_site(
     // high DPFratio filter
     if (_opt.is_max_base_filt)
     {
-        const auto& siteSampleInfo(locus.getSiteSample(sampleIndex));
-        const unsigned total_calls(siteSampleInfo.n_used_calls+siteSampleInfo.n_unused_calls);
-        const double unusedCallFraction(safeFrac(siteSampleInfo.n_unused_calls, total_calls));
-        if (unusedCallFraction>_opt.max_base_filt) sampleInfo.filters.set(GERMLINE_VARIANT_VCF_FILTERS::HighBaseFilt);
+        const unsigned total_calls(n_used_calls+n_unused_calls);
+        const double unusedCallFraction(safeFrac(n_unused_calls, total_calls));
+        if (unusedCallFraction>_opt.max_base_filt) filters.set(GERMLINE_VARIANT_VCF_FILTERS::HighBaseFilt);
     }
+}
+
+
+
+void
+ScoringModelManager::
+default_classify_site(
+    const unsigned sampleIndex,
+    const unsigned allSampleLocusDepth,
+    GermlineSiteLocusInfo& locus) const
+{
+    LocusSampleInfo& sampleInfo(locus.getSample(sampleIndex));
+    const auto& siteSampleInfo(locus.getSiteSample(sampleIndex));
+
+    default_classify_site_sample_shared(
+        sampleInfo.gqx, allSampleLocusDepth, siteSampleInfo.n_used_calls, siteSampleInfo.n_unused_calls,
+        sampleInfo.filters);
+
     if (locus.isVariantLocus())
     {
         if (_opt.is_max_snv_hpol)
@@ -276,7 +293,6 @@ default_classify_site(
         {
             if (_opt.is_max_snv_sb)
             {
-                const auto& siteSampleInfo(locus.getSiteSample(sampleIndex));
                 if (siteSampleInfo.strandBias > _opt.max_snv_sb)
                     sampleInfo.filters.set(GERMLINE_VARIANT_VCF_FILTERS::HighSNVSB);
             }
@@ -301,6 +317,21 @@ default_classify_site_locus(
 
 
 
+void
+ScoringModelManager::
+default_classify_homref_site(
+    GermlineHomRefSiteInfo& site) const
+{
+    const unsigned allSampleLocusDepth(site.getTotalReadDepth());
+    for (auto& sample : site.samples)
+    {
+        default_classify_site_sample_shared(
+            sample.gqx, allSampleLocusDepth, sample.n_used_calls, sample.n_unused_calls, sample.filters);
+    }
+}
+
+
+
 void
 ScoringModelManager::
 default_classify_indel(
@@ -28,6 +28,8 @@
 #include "starling_shared.hh"
 #include "calibration/VariantScoringModelServer.hh"
 
+#include <memory>
+
 
 /// handles site and indel filter labeling OR EVS scoring and filtering
 ///
@@ -40,6 +42,9 @@
 /// Also supports a legacy EVS model expressing both a logistic regression
 /// model and a rule based filter, this model is deprecated.
 ///
+/// Copies of this object share the same (read-only) EVS models, so that each worker thread
+/// can track its own current chromosome without reloading the models.
+///
 struct ScoringModelManager
 {
     ScoringModelManager(
@@ -69,6 +74,12 @@ struct ScoringModelManager
     void default_classify_site_locus(
         GermlineSiteLocusInfo& locus) const;
 
+    /// simple hard-cutoff filtration rules applied to a hom-ref site, these match
+    /// default_classify_site_locus for a non-variant site locus
+    void
+    default_classify_homref_site(
+        GermlineHomRefSiteInfo& site) const;
+
     /// simple hard-cutoff filtration rules applied to indel locus in one sample
     void
     default_classify_indel(
@@ -107,6 +118,15 @@ private:
         return (not _chromName.empty());
     }
 
+    /// site sample filters which do not depend on whether the site is variant
+    void
+    default_classify_site_sample_shared(
+        const int gqx,
+        const unsigned allSampleLocusDepth,
+        const unsigned n_used_calls,
+        const unsigned n_unused_calls,
+        GermlineFilterKeeper& filters) const;
+
     double
     snvEVSThreshold() const
     {
@@ -131,6 +151,6 @@ private:
     double _normChromDepth = 0.;
     double _maxChromDepth = 0.;
 
-    std::unique_ptr<VariantScoringModelServer> _snvScoringModelPtr;
-    std::unique_ptr<VariantScoringModelServer> _indelScoringModelPtr;
+    std::shared_ptr<const VariantScoringModelServer> _snvScoringModelPtr;
+    std::shared_ptr<const VariantScoringModelServer> _indelScoringModelPtr;
 };
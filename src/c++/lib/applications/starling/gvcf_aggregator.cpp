@@ -30,26 +30,29 @@ gvcf_aggregator::
 gvcf_aggregator(
     const starling_options& opt,
     const starling_deriv_options& dopt,
+    const ScoringModelManager& scoringModels,
     const starling_streams& streams,
     const reference_contig_segment& ref,
     const RegionTracker& nocompressRegions,
     const RegionTracker& targetedRegions,
     const std::vector<std::reference_wrapper<const pos_basecall_buffer>>& basecallBuffers)
-    : _scoringModels(opt, dopt.gvcf)
+    : _scoringModels(scoringModels),
+      _locusPool(dopt.gvcf, streams.getSampleCount())
 {
     if (! opt.gvcf.is_gvcf_output())
         throw std::invalid_argument("gvcf_aggregator cannot be constructed with nothing to do.");
 
-    _gvcfWriterPtr.reset(new gvcf_writer(opt, dopt, streams, ref, nocompressRegions, _scoringModels));
+    _gvcfWriterPtr.reset(new gvcf_writer(opt, dopt, streams, ref, nocompressRegions, _scoringModels, _locusPool));
     std::shared_ptr<variant_pipe_stage_base> nextPipeStage(_gvcfWriterPtr);
     if (opt.is_ploidy_prior)
     {
-        std::shared_ptr<variant_pipe_stage_base> overlapper(new indel_overlapper(_scoringModels, ref, nextPipeStage));
-        _codonPhaserPtr.reset(new Codon_phaser(opt, basecallBuffers, overlapper));
+        _indelOverlapperPtr.reset(new indel_overlapper(_scoringModels, ref, nextPipeStage));
+        _codonPhaserPtr.reset(new Codon_phaser(opt, basecallBuffers, _indelOverlapperPtr));
         nextPipeStage = _codonPhaserPtr;
     }
     const bool isTargetedRegions(not opt.gvcf.targeted_regions_bedfile.empty());
-    _head.reset(new variant_prefilter_stage(_scoringModels, isTargetedRegions, targetedRegions, nextPipeStage));
+    _prefilterPtr.reset(new variant_prefilter_stage(_scoringModels, isTargetedRegions, targetedRegions, nextPipeStage));
+    _head = _prefilterPtr;
 }
 
 gvcf_aggregator::~gvcf_aggregator()
@@ -64,6 +67,18 @@ add_site(std::unique_ptr<GermlineSiteLocusInfo> si)
     _head->process(std::move(si));
 }
 
+bool
+gvcf_aggregator::
+tryAddHomRefSite(GermlineHomRefSiteInfo& site)
+{
+    // any buffered loci would need to be written ahead of this site:
+    if (is_phasing_block()) return false;
+    if (_indelOverlapperPtr && _indelOverlapperPtr->isBuffer()) return false;
+
+    _prefilterPtr->classifyHomRefSite(site);
+    return _gvcfWriterPtr->tryAddHomRefSite(site);
+}
+
 void
 gvcf_aggregator::add_indel(std::unique_ptr<GermlineIndelLocusInfo> info)
 {
@@ -26,8 +26,11 @@
 #include "gvcf_locus_info.hh"
 #include "gvcf_compressor.hh"
 #include "gvcf_writer.hh"
+#include "GermlineLocusPool.hh"
+#include "indel_overlapper.hh"
 #include "ScoringModelManager.hh"
 #include "starling_streams.hh"
+#include "variant_prefilter_stage.hh"
 
 #include <iosfwd>
 
@@ -41,6 +44,7 @@ public:
     gvcf_aggregator(
         const starling_options& opt,
         const starling_deriv_options& dopt,
+        const ScoringModelManager& scoringModels,
         const starling_streams& streams,
         const reference_contig_segment& ref,
         const RegionTracker& nocompressRegions,
@@ -58,6 +62,15 @@ public:
 
     void add_site(std::unique_ptr<GermlineSiteLocusInfo> si);
 
+    /// try to add a hom-ref site directly to the current non-variant gVCF blocks
+    ///
+    /// this is only possible when no loci are buffered in the pipeline and the site extends the current
+    /// block in every sample, otherwise the equivalent site locus must be added with add_site
+    ///
+    /// \param[in,out] site filters are added to the site as it would be for a site locus
+    /// \return true if the site was added
+    bool tryAddHomRefSite(GermlineHomRefSiteInfo& site);
+
     void add_indel(std::unique_ptr<GermlineIndelLocusInfo> info);
     void reset();
 
@@ -77,10 +90,20 @@ public:
         return _scoringModels.getMaxDepth();
     }
 
+    /// source of recycled site loci, loci from this pool are returned to it after they are written
+    GermlineLocusPool&
+    getLocusPool()
+    {
+        return _locusPool;
+    }
+
 private:
     ScoringModelManager _scoringModels;
+    GermlineLocusPool _locusPool;
 
     std::shared_ptr<Codon_phaser> _codonPhaserPtr;
+    std::shared_ptr<indel_overlapper> _indelOverlapperPtr;
     std::shared_ptr<gvcf_writer> _gvcfWriterPtr;
+    std::shared_ptr<variant_prefilter_stage> _prefilterPtr;
     std::shared_ptr<variant_pipe_stage_base> _head;
 };
@@ -73,48 +73,83 @@ is_new_value_blockable(const int new_val,
 
 
 
-bool
-gvcf_block_site_record::
-testCanSiteJoinSampleBlockShared(
+/// get the site values used to test blocking criteria from a full site locus
+static
+GermlineBlockingSampleInfo
+getBlockingSampleInfo(
     const GermlineSiteLocusInfo& locus,
-    const unsigned sampleIndex) const
+    const unsigned sampleIndex)
 {
-    // pos must be +1 from end of record:
-    if ((pos+count) != locus.pos) return false;
-
     const LocusSampleInfo& inputSampleInfo(locus.getSample(sampleIndex));
     const auto& inputSiteSampleInfo(locus.getSiteSample(sampleIndex));
 
+    GermlineBlockingSampleInfo blockingSampleInfo;
+    blockingSampleInfo.maxGenotype = inputSampleInfo.max_gt();
+    blockingSampleInfo.ploidy = inputSampleInfo.getPloidy().getPloidy();
+    blockingSampleInfo.gqx = inputSampleInfo.gqx;
+    blockingSampleInfo.isGqx = locus.is_gqx(sampleIndex);
+    blockingSampleInfo.n_used_calls = inputSiteSampleInfo.n_used_calls;
+    blockingSampleInfo.n_unused_calls = inputSiteSampleInfo.n_unused_calls;
+    blockingSampleInfo.totalReadDepth = inputSiteSampleInfo.getTotalReadDepth();
+    blockingSampleInfo.filters = inputSampleInfo.filters;
+    return blockingSampleInfo;
+}
+
+
+
+bool
+gvcf_block_site_record::
+testCanSampleJoinBlock(
+    const pos_t sitePos,
+    const GermlineFilterKeeper& siteFilters,
+    const GermlineBlockingSampleInfo& inputSampleInfo) const
+{
+    assert(count>0);
+
+    // pos must be +1 from end of record:
+    if ((pos+count) != sitePos) return false;
+
     static const unsigned blockSampleIndex(0);
     const LocusSampleInfo& blockSampleInfo(getSample(blockSampleIndex));
     const auto& blockSiteSampleInfo(getSiteSample(blockSampleIndex));
 
     // filters must match:
-    if (not (filters == locus.filters)) return false;
+    if (not (filters == siteFilters)) return false;
     if (not (blockSampleInfo.filters == inputSampleInfo.filters)) return false;
 
-    if (blockSampleInfo.isVariant() or inputSampleInfo.isVariant()) return false;
+    if (blockSampleInfo.isVariant() or inputSampleInfo.maxGenotype.isVariant()) return false;
 
     if (! is_new_value_blockable(
-            inputSiteSampleInfo.n_used_calls, block_dpu, frac_tol, abs_tol))
+            inputSampleInfo.n_used_calls, block_dpu, frac_tol, abs_tol))
     {
         return false;
     }
     if (! is_new_value_blockable(
-            inputSiteSampleInfo.n_unused_calls, block_dpf, frac_tol, abs_tol))
+            inputSampleInfo.n_unused_calls, block_dpf, frac_tol, abs_tol))
     {
         return false;
     }
 
     // coverage states must match:
-    if (blockSiteSampleInfo.isAnyReadCoverage() != inputSiteSampleInfo.isAnyReadCoverage()) return false;
-    if (blockSiteSampleInfo.isUsedReadCoverage() != inputSiteSampleInfo.isUsedReadCoverage()) return false;
+    const bool isInputUsedReadCoverage(inputSampleInfo.n_used_calls != 0);
+    const bool isInputAnyReadCoverage(isInputUsedReadCoverage or (inputSampleInfo.n_unused_calls != 0));
+    if (blockSiteSampleInfo.isAnyReadCoverage() != isInputAnyReadCoverage) return false;
+    if (blockSiteSampleInfo.isUsedReadCoverage() != isInputUsedReadCoverage) return false;
 
     // genotype must match
-    if (not (blockSampleInfo.maxGenotypeIndexPolymorphic == inputSampleInfo.max_gt())) return false;
+    if (not (blockSampleInfo.maxGenotypeIndexPolymorphic == inputSampleInfo.maxGenotype)) return false;
 
     // ploidy must match
-    if (not (blockSampleInfo.getPloidy().getPloidy() == inputSampleInfo.getPloidy().getPloidy())) return false;
+    if (not (blockSampleInfo.getPloidy().getPloidy() == inputSampleInfo.ploidy)) return false;
+
+    // test blocking values:
+    if (! is_new_value_blockable(inputSampleInfo.gqx,
+                                 block_gqx,frac_tol,abs_tol,
+                                 inputSampleInfo.isGqx,
+                                 isBlockGqxDefined))
+    {
+        return false;
+    }
 
     return true;
 }
@@ -167,19 +202,39 @@ testCanSiteJoinSampleBlock(
     const unsigned sampleIndex) const
 {
     if (count==0) return true;
+    return testCanSampleJoinBlock(locus.pos, locus.filters, getBlockingSampleInfo(locus, sampleIndex));
+}
 
-    if (not testCanSiteJoinSampleBlockShared(locus,sampleIndex)) return false;
 
-    const LocusSampleInfo& inputSampleInfo(locus.getSample(sampleIndex));
 
-    // test blocking values:
-    if (! is_new_value_blockable(inputSampleInfo.gqx,
-                                 block_gqx,frac_tol,abs_tol,
-                                 locus.is_gqx(sampleIndex),
-                                 isBlockGqxDefined))
+bool
+gvcf_block_site_record::
+testCanHomRefSiteExtendSampleBlock(
+    const GermlineHomRefSiteInfo& site,
+    const unsigned sampleIndex) const
+{
+    // a new block is always started from a full site locus:
+    if (count==0) return false;
+    return testCanSampleJoinBlock(site.pos, site.filters, site.samples[sampleIndex]);
+}
+
+
+
+void
+gvcf_block_site_record::
+extendSampleBlock(
+    const GermlineHomRefSiteInfo& site,
+    const unsigned sampleIndex)
+{
+    assert(count>0);
+    const GermlineBlockingSampleInfo& inputSampleInfo(site.samples[sampleIndex]);
+
+    block_dpu.add(inputSampleInfo.n_used_calls);
+    block_dpf.add(inputSampleInfo.n_unused_calls);
+    if (inputSampleInfo.isGqx)
     {
-        return false;
+        block_gqx.add(inputSampleInfo.gqx);
     }
 
-    return true;
+    count += 1;
 }
@@ -70,16 +70,29 @@ struct gvcf_block_site_record : public GermlineSiteLocusInfo
         const GermlineSiteLocusInfo& locus,
         const unsigned sampleIndex);
 
-private:
-
-    /// reduce diploid/continuous site logical duplication by putting common tests here
+    /// determine if the given hom-ref site could extend this block
     ///
-    /// \return false if block cannot be shared, true otherwise (not enough by itself to conclude sharable)
+    /// this is always false for an empty block, which must be started from a full site locus
     bool
-    testCanSiteJoinSampleBlockShared(
-        const GermlineSiteLocusInfo& locus,
+    testCanHomRefSiteExtendSampleBlock(
+        const GermlineHomRefSiteInfo& site,
         const unsigned sampleIndex) const;
 
+    /// add hom-ref site to the current (non-empty) block
+    void
+    extendSampleBlock(
+        const GermlineHomRefSiteInfo& site,
+        const unsigned sampleIndex);
+
+private:
+
+    /// blocking tests shared by full site loci and compact hom-ref sites, block must be non-empty
+    bool
+    testCanSampleJoinBlock(
+        const pos_t sitePos,
+        const GermlineFilterKeeper& siteFilters,
+        const GermlineBlockingSampleInfo& inputSampleInfo) const;
+
 public:
     const double frac_tol;
     const int abs_tol;
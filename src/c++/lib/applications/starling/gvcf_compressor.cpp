@@ -73,6 +73,21 @@ is_site_compressible(
 
 
 
+bool
+gvcf_compressor::
+is_homref_site_compressible(
+    const GermlineHomRefSiteInfo& site) const
+{
+    if (! _opt.is_block_compression) return false;
+
+    // the only confident allele is the reference, so the reference fraction is one in any sample with support:
+    if (site.isConfidentRefSupport and ((1. + _opt.block_max_nonref) <= 1)) return false;
+
+    return (! _nocompress_regions.isIntersectRegion(site.pos));
+}
+
+
+
 bool
 gvcf_compressor::
 is_range_compressible(
@@ -43,6 +43,11 @@ struct gvcf_compressor
     is_site_compressible(
         const GermlineSiteLocusInfo& locus) const;
 
+    /// equivalent of is_site_compressible for a hom-ref site
+    bool
+    is_homref_site_compressible(
+        const GermlineHomRefSiteInfo& site) const;
+
     /// determine if a range of positions could be excluded
     /// (in the absence of variant signal)
     bool
@@ -1011,6 +1011,32 @@ struct GermlineDiploidSiteLocusInfo : public GermlineSiteLocusInfo
         evsDevelopmentFeatures.clear();
     }
 
+    /// return locus to the state of a newly constructed object with the same arguments, while
+    /// retaining all allocated storage
+    void
+    reset(
+        const pos_t init_pos,
+        const uint8_t initRefBaseIndex,
+        const bool is_forced_output = false)
+    {
+        clear();
+        clearEVSFeatures();
+
+        // LocusSampleInfo::clear() does not restore all constructor defaults:
+        const unsigned sampleCount(getSampleCount());
+        for (unsigned sampleIndex(0); sampleIndex<sampleCount; ++sampleIndex)
+        {
+            LocusSampleInfo& sampleInfo(getSample(sampleIndex));
+            sampleInfo.maxGenotypeIndexPolymorphic = VcfGenotype();
+            sampleInfo.maxGenotypeIndex = VcfGenotype();
+            sampleInfo.supportCounts.setAltCount(1);
+        }
+
+        pos = init_pos;
+        refBaseIndex = initRefBaseIndex;
+        isForcedOutput = is_forced_output;
+    }
+
     /// production and development features used in the empirical scoring model:
     VariantScoringFeatureKeeper evsFeatures;
     VariantScoringFeatureKeeper evsDevelopmentFeatures;
@@ -1019,6 +1045,63 @@ struct GermlineDiploidSiteLocusInfo : public GermlineSiteLocusInfo
 std::ostream& operator<<(std::ostream& os,const GermlineDiploidSiteLocusInfo& si);
 
 
+
+/// the per-sample site values which determine whether a site can join a non-variant gVCF block
+struct GermlineBlockingSampleInfo
+{
+    VcfGenotype maxGenotype;
+    int ploidy = 0;
+    int gqx = 0;
+    bool isGqx = false;
+    unsigned n_used_calls = 0;
+    unsigned n_unused_calls = 0;
+
+    /// the raw pileup depth used for the high depth filter
+    unsigned totalReadDepth = 0;
+    GermlineFilterKeeper filters;
+};
+
+
+/// compact record of a site where the reference allele is the only allele observed in any sample
+///
+/// this holds only the values needed to filter the site and extend the current non-variant gVCF
+/// blocks, so that most hom-ref positions can be handled without building a full site locus
+///
+struct GermlineHomRefSiteInfo
+{
+    explicit
+    GermlineHomRefSiteInfo(
+        const unsigned sampleCount)
+        : samples(sampleCount)
+    {}
+
+    unsigned
+    getSampleCount() const
+    {
+        return samples.size();
+    }
+
+    unsigned
+    getTotalReadDepth() const
+    {
+        unsigned allSampleLocusDepth(0);
+        for (const auto& sample : samples)
+        {
+            allSampleLocusDepth += sample.totalReadDepth;
+        }
+        return allSampleLocusDepth;
+    }
+
+    pos_t pos = 0;
+    uint8_t refBaseIndex = BASE_ID::ANY;
+
+    /// true if any sample has confident reference allele support
+    bool isConfidentRefSupport = false;
+    GermlineFilterKeeper filters;
+    std::vector<GermlineBlockingSampleInfo> samples;
+};
+
+
 /// TODO STREL-125 - transition to using regular counts structures
 struct GermlineContinuousSiteSampleInfo
 {
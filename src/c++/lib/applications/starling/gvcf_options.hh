@@ -82,6 +82,9 @@ struct gvcf_options
 
     std::string outputPrefix;
 
+    /// write gVCF files as BGZF segments with index fragments, to be merged by MergeBgzfSegments
+    bool is_bgzf_output = false;
+
     /// file specifying regions that are not compressed in the gvcf:
     std::string nocompress_region_bedfile;
 
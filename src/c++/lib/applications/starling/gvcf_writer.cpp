@@ -24,7 +24,6 @@
 
 #include "gvcf_writer.hh"
 
-#include "gvcf_header.hh"
 #include "indel_overlapper.hh"
 #include "LocusReportInfoUtil.hh"
 #include "variant_prefilter_stage.hh"
@@ -55,7 +54,8 @@ gvcf_writer(
     const starling_streams& streams,
     const reference_contig_segment& ref,
     const RegionTracker& nocompress_regions,
-    const ScoringModelManager& scoringModels)
+    const ScoringModelManager& scoringModels,
+    GermlineLocusPool& locusPool)
     : _opt(opt)
     , _streams(streams)
     , _ref(ref)
@@ -64,23 +64,12 @@ gvcf_writer(
     , _headPos(0)
     , _gvcf_comp(opt.gvcf,nocompress_regions)
     , _scoringModels(scoringModels)
+    , _locusPool(locusPool)
 {
     if (! opt.gvcf.is_gvcf_output())
         throw std::invalid_argument("gvcf_writer cannot be constructed with nothing to do.");
 
     const unsigned sampleCount(_streams.getSampleCount());
-    const auto& sampleNames(_streams.getSampleNames());
-
-    if (! _opt.gvcf.is_skip_header)
-    {
-        finish_gvcf_header(_opt, _dopt, _dopt.chrom_depth, sampleNames, _streams.gvcfVariantsStream());
-        for (unsigned sampleIndex(0); sampleIndex<sampleCount; ++sampleIndex)
-        {
-            const std::string& sampleName(sampleNames[sampleIndex]);
-            finish_gvcf_header(_opt, _dopt, _dopt.chrom_depth, {sampleName}, _streams.gvcfSampleStream(sampleIndex));
-        }
-    }
-
     for (unsigned sampleIndex(0); sampleIndex<sampleCount; ++sampleIndex)
     {
         _blockPerSample.emplace_back(_opt.gvcf);
@@ -135,14 +124,22 @@ skip_to_pos(
     // advance through any indel region by adding individual sites
     while (_headPos<target_pos)
     {
-        GermlineDiploidSiteLocusInfo si = get_empty_site(_headPos);
-
-        add_site_internal(si);
+        const GermlineDiploidSiteLocusInfo& emptySite(get_empty_site(_headPos));
+        if (_last_indel)
+        {
+            // sites may be modified by an overlapping indel, so these are written from a copy of the empty site:
+            GermlineDiploidSiteLocusInfo si = emptySite;
+            add_site_internal(si);
+        }
+        else
+        {
+            add_site_internal(_empty_site);
+        }
         // Don't do compressed ranges if there is an overlapping indel
         // filters are being applied to the overlapping positions
         if (_last_indel) continue;
 
-        if (_gvcf_comp.is_range_compressible(known_pos_range2(si.pos, target_pos)))
+        if (_gvcf_comp.is_range_compressible(known_pos_range2(emptySite.pos, target_pos)))
         {
             const int deltapos(target_pos - _headPos);
             for (auto& block : _blockPerSample)
@@ -185,6 +182,7 @@ process(std::unique_ptr<GermlineSiteLocusInfo> locusPtr)
 
         skip_to_pos(locusPtr->pos);
         add_site_internal(*locusPtr);
+        _locusPool.release(std::move(locusPtr));
     }
     catch (...)
     {
@@ -196,6 +194,41 @@ process(std::unique_ptr<GermlineSiteLocusInfo> locusPtr)
 
 
 
+bool
+gvcf_writer::
+tryAddHomRefSite(
+    const GermlineHomRefSiteInfo& site)
+{
+    assert(site.getSampleCount() == getSampleCount());
+
+    // skipping to the site position has the same effect whether the site is added here or as a full locus:
+    skip_to_pos(site.pos);
+
+    if (_last_indel)
+    {
+        // sites overlapping an indel may be modified, so these must be added as a full locus
+        if (site.pos < _last_indel->end()) return false;
+        _last_indel.reset(nullptr);
+    }
+
+    if (! _gvcf_comp.is_homref_site_compressible(site)) return false;
+
+    const unsigned sampleCount(getSampleCount());
+    for (unsigned sampleIndex(0); sampleIndex<sampleCount; ++sampleIndex)
+    {
+        if (! _blockPerSample[sampleIndex].testCanHomRefSiteExtendSampleBlock(site, sampleIndex)) return false;
+    }
+
+    for (unsigned sampleIndex(0); sampleIndex<sampleCount; ++sampleIndex)
+    {
+        _blockPerSample[sampleIndex].extendSampleBlock(site, sampleIndex);
+    }
+    _headPos=site.pos+1;
+    return true;
+}
+
+
+
 void
 gvcf_writer::
 process(std::unique_ptr<GermlineIndelLocusInfo> locusPtr)
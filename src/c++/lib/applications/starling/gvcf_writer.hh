@@ -26,6 +26,7 @@
 
 #include "gvcf_block_site_record.hh"
 #include "gvcf_compressor.hh"
+#include "GermlineLocusPool.hh"
 #include "ScoringModelManager.hh"
 #include "starling_shared.hh"
 #include "starling_streams.hh"
@@ -47,11 +48,22 @@ struct gvcf_writer : public variant_pipe_stage_base
         const starling_streams& streams,
         const reference_contig_segment& ref,
         const RegionTracker& nocompress_regions,
-        const ScoringModelManager& scoringModels);
+        const ScoringModelManager& scoringModels,
+        GermlineLocusPool& locusPool);
 
     void process(std::unique_ptr<GermlineSiteLocusInfo>) override;
     void process(std::unique_ptr<GermlineIndelLocusInfo>) override;
 
+    /// try to add a filtered hom-ref site by extending the current non-variant block of every sample
+    ///
+    /// this must only be called when no loci are buffered in earlier pipeline stages
+    ///
+    /// \return false if the site could not be added this way, in which case the full site locus must
+    ///         be sent through the pipeline instead
+    bool
+    tryAddHomRefSite(
+        const GermlineHomRefSiteInfo& site);
+
     void
     resetRegion(
         const std::string& chromName,
@@ -172,6 +184,9 @@ private:
     gvcf_compressor _gvcf_comp;
     const ScoringModelManager& _scoringModels;
 
+    /// site loci are returned here after they are written
+    GermlineLocusPool& _locusPool;
+
     /// print output limits:
     const unsigned maxPL = 999;
 };
@@ -50,6 +50,13 @@ struct indel_overlapper : public variant_pipe_stage_base
     void process(std::unique_ptr<GermlineSiteLocusInfo> siteLocusPtr) override;
     void process(std::unique_ptr<GermlineIndelLocusInfo> indelLocusPtr) override;
 
+    /// true if any loci are held back for overlap resolution
+    bool
+    isBuffer() const
+    {
+        return (not (_indel_buffer.empty() and _nonvariant_indel_buffer.empty() and _site_buffer.empty()));
+    }
+
     static
     void
     modify_overlapping_site(
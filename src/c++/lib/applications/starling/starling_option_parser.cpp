@@ -80,6 +80,8 @@ get_starling_option_parser(
      "Skip writing header info for the gvcf file (usually used to simplify segment concatenation)")
     ("gvcf-include-header", po::value(&opt.gvcf.include_headers)->multitoken(),
      "Include the specified field description in the header (usually used to simplify segment concatenation when different segments have different fields)")
+    ("gvcf-bgzf-output", po::value(&opt.gvcf.is_bgzf_output)->zero_tokens(),
+     "Write all gVCF files as BGZF compressed segments with tabix index fragments (usually used to merge segments with MergeBgzfSegments)")
     ;
 
     po::options_description phase_opt("Read-backed phasing options");
@@ -41,12 +41,14 @@ starling_pos_processor::
 starling_pos_processor(
     const starling_options& opt,
     const starling_deriv_options& dopt,
+    const ScoringModelManager& scoringModels,
     const reference_contig_segment& ref,
     const starling_streams& streams)
     : base_t(opt,dopt,ref,streams, opt.alignFileOpt.alignmentFilename.size()),
       _opt(opt),
       _dopt(dopt),
-      _streams(streams)
+      _streams(streams),
+      _homRefSite(getSampleCount())
 {
     const unsigned sampleCount(getSampleCount());
     assert(_streams.getSampleNames().size() == sampleCount);
@@ -63,7 +65,7 @@ starling_pos_processor(
         }
 
         _gvcfer.reset(new gvcf_aggregator(
-                          _opt, _dopt, _streams, ref, _nocompress_regions, _targeted_regions, basecallBuffers));
+                          _opt, _dopt, scoringModels, _streams, ref, _nocompress_regions, _targeted_regions, basecallBuffers));
     }
 
     // setup indel buffer samples:
@@ -498,6 +500,78 @@ updateSnvLocusWithSampleInfo(
 
 
 
+bool
+starling_pos_processor::
+tryAddHomRefSite(
+    const pos_t pos,
+    const uint8_t refBaseIndex,
+    const std::vector<int>& groupLocusPloidy,
+    const std::vector<int>& callerPloidy,
+    const std::vector<diploid_genotype>& allDgt)
+{
+    if (refBaseIndex == BASE_ID::ANY) return false;
+
+    GermlineHomRefSiteInfo& site(_homRefSite);
+    site.pos = pos;
+    site.refBaseIndex = refBaseIndex;
+    site.isConfidentRefSupport = false;
+    site.filters.clear();
+
+    auto isHomRefGenotype = [&](const unsigned genotypeIndex, const int ploidy)
+    {
+        if (DIGT::get_allele(genotypeIndex, 0) != refBaseIndex) return false;
+        return ((ploidy == 1) or (DIGT::get_allele(genotypeIndex, 1) == refBaseIndex));
+    };
+
+    std::array<unsigned, N_BASE> sampleBaseCounts;
+    const unsigned sampleCount(getSampleCount());
+    for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
+    {
+        // ploidy conflicts and overlapping hom-alt deletions are only handled with a full site locus:
+        const int ploidy(callerPloidy[sampleIndex]);
+        if (groupLocusPloidy[sampleIndex] != ploidy) return false;
+
+        const CleanedPileup& cpi(sample(sampleIndex).cpi);
+        if (cpi.n_used_calls() == 0) return false;
+
+        // any confident non-reference basecall could change the site alleles and the block compression criteria:
+        cpi.cleanedPileup().get_known_counts(sampleBaseCounts, _opt.used_allele_count_min_qscore);
+        for (unsigned baseIndex(0); baseIndex < N_BASE; ++baseIndex)
+        {
+            if (baseIndex == refBaseIndex) continue;
+            if (sampleBaseCounts[baseIndex] != 0) return false;
+        }
+        if (sampleBaseCounts[refBaseIndex] != 0) site.isConfidentRefSupport = true;
+
+        // a polymorphic genotype which differs from the genome genotype sets GQX to zero, leave this
+        // boundary case to the full site locus:
+        const diploid_genotype& dgt(allDgt[sampleIndex]);
+        if (not isHomRefGenotype(dgt.genome.max_gt, ploidy)) return false;
+        if (not isHomRefGenotype(dgt.poly.max_gt, ploidy)) return false;
+
+        GermlineBlockingSampleInfo& siteSample(site.samples[sampleIndex]);
+        if (ploidy == 1)
+        {
+            siteSample.maxGenotype.setGenotypeFromAlleleIndices(0);
+        }
+        else
+        {
+            siteSample.maxGenotype.setGenotypeFromAlleleIndices(0, 0);
+        }
+        siteSample.ploidy = ploidy;
+        siteSample.gqx = std::min(dgt.genome.max_gt_qphred, dgt.poly.max_gt_qphred);
+        siteSample.isGqx = true;
+        siteSample.n_used_calls = cpi.n_used_calls();
+        siteSample.n_unused_calls = cpi.n_unused_calls();
+        siteSample.totalReadDepth = cpi.rawPileup().mapqTracker.count;
+        siteSample.filters.clear();
+    }
+
+    return _gvcfer->tryAddHomRefSite(site);
+}
+
+
+
 void
 starling_pos_processor::
 getSiteAltAlleles(
@@ -651,9 +725,16 @@ process_pos_snp_digt(
             _opt, _dopt, sample(sampleIndex), callerPloidy[sampleIndex], allDgt[sampleIndex]);
     }
 
+    const uint8_t refBaseIndex(base_to_id(_ref.get_base(pos)));
+
+    // most sites can be added to the current non-variant block without building a site locus:
+    if (not isForcedOutput)
+    {
+        if (tryAddHomRefSite(pos, refBaseIndex, groupLocusPloidy, callerPloidy, allDgt)) return;
+    }
+
     // prep step 4) rank each allele in each sample, allowing up to ploidy alleles.
     //              approximate an aggregate rank over all samples:
-    const uint8_t refBaseIndex(base_to_id(_ref.get_base(pos)));
     std::vector<uint8_t> altAlleles;
     if (refBaseIndex != BASE_ID::ANY)
     {
@@ -663,7 +744,8 @@ process_pos_snp_digt(
     // -----------------------------------------------
     // create site locus object:
     //
-    std::unique_ptr<GermlineDiploidSiteLocusInfo> locusPtr(new GermlineDiploidSiteLocusInfo(_dopt.gvcf, sampleCount, pos, refBaseIndex, isForcedOutput));
+    std::unique_ptr<GermlineDiploidSiteLocusInfo> locusPtr(
+        _gvcfer->getLocusPool().getDiploidSite(pos, refBaseIndex, isForcedOutput));
 
     // add all candidate alternate alleles:
     for (const auto baseId : altAlleles)
@@ -40,6 +40,7 @@ struct starling_pos_processor : public starling_pos_processor_base
     starling_pos_processor(
         const starling_options& opt,
         const starling_deriv_options& dopt,
+        const ScoringModelManager& scoringModels,
         const reference_contig_segment& ref,
         const starling_streams& streams);
 
@@ -99,6 +100,18 @@ private:
     void process_pos_indel_digt(const pos_t pos);
     void process_pos_indel_continuous(const pos_t pos);
 
+    /// handle sites without any non-reference allele observations by extending the current non-variant
+    /// gVCF blocks directly, without constructing a site locus
+    ///
+    /// \return false if this site requires a full site locus
+    bool
+    tryAddHomRefSite(
+        const pos_t pos,
+        const uint8_t refBaseIndex,
+        const std::vector<int>& groupLocusPloidy,
+        const std::vector<int>& callerPloidy,
+        const std::vector<diploid_genotype>& allDgt);
+
     void
     getSiteAltAlleles(
         const uint8_t refBaseIndex,
@@ -111,6 +124,9 @@ private:
 
     std::unique_ptr<gvcf_aggregator> _gvcfer;
 
+    /// reused for each site handled by tryAddHomRefSite
+    GermlineHomRefSiteInfo _homRefSite;
+
     RegionTracker _nocompress_regions;
     RegionTracker _targeted_regions;
 
@@ -23,12 +23,14 @@
 ///
 
 #include "starling_run.hh"
+#include "ScoringModelManager.hh"
 #include "starling_pos_processor.hh"
 #include "starling_streams.hh"
 
 #include "appstats/RunStatsManager.hh"
 #include "blt_util/id_map.hh"
 #include "blt_util/log.hh"
+#include "blt_util/OrderedTaskRunner.hh"
 #include "common/Exceptions.hh"
 #include "htsapi/bam_header_util.hh"
 #include "starling_common/HtsMergeStreamerUtil.hh"
@@ -36,6 +38,8 @@
 #include "starling_common/starling_ref_seq.hh"
 #include "starling_common/starling_pos_processor_util.hh"
 
+#include <memory>
+
 
 
 namespace INPUT_TYPE
@@ -103,43 +107,33 @@ mapVcfSampleIndices(
 
 
 
-void
-starling_run(
-    const prog_info& pinfo,
-    const starling_options& opt)
+namespace
 {
-    using namespace illumina::common;
-
-    // ensure that this object is created first for runtime benchmark
-    RunStatsManager segmentStatMan(opt.segmentStatsFilename);
-
-    opt.validate();
-
-    const starling_deriv_options dopt(opt);
-    starling_read_counts brc;
-    reference_contig_segment ref;
-
-    const unsigned sampleCount(opt.alignFileOpt.alignmentFilename.size());
-
-    ////////////////////////////////////////
-    // setup streamData:
-    //
-    HtsMergeStreamer streamData;
-
-    // additional data structures required in the region loop below, which are filled in as a side effect of
-    // streamData initialization:
-    std::vector<std::reference_wrapper<const bam_hdr_t>> bamHeaders;
-    std::vector<std::string> sampleNames;
-    unsigned ploidyVcfSampleCount(0);
-    std::vector<unsigned> sampleIndexToPloidyVcfSampleIndex;
 
+/// all per-thread state required to analyze a series of regions
+///
+/// each worker owns its own input streams, reference segment and position processor, so that workers can
+/// process different regions concurrently while sharing only the (read-only) options and scoring models
+///
+struct StarlingRegionWorker
+{
+    StarlingRegionWorker(
+        const prog_info& pinfo,
+        const starling_options& opt,
+        const starling_deriv_options& dopt,
+        const ScoringModelManager& scoringModels,
+        const bool isRegionBuffer)
+        : _opt(opt)
     {
+        const unsigned sampleCount(opt.alignFileOpt.alignmentFilename.size());
+
         std::vector<unsigned> registrationIndices;
         for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
         {
             registrationIndices.push_back(sampleIndex);
         }
-        bamHeaders = registerAlignments(opt.alignFileOpt.alignmentFilename, registrationIndices, streamData);
+        bamHeaders = registerAlignments(opt.alignFileOpt.alignmentFilename, registrationIndices, streamData,
+                                        opt.isAlignmentPrefetch);
 
         assert(not bamHeaders.empty());
         const bam_hdr_t& referenceHeader(bamHeaders.front());
@@ -172,149 +166,245 @@ starling_run(
         {
             streamData.registerBed(opt.gvcf.targeted_regions_bedfile.c_str(), INPUT_TYPE::TARGETED_REGION);
         }
+
+        streams.reset(new starling_streams(opt, dopt, pinfo, bamHeaders, sampleNames, isRegionBuffer));
+        sppr.reset(new starling_pos_processor(opt, dopt, scoringModels, ref, *streams));
     }
 
-    starling_streams client_io(opt, pinfo, bamHeaders, sampleNames);
-    starling_pos_processor sppr(opt, dopt, ref, client_io);
+    /// process all input for one analysis region
+    ///
+    /// output for the region is not guaranteed to be complete until sppr is reset or moved to another region
+    void
+    processRegion(const AnalysisRegionInfo& rinfo);
 
-    const bam_hdr_t& referenceHeader(bamHeaders.front());
-    const bam_header_info referenceHeaderInfo(referenceHeader);
+    HtsMergeStreamer streamData;
 
-    // parse and sanity check regions
-    const auto& referenceAlignmentFilename(opt.alignFileOpt.alignmentFilename.front());
-    std::vector<AnalysisRegionInfo> regionInfo;
-    getStrelkaAnalysisRegions(opt, referenceAlignmentFilename, referenceHeaderInfo, regionInfo);
+    // additional data structures required in the region loop below, which are filled in as a side effect of
+    // streamData initialization:
+    std::vector<std::reference_wrapper<const bam_hdr_t>> bamHeaders;
+    std::vector<std::string> sampleNames;
+    unsigned ploidyVcfSampleCount = 0;
+    std::vector<unsigned> sampleIndexToPloidyVcfSampleIndex;
 
-    for (const auto& rinfo : regionInfo)
-    {
-        sppr.resetRegion(rinfo.regionChrom, rinfo.regionRange);
-        streamData.resetRegion(rinfo.streamerRegion.c_str());
-        setRefSegment(opt, rinfo.regionChrom, rinfo.refRegionRange, ref);
+    starling_read_counts brc;
+    reference_contig_segment ref;
+    std::unique_ptr<starling_streams> streams;
+    std::unique_ptr<starling_pos_processor> sppr;
 
-        while (streamData.next())
-        {
-            const pos_t currentPos(streamData.getCurrentPos());
-            const HTS_TYPE::index_t currentHtsType(streamData.getCurrentType());
-            const unsigned currentIndex(streamData.getCurrentIndex());
+private:
+    const starling_options& _opt;
+};
 
-            // wind sppr forward to position behind buffer head:
-            sppr.set_head_pos(currentPos-1);
 
-            if       (HTS_TYPE::BAM == currentHtsType)
-            {
-                // Remove the filter below because it's not valid for
-                // RNA-Seq case, reads should be selected for the report
-                // range by the bam reading functions
-                //
-                // /// get potential bounds of the read based only on current_pos:
-                // const known_pos_range any_read_bounds(current_pos-max_indel_size,current_pos+MAX_READ_SIZE+max_indel_size);
-                // if( sppr.is_range_outside_report_influence_zone(any_read_bounds) ) continue;
-
-                // Approximate begin range filter: (removed for RNA-Seq)
-                //if((current_pos+MAX_READ_SIZE+max_indel_size) <= rlimit.begin_pos) continue;
-
-                processInputReadAlignment(opt, ref, streamData.getCurrentBamStreamer(),
-                                          streamData.getCurrentBam(), currentPos,
-                                          brc, sppr, currentIndex);
-            }
-            else if (HTS_TYPE::VCF == currentHtsType)
+
+void
+StarlingRegionWorker::
+processRegion(const AnalysisRegionInfo& rinfo)
+{
+    using namespace illumina::common;
+
+    const starling_options& opt(_opt);
+    const unsigned sampleCount(opt.alignFileOpt.alignmentFilename.size());
+
+    sppr->resetRegion(rinfo.regionChrom, rinfo.regionRange);
+    streamData.resetRegion(rinfo.streamerRegion.c_str());
+    setRefSegment(opt, rinfo.regionChrom, rinfo.refRegionRange, ref);
+
+    while (streamData.next())
+    {
+        const pos_t currentPos(streamData.getCurrentPos());
+        const HTS_TYPE::index_t currentHtsType(streamData.getCurrentType());
+        const unsigned currentIndex(streamData.getCurrentIndex());
+
+        // wind sppr forward to position behind buffer head:
+        sppr->set_head_pos(currentPos-1);
+
+        if       (HTS_TYPE::BAM == currentHtsType)
+        {
+            // Remove the filter below because it's not valid for
+            // RNA-Seq case, reads should be selected for the report
+            // range by the bam reading functions
+            //
+            // /// get potential bounds of the read based only on current_pos:
+            // const known_pos_range any_read_bounds(current_pos-max_indel_size,current_pos+MAX_READ_SIZE+max_indel_size);
+            // if( sppr.is_range_outside_report_influence_zone(any_read_bounds) ) continue;
+
+            // Approximate begin range filter: (removed for RNA-Seq)
+            //if((current_pos+MAX_READ_SIZE+max_indel_size) <= rlimit.begin_pos) continue;
+
+            processInputReadAlignment(opt, ref, streamData.getCurrentBamStreamer(),
+                                      streamData.getCurrentBam(), currentPos,
+                                      brc, *sppr, currentIndex);
+        }
+        else if (HTS_TYPE::VCF == currentHtsType)
+        {
+            const vcf_record& vcfRecord(streamData.getCurrentVcf());
+            if     (INPUT_TYPE::CANDIDATE_INDELS == currentIndex)     // process candidate indels input from vcf file(s)
             {
-                const vcf_record& vcfRecord(streamData.getCurrentVcf());
-                if     (INPUT_TYPE::CANDIDATE_INDELS == currentIndex)     // process candidate indels input from vcf file(s)
+                if (vcfRecord.is_indel())
                 {
-                    if (vcfRecord.is_indel())
-                    {
-                        process_candidate_indel(opt.max_indel_size, vcfRecord, sppr);
-                    }
-                    else
-                    {
-                        log_os << "WARNING: candidate indel vcf variant record cannot be categorized as indel:\n";
-                        streamData.getCurrentVcfStreamer().report_state(log_os);
-                    }
+                    process_candidate_indel(opt.max_indel_size, vcfRecord, *sppr);
                 }
-                else if (INPUT_TYPE::FORCED_GT_VARIANTS == currentIndex)     // process forced genotype tests from vcf file(s)
+                else
                 {
-                    if (vcfRecord.is_indel())
-                    {
-                        static const unsigned sample_no(0);
-                        static const bool is_forced_output(true);
-                        process_candidate_indel(opt.max_indel_size, vcfRecord, sppr, sample_no, is_forced_output);
-                    }
-                    else if (vcfRecord.is_snv() or vcfRecord.is_ref_site())
-                    {
-                        sppr.insert_forced_output_pos(vcfRecord.pos - 1);
-                    }
-                    else
-                    {
-                        std::ostringstream oss;
-                        oss << "ERROR: forcedGT vcf variant record cannot be categorized as SNV or indel:\n";
-                        streamData.getCurrentVcfStreamer().report_state(oss);
-                        BOOST_THROW_EXCEPTION(LogicException(oss.str()));
-                    }
+                    log_os << "WARNING: candidate indel vcf variant record cannot be categorized as indel:\n";
+                    streamData.getCurrentVcfStreamer().report_state(log_os);
+                }
+            }
+            else if (INPUT_TYPE::FORCED_GT_VARIANTS == currentIndex)     // process forced genotype tests from vcf file(s)
+            {
+                if (vcfRecord.is_indel())
+                {
+                    static const unsigned sample_no(0);
+                    static const bool is_forced_output(true);
+                    process_candidate_indel(opt.max_indel_size, vcfRecord, *sppr, sample_no, is_forced_output);
                 }
-                else if (INPUT_TYPE::PLOIDY_REGION == currentIndex)
+                else if (vcfRecord.is_snv() or vcfRecord.is_ref_site())
                 {
-                    std::vector<unsigned> samplePloidy;
-                    known_pos_range2 ploidyRange;
-                    try
-                    {
-                        parsePloidyFromVcf(ploidyVcfSampleCount, vcfRecord.line, ploidyRange, samplePloidy);
-                    }
-                    catch (...)
-                    {
-                        log_os << "ERROR: Exception caught while parsing vcf ploidy record\n";
-                        streamData.getCurrentVcfStreamer().report_state(log_os);
-                        throw;
-                    }
-
-                    for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
-                    {
-                        const unsigned ploidy(samplePloidy[sampleIndexToPloidyVcfSampleIndex[sampleIndex]]);
-                        if ((ploidy == 0) || (ploidy == 1))
-                        {
-                            const bool retval(sppr.insert_ploidy_region(sampleIndex, ploidyRange, ploidy));
-                            if (!retval)
-                            {
-                                std::ostringstream oss;
-                                const auto& sampleName(client_io.getSampleNames()[sampleIndex]);
-                                oss << "ERROR: ploidy vcf FORMAT/CN values conflict. Conflict detected in sample '"
-                                    << sampleName << "' at:\n";
-                                streamData.getCurrentVcfStreamer().report_state(oss);
-                                BOOST_THROW_EXCEPTION(LogicException(oss.str()));
-                            }
-                        }
-                    }
+                    sppr->insert_forced_output_pos(vcfRecord.pos - 1);
                 }
                 else
                 {
-                    assert(false && "Unexpected hts index");
+                    std::ostringstream oss;
+                    oss << "ERROR: forcedGT vcf variant record cannot be categorized as SNV or indel:\n";
+                    streamData.getCurrentVcfStreamer().report_state(oss);
+                    BOOST_THROW_EXCEPTION(LogicException(oss.str()));
                 }
             }
-            else if (HTS_TYPE::BED == currentHtsType)
+            else if (INPUT_TYPE::PLOIDY_REGION == currentIndex)
             {
-                const bed_record& bedRecord(streamData.getCurrentBed());
-                if (INPUT_TYPE::NOCOMPRESS_REGION == currentIndex)
+                std::vector<unsigned> samplePloidy;
+                known_pos_range2 ploidyRange;
+                try
                 {
-                    known_pos_range2 range(bedRecord.begin,bedRecord.end);
-                    sppr.insert_nocompress_region(range);
+                    parsePloidyFromVcf(ploidyVcfSampleCount, vcfRecord.line, ploidyRange, samplePloidy);
                 }
-
-                else if (INPUT_TYPE::TARGETED_REGION == currentIndex)
+                catch (...)
                 {
-                    known_pos_range2 range(bedRecord.begin,bedRecord.end);
-                    sppr.insert_targeted_region(range);
+                    log_os << "ERROR: Exception caught while parsing vcf ploidy record\n";
+                    streamData.getCurrentVcfStreamer().report_state(log_os);
+                    throw;
                 }
-                else
+
+                for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
                 {
-                    assert(false && "Unexpected hts index");
+                    const unsigned ploidy(samplePloidy[sampleIndexToPloidyVcfSampleIndex[sampleIndex]]);
+                    if ((ploidy == 0) || (ploidy == 1))
+                    {
+                        const bool retval(sppr->insert_ploidy_region(sampleIndex, ploidyRange, ploidy));
+                        if (!retval)
+                        {
+                            std::ostringstream oss;
+                            const auto& sampleName(sampleNames[sampleIndex]);
+                            oss << "ERROR: ploidy vcf FORMAT/CN values conflict. Conflict detected in sample '"
+                                << sampleName << "' at:\n";
+                            streamData.getCurrentVcfStreamer().report_state(oss);
+                            BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+                        }
+                    }
                 }
             }
             else
             {
-                assert(false && "Invalid input condition");
+                assert(false && "Unexpected hts index");
             }
         }
+        else if (HTS_TYPE::BED == currentHtsType)
+        {
+            const bed_record& bedRecord(streamData.getCurrentBed());
+            if (INPUT_TYPE::NOCOMPRESS_REGION == currentIndex)
+            {
+                known_pos_range2 range(bedRecord.begin,bedRecord.end);
+                sppr->insert_nocompress_region(range);
+            }
+
+            else if (INPUT_TYPE::TARGETED_REGION == currentIndex)
+            {
+                known_pos_range2 range(bedRecord.begin,bedRecord.end);
+                sppr->insert_targeted_region(range);
+            }
+            else
+            {
+                assert(false && "Unexpected hts index");
+            }
+        }
+        else
+        {
+            assert(false && "Invalid input condition");
+        }
     }
-    sppr.reset();
 }
 
+}
+
+
+
+void
+starling_run(
+    const prog_info& pinfo,
+    const starling_options& opt)
+{
+    // ensure that this object is created first for runtime benchmark
+    RunStatsManager segmentStatMan(opt.segmentStatsFilename);
+
+    opt.validate();
+
+    const starling_deriv_options dopt(opt);
+
+    // scoring models are loaded once and shared by all workers:
+    const ScoringModelManager scoringModels(opt, dopt.gvcf);
+
+    const unsigned workerCount(opt.workerThreadCount);
+    const bool isRegionBuffer(workerCount > 1);
+
+    std::vector<std::unique_ptr<StarlingRegionWorker>> workers;
+    for (unsigned workerIndex(0); workerIndex < workerCount; ++workerIndex)
+    {
+        workers.emplace_back(new StarlingRegionWorker(pinfo, opt, dopt, scoringModels, isRegionBuffer));
+    }
+
+    const StarlingRegionWorker& referenceWorker(*workers.front());
+    const bam_hdr_t& referenceHeader(referenceWorker.bamHeaders.front());
+    const bam_header_info referenceHeaderInfo(referenceHeader);
+
+    // parse and sanity check regions
+    const auto& referenceAlignmentFilename(opt.alignFileOpt.alignmentFilename.front());
+    std::vector<AnalysisRegionInfo> regionInfo;
+    getStrelkaAnalysisRegions(opt, referenceAlignmentFilename, referenceHeaderInfo, regionInfo);
+
+    if (not isRegionBuffer)
+    {
+        StarlingRegionWorker& worker(*workers.front());
+        for (const auto& rinfo : regionInfo)
+        {
+            worker.processRegion(rinfo);
+        }
+        worker.sppr->reset();
+        segmentStatMan.addReadRealignmentStats(worker.sppr->getReadRealignmentStats());
+        return;
+    }
+
+    // in threaded mode, the workers buffer the output of each region, which is written to the primary
+    // output streams in region order:
+    const starling_streams primaryStreams(opt, dopt, pinfo, referenceWorker.bamHeaders, referenceWorker.sampleNames);
+
+    auto runRegion = [&](const unsigned workerIndex, const unsigned regionIndex, TaskOutput& regionOutput)
+    {
+        StarlingRegionWorker& worker(*workers[workerIndex]);
+        worker.processRegion(regionInfo[regionIndex]);
+        worker.sppr->reset();
+        worker.streams->transferRegionOutput(regionOutput);
+    };
+
+    auto writeRegion = [&](const TaskOutput& regionOutput)
+    {
+        primaryStreams.writeRegionOutput(regionOutput);
+    };
+
+    runOrderedTasks(workerCount, regionInfo.size(), runRegion, writeRegion);
+
+    for (const auto& worker : workers)
+    {
+        segmentStatMan.addReadRealignmentStats(worker->sppr->getReadRealignmentStats());
+    }
+}
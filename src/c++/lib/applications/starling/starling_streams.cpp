@@ -22,6 +22,7 @@
 ///
 
 #include "starling_streams.hh"
+#include "gvcf_header.hh"
 #include "htsapi/bam_header_util.hh"
 
 #include <cassert>
@@ -34,24 +35,29 @@ std::ostream*
 starling_streams::
 initialize_gvcf_file(
     const starling_options& opt,
+    const starling_deriv_options& dopt,
     const prog_info& pinfo,
     const std::string& filename,
     const char* label,
-    const bam_hdr_t& header)
+    const bam_hdr_t& header,
+    const std::vector<std::string>& sampleNames)
 {
-    std::ofstream* fosPtr(new std::ofstream);
-    open_ofstream(pinfo, filename, label, *fosPtr);
+    // use the same compression level as the bgzip9 step previously used to compress gVCF segments:
+    static const int gvcfCompressionLevel(9);
+    std::ostream* osPtr(initialize_text_stream(pinfo, filename, label, gvcfCompressionLevel));
 
-    if (not opt.gvcf.is_skip_header)
+    if ((not opt.gvcf.is_skip_header) && (not isRegionBuffer()))
     {
-        std::ostream& os(*fosPtr);
+        std::ostream& os(*osPtr);
         const char* const cmdline(opt.cmdline.c_str());
 
         write_vcf_audit(opt,pinfo,cmdline,header,os);
 
         os << "##content=" << pinfo.name() << " germline small-variant calls\n";
+
+        finish_gvcf_header(opt, dopt.gvcf, dopt.gvcf.chrom_depth, sampleNames, os);
     }
-    return fosPtr;
+    return osPtr;
 }
 
 
@@ -59,10 +65,12 @@ initialize_gvcf_file(
 starling_streams::
 starling_streams(
     const starling_options& opt,
+    const starling_deriv_options& dopt,
     const prog_info& pinfo,
     const std::vector<std::reference_wrapper<const bam_hdr_t>>& bamHeaders,
-    const std::vector<std::string>& sampleNames)
-    : base_t(opt, pinfo, sampleNames.size()),
+    const std::vector<std::string>& sampleNames,
+    const bool isRegionBuffer)
+    : base_t(opt, pinfo, sampleNames.size(), isRegionBuffer),
       _sampleNames(sampleNames)
 {
     assert(not bamHeaders.empty());
@@ -70,27 +78,31 @@ starling_streams(
 
     if (opt.gvcf.is_gvcf_output())
     {
-        const std::string gvcfVariantsPath(opt.gvcf.outputPrefix+"variants.vcf");
-        _gvcfVariantsStreamPtr.reset(initialize_gvcf_file(opt, pinfo, gvcfVariantsPath, "variants", referenceHeader));
+        const std::string vcfSuffix(opt.gvcf.is_bgzf_output ? ".vcf.gz" : ".vcf");
+        const std::string gvcfVariantsPath(opt.gvcf.outputPrefix+"variants"+vcfSuffix);
+        _gvcfVariantsStreamPtr.reset(
+            initialize_gvcf_file(opt, dopt, pinfo, gvcfVariantsPath, "variants", referenceHeader, sampleNames));
         const unsigned sampleCount(getSampleCount());
         for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
         {
             std::ostringstream sampleTag;
             sampleTag << "S" << (sampleIndex+1);
-            const std::string gvcfSamplePath(opt.gvcf.outputPrefix+"genome." + sampleTag.str() + ".vcf");
+            const std::string gvcfSamplePath(opt.gvcf.outputPrefix+"genome." + sampleTag.str() + vcfSuffix);
             _gvcfSampleStreamPtr.emplace_back(
-                initialize_gvcf_file(opt, pinfo, gvcfSamplePath, sampleTag.str().c_str(), referenceHeader));
+                initialize_gvcf_file(opt, dopt, pinfo, gvcfSamplePath, sampleTag.str().c_str(), referenceHeader,
+                                     {sampleNames[sampleIndex]}));
         }
     }
 
     if (opt.is_realigned_read_file())
     {
+        assert(not isRegionBuffer);
         const unsigned inputAlignFileCount(bamHeaders.size());
         for (unsigned alignFileIndex(0); alignFileIndex < inputAlignFileCount; alignFileIndex++)
         {
             std::ostringstream rfile;
             rfile << opt.realignedReadFilenamePrefix << ".S" << alignFileIndex << ".bam";
-            _realign_bam_ptr[alignFileIndex] = initialize_realign_bam(rfile.str(), bamHeaders[alignFileIndex]);
+            _realign_bam_ptr[alignFileIndex] = initialize_realign_bam(opt, rfile.str(), bamHeaders[alignFileIndex]);
         }
     }
 }
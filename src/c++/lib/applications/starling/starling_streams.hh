@@ -33,9 +33,11 @@ struct starling_streams : public starling_streams_base
 
     starling_streams(
         const starling_options& opt,
+        const starling_deriv_options& dopt,
         const prog_info& pinfo,
         const std::vector<std::reference_wrapper<const bam_hdr_t>>& bamHeaders,
-        const std::vector<std::string>& sampleNames);
+        const std::vector<std::string>& sampleNames,
+        const bool isRegionBuffer = false);
 
     std::ostream&
     gvcfSampleStream(const unsigned sampleIndex) const
@@ -57,14 +59,15 @@ struct starling_streams : public starling_streams_base
     }
 
 private:
-    static
     std::ostream*
     initialize_gvcf_file(
         const starling_options& opt,
+        const starling_deriv_options& dopt,
         const prog_info& pinfo,
         const std::string& filename,
         const char* label,
-        const bam_hdr_t& header);
+        const bam_hdr_t& header,
+        const std::vector<std::string>& sampleNames);
 
     std::unique_ptr<std::ostream> _gvcfVariantsStreamPtr;
     std::vector<std::unique_ptr<std::ostream>> _gvcfSampleStreamPtr;
@@ -0,0 +1,114 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "boost/test/unit_test.hpp"
+
+#include "GermlineLocusPool.hh"
+#include "starling_shared.hh"
+
+#include <sstream>
+
+
+BOOST_AUTO_TEST_SUITE( GermlineLocusPool_test )
+
+
+static
+std::string
+getLocusString(const GermlineDiploidSiteLocusInfo& locus)
+{
+    std::ostringstream oss;
+    oss << locus;
+    return oss.str();
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_GermlineLocusPoolRecycle )
+{
+    starling_options opt;
+    opt.is_user_genome_size = true;
+    opt.user_genome_size = 1000;
+    const starling_deriv_options dopt(opt);
+
+    const unsigned sampleCount(2);
+    GermlineLocusPool pool(dopt.gvcf, sampleCount);
+
+    auto locusPtr(pool.getDiploidSite(10, BASE_ID::A));
+    const GermlineDiploidSiteLocusInfo* const firstLocusPtr(locusPtr.get());
+
+    // modify the locus as if it was called and filtered:
+    locusPtr->addAltSiteAllele(BASE_ID::C);
+    locusPtr->anyVariantAlleleQuality = 30;
+    locusPtr->hpol = 3;
+    locusPtr->filters.set(GERMLINE_VARIANT_VCF_FILTERS::LowGQX);
+    {
+        LocusSampleInfo& sampleInfo(locusPtr->getSample(1));
+        sampleInfo.setPloidy(2);
+        sampleInfo.genotypePhredLoghood.getGenotypeLikelihood(1,1) = 50;
+        sampleInfo.supportCounts.setAltCount(2);
+        sampleInfo.supportCounts.getCounts(true).incrementAlleleCount(1);
+        GermlineSiteSampleInfo siteSampleInfo;
+        siteSampleInfo.n_used_calls = 12;
+        locusPtr->setSiteSampleInfo(1, siteSampleInfo);
+    }
+
+    pool.release(std::move(locusPtr));
+    BOOST_REQUIRE_EQUAL(pool.getFreeSiteCount(), 1u);
+
+    // a recycled locus should be indistinguishable from a new locus:
+    auto recycledLocusPtr(pool.getDiploidSite(20, BASE_ID::G, true));
+    BOOST_REQUIRE_EQUAL(pool.getFreeSiteCount(), 0u);
+    BOOST_REQUIRE_EQUAL(recycledLocusPtr.get(), firstLocusPtr);
+
+    const GermlineDiploidSiteLocusInfo newLocus(dopt.gvcf, sampleCount, 20, BASE_ID::G, true);
+    BOOST_REQUIRE_EQUAL(getLocusString(*recycledLocusPtr), getLocusString(newLocus));
+    BOOST_REQUIRE_EQUAL(recycledLocusPtr->getAltAlleleCount(), 0u);
+    BOOST_REQUIRE(recycledLocusPtr->filters.none());
+    BOOST_REQUIRE_EQUAL(recycledLocusPtr->getSample(1).supportCounts.getAltCount(), 1u);
+    BOOST_REQUIRE(recycledLocusPtr->getSample(1).genotypePhredLoghood.getGenotypeLikelihood().empty());
+
+    // alleles can be added again after reset:
+    recycledLocusPtr->addAltSiteAllele(BASE_ID::T);
+    BOOST_REQUIRE_EQUAL(recycledLocusPtr->getAltAlleleCount(), 1u);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_GermlineLocusPoolReleaseOtherType )
+{
+    starling_options opt;
+    opt.is_user_genome_size = true;
+    opt.user_genome_size = 1000;
+    const starling_deriv_options dopt(opt);
+
+    const unsigned sampleCount(1);
+    GermlineLocusPool pool(dopt.gvcf, sampleCount);
+
+    // loci which were not created by the pool are not recycled:
+    std::unique_ptr<GermlineSiteLocusInfo> continuousLocusPtr(
+        new GermlineContinuousSiteLocusInfo(sampleCount, 10, BASE_ID::A));
+    pool.release(std::move(continuousLocusPtr));
+    BOOST_REQUIRE_EQUAL(pool.getFreeSiteCount(), 0u);
+
+    pool.release(std::unique_ptr<GermlineSiteLocusInfo>());
+    BOOST_REQUIRE_EQUAL(pool.getFreeSiteCount(), 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,128 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "boost/test/unit_test.hpp"
+
+#include "gvcf_block_site_record.hh"
+#include "starling_shared.hh"
+
+
+BOOST_AUTO_TEST_SUITE( gvcf_block_site_record_test )
+
+
+static
+void
+setHomRefLocus(
+    const unsigned depth,
+    const int genotypeQuality,
+    GermlineDiploidSiteLocusInfo& locus)
+{
+    LocusSampleInfo& sampleInfo(locus.getSample(0));
+    sampleInfo.setPloidy(2);
+    sampleInfo.maxGenotypeIndex.setGenotypeFromAlleleIndices(0,0);
+    sampleInfo.maxGenotypeIndexPolymorphic.setGenotypeFromAlleleIndices(0,0);
+    sampleInfo.genotypeQuality = genotypeQuality;
+    sampleInfo.genotypeQualityPolymorphic = genotypeQuality;
+    sampleInfo.setGqx();
+
+    GermlineSiteSampleInfo siteSampleInfo;
+    siteSampleInfo.n_used_calls = depth;
+    siteSampleInfo.mapqTracker.count = depth;
+    locus.setSiteSampleInfo(0, siteSampleInfo);
+}
+
+
+
+static
+void
+setHomRefSite(
+    const pos_t pos,
+    const unsigned depth,
+    const int genotypeQuality,
+    GermlineHomRefSiteInfo& site)
+{
+    site.pos = pos;
+    site.refBaseIndex = BASE_ID::A;
+    GermlineBlockingSampleInfo& sample(site.samples[0]);
+    sample.maxGenotype.setGenotypeFromAlleleIndices(0,0);
+    sample.ploidy = 2;
+    sample.gqx = genotypeQuality;
+    sample.isGqx = true;
+    sample.n_used_calls = depth;
+    sample.totalReadDepth = depth;
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_homRefSiteBlockExtension )
+{
+    starling_options opt;
+    opt.is_user_genome_size = true;
+    opt.user_genome_size = 1000;
+    const starling_deriv_options dopt(opt);
+
+    gvcf_block_site_record locusBlock(opt.gvcf);
+    gvcf_block_site_record homRefBlock(opt.gvcf);
+
+    GermlineHomRefSiteInfo site(1);
+    setHomRefSite(10, 30, 60, site);
+
+    // an empty block cannot be started from a hom-ref site:
+    BOOST_REQUIRE(not homRefBlock.testCanHomRefSiteExtendSampleBlock(site, 0));
+
+    // start both blocks from the same site locus:
+    {
+        GermlineDiploidSiteLocusInfo locus(dopt.gvcf, 1, 10, BASE_ID::A);
+        setHomRefLocus(30, 60, locus);
+        locusBlock.joinSiteToSampleBlock(locus, 0);
+        homRefBlock.joinSiteToSampleBlock(locus, 0);
+    }
+
+    // extending the block with hom-ref sites should match joining the equivalent site loci:
+    const unsigned depths[] = { 32, 28, 35 };
+    pos_t pos(11);
+    for (const unsigned depth : depths)
+    {
+        GermlineDiploidSiteLocusInfo locus(dopt.gvcf, 1, pos, BASE_ID::A);
+        setHomRefLocus(depth, depth*2, locus);
+        BOOST_REQUIRE(locusBlock.testCanSiteJoinSampleBlock(locus, 0));
+        locusBlock.joinSiteToSampleBlock(locus, 0);
+
+        setHomRefSite(pos, depth, depth*2, site);
+        BOOST_REQUIRE(homRefBlock.testCanHomRefSiteExtendSampleBlock(site, 0));
+        homRefBlock.extendSampleBlock(site, 0);
+        pos++;
+    }
+
+    BOOST_REQUIRE_EQUAL(homRefBlock.count, locusBlock.count);
+    BOOST_REQUIRE_EQUAL(homRefBlock.block_dpu.min(), locusBlock.block_dpu.min());
+    BOOST_REQUIRE_EQUAL(homRefBlock.block_dpu.max(), locusBlock.block_dpu.max());
+    BOOST_REQUIRE_EQUAL(homRefBlock.block_gqx.min(), locusBlock.block_gqx.min());
+
+    // sites which are not adjacent to the block, or have different filters, cannot extend it:
+    setHomRefSite(pos+1, 30, 60, site);
+    BOOST_REQUIRE(not homRefBlock.testCanHomRefSiteExtendSampleBlock(site, 0));
+
+    setHomRefSite(pos, 30, 60, site);
+    site.samples[0].filters.set(GERMLINE_VARIANT_VCF_FILTERS::LowGQX);
+    BOOST_REQUIRE(not homRefBlock.testCanHomRefSiteExtendSampleBlock(site, 0));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
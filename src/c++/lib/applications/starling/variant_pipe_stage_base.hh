@@ -23,6 +23,8 @@
 #pragma once
 #include "gvcf_locus_info.hh"
 
+#include <typeinfo>
+
 
 /// base class used for snv/indel processing pipeline from "raw" calls to gVCF
 /// output.
@@ -60,6 +62,12 @@ protected:
     template <class TDerived, class TBase>
     static std::unique_ptr<TDerived> downcast(std::unique_ptr<TBase> basePtr)
     {
+        // this is called for every locus, so check for an exact type match before the full dynamic_cast:
+        if (basePtr and (typeid(*basePtr) == typeid(TDerived)))
+        {
+            return std::unique_ptr<TDerived>(static_cast<TDerived*>(basePtr.release()));
+        }
+
         TDerived* ptr(dynamic_cast<TDerived*>(basePtr.release()));
         if (ptr != nullptr)
         {
@@ -89,6 +89,23 @@ process(std::unique_ptr<GermlineSiteLocusInfo> locusPtr)
 
 
 
+void
+variant_prefilter_stage::
+classifyHomRefSite(
+    GermlineHomRefSiteInfo& site) const
+{
+    // hom-ref sites are never created in 'no-ploid' regions, so only the off target filter is shared with
+    // the site locus:
+    if (_isTargetedRegions and (not _targetedRegions.isIntersectRegion(site.pos)))
+    {
+        site.filters.set(GERMLINE_VARIANT_VCF_FILTERS::OffTarget);
+    }
+
+    _model.default_classify_homref_site(site);
+}
+
+
+
 void
 variant_prefilter_stage::
 process(std::unique_ptr<GermlineIndelLocusInfo> locusPtr)
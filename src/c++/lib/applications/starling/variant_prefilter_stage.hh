@@ -41,6 +41,11 @@ struct variant_prefilter_stage : public variant_pipe_stage_base
     void process(std::unique_ptr<GermlineSiteLocusInfo> locusPtr) override;
     void process(std::unique_ptr<GermlineIndelLocusInfo> locusPtr) override;
 
+    /// apply the same filters to a hom-ref site which would be applied to the equivalent site locus
+    void
+    classifyHomRefSite(
+        GermlineHomRefSiteInfo& site) const;
+
 private:
     void
     applySharedLocusFilters(
@@ -24,7 +24,7 @@
 
 #pragma once
 
-#include "SiteNoise.hh"
+#include "strelka_common/SiteNoise.hh"
 #include "blt_util/blt_types.hh"
 #include "blt_util/RangeMap.hh"
 
@@ -36,6 +36,7 @@
 #include <cmath>
 #include <cstdlib>
 
+#include <array>
 #include <map>
 
 
@@ -65,9 +66,7 @@ get_diploid_strand_grid_lhood_spi(
     const unsigned ref_gt,
     blt_float_t* const lhood)
 {
-    // TODO: make this thread safe...
-    //
-    static het_ratio_cache<2> hrcache;
+    static thread_local het_ratio_cache<2> hrcache;
 
     // get likelihood of each genotype
     for (unsigned gt(0); gt<(DIGT_GRID::STRAND_STATE_SIZE); ++gt) lhood[gt] = 0.;
@@ -154,7 +153,65 @@ gvcf_nonsomatic_gvcf_prior(
 
 
 
+/// table of gvcf_nonsomatic_gvcf_prior values for each DDIGT_GRID state
+struct NonsomaticGvcfPriors
+{
+    NonsomaticGvcfPriors()
+    {
+        for (unsigned fn(0); fn<DIGT_GRID::PRESTRAND_SIZE; ++fn)
+        {
+            for (unsigned ft(0); ft<DIGT_GRID::PRESTRAND_SIZE; ++ft)
+            {
+                val[DDIGT_GRID::get_state(fn,ft)] = gvcf_nonsomatic_gvcf_prior(fn,ft);
+            }
+        }
+    }
+
+    std::array<float,DDIGT_GRID::PRESTRAND_SIZE> val;
+};
+
+
+
+/// get the posterior probability of the expanded 'non-somatic' state used for the somatic gVCF
+///
+/// this processes regular tumor/normal lhood, but:
+/// (1) uses uniform probability for {somatic,non-somatic} states
+/// (2) simplifies computation to remove strand-specific logic
+/// (3) ignores normal genotype
+///
 static
+double
+get_gvcf_nonsomatic_prob(
+    const blt_float_t* normal_lhood,
+    const blt_float_t* tumor_lhood)
+{
+    static const NonsomaticGvcfPriors priors;
+
+    double pprob[DDIGT_GRID::PRESTRAND_SIZE];
+    for (unsigned fn(0); fn<DIGT_GRID::PRESTRAND_SIZE; ++fn)
+    {
+        for (unsigned ft(0); ft<DIGT_GRID::PRESTRAND_SIZE; ++ft)
+        {
+            const unsigned dgt(DDIGT_GRID::get_state(fn,ft));
+            pprob[dgt] = normal_lhood[fn]+tumor_lhood[ft]+priors.val[dgt];
+        }
+    }
+
+    unsigned max_gt(0);
+    opt_normalize_ln_distro(pprob,pprob+DDIGT_GRID::PRESTRAND_SIZE,
+                            DDIGT_GRID::is_nonsom.val.begin(),max_gt);
+
+    double sgvcf_nonsomatic_sum(0);
+    for (unsigned f(0); f<DIGT_GRID::PRESTRAND_SIZE; ++f)
+    {
+        const unsigned dgt(DDIGT_GRID::get_state(f,f));
+        sgvcf_nonsomatic_sum += pprob[dgt];
+    }
+    return sgvcf_nonsomatic_sum;
+}
+
+
+
 void
 calculate_result_set_grid(
     const bool isComputeNonSomatic,
@@ -185,33 +242,7 @@ calculate_result_set_grid(
     // add new somatic gVCF value -- note this is an expanded definition of 'non-somatic' beyond just f_N == f_T
     if (isComputeNonSomatic)
     {
-        // process regular tumor/normal lhood, but:
-        // (1) use uniform probability for {somatic,non-somatic} states
-        // (2) simplify computation to remove strand-specific logic
-        // (3) ignore normal genotype
-        //
-        std::vector<double> pprob(DDIGT_GRID::SIZE);
-        for (unsigned fn(0); fn<DIGT_GRID::PRESTRAND_SIZE; ++fn)
-        {
-            for (unsigned ft(0); ft<DIGT_GRID::PRESTRAND_SIZE; ++ft)
-            {
-                const unsigned dgt(DDIGT_GRID::get_state(fn,ft));
-                pprob[dgt] = normal_lhood[fn]+tumor_lhood[ft]+gvcf_nonsomatic_gvcf_prior(fn,ft);
-            }
-        }
-
-        unsigned max_gt(0);
-        opt_normalize_ln_distro(pprob.begin(),pprob.begin()+DDIGT_GRID::PRESTRAND_SIZE,
-                                DDIGT_GRID::is_nonsom.val.begin(),max_gt);
-
-        double sgvcf_nonsomatic_sum(0);
-        for (unsigned f(0); f<DIGT_GRID::PRESTRAND_SIZE; ++f)
-        {
-            const unsigned dgt(DDIGT_GRID::get_state(f,f));
-            sgvcf_nonsomatic_sum += pprob[dgt];
-        }
-
-        rs.nonsomatic_qphred=error_prob_to_qphred(1.-sgvcf_nonsomatic_sum);
+        rs.nonsomatic_qphred=error_prob_to_qphred(1.-get_gvcf_nonsomatic_prob(normal_lhood, tumor_lhood));
     }
 
     static const bool is_compute_sb(true);
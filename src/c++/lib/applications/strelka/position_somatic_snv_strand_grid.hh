@@ -35,6 +35,26 @@
 #include "blt_common/position_snp_call_pprob_digt.hh"
 
 
+/// compute the somatic snv result set for one site from its normal and tumor grid likelihoods
+///
+/// \param normal_lhood normal sample likelihoods, indexed by DIGT_GRID state
+/// \param tumor_lhood tumor sample likelihoods, indexed by DIGT_GRID state
+/// \param bare_lnprior_normal normal genotype log priors, indexed by SOMATIC_DIGT state
+void
+calculate_result_set_grid(
+    const bool isComputeNonSomatic,
+    const blt_float_t ssnv_contam_tolerance,
+    const blt_float_t ln_sse_rate,
+    const blt_float_t ln_csse_rate,
+    const blt_float_t* normal_lhood,
+    const blt_float_t* tumor_lhood,
+    const blt_float_t* bare_lnprior_normal,
+    const blt_float_t lnmatch,
+    const blt_float_t lnmismatch,
+    const bool is_forced_output,
+    snv_result_set& rs);
+
+
 // object used to pre-compute priors:
 struct somatic_snv_caller_strand_grid
 {
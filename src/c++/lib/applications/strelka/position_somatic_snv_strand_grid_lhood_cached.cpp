@@ -24,6 +24,7 @@
 
 #include "position_somatic_snv_strand_grid_lhood_cached.hh"
 #include "strelka_digt_states.hh"
+#include "strelka_common/BasecallQscoreCounts.hh"
 #include "strelka_common/het_ratio_cache.hh"
 
 #include "blt_util/digt.hh"
@@ -36,28 +37,56 @@ static const blt_float_t ln_one_third(std::log(one_third));
 static const blt_float_t one_half(1./2.);
 static const blt_float_t ln_one_half(std::log(one_half));
 
+
+
+/// get the number of calls matching and not matching the reference for one qscore
+static
+void
+getRefAltCounts(
+    const std::array<unsigned,N_BASE>& baseCount,
+    const unsigned ref_gt,
+    unsigned& refCount,
+    unsigned& altCount)
+{
+    refCount = 0;
+    altCount = 0;
+    for (unsigned obs_id(0); obs_id<N_BASE; ++obs_id)
+    {
+        if (obs_id == ref_gt)
+        {
+            refCount += baseCount[obs_id];
+        }
+        else
+        {
+            altCount += baseCount[obs_id];
+        }
+    }
+}
+
+
+
 void
 get_diploid_gt_lhood_cached_simple(
     const snp_pos_info& pi,
     const unsigned ref_gt,
     blt_float_t* const lhood)
 {
-    // ! not thread-safe !
-    static het_ratio_cache<3> hrcache;
+    static thread_local het_ratio_cache<3> hrcache;
 
     // get likelihood of each genotype
     for (unsigned gt(0); gt<SOMATIC_DIGT::SIZE; ++gt) lhood[gt] = 0.;
 
-    for (const base_call& bc : pi.calls)
+    const BasecallQscoreCounts counts(pi);
+    for (const auto& qcounts : counts)
     {
-        std::pair<bool,cache_val<3>*> ret(hrcache.get_val(bc.get_qscore(),0));
+        std::pair<bool,cache_val<3>*> ret(hrcache.get_val(qcounts.qscore,0));
         cache_val<3>& cv(*ret.second);
         if (! ret.first)
         {
-            const blt_float_t eprob(bc.error_prob());
+            const blt_float_t eprob(qphred_to_error_prob(qcounts.qscore));
             const blt_float_t ceprob(1-eprob);
-            const blt_float_t lne(bc.ln_error_prob());
-            const blt_float_t lnce(bc.ln_comp_error_prob());
+            const blt_float_t lne(qphred_to_ln_error_prob(qcounts.qscore));
+            const blt_float_t lnce(qphred_to_ln_comp_error_prob(qcounts.qscore));
 
             // precalculate the result for expect values of 0.0, 0.5 & 1.0
             cv.val[0] = lne+ln_one_third;
@@ -65,27 +94,19 @@ get_diploid_gt_lhood_cached_simple(
             cv.val[2] = lnce;
         }
 
-        const uint8_t obs_id(bc.base_id);
+        unsigned refCount, altCount;
+        getRefAltCounts(qcounts.baseCount, ref_gt, refCount, altCount);
 
-        if (obs_id == ref_gt)
-        {
-            lhood[SOMATIC_DIGT::REF] += cv.val[2];
-            lhood[SOMATIC_DIGT::HET] += cv.val[1];
-            lhood[SOMATIC_DIGT::HOM] += cv.val[0];
-        }
-        else
-        {
-            lhood[SOMATIC_DIGT::REF] += cv.val[0];
-            lhood[SOMATIC_DIGT::HET] += cv.val[1];
-            lhood[SOMATIC_DIGT::HOM] += cv.val[2];
-        }
+        lhood[SOMATIC_DIGT::REF] += refCount*cv.val[2] + altCount*cv.val[0];
+        lhood[SOMATIC_DIGT::HET] += (refCount+altCount)*cv.val[1];
+        lhood[SOMATIC_DIGT::HOM] += refCount*cv.val[0] + altCount*cv.val[2];
     }
 }
 
 static
 void
 get_high_low_het_ratio_lhood_cached(
-    const snp_pos_info& pi,
+    const BasecallQscoreCounts& counts,
     const unsigned ref_gt,
     const blt_float_t het_ratio,
     const unsigned het_ratio_index,
@@ -95,17 +116,13 @@ get_high_low_het_ratio_lhood_cached(
 {
     const blt_float_t chet_ratio(1.-het_ratio);
 
-    const unsigned n_calls(pi.calls.size());
-
-    for (unsigned i(0); i<n_calls; ++i)
+    for (const auto& qcounts : counts)
     {
-        const base_call& bc(pi.calls[i]);
-
-        std::pair<bool,cache_val<2>*> ret(hrcache.get_val(bc.get_qscore(),het_ratio_index));
+        std::pair<bool,cache_val<2>*> ret(hrcache.get_val(qcounts.qscore,het_ratio_index));
         cache_val<2>& cv(*ret.second);
         if (! ret.first)
         {
-            const blt_float_t eprob(bc.error_prob());
+            const blt_float_t eprob(qphred_to_error_prob(qcounts.qscore));
             const blt_float_t ceprob(1-eprob);
 
             // precalculate the result for expect values of het_ratio and chet_ratio
@@ -113,18 +130,11 @@ get_high_low_het_ratio_lhood_cached(
             cv.val[1] = std::log((ceprob)*chet_ratio+((eprob)*one_third)*het_ratio);    // match for lhood_low, mismatch for lhood_high
         }
 
-        const uint8_t obs_id(bc.base_id);
+        unsigned refCount, altCount;
+        getRefAltCounts(qcounts.baseCount, ref_gt, refCount, altCount);
 
-        if (obs_id == ref_gt)   // match
-        {
-            *lhood_high += cv.val[0];
-            *lhood_low += cv.val[1];
-        }
-        else                    // mismatch
-        {
-            *lhood_high += cv.val[1];
-            *lhood_low += cv.val[0];
-        }
+        *lhood_high += refCount*cv.val[0] + altCount*cv.val[1];
+        *lhood_low += refCount*cv.val[1] + altCount*cv.val[0];
     }
 }
 
@@ -135,8 +145,7 @@ get_diploid_het_grid_lhood_cached(
     const unsigned hetResolution,
     blt_float_t* const lhood)
 {
-    // ! not thread-safe !
-    static het_ratio_cache<2> hrcache;
+    static thread_local het_ratio_cache<2> hrcache;
 
     // get likelihood of each genotype
     const unsigned totalHetRatios(hetResolution*2);
@@ -144,10 +153,11 @@ get_diploid_het_grid_lhood_cached(
 
 //    blt_float_t* lhood_off=lhood-N_BASE;
 
+    const BasecallQscoreCounts counts(pi);
     for (unsigned hetIndex(0); hetIndex<hetResolution; ++hetIndex)
     {
         const blt_float_t het_ratio((hetIndex+1)*DIGT_GRID::RATIO_INCREMENT);
-        get_high_low_het_ratio_lhood_cached(pi,ref_gt, het_ratio,hetIndex,hrcache,
+        get_high_low_het_ratio_lhood_cached(counts,ref_gt, het_ratio,hetIndex,hrcache,
                                             lhood+(totalHetRatios-(hetIndex+1)),
                                             lhood+hetIndex);
     }
@@ -188,16 +198,17 @@ get_strand_ratio_lhood_spi(
     blt_float_t lhood_fwd = 0; // "on-strand" is fwd
     blt_float_t lhood_rev = 0; // "on-strand" is rev
 
-    for (const base_call& bc : pi.calls)
+    const BasecallQscoreCounts counts(pi);
+    for (const auto& qcounts : counts)
     {
-        std::pair<bool,cache_val<2>*> ret(hrcache.get_val(bc.get_qscore(),het_ratio_index));
+        std::pair<bool,cache_val<2>*> ret(hrcache.get_val(qcounts.qscore,het_ratio_index));
         cache_val<2>& cv(*ret.second);
 
         // compute results only if they aren't already cached:
         //
         if (! ret.first)
         {
-            const blt_float_t eprob(bc.error_prob());
+            const blt_float_t eprob(qphred_to_error_prob(qcounts.qscore));
             const blt_float_t ceprob(1.-eprob);
             // cached value [0] refers to state 2 above: on-strand
             // reference allele
@@ -207,25 +218,15 @@ get_strand_ratio_lhood_spi(
             cv.val[1]=(std::log((ceprob)*het_ratio+((eprob)*one_third)*chet_ratio));
         }
 
-        const uint8_t obs_id(bc.base_id);
+        unsigned fwdRefCount, fwdAltCount, revRefCount, revAltCount;
+        getRefAltCounts(qcounts.strandBaseCount[1], ref_gt, fwdRefCount, fwdAltCount);
+        getRefAltCounts(qcounts.strandBaseCount[0], ref_gt, revRefCount, revAltCount);
 
-        if (obs_id==ref_gt)
-        {
-            const blt_float_t val_off_strand(bc.ln_comp_error_prob());
-            const blt_float_t val_fwd(bc.is_fwd_strand ? cv.val[0] : val_off_strand);
-            const blt_float_t val_rev(bc.is_fwd_strand ? val_off_strand : cv.val[0]);
-            lhood_fwd += val_fwd;
-            lhood_rev += val_rev;
-        }
-        else
-        {
-            const blt_float_t val_off_strand(bc.ln_error_prob()+ln_one_third);
-            const blt_float_t val_fwd(bc.is_fwd_strand ? cv.val[1] : val_off_strand);
-            const blt_float_t val_rev(bc.is_fwd_strand ? val_off_strand : cv.val[1]);
+        const blt_float_t ref_off_strand(qphred_to_ln_comp_error_prob(qcounts.qscore));
+        const blt_float_t alt_off_strand(qphred_to_ln_error_prob(qcounts.qscore)+ln_one_third);
 
-            lhood_fwd += val_fwd;
-            lhood_rev += val_rev;
-        }
+        lhood_fwd += fwdRefCount*cv.val[0] + revRefCount*ref_off_strand + fwdAltCount*cv.val[1] + revAltCount*alt_off_strand;
+        lhood_rev += revRefCount*cv.val[0] + fwdRefCount*ref_off_strand + revAltCount*cv.val[1] + fwdAltCount*alt_off_strand;
     }
 
     *lhood = log_sum(lhood_fwd,lhood_rev)+ln_one_half;
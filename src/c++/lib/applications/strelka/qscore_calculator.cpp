@@ -52,6 +52,86 @@ static const blt_float_t neg_inf = -std::numeric_limits<float>::infinity();
 static const blt_float_t ln_one_half(std::log(1./2.));
 static const blt_float_t log_error_mod = -std::log(static_cast<double>(DIGT_GRID::PRESTRAND_SIZE-1));
 
+/// get the log probability of each (normal,tumor) frequency pair which has non-zero prior probability under a
+/// non-somatic normal genotype ngt
+///
+/// \return number of values written to log_sum
+static
+unsigned
+get_nonsomatic_freq_log_sum(
+    const unsigned ngt,
+    const blt_float_t ln_se_rate,
+    const blt_float_t ln_cse_rate,
+    const blt_float_t* normal_lhood,
+    const blt_float_t* tumor_lhood,
+    double* log_sum)
+{
+    // P(fn != ft | Gn = Gt) = 0, so only the diagonal of the frequency grid is needed:
+    const blt_float_t ln_freq_error_rate(ln_se_rate+log_error_mod);
+    for (unsigned freq_index(0); freq_index<DIGT_GRID::PRESTRAND_SIZE; ++freq_index)
+    {
+        const double lprior_freq = (freq_index == ngt) ? ln_cse_rate : ln_freq_error_rate;
+        log_sum[freq_index] = lprior_freq + normal_lhood[freq_index] + tumor_lhood[freq_index];
+    }
+    return DIGT_GRID::PRESTRAND_SIZE;
+}
+
+
+
+/// get the log probability of each (normal,tumor) frequency pair which has non-zero prior probability under a
+/// somatic state with normal genotype ngt
+///
+/// values are produced in tumor frequency order, then normal frequency order
+///
+/// \return number of values written to log_sum
+static
+unsigned
+get_somatic_freq_log_sum(
+    const unsigned ngt,
+    const blt_float_t contam_tolerance,
+    const blt_float_t ln_cse_rate,
+    const blt_float_t* normal_lhood,
+    const blt_float_t* tumor_lhood,
+    double* log_sum)
+{
+    // P(fn = ft | Gn != Gt) = 0
+    unsigned size(0);
+    if (ngt != SOMATIC_DIGT::REF)
+    {
+        const double lprior_freq = log_error_mod + ln_cse_rate;
+        for (unsigned tumor_freq_index(0); tumor_freq_index<DIGT_GRID::PRESTRAND_SIZE; ++tumor_freq_index)
+        {
+            if (tumor_freq_index == ngt) continue;
+            log_sum[size++] = lprior_freq + normal_lhood[ngt] + tumor_lhood[tumor_freq_index];
+        }
+    }
+    else
+    {
+        // if tumor_freq is large, normal_freq==DIGT_GRID::RATIO_INCREMENT is considered as "canonical" frequency
+        // rather than noise:
+        static const unsigned contam_freq_index(SOMATIC_DIGT::SIZE);
+
+        const double lprior_freq = log_error_mod + ln_one_half;
+        for (unsigned tumor_freq_index(0); tumor_freq_index<DIGT_GRID::PRESTRAND_SIZE; ++tumor_freq_index)
+        {
+            const blt_float_t tumor_freq = DIGT_GRID::get_fraction_from_index(tumor_freq_index);
+            const bool consider_norm_contam = contam_tolerance*tumor_freq >= DIGT_GRID::RATIO_INCREMENT;
+
+            if (tumor_freq_index != ngt)
+            {
+                log_sum[size++] = lprior_freq + normal_lhood[ngt] + tumor_lhood[tumor_freq_index];
+            }
+            if (consider_norm_contam && (tumor_freq_index != contam_freq_index))
+            {
+                log_sum[size++] = lprior_freq + normal_lhood[contam_freq_index] + tumor_lhood[tumor_freq_index];
+            }
+        }
+    }
+    return size;
+}
+
+
+
 void
 calculate_result_set_grid(
     const blt_float_t contam_tolerance,
@@ -70,58 +150,28 @@ calculate_result_set_grid(
 
     rs.max_gt = 0;
 
+    // each somatic state has at most two normal frequencies for each tumor frequency:
+    double log_sum[DIGT_GRID::PRESTRAND_SIZE*2];
+
     for (unsigned ngt(0); ngt<SOMATIC_DIGT::SIZE; ++ngt)
     {
         for (unsigned tgt(0); tgt<SOMATIC_STATE::SIZE; ++tgt) // 0: non-somatic, 1: somatic
         {
-            double max_log_sum = neg_inf;
-            double log_sum[DDIGT_GRID::PRESTRAND_SIZE];
-            int index = 0;
+            const unsigned log_sum_size((tgt == 0) ?
+                                        get_nonsomatic_freq_log_sum(ngt, ln_se_rate, ln_cse_rate,
+                                                                    normal_lhood, tumor_lhood, log_sum) :
+                                        get_somatic_freq_log_sum(ngt, contam_tolerance, ln_cse_rate,
+                                                                 normal_lhood, tumor_lhood, log_sum));
 
-            for (unsigned tumor_freq_index(0); tumor_freq_index<DIGT_GRID::PRESTRAND_SIZE; ++tumor_freq_index)
+            double max_log_sum = neg_inf;
+            for (unsigned i(0); i<log_sum_size; ++i)
             {
-                blt_float_t tumor_freq = DIGT_GRID::get_fraction_from_index(tumor_freq_index);
-
-                // this flag is set if tumor_freq is large.
-                // if it is set, normal_freq==DIGT_GRID::RATIO_INCREMENT is considered as "canonical" frequency rather than noise
-                bool consider_norm_contam = contam_tolerance*tumor_freq >= DIGT_GRID::RATIO_INCREMENT;
-
-                for (unsigned normal_freq_index(0); normal_freq_index<DIGT_GRID::PRESTRAND_SIZE; ++normal_freq_index)
-                {
-                    double lprior_freq;
-
-                    if (tgt == 0)    // non-somatic
-                    {
-                        if (normal_freq_index != tumor_freq_index) continue; // P(fn != ft | Gn = Gt) = 0
-
-                        lprior_freq = (normal_freq_index == ngt) ? ln_cse_rate : ln_se_rate+log_error_mod;
-                    }
-                    else    // somatic
-                    {
-                        if (normal_freq_index == tumor_freq_index) continue; // P(fn = ft | Gn != Gt) = 0
-                        if (ngt != SOMATIC_DIGT::REF)
-                        {
-                            if (normal_freq_index != ngt)
-                                continue;
-                            lprior_freq = log_error_mod + ln_cse_rate;
-                        }
-                        else
-                        {
-                            if (normal_freq_index == ngt || (consider_norm_contam && normal_freq_index == SOMATIC_DIGT::SIZE))
-                                lprior_freq = log_error_mod + ln_one_half;
-                            else
-                                continue;
-                        }
-                    }
-                    double lsum = lprior_freq + normal_lhood[normal_freq_index] + tumor_lhood[tumor_freq_index];
-                    log_sum[index++] = lsum;
-                    if (lsum > max_log_sum) max_log_sum = lsum;
-                }
+                if (log_sum[i] > max_log_sum) max_log_sum = log_sum[i];
             }
 
             // Calculate log(exp(log_sum[0]-max_log_sum) + ...
             double sum = 0.0;
-            for (int i(0); i<index; ++i)
+            for (unsigned i(0); i<log_sum_size; ++i)
             {
                 sum += std::exp(log_sum[i] - max_log_sum);
             }
@@ -26,7 +26,7 @@
 #pragma once
 
 #include "boost/utility.hpp"
-#include "SiteNoise.hh"
+#include "strelka_common/SiteNoise.hh"
 
 #include <iosfwd>
 
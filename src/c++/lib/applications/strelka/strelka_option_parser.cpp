@@ -92,6 +92,8 @@ get_strelka_option_parser(
      "Output a bed file of regions which are confidently somatic or non-somatic for SNVs at allele frequencies of 10% or greater.")
     ("noise-vcf", po::value(&opt.noise_vcf)->multitoken(),
      "Noise panel VCF for low-frequency noise")
+    ("noise-track", po::value(&opt.noise_track_filename),
+     "Noise panel for low-frequency noise in the binary site noise track format written by PackNoisePanel, this replaces noise-vcf")
     ;
 
     po::options_description strelka_parse_opt_filter("Somatic variant-calling filters");
@@ -215,6 +217,17 @@ finalize_strelka_options(
         pinfo.usage("Strelka depth factor must not be less than 0");
     }
 
+    if ((opt.workerThreadCount > 1) && opt.is_tumor_realigned_read())
+    {
+        pinfo.usage("Realigned read output is not supported with multiple worker threads");
+    }
+
+    if ((not opt.noise_vcf.empty()) and (not opt.noise_track_filename.empty()))
+    {
+        pinfo.usage("Noise panel can be provided as noise-vcf or noise-track but not both");
+    }
+    checkOptionalFile(pinfo,opt.noise_track_filename, "noise track");
+
     checkOptionalFile(pinfo,opt.somatic_snv_scoring_model_filename, "somatic snv scoring model");
     checkOptionalFile(pinfo,opt.somatic_indel_scoring_model_filename, "somatic indel scoring model");
 
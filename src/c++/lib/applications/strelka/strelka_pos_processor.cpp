@@ -87,6 +87,10 @@ reset()
 
     _indelWriter.clear();
     _noisePos.clear();
+
+    // in region buffer mode, end any callable range at the region boundary so that the range is included in the
+    // transferred region output. Abutting ranges are merged again when region output is appended:
+    if (_streams.isRegionBuffer()) _scallProcessor.flush();
 }
 
 
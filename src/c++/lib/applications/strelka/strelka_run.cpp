@@ -28,11 +28,15 @@
 
 #include "appstats/RunStatsManager.hh"
 #include "blt_util/log.hh"
+#include "blt_util/OrderedTaskRunner.hh"
 #include "common/Exceptions.hh"
 #include "htsapi/bam_header_info.hh"
 #include "starling_common/HtsMergeStreamerUtil.hh"
 #include "starling_common/starling_ref_seq.hh"
 #include "starling_common/starling_pos_processor_util.hh"
+#include "strelka_common/SiteNoiseTrack.hh"
+
+#include <memory>
 
 
 
@@ -50,31 +54,24 @@ enum index_t
 
 
 
-void
-strelka_run(
-    const prog_info& pinfo,
-    const strelka_options& opt)
+namespace
 {
-    using namespace illumina::common;
-
-    // ensure that this object is created first for runtime benchmark
-    RunStatsManager segmentStatMan(opt.segmentStatsFilename);
-
-    opt.validate();
-
-    const strelka_deriv_options dopt(opt);
-    const StrelkaSampleSetSummary ssi;
-    starling_read_counts brc;
-    reference_contig_segment ref;
 
-    ////////////////////////////////////////
-    // setup streamData:
-    //
-    HtsMergeStreamer streamData;
-
-    // additional data structures required in the region loop below, which are filled in as a side effect of
-    // streamData initialization:
-    std::vector<std::reference_wrapper<const bam_hdr_t>> bamHeaders;
+/// all per-thread state required to analyze a series of regions
+///
+/// each worker owns its own input streams, reference segment and position processor, so that workers can
+/// process different regions concurrently while sharing only the (read-only) options and noise track
+///
+struct StrelkaRegionWorker
+{
+    /// \param[in] noiseTrackPtr optional noise panel track, shared by all workers
+    StrelkaRegionWorker(
+        const prog_info& pinfo,
+        const strelka_options& opt,
+        const strelka_deriv_options& dopt,
+        const bool isRegionBuffer,
+        const SiteNoiseTrack* noiseTrackPtr)
+        : _opt(opt)
     {
         std::vector<unsigned> registrationIndices;
         for (const bool isTumor : opt.alignFileOpt.isAlignmentTumor)
@@ -83,7 +80,8 @@ strelka_run(
             registrationIndices.push_back(rindex);
         }
 
-        bamHeaders = registerAlignments(opt.alignFileOpt.alignmentFilename, registrationIndices, streamData);
+        bamHeaders = registerAlignments(opt.alignFileOpt.alignmentFilename, registrationIndices, streamData,
+                                        opt.isAlignmentPrefetch);
 
         assert(not bamHeaders.empty());
         const bam_hdr_t& referenceHeader(bamHeaders.front());
@@ -94,105 +92,242 @@ strelka_run(
         registerVcfList(opt.force_output_vcf, INPUT_TYPE::FORCED_GT_VARIANTS, referenceHeader, streamData);
 
         registerVcfList(opt.noise_vcf, INPUT_TYPE::NOISE_VARIANTS, referenceHeader, streamData);
+        if (nullptr != noiseTrackPtr)
+        {
+            noiseTrackReader.reset(new SiteNoiseTrackRegionReader(*noiseTrackPtr));
+        }
+
+        streams.reset(new strelka_streams(opt, dopt, pinfo, referenceHeader, ssi, isRegionBuffer));
+        sppr.reset(new strelka_pos_processor(opt, dopt, ref, *streams));
     }
 
-    const bam_hdr_t& referenceHeader(bamHeaders.front());
-    const bam_header_info referenceHeaderInfo(referenceHeader);
+    /// process all input for one analysis region
+    ///
+    /// output for the region is not guaranteed to be complete until sppr is reset or moved to another region
+    void
+    processRegion(const AnalysisRegionInfo& rinfo);
 
-    strelka_streams client_io(opt, dopt, pinfo, referenceHeader, ssi);
-    strelka_pos_processor sppr(opt, dopt, ref, client_io);
+    HtsMergeStreamer streamData;
 
-    // parse and sanity check regions
-    const auto& referenceAlignmentFilename(opt.alignFileOpt.alignmentFilename.front());
-    std::vector<AnalysisRegionInfo> regionInfo;
-    getStrelkaAnalysisRegions(opt, referenceAlignmentFilename, referenceHeaderInfo, regionInfo);
+    // additional data structures required in the region loop below, which are filled in as a side effect of
+    // streamData initialization:
+    std::vector<std::reference_wrapper<const bam_hdr_t>> bamHeaders;
+
+    const StrelkaSampleSetSummary ssi;
+    starling_read_counts brc;
+    reference_contig_segment ref;
+    std::unique_ptr<strelka_streams> streams;
+    std::unique_ptr<strelka_pos_processor> sppr;
+    std::unique_ptr<SiteNoiseTrackRegionReader> noiseTrackReader;
+
+private:
+    /// insert all noise track sites in the current region up to and including endPos
+    ///
+    /// sppr is wound forward to each site in turn, exactly as it would be for the same site read from a noise vcf
+    void
+    insertTrackNoise(const pos_t endPos);
+
+    const strelka_options& _opt;
+};
+
+
+
+void
+StrelkaRegionWorker::
+insertTrackNoise(const pos_t endPos)
+{
+    if (not noiseTrackReader) return;
 
-    for (const auto& rinfo : regionInfo)
+    SiteNoise sn;
+    while (noiseTrackReader->isNextPos() and (noiseTrackReader->getNextPos() <= endPos))
     {
-        sppr.resetRegion(rinfo.regionChrom, rinfo.regionRange);
-        streamData.resetRegion(rinfo.streamerRegion.c_str());
-        setRefSegment(opt, rinfo.regionChrom, rinfo.refRegionRange, ref);
+        const pos_t pos(noiseTrackReader->getNextPos());
+        noiseTrackReader->next(sn);
+        sppr->set_head_pos(pos - 1);
+        sppr->insert_noise_pos(pos, sn);
+    }
+}
 
-        while (streamData.next())
-        {
-            const pos_t currentPos(streamData.getCurrentPos());
-            const HTS_TYPE::index_t currentHtsType(streamData.getCurrentType());
-            const unsigned currentIndex(streamData.getCurrentIndex());
 
-            // wind sppr forward to position behind buffer head:
-            sppr.set_head_pos(currentPos - 1);
 
-            if (HTS_TYPE::BAM == currentHtsType)
+void
+StrelkaRegionWorker::
+processRegion(const AnalysisRegionInfo& rinfo)
+{
+    using namespace illumina::common;
+
+    const strelka_options& opt(_opt);
+
+    sppr->resetRegion(rinfo.regionChrom, rinfo.regionRange);
+    streamData.resetRegion(rinfo.streamerRegion.c_str());
+    setRefSegment(opt, rinfo.regionChrom, rinfo.refRegionRange, ref);
+
+    // the noise track covers the same range as the noise vcf region query:
+    if (noiseTrackReader)
+    {
+        noiseTrackReader->resetRegion(rinfo.regionChrom, rinfo.streamerRegionRange.begin_pos(),
+                                      rinfo.streamerRegionRange.end_pos());
+    }
+
+    while (streamData.next())
+    {
+        const pos_t currentPos(streamData.getCurrentPos());
+        const HTS_TYPE::index_t currentHtsType(streamData.getCurrentType());
+        const unsigned currentIndex(streamData.getCurrentIndex());
+
+        insertTrackNoise(currentPos);
+
+        // wind sppr forward to position behind buffer head:
+        sppr->set_head_pos(currentPos - 1);
+
+        if (HTS_TYPE::BAM == currentHtsType)
+        {
+            // Remove the filter below because it's not valid for
+            // RNA-Seq case, reads should be selected for the report
+            // range by the bam reading functions
+            //
+            // /// get potential bounds of the read based only on current_pos:
+            // const known_pos_range any_read_bounds(current_pos-max_indel_size,current_pos+MAX_READ_SIZE+max_indel_size);
+            // if( sppr.is_range_outside_report_influence_zone(any_read_bounds) ) continue;
+
+            // Approximate begin range filter: (removed for RNA-Seq)
+            //if((current_pos+MAX_READ_SIZE+MAX_INDEL_SIZE) <= rlimit.begin_pos) continue;
+            processInputReadAlignment(opt, ref, streamData.getCurrentBamStreamer(),
+                                      streamData.getCurrentBam(), currentPos,
+                                      brc, *sppr, currentIndex);
+        }
+        else if (HTS_TYPE::VCF == currentHtsType)
+        {
+            const vcf_record& vcfRecord(streamData.getCurrentVcf());
+            if (INPUT_TYPE::CANDIDATE_INDELS == currentIndex)     // process candidate indels input from vcf file(s)
             {
-                // Remove the filter below because it's not valid for
-                // RNA-Seq case, reads should be selected for the report
-                // range by the bam reading functions
-                //
-                // /// get potential bounds of the read based only on current_pos:
-                // const known_pos_range any_read_bounds(current_pos-max_indel_size,current_pos+MAX_READ_SIZE+max_indel_size);
-                // if( sppr.is_range_outside_report_influence_zone(any_read_bounds) ) continue;
-
-                // Approximate begin range filter: (removed for RNA-Seq)
-                //if((current_pos+MAX_READ_SIZE+MAX_INDEL_SIZE) <= rlimit.begin_pos) continue;
-                processInputReadAlignment(opt, ref, streamData.getCurrentBamStreamer(),
-                                          streamData.getCurrentBam(), currentPos,
-                                          brc, sppr, currentIndex);
+                if (vcfRecord.is_indel())
+                {
+                    process_candidate_indel(opt.max_indel_size, vcfRecord, *sppr);
+                }
+                else
+                {
+                    log_os << "WARNING: candidate indel vcf variant record cannot be categorized as indel:\n";
+                    streamData.getCurrentVcfStreamer().report_state(log_os);
+                }
             }
-            else if (HTS_TYPE::VCF == currentHtsType)
+            else if (INPUT_TYPE::FORCED_GT_VARIANTS ==
+                     currentIndex)     // process forced genotype tests from vcf file(s)
             {
-                const vcf_record& vcfRecord(streamData.getCurrentVcf());
-                if (INPUT_TYPE::CANDIDATE_INDELS == currentIndex)     // process candidate indels input from vcf file(s)
+                if (vcfRecord.is_indel())
                 {
-                    if (vcfRecord.is_indel())
-                    {
-                        process_candidate_indel(opt.max_indel_size, vcfRecord, sppr);
-                    }
-                    else
-                    {
-                        log_os << "WARNING: candidate indel vcf variant record cannot be categorized as indel:\n";
-                        streamData.getCurrentVcfStreamer().report_state(log_os);
-                    }
+                    static const unsigned sample_no(0);
+                    static const bool is_forced_output(true);
+                    process_candidate_indel(opt.max_indel_size, vcfRecord, *sppr, sample_no, is_forced_output);
                 }
-                else if (INPUT_TYPE::FORCED_GT_VARIANTS ==
-                         currentIndex)     // process forced genotype tests from vcf file(s)
+                else if (vcfRecord.is_snv() or vcfRecord.is_ref_site())
                 {
-                    if (vcfRecord.is_indel())
-                    {
-                        static const unsigned sample_no(0);
-                        static const bool is_forced_output(true);
-                        process_candidate_indel(opt.max_indel_size, vcfRecord, sppr, sample_no, is_forced_output);
-                    }
-                    else if (vcfRecord.is_snv() or vcfRecord.is_ref_site())
-                    {
-                        sppr.insert_forced_output_pos(vcfRecord.pos - 1);
-                    }
-                    else
-                    {
-                        std::ostringstream oss;
-                        oss << "ERROR: forcedGT vcf variant record cannot be categorized as SNV or indel:\n";
-                        streamData.getCurrentVcfStreamer().report_state(oss);
-                        BOOST_THROW_EXCEPTION(LogicException(oss.str()));
-                    }
+                    sppr->insert_forced_output_pos(vcfRecord.pos - 1);
                 }
-                else if (INPUT_TYPE::NOISE_VARIANTS == currentIndex)
+                else
                 {
-                    if (vcfRecord.is_snv())
-                    {
-                        SiteNoise sn;
-                        set_noise_from_vcf(vcfRecord.line, sn);
-                        sppr.insert_noise_pos(vcfRecord.pos - 1, sn);
-                    }
+                    std::ostringstream oss;
+                    oss << "ERROR: forcedGT vcf variant record cannot be categorized as SNV or indel:\n";
+                    streamData.getCurrentVcfStreamer().report_state(oss);
+                    BOOST_THROW_EXCEPTION(LogicException(oss.str()));
                 }
-                else
+            }
+            else if (INPUT_TYPE::NOISE_VARIANTS == currentIndex)
+            {
+                if (vcfRecord.is_snv())
                 {
-                    assert(false && "Unexpected hts index");
+                    SiteNoise sn;
+                    set_noise_from_vcf(vcfRecord.line, sn);
+                    sppr->insert_noise_pos(vcfRecord.pos - 1, sn);
                 }
             }
             else
             {
-                assert(false && "Invalid input condition");
+                assert(false && "Unexpected hts index");
             }
         }
+        else
+        {
+            assert(false && "Invalid input condition");
+        }
+    }
+
+    insertTrackNoise(rinfo.streamerRegionRange.end_pos());
+}
+
+}
+
+
+
+void
+strelka_run(
+    const prog_info& pinfo,
+    const strelka_options& opt)
+{
+    // ensure that this object is created first for runtime benchmark
+    RunStatsManager segmentStatMan(opt.segmentStatsFilename);
+
+    opt.validate();
+
+    const strelka_deriv_options dopt(opt);
+
+    const unsigned workerCount(opt.workerThreadCount);
+    const bool isRegionBuffer(workerCount > 1);
+
+    std::unique_ptr<SiteNoiseTrack> noiseTrack;
+    if (not opt.noise_track_filename.empty())
+    {
+        noiseTrack.reset(new SiteNoiseTrack(opt.noise_track_filename));
+    }
+
+    std::vector<std::unique_ptr<StrelkaRegionWorker>> workers;
+    for (unsigned workerIndex(0); workerIndex < workerCount; ++workerIndex)
+    {
+        workers.emplace_back(new StrelkaRegionWorker(pinfo, opt, dopt, isRegionBuffer, noiseTrack.get()));
+    }
+
+    const StrelkaRegionWorker& referenceWorker(*workers.front());
+    const bam_hdr_t& referenceHeader(referenceWorker.bamHeaders.front());
+    const bam_header_info referenceHeaderInfo(referenceHeader);
+
+    // parse and sanity check regions
+    const auto& referenceAlignmentFilename(opt.alignFileOpt.alignmentFilename.front());
+    std::vector<AnalysisRegionInfo> regionInfo;
+    getStrelkaAnalysisRegions(opt, referenceAlignmentFilename, referenceHeaderInfo, regionInfo);
+
+    if (not isRegionBuffer)
+    {
+        StrelkaRegionWorker& worker(*workers.front());
+        for (const auto& rinfo : regionInfo)
+        {
+            worker.processRegion(rinfo);
+        }
+        worker.sppr->reset();
+        segmentStatMan.addReadRealignmentStats(worker.sppr->getReadRealignmentStats());
+        return;
+    }
+
+    // in threaded mode, the workers buffer the output of each region, which is written to the primary
+    // output streams in region order:
+    const strelka_streams primaryStreams(opt, dopt, pinfo, referenceHeader, referenceWorker.ssi);
+
+    auto runRegion = [&](const unsigned workerIndex, const unsigned regionIndex, TaskOutput& regionOutput)
+    {
+        StrelkaRegionWorker& worker(*workers[workerIndex]);
+        worker.processRegion(regionInfo[regionIndex]);
+        worker.sppr->reset();
+        worker.streams->transferRegionOutput(regionOutput);
+    };
+
+    auto writeRegion = [&](const TaskOutput& regionOutput)
+    {
+        primaryStreams.writeRegionOutput(regionOutput);
+    };
+
+    runOrderedTasks(workerCount, regionInfo.size(), runRegion, writeRegion);
+
+    for (const auto& worker : workers)
+    {
+        segmentStatMan.addReadRealignmentStats(worker->sppr->getReadRealignmentStats());
     }
-    sppr.reset();
 }
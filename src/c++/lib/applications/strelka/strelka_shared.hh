@@ -135,6 +135,9 @@ struct strelka_options : public starling_base_options
     // positions/indels in vcf are used to estimate low-frequency sequencing noise:
     std::vector<std::string> noise_vcf;
 
+    // binary site noise track used in place of noise_vcf:
+    std::string noise_track_filename;
+
     somatic_filter_options sfilter;
 
     /// somatic scoring models:
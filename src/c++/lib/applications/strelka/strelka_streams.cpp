@@ -90,19 +90,23 @@ strelka_streams(
     const strelka_deriv_options& dopt,
     const prog_info& pinfo,
     const bam_hdr_t& header,
-    const StrelkaSampleSetSummary& ssi)
-    : base_t(opt,pinfo,ssi.size())
+    const StrelkaSampleSetSummary& ssi,
+    const bool isRegionBuffer)
+    : base_t(opt,pinfo,ssi.size(),isRegionBuffer)
 {
+    const bool isWriteHeader((not opt.sfilter.is_skip_header) && (not isRegionBuffer));
+
     {
         using namespace STRELKA_SAMPLE_TYPE;
+        assert(not (isRegionBuffer && (opt.is_realigned_read_file() || opt.is_tumor_realigned_read())));
         if (opt.is_realigned_read_file())
         {
-            _realign_bam_ptr[NORMAL] = initialize_realign_bam(opt.realignedReadFilenamePrefix,header);
+            _realign_bam_ptr[NORMAL] = initialize_realign_bam(opt, opt.realignedReadFilenamePrefix,header);
         }
 
         if (opt.is_tumor_realigned_read())
         {
-            _realign_bam_ptr[TUMOR] = initialize_realign_bam(opt.tumor_realigned_read_filename,header);
+            _realign_bam_ptr[TUMOR] = initialize_realign_bam(opt, opt.tumor_realigned_read_filename,header);
         }
     }
 
@@ -110,12 +114,10 @@ strelka_streams(
     {
         const char* const cmdline(opt.cmdline.c_str());
 
-        std::ofstream* fosptr(new std::ofstream);
-        _somatic_snv_osptr.reset(fosptr);
-        std::ofstream& fos(*fosptr);
-        open_ofstream(pinfo,opt.somatic_snv_filename,"somatic-snv",fos);
-
-        if (! opt.sfilter.is_skip_header)
+        std::ostream* osptr(initialize_text_stream(pinfo,opt.somatic_snv_filename,"somatic-snv"));
+        _somatic_snv_osptr.reset(osptr);
+        std::ostream& fos(*osptr);
+        if (isWriteHeader)
         {
             write_vcf_audit(opt,pinfo,cmdline,header,fos);
             fos << "##content=strelka somatic snv calls\n"
@@ -223,13 +225,11 @@ strelka_streams(
     {
         const char* const cmdline(opt.cmdline.c_str());
 
-        std::ofstream* fosptr(new std::ofstream);
-        _somatic_indel_osptr.reset(fosptr);
-        std::ofstream& fos(*fosptr);
-
-        open_ofstream(pinfo,opt.somatic_indel_filename,"somatic-indel",fos);
+        std::ostream* osptr(initialize_text_stream(pinfo,opt.somatic_indel_filename,"somatic-indel"));
+        _somatic_indel_osptr.reset(osptr);
+        std::ostream& fos(*osptr);
 
-        if (! opt.sfilter.is_skip_header)
+        if (isWriteHeader)
         {
             write_vcf_audit(opt,pinfo,cmdline,header,fos);
             fos << "##content=strelka somatic indel calls\n"
@@ -344,16 +344,18 @@ strelka_streams(
 
     if (opt.is_somatic_callable())
     {
-        std::ofstream* fosptr(new std::ofstream);
-        _somatic_callable_osptr.reset(fosptr);
-        std::ofstream& fos(*fosptr);
-
-        open_ofstream(pinfo,opt.somatic_callable_filename,"somatic-callable-regions",fos);
+        _somatic_callable_osptr.reset(initialize_text_stream(pinfo,opt.somatic_callable_filename,"somatic-callable-regions"));
+        if (not isRegionBuffer)
+        {
+            _somaticCallableMerge.reset(new RegionProcessor(_somatic_callable_osptr.get()));
+            setBedRangeMerge(_somatic_callable_osptr.get(), *_somaticCallableMerge);
+        }
 
         // post samtools 1.0 tabix doesn't handle header information anymore, so take this out entirely:
 #if 0
-        if (! opt.sfilter.is_skip_header)
+        if (isWriteHeader)
         {
+            std::ostream& fos(*_somatic_callable_osptr);
             fos << "track name=\"StrelkaCallableSites\"\t"
                 << "description=\"Sites with sufficient information to call somatic alleles at 10% frequency or greater.\"\n";
         }
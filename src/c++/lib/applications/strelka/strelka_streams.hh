@@ -39,7 +39,8 @@ struct strelka_streams : public starling_streams_base
         const strelka_deriv_options& dopt,
         const prog_info& pinfo,
         const bam_hdr_t& bam_header,
-        const StrelkaSampleSetSummary& ssi);
+        const StrelkaSampleSetSummary& ssi,
+        const bool isRegionBuffer = false);
 
     std::ostream*
     somatic_snv_osptr() const
@@ -63,4 +64,8 @@ private:
     std::unique_ptr<std::ostream> _somatic_snv_osptr;
     std::unique_ptr<std::ostream> _somatic_indel_osptr;
     std::unique_ptr<std::ostream> _somatic_callable_osptr;
+
+    /// merges callable ranges across regions when region output is appended, declared after the callable stream
+    /// so that any pending range is written before the stream is closed
+    std::unique_ptr<RegionProcessor> _somaticCallableMerge;
 };
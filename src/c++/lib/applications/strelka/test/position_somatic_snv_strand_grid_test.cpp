@@ -0,0 +1,210 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#include "boost/test/unit_test.hpp"
+
+#include "position_somatic_snv_strand_grid.hh"
+#include "position_somatic_snv_strand_grid_lhood_cached.hh"
+#include "qscore_calculator.hh"
+
+#include "blt_util/prob_util.hh"
+
+#include <algorithm>
+#include <cmath>
+
+
+BOOST_AUTO_TEST_SUITE( position_somatic_snv_strand_grid_test )
+
+
+/// calls in a synthetic pileup at ref base 0, qscores cycle over a fixed range
+///
+/// the first altCount calls carry alt base 1, the first fwdAltCount of these on the forward strand, the next
+/// errorCount calls carry other non-reference bases, and the remaining calls are reference
+struct PileupSpec
+{
+    unsigned depth;
+    unsigned altCount;
+    unsigned fwdAltCount;
+    unsigned errorCount;
+};
+
+
+
+static
+void
+getPileup(
+    const PileupSpec& spec,
+    snp_pos_info& pi)
+{
+    pi.clear();
+    pi.set_ref_base(id_to_base(0));
+    for (unsigned callIndex(0); callIndex < spec.depth; ++callIndex)
+    {
+        const unsigned qscore(10 + ((callIndex*7) % 31));
+        unsigned baseId(0);
+        bool isFwdStrand((callIndex % 2) == 0);
+        if (callIndex < spec.altCount)
+        {
+            baseId = 1;
+            isFwdStrand = (callIndex < spec.fwdAltCount);
+        }
+        else if (callIndex < (spec.altCount+spec.errorCount))
+        {
+            baseId = 2 + (callIndex % 2);
+        }
+        pi.calls.push_back(base_call(baseId,qscore,isFwdStrand,0,0,false,false,false,false,false));
+    }
+}
+
+
+
+/// get the full set of grid likelihoods used by the somatic snv caller for one sample
+static
+void
+getGridLhood(
+    const snp_pos_info& pi,
+    blt_float_t* lhood)
+{
+    static const unsigned ref_gt(0);
+    het_ratio_cache<2> hrcache;
+
+    get_diploid_gt_lhood_cached_simple(pi, ref_gt, lhood);
+    get_diploid_het_grid_lhood_cached(pi, ref_gt, DIGT_GRID::HET_RES, lhood+SOMATIC_DIGT::SIZE);
+    for (unsigned i(0); i<DIGT_GRID::HET_RES; ++i)
+    {
+        const blt_float_t het_ratio((i+1)*DIGT_GRID::RATIO_INCREMENT);
+        get_strand_ratio_lhood_spi(pi, ref_gt, het_ratio, i, hrcache, lhood+DIGT_GRID::PRESTRAND_SIZE+i);
+    }
+}
+
+
+
+static
+void
+getResultSet(
+    const blt_float_t* normal_lhood,
+    const blt_float_t* tumor_lhood,
+    const bool isComputeNonSomatic,
+    snv_result_set& rs)
+{
+    // parameters follow the strelka defaults:
+    const blt_float_t contam_tolerance(0.15);
+    const blt_float_t ln_sse_rate(std::log(0.000005*0.5));
+    const blt_float_t ln_csse_rate(log1p_switch(-0.000005));
+    const blt_float_t ln_som_match(log1p_switch(-0.000001));
+    const blt_float_t ln_som_mismatch(std::log(0.000001));
+    blt_float_t bare_lnprior[SOMATIC_DIGT::SIZE];
+    calculate_bare_lnprior(0.001, bare_lnprior);
+
+    calculate_result_set_grid(isComputeNonSomatic, contam_tolerance, ln_sse_rate, ln_csse_rate,
+                              normal_lhood, tumor_lhood, bare_lnprior, ln_som_match, ln_som_mismatch, false, rs);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_result_set_grid_golden )
+{
+    struct GoldenCase
+    {
+        PileupSpec normal;
+        PileupSpec tumor;
+        bool isComputeNonSomatic;
+        int qphred;
+        unsigned max_gt;
+        unsigned ntype;
+        int from_ntype_qphred;
+        int nonsomatic_qphred;
+        double strandBias;
+    };
+
+    // expected values were captured from the full grid scan which preceded the current implementation:
+    static const GoldenCase goldenCases[] =
+    {
+        // germline het:
+        {{40,20,10,0}, {40,20,10,0}, false, 0, 4, 2, 0, 0, 0},
+        {{40,20,10,0}, {40,20,10,0}, true, 0, 4, 2, 0, 3070, 0},
+        // somatic:
+        {{40,0,0,0}, {40,12,6,0}, false, 35, 1, 0, 35, 0, 0},
+        {{40,0,0,0}, {40,12,6,0}, true, 35, 1, 0, 35, 0, 0},
+        // low frequency somatic with errors:
+        {{60,0,0,1}, {200,10,5,2}, false, 5, 1, 0, 5, 0, 0},
+        {{60,0,0,1}, {200,10,5,2}, true, 5, 1, 0, 5, 0, 0},
+        // strand-biased somatic:
+        {{30,0,0,0}, {30,10,10,0}, false, 29, 1, 0, 29, 0, 4.39538002},
+        {{30,0,0,0}, {30,10,10,0}, true, 29, 1, 0, 29, 0, 4.39538002},
+        // noise:
+        {{50,1,1,0}, {50,2,1,1}, false, 0, 0, 0, 0, 0, 0},
+        {{50,1,1,0}, {50,2,1,1}, true, 0, 0, 0, 0, 0, 0},
+        // germline hom:
+        {{20,20,10,0}, {20,20,10,0}, false, 0, 2, 1, 0, 0, 0},
+        {{20,20,10,0}, {20,20,10,0}, true, 0, 2, 1, 0, 11, 0},
+        // germline het with tumor loss of heterozygosity:
+        {{30,15,8,0}, {30,29,15,0}, false, 2, 4, 2, 2, 0, 0},
+        {{30,15,8,0}, {30,29,15,0}, true, 2, 4, 2, 2, 3070, 0},
+        // single read:
+        {{1,0,0,0}, {1,1,1,0}, false, 0, 0, 0, 0, 0, 0},
+        {{1,0,0,0}, {1,1,1,0}, true, 0, 0, 0, 0, 2, 0},
+    };
+
+    snp_pos_info normal_pi;
+    snp_pos_info tumor_pi;
+    blt_float_t normal_lhood[DIGT_GRID::SIZE];
+    blt_float_t tumor_lhood[DIGT_GRID::SIZE];
+
+    for (const GoldenCase& golden : goldenCases)
+    {
+        getPileup(golden.normal, normal_pi);
+        getPileup(golden.tumor, tumor_pi);
+        getGridLhood(normal_pi, normal_lhood);
+        getGridLhood(tumor_pi, tumor_lhood);
+
+        snv_result_set rs;
+        getResultSet(normal_lhood, tumor_lhood, golden.isComputeNonSomatic, rs);
+
+        BOOST_REQUIRE_EQUAL(rs.qphred, golden.qphred);
+        BOOST_REQUIRE_EQUAL(rs.max_gt, golden.max_gt);
+        BOOST_REQUIRE_EQUAL(rs.ntype, golden.ntype);
+        BOOST_REQUIRE_EQUAL(rs.from_ntype_qphred, golden.from_ntype_qphred);
+        BOOST_REQUIRE_EQUAL(rs.nonsomatic_qphred, golden.nonsomatic_qphred);
+        BOOST_REQUIRE_SMALL(rs.strandBias-golden.strandBias, 1e-5);
+    }
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_result_set_grid_flat_lhood )
+{
+    blt_float_t normal_lhood[DIGT_GRID::SIZE];
+    blt_float_t tumor_lhood[DIGT_GRID::SIZE];
+    std::fill(normal_lhood, normal_lhood+DIGT_GRID::SIZE, 0);
+    std::fill(tumor_lhood, tumor_lhood+DIGT_GRID::SIZE, 0);
+
+    // with no information in the likelihoods, the result is determined by the priors alone:
+    snv_result_set rs;
+    getResultSet(normal_lhood, tumor_lhood, true, rs);
+    BOOST_REQUIRE_EQUAL(rs.qphred, 0);
+    BOOST_REQUIRE_EQUAL(rs.max_gt, 0u);
+    BOOST_REQUIRE_EQUAL(rs.ntype, 0u);
+    BOOST_REQUIRE_EQUAL(rs.from_ntype_qphred, 0);
+    BOOST_REQUIRE_EQUAL(rs.nonsomatic_qphred, 3);
+    BOOST_REQUIRE_EQUAL(rs.strandBias, 0);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
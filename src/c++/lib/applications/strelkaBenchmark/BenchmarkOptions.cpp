@@ -0,0 +1,126 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "BenchmarkOptions.hh"
+#include "blt_util/log.hh"
+#include "common/ProgramUtil.hh"
+
+#include "boost/filesystem.hpp"
+#include "boost/program_options.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+
+
+static
+void
+usage(
+    std::ostream& os,
+    const illumina::Program& prog,
+    const boost::program_options::options_description& visible,
+    const char* msg = nullptr)
+{
+    usage(os, prog, visible, "Run a Strelka component benchmark", "", msg);
+}
+
+
+
+void
+parseBenchmarkOptions(
+    const illumina::Program& prog,
+    int argc, char* argv[],
+    const std::vector<std::string>& benchmarkNames,
+    BenchmarkOptions& opt)
+{
+    std::ostringstream benchmarkHelp;
+    benchmarkHelp << "name of the benchmark to run (required), one of:";
+    for (const auto& benchmarkName : benchmarkNames)
+    {
+        benchmarkHelp << " " << benchmarkName;
+    }
+
+    namespace po = boost::program_options;
+    po::options_description req("configuration");
+    req.add_options()
+    ("benchmark", po::value(&opt.benchmarkName),
+     benchmarkHelp.str().c_str())
+    ("align-file", po::value(&opt.alignmentFilename),
+     "alignment file in BAM or CRAM format, used by benchmarks which replay read data")
+    ("vcf-file", po::value(&opt.vcfFilename),
+     "tabix indexed vcf file, used by benchmarks which replay variant records")
+    ("region", po::value(&opt.region),
+     "restrict replayed read or variant data to this region")
+    ("repeat", po::value(&opt.repeatCount)->default_value(opt.repeatCount),
+     "number of times to repeat the benchmark workload");
+
+    po::options_description help("help");
+    help.add_options()
+    ("help,h","print this message");
+
+    po::options_description visible("options");
+    visible.add(req).add(help);
+
+    bool po_parse_fail(false);
+    po::variables_map vm;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, visible,
+                                         po::command_line_style::unix_style ^ po::command_line_style::allow_short), vm);
+        po::notify(vm);
+    }
+    catch (const boost::program_options::error& e)
+    {
+        log_os << "\nERROR: Exception thrown by option parser: " << e.what() << "\n";
+        po_parse_fail=true;
+    }
+
+    if ((argc<=1) || (vm.count("help")) || po_parse_fail)
+    {
+        usage(log_os,prog,visible);
+    }
+
+    if (std::find(benchmarkNames.begin(), benchmarkNames.end(), opt.benchmarkName) == benchmarkNames.end())
+    {
+        std::ostringstream oss;
+        oss << "Unknown benchmark name: '" << opt.benchmarkName << "'";
+        usage(log_os,prog,visible,oss.str().c_str());
+    }
+
+    if ((! opt.alignmentFilename.empty()) && (! boost::filesystem::exists(opt.alignmentFilename)))
+    {
+        std::ostringstream oss;
+        oss << "Alignment file does not exist: '" << opt.alignmentFilename << "'";
+        usage(log_os,prog,visible,oss.str().c_str());
+    }
+
+    if ((! opt.vcfFilename.empty()) && (! boost::filesystem::exists(opt.vcfFilename)))
+    {
+        std::ostringstream oss;
+        oss << "Vcf file does not exist: '" << opt.vcfFilename << "'";
+        usage(log_os,prog,visible,oss.str().c_str());
+    }
+
+    if (opt.repeatCount < 1)
+    {
+        usage(log_os,prog,visible,"Repeat count must be at least 1");
+    }
+}
@@ -0,0 +1,54 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#pragma once
+
+#include "common/Program.hh"
+
+#include <string>
+#include <vector>
+
+
+struct BenchmarkOptions
+{
+    /// name of the benchmark to run
+    std::string benchmarkName;
+
+    /// alignment file input for benchmarks which replay read data
+    std::string alignmentFilename;
+
+    /// tabix indexed vcf input for benchmarks which replay variant records
+    std::string vcfFilename;
+
+    /// optional region of the alignment or vcf file to replay
+    std::string region;
+
+    /// number of times the benchmark workload is repeated
+    unsigned repeatCount = 1;
+};
+
+
+/// \param[in] benchmarkNames all valid benchmark names
+void
+parseBenchmarkOptions(
+    const illumina::Program& prog,
+    int argc, char* argv[],
+    const std::vector<std::string>& benchmarkNames,
+    BenchmarkOptions& opt);
@@ -0,0 +1,62 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#include "BenchmarkReads.hh"
+
+#include "common/Exceptions.hh"
+#include "htsapi/bam_streamer.hh"
+#include "starling_common/alignment_util.hh"
+
+#include <sstream>
+
+
+
+void
+loadBenchmarkReads(
+    const BenchmarkOptions& opt,
+    std::vector<bam_record>& reads)
+{
+    using namespace illumina::common;
+
+    if (opt.alignmentFilename.empty())
+    {
+        std::ostringstream oss;
+        oss << "The " << opt.benchmarkName << " benchmark requires an alignment file";
+        BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+    }
+
+    bam_streamer readStream(opt.alignmentFilename.c_str(), (opt.region.empty() ? nullptr : opt.region.c_str()));
+
+    alignment al;
+    while (readStream.next())
+    {
+        const bam_record& read(*(readStream.get_record_ptr()));
+        if (read.is_unmapped()) continue;
+        getAlignmentFromBamRecord(read, al);
+        if (al.empty() || ALIGNPATH::is_apath_floating(al.path)) continue;
+        reads.push_back(read);
+    }
+
+    if (reads.empty())
+    {
+        std::ostringstream oss;
+        oss << "No mapped reads found in " << opt.benchmarkName << " benchmark input";
+        BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+    }
+}
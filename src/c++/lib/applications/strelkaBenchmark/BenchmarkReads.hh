@@ -0,0 +1,35 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#pragma once
+
+#include "BenchmarkOptions.hh"
+
+#include "htsapi/bam_record.hh"
+
+#include <vector>
+
+
+/// load all mapped reads with a usable alignment from the benchmark alignment file
+///
+/// an exception is thrown if the alignment file is not specified or no usable reads are found
+void
+loadBenchmarkReads(
+    const BenchmarkOptions& opt,
+    std::vector<bam_record>& reads);
@@ -0,0 +1,109 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#include "GenotypeLhoodBenchmark.hh"
+
+#include "blt_util/digt.hh"
+#include "blt_util/time_util.hh"
+#include "strelka_common/position_snp_call_grid_lhood_cached.hh"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+
+
+/// simulate a het pileup with qscores spread over the typical unbinned range
+static
+void
+getSimulatedPileup(
+    const unsigned depth,
+    std::mt19937& rng,
+    snp_pos_info& pi)
+{
+    std::uniform_int_distribution<unsigned> qscoreDist(2,40);
+    std::uniform_int_distribution<unsigned> baseDist(0,N_BASE-1);
+    std::uniform_real_distribution<double> fracDist(0,1);
+
+    pi.clear();
+    pi.set_ref_base(id_to_base(0));
+    for (unsigned callIndex(0); callIndex < depth; ++callIndex)
+    {
+        const unsigned qscore(qscoreDist(rng));
+        unsigned baseId((fracDist(rng) < 0.5) ? 1 : 0);
+        if (fracDist(rng) < qphred_to_error_prob(qscore)) baseId = baseDist(rng);
+        const bool isFwdStrand(fracDist(rng) < 0.5);
+        pi.calls.push_back(base_call(baseId,qscore,isFwdStrand,0,0,false,false,false,false,false));
+    }
+}
+
+
+
+void
+runGenotypeLhoodBenchmark(
+    const BenchmarkOptions& opt,
+    std::ostream& os)
+{
+    // number of base calls evaluated per kernel at each depth (times the repeat count):
+    static const unsigned callsPerDepth(2000000);
+    static const unsigned hetResolution(9);
+    static const unsigned depths[] = { 10, 30, 100, 300, 1000, 3000, 10000 };
+
+    blt_options bopt;
+    std::mt19937 rng(1);
+    snp_pos_info pi;
+    blt_float_t lhood[DIGT::SIZE+(hetResolution*2*DIGT::HET_SIZE)];
+
+    // accumulate a result value so that the kernel calls can't be optimized out:
+    double lhoodSum(0);
+
+    os << "benchmark\tgenotype-lhood\n";
+    os << "depth\tgtLhoodNanosecondsPerPileup\thetGridLhoodNanosecondsPerPileup\n";
+    for (const unsigned depth : depths)
+    {
+        getSimulatedPileup(depth, rng, pi);
+        const unsigned iterationCount(std::max(1u,(callsPerDepth/depth))*opt.repeatCount);
+
+        TimeTracker gtTimer;
+        gtTimer.resume();
+        for (unsigned iterationIndex(0); iterationIndex < iterationCount; ++iterationIndex)
+        {
+            get_diploid_gt_lhood_cached(bopt, pi, lhood);
+            lhoodSum += lhood[0];
+        }
+        gtTimer.stop();
+
+        TimeTracker gridTimer;
+        gridTimer.resume();
+        for (unsigned iterationIndex(0); iterationIndex < iterationCount; ++iterationIndex)
+        {
+            get_diploid_het_grid_lhood_cached(pi, hetResolution, lhood+DIGT::SIZE);
+            lhoodSum += lhood[DIGT::SIZE];
+        }
+        gridTimer.stop();
+
+        os << depth
+           << "\t" << (gtTimer.getWallSeconds()*1e9/iterationCount)
+           << "\t" << (gridTimer.getWallSeconds()*1e9/iterationCount)
+           << "\n";
+    }
+
+    if (lhoodSum == 0) os << "lhoodSum\t" << lhoodSum << "\n";
+}
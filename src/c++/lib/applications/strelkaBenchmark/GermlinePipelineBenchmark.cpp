@@ -0,0 +1,399 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "GermlinePipelineBenchmark.hh"
+#include "AllocationCounter.hh"
+
+#include "applications/starling/GermlineLocusPool.hh"
+#include "applications/starling/gvcf_block_site_record.hh"
+#include "applications/starling/gvcf_compressor.hh"
+#include "applications/starling/indel_overlapper.hh"
+#include "applications/starling/ScoringModelManager.hh"
+#include "applications/starling/variant_prefilter_stage.hh"
+#include "blt_util/RegionTracker.hh"
+#include "blt_util/time_util.hh"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+
+
+
+/// final pipeline stage standing in for gvcf_writer, which optionally returns site loci to a pool
+struct BenchmarkLocusSink : public variant_pipe_stage_base
+{
+    explicit
+    BenchmarkLocusSink(
+        GermlineLocusPool* locusPoolPtr)
+        : _locusPoolPtr(locusPoolPtr)
+    {}
+
+    void
+    process(std::unique_ptr<GermlineSiteLocusInfo> locusPtr) override
+    {
+        siteCount++;
+        if (locusPtr->filters.any()) filteredSiteCount++;
+        if (_locusPoolPtr) _locusPoolPtr->release(std::move(locusPtr));
+    }
+
+    void
+    process(std::unique_ptr<GermlineIndelLocusInfo>) override
+    {}
+
+    uint64_t siteCount = 0;
+    uint64_t filteredSiteCount = 0;
+
+private:
+    GermlineLocusPool* _locusPoolPtr;
+};
+
+
+
+/// final pipeline stage standing in for gvcf_writer, which joins site loci and hom-ref sites into
+/// non-variant blocks following the same rules as the gVCF writer
+struct BenchmarkBlockSink : public variant_pipe_stage_base
+{
+    BenchmarkBlockSink(
+        const gvcf_options& opt,
+        const RegionTracker& nocompressRegions,
+        const unsigned sampleCount,
+        GermlineLocusPool& locusPool)
+        : _compressor(opt, nocompressRegions),
+          _locusPool(locusPool)
+    {
+        for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
+        {
+            _blockPerSample.emplace_back(opt);
+        }
+    }
+
+    void
+    process(std::unique_ptr<GermlineSiteLocusInfo> locusPtr) override
+    {
+        if (not _compressor.is_site_compressible(*locusPtr))
+        {
+            writeAllBlocks();
+            siteRecordCount++;
+        }
+        else
+        {
+            const unsigned sampleCount(_blockPerSample.size());
+            for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
+            {
+                gvcf_block_site_record& block(_blockPerSample[sampleIndex]);
+                if (not block.testCanSiteJoinSampleBlock(*locusPtr, sampleIndex))
+                {
+                    writeBlock(block);
+                }
+                block.joinSiteToSampleBlock(*locusPtr, sampleIndex);
+            }
+        }
+        _locusPool.release(std::move(locusPtr));
+    }
+
+    void
+    process(std::unique_ptr<GermlineIndelLocusInfo>) override
+    {}
+
+    bool
+    tryAddHomRefSite(
+        const GermlineHomRefSiteInfo& site)
+    {
+        if (not _compressor.is_homref_site_compressible(site)) return false;
+
+        const unsigned sampleCount(_blockPerSample.size());
+        for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
+        {
+            if (not _blockPerSample[sampleIndex].testCanHomRefSiteExtendSampleBlock(site, sampleIndex)) return false;
+        }
+        for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
+        {
+            _blockPerSample[sampleIndex].extendSampleBlock(site, sampleIndex);
+        }
+        return true;
+    }
+
+    uint64_t siteRecordCount = 0;
+    uint64_t blockCount = 0;
+
+    /// hash of all block boundaries and depth ranges, used to check that the block output is unchanged
+    uint64_t blockHash = 0;
+
+private:
+    void
+    flush_impl() override
+    {
+        writeAllBlocks();
+    }
+
+    void
+    writeBlock(gvcf_block_site_record& block)
+    {
+        if (block.count <= 0) return;
+        blockCount++;
+        for (const uint64_t value : { static_cast<uint64_t>(block.pos), static_cast<uint64_t>(block.count),
+                                      static_cast<uint64_t>(block.block_dpu.min()),
+                                      static_cast<uint64_t>(block.block_gqx.min())
+                                    })
+        {
+            blockHash = (blockHash * 1000003) ^ value;
+        }
+        block.reset();
+    }
+
+    void
+    writeAllBlocks()
+    {
+        for (auto& block : _blockPerSample)
+        {
+            writeBlock(block);
+        }
+    }
+
+    gvcf_compressor _compressor;
+    GermlineLocusPool& _locusPool;
+    std::vector<gvcf_block_site_record> _blockPerSample;
+};
+
+
+
+/// fill in a site locus as the position processor would for a confident hom-ref call
+static
+void
+setHomRefSiteLocus(
+    const unsigned depth,
+    const int genotypeQuality,
+    GermlineDiploidSiteLocusInfo& locus)
+{
+    const unsigned sampleCount(locus.getSampleCount());
+    for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
+    {
+        LocusSampleInfo& sampleInfo(locus.getSample(sampleIndex));
+        sampleInfo.setPloidy(2);
+        sampleInfo.maxGenotypeIndex.setGenotypeFromAlleleIndices(0,0);
+        sampleInfo.maxGenotypeIndexPolymorphic.setGenotypeFromAlleleIndices(0,0);
+        sampleInfo.genotypeQuality = genotypeQuality;
+        sampleInfo.genotypeQualityPolymorphic = genotypeQuality;
+        sampleInfo.setGqx();
+        sampleInfo.genotypePhredLoghood.getGenotypeLikelihood(0,0) = 0;
+
+        sampleInfo.supportCounts.setAltCount(0);
+        for (unsigned readIndex(0); readIndex < depth; ++readIndex)
+        {
+            sampleInfo.supportCounts.getCounts(readIndex%2).incrementRefAlleleCount();
+        }
+
+        GermlineSiteSampleInfo siteSampleInfo;
+        siteSampleInfo.n_used_calls = depth;
+        siteSampleInfo.mapqTracker.count = depth;
+        locus.setSiteSampleInfo(sampleIndex, siteSampleInfo);
+    }
+}
+
+
+
+/// fill in a hom-ref site with the same values as setHomRefSiteLocus
+static
+void
+setHomRefSite(
+    const pos_t pos,
+    const uint8_t refBaseIndex,
+    const unsigned depth,
+    const int genotypeQuality,
+    GermlineHomRefSiteInfo& site)
+{
+    site.pos = pos;
+    site.refBaseIndex = refBaseIndex;
+    site.isConfidentRefSupport = true;
+    site.filters.clear();
+    for (auto& sample : site.samples)
+    {
+        sample.maxGenotype.setGenotypeFromAlleleIndices(0,0);
+        sample.ploidy = 2;
+        sample.gqx = genotypeQuality;
+        sample.isGqx = true;
+        sample.n_used_calls = depth;
+        sample.n_unused_calls = 0;
+        sample.totalReadDepth = depth;
+        sample.filters.clear();
+    }
+}
+
+
+
+void
+runGermlinePipelineBenchmark(
+    const BenchmarkOptions& opt,
+    std::ostream& os)
+{
+    static const unsigned locusCountPerRepeat(2000000);
+    static const unsigned sampleCount(1);
+
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<unsigned> baseDist(0,3);
+    std::uniform_int_distribution<unsigned> depthDist(20,40);
+
+    reference_contig_segment ref;
+    for (unsigned refIndex(0); refIndex < locusCountPerRepeat; ++refIndex)
+    {
+        ref.seq().push_back("ACGT"[baseDist(rng)]);
+    }
+
+    starling_options starlingOpt;
+    starlingOpt.is_user_genome_size = true;
+    starlingOpt.user_genome_size = ref.seq().size();
+    const starling_deriv_options dopt(starlingOpt);
+    const ScoringModelManager scoringModels(starlingOpt, dopt.gvcf);
+    const RegionTracker targetedRegions;
+
+    os << "benchmark\tgermline-pipeline\n";
+    os << "locusMode\tsites\tfilteredSites\tallocationsPerSite\tnanosecondsPerSite\n";
+    for (const bool isPooled : { false, true })
+    {
+        GermlineLocusPool locusPool(dopt.gvcf, sampleCount);
+        std::shared_ptr<BenchmarkLocusSink> sink(new BenchmarkLocusSink(isPooled ? &locusPool : nullptr));
+        std::shared_ptr<variant_pipe_stage_base> overlapper(new indel_overlapper(scoringModels, ref, sink));
+        variant_prefilter_stage head(scoringModels, false, targetedRegions, overlapper);
+
+        rng.seed(1);
+
+        TimeTracker timer;
+        const uint64_t startAllocationCount(getAllocationCount());
+        timer.resume();
+
+        for (unsigned repeatIndex(0); repeatIndex < opt.repeatCount; ++repeatIndex)
+        {
+            for (pos_t pos(0); pos < static_cast<pos_t>(locusCountPerRepeat); ++pos)
+            {
+                const uint8_t refBaseIndex(base_to_id(ref.get_base(pos)));
+                std::unique_ptr<GermlineDiploidSiteLocusInfo> locusPtr;
+                if (isPooled)
+                {
+                    locusPtr = locusPool.getDiploidSite(pos, refBaseIndex);
+                }
+                else
+                {
+                    locusPtr.reset(new GermlineDiploidSiteLocusInfo(dopt.gvcf, sampleCount, pos, refBaseIndex));
+                }
+                setHomRefSiteLocus(depthDist(rng), 90, *locusPtr);
+                head.process(std::move(locusPtr));
+            }
+            head.flush();
+        }
+
+        timer.stop();
+        const uint64_t allocationCount(getAllocationCount() - startAllocationCount);
+        const double siteCount(std::max(static_cast<uint64_t>(1), sink->siteCount));
+
+        os << (isPooled ? "pooled" : "allocated")
+           << "\t" << sink->siteCount
+           << "\t" << sink->filteredSiteCount
+           << "\t" << (allocationCount/siteCount)
+           << "\t" << (timer.getWallSeconds()*1e9/siteCount)
+           << "\n";
+    }
+}
+
+
+
+void
+runHomRefBlockBenchmark(
+    const BenchmarkOptions& opt,
+    std::ostream& os)
+{
+    static const unsigned locusCountPerRepeat(2000000);
+    static const unsigned sampleCount(1);
+
+    // approximate human genome size, used to project the per-site cost to a WGS run:
+    static const double genomeSize(3.1e9);
+
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<unsigned> baseDist(0,3);
+    std::uniform_int_distribution<unsigned> depthDist(15,45);
+
+    reference_contig_segment ref;
+    for (unsigned refIndex(0); refIndex < locusCountPerRepeat; ++refIndex)
+    {
+        ref.seq().push_back("ACGT"[baseDist(rng)]);
+    }
+
+    starling_options starlingOpt;
+    starlingOpt.is_user_genome_size = true;
+    starlingOpt.user_genome_size = ref.seq().size();
+    const starling_deriv_options dopt(starlingOpt);
+    const ScoringModelManager scoringModels(starlingOpt, dopt.gvcf);
+    const RegionTracker nocompressRegions;
+    const RegionTracker targetedRegions;
+
+    os << "benchmark\thomref-block\n";
+    os << "siteMode\tsites\thomRefSites\tblocks\tblockHash\tnanosecondsPerSite\tprojectedWgsSeconds\n";
+    for (const bool isHomRefFastPath : { false, true })
+    {
+        GermlineLocusPool locusPool(dopt.gvcf, sampleCount);
+        std::shared_ptr<BenchmarkBlockSink> sink(
+            new BenchmarkBlockSink(starlingOpt.gvcf, nocompressRegions, sampleCount, locusPool));
+        std::shared_ptr<variant_pipe_stage_base> overlapper(new indel_overlapper(scoringModels, ref, sink));
+        variant_prefilter_stage head(scoringModels, false, targetedRegions, overlapper);
+        GermlineHomRefSiteInfo site(sampleCount);
+
+        rng.seed(1);
+        uint64_t homRefSiteCount(0);
+
+        TimeTracker timer;
+        timer.resume();
+
+        for (unsigned repeatIndex(0); repeatIndex < opt.repeatCount; ++repeatIndex)
+        {
+            for (pos_t pos(0); pos < static_cast<pos_t>(locusCountPerRepeat); ++pos)
+            {
+                const uint8_t refBaseIndex(base_to_id(ref.get_base(pos)));
+                const unsigned depth(depthDist(rng));
+                const int genotypeQuality(depth*3);
+                if (isHomRefFastPath)
+                {
+                    setHomRefSite(pos, refBaseIndex, depth, genotypeQuality, site);
+                    head.classifyHomRefSite(site);
+                    if (sink->tryAddHomRefSite(site))
+                    {
+                        homRefSiteCount++;
+                        continue;
+                    }
+                }
+                std::unique_ptr<GermlineDiploidSiteLocusInfo> locusPtr(locusPool.getDiploidSite(pos, refBaseIndex));
+                setHomRefSiteLocus(depth, genotypeQuality, *locusPtr);
+                head.process(std::move(locusPtr));
+            }
+            head.flush();
+        }
+
+        timer.stop();
+        const uint64_t siteCount(static_cast<uint64_t>(opt.repeatCount)*locusCountPerRepeat);
+        const double nanosecondsPerSite(timer.getWallSeconds()*1e9/std::max(static_cast<uint64_t>(1), siteCount));
+
+        os << (isHomRefFastPath ? "homref" : "locus")
+           << "\t" << siteCount
+           << "\t" << homRefSiteCount
+           << "\t" << sink->blockCount
+           << "\t" << sink->blockHash
+           << "\t" << nanosecondsPerSite
+           << "\t" << (nanosecondsPerSite*genomeSize/1e9)
+           << "\n";
+    }
+}
@@ -0,0 +1,40 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#pragma once
+
+#include "BenchmarkOptions.hh"
+
+#include <iosfwd>
+
+
+/// time the germline variant pipeline over synthetic hom-ref site loci, with newly allocated and recycled loci
+void
+runGermlinePipelineBenchmark(
+    const BenchmarkOptions& opt,
+    std::ostream& os);
+
+
+/// time gVCF non-variant block accumulation over synthetic hom-ref sites, with each site built as a full
+/// site locus and with the compact hom-ref site fast path
+void
+runHomRefBlockBenchmark(
+    const BenchmarkOptions& opt,
+    std::ostream& os);
@@ -0,0 +1,116 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "GlobalAlignerBenchmark.hh"
+
+#include "alignment/GlobalAligner.hh"
+#include "blt_util/time_util.hh"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+
+
+/// simulate a reference segment in a short tandem repeat, and a haplotype with one repeat unit inserted
+/// and one SNV
+static
+void
+getSimulatedHaplotype(
+    const unsigned refSize,
+    std::mt19937& rng,
+    std::string& ref,
+    std::string& haplotype)
+{
+    static const char bases[] = "ACGT";
+    static const unsigned repeatUnitSize(3);
+    std::uniform_int_distribution<unsigned> baseDist(0,3);
+
+    ref.clear();
+    for (unsigned refIndex(0); refIndex < refSize; ++refIndex)
+    {
+        ref.push_back((refIndex < repeatUnitSize) ? bases[baseDist(rng)] : ref[refIndex-repeatUnitSize]);
+    }
+
+    const unsigned midPos(refSize/2);
+    haplotype = ref.substr(0,midPos) + ref.substr(midPos-repeatUnitSize,repeatUnitSize) + ref.substr(midPos);
+    const unsigned snvPos(refSize/4);
+    haplotype[snvPos] = bases[(std::find(bases,bases+4,haplotype[snvPos])-bases+1)%4];
+}
+
+
+
+void
+runGlobalAlignerBenchmark(
+    const BenchmarkOptions& opt,
+    std::ostream& os)
+{
+    // alignment matrix cells evaluated by the full aligner at each size (times the repeat count):
+    static const unsigned cellsPerSize(20000000);
+    static const unsigned refSizes[] = { 30, 100, 300, 1000 };
+    static const unsigned maxIndelSize(49);
+
+    // scores match those used for active region haplotype alignment:
+    const AlignmentScores<int> scores(1, -4, -5, -1, -100, -5, true, true);
+    const GlobalAligner<int> aligner(scores);
+
+    std::mt19937 rng(1);
+    std::string ref;
+    std::string haplotype;
+    AlignmentResult<int> result;
+
+    // accumulate a result value so that the alignment calls can't be optimized out:
+    long scoreSum(0);
+
+    os << "benchmark\tglobal-aligner\n";
+    os << "refSize\tfullAlignMicrosecondsPerHaplotype\tbandedAlignMicrosecondsPerHaplotype\n";
+    for (const unsigned refSize : refSizes)
+    {
+        getSimulatedHaplotype(refSize, rng, ref, haplotype);
+        const unsigned iterationCount(std::max(1u,(cellsPerSize/(refSize*refSize)))*opt.repeatCount);
+
+        TimeTracker fullTimer;
+        fullTimer.resume();
+        for (unsigned iterationIndex(0); iterationIndex < iterationCount; ++iterationIndex)
+        {
+            aligner.align(haplotype.begin(), haplotype.end(), ref.begin(), ref.end(), result);
+            scoreSum += result.score;
+        }
+        fullTimer.stop();
+
+        TimeTracker bandedTimer;
+        bandedTimer.resume();
+        for (unsigned iterationIndex(0); iterationIndex < iterationCount; ++iterationIndex)
+        {
+            aligner.alignBanded(haplotype.begin(), haplotype.end(), ref.begin(), ref.end(), maxIndelSize, result);
+            scoreSum += result.score;
+        }
+        bandedTimer.stop();
+
+        os << refSize
+           << "\t" << (fullTimer.getWallSeconds()*1e6/iterationCount)
+           << "\t" << (bandedTimer.getWallSeconds()*1e6/iterationCount)
+           << "\n";
+    }
+
+    if (scoreSum == 0) os << "scoreSum\t" << scoreSum << "\n";
+}
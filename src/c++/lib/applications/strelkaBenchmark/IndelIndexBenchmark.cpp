@@ -0,0 +1,215 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#include "IndelIndexBenchmark.hh"
+
+#include "blt_util/time_util.hh"
+#include "starling_common/IndelPositionIndex.hh"
+
+#include <cassert>
+#include <map>
+#include <random>
+#include <vector>
+
+
+
+namespace
+{
+
+typedef std::map<IndelKey,unsigned> IndelMap;
+typedef IndelPositionIndex<unsigned> IndelIndex;
+
+
+IndelMap::const_iterator
+positionLowerBound(
+    const IndelMap& indels,
+    const pos_t pos)
+{
+    return indels.lower_bound(IndelKey(pos));
+}
+
+IndelIndex::const_iterator
+positionLowerBound(
+    const IndelIndex& indels,
+    const pos_t pos)
+{
+    return indels.positionLowerBound(pos);
+}
+
+void
+erasePosition(
+    IndelMap& indels,
+    const pos_t pos)
+{
+    indels.erase(indels.lower_bound(IndelKey(pos)), indels.lower_bound(IndelKey(pos+1)));
+}
+
+void
+erasePosition(
+    IndelIndex& indels,
+    const pos_t pos)
+{
+    indels.erasePosition(pos);
+}
+
+
+
+/// synthetic indel buffer workload, with indels for each position generated ahead of the reads which query them
+struct IndelWorkload
+{
+    IndelWorkload(
+        const unsigned indelsPerPos,
+        const pos_t locusSize,
+        std::mt19937& rng)
+    {
+        static const char* insertSequences[] = { "A", "AC", "ACT", "ACTG", "ACTGA", "ACTGAC" };
+        std::uniform_int_distribution<unsigned> lengthDist(1,12);
+        std::uniform_int_distribution<unsigned> typeDist(0,1);
+        std::uniform_int_distribution<unsigned> insertDist(0,5);
+        std::uniform_int_distribution<pos_t> readOffsetDist(0,readLength-1);
+
+        for (pos_t pos(0); pos < locusSize; ++pos)
+        {
+            for (unsigned indelIndex(0); indelIndex < indelsPerPos; ++indelIndex)
+            {
+                if (typeDist(rng) == 0)
+                {
+                    keys.emplace_back(pos, INDEL::INDEL, lengthDist(rng));
+                }
+                else
+                {
+                    keys.emplace_back(pos, INDEL::INDEL, 0, insertSequences[insertDist(rng)]);
+                }
+            }
+            for (unsigned readIndex(0); readIndex < readsPerPos; ++readIndex)
+            {
+                readBeginPos.push_back(pos - readOffsetDist(rng));
+            }
+        }
+    }
+
+    static const pos_t readLength = 150;
+    static const pos_t bufferSize = 300;
+    static const unsigned readsPerPos = 4;
+    static const pos_t maxIndelSize = 50;
+
+    std::vector<IndelKey> keys;
+    std::vector<pos_t> readBeginPos;
+};
+
+
+
+/// \return a checksum over the range query results so that the queries can't be optimized out
+template <typename IndelContainer>
+unsigned
+runWorkload(
+    const IndelWorkload& workload,
+    IndelContainer& indels,
+    TimeTracker& timer)
+{
+    unsigned checksum(0);
+    const unsigned indelsPerPos(workload.keys.size()/(workload.readBeginPos.size()/IndelWorkload::readsPerPos));
+
+    timer.resume();
+    auto keyIter(workload.keys.begin());
+    auto readIter(workload.readBeginPos.begin());
+    pos_t pos(0);
+    for (; keyIter != workload.keys.end(); ++pos)
+    {
+        // add indels at the buffer head:
+        for (unsigned indelIndex(0); indelIndex < indelsPerPos; ++indelIndex, ++keyIter)
+        {
+            indels.insert(std::make_pair(*keyIter, pos));
+        }
+
+        // find candidate indels for each read ending at the buffer head:
+        for (unsigned readIndex(0); readIndex < IndelWorkload::readsPerPos; ++readIndex, ++readIter)
+        {
+            const pos_t beginPos(*readIter);
+            const pos_t endPos(pos+1);
+            auto indelIter(positionLowerBound(indels, beginPos-IndelWorkload::maxIndelSize));
+            const auto indelEnd(positionLowerBound(indels, endPos));
+            for (; indelIter != indelEnd; ++indelIter)
+            {
+                if (indelIter->first.right_pos() < beginPos) continue;
+                checksum += indelIter->second;
+            }
+        }
+
+        // clear positions behind the buffer:
+        erasePosition(indels, pos-IndelWorkload::bufferSize);
+    }
+    timer.stop();
+    return checksum;
+}
+
+
+
+/// add a std::pair insert to IndelPositionIndex so that both containers share the workload code
+struct IndelIndexAdapter : public IndelIndex
+{
+    std::pair<iterator,bool>
+    insert(const std::pair<IndelKey,unsigned>& value)
+    {
+        return IndelIndex::insert(value.first, value.second);
+    }
+};
+
+}
+
+
+
+void
+runIndelIndexBenchmark(
+    const BenchmarkOptions& opt,
+    std::ostream& os)
+{
+    static const pos_t locusSize(20000);
+    static const unsigned indelsPerPosList[] = { 1, 4, 16 };
+
+    std::mt19937 rng(1);
+    unsigned checksum(0);
+
+    os << "benchmark\tindel-index\n";
+    os << "indelsPerPos\tmapNanosecondsPerRead\tindexNanosecondsPerRead\n";
+    for (const unsigned indelsPerPos : indelsPerPosList)
+    {
+        const IndelWorkload workload(indelsPerPos, locusSize, rng);
+
+        TimeTracker mapTimer;
+        TimeTracker indexTimer;
+        for (unsigned repeatIndex(0); repeatIndex < opt.repeatCount; ++repeatIndex)
+        {
+            IndelMap indelMap;
+            const unsigned mapChecksum(runWorkload(workload, indelMap, mapTimer));
+            IndelIndexAdapter indelIndex;
+            const unsigned indexChecksum(runWorkload(workload, indelIndex, indexTimer));
+            assert(mapChecksum == indexChecksum);
+            checksum += indexChecksum;
+        }
+
+        const double readCount(static_cast<double>(workload.readBeginPos.size())*opt.repeatCount);
+        os << indelsPerPos
+           << "\t" << (mapTimer.getWallSeconds()*1e9/readCount)
+           << "\t" << (indexTimer.getWallSeconds()*1e9/readCount)
+           << "\n";
+    }
+
+    if (checksum == 0) os << "checksum\t" << checksum << "\n";
+}
@@ -0,0 +1,176 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#include "PileupBenchmark.hh"
+#include "AllocationCounter.hh"
+#include "BenchmarkReads.hh"
+
+#include "blt_util/time_util.hh"
+#include "starling_common/alignment_util.hh"
+#include "starling_common/pos_basecall_buffer.hh"
+
+#include <iostream>
+#include <vector>
+
+
+
+/// build a reference from the first base call observed at each position, so that alt
+/// observations occur at a realistic rate without requiring a reference input
+static
+void
+getPileupReference(
+    const std::vector<bam_record>& reads,
+    reference_contig_segment& ref)
+{
+    alignment al;
+    getAlignmentFromBamRecord(reads.front(), al);
+    const pos_t beginPos(al.pos);
+    ref.set_offset(beginPos);
+
+    std::string& seq(ref.seq());
+    for (const bam_record& read : reads)
+    {
+        getAlignmentFromBamRecord(read, al);
+        const bam_seq readSeq(read.get_bam_read());
+        pos_t refPos(al.pos);
+        pos_t readPos(0);
+        for (const ALIGNPATH::path_segment& ps : al.path)
+        {
+            if (ALIGNPATH::is_segment_align_match(ps.type))
+            {
+                for (unsigned i(0); i < ps.length; ++i)
+                {
+                    const unsigned refIndex(refPos+i-beginPos);
+                    if (refIndex >= seq.size()) seq.resize(refIndex+1, 'N');
+                    if (seq[refIndex] == 'N') seq[refIndex] = readSeq.get_char(readPos+i);
+                }
+            }
+            if (ALIGNPATH::is_segment_type_read_length(ps.type)) readPos += ps.length;
+            if (ALIGNPATH::is_segment_type_ref_length(ps.type)) refPos += ps.length;
+        }
+    }
+}
+
+
+
+/// read back and clear all positions up to and including endPos
+static
+void
+scanPileup(
+    const pos_t endPos,
+    pos_t& scanPos,
+    pos_basecall_buffer& basecallBuffer,
+    uint64_t& scannedCallCount)
+{
+    for (; scanPos <= endPos; ++scanPos)
+    {
+        const snp_pos_info& pi(basecallBuffer.get_pos(scanPos));
+        for (const base_call& bc : pi.calls)
+        {
+            if (not bc.is_call_filter) scannedCallCount++;
+        }
+        basecallBuffer.clear_to_pos(scanPos);
+    }
+}
+
+
+
+void
+runPileupBenchmark(
+    const BenchmarkOptions& opt,
+    std::ostream& os)
+{
+    std::vector<bam_record> reads;
+    loadBenchmarkReads(opt, reads);
+
+    reference_contig_segment ref;
+    getPileupReference(reads, ref);
+
+    pos_basecall_buffer basecallBuffer(ref);
+    alignment al;
+    uint64_t callCount(0);
+    uint64_t scannedCallCount(0);
+
+    TimeTracker timer;
+    const uint64_t startAllocationCount(getAllocationCount());
+    timer.resume();
+
+    for (unsigned repeatIndex(0); repeatIndex < opt.repeatCount; ++repeatIndex)
+    {
+        pos_t scanPos(ref.get_offset());
+        for (const bam_record& read : reads)
+        {
+            getAlignmentFromBamRecord(read, al);
+
+            // positions before the start of this read will not receive any more base calls:
+            scanPileup(al.pos-1, scanPos, basecallBuffer, scannedCallCount);
+
+            const bam_seq readSeq(read.get_bam_read());
+            const uint8_t* qual(read.qual());
+            const uint8_t mapq(read.map_qual());
+            const bool isFwdStrand(read.is_fwd_strand());
+            const unsigned readSize(read.read_size());
+
+            pos_t refPos(al.pos);
+            pos_t readPos(0);
+            for (const ALIGNPATH::path_segment& ps : al.path)
+            {
+                if (ALIGNPATH::is_segment_align_match(ps.type))
+                {
+                    for (unsigned i(0); i < ps.length; ++i)
+                    {
+                        const pos_t pos(refPos+i);
+                        const unsigned readIndex(readPos+i);
+                        const uint8_t callId(base_to_id(readSeq.get_char(readIndex)));
+                        const uint8_t qscore(qual[readIndex]);
+
+                        basecallBuffer.insert_mapq_count(pos, mapq);
+                        basecallBuffer.update_ranksums(ref.get_base(pos), pos, callId, qscore, mapq, readIndex, false);
+                        basecallBuffer.insert_alt_read_pos(pos, callId, readIndex, readSize);
+
+                        const bool isCallFilter(qscore < 17);
+                        const base_call bc(callId, qscore, isFwdStrand, readIndex, readSize, isCallFilter, false,
+                                           false, (i == 0), ((i+1) == ps.length));
+                        basecallBuffer.insert_pos_basecall(pos, true, bc);
+                        callCount++;
+                    }
+                }
+                if (ALIGNPATH::is_segment_type_read_length(ps.type)) readPos += ps.length;
+                if (ALIGNPATH::is_segment_type_ref_length(ps.type)) refPos += ps.length;
+            }
+        }
+        scanPileup(ref.end(), scanPos, basecallBuffer, scannedCallCount);
+        basecallBuffer.clear();
+    }
+
+    timer.stop();
+    const uint64_t allocationCount(getAllocationCount() - startAllocationCount);
+    const double wallSeconds(timer.getWallSeconds());
+
+    os << "benchmark\tpileup\n";
+    os << "baseCalls\t" << callCount << "\n";
+    os << "scannedBaseCalls\t" << scannedCallCount << "\n";
+    os << "allocations\t" << allocationCount << "\n";
+    os << "allocationsPerBaseCall\t" << (static_cast<double>(allocationCount)/callCount) << "\n";
+    os << "wallSeconds\t" << wallSeconds << "\n";
+    if (wallSeconds > 0)
+    {
+        os << "baseCallsPerSecond\t" << (callCount/wallSeconds) << "\n";
+    }
+}
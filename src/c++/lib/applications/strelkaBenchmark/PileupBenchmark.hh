@@ -0,0 +1,35 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#pragma once
+
+#include "BenchmarkOptions.hh"
+
+#include <iosfwd>
+
+
+/// replay the aligned base calls from a set of alignments through pos_basecall_buffer, and report throughput
+/// and heap allocations per base call
+///
+/// base calls are added and scanned in the pattern used by germline calling: each position is read back once
+/// all reads overlapping it have been added, and is then cleared
+void
+runPileupBenchmark(
+    const BenchmarkOptions& opt,
+    std::ostream& os);
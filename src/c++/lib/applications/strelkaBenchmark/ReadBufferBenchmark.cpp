@@ -0,0 +1,91 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "ReadBufferBenchmark.hh"
+#include "AllocationCounter.hh"
+#include "BenchmarkReads.hh"
+
+#include "blt_util/time_util.hh"
+#include "starling_common/alignment_util.hh"
+#include "starling_common/starling_read_buffer.hh"
+
+#include <iostream>
+#include <vector>
+
+
+
+void
+runReadBufferBenchmark(
+    const BenchmarkOptions& opt,
+    std::ostream& os)
+{
+    // approximates the span of positions the variant caller keeps in the read buffer:
+    static const pos_t bufferWindowSize(1000);
+
+    std::vector<bam_record> reads;
+    loadBenchmarkReads(opt, reads);
+
+    starling_read_buffer readBuffer;
+    alignment al;
+    uint64_t readCount(0);
+    uint64_t segmentCount(0);
+
+    TimeTracker timer;
+    const uint64_t startAllocationCount(getAllocationCount());
+    timer.resume();
+
+    for (unsigned repeatIndex(0); repeatIndex < opt.repeatCount; ++repeatIndex)
+    {
+        for (const bam_record& read : reads)
+        {
+            getAlignmentFromBamRecord(read, al);
+
+            // slide the buffer window forward, visiting each position's read segments before it is cleared:
+            const pos_t clearPos(al.pos - bufferWindowSize);
+            read_segment_iter segmentIter(readBuffer.get_pos_read_segment_iter(clearPos));
+            for (read_segment_iter::ret_val segment; true; segmentIter.next())
+            {
+                segment = segmentIter.get_ptr();
+                if (nullptr == segment.first) break;
+                segmentCount++;
+            }
+            readBuffer.clear_to_pos(clearPos);
+
+            readBuffer.add_read_alignment(read, al, MAPLEVEL::TIER1_MAPPED);
+            readCount++;
+        }
+        readBuffer.clear();
+    }
+
+    timer.stop();
+    const uint64_t allocationCount(getAllocationCount() - startAllocationCount);
+    const double wallSeconds(timer.getWallSeconds());
+
+    os << "benchmark\tread-buffer\n";
+    os << "reads\t" << readCount << "\n";
+    os << "visitedSegments\t" << segmentCount << "\n";
+    os << "allocations\t" << allocationCount << "\n";
+    os << "allocationsPerRead\t" << (static_cast<double>(allocationCount)/readCount) << "\n";
+    os << "wallSeconds\t" << wallSeconds << "\n";
+    if (wallSeconds > 0)
+    {
+        os << "readsPerSecond\t" << (readCount/wallSeconds) << "\n";
+    }
+}
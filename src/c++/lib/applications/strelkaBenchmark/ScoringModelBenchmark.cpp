@@ -0,0 +1,222 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#include "ScoringModelBenchmark.hh"
+
+#include "blt_util/time_util.hh"
+#include "calibration/BinaryScoringModelFile.hh"
+#include "calibration/RandomForestModel.hh"
+#include "calibration/VariantScoringModelServer.hh"
+
+#include "boost/filesystem.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+
+
+/// add a random subtree rooted at nodeIndex to a json tree in the scoring model format
+static
+void
+addSimulatedSubtree(
+    const unsigned nodeIndex,
+    const unsigned depth,
+    const unsigned maxDepth,
+    const unsigned featureCount,
+    std::mt19937& rng,
+    unsigned& nodeCount,
+    Json::Value& jtree)
+{
+    std::uniform_int_distribution<unsigned> featureDist(0,featureCount-1);
+    std::uniform_real_distribution<double> fracDist(0,1);
+
+    const std::string key(std::to_string(nodeIndex));
+    Json::Value children(Json::arrayValue);
+    Json::Value votes(Json::arrayValue);
+
+    // trained trees are unbalanced, so terminate some branches early:
+    const bool isLeaf((depth >= maxDepth) || ((depth > 3) && (fracDist(rng) < 0.1)));
+    if (isLeaf)
+    {
+        children.append(-1);
+        children.append(-1);
+        votes.append(std::floor(fracDist(rng)*100)+1);
+        votes.append(std::floor(fracDist(rng)*100)+1);
+    }
+    else
+    {
+        const unsigned leftIndex(nodeCount++);
+        const unsigned rightIndex(nodeCount++);
+        children.append(leftIndex);
+        children.append(rightIndex);
+        votes.append(0);
+        votes.append(0);
+
+        Json::Value decision(Json::arrayValue);
+        decision.append(featureDist(rng));
+        decision.append(fracDist(rng));
+        jtree["decisions"][key] = decision;
+
+        addSimulatedSubtree(leftIndex, depth+1, maxDepth, featureCount, rng, nodeCount, jtree);
+        addSimulatedSubtree(rightIndex, depth+1, maxDepth, featureCount, rng, nodeCount, jtree);
+    }
+    jtree["tree"][key] = children;
+    jtree["node_votes"][key] = votes;
+}
+
+
+
+/// time scoring model server startup from the json and binary forms of the same model file
+static
+void
+reportServerLoadTimes(
+    const Json::Value& modelRoot,
+    const unsigned featureCount,
+    std::ostream& os)
+{
+    namespace bfs = boost::filesystem;
+
+    VariantScoringModelMetadata::featureMap_t featureMap;
+    Json::Value varModel(modelRoot);
+    varModel["Date"] = "benchmark";
+    varModel["ModelType"] = "RandomForest";
+    varModel["FilterCutoff"] = 0.5;
+    for (unsigned featureIndex(0); featureIndex < featureCount; ++featureIndex)
+    {
+        const std::string featureName("F" + std::to_string(featureIndex));
+        featureMap[featureName] = featureIndex;
+        varModel["Features"].append(featureName);
+    }
+    Json::Value fileRoot;
+    fileRoot["CalibrationModels"]["Germline"]["SNP"] = varModel;
+
+    const std::string jsonFilename((bfs::temp_directory_path() / bfs::unique_path()).string());
+    const std::string binaryFilename(jsonFilename + ".bin");
+    {
+        std::ofstream ofs(jsonFilename);
+        ofs << fileRoot;
+    }
+    convertScoringModelFile(jsonFilename, binaryFilename);
+
+    auto getLoadMilliseconds = [&](const std::string& filename)
+    {
+        TimeTracker timer;
+        timer.resume();
+        VariantScoringModelServer server(featureMap, filename, SCORING_CALL_TYPE::GERMLINE, SCORING_VARIANT_TYPE::SNV);
+        timer.stop();
+        return (timer.getWallSeconds()*1e3);
+    };
+
+    os << "jsonModelFileBytes\t" << bfs::file_size(jsonFilename) << "\n";
+    os << "binaryModelFileBytes\t" << bfs::file_size(binaryFilename) << "\n";
+    os << "jsonServerLoadMilliseconds\t" << getLoadMilliseconds(jsonFilename) << "\n";
+    os << "binaryServerLoadMilliseconds\t" << getLoadMilliseconds(binaryFilename) << "\n";
+
+    bfs::remove(jsonFilename);
+    bfs::remove(binaryFilename);
+}
+
+
+
+void
+runScoringModelBenchmark(
+    const BenchmarkOptions& opt,
+    std::ostream& os)
+{
+    // forest dimensions are chosen to resemble the germline empirical variant scoring models:
+    static const unsigned treeCount(100);
+    static const unsigned maxDepth(12);
+    static const unsigned featureCount(30);
+    static const unsigned rowCount(20000);
+    static const unsigned batchSizes[] = { 1, 16, 256, 4096 };
+
+    std::mt19937 rng(1);
+
+    Json::Value root;
+    for (unsigned treeIndex(0); treeIndex < treeCount; ++treeIndex)
+    {
+        unsigned nodeCount(1);
+        Json::Value jtree;
+        addSimulatedSubtree(0, 0, maxDepth, featureCount, rng, nodeCount, jtree);
+        root["Model"].append(jtree);
+    }
+
+    RandomForestModel model;
+    TimeTracker loadTimer;
+    loadTimer.resume();
+    model.Deserialize(featureCount, root);
+    loadTimer.stop();
+
+    std::uniform_real_distribution<double> fracDist(0,1);
+    std::vector<VariantScoringModelBase::featureInput_t> rows(rowCount);
+    for (auto& row : rows)
+    {
+        for (unsigned featureIndex(0); featureIndex < featureCount; ++featureIndex)
+        {
+            row.push_back(fracDist(rng));
+        }
+    }
+
+    // accumulate a result value so that the scoring calls can't be optimized out:
+    double probSum(0);
+
+    os << "benchmark\tscoring-model\n";
+    os << "modelLoadMilliseconds\t" << (loadTimer.getWallSeconds()*1e3) << "\n";
+
+    TimeTracker singleTimer;
+    singleTimer.resume();
+    for (unsigned repeatIndex(0); repeatIndex < opt.repeatCount; ++repeatIndex)
+    {
+        for (const auto& row : rows)
+        {
+            probSum += model.getProb(row);
+        }
+    }
+    singleTimer.stop();
+    os << "singleRowNanosecondsPerVariant\t" << (singleTimer.getWallSeconds()*1e9/(rowCount*opt.repeatCount)) << "\n";
+
+    os << "batchSize\tbatchedNanosecondsPerVariant\n";
+    std::vector<VariantScoringModelBase::featureInput_t> batch;
+    std::vector<double> probs;
+    for (const unsigned batchSize : batchSizes)
+    {
+        TimeTracker batchTimer;
+        for (unsigned repeatIndex(0); repeatIndex < opt.repeatCount; ++repeatIndex)
+        {
+            for (unsigned rowIndex(0); rowIndex < rowCount; rowIndex += batchSize)
+            {
+                batch.assign(rows.begin()+rowIndex, rows.begin()+std::min(rowIndex+batchSize,rowCount));
+                batchTimer.resume();
+                model.getProbs(batch, probs);
+                batchTimer.stop();
+                probSum += probs[0];
+            }
+        }
+        os << batchSize << "\t" << (batchTimer.getWallSeconds()*1e9/(rowCount*opt.repeatCount)) << "\n";
+    }
+
+    if (probSum == 0) os << "probSum\t" << probSum << "\n";
+
+    reportServerLoadTimes(root, featureCount, os);
+}
@@ -0,0 +1,252 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#include "TrioTransmissionBenchmark.hh"
+
+#include "applications/pedicure/denovo_snv_transmission.hh"
+#include "blt_util/math_util.hh"
+#include "blt_util/time_util.hh"
+#include "strelka_common/position_snp_call_grid_lhood_cached.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+
+
+namespace
+{
+
+typedef std::array<double,TRANSMISSION_STATE::SIZE> state_lhood_t;
+
+
+/// trio site likelihoods in pedicure's sample order
+struct TrioSite
+{
+    dsnv_state_t parent0Lhood;
+    dsnv_state_t parent1Lhood;
+    dsnv_state_t probandLhood;
+    std::array<bool,N_BASE> candidateAlleles;
+};
+
+
+
+/// simulate a pileup where each read supports the alt allele with probability altFraction
+void
+getSimulatedPileup(
+    const unsigned depth,
+    const double altFraction,
+    std::mt19937& rng,
+    snp_pos_info& pi)
+{
+    std::uniform_int_distribution<unsigned> qscoreDist(10,40);
+    std::uniform_int_distribution<unsigned> baseDist(0,N_BASE-1);
+    std::uniform_real_distribution<double> fracDist(0,1);
+
+    pi.clear();
+    pi.set_ref_base(id_to_base(0));
+    for (unsigned callIndex(0); callIndex < depth; ++callIndex)
+    {
+        const unsigned qscore(qscoreDist(rng));
+        unsigned baseId((fracDist(rng) < altFraction) ? 1 : 0);
+        if (fracDist(rng) < qphred_to_error_prob(qscore)) baseId = baseDist(rng);
+        const bool isFwdStrand(fracDist(rng) < 0.5);
+        pi.calls.push_back(base_call(baseId,qscore,isFwdStrand,0,0,false,false,false,false,false));
+    }
+}
+
+
+
+void
+getSampleLhood(
+    const blt_options& bopt,
+    const snp_pos_info& pi,
+    dsnv_state_t& lhood)
+{
+    get_diploid_gt_lhood_cached(bopt, pi, lhood.data());
+    get_diploid_het_grid_lhood_cached(pi, DIGT_DGRID::HET_RES, lhood.data()+DIGT::SIZE);
+}
+
+
+
+/// simulate trio sites which cycle through inherited het, de novo het and shared noise patterns
+std::vector<TrioSite>
+getSimulatedTrioSites(
+    const unsigned siteCount,
+    std::mt19937& rng)
+{
+    // parent0, parent1 and proband alt fractions of each site pattern:
+    static const double altFractions[][3] = { { 0.5, 0, 0.5 }, { 0, 0, 0.5 }, { 0.1, 0.1, 0.3 } };
+    static const unsigned patternCount(sizeof(altFractions)/sizeof(altFractions[0]));
+    std::uniform_int_distribution<unsigned> depthDist(10,60);
+
+    blt_options bopt;
+    snp_pos_info pi;
+    std::vector<TrioSite> sites(siteCount);
+    for (unsigned siteIndex(0); siteIndex < siteCount; ++siteIndex)
+    {
+        TrioSite& site(sites[siteIndex]);
+        const double* fractions(altFractions[siteIndex % patternCount]);
+        dsnv_state_t* sampleLhood[] = { &site.parent0Lhood, &site.parent1Lhood, &site.probandLhood };
+        site.candidateAlleles.fill(false);
+        for (unsigned sampleIndex(0); sampleIndex < 3; ++sampleIndex)
+        {
+            getSimulatedPileup(depthDist(rng), fractions[sampleIndex], rng, pi);
+            dsnv_state_t& lhood(*sampleLhood[sampleIndex]);
+            getSampleLhood(bopt, pi, lhood);
+            const unsigned maxGT(std::max_element(lhood.begin(), lhood.begin()+DIGT::SIZE)-lhood.begin());
+            site.candidateAlleles[DIGT::get_allele(maxGT,0)] = true;
+            site.candidateAlleles[DIGT::get_allele(maxGT,1)] = true;
+        }
+    }
+    return sites;
+}
+
+
+
+/// the transmission state likelihood computation as written before the precomputed table, with the
+/// transmission state lookup from the table
+void
+getEnumeratedStateLhood(
+    const TrioSite& site,
+    state_lhood_t& stateLhood)
+{
+    const TrioTransmissionTable& table(TrioTransmissionTable::get());
+    stateLhood.fill(-std::numeric_limits<double>::infinity());
+
+    auto isFilterGT = [&](const unsigned gt)
+    {
+        return (! (site.candidateAlleles[DIGT::get_allele(gt,0)] && site.candidateAlleles[DIGT::get_allele(gt,1)]));
+    };
+
+    for (unsigned parent0GT(0); parent0GT<DIGT::SIZE; ++parent0GT)
+    {
+        if (isFilterGT(parent0GT)) continue;
+        for (unsigned parent1GT(0); parent1GT<DIGT::SIZE; ++parent1GT)
+        {
+            if (isFilterGT(parent1GT)) continue;
+            for (unsigned probandGT(0); probandGT<DIGT::SIZE; ++probandGT)
+            {
+                if (isFilterGT(probandGT)) continue;
+                const double pedigreeLhood = site.parent0Lhood[parent0GT] + site.parent1Lhood[parent1GT] + site.probandLhood[probandGT];
+                const TRANSMISSION_STATE::index_t tran(table.getState(parent0GT,parent1GT,probandGT));
+                stateLhood[tran] = log_sum(stateLhood[tran],pedigreeLhood);
+            }
+        }
+    }
+
+    static const unsigned ratioCount(DIGT_DGRID::HET_RES*2);
+    for (unsigned hetIndex(0); hetIndex<(DIGT::HET_SIZE); hetIndex++)
+    {
+        const unsigned hetGT(hetIndex+N_BASE);
+        if (isFilterGT(hetGT)) continue;
+        for (unsigned ratioIndex(0); ratioIndex<ratioCount; ++ratioIndex)
+        {
+            const unsigned noiseState(DIGT::SIZE+(ratioIndex*DIGT::HET_SIZE)+hetIndex);
+            const double errorLhood =
+                site.parent0Lhood[noiseState] +
+                site.parent1Lhood[noiseState] +
+                site.probandLhood[noiseState];
+            stateLhood[TRANSMISSION_STATE::ERROR] = log_sum(stateLhood[TRANSMISSION_STATE::ERROR], errorLhood);
+        }
+    }
+}
+
+
+
+void
+getTableStateLhood(
+    const TrioSite& site,
+    state_lhood_t& stateLhood)
+{
+    getTrioTransmissionStateLhood(site.parent0Lhood, site.parent1Lhood, site.probandLhood,
+                                  site.candidateAlleles, stateLhood);
+    addTrioSharedNoiseLhood(site.parent0Lhood, site.parent1Lhood, site.probandLhood,
+                            site.candidateAlleles, stateLhood);
+}
+
+}
+
+
+
+void
+runTrioTransmissionBenchmark(
+    const BenchmarkOptions& opt,
+    std::ostream& os)
+{
+    static const unsigned siteCount(30000);
+
+    std::mt19937 rng(1);
+    const std::vector<TrioSite> sites(getSimulatedTrioSites(siteCount, rng));
+
+    // accumulate a result value so that the kernel calls can't be optimized out:
+    double lhoodSum(0);
+    state_lhood_t stateLhood;
+
+    TimeTracker enumeratedTimer;
+    enumeratedTimer.resume();
+    for (unsigned repeatIndex(0); repeatIndex < opt.repeatCount; ++repeatIndex)
+    {
+        for (const TrioSite& site : sites)
+        {
+            getEnumeratedStateLhood(site, stateLhood);
+            lhoodSum += stateLhood[TRANSMISSION_STATE::DENOVO];
+        }
+    }
+    enumeratedTimer.stop();
+
+    TimeTracker tableTimer;
+    tableTimer.resume();
+    for (unsigned repeatIndex(0); repeatIndex < opt.repeatCount; ++repeatIndex)
+    {
+        for (const TrioSite& site : sites)
+        {
+            getTableStateLhood(site, stateLhood);
+            lhoodSum += stateLhood[TRANSMISSION_STATE::DENOVO];
+        }
+    }
+    tableTimer.stop();
+
+    // check that both methods agree:
+    double maxLhoodDiff(0);
+    state_lhood_t enumeratedStateLhood;
+    for (const TrioSite& site : sites)
+    {
+        getEnumeratedStateLhood(site, enumeratedStateLhood);
+        getTableStateLhood(site, stateLhood);
+        for (unsigned state(0); state<TRANSMISSION_STATE::SIZE; ++state)
+        {
+            // skip states with negligible likelihood, which the table method may underflow to zero:
+            if (enumeratedStateLhood[state] < (-500.)) continue;
+            maxLhoodDiff = std::max(maxLhoodDiff, std::abs(enumeratedStateLhood[state]-stateLhood[state]));
+        }
+    }
+
+    const double callCount(static_cast<double>(sites.size())*opt.repeatCount);
+    os << "benchmark\ttrio-transmission\n";
+    os << "sites\t" << sites.size() << "\n";
+    os << "enumeratedNanosecondsPerSite\t" << (enumeratedTimer.getWallSeconds()*1e9/callCount) << "\n";
+    os << "tableNanosecondsPerSite\t" << (tableTimer.getWallSeconds()*1e9/callCount) << "\n";
+    os << "maxStateLhoodDifference\t" << maxLhoodDiff << "\n";
+
+    if (lhoodSum == 0) os << "lhoodSum\t" << lhoodSum << "\n";
+}
@@ -0,0 +1,199 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#include "VcfRecordBenchmark.hh"
+#include "AllocationCounter.hh"
+
+#include "blt_util/time_util.hh"
+#include "common/Exceptions.hh"
+#include "htsapi/vcf_record.hh"
+#include "htsapi/vcf_streamer.hh"
+
+#include <cassert>
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+
+static
+void
+loadBenchmarkVcfLines(
+    const BenchmarkOptions& opt,
+    std::vector<std::string>& lines)
+{
+    using namespace illumina::common;
+
+    if (opt.vcfFilename.empty())
+    {
+        std::ostringstream oss;
+        oss << "The " << opt.benchmarkName << " benchmark requires a vcf file";
+        BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+    }
+
+    static const bool isRequireNormalized(false);
+    vcf_streamer vcfStream(opt.vcfFilename.c_str(), nullptr, isRequireNormalized);
+
+    std::vector<std::string> regions;
+    if (opt.region.empty())
+    {
+        regions = vcfStream.getIndexSequenceNames();
+    }
+    else
+    {
+        regions.push_back(opt.region);
+    }
+
+    for (const std::string& region : regions)
+    {
+        vcfStream.resetRegion(region.c_str());
+        while (vcfStream.next())
+        {
+            lines.emplace_back(vcfStream.get_record_ptr()->line);
+        }
+    }
+
+    if (lines.empty())
+    {
+        std::ostringstream oss;
+        oss << "No records found in " << opt.benchmarkName << " benchmark input";
+        BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+    }
+}
+
+
+
+namespace
+{
+
+/// counts of each variant type found in the benchmark records
+struct VcfRecordTypeCounts
+{
+    bool
+    operator==(const VcfRecordTypeCounts& rhs) const
+    {
+        return ((indel == rhs.indel) and (snv == rhs.snv) and (refSite == rhs.refSite) and
+                (unnormalized == rhs.unnormalized));
+    }
+
+    uint64_t indel = 0;
+    uint64_t snv = 0;
+    uint64_t refSite = 0;
+    uint64_t unnormalized = 0;
+
+    /// total size of all accessed CHROM, REF and ALT fields
+    uint64_t fieldSize = 0;
+};
+
+}
+
+
+
+/// \param isFieldAccess if true, access the CHROM, REF and ALT fields of each record as well as running the
+///                      variant type tests
+static
+void
+runVcfRecordPass(
+    const BenchmarkOptions& opt,
+    const std::vector<std::string>& lines,
+    const bool isFieldAccess,
+    const char* passLabel,
+    VcfRecordTypeCounts& counts,
+    std::ostream& os)
+{
+    vcf_record vcfRecord;
+    uint64_t recordCount(0);
+
+    TimeTracker timer;
+    const uint64_t startAllocationCount(getAllocationCount());
+    timer.resume();
+
+    for (unsigned repeatIndex(0); repeatIndex < opt.repeatCount; ++repeatIndex)
+    {
+        for (const std::string& line : lines)
+        {
+            vcfRecord.set(line.c_str());
+            recordCount++;
+
+            // mirror the tests made on each record by vcf_streamer and the callers' vcf input handlers:
+            if (vcfRecord.isSimpleVariantLocus() and (not vcfRecord.is_normalized())) counts.unnormalized++;
+            if (vcfRecord.is_indel())
+            {
+                counts.indel++;
+            }
+            else if (vcfRecord.is_snv())
+            {
+                counts.snv++;
+            }
+            else if (vcfRecord.is_ref_site())
+            {
+                counts.refSite++;
+            }
+
+            if (isFieldAccess)
+            {
+                counts.fieldSize += vcfRecord.getChrom().size() + vcfRecord.getRef().size();
+                for (const std::string& alt : vcfRecord.getAlt())
+                {
+                    counts.fieldSize += alt.size();
+                }
+            }
+        }
+    }
+
+    timer.stop();
+    const uint64_t allocationCount(getAllocationCount() - startAllocationCount);
+    const double wallSeconds(timer.getWallSeconds());
+
+    os << passLabel << "Allocations\t" << allocationCount << "\n";
+    os << passLabel << "AllocationsPerRecord\t" << (static_cast<double>(allocationCount)/recordCount) << "\n";
+    os << passLabel << "WallSeconds\t" << wallSeconds << "\n";
+    if (wallSeconds > 0)
+    {
+        os << passLabel << "RecordsPerSecond\t" << (recordCount/wallSeconds) << "\n";
+    }
+}
+
+
+
+void
+runVcfRecordBenchmark(
+    const BenchmarkOptions& opt,
+    std::ostream& os)
+{
+    std::vector<std::string> lines;
+    loadBenchmarkVcfLines(opt, lines);
+
+    os << "benchmark\tvcf-record\n";
+    os << "records\t" << (lines.size()*opt.repeatCount) << "\n";
+
+    VcfRecordTypeCounts typeCheckCounts;
+    runVcfRecordPass(opt, lines, false, "typeCheck", typeCheckCounts, os);
+
+    VcfRecordTypeCounts fieldAccessCounts;
+    runVcfRecordPass(opt, lines, true, "fieldAccess", fieldAccessCounts, os);
+    assert(typeCheckCounts == fieldAccessCounts);
+
+    os << "indels\t" << typeCheckCounts.indel << "\n";
+    os << "snvs\t" << typeCheckCounts.snv << "\n";
+    os << "refSites\t" << typeCheckCounts.refSite << "\n";
+    os << "unnormalized\t" << typeCheckCounts.unnormalized << "\n";
+}
@@ -0,0 +1,88 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "strelkaBenchmark.hh"
+#include "BenchmarkOptions.hh"
+#include "GenotypeLhoodBenchmark.hh"
+#include "GermlinePipelineBenchmark.hh"
+#include "GlobalAlignerBenchmark.hh"
+#include "IndelIndexBenchmark.hh"
+#include "PileupBenchmark.hh"
+#include "ReadBufferBenchmark.hh"
+#include "ScoringModelBenchmark.hh"
+#include "TrioTransmissionBenchmark.hh"
+#include "VcfRecordBenchmark.hh"
+
+#include <cassert>
+
+#include <functional>
+#include <iostream>
+#include <utility>
+
+
+
+typedef std::function<void(const BenchmarkOptions&, std::ostream&)> benchmark_t;
+
+
+
+/// all available benchmarks, in the order listed in the usage message
+static
+const std::vector<std::pair<std::string,benchmark_t>>&
+getBenchmarks()
+{
+    static const std::vector<std::pair<std::string,benchmark_t>> benchmarks =
+    {
+        { "read-buffer", runReadBufferBenchmark },
+        { "pileup", runPileupBenchmark },
+        { "genotype-lhood", runGenotypeLhoodBenchmark },
+        { "scoring-model", runScoringModelBenchmark },
+        { "global-aligner", runGlobalAlignerBenchmark },
+        { "germline-pipeline", runGermlinePipelineBenchmark },
+        { "homref-block", runHomRefBlockBenchmark },
+        { "vcf-record", runVcfRecordBenchmark },
+        { "indel-index", runIndelIndexBenchmark },
+        { "trio-transmission", runTrioTransmissionBenchmark }
+    };
+    return benchmarks;
+}
+
+
+
+void
+strelkaBenchmark::
+runInternal(int argc, char* argv[]) const
+{
+    std::vector<std::string> benchmarkNames;
+    for (const auto& benchmark : getBenchmarks())
+    {
+        benchmarkNames.push_back(benchmark.first);
+    }
+
+    BenchmarkOptions opt;
+    parseBenchmarkOptions(*this, argc, argv, benchmarkNames, opt);
+
+    for (const auto& benchmark : getBenchmarks())
+    {
+        if (benchmark.first != opt.benchmarkName) continue;
+        benchmark.second(opt, std::cout);
+        return;
+    }
+    assert(false && "Unknown benchmark name");
+}
@@ -68,7 +68,8 @@ snoise_run(
     std::vector<std::reference_wrapper<const bam_hdr_t>> bamHeaders;
     {
         std::vector<unsigned> registrationIndices(opt.alignFileOpt.alignmentFilename.size(), 0);
-        bamHeaders = registerAlignments(opt.alignFileOpt.alignmentFilename, registrationIndices, streamData);
+        bamHeaders = registerAlignments(opt.alignFileOpt.alignmentFilename, registrationIndices, streamData,
+                                        opt.isAlignmentPrefetch);
 
         assert(not bamHeaders.empty());
         const bam_hdr_t& referenceHeader(bamHeaders.front());
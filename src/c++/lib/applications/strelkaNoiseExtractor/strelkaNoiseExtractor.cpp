@@ -94,7 +94,7 @@ runInternal(int argc, char* argv[]) const
     arg_data ad(legacy_starling_args,pinfo,opt.cmdline);
     legacy_starling_arg_parse(ad,opt);
 
-    finalize_starling_base_options(pinfo,vm,opt);
+    finalize_snoise_options(pinfo,vm,opt);
 
     snoise_run(pinfo,opt);
 }
@@ -0,0 +1,168 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#pragma once
+
+#include "boost/serialization/nvp.hpp"
+#include "boost/serialization/vector.hpp"
+
+#include <cstdint>
+
+#include <algorithm>
+#include <iosfwd>
+#include <vector>
+
+
+/// histogram of counts in power of two bins
+///
+/// bin i holds values in [2^i,2^(i+1)), except that zero is added to the first bin and all values beyond
+/// the last bin are added to the last bin
+///
+struct Log2CountHistogram
+{
+    Log2CountHistogram()
+        : bins(binCount, 0)
+    {}
+
+    void
+    add(uint64_t value)
+    {
+        unsigned binIndex(0);
+        while ((value > 1) && ((binIndex+1) < bins.size()))
+        {
+            value >>= 1;
+            binIndex++;
+        }
+        bins[binIndex]++;
+    }
+
+    void
+    merge(const Log2CountHistogram& rhs)
+    {
+        if (rhs.bins.size() > bins.size()) bins.resize(rhs.bins.size(), 0);
+        for (unsigned binIndex(0); binIndex<rhs.bins.size(); ++binIndex)
+        {
+            bins[binIndex] += rhs.bins[binIndex];
+        }
+    }
+
+    /// write bin counts as a comma separated list
+    void
+    report(std::ostream& os) const;
+
+    template<class Archive>
+    void serialize(Archive& ar, const unsigned /* version */)
+    {
+        ar& BOOST_SERIALIZATION_NVP(bins);
+    }
+
+    static const unsigned binCount = 20;
+
+    std::vector<uint64_t> bins;
+};
+
+BOOST_CLASS_IMPLEMENTATION(Log2CountHistogram, boost::serialization::object_serializable)
+
+
+
+/// accumulates candidate alignment search and scoring counts over all realigned reads
+///
+struct ReadRealignmentStats
+{
+    void
+    addRead(
+        const unsigned candidateAlignmentCount,
+        const unsigned scoreCacheHitCount)
+    {
+        realignedReads++;
+        candidateAlignments += candidateAlignmentCount;
+        candidateAlignmentScoreCacheHits += scoreCacheHitCount;
+        maxCandidateAlignmentsPerRead = std::max(maxCandidateAlignmentsPerRead,
+                                                 static_cast<uint64_t>(candidateAlignmentCount));
+        candidateAlignmentsPerReadHistogram.add(candidateAlignmentCount);
+    }
+
+    /// add the candidate alignment search work of one read
+    ///
+    /// \param isReadBudgetExhausted the read exceeded its own search budget
+    /// \param isWindowBudgetExhausted the read was searched after its realignment window exceeded its budget
+    void
+    addSearch(
+        const unsigned searchStepCount,
+        const bool isReadBudgetExhausted,
+        const bool isWindowBudgetExhausted)
+    {
+        searchStepsPerReadHistogram.add(searchStepCount);
+        if (isReadBudgetExhausted) readBudgetExhaustedReads++;
+        if (isWindowBudgetExhausted) windowBudgetExhaustedReads++;
+    }
+
+    void
+    merge(const ReadRealignmentStats& rhs)
+    {
+        realignedReads += rhs.realignedReads;
+        candidateAlignments += rhs.candidateAlignments;
+        candidateAlignmentScoreCacheHits += rhs.candidateAlignmentScoreCacheHits;
+        maxCandidateAlignmentsPerRead = std::max(maxCandidateAlignmentsPerRead, rhs.maxCandidateAlignmentsPerRead);
+        readBudgetExhaustedReads += rhs.readBudgetExhaustedReads;
+        windowBudgetExhaustedReads += rhs.windowBudgetExhaustedReads;
+        candidateAlignmentsPerReadHistogram.merge(rhs.candidateAlignmentsPerReadHistogram);
+        searchStepsPerReadHistogram.merge(rhs.searchStepsPerReadHistogram);
+    }
+
+    void
+    report(std::ostream& os) const;
+
+    template<class Archive>
+    void serialize(Archive& ar, const unsigned /* version */)
+    {
+        ar& BOOST_SERIALIZATION_NVP(realignedReads);
+        ar& BOOST_SERIALIZATION_NVP(candidateAlignments);
+        ar& BOOST_SERIALIZATION_NVP(candidateAlignmentScoreCacheHits);
+        ar& BOOST_SERIALIZATION_NVP(maxCandidateAlignmentsPerRead);
+        ar& BOOST_SERIALIZATION_NVP(readBudgetExhaustedReads);
+        ar& BOOST_SERIALIZATION_NVP(windowBudgetExhaustedReads);
+        ar& BOOST_SERIALIZATION_NVP(candidateAlignmentsPerReadHistogram);
+        ar& BOOST_SERIALIZATION_NVP(searchStepsPerReadHistogram);
+    }
+
+    /// number of reads scored against at least one candidate alignment
+    uint64_t realignedReads = 0;
+
+    /// total number of candidate alignments scored over all reads
+    uint64_t candidateAlignments = 0;
+
+    /// number of candidate alignment scores which reused cached expected read bases
+    uint64_t candidateAlignmentScoreCacheHits = 0;
+
+    uint64_t maxCandidateAlignmentsPerRead = 0;
+
+    /// number of reads which exceeded the per-read candidate alignment search budget
+    uint64_t readBudgetExhaustedReads = 0;
+
+    /// number of reads searched with the reduced strategy because their realignment window exceeded the
+    /// per-window search budget
+    uint64_t windowBudgetExhaustedReads = 0;
+
+    Log2CountHistogram candidateAlignmentsPerReadHistogram;
+    Log2CountHistogram searchStepsPerReadHistogram;
+};
+
+BOOST_CLASS_IMPLEMENTATION(ReadRealignmentStats, boost::serialization::object_serializable)
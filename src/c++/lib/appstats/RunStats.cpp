@@ -42,6 +42,44 @@ safeFrac(
     return (static_cast<double>(num)/den);
 }
 
+
+
+void
+Log2CountHistogram::
+report(std::ostream& os) const
+{
+    bool isFirst(true);
+    for (const uint64_t count : bins)
+    {
+        if (not isFirst) os << ',';
+        os << count;
+        isFirst = false;
+    }
+}
+
+
+
+void
+ReadRealignmentStats::
+report(std::ostream& os) const
+{
+    os << "RealignedReads\t" << realignedReads << "\n";
+    os << "CandidateAlignmentsPerRead\t" << safeFrac(candidateAlignments, realignedReads) << "\n";
+    os << "MaxCandidateAlignmentsPerRead\t" << maxCandidateAlignmentsPerRead << "\n";
+    os << "CandidateAlignmentScoreCacheHitFraction\t"
+       << safeFrac(candidateAlignmentScoreCacheHits, candidateAlignments) << "\n";
+    os << "ReadSearchBudgetExhaustedReads\t" << readBudgetExhaustedReads << "\n";
+    os << "WindowSearchBudgetExhaustedReads\t" << windowBudgetExhaustedReads << "\n";
+    os << "CandidateAlignmentsPerReadLog2Histogram\t";
+    candidateAlignmentsPerReadHistogram.report(os);
+    os << "\n";
+    os << "SearchStepsPerReadLog2Histogram\t";
+    searchStepsPerReadHistogram.report(os);
+    os << "\n";
+}
+
+
+
 void
 RunStatsData::
 report(std::ostream& os) const
@@ -49,6 +87,7 @@ report(std::ostream& os) const
     os << "TotalHours\t";
     lifeTime.reportHr(os);
     os << "\n";
+    readRealignment.report(os);
 }
 
 
@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include "ReadRealignmentStats.hh"
 #include "blt_util/time_util.hh"
 
 #include "boost/serialization/nvp.hpp"
@@ -44,6 +45,7 @@ struct RunStatsData
     merge(const RunStatsData& rhs)
     {
         lifeTime.merge(rhs.lifeTime);
+        readRealignment.merge(rhs.readRealignment);
     }
 
     void
@@ -53,9 +55,11 @@ struct RunStatsData
     void serialize(Archive& ar, const unsigned /* version */)
     {
         ar& BOOST_SERIALIZATION_NVP(lifeTime);
+        ar& BOOST_SERIALIZATION_NVP(readRealignment);
     }
 
     CpuTimes lifeTime;
+    ReadRealignmentStats readRealignment;
 };
 
 BOOST_CLASS_IMPLEMENTATION(RunStatsData, boost::serialization::object_serializable)
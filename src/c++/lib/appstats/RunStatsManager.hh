@@ -44,6 +44,12 @@ struct RunStatsManager : private boost::noncopyable
 
     ~RunStatsManager();
 
+    void
+    addReadRealignmentStats(const ReadRealignmentStats& stats)
+    {
+        runStats.runStatsData.readRealignment.merge(stats);
+    }
+
 private:
     std::ostream* _osPtr;
     TimeTracker lifeTime;
@@ -0,0 +1,60 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#include "blt_util/Fnv1aChecksum.hh"
+
+#include "blt_util/blt_exception.hh"
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+
+
+uint64_t
+getFileChecksum(
+    const std::string& filename,
+    uint64_t& fileSize)
+{
+    std::ifstream ifs(filename, std::ios::binary);
+    if (! ifs)
+    {
+        std::ostringstream oss;
+        oss << "ERROR: Can't open file: '" << filename << "'";
+        throw blt_exception(oss.str().c_str());
+    }
+
+    Fnv1aChecksum checksum;
+    fileSize = 0;
+    std::vector<char> buffer(1 << 16);
+    while (ifs)
+    {
+        ifs.read(buffer.data(), buffer.size());
+        const std::size_t readSize(ifs.gcount());
+        checksum.update(buffer.data(), readSize);
+        fileSize += readSize;
+    }
+    if (ifs.bad())
+    {
+        std::ostringstream oss;
+        oss << "ERROR: Can't read file: '" << filename << "'";
+        throw blt_exception(oss.str().c_str());
+    }
+    return checksum.value();
+}
@@ -0,0 +1,65 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <string>
+
+
+/// incremental 64 bit FNV-1a checksum
+///
+/// This is used to tie derived binary files back to the text files they were built from, it is not
+/// intended to detect deliberate modification.
+///
+struct Fnv1aChecksum
+{
+    void
+    update(
+        const char* data,
+        const std::size_t size)
+    {
+        static const uint64_t fnvPrime(0x100000001b3ull);
+        for (std::size_t i(0); i < size; ++i)
+        {
+            _value ^= static_cast<unsigned char>(data[i]);
+            _value *= fnvPrime;
+        }
+    }
+
+    uint64_t
+    value() const
+    {
+        return _value;
+    }
+
+private:
+    uint64_t _value = 0xcbf29ce484222325ull;
+};
+
+
+/// get the FNV-1a checksum and size of a file's contents
+///
+/// throws blt_exception if the file can't be read
+uint64_t
+getFileChecksum(
+    const std::string& filename,
+    uint64_t& fileSize);
@@ -21,64 +21,61 @@
 ///
 /// \author Chris Saunders
 ///
-
 #pragma once
 
 #include <cassert>
+#include <cstdint>
 
-#include <map>
+#include <vector>
 
 
 /// online median tracking obj assuming high repeat obs counts
 ///
+/// Observations are stored in a flat histogram indexed by depth, which grows to the highest depth observed.
+///
 /// Note that by design depth=0 is excluded from the median
 struct MedianDepthTracker
 {
     void
-    addObs(const unsigned val)
+    addObs(
+        const unsigned val,
+        const unsigned count = 1)
     {
-        auto iter(_cmap.find(val));
-        if (iter == _cmap.end())
+        if (val >= _depthCount.size())
         {
-            _cmap[val] = 1;
+            _depthCount.resize(val+1,0);
         }
-        else
-        {
-            iter->second++;
-        }
-        _total++;
+        _depthCount[val] += count;
+        _total += count;
     }
 
     double
     getMedian() const
     {
         // +1 makes the 1/2 case work out correctly...
-        unsigned ztotal(_total+1);
-        const auto ziter(_cmap.find(0));
-        if (ziter != _cmap.end())
-        {
-            ztotal -= ziter->second;
-        }
+        const uint64_t ztotal(getNonZeroObsCount()+1);
 
-        unsigned sum = 0;
+        uint64_t sum = 0;
         unsigned lastBefore = 0;
         unsigned firstAfter = 0;
-        for (const auto& val : _cmap)
+        const unsigned depthSize(_depthCount.size());
+        for (unsigned depth(1); depth < depthSize; ++depth)
         {
-            if (val.first == 0) continue;
+            const uint64_t count(_depthCount[depth]);
+            if (count == 0) continue;
 
             // double instead of half so that we stay away from float math:
-            sum += (val.second*2);
+            sum += (count*2);
             if (sum >= ztotal)
             {
-                firstAfter = val.first;
-                if ((ztotal + val.second*2) != (sum + 1))
+                firstAfter = depth;
+                if ((ztotal + count*2) != (sum + 1))
                 {
                     lastBefore = firstAfter;
                 }
                 break;
             }
-            lastBefore = val.first;
+            lastBefore = depth;
         }
 
         assert ((sum+1) >= ztotal);
@@ -87,7 +84,37 @@ struct MedianDepthTracker
         return (static_cast<double>(lastBefore + firstAfter)/2.);
     }
 
+    /// \return the smallest non-zero depth at or above fraction p of all non-zero depth observations, or 0 if
+    /// there are no non-zero depth observations
+    unsigned
+    getQuantile(const double p) const
+    {
+        assert((p >= 0.) && (p <= 1.));
+
+        const uint64_t nonZeroTotal(getNonZeroObsCount());
+        if (nonZeroTotal == 0) return 0;
+
+        const double target(p*nonZeroTotal);
+        uint64_t sum = 0;
+        const unsigned depthSize(_depthCount.size());
+        for (unsigned depth(1); depth < depthSize; ++depth)
+        {
+            sum += _depthCount[depth];
+            if ((sum > 0) && (sum >= target)) return depth;
+        }
+        return (depthSize-1);
+    }
+
+    uint64_t
+    getNonZeroObsCount() const
+    {
+        if (_depthCount.empty()) return 0;
+        return (_total - _depthCount[0]);
+    }
+
 private:
-    unsigned _total = 0;
-    std::map<unsigned,unsigned> _cmap;
+    uint64_t _total = 0;
+
+    /// observation count for each depth
+    std::vector<uint64_t> _depthCount;
 };
@@ -0,0 +1,104 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#include "blt_util/MemoryMappedFile.hh"
+
+#include "blt_util/blt_exception.hh"
+
+#include <cerrno>
+#include <cstring>
+
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#ifndef _MSC_VER
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+
+static
+void
+mapError(
+    const std::string& filename,
+    const char* msg)
+{
+    std::ostringstream oss;
+    oss << "ERROR: Can't " << msg << " file: '" << filename << "'";
+    if (errno != 0) oss << " (" << std::strerror(errno) << ")";
+    throw blt_exception(oss.str().c_str());
+}
+
+
+
+MemoryMappedFile::
+MemoryMappedFile(const std::string& filename)
+    : _filename(filename)
+{
+#ifndef _MSC_VER
+    errno=0;
+    const int fd(open(filename.c_str(), O_RDONLY));
+    if (fd < 0) mapError(filename, "open");
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0)
+    {
+        close(fd);
+        mapError(filename, "stat");
+    }
+    _size = fileStat.st_size;
+
+    // mmap rejects zero length mappings, an empty file is left as an empty view:
+    if (_size > 0)
+    {
+        void* addr(mmap(nullptr, _size, PROT_READ, MAP_SHARED, fd, 0));
+        if (addr == MAP_FAILED)
+        {
+            close(fd);
+            mapError(filename, "memory map");
+        }
+        _data = static_cast<const char*>(addr);
+        _isMapped = true;
+    }
+    close(fd);
+#else
+    std::ifstream ifs(filename, std::ios::binary);
+    if (! ifs) mapError(filename, "open");
+    _buffer.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    _data = _buffer.data();
+    _size = _buffer.size();
+#endif
+}
+
+
+
+MemoryMappedFile::
+~MemoryMappedFile()
+{
+#ifndef _MSC_VER
+    if (_isMapped)
+    {
+        munmap(const_cast<char*>(_data), _size);
+    }
+#endif
+}
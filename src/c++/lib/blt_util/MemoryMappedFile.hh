@@ -0,0 +1,68 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#pragma once
+
+#include "boost/utility.hpp"
+
+#include <cstddef>
+
+#include <string>
+#include <vector>
+
+
+/// read-only view of an entire file mapped into memory
+///
+/// The mapping is shared, so any number of processes mapping the same file
+/// share a single copy of its pages. On platforms without mmap the file is
+/// read into a private buffer instead.
+///
+struct MemoryMappedFile : private boost::noncopyable
+{
+    /// throws blt_exception if the file can't be opened or mapped
+    explicit
+    MemoryMappedFile(const std::string& filename);
+
+    ~MemoryMappedFile();
+
+    const char*
+    data() const
+    {
+        return _data;
+    }
+
+    std::size_t
+    size() const
+    {
+        return _size;
+    }
+
+    const std::string&
+    filename() const
+    {
+        return _filename;
+    }
+
+private:
+    std::string _filename;
+    const char* _data = nullptr;
+    std::size_t _size = 0;
+    bool _isMapped = false;
+    std::vector<char> _buffer;
+};
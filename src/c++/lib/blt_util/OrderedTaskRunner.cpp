@@ -0,0 +1,117 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "blt_util/OrderedTaskRunner.hh"
+
+#include <cassert>
+
+#include <condition_variable>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <thread>
+
+
+
+void
+runOrderedTasks(
+    const unsigned workerCount,
+    const unsigned taskCount,
+    const std::function<void(const unsigned workerIndex, const unsigned taskIndex, TaskOutput& taskOutput)>& runTask,
+    const std::function<void(const TaskOutput& taskOutput)>& writeTaskOutput)
+{
+    assert(workerCount > 0);
+
+    if (workerCount == 1)
+    {
+        for (unsigned taskIndex(0); taskIndex < taskCount; ++taskIndex)
+        {
+            TaskOutput taskOutput;
+            runTask(0, taskIndex, taskOutput);
+            writeTaskOutput(taskOutput);
+        }
+        return;
+    }
+
+    // limit the number of completed tasks which can be held waiting on the output of an earlier task:
+    const unsigned maxTaskLookahead(2*workerCount);
+
+    std::mutex taskMutex;
+    std::condition_variable taskCondition;
+    unsigned nextTaskIndex(0);
+    unsigned nextWriteIndex(0);
+    std::map<unsigned,TaskOutput> pendingOutput;
+    std::exception_ptr taskError;
+
+    auto worker = [&](const unsigned workerIndex)
+    {
+        while (true)
+        {
+            unsigned taskIndex(0);
+            {
+                std::unique_lock<std::mutex> lock(taskMutex);
+                taskCondition.wait(lock, [&]
+                {
+                    return (taskError ||
+                            (nextTaskIndex >= taskCount) ||
+                            (nextTaskIndex < (nextWriteIndex + maxTaskLookahead)));
+                });
+                if (taskError || (nextTaskIndex >= taskCount)) return;
+                taskIndex = nextTaskIndex++;
+            }
+
+            try
+            {
+                TaskOutput taskOutput;
+                runTask(workerIndex, taskIndex, taskOutput);
+
+                std::lock_guard<std::mutex> lock(taskMutex);
+                pendingOutput[taskIndex] = std::move(taskOutput);
+                while (not taskError)
+                {
+                    const auto iter(pendingOutput.find(nextWriteIndex));
+                    if (iter == pendingOutput.end()) break;
+                    writeTaskOutput(iter->second);
+                    pendingOutput.erase(iter);
+                    nextWriteIndex++;
+                }
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(taskMutex);
+                if (not taskError) taskError = std::current_exception();
+            }
+            taskCondition.notify_all();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned workerIndex(0); workerIndex < workerCount; ++workerIndex)
+    {
+        workers.emplace_back(worker, workerIndex);
+    }
+    for (auto& thread : workers)
+    {
+        thread.join();
+    }
+
+    if (taskError) std::rethrow_exception(taskError);
+    assert(nextWriteIndex == taskCount);
+}
@@ -0,0 +1,51 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+
+/// buffered text output from one task, with one entry per output stream
+typedef std::vector<std::string> TaskOutput;
+
+
+/// run a sequence of indexed tasks on a pool of worker threads, and hand each task's output to a single writer
+/// in task index order
+///
+/// Tasks are claimed by workers in index order. The writer is only ever called by one thread at a time,
+/// so it can write to shared output streams without further synchronization.
+///
+/// If any task or writer call throws, no new tasks are started and the first exception is rethrown on the
+/// calling thread after all workers have stopped.
+///
+/// \param[in] workerCount number of worker threads, if this is 1 all tasks are run on the calling thread
+/// \param[in] taskCount total number of tasks
+/// \param[in] runTask called as runTask(workerIndex, taskIndex, taskOutput), concurrent calls
+///                    always have different workerIndex values
+/// \param[in] writeTaskOutput called once for each task in task index order
+void
+runOrderedTasks(
+    const unsigned workerCount,
+    const unsigned taskCount,
+    const std::function<void(const unsigned workerIndex, const unsigned taskIndex, TaskOutput& taskOutput)>& runTask,
+    const std::function<void(const TaskOutput& taskOutput)>& writeTaskOutput);
@@ -0,0 +1,110 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#include "blt_util/PackedReference.hh"
+
+#include "blt_util/blt_exception.hh"
+
+#include <cstring>
+
+#include <sstream>
+
+
+
+static
+void
+packedReferenceError(
+    const std::string& filename,
+    const char* msg)
+{
+    std::ostringstream oss;
+    oss << "ERROR: " << msg << " in packed reference file: '" << filename << "'";
+    throw blt_exception(oss.str().c_str());
+}
+
+
+
+PackedReference::
+PackedReference(const std::string& filename)
+    : _file(filename)
+{
+    using namespace PackedReferenceFormat;
+
+    if ((_file.size() < sizeof(FileHeader)) or
+        (std::memcmp(_file.data(), magic, sizeof(magic)) != 0))
+    {
+        packedReferenceError(filename, "Unrecognized header");
+    }
+    if (header().byteOrder != byteOrderMark)
+    {
+        packedReferenceError(filename, "Incompatible byte order");
+    }
+    if (header().version != formatVersion)
+    {
+        packedReferenceError(filename, "Unsupported format version");
+    }
+
+    const uint64_t fileSize(_file.size());
+    auto isValidSection = [&](const uint64_t offset, const uint64_t size)
+    {
+        return ((offset <= fileSize) and (size <= (fileSize-offset)));
+    };
+
+    const uint32_t contigCount(header().contigCount);
+    if (not isValidSection(sizeof(FileHeader), (contigCount * static_cast<uint64_t>(sizeof(ContigRecord)))))
+    {
+        packedReferenceError(filename, "Invalid contig table");
+    }
+
+    const ContigRecord* records(reinterpret_cast<const ContigRecord*>(_file.data()+sizeof(FileHeader)));
+    for (unsigned contigIndex(0); contigIndex < contigCount; ++contigIndex)
+    {
+        const ContigRecord& record(records[contigIndex]);
+        if ((record.length > (fileSize*4)) or
+            (not isValidSection(record.nameOffset, record.nameSize)) or
+            (not isValidSection(record.baseOffset, getPackedBaseSize(record.length))) or
+            (not isValidSection(record.nMaskOffset, getNMaskSize(record.length))))
+        {
+            packedReferenceError(filename, "Invalid contig record");
+        }
+
+        _contigs.emplace_back();
+        PackedReferenceContig& contig(_contigs.back());
+        contig.name.assign(_file.data()+record.nameOffset, record.nameSize);
+        contig.length = record.length;
+        contig.bases = reinterpret_cast<const uint8_t*>(_file.data()+record.baseOffset);
+        contig.nMask = reinterpret_cast<const uint8_t*>(_file.data()+record.nMaskOffset);
+
+        if (not _contigIndex.insert(std::make_pair(contig.name, contigIndex)).second)
+        {
+            packedReferenceError(filename, "Duplicate contig name");
+        }
+    }
+}
+
+
+
+const PackedReferenceContig*
+PackedReference::
+getContig(const std::string& name) const
+{
+    const auto iter(_contigIndex.find(name));
+    if (iter == _contigIndex.end()) return nullptr;
+    return &(_contigs[iter->second]);
+}
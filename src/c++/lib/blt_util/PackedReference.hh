@@ -0,0 +1,144 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#pragma once
+
+#include "blt_util/MemoryMappedFile.hh"
+
+#include "boost/utility.hpp"
+
+#include <cstdint>
+
+#include <map>
+#include <string>
+#include <vector>
+
+
+/// Packed reference files hold a standardized copy of every contig in a fasta reference, with each base stored
+/// in 2 bits plus a 1 bit per base N-mask. They are built once per run and memory mapped by every process which
+/// needs reference sequence.
+///
+/// File layout, all integers are in native byte order and all sections are 8 byte aligned:
+///
+/// 1. FileHeader
+/// 2. FileHeader::contigCount ContigRecord entries
+/// 3. for each contig: name, packed bases, N-mask
+///
+/// Base i of a contig is stored in bits (2*(i%4), 2*(i%4)+1) of byte i/4 using the BASE_ID encoding, and is an N
+/// if bit i%8 of N-mask byte i/8 is set.
+///
+namespace PackedReferenceFormat
+{
+
+static const char magic[8] = { 'S', 'T', 'K', 'P', 'R', 'E', 'F', '\0' };
+static const uint32_t formatVersion = 1;
+static const uint32_t byteOrderMark = 0x01020304;
+
+struct FileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+
+    /// size of the source fasta file, and FNV-1a checksum of its fasta index
+    uint64_t sourceFastaSize;
+    uint64_t sourceIndexChecksum;
+
+    uint32_t contigCount;
+    uint32_t reserved;
+};
+
+struct ContigRecord
+{
+    uint64_t nameOffset;
+    uint64_t nameSize;
+    uint64_t length;
+    uint64_t baseOffset;
+    uint64_t nMaskOffset;
+};
+
+static_assert(sizeof(FileHeader) == 40, "Unexpected packed reference header size");
+static_assert(sizeof(ContigRecord) == 40, "Unexpected packed reference contig record size");
+
+inline
+uint64_t
+getPackedBaseSize(const uint64_t length)
+{
+    return ((length+3)/4);
+}
+
+inline
+uint64_t
+getNMaskSize(const uint64_t length)
+{
+    return ((length+7)/8);
+}
+}
+
+
+
+/// read-only view of one contig in a packed reference
+struct PackedReferenceContig
+{
+    /// \param pos zero-indexed contig position, must be less than length
+    char
+    get_base(const uint64_t pos) const
+    {
+        static const char base[] = "ACGT";
+        if ((nMask[pos>>3] >> (pos&7)) & 1) return 'N';
+        return base[(bases[pos>>2] >> ((pos&3)<<1)) & 3];
+    }
+
+    std::string name;
+    uint64_t length = 0;
+    const uint8_t* bases = nullptr;
+    const uint8_t* nMask = nullptr;
+};
+
+
+
+/// read-only access to a memory mapped packed reference file
+///
+struct PackedReference : private boost::noncopyable
+{
+    /// maps the file and checks its layout, throws if this is not a valid packed reference file
+    explicit
+    PackedReference(const std::string& filename);
+
+    const PackedReferenceFormat::FileHeader&
+    header() const
+    {
+        return *reinterpret_cast<const PackedReferenceFormat::FileHeader*>(_file.data());
+    }
+
+    const std::string&
+    filename() const
+    {
+        return _file.filename();
+    }
+
+    /// \return nullptr if the contig is not in the packed reference
+    const PackedReferenceContig*
+    getContig(const std::string& name) const;
+
+private:
+    MemoryMappedFile _file;
+    std::vector<PackedReferenceContig> _contigs;
+    std::map<std::string,unsigned> _contigIndex;
+};
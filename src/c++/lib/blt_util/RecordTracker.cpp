@@ -134,14 +134,15 @@ convertVcfAltToIndel(
     const vcf_record& vcfr,
     const std::string& alt_instance)
 {
-    unsigned ref_length = vcfr.ref.size();
+    const std::string& ref(vcfr.getRef());
+    unsigned ref_length = ref.size();
     unsigned alt_length = alt_instance.size();
 
     assert(alt_length != ref_length);
     // AFAIK, the only way for alt_length and ref_length to be
     // equal would be for the record to be a SNP
 
-    const bool isFirstBaseMatching(testIsFirstBaseMatching(vcfr.ref, alt_instance));
+    const bool isFirstBaseMatching(testIsFirstBaseMatching(ref, alt_instance));
     const pos_t startPosOffset((isFirstBaseMatching ? 1 : 0));
     IndelKey indelKey;
     indelKey.pos = (vcfr.pos -1) + startPosOffset;
@@ -172,7 +173,7 @@ IndelGenotype::
 extractAlts()
 {
     max_delete_length = 0;
-    for (const auto& alt_str : vcfr.alt)
+    for (const auto& alt_str : vcfr.getAlt())
     {
         alts.push_back(convertVcfAltToIndel(vcfr, alt_str));
         max_delete_length = std::max(max_delete_length, alts.back().deletionLength);
@@ -284,7 +285,7 @@ addVcfRecord(
 {
     // overlapping vcf records are allowed
     // currently only used to add indels with single alts
-    assert(vcfRecord.alt.size() == 1 && vcfRecord.is_indel());
+    assert(vcfRecord.getAltCount() == 1 && vcfRecord.is_indel());
 
     IndelGenotype genotype_instance(vcfRecord);
 
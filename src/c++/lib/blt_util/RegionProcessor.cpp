@@ -30,16 +30,17 @@
 
 void
 RegionProcessor::
-addToRegion(
+addRange(
     const std::string& chrom,
-    const pos_t outputPos)
+    const pos_t beginPos,
+    const pos_t endPos)
 {
     if (nullptr == _osptr) return;
 
     // determine if we need to flush current range:
     if (_is_range)
     {
-        if ((chrom != _chrom) || ((_prange.end_pos+1) != outputPos))
+        if ((chrom != _chrom) || (_prange.end_pos != beginPos))
         {
             flush();
         }
@@ -47,13 +48,13 @@ addToRegion(
 
     if (_is_range)
     {
-        _prange.set_end_pos(outputPos);
+        _prange.set_end_pos(endPos);
     }
     else
     {
         _chrom=chrom;
-        _prange.set_begin_pos(outputPos-1);
-        _prange.set_end_pos(outputPos);
+        _prange.set_begin_pos(beginPos);
+        _prange.set_end_pos(endPos);
         _is_range=true;
     }
 }
@@ -49,7 +49,19 @@ struct RegionProcessor
     void
     addToRegion(
         const std::string& chrom,
-        const pos_t outputPos);
+        const pos_t outputPos)
+    {
+        addRange(chrom, outputPos-1, outputPos);
+    }
+
+    /// add the zero-indexed range [beginPos,endPos), which is merged with the pending range if they abut
+    ///
+    /// ranges must be added in order:
+    void
+    addRange(
+        const std::string& chrom,
+        const pos_t beginPos,
+        const pos_t endPos);
 
     // write out any pending ranges:
     void
@@ -24,8 +24,13 @@
 
 #pragma once
 
+#include "blt_util/PackedReference.hh"
 #include "blt_util/blt_types.hh"
 
+#include <cassert>
+
+#include <algorithm>
+#include <memory>
 #include <string>
 
 
@@ -38,6 +43,10 @@
 /// data. When time allows this will be restricted so that a compressed
 /// internal object can be used.
 ///
+/// Alternatively, the segment can read directly from a memory mapped
+/// packed reference contig without holding its own copy of the sequence,
+/// see set_packed_contig().
+///
 struct reference_contig_segment
 {
     reference_contig_segment()
@@ -48,6 +57,7 @@ struct reference_contig_segment
     get_base(const pos_t pos) const
     {
         if (pos<_offset || pos>=end()) return 'N';
+        if (_packedContig) return _packedContig->get_base(pos);
         return _seq[pos-_offset];
     }
 
@@ -66,6 +76,14 @@ struct reference_contig_segment
                 substr.push_back(get_base(pos+i));
             }
         }
+        else if (_packedContig)
+        {
+            substr.resize(length);
+            for (int i(0); i<length; ++i)
+            {
+                substr[i] = _packedContig->get_base(pos+i);
+            }
+        }
         else
         {
             //fast path
@@ -73,15 +91,43 @@ struct reference_contig_segment
         }
     }
 
+    /// the sequence string is not available for segments reading from a packed reference contig
     std::string& seq()
     {
+        assert(! is_packed());
         return _seq;
     }
     const std::string& seq() const
     {
+        assert(! is_packed());
         return _seq;
     }
 
+    /// read this segment directly from a packed reference contig
+    ///
+    /// The segment covers [begin_pos,end_pos), clipped to the end of the contig.
+    ///
+    /// \param packedRef the packed reference holding contig, this is retained to keep the contig mapped
+    void
+    set_packed_contig(
+        std::shared_ptr<const PackedReference> packedRef,
+        const PackedReferenceContig& contig,
+        const pos_t begin_pos,
+        const pos_t end_pos)
+    {
+        clear();
+        _packedRef = std::move(packedRef);
+        _packedContig = &contig;
+        _offset = begin_pos;
+        _packedEnd = std::max(begin_pos, static_cast<pos_t>(std::min(static_cast<uint64_t>(end_pos), contig.length)));
+    }
+
+    bool
+    is_packed() const
+    {
+        return (_packedContig != nullptr);
+    }
+
     pos_t
     get_offset() const
     {
@@ -91,12 +137,14 @@ struct reference_contig_segment
     void
     set_offset(const pos_t offset)
     {
+        assert(! is_packed());
         _offset=offset;
     }
 
     pos_t
     end() const
     {
+        if (_packedContig) return _packedEnd;
         return _offset+_seq.size();
     }
 
@@ -105,10 +153,17 @@ struct reference_contig_segment
     {
         _offset=0;
         _seq.clear();
+        _packedRef.reset();
+        _packedContig=nullptr;
+        _packedEnd=0;
     }
 
 private:
 
     pos_t _offset;
     std::string _seq;
+
+    std::shared_ptr<const PackedReference> _packedRef;
+    const PackedReferenceContig* _packedContig = nullptr;
+    pos_t _packedEnd = 0;
 };
@@ -110,6 +110,29 @@ BOOST_AUTO_TEST_CASE( test_MDT3 )
     BOOST_REQUIRE_CLOSE(t.getMedian(),2.5,eps);
 }
 
+BOOST_AUTO_TEST_CASE( test_MDTQuantile )
+{
+    static const double eps(0.00001);
+
+    MedianDepthTracker t;
+
+    BOOST_REQUIRE_EQUAL(t.getQuantile(0.5),0u);
+
+    t.addObs(0,10);
+    t.addObs(1);
+    t.addObs(2,2);
+    t.addObs(10);
+
+    BOOST_REQUIRE_EQUAL(t.getNonZeroObsCount(),4u);
+    BOOST_REQUIRE_CLOSE(t.getMedian(),2.,eps);
+    BOOST_REQUIRE_EQUAL(t.getQuantile(0.),1u);
+    BOOST_REQUIRE_EQUAL(t.getQuantile(0.25),1u);
+    BOOST_REQUIRE_EQUAL(t.getQuantile(0.5),2u);
+    BOOST_REQUIRE_EQUAL(t.getQuantile(0.75),2u);
+    BOOST_REQUIRE_EQUAL(t.getQuantile(0.8),10u);
+    BOOST_REQUIRE_EQUAL(t.getQuantile(1.),10u);
+}
+
 
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -0,0 +1,87 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "boost/test/unit_test.hpp"
+
+#include "blt_util/OrderedTaskRunner.hh"
+
+#include <stdexcept>
+#include <string>
+
+
+BOOST_AUTO_TEST_SUITE( test_OrderedTaskRunner )
+
+
+static
+void
+testTaskOrder(const unsigned workerCount)
+{
+    static const unsigned taskCount(50);
+
+    std::vector<unsigned> writeOrder;
+
+    // boost test assertions aren't thread safe, so only record the task output in the worker and writer calls:
+    auto runTask = [&](const unsigned workerIndex, const unsigned taskIndex, TaskOutput& taskOutput)
+    {
+        if (workerIndex >= workerCount) throw std::logic_error("unexpected worker index");
+        taskOutput.push_back(std::to_string(taskIndex));
+    };
+
+    auto writeTaskOutput = [&](const TaskOutput& taskOutput)
+    {
+        writeOrder.push_back(std::stoul(taskOutput.at(0)));
+    };
+
+    runOrderedTasks(workerCount, taskCount, runTask, writeTaskOutput);
+
+    BOOST_REQUIRE_EQUAL(writeOrder.size(), taskCount);
+    for (unsigned taskIndex(0); taskIndex < taskCount; ++taskIndex)
+    {
+        BOOST_REQUIRE_EQUAL(writeOrder[taskIndex], taskIndex);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( test_OrderedTaskRunnerSingleWorker )
+{
+    testTaskOrder(1);
+}
+
+
+BOOST_AUTO_TEST_CASE( test_OrderedTaskRunnerMultiWorker )
+{
+    testTaskOrder(4);
+}
+
+
+BOOST_AUTO_TEST_CASE( test_OrderedTaskRunnerException )
+{
+    auto runTask = [](const unsigned, const unsigned taskIndex, TaskOutput&)
+    {
+        if (taskIndex == 7) throw std::runtime_error("task failure");
+    };
+
+    auto writeTaskOutput = [](const TaskOutput&) {};
+
+    BOOST_REQUIRE_THROW(runOrderedTasks(3, 20, runTask, writeTaskOutput), std::runtime_error);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,60 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#include "boost/test/unit_test.hpp"
+
+#include "RegionProcessor.hh"
+
+#include <sstream>
+
+
+BOOST_AUTO_TEST_SUITE( test_RegionProcessor )
+
+
+BOOST_AUTO_TEST_CASE( test_RegionProcessorPositions )
+{
+    std::ostringstream oss;
+    {
+        RegionProcessor rp(&oss);
+        rp.addToRegion("chr1", 10);
+        rp.addToRegion("chr1", 11);
+        rp.addToRegion("chr1", 13);
+        rp.addToRegion("chr2", 14);
+    }
+    BOOST_REQUIRE_EQUAL(oss.str(), "chr1\t9\t11\nchr1\t12\t13\nchr2\t13\t14\n");
+}
+
+
+BOOST_AUTO_TEST_CASE( test_RegionProcessorRanges )
+{
+    // abutting ranges are merged, including a single position range added after a longer range:
+    std::ostringstream oss;
+    {
+        RegionProcessor rp(&oss);
+        rp.addRange("chr1", 0, 5);
+        rp.addRange("chr1", 5, 8);
+        rp.addToRegion("chr1", 9);
+        rp.addRange("chr1", 10, 12);
+        rp.flush();
+        rp.addRange("chr1", 12, 15);
+    }
+    BOOST_REQUIRE_EQUAL(oss.str(), "chr1\t0\t9\nchr1\t10\t12\nchr1\t12\t15\n");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,62 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#pragma once
+
+#include "boost/filesystem.hpp"
+#include "boost/utility.hpp"
+
+#include <string>
+
+
+/// a unique temporary path for unit test output, anything created at this path is removed when this object goes
+/// out of scope
+///
+/// The path can be used directly as a file name, or created as a directory to hold several files.
+///
+struct TestTempPath : private boost::noncopyable
+{
+    /// \param[in] suffix appended to the unique path name, this can be used to add a file extension
+    explicit
+    TestTempPath(const std::string& suffix = "")
+        : path((boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("%%%%-%%%%-%%%%"+suffix)).string())
+    {}
+
+    ~TestTempPath()
+    {
+        boost::system::error_code ec;
+        boost::filesystem::remove_all(path, ec);
+    }
+
+    /// create a directory at this path
+    void
+    createDirectory() const
+    {
+        boost::filesystem::create_directory(path);
+    }
+
+    /// path of a file named name in the directory at this path
+    std::string
+    file(const std::string& name) const
+    {
+        return (boost::filesystem::path(path) / name).string();
+    }
+
+    const std::string path;
+};
@@ -0,0 +1,322 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#include "BinaryScoringModelFile.hh"
+
+#include "blt_util/blt_exception.hh"
+#include "blt_util/Fnv1aChecksum.hh"
+#include "common/Exceptions.hh"
+
+#include <cassert>
+#include <cstring>
+
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+
+
+static
+void
+binaryModelError(
+    const std::string& filename,
+    const std::string& msg)
+{
+    using namespace illumina::common;
+
+    std::ostringstream oss;
+    oss << "ERROR: " << msg << " in binary scoring model file: '" << filename << "'";
+    BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+}
+
+
+
+static
+uint64_t
+alignOffset(const uint64_t offset)
+{
+    return ((offset + 7) & ~static_cast<uint64_t>(7));
+}
+
+
+
+namespace
+{
+
+/// a model from the json file along with its position in the binary file
+struct ConvertedModel
+{
+    std::vector<std::string> strings;
+    VariantScoringModelMetadata meta;
+    std::unique_ptr<RandomForestModel> forest;
+    BinaryScoringModel::ModelRecord record;
+};
+
+}
+
+
+
+void
+convertScoringModelFile(
+    const std::string& jsonFilename,
+    const std::string& binaryFilename)
+{
+    using namespace BinaryScoringModel;
+
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = formatVersion;
+    header.byteOrder = byteOrderMark;
+    header.sourceChecksum = getFileChecksum(jsonFilename, header.sourceSize);
+
+    Json::Value root;
+    {
+        std::ifstream file(jsonFilename, std::ifstream::binary);
+        file >> root;
+    }
+
+    const Json::Value models = root["CalibrationModels"];
+    if (models.isNull())
+    {
+        std::ostringstream oss;
+        oss << "ERROR: Can't find node 'CalibrationModels' in scoring model file: '" << jsonFilename << "'";
+        BOOST_THROW_EXCEPTION(illumina::common::LogicException(oss.str()));
+    }
+
+    std::vector<ConvertedModel> convertedModels;
+    for (int callIndex(0); callIndex < SCORING_CALL_TYPE::SIZE; ++callIndex)
+    {
+        const char* callLabel(SCORING_CALL_TYPE::get_label(static_cast<SCORING_CALL_TYPE::index_t>(callIndex)));
+        const Json::Value callModels = models[callLabel];
+        if (callModels.isNull()) continue;
+
+        for (int variantIndex(0); variantIndex < SCORING_VARIANT_TYPE::SIZE; ++variantIndex)
+        {
+            const char* variantLabel(SCORING_VARIANT_TYPE::get_label(static_cast<SCORING_VARIANT_TYPE::index_t>(variantIndex)));
+            const Json::Value varModel = callModels[variantLabel];
+            if (varModel.isNull()) continue;
+
+            convertedModels.emplace_back();
+            ConvertedModel& cmodel(convertedModels.back());
+            cmodel.meta.Deserialize(varModel);
+            if (cmodel.meta.ModelType != "RandomForest")
+            {
+                std::ostringstream oss;
+                oss << "ERROR: Unsupported scoring model type '" << cmodel.meta.ModelType << "' in scoring model file: '" << jsonFilename << "'";
+                BOOST_THROW_EXCEPTION(illumina::common::LogicException(oss.str()));
+            }
+            cmodel.forest.reset(new RandomForestModel());
+            cmodel.forest->Deserialize(cmodel.meta.featureNames.size(), varModel);
+
+            cmodel.strings = { callLabel, variantLabel, cmodel.meta.date, cmodel.meta.ModelType };
+            cmodel.strings.insert(cmodel.strings.end(), cmodel.meta.featureNames.begin(), cmodel.meta.featureNames.end());
+        }
+    }
+    header.modelCount = convertedModels.size();
+
+    // lay out all sections:
+    uint64_t offset(sizeof(FileHeader) + (header.modelCount * sizeof(ModelRecord)));
+    for (ConvertedModel& cmodel : convertedModels)
+    {
+        ModelRecord& record(cmodel.record);
+        std::memset(&record, 0, sizeof(record));
+        record.probPow = cmodel.meta.probPow;
+        record.probScale = cmodel.meta.probScale;
+        record.filterCutoff = cmodel.meta.filterCutoff;
+
+        record.stringOffset = alignOffset(offset);
+        record.stringSize = 0;
+        for (const std::string& str : cmodel.strings)
+        {
+            record.stringSize += str.size()+1;
+        }
+        record.stringCount = cmodel.strings.size();
+        offset = record.stringOffset + record.stringSize;
+
+        record.treeCount = cmodel.forest->getTreeCount();
+        record.treeRootOffset = alignOffset(offset);
+        offset = record.treeRootOffset + (record.treeCount * sizeof(uint32_t));
+
+        record.nodeCount = cmodel.forest->getNodeCount();
+        record.nodeOffset = alignOffset(offset);
+        offset = record.nodeOffset + (record.nodeCount * sizeof(RandomForestModel::FlatNode));
+    }
+
+    std::ofstream ofs(binaryFilename, std::ios::binary);
+    if (! ofs)
+    {
+        std::ostringstream oss;
+        oss << "ERROR: Can't open binary scoring model output file: '" << binaryFilename << "'";
+        throw blt_exception(oss.str().c_str());
+    }
+
+    uint64_t writeOffset(0);
+    auto writeSection = [&](const uint64_t sectionOffset, const void* data, const uint64_t size)
+    {
+        static const char zeros[8] = {};
+        assert(sectionOffset >= writeOffset);
+        ofs.write(zeros, sectionOffset-writeOffset);
+        ofs.write(static_cast<const char*>(data), size);
+        writeOffset = sectionOffset+size;
+    };
+
+    writeSection(0, &header, sizeof(header));
+    for (const ConvertedModel& cmodel : convertedModels)
+    {
+        writeSection(writeOffset, &cmodel.record, sizeof(ModelRecord));
+    }
+    for (const ConvertedModel& cmodel : convertedModels)
+    {
+        const ModelRecord& record(cmodel.record);
+        uint64_t stringOffset(record.stringOffset);
+        for (const std::string& str : cmodel.strings)
+        {
+            writeSection(stringOffset, str.c_str(), str.size()+1);
+            stringOffset += str.size()+1;
+        }
+        writeSection(record.treeRootOffset, cmodel.forest->getTreeRootIndex(), record.treeCount * sizeof(uint32_t));
+        writeSection(record.nodeOffset, cmodel.forest->getNodes(), record.nodeCount * sizeof(RandomForestModel::FlatNode));
+    }
+
+    if (! ofs)
+    {
+        std::ostringstream oss;
+        oss << "ERROR: Failed to write binary scoring model output file: '" << binaryFilename << "'";
+        throw blt_exception(oss.str().c_str());
+    }
+}
+
+
+
+BinaryScoringModelFile::
+BinaryScoringModelFile(const std::string& filename)
+    : _file(filename)
+{
+    using namespace BinaryScoringModel;
+
+    if ((_file.size() < sizeof(FileHeader)) or
+        (std::memcmp(_file.data(), magic, sizeof(magic)) != 0))
+    {
+        binaryModelError(filename, "Unrecognized header");
+    }
+
+    const FileHeader& fileHeader(header());
+    if (fileHeader.byteOrder != byteOrderMark)
+    {
+        binaryModelError(filename, "Incompatible byte order");
+    }
+    if (fileHeader.version != formatVersion)
+    {
+        std::ostringstream oss;
+        oss << "Unsupported format version " << fileHeader.version << " (expected " << formatVersion << ")";
+        binaryModelError(filename, oss.str());
+    }
+    checkSection(sizeof(FileHeader), fileHeader.modelCount, sizeof(ModelRecord), alignof(ModelRecord));
+}
+
+
+
+bool
+BinaryScoringModelFile::
+isBinaryScoringModelFile(const std::string& filename)
+{
+    char fileMagic[sizeof(BinaryScoringModel::magic)];
+    std::ifstream ifs(filename, std::ios::binary);
+    ifs.read(fileMagic, sizeof(fileMagic));
+    return (ifs and (std::memcmp(fileMagic, BinaryScoringModel::magic, sizeof(fileMagic)) == 0));
+}
+
+
+
+void
+BinaryScoringModelFile::
+checkSection(
+    const uint64_t offset,
+    const uint64_t count,
+    const uint64_t elementSize,
+    const uint64_t alignment) const
+{
+    if ((offset > _file.size()) or (count > ((_file.size()-offset)/elementSize)) or ((offset % alignment) != 0))
+    {
+        binaryModelError(_file.filename(), "Invalid section offset");
+    }
+}
+
+
+
+bool
+BinaryScoringModelFile::
+getModel(
+    const SCORING_CALL_TYPE::index_t callType,
+    const SCORING_VARIANT_TYPE::index_t variantType,
+    VariantScoringModelMetadata& meta,
+    RandomForestModel& model) const
+{
+    using namespace BinaryScoringModel;
+
+    const std::string callLabel(SCORING_CALL_TYPE::get_label(callType));
+    const std::string variantLabel(SCORING_VARIANT_TYPE::get_label(variantType));
+
+    const ModelRecord* records(reinterpret_cast<const ModelRecord*>(_file.data()+sizeof(FileHeader)));
+    for (unsigned modelIndex(0); modelIndex < header().modelCount; ++modelIndex)
+    {
+        const ModelRecord& record(records[modelIndex]);
+
+        // unpack the string block:
+        checkSection(record.stringOffset, record.stringSize, 1, 1);
+        std::vector<std::string> strings;
+        {
+            const char* str(_file.data()+record.stringOffset);
+            const char* strEnd(str+record.stringSize);
+            while ((str < strEnd) and (strings.size() < record.stringCount))
+            {
+                const char* term(static_cast<const char*>(std::memchr(str, '\0', strEnd-str)));
+                if (term == nullptr) break;
+                strings.emplace_back(str, term);
+                str = term+1;
+            }
+        }
+        if ((record.stringCount < 4) or (strings.size() != record.stringCount))
+        {
+            binaryModelError(_file.filename(), "Invalid model string block");
+        }
+
+        if ((strings[0] != callLabel) or (strings[1] != variantLabel)) continue;
+
+        meta.date = strings[2];
+        meta.ModelType = strings[3];
+        meta.probPow = record.probPow;
+        meta.probScale = record.probScale;
+        meta.filterCutoff = record.filterCutoff;
+        meta.featureNames.assign(strings.begin()+4, strings.end());
+
+        checkSection(record.treeRootOffset, record.treeCount, sizeof(uint32_t), alignof(uint32_t));
+        checkSection(record.nodeOffset, record.nodeCount, sizeof(RandomForestModel::FlatNode), alignof(RandomForestModel::FlatNode));
+        model.setExternalForest(
+            meta.featureNames.size(),
+            reinterpret_cast<const RandomForestModel::FlatNode*>(_file.data()+record.nodeOffset),
+            record.nodeCount,
+            reinterpret_cast<const uint32_t*>(_file.data()+record.treeRootOffset),
+            record.treeCount);
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,141 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#pragma once
+
+#include "RandomForestModel.hh"
+#include "VariantScoringModelMetadata.hh"
+#include "VariantScoringModelTypes.hh"
+
+#include "blt_util/MemoryMappedFile.hh"
+
+#include <cstdint>
+
+#include <string>
+
+
+/// Binary scoring model files hold the compiled form of every model in a json scoring model file, so that
+/// processes can memory map the models instead of parsing json at startup.
+///
+/// File layout, all integers are in native byte order and all sections are 8 byte aligned:
+///
+/// 1. FileHeader
+/// 2. FileHeader::modelCount ModelRecord entries
+/// 3. for each model: a string block, the tree root index array and the RandomForestModel::FlatNode array
+///
+/// Each model's string block holds null-terminated strings in the order: call type label, variant type label,
+/// date, model type, and then one entry per feature name in feature index order.
+///
+namespace BinaryScoringModel
+{
+
+static const char magic[8] = { 'S', 'T', 'K', 'S', 'M', 'O', 'D', '\0' };
+static const uint32_t formatVersion = 1;
+static const uint32_t byteOrderMark = 0x01020304;
+
+struct FileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+
+    /// FNV-1a checksum and size of the json model file this file was converted from
+    uint64_t sourceChecksum;
+    uint64_t sourceSize;
+
+    uint32_t modelCount;
+    uint32_t reserved;
+};
+
+struct ModelRecord
+{
+    double probPow;
+    double probScale;
+    double filterCutoff;
+
+    uint64_t stringOffset;
+    uint64_t stringSize;
+    uint32_t stringCount;
+
+    uint32_t treeCount;
+    uint64_t treeRootOffset;
+
+    uint64_t nodeOffset;
+    uint64_t nodeCount;
+};
+
+static_assert(sizeof(FileHeader) == 40, "Unexpected binary scoring model header size");
+static_assert(sizeof(ModelRecord) == 72, "Unexpected binary scoring model record size");
+}
+
+
+
+/// convert every model in a json scoring model file to the binary scoring model format
+void
+convertScoringModelFile(
+    const std::string& jsonFilename,
+    const std::string& binaryFilename);
+
+
+/// read-only access to the models in a memory mapped binary scoring model file
+///
+/// Models returned from this object point directly into the mapped file, so this object must
+/// outlive them.
+///
+struct BinaryScoringModelFile
+{
+    /// maps the file and checks its header, throws if this is not a compatible binary scoring model file
+    explicit
+    BinaryScoringModelFile(const std::string& filename);
+
+    /// \return true if filename starts with the binary scoring model magic string
+    static
+    bool
+    isBinaryScoringModelFile(const std::string& filename);
+
+    const BinaryScoringModel::FileHeader&
+    header() const
+    {
+        return *reinterpret_cast<const BinaryScoringModel::FileHeader*>(_file.data());
+    }
+
+    /// find the model for the given call and variant type
+    ///
+    /// The metadata feature names are not checked against any client feature map.
+    ///
+    /// \return false if the file has no model for this call and variant type
+    bool
+    getModel(
+        const SCORING_CALL_TYPE::index_t callType,
+        const SCORING_VARIANT_TYPE::index_t variantType,
+        VariantScoringModelMetadata& meta,
+        RandomForestModel& model) const;
+
+private:
+    /// throw if an array of count elements at offset is not within the mapped file, or offset does not have the
+    /// given alignment
+    void
+    checkSection(
+        const uint64_t offset,
+        const uint64_t count,
+        const uint64_t elementSize,
+        const uint64_t alignment) const;
+
+    MemoryMappedFile _file;
+};
@@ -97,8 +97,7 @@ Deserialize(
     const unsigned treeCount(jmodels.size());
     for (unsigned treeIndex = 0; treeIndex < treeCount; ++treeIndex)
     {
-        _forest.emplace_back();
-        DecisionTree& dtree(_forest.back());
+        DecisionTree dtree;
 
         // loop through the three parameter categories (TREE,VOTE, DECISION) for each tree
         for (int i(0); i<SIZE; ++i)
@@ -140,69 +139,163 @@ Deserialize(
                 }
             }
         }
+
+        compileTree(dtree);
     }
+
+    useOwnedForest();
 }
 
 
 
-double
+void
+RandomForestModel::
+setExternalForest(
+    const unsigned expectedFeatureCount,
+    const FlatNode* nodes,
+    const uint64_t nodeCount,
+    const uint32_t* treeRootIndex,
+    const unsigned treeCount)
+{
+    using namespace illumina::common;
+
+    clear();
+
+    for (unsigned treeIndex(0); treeIndex < treeCount; ++treeIndex)
+    {
+        if (treeRootIndex[treeIndex] >= nodeCount)
+        {
+            std::ostringstream oss;
+            oss << "ERROR: scoring model tree " << treeIndex << " root node index is out of range";
+            BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+        }
+    }
+
+    // requiring children to follow their parent guarantees that every traversal terminates:
+    for (uint64_t nodeIndex(0); nodeIndex < nodeCount; ++nodeIndex)
+    {
+        const FlatNode& node(nodes[nodeIndex]);
+        if (node.featureIndex == FlatNode::leafFeatureIndex) continue;
+        if ((node.featureIndex >= expectedFeatureCount) or
+            (node.leftChildIndex <= nodeIndex) or
+            ((node.leftChildIndex+1ul) >= nodeCount))
+        {
+            std::ostringstream oss;
+            oss << "ERROR: scoring model node " << nodeIndex << " has an invalid feature index or child node index";
+            BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+        }
+    }
+
+    _nodeData = nodes;
+    _nodeCount = nodeCount;
+    _rootData = treeRootIndex;
+    _treeCount = treeCount;
+}
+
+
+
+void
 RandomForestModel::
-getDecisionTreeProb(
-    const featureInput_t& features,
-    const DecisionTree& dtree) const
+compileTree(
+    const DecisionTree& dtree)
 {
-    unsigned nodeIndex(0);
+    auto treeError = [&](const int nodeIndex, const char* msg)
+    {
+        using namespace illumina::common;
+
+        std::ostringstream oss;
+        oss << "ERROR: scoring model tree " << _treeRootIndex.size()-1 << " node " << nodeIndex << ": " << msg;
+        BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+    };
 
-    //traverse a single tree
-    while (true)
+    const unsigned rootIndex(_nodes.size());
+    _treeRootIndex.push_back(rootIndex);
+    _nodes.emplace_back();
+
+    // (json node index, flat node index) of each node waiting to be compiled:
+    std::vector<std::pair<int,unsigned>> pendingNodes = {{0,rootIndex}};
+    std::vector<bool> isCompiled(dtree.data.size(),false);
+
+    while (not pendingNodes.empty())
     {
+        const int nodeIndex(pendingNodes.back().first);
+        const unsigned flatIndex(pendingNodes.back().second);
+        pendingNodes.pop_back();
+
+        if ((nodeIndex < 0) or (nodeIndex >= static_cast<int>(dtree.data.size()))) treeError(nodeIndex,"child node index is out of range");
+        if (isCompiled[nodeIndex]) treeError(nodeIndex,"node is reachable from more than one parent");
+        isCompiled[nodeIndex] = true;
+
         const DecisionTreeNode& node(dtree.getNode(nodeIndex));
-        assert(node.tree.isInit);
-        // test condition signifies we've reached a leaf node
+        if (not node.tree.isInit) treeError(nodeIndex,"missing tree entry");
+
+        // test condition signifies a leaf node
         if (node.tree.left == -1)
         {
-            assert(node.vote.isInit);
+            if (not node.vote.isInit) treeError(nodeIndex,"missing node_votes entry");
             const double total = node.vote.left + node.vote.right;
-            return (node.vote.left / total);
+            _nodes[flatIndex].value = (node.vote.left / total);
+            continue;
         }
 
-        assert(node.decision.isInit);
-        if (features[node.decision.left] <= node.decision.right)
-        {
-            nodeIndex=node.tree.left;
-        }
-        else
+        if (not node.decision.isInit) treeError(nodeIndex,"missing decisions entry");
+        if ((node.decision.left < 0) or (node.decision.left >= FlatNode::leafFeatureIndex))
         {
-            nodeIndex=node.tree.right;
+            treeError(nodeIndex,"decision feature index is out of range");
         }
+
+        const unsigned leftChildIndex(_nodes.size());
+        FlatNode& flatNode(_nodes[flatIndex]);
+        flatNode.value = node.decision.right;
+        flatNode.featureIndex = static_cast<uint16_t>(node.decision.left);
+        flatNode.leftChildIndex = leftChildIndex;
+        _nodes.resize(leftChildIndex+2);
+
+        // push the left child last so that it is compiled first, this keeps left-descending paths contiguous:
+        pendingNodes.emplace_back(node.tree.right,leftChildIndex+1);
+        pendingNodes.emplace_back(node.tree.left,leftChildIndex);
     }
 }
 
 
+
 double
 RandomForestModel::
 getProb(
     const featureInput_t& features) const
 {
-    double retval(0);
-    try
+    // get the probability for every tree and average them out.
+    double prob(0);
+    for (unsigned treeIndex(0); treeIndex < _treeCount; ++treeIndex)
+    {
+        prob += getFlatTreeProb(_nodeData,_rootData[treeIndex],features.data());
+    }
+    return prob/_treeCount;
+}
+
+
+
+void
+RandomForestModel::
+getProbs(
+    const std::vector<featureInput_t>& featureRows,
+    std::vector<double>& probs) const
+{
+    const unsigned rowCount(featureRows.size());
+    probs.assign(rowCount,0.);
+
+    // trees are summed in the same order as getProb, so batched and single row scores are identical:
+    for (unsigned treeIndex(0); treeIndex < _treeCount; ++treeIndex)
     {
-        // get the probability for every tree and average them out.
-        double prob(0);
-        for (const DecisionTree& dtree : _forest)
+        const unsigned rootIndex(_rootData[treeIndex]);
+        for (unsigned rowIndex(0); rowIndex < rowCount; ++rowIndex)
         {
-            prob += getDecisionTreeProb(features, dtree);
+            probs[rowIndex] += getFlatTreeProb(_nodeData,rootIndex,featureRows[rowIndex].data());
         }
-        retval = prob/_forest.size();
     }
-    catch (...)
+
+    for (double& prob : probs)
     {
-//        log_os << "Exception caught in random forest while scoring features:\n";
-//        for (const auto val : features)
-//        {
-//            log_os << "K:V " << val.first << " : " << val.second << "\n";
-//        }
-        throw;
+        prob /= _treeCount;
     }
-    return retval;
 }
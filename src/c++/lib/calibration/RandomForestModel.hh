@@ -28,23 +28,88 @@
 #include "json/json.h"
 
 #include <cassert>
+#include <cstdint>
 
 #include <map>
 #include <vector>
 
 struct RandomForestModel : public VariantScoringModelBase
 {
+    /// compiled form of a single tree node
+    ///
+    /// The two children of each decision node are stored adjacently, so the right child index is
+    /// always leftChildIndex+1, and children always follow their parent in the node array. The
+    /// threshold is kept in double precision so that compiled scores exactly match the json model.
+    ///
+    /// This layout is also the on-disk node format of binary scoring model files.
+    struct FlatNode
+    {
+        /// decision threshold, or the vote fraction for leaf nodes
+        double value = 0;
+        uint32_t leftChildIndex = 0;
+        uint16_t featureIndex = leafFeatureIndex;
+        uint16_t padding = 0;
+
+        static const uint16_t leafFeatureIndex = 0xFFFF;
+    };
+
     RandomForestModel() {}
 
+    RandomForestModel(const RandomForestModel&) = delete;
+    RandomForestModel& operator=(const RandomForestModel&) = delete;
+
     bool isInit() const
     {
-        return (! _forest.empty());
+        return (_treeCount != 0);
     }
 
     double getProb(const featureInput_t& features) const override;
 
+    /// score all feature rows, traversing the forest one tree at a time so that each tree's nodes stay
+    /// in cache across the whole batch
+    void
+    getProbs(
+        const std::vector<featureInput_t>& featureRows,
+        std::vector<double>& probs) const override;
+
     void Deserialize(const unsigned expectedFeatureCount, const Json::Value& root);
 
+    /// use a compiled forest stored outside of this object, such as a memory mapped binary model file
+    ///
+    /// The forest is validated against expectedFeatureCount and the node layout rules of FlatNode. The
+    /// node and root arrays must outlive this object.
+    void
+    setExternalForest(
+        const unsigned expectedFeatureCount,
+        const FlatNode* nodes,
+        const uint64_t nodeCount,
+        const uint32_t* treeRootIndex,
+        const unsigned treeCount);
+
+    const FlatNode*
+    getNodes() const
+    {
+        return _nodeData;
+    }
+
+    uint64_t
+    getNodeCount() const
+    {
+        return _nodeCount;
+    }
+
+    const uint32_t*
+    getTreeRootIndex() const
+    {
+        return _rootData;
+    }
+
+    unsigned
+    getTreeCount() const
+    {
+        return _treeCount;
+    }
+
 private:
     template <typename L, typename R>
     struct TreeNode
@@ -82,17 +147,54 @@ private:
         const Json::Value& v,
         TreeNode<L,R>& val);
 
+    /// append the nodes of a parsed tree to the flat node array
+    void
+    compileTree(
+        const DecisionTree& dtree);
+
+    static
     double
-    getDecisionTreeProb(
-        const featureInput_t& features,
-        const DecisionTree& dtree) const;
+    getFlatTreeProb(
+        const FlatNode* nodes,
+        const unsigned rootIndex,
+        const double* features)
+    {
+        const FlatNode* node(nodes+rootIndex);
+        while (node->featureIndex != FlatNode::leafFeatureIndex)
+        {
+            // written as 'not <=' so that NaN features follow the right branch, as in the json model
+            node = nodes + node->leftChildIndex + (not (features[node->featureIndex] <= node->value));
+        }
+        return node->value;
+    }
+
+    /// point the forest accessors at the internally owned node arrays
+    void
+    useOwnedForest()
+    {
+        _nodeData = _nodes.data();
+        _nodeCount = _nodes.size();
+        _rootData = _treeRootIndex.data();
+        _treeCount = _treeRootIndex.size();
+    }
 
     void
     clear()
     {
-        _forest.clear();
+        _nodes.clear();
+        _treeRootIndex.clear();
+        useOwnedForest();
     }
 
 ////////data:
-    std::vector<DecisionTree> _forest;
+    std::vector<FlatNode> _nodes;
+    std::vector<uint32_t> _treeRootIndex;
+
+    // the forest used for scoring, this points either to the vectors above or to external storage:
+    const FlatNode* _nodeData = nullptr;
+    uint64_t _nodeCount = 0;
+    const uint32_t* _rootData = nullptr;
+    unsigned _treeCount = 0;
 };
+
+static_assert(sizeof(RandomForestModel::FlatNode) == 16, "Unexpected random forest node size");
@@ -35,5 +35,21 @@ struct VariantScoringModelBase : public PolymorphicObject
     virtual
     double
     getProb(const featureInput_t& features) const = 0;
+
+    /// score a batch of feature vectors, probs[i] is set to getProb(featureRows[i])
+    ///
+    /// models may override this with an evaluation order which is more efficient for large batches
+    virtual
+    void
+    getProbs(
+        const std::vector<featureInput_t>& featureRows,
+        std::vector<double>& probs) const
+    {
+        probs.clear();
+        for (const featureInput_t& features : featureRows)
+        {
+            probs.push_back(getProb(features));
+        }
+    }
 };
 
@@ -120,6 +120,17 @@ VariantScoringModelMetadata::
 Deserialize(
     const featureMap_t& featureMap,
     const Json::Value& root)
+{
+    Deserialize(root);
+    validateFeatures(featureMap);
+}
+
+
+
+void
+VariantScoringModelMetadata::
+Deserialize(
+    const Json::Value& root)
 {
     using namespace SMODEL_ENTRY_TYPE;
     date  = Clean_string(root[get_label(DATE)].asString());
@@ -134,16 +145,29 @@ Deserialize(
         probScale = caliRoot.get("Scale", probScale).asDouble();
     }
 
-    // read and validate features:
+    // read features:
     const Json::Value featureRoot = root[get_label(FEATURES)];
     assert(!featureRoot.isNull());
 
+    featureNames.clear();
+    for (const auto& val : featureRoot)
+    {
+        featureNames.push_back(val.asString());
+    }
+}
+
+
+
+void
+VariantScoringModelMetadata::
+validateFeatures(
+    const featureMap_t& featureMap) const
+{
     const auto fend(featureMap.end());
 
     unsigned expectedIndex=0;
-    for (const auto& val : featureRoot)
+    for (const std::string& fname : featureNames)
     {
-        const std::string fname(val.asString());
         const auto fiter(featureMap.find(fname));
         if (fiter == fend)
         {
@@ -163,10 +187,10 @@ Deserialize(
         {
             bool isFirst(true);
             oss << "\tModelfile features: {";
-            for (const auto& val : featureRoot)
+            for (const std::string& fname : featureNames)
             {
                 if (not isFirst) oss << ",";
-                oss << val.asString();
+                oss << fname;
                 isFirst=false;
             }
             oss << "}\n";
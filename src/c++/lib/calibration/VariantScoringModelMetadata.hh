@@ -27,6 +27,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 
 /// parse common meta-data format shared for all variant scoring models
@@ -41,6 +42,14 @@ struct VariantScoringModelMetadata
         const featureMap_t& featureMap,
         const Json::Value& root);
 
+    /// parse metadata without checking the model features against a client feature map
+    void Deserialize(
+        const Json::Value& root);
+
+    /// check that the model features exactly match the client feature map
+    void validateFeatures(
+        const featureMap_t& featureMap) const;
+
     std::string date;
     std::string ModelType;
 
@@ -52,5 +61,8 @@ struct VariantScoringModelMetadata
 
     /// \TODO Doc this. what is the orientation of this number? <,>,<=,>=? Does it mean filter stuff to remove or to keep?
     double filterCutoff;
+
+    /// model feature names in feature index order
+    std::vector<std::string> featureNames;
 };
 
@@ -56,6 +56,28 @@ VariantScoringModelServer(
     const SCORING_CALL_TYPE::index_t callType,
     const SCORING_VARIANT_TYPE::index_t variantType)
 {
+    if (BinaryScoringModelFile::isBinaryScoringModelFile(model_file))
+    {
+        try
+        {
+            _binaryModelFile.reset(new BinaryScoringModelFile(model_file));
+            std::unique_ptr<RandomForestModel> rfModel(new RandomForestModel());
+            if (not _binaryModelFile->getModel(callType, variantType, _meta, *rfModel))
+            {
+                modelParseError(model_file, std::string(SCORING_CALL_TYPE::get_label(callType)) + "/" +
+                                SCORING_VARIANT_TYPE::get_label(variantType));
+            }
+            _meta.validateFeatures(featureMap);
+            _model = std::move(rfModel);
+        }
+        catch (...)
+        {
+            log_os << "Exception caught while attempting to load binary scoring model file '" << model_file << "'\n";
+            throw;
+        }
+        return;
+    }
+
     Json::Value root;
     {
         std::ifstream file(model_file , std::ifstream::binary);
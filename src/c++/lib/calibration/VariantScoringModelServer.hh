@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include "BinaryScoringModelFile.hh"
 #include "VariantScoringModelBase.hh"
 #include "VariantScoringModelMetadata.hh"
 #include "VariantScoringModelTypes.hh"
@@ -31,6 +32,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <vector>
 
 
 /// client interface to variant scoring models specified by file at runtime
@@ -39,6 +41,8 @@ struct VariantScoringModelServer
 {
     /// \param featureMap Names of features supported in the client code, each feature
     ///                   name should be mapped to a feature index number.
+    /// \param model_file Scoring model file in either json or binary scoring model format. Binary
+    ///                   model files are memory mapped and shared with other processes.
     VariantScoringModelServer(
         const VariantScoringModelMetadata::featureMap_t& featureMap,
         const std::string& model_file,
@@ -51,7 +55,20 @@ struct VariantScoringModelServer
         const VariantScoringModelBase::featureInput_t& features) const
     {
 
-        return std::max(0.,std::min(1.,(_meta.probScale * std::pow(_model->getProb(features), _meta.probPow))));
+        return calibrateProb(_model->getProb(features));
+    }
+
+    /// score a batch of variants, scores[i] is set to scoreVariant(featureRows[i])
+    void
+    scoreVariants(
+        const std::vector<VariantScoringModelBase::featureInput_t>& featureRows,
+        std::vector<double>& scores) const
+    {
+        _model->getProbs(featureRows,scores);
+        for (double& score : scores)
+        {
+            score = calibrateProb(score);
+        }
     }
 
     double scoreFilterThreshold() const
@@ -60,6 +77,15 @@ struct VariantScoringModelServer
     }
 
 private:
+    double
+    calibrateProb(const double prob) const
+    {
+        return std::max(0.,std::min(1.,(_meta.probScale * std::pow(prob, _meta.probPow))));
+    }
+
     VariantScoringModelMetadata _meta;
+
+    // a binary model file is mapped for the lifetime of the model which points into it:
+    std::unique_ptr<BinaryScoringModelFile> _binaryModelFile;
     std::unique_ptr<VariantScoringModelBase> _model;
 };
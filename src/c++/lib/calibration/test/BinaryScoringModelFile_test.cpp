@@ -0,0 +1,136 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#include "boost/test/unit_test.hpp"
+
+#include "blt_util/Fnv1aChecksum.hh"
+#include "blt_util/test/TestTempPath.hh"
+#include "calibration/BinaryScoringModelFile.hh"
+#include "calibration/VariantScoringModelServer.hh"
+
+#include "boost/filesystem.hpp"
+
+#include <fstream>
+#include <stdexcept>
+
+
+BOOST_AUTO_TEST_SUITE( test_BinaryScoringModelFile )
+
+
+static const char* testModelFile = R"({
+"CalibrationModels" : {
+    "Germline" : {
+        "SNP" : {
+            "Date" : "2016.09.01",
+            "ModelType" : "RandomForest",
+            "FilterCutoff" : 0.6,
+            "Calibration" : { "Power" : 2.0, "Scale" : 1.5 },
+            "Features" : [ "F0", "F1" ],
+            "Model" : [
+                {
+                    "tree" : { "0" : [1, 2], "1" : [-1, -1], "2" : [3, 4], "3" : [-1, -1], "4" : [-1, -1] },
+                    "node_votes" : { "0" : [0, 0], "1" : [3, 1], "2" : [0, 0], "3" : [1, 1], "4" : [0, 4] },
+                    "decisions" : { "0" : [0, 0.5], "2" : [1, 2.0] }
+                },
+                {
+                    "tree" : { "0" : [-1, -1] },
+                    "node_votes" : { "0" : [1, 3] },
+                    "decisions" : {}
+                }
+            ]
+        }
+    }
+}
+})";
+
+
+
+BOOST_AUTO_TEST_CASE( test_BinaryScoringModelRoundTrip )
+{
+    const TestTempPath jsonFile;
+    const TestTempPath binaryFile;
+    {
+        std::ofstream ofs(jsonFile.path);
+        ofs << testModelFile;
+    }
+
+    convertScoringModelFile(jsonFile.path, binaryFile.path);
+    BOOST_REQUIRE(BinaryScoringModelFile::isBinaryScoringModelFile(binaryFile.path));
+    BOOST_REQUIRE(! BinaryScoringModelFile::isBinaryScoringModelFile(jsonFile.path));
+
+    uint64_t jsonSize(0);
+    const uint64_t jsonChecksum(getFileChecksum(jsonFile.path, jsonSize));
+    {
+        const BinaryScoringModelFile binaryModel(binaryFile.path);
+        BOOST_REQUIRE_EQUAL(binaryModel.header().sourceChecksum, jsonChecksum);
+        BOOST_REQUIRE_EQUAL(binaryModel.header().sourceSize, jsonSize);
+
+        VariantScoringModelMetadata meta;
+        RandomForestModel model;
+        BOOST_REQUIRE(! binaryModel.getModel(SCORING_CALL_TYPE::GERMLINE, SCORING_VARIANT_TYPE::INDEL, meta, model));
+        BOOST_REQUIRE(binaryModel.getModel(SCORING_CALL_TYPE::GERMLINE, SCORING_VARIANT_TYPE::SNV, meta, model));
+        BOOST_REQUIRE_EQUAL(meta.date, "2016.09.01");
+        BOOST_REQUIRE_EQUAL(meta.ModelType, "RandomForest");
+        BOOST_REQUIRE_EQUAL(meta.filterCutoff, 0.6);
+        BOOST_REQUIRE_EQUAL(meta.featureNames.size(), 2u);
+        BOOST_REQUIRE_EQUAL(meta.featureNames[1], "F1");
+        BOOST_REQUIRE_EQUAL(model.getTreeCount(), 2u);
+    }
+
+    // binary and json models should produce identical scores through the server interface:
+    const VariantScoringModelMetadata::featureMap_t featureMap = { {"F0", 0}, {"F1", 1} };
+    const VariantScoringModelServer jsonServer(featureMap, jsonFile.path, SCORING_CALL_TYPE::GERMLINE, SCORING_VARIANT_TYPE::SNV);
+    const VariantScoringModelServer binaryServer(featureMap, binaryFile.path, SCORING_CALL_TYPE::GERMLINE, SCORING_VARIANT_TYPE::SNV);
+    BOOST_REQUIRE_EQUAL(jsonServer.scoreFilterThreshold(), binaryServer.scoreFilterThreshold());
+
+    const std::vector<VariantScoringModelBase::featureInput_t> rows = { { 0.2, 10.0 }, { 0.6, 2.0 }, { 0.6, 3.0 } };
+    for (const auto& row : rows)
+    {
+        BOOST_REQUIRE_EQUAL(jsonServer.scoreVariant(row), binaryServer.scoreVariant(row));
+    }
+    BOOST_REQUIRE_EQUAL(binaryServer.scoreVariant(rows[1]), (1.5*0.375*0.375));
+
+    // binary models are checked against the client feature map as well:
+    const VariantScoringModelMetadata::featureMap_t badFeatureMap = { {"F0", 0}, {"F2", 1} };
+    BOOST_REQUIRE_THROW(VariantScoringModelServer(badFeatureMap, binaryFile.path, SCORING_CALL_TYPE::GERMLINE, SCORING_VARIANT_TYPE::SNV), std::exception);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_BinaryScoringModelTruncated )
+{
+    const TestTempPath jsonFile;
+    const TestTempPath binaryFile;
+    {
+        std::ofstream ofs(jsonFile.path);
+        ofs << testModelFile;
+    }
+    convertScoringModelFile(jsonFile.path, binaryFile.path);
+
+    // truncate the node array of the binary model:
+    boost::filesystem::resize_file(binaryFile.path, boost::filesystem::file_size(binaryFile.path)-8);
+
+    const BinaryScoringModelFile binaryModel(binaryFile.path);
+    VariantScoringModelMetadata meta;
+    RandomForestModel model;
+    BOOST_REQUIRE_THROW(binaryModel.getModel(SCORING_CALL_TYPE::GERMLINE, SCORING_VARIANT_TYPE::SNV, meta, model), std::exception);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,125 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#include "boost/test/unit_test.hpp"
+
+#include "calibration/RandomForestModel.hh"
+
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+
+BOOST_AUTO_TEST_SUITE( test_RandomForestModel )
+
+
+static
+Json::Value
+parseJson(const char* jsonString)
+{
+    Json::Value root;
+    std::istringstream iss(jsonString);
+    iss >> root;
+    return root;
+}
+
+
+
+/// two tree forest: the first tree splits on feature 0 then feature 1, the second tree is a single leaf
+static const char* testForest = R"({
+"Model" : [
+    {
+        "tree" : { "0" : [1, 2], "2" : [3, 4], "1" : [-1, -1], "3" : [-1, -1], "4" : [-1, -1] },
+        "node_votes" : { "0" : [0, 0], "1" : [3, 1], "2" : [0, 0], "3" : [1, 1], "4" : [0, 4] },
+        "decisions" : { "0" : [0, 0.5], "2" : [1, 2.0] }
+    },
+    {
+        "tree" : { "0" : [-1, -1] },
+        "node_votes" : { "0" : [1, 3] },
+        "decisions" : {}
+    }
+]
+})";
+
+
+
+BOOST_AUTO_TEST_CASE( test_RandomForestModelProb )
+{
+    RandomForestModel model;
+    model.Deserialize(2, parseJson(testForest));
+    BOOST_REQUIRE(model.isInit());
+
+    static const double nan(std::numeric_limits<double>::quiet_NaN());
+    const std::vector<VariantScoringModelBase::featureInput_t> rows =
+    {
+        { 0.2, 10.0 },
+        { 0.5, 10.0 },
+        { 0.6, 2.0 },
+        { 0.6, 3.0 },
+        { nan, 1.0 }
+    };
+    const std::vector<double> expectedProbs = { 0.5, 0.5, 0.375, 0.125, 0.375 };
+
+    for (unsigned rowIndex(0); rowIndex < rows.size(); ++rowIndex)
+    {
+        BOOST_REQUIRE_EQUAL(model.getProb(rows[rowIndex]), expectedProbs[rowIndex]);
+    }
+
+    std::vector<double> probs;
+    model.getProbs(rows, probs);
+    BOOST_REQUIRE_EQUAL(probs.size(), rows.size());
+    for (unsigned rowIndex(0); rowIndex < rows.size(); ++rowIndex)
+    {
+        BOOST_REQUIRE_EQUAL(probs[rowIndex], expectedProbs[rowIndex]);
+    }
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_RandomForestModelBadTree )
+{
+    // feature index beyond the expected feature count:
+    {
+        RandomForestModel model;
+        BOOST_REQUIRE_THROW(model.Deserialize(1, parseJson(testForest)), std::exception);
+    }
+
+    // leaf node without votes:
+    {
+        static const char* missingVote = R"({ "Model" : [ {
+            "tree" : { "0" : [1, 2], "1" : [-1, -1], "2" : [-1, -1] },
+            "node_votes" : { "1" : [1, 1] },
+            "decisions" : { "0" : [0, 0.5] } } ] })";
+        RandomForestModel model;
+        BOOST_REQUIRE_THROW(model.Deserialize(1, parseJson(missingVote)), std::exception);
+    }
+
+    // child link back to the root:
+    {
+        static const char* cycle = R"({ "Model" : [ {
+            "tree" : { "0" : [1, 0], "1" : [-1, -1] },
+            "node_votes" : { "1" : [1, 1] },
+            "decisions" : { "0" : [0, 0.5] } } ] })";
+        RandomForestModel model;
+        BOOST_REQUIRE_THROW(model.Deserialize(1, parseJson(cycle)), std::exception);
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
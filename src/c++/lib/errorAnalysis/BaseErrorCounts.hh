@@ -94,6 +94,7 @@ operator<<(std::ostream& os, const StrandBaseCounts& sbc);
 
 
 struct BaseErrorContextObservationData;
+struct SequenceErrorCountsFileAccess;
 
 
 /// basecalls are input by strand, but once compressed
@@ -139,6 +140,7 @@ struct BaseErrorContextObservation
 
 private:
     friend BaseErrorContextObservationData;
+    friend SequenceErrorCountsFileAccess;
 
     StrandBaseCounts strand0;
     StrandBaseCounts strand1;
@@ -274,6 +276,7 @@ public:
 
 private:
     friend BaseErrorData;
+    friend SequenceErrorCountsFileAccess;
 
     // value is number of observations:
     data_t data;
@@ -376,6 +379,8 @@ public:
     }
 
 private:
+    friend SequenceErrorCountsFileAccess;
+
     data_t::iterator
     getContextIterator(
         const BaseErrorContext& context);
@@ -38,6 +38,8 @@
 #include <set>
 
 
+struct SequenceErrorCountsFileAccess;
+
 namespace INDEL_TYPE
 {
 enum index_t
@@ -224,6 +226,8 @@ public:
     }
 
 private:
+    friend SequenceErrorCountsFileAccess;
+
     // value is number of observations:
     std::map<IndelBackgroundObservation,unsigned> data;
 };
@@ -356,6 +360,8 @@ public:
     }
 
 private:
+    friend SequenceErrorCountsFileAccess;
+
     // value is number of observations:
     std::map<IndelErrorContextObservation,unsigned> data;
 };
@@ -481,6 +487,8 @@ public:
     }
 
 private:
+    friend SequenceErrorCountsFileAccess;
+
     data_t::iterator
     getContextIterator(
         const IndelErrorContext& context);
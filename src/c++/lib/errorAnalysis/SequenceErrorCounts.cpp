@@ -23,9 +23,9 @@
 ///
 
 #include "SequenceErrorCounts.hh"
+#include "SequenceErrorCountsFile.hh"
 
 #include "boost/archive/binary_iarchive.hpp"
-#include "boost/archive/binary_oarchive.hpp"
 
 #include <fstream>
 #include <iostream>
@@ -47,14 +47,8 @@ SequenceErrorCounts::
 save(
     const char* filename) const
 {
-    using namespace boost::archive;
-
     assert(nullptr != filename);
-    std::ofstream ofs(filename, std::ios::binary);
-    binary_oarchive oa(ofs);
-
-    oa << _bases;
-    oa << _indels;
+    writeSequenceErrorCountsFile(*this, filename);
 }
 
 
@@ -66,9 +60,15 @@ load(
 {
     using namespace boost::archive;
 
-    clear();
-
     assert(nullptr != filename);
+    if (isSequenceErrorCountsFile(filename))
+    {
+        readSequenceErrorCountsFile(filename, *this);
+        return;
+    }
+
+    // read the boost archive format written by earlier versions:
+    clear();
     std::ifstream ifs(filename, std::ios::binary);
     binary_iarchive ia(ifs);
 
@@ -71,9 +71,12 @@ struct SequenceErrorCounts
         _indels.clear();
     }
 
+    /// save counts in the sequence error counts file format, see SequenceErrorCountsFile.hh
     void
     save(const char* filename) const;
 
+    /// load counts from either the sequence error counts file format or the boost archive format written by
+    /// earlier versions of save()
     void
     load(const char* filename);
 
@@ -0,0 +1,1222 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#include "SequenceErrorCountsFile.hh"
+#include "SequenceErrorCounts.hh"
+
+#include "common/Exceptions.hh"
+
+#include "boost/filesystem.hpp"
+#include "boost/utility.hpp"
+
+#include <cassert>
+#include <cstring>
+
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <sstream>
+
+
+
+/// provides the file format code with access to the private members of the counts objects, in the same way
+/// that boost::serialization::access does for the archive format
+///
+struct SequenceErrorCountsFileAccess
+{
+    template <typename T>
+    static
+    auto
+    getStrand(
+        T& obs,
+        const unsigned strandIndex) -> decltype((obs.strand0))
+    {
+        return ((strandIndex == 0) ? obs.strand0 : obs.strand1);
+    }
+
+    template <typename T>
+    static
+    auto
+    getData(T& observationData) -> decltype((observationData.data))
+    {
+        return observationData.data;
+    }
+
+    static
+    BaseErrorContextObservationData::refQual_t&
+    getRefQuals(BaseErrorContextObservationData& observationData)
+    {
+        return observationData.refQuals;
+    }
+
+    template <typename T>
+    static
+    auto
+    getContextData(T& counts) -> decltype((counts._data))
+    {
+        return counts._data;
+    }
+};
+
+
+
+using namespace SequenceErrorCountsFileFormat;
+
+
+
+namespace
+{
+
+typedef SequenceErrorCountsFileAccess Access;
+
+
+void
+throwFileError(
+    const std::string& filename,
+    const char* msg)
+{
+    using namespace illumina::common;
+
+    std::ostringstream oss;
+    oss << "ERROR: " << msg << " in sequence error counts file: '" << filename << "'";
+    BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+}
+
+
+
+void
+appendVarint(
+    std::string& buffer,
+    uint64_t val)
+{
+    while (val >= 0x80)
+    {
+        buffer.push_back(static_cast<char>((val & 0x7f) | 0x80));
+        val >>= 7;
+    }
+    buffer.push_back(static_cast<char>(val));
+}
+
+
+
+/// decode one varint from [begin,end), advancing begin
+///
+/// \return false if the varint is not complete or too long
+bool
+decodeVarint(
+    const char*& begin,
+    const char* end,
+    uint64_t& val)
+{
+    val = 0;
+    for (unsigned shift(0); (shift < 64) && (begin != end); shift += 7)
+    {
+        const uint8_t byte(*begin++);
+        val |= (static_cast<uint64_t>(byte & 0x7f) << shift);
+        if (! (byte & 0x80)) return true;
+    }
+    return false;
+}
+
+
+
+struct CountsFileWriter : private boost::noncopyable
+{
+    explicit
+    CountsFileWriter(const std::string& filename)
+        : _filename(filename),
+          _ofs(filename, std::ios::binary)
+    {
+        if (! _ofs)
+        {
+            using namespace illumina::common;
+
+            std::ostringstream oss;
+            oss << "ERROR: Can't open sequence error counts output file: '" << filename << "'";
+            BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+        }
+        writeBytes(magic, sizeof(magic));
+        writeVarint(formatVersion);
+    }
+
+    void
+    writeVarint(const uint64_t val)
+    {
+        _buffer.clear();
+        appendVarint(_buffer, val);
+        writeBytes(_buffer.data(), _buffer.size());
+    }
+
+    /// doubles are written as 8 byte native IEEE values
+    void
+    writeDouble(const double val)
+    {
+        static_assert(sizeof(val) == 8, "Unexpected double size");
+        writeBytes(reinterpret_cast<const char*>(&val), sizeof(val));
+    }
+
+    void
+    writeBytes(
+        const char* data,
+        const uint64_t size)
+    {
+        _ofs.write(data, size);
+    }
+
+    void
+    close()
+    {
+        _ofs.close();
+        if (! _ofs)
+        {
+            throwFileError(_filename, "Failed to write output");
+        }
+    }
+
+private:
+    std::string _filename;
+    std::ofstream _ofs;
+    std::string _buffer;
+};
+
+
+
+struct CountsFileReader : private boost::noncopyable
+{
+    explicit
+    CountsFileReader(const std::string& filename)
+        : _filename(filename),
+          _ifs(filename, std::ios::binary)
+    {
+        if (! _ifs)
+        {
+            throwFileError(filename, "Can't open input");
+        }
+
+        char fileMagic[sizeof(magic)];
+        if ((not readBytes(fileMagic, sizeof(fileMagic))) or
+            (std::memcmp(fileMagic, magic, sizeof(magic)) != 0))
+        {
+            throwFileError(filename, "Unrecognized header");
+        }
+        if (readVarint() != formatVersion)
+        {
+            throwFileError(filename, "Unsupported format version");
+        }
+    }
+
+    const std::string&
+    filename() const
+    {
+        return _filename;
+    }
+
+    uint64_t
+    readVarint()
+    {
+        uint64_t val(0);
+        for (unsigned shift(0); shift < 64; shift += 7)
+        {
+            const int byte(_ifs.rdbuf()->sbumpc());
+            if (byte == std::char_traits<char>::eof())
+            {
+                throwFileError(_filename, "Unexpected end of file");
+            }
+            val |= (static_cast<uint64_t>(byte & 0x7f) << shift);
+            if (! (byte & 0x80)) return val;
+        }
+        throwFileError(_filename, "Invalid integer encoding");
+        return 0;
+    }
+
+    double
+    readDouble()
+    {
+        double val;
+        if (not readBytes(reinterpret_cast<char*>(&val), sizeof(val)))
+        {
+            throwFileError(_filename, "Unexpected end of file");
+        }
+        return val;
+    }
+
+    /// \return false if the file ends before size bytes are read
+    bool
+    readBytes(
+        char* data,
+        const uint64_t size)
+    {
+        return (_ifs.rdbuf()->sgetn(data, size) == static_cast<std::streamsize>(size));
+    }
+
+    /// \return true if the next entry of the current section is a context, false at the end of the section
+    bool
+    readSectionTag()
+    {
+        const uint64_t tag(readVarint());
+        if (tag > CONTEXT_TAG)
+        {
+            throwFileError(_filename, "Invalid section tag");
+        }
+        return (tag == CONTEXT_TAG);
+    }
+
+private:
+    std::string _filename;
+    std::ifstream _ifs;
+};
+
+
+
+/// buffer the records of one table block column by column
+///
+struct ColumnBlockWriter
+{
+    explicit
+    ColumnBlockWriter(const unsigned columnCount)
+        : _columns(columnCount)
+    {}
+
+    /// add the leading sort key of the next record to the first column
+    void
+    putKey(const uint64_t val)
+    {
+        assert(val >= _lastKey);
+        appendVarint(_columns[0], (val-_lastKey));
+        _lastKey = val;
+    }
+
+    void
+    put(
+        const unsigned columnIndex,
+        const uint64_t val)
+    {
+        assert((columnIndex > 0) && (columnIndex < _columns.size()));
+        appendVarint(_columns[columnIndex], val);
+    }
+
+    void
+    endRecord()
+    {
+        _recordCount++;
+    }
+
+    unsigned
+    recordCount() const
+    {
+        return _recordCount;
+    }
+
+    /// write the block and clear it for the next set of records
+    void
+    write(CountsFileWriter& writer)
+    {
+        assert(_recordCount > 0);
+        writer.writeVarint(_recordCount);
+        for (std::string& column : _columns)
+        {
+            writer.writeVarint(column.size());
+            writer.writeBytes(column.data(), column.size());
+            column.clear();
+        }
+        _recordCount = 0;
+        _lastKey = 0;
+    }
+
+private:
+    std::vector<std::string> _columns;
+    unsigned _recordCount = 0;
+    uint64_t _lastKey = 0;
+};
+
+
+
+/// decode the records of one table block column by column
+///
+struct ColumnBlockReader
+{
+    explicit
+    ColumnBlockReader(const unsigned columnCount)
+        : _columns(columnCount),
+          _cursors(columnCount)
+    {}
+
+    /// read the next block of the current table
+    ///
+    /// \return false at the end of the table
+    bool
+    read(CountsFileReader& reader)
+    {
+        _filenamePtr = &(reader.filename());
+        const uint64_t recordCount(reader.readVarint());
+        if (recordCount > blockRecordCount)
+        {
+            throwError("Invalid table block size");
+        }
+        _recordCount = recordCount;
+        if (_recordCount == 0) return false;
+
+        const unsigned columnCount(_columns.size());
+        for (unsigned columnIndex(0); columnIndex < columnCount; ++columnIndex)
+        {
+            std::string& column(_columns[columnIndex]);
+            const uint64_t columnSize(reader.readVarint());
+
+            // each value takes at least one byte, so this bounds the column buffer by the block record count:
+            if (columnSize > (static_cast<uint64_t>(_recordCount)*maxColumnBytesPerRecord))
+            {
+                throwError("Invalid table column size");
+            }
+            column.resize(columnSize);
+            if ((columnSize > 0) && (not reader.readBytes(&column[0], columnSize)))
+            {
+                throwError("Unexpected end of file");
+            }
+            _cursors[columnIndex] = column.data();
+        }
+        _lastKey = 0;
+        return true;
+    }
+
+    unsigned
+    recordCount() const
+    {
+        return _recordCount;
+    }
+
+    /// get the leading sort key of the next record from the first column
+    template <typename T>
+    T
+    getKey()
+    {
+        _lastKey += get<uint64_t>(0);
+        return checkRange<T>(_lastKey);
+    }
+
+    template <typename T>
+    T
+    get(const unsigned columnIndex)
+    {
+        const std::string& column(_columns[columnIndex]);
+        const char*& cursor(_cursors[columnIndex]);
+        uint64_t val(0);
+        if (not decodeVarint(cursor, (column.data()+column.size()), val))
+        {
+            throwError("Invalid table column");
+        }
+        return checkRange<T>(val);
+    }
+
+    void
+    throwError(const char* msg) const
+    {
+        assert(nullptr != _filenamePtr);
+        throwFileError(*_filenamePtr, msg);
+    }
+
+private:
+    template <typename T>
+    T
+    checkRange(const uint64_t val) const
+    {
+        if (val > std::numeric_limits<T>::max())
+        {
+            throwError("Out of range table value");
+        }
+        return static_cast<T>(val);
+    }
+
+    /// upper bound on the encoded size of one record in a column, which allows for the alt quality columns of
+    /// the base error table, each of which can hold up to one value per quality level
+    static const uint64_t maxColumnBytesPerRecord = 10*(std::numeric_limits<uint16_t>::max()+1);
+
+    std::vector<std::string> _columns;
+    std::vector<const char*> _cursors;
+    unsigned _recordCount = 0;
+    uint64_t _lastKey = 0;
+    const std::string* _filenamePtr = nullptr;
+};
+
+
+
+/// table of compressed basecall observations in a base error context
+struct BaseErrorTableCodec
+{
+    typedef BaseErrorContextObservation key_type;
+    typedef unsigned value_type;
+
+    enum column_t
+    {
+        STRAND0_REF_COUNT,
+        STRAND0_ALT_SIZE,
+        STRAND0_ALT_QUAL,
+        STRAND0_ALT_COUNT,
+        STRAND1_REF_COUNT,
+        STRAND1_ALT_SIZE,
+        STRAND1_ALT_QUAL,
+        STRAND1_ALT_COUNT,
+        OBSERVATION_COUNT,
+        COLUMN_COUNT
+    };
+
+    static
+    void
+    encode(
+        const key_type& key,
+        const value_type& value,
+        ColumnBlockWriter& block)
+    {
+        for (unsigned strandIndex(0); strandIndex < 2; ++strandIndex)
+        {
+            const StrandBaseCounts& strand(Access::getStrand(key, strandIndex));
+            const unsigned columnOffset(strandIndex*(STRAND1_REF_COUNT-STRAND0_REF_COUNT));
+            if (strandIndex == 0)
+            {
+                block.putKey(strand.refCount);
+            }
+            else
+            {
+                block.put(STRAND1_REF_COUNT, strand.refCount);
+            }
+            block.put(columnOffset+STRAND0_ALT_SIZE, strand.alt.size());
+            for (const auto& qualCount : strand.alt)
+            {
+                block.put(columnOffset+STRAND0_ALT_QUAL, qualCount.first);
+                block.put(columnOffset+STRAND0_ALT_COUNT, qualCount.second);
+            }
+        }
+        block.put(OBSERVATION_COUNT, value);
+    }
+
+    static
+    void
+    decode(
+        ColumnBlockReader& block,
+        key_type& key,
+        value_type& value)
+    {
+        for (unsigned strandIndex(0); strandIndex < 2; ++strandIndex)
+        {
+            StrandBaseCounts& strand(Access::getStrand(key, strandIndex));
+            const unsigned columnOffset(strandIndex*(STRAND1_REF_COUNT-STRAND0_REF_COUNT));
+            if (strandIndex == 0)
+            {
+                strand.refCount = block.getKey<unsigned>();
+            }
+            else
+            {
+                strand.refCount = block.get<unsigned>(STRAND1_REF_COUNT);
+            }
+            strand.alt.clear();
+            const unsigned altSize(block.get<uint16_t>(columnOffset+STRAND0_ALT_SIZE));
+            for (unsigned altIndex(0); altIndex < altSize; ++altIndex)
+            {
+                const uint16_t qual(block.get<uint16_t>(columnOffset+STRAND0_ALT_QUAL));
+                strand.alt.insert(strand.alt.end(),
+                                  std::make_pair(qual, block.get<unsigned>(columnOffset+STRAND0_ALT_COUNT)));
+            }
+        }
+        value = block.get<value_type>(OBSERVATION_COUNT);
+    }
+};
+
+
+
+/// table of reference basecall counts by quality in a base error context
+struct RefQualTableCodec
+{
+    typedef uint16_t key_type;
+    typedef uint64_t value_type;
+
+    enum column_t
+    {
+        QUAL,
+        COUNT,
+        COLUMN_COUNT
+    };
+
+    static
+    void
+    encode(
+        const key_type& key,
+        const value_type& value,
+        ColumnBlockWriter& block)
+    {
+        block.putKey(key);
+        block.put(COUNT, value);
+    }
+
+    static
+    void
+    decode(
+        ColumnBlockReader& block,
+        key_type& key,
+        value_type& value)
+    {
+        key = block.getKey<key_type>();
+        value = block.get<value_type>(COUNT);
+    }
+};
+
+
+
+GENOTYPE_STATUS::genotype_t
+getGenotypeStatus(
+    ColumnBlockReader& block,
+    const unsigned columnIndex)
+{
+    const unsigned status(block.get<unsigned>(columnIndex));
+    if (status >= GENOTYPE_STATUS::SIZE)
+    {
+        block.throwError("Invalid genotype status");
+    }
+    return static_cast<GENOTYPE_STATUS::genotype_t>(status);
+}
+
+
+
+/// table of background depth observations in an indel error context
+struct IndelBackgroundTableCodec
+{
+    typedef IndelBackgroundObservation key_type;
+    typedef unsigned value_type;
+
+    enum column_t
+    {
+        DEPTH,
+        STATUS,
+        OBSERVATION_COUNT,
+        COLUMN_COUNT
+    };
+
+    static
+    void
+    encode(
+        const key_type& key,
+        const value_type& value,
+        ColumnBlockWriter& block)
+    {
+        block.putKey(key.depth);
+        block.put(STATUS, key.backgroundStatus);
+        block.put(OBSERVATION_COUNT, value);
+    }
+
+    static
+    void
+    decode(
+        ColumnBlockReader& block,
+        key_type& key,
+        value_type& value)
+    {
+        key.depth = block.getKey<unsigned>();
+        key.backgroundStatus = getGenotypeStatus(block, STATUS);
+        value = block.get<value_type>(OBSERVATION_COUNT);
+    }
+};
+
+
+
+/// table of indel signal observations in an indel error context
+struct IndelErrorTableCodec
+{
+    typedef IndelErrorContextObservation key_type;
+    typedef unsigned value_type;
+
+    enum column_t
+    {
+        REF_COUNT,
+        SIGNAL_COUNT,
+        STATUS = SIGNAL_COUNT+INDEL_SIGNAL_TYPE::SIZE,
+        OBSERVATION_COUNT,
+        COLUMN_COUNT
+    };
+
+    static
+    void
+    encode(
+        const key_type& key,
+        const value_type& value,
+        ColumnBlockWriter& block)
+    {
+        block.putKey(key.refCount);
+        for (unsigned signalIndex(0); signalIndex < INDEL_SIGNAL_TYPE::SIZE; ++signalIndex)
+        {
+            block.put(SIGNAL_COUNT+signalIndex, key.signalCounts[signalIndex]);
+        }
+        block.put(STATUS, key.variantStatus);
+        block.put(OBSERVATION_COUNT, value);
+    }
+
+    static
+    void
+    decode(
+        ColumnBlockReader& block,
+        key_type& key,
+        value_type& value)
+    {
+        key.refCount = block.getKey<unsigned>();
+        for (unsigned signalIndex(0); signalIndex < INDEL_SIGNAL_TYPE::SIZE; ++signalIndex)
+        {
+            key.signalCounts[signalIndex] = block.get<unsigned>(SIGNAL_COUNT+signalIndex);
+        }
+        key.variantStatus = getGenotypeStatus(block, STATUS);
+        value = block.get<value_type>(OBSERVATION_COUNT);
+    }
+};
+
+
+
+template <typename Codec>
+struct TableWriter
+{
+    explicit
+    TableWriter(CountsFileWriter& writer)
+        : _writer(writer),
+          _block(Codec::COLUMN_COUNT)
+    {}
+
+    void
+    add(
+        const typename Codec::key_type& key,
+        const typename Codec::value_type& value)
+    {
+        Codec::encode(key, value, _block);
+        _block.endRecord();
+        if (_block.recordCount() >= blockRecordCount) _block.write(_writer);
+    }
+
+    /// write any buffered records and the end of the table
+    void
+    finish()
+    {
+        if (_block.recordCount() > 0) _block.write(_writer);
+        _writer.writeVarint(0);
+    }
+
+private:
+    CountsFileWriter& _writer;
+    ColumnBlockWriter _block;
+};
+
+
+
+template <typename Codec>
+struct TableReader
+{
+    explicit
+    TableReader(CountsFileReader& reader)
+        : _reader(reader),
+          _block(Codec::COLUMN_COUNT)
+    {}
+
+    /// \return false at the end of the table
+    bool
+    next(
+        typename Codec::key_type& key,
+        typename Codec::value_type& value)
+    {
+        if (_isEnd) return false;
+        if (_recordIndex >= _block.recordCount())
+        {
+            if (not _block.read(_reader))
+            {
+                _isEnd = true;
+                return false;
+            }
+            _recordIndex = 0;
+        }
+        Codec::decode(_block, key, value);
+        _recordIndex++;
+        return true;
+    }
+
+private:
+    CountsFileReader& _reader;
+    ColumnBlockReader _block;
+    unsigned _recordIndex = 0;
+    bool _isEnd = false;
+};
+
+
+
+template <typename Codec, typename M>
+void
+writeTable(
+    CountsFileWriter& writer,
+    const M& table)
+{
+    TableWriter<Codec> tableWriter(writer);
+    for (const auto& val : table)
+    {
+        tableWriter.add(val.first, val.second);
+    }
+    tableWriter.finish();
+}
+
+
+
+template <typename Codec, typename M>
+void
+readTable(
+    CountsFileReader& reader,
+    M& table)
+{
+    TableReader<Codec> tableReader(reader);
+    typename Codec::key_type key;
+    typename Codec::value_type value;
+    while (tableReader.next(key, value))
+    {
+        table.insert(table.end(), std::make_pair(key, value));
+    }
+}
+
+
+
+/// merge the current table of each input into one output table
+///
+/// records with equal keys are summed in input order
+template <typename Codec>
+void
+mergeTable(
+    const std::vector<CountsFileReader*>& inputs,
+    CountsFileWriter& writer)
+{
+    typedef typename Codec::key_type key_type;
+    typedef typename Codec::value_type value_type;
+
+    const unsigned inputCount(inputs.size());
+    std::vector<TableReader<Codec>> tableReaders;
+    tableReaders.reserve(inputCount);
+    std::vector<key_type> keys(inputCount);
+    std::vector<value_type> values(inputCount);
+
+    // order inputs by their next key, and then by input index:
+    auto isAfter = [&](const unsigned index1, const unsigned index2)
+    {
+        if (keys[index2] < keys[index1]) return true;
+        if (keys[index1] < keys[index2]) return false;
+        return (index1 > index2);
+    };
+    std::priority_queue<unsigned, std::vector<unsigned>, decltype(isAfter)> inputQueue(isAfter);
+
+    auto nextRecord = [&](const unsigned inputIndex)
+    {
+        if (tableReaders[inputIndex].next(keys[inputIndex], values[inputIndex])) inputQueue.push(inputIndex);
+    };
+
+    for (unsigned inputIndex(0); inputIndex < inputCount; ++inputIndex)
+    {
+        tableReaders.emplace_back(*inputs[inputIndex]);
+        nextRecord(inputIndex);
+    }
+
+    TableWriter<Codec> tableWriter(writer);
+    key_type key;
+    while (not inputQueue.empty())
+    {
+        unsigned inputIndex(inputQueue.top());
+        inputQueue.pop();
+        key = keys[inputIndex];
+        value_type value(values[inputIndex]);
+        nextRecord(inputIndex);
+
+        while ((not inputQueue.empty()) and (not (key < keys[inputQueue.top()])))
+        {
+            inputIndex = inputQueue.top();
+            inputQueue.pop();
+            value += values[inputIndex];
+            nextRecord(inputIndex);
+        }
+        tableWriter.add(key, value);
+    }
+    tableWriter.finish();
+}
+
+
+
+struct BaseErrorSection
+{
+    typedef BaseErrorCounts counts_type;
+    typedef BaseErrorContext context_type;
+    typedef BaseErrorData data_type;
+
+    static
+    void
+    writeContext(
+        CountsFileWriter& writer,
+        const context_type& context)
+    {
+        writer.writeVarint(context.repeatCount);
+    }
+
+    static
+    void
+    readContext(
+        CountsFileReader& reader,
+        context_type& context)
+    {
+        context.repeatCount = reader.readVarint();
+    }
+
+    static
+    void
+    writeHeader(
+        CountsFileWriter& writer,
+        const data_type& data)
+    {
+        writer.writeVarint(data.excludedRegionSkipped);
+        writer.writeVarint(data.depthSkipped);
+        writer.writeVarint(data.emptySkipped);
+        writer.writeVarint(data.noiseSkipped);
+    }
+
+    static
+    void
+    readHeader(
+        CountsFileReader& reader,
+        data_type& data)
+    {
+        data.excludedRegionSkipped = reader.readVarint();
+        data.depthSkipped = reader.readVarint();
+        data.emptySkipped = reader.readVarint();
+        data.noiseSkipped = reader.readVarint();
+    }
+
+    static
+    void
+    writeTables(
+        CountsFileWriter& writer,
+        const data_type& data)
+    {
+        writeTable<BaseErrorTableCodec>(writer, Access::getData(data.error));
+        writeTable<RefQualTableCodec>(writer, data.error.getRefQuals());
+    }
+
+    static
+    void
+    readTables(
+        CountsFileReader& reader,
+        data_type& data)
+    {
+        readTable<BaseErrorTableCodec>(reader, Access::getData(data.error));
+        readTable<RefQualTableCodec>(reader, Access::getRefQuals(data.error));
+    }
+
+    static
+    void
+    mergeTables(
+        const std::vector<CountsFileReader*>& inputs,
+        CountsFileWriter& writer)
+    {
+        mergeTable<BaseErrorTableCodec>(inputs, writer);
+        mergeTable<RefQualTableCodec>(inputs, writer);
+    }
+};
+
+
+
+struct IndelErrorSection
+{
+    typedef IndelErrorCounts counts_type;
+    typedef IndelErrorContext context_type;
+    typedef IndelErrorData data_type;
+
+    static
+    void
+    writeContext(
+        CountsFileWriter& writer,
+        const context_type& context)
+    {
+        writer.writeVarint(context.repeatCount);
+    }
+
+    static
+    void
+    readContext(
+        CountsFileReader& reader,
+        context_type& context)
+    {
+        context.repeatCount = reader.readVarint();
+    }
+
+    static
+    void
+    writeHeader(
+        CountsFileWriter& writer,
+        const data_type& data)
+    {
+        writer.writeVarint(data.excludedRegionSkipped);
+        writer.writeVarint(data.depthSkipped);
+        writer.writeDouble(data.depthSupport.depth);
+        writer.writeDouble(data.depthSupport.supportCount);
+    }
+
+    static
+    void
+    readHeader(
+        CountsFileReader& reader,
+        data_type& data)
+    {
+        data.excludedRegionSkipped = reader.readVarint();
+        data.depthSkipped = reader.readVarint();
+        data.depthSupport.depth = reader.readDouble();
+        data.depthSupport.supportCount = reader.readDouble();
+    }
+
+    static
+    void
+    writeTables(
+        CountsFileWriter& writer,
+        const data_type& data)
+    {
+        writeTable<IndelBackgroundTableCodec>(writer, Access::getData(data.background));
+        writeTable<IndelErrorTableCodec>(writer, Access::getData(data.error));
+    }
+
+    static
+    void
+    readTables(
+        CountsFileReader& reader,
+        data_type& data)
+    {
+        readTable<IndelBackgroundTableCodec>(reader, Access::getData(data.background));
+        readTable<IndelErrorTableCodec>(reader, Access::getData(data.error));
+    }
+
+    static
+    void
+    mergeTables(
+        const std::vector<CountsFileReader*>& inputs,
+        CountsFileWriter& writer)
+    {
+        mergeTable<IndelBackgroundTableCodec>(inputs, writer);
+        mergeTable<IndelErrorTableCodec>(inputs, writer);
+    }
+};
+
+
+
+template <typename Section>
+void
+writeSection(
+    CountsFileWriter& writer,
+    const typename Section::counts_type& counts)
+{
+    for (const auto& val : counts)
+    {
+        writer.writeVarint(CONTEXT_TAG);
+        Section::writeContext(writer, val.first);
+        Section::writeHeader(writer, val.second);
+        Section::writeTables(writer, val.second);
+    }
+    writer.writeVarint(END_TAG);
+}
+
+
+
+template <typename Section>
+void
+readSection(
+    CountsFileReader& reader,
+    typename Section::counts_type& counts)
+{
+    auto& contextData(Access::getContextData(counts));
+    while (reader.readSectionTag())
+    {
+        typename Section::context_type context;
+        Section::readContext(reader, context);
+        typename Section::data_type& data(contextData[context]);
+        Section::readHeader(reader, data);
+        Section::readTables(reader, data);
+    }
+}
+
+
+
+/// merge the current section of each input into one output section
+///
+/// contexts are merged in sort order, and each context is merged from only those inputs which contain it
+template <typename Section>
+void
+mergeSection(
+    const std::vector<CountsFileReader*>& inputs,
+    CountsFileWriter& writer)
+{
+    typedef typename Section::context_type context_type;
+    typedef typename Section::data_type data_type;
+
+    const unsigned inputCount(inputs.size());
+    std::vector<bool> isContext(inputCount);
+    std::vector<context_type> contexts(inputCount);
+
+    auto nextContext = [&](const unsigned inputIndex)
+    {
+        isContext[inputIndex] = inputs[inputIndex]->readSectionTag();
+        if (isContext[inputIndex]) Section::readContext(*inputs[inputIndex], contexts[inputIndex]);
+    };
+
+    for (unsigned inputIndex(0); inputIndex < inputCount; ++inputIndex)
+    {
+        nextContext(inputIndex);
+    }
+
+    std::vector<unsigned> contextInputIndices;
+    std::vector<CountsFileReader*> contextInputs;
+    while (true)
+    {
+        const context_type* minContextPtr(nullptr);
+        for (unsigned inputIndex(0); inputIndex < inputCount; ++inputIndex)
+        {
+            if (not isContext[inputIndex]) continue;
+            if ((nullptr == minContextPtr) or (contexts[inputIndex] < *minContextPtr))
+            {
+                minContextPtr = &(contexts[inputIndex]);
+            }
+        }
+        if (nullptr == minContextPtr) break;
+        const context_type context(*minContextPtr);
+
+        contextInputIndices.clear();
+        contextInputs.clear();
+        data_type mergedHeader;
+        for (unsigned inputIndex(0); inputIndex < inputCount; ++inputIndex)
+        {
+            if ((not isContext[inputIndex]) or (context < contexts[inputIndex])) continue;
+            data_type inputHeader;
+            Section::readHeader(*inputs[inputIndex], inputHeader);
+            mergedHeader.merge(inputHeader);
+            contextInputIndices.push_back(inputIndex);
+            contextInputs.push_back(inputs[inputIndex]);
+        }
+
+        writer.writeVarint(CONTEXT_TAG);
+        Section::writeContext(writer, context);
+        Section::writeHeader(writer, mergedHeader);
+        Section::mergeTables(contextInputs, writer);
+
+        for (const unsigned inputIndex : contextInputIndices)
+        {
+            nextContext(inputIndex);
+        }
+    }
+    writer.writeVarint(END_TAG);
+}
+
+
+}
+
+
+
+bool
+isSequenceErrorCountsFile(const std::string& filename)
+{
+    std::ifstream ifs(filename, std::ios::binary);
+    char fileMagic[sizeof(magic)];
+    if (not ifs.read(fileMagic, sizeof(fileMagic))) return false;
+    return (std::memcmp(fileMagic, magic, sizeof(magic)) == 0);
+}
+
+
+
+void
+writeSequenceErrorCountsFile(
+    const SequenceErrorCounts& counts,
+    const std::string& filename)
+{
+    CountsFileWriter writer(filename);
+    writeSection<BaseErrorSection>(writer, counts.getBaseCounts());
+    writeSection<IndelErrorSection>(writer, counts.getIndelCounts());
+    writer.close();
+}
+
+
+
+void
+readSequenceErrorCountsFile(
+    const std::string& filename,
+    SequenceErrorCounts& counts)
+{
+    counts.clear();
+    CountsFileReader reader(filename);
+    readSection<BaseErrorSection>(reader, counts.getBaseCounts());
+    readSection<IndelErrorSection>(reader, counts.getIndelCounts());
+}
+
+
+
+/// \param[in] mergeLevel number of intermediate merge levels above this one, used to give the intermediate files
+///                       of each level distinct names
+static
+void
+mergeSequenceErrorCountsFilesLevel(
+    const std::vector<std::string>& inputFilenames,
+    const std::string& outputFilename,
+    const unsigned maxInputCount,
+    const unsigned mergeLevel)
+{
+    assert(not inputFilenames.empty());
+    assert(maxInputCount > 1);
+
+    if (inputFilenames.size() > maxInputCount)
+    {
+        std::vector<std::string> groupFilenames;
+        const unsigned inputCount(inputFilenames.size());
+        for (unsigned groupStart(0); groupStart < inputCount; groupStart += maxInputCount)
+        {
+            const unsigned groupEnd(std::min(groupStart+maxInputCount, inputCount));
+            const std::vector<std::string> groupInputs(inputFilenames.begin()+groupStart,
+                                                       inputFilenames.begin()+groupEnd);
+            std::ostringstream oss;
+            oss << outputFilename << ".mergeLevel" << mergeLevel << "Group" << groupFilenames.size() << ".tmp";
+            groupFilenames.push_back(oss.str());
+            mergeSequenceErrorCountsFilesLevel(groupInputs, groupFilenames.back(), maxInputCount, mergeLevel);
+        }
+        mergeSequenceErrorCountsFilesLevel(groupFilenames, outputFilename, maxInputCount, mergeLevel+1);
+        for (const std::string& groupFilename : groupFilenames)
+        {
+            boost::filesystem::remove(groupFilename);
+        }
+        return;
+    }
+
+    std::vector<std::unique_ptr<CountsFileReader>> readers;
+    std::vector<CountsFileReader*> inputs;
+    for (const std::string& inputFilename : inputFilenames)
+    {
+        readers.emplace_back(new CountsFileReader(inputFilename));
+        inputs.push_back(readers.back().get());
+    }
+
+    CountsFileWriter writer(outputFilename);
+    mergeSection<BaseErrorSection>(inputs, writer);
+    mergeSection<IndelErrorSection>(inputs, writer);
+    writer.close();
+}
+
+
+
+void
+mergeSequenceErrorCountsFiles(
+    const std::vector<std::string>& inputFilenames,
+    const std::string& outputFilename,
+    const unsigned maxInputCount)
+{
+    mergeSequenceErrorCountsFilesLevel(inputFilenames, outputFilename, maxInputCount, 0);
+}
@@ -0,0 +1,87 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#pragma once
+
+#include <string>
+#include <vector>
+
+
+struct SequenceErrorCounts;
+
+
+/// Sequence error counts files hold the content of SequenceErrorCounts in a compact format which can be merged
+/// without loading each input file into memory.
+///
+/// File layout, all integers are unsigned LEB128 varints unless noted otherwise:
+///
+/// 1. magic (8 bytes), format version
+/// 2. base error section: a series of context records, each starting with a context tag, ended by the end tag
+/// 3. indel error section: as above
+///
+/// Each context record is a header (the context and its scalar counts) followed by the context's observation
+/// tables. Each table is a series of blocks holding up to blockRecordCount records, ended by a zero record
+/// count. Within a block the records are stored column by column, and each column is preceded by its byte size.
+///
+/// Contexts and table records are stored in the sort order of their in-memory maps. The first column of every
+/// table is the leading sort key of its records, and is delta-encoded within each block.
+///
+namespace SequenceErrorCountsFileFormat
+{
+static const char magic[8] = { 'S', 'T', 'K', 'S', 'E', 'C', 'N', 'T' };
+static const unsigned formatVersion = 1;
+static const unsigned blockRecordCount = 4096;
+
+enum sectionTag
+{
+    END_TAG,
+    CONTEXT_TAG
+};
+}
+
+
+/// \return true if filename is a sequence error counts file, false for any other file, including the boost
+///         archive format used by earlier versions of SequenceErrorCounts::save
+bool
+isSequenceErrorCountsFile(const std::string& filename);
+
+void
+writeSequenceErrorCountsFile(
+    const SequenceErrorCounts& counts,
+    const std::string& filename);
+
+/// replace the content of counts with the content of a sequence error counts file
+void
+readSequenceErrorCountsFile(
+    const std::string& filename,
+    SequenceErrorCounts& counts);
+
+/// merge sequence error counts files into one output file
+///
+/// Inputs are merged context by context and block by block, so that memory use depends on the number of input
+/// files but not on their size. The output is identical to loading and merging all inputs in memory and saving
+/// the result.
+///
+/// \param[in] maxInputCount limit on the number of files open at once, larger merges are made from intermediate
+///                          merges of input groups, written next to the output file
+void
+mergeSequenceErrorCountsFiles(
+    const std::vector<std::string>& inputFilenames,
+    const std::string& outputFilename,
+    const unsigned maxInputCount = 256);
@@ -0,0 +1,214 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#include "boost/test/unit_test.hpp"
+
+#include "SequenceErrorCounts.hh"
+#include "SequenceErrorCountsFile.hh"
+
+#include "blt_util/test/TestTempPath.hh"
+#include "common/Exceptions.hh"
+
+#include "boost/archive/binary_oarchive.hpp"
+#include "boost/filesystem.hpp"
+
+#include <fstream>
+#include <iterator>
+
+
+BOOST_AUTO_TEST_SUITE( SequenceErrorCountsFile_test )
+
+
+static
+std::string
+getFileContent(const std::string& filename)
+{
+    std::ifstream ifs(filename, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+}
+
+
+
+/// fill counts with a test pattern which varies with seed
+///
+/// \param indelErrorCount number of distinct indel error observations to add, set this above the file block size
+///                        to test reading and merging across table blocks
+static
+void
+addTestCounts(
+    const unsigned seed,
+    const unsigned indelErrorCount,
+    SequenceErrorCounts& counts)
+{
+    for (unsigned repeatCount(1); repeatCount <= (2+seed); ++repeatCount)
+    {
+        BaseErrorContext baseContext;
+        baseContext.repeatCount = repeatCount;
+        for (unsigned siteIndex(0); siteIndex < 20; ++siteIndex)
+        {
+            BaseErrorContextInputObservation siteObservation;
+            for (unsigned readIndex(0); readIndex < (siteIndex+seed); ++readIndex)
+            {
+                siteObservation.addRefCount((readIndex%2) == 0, 20+(readIndex%3)*10);
+            }
+            if ((siteIndex%3) == seed%3)
+            {
+                siteObservation.addAltCount(true, 15+siteIndex);
+                siteObservation.addAltCount(false, 35);
+            }
+            counts.getBaseCounts().addSiteObservation(baseContext, siteObservation);
+        }
+        counts.getBaseCounts().addDepthSkip(baseContext);
+        if (repeatCount == seed) counts.getBaseCounts().addNoiseSkip(baseContext);
+
+        IndelErrorContext indelContext;
+        indelContext.repeatCount = repeatCount;
+        for (unsigned obsIndex(0); obsIndex < indelErrorCount; ++obsIndex)
+        {
+            IndelErrorContextObservation errorObservation;
+            errorObservation.refCount = obsIndex/3;
+            errorObservation.signalCounts[obsIndex%INDEL_SIGNAL_TYPE::SIZE] = 1+seed;
+            errorObservation.variantStatus = ((obsIndex%5) == 0) ? GENOTYPE_STATUS::HET : GENOTYPE_STATUS::UNKNOWN;
+            counts.getIndelCounts().addError(indelContext, errorObservation, 30+obsIndex);
+
+            IndelBackgroundObservation backgroundObservation;
+            backgroundObservation.depth = obsIndex%50;
+            backgroundObservation.backgroundStatus = GENOTYPE_STATUS::UNKNOWN;
+            counts.getIndelCounts().addBackground(indelContext, backgroundObservation);
+        }
+        counts.getIndelCounts().addExcludedRegionSkip(indelContext);
+    }
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_roundTrip )
+{
+    SequenceErrorCounts counts;
+    addTestCounts(1, 5000, counts);
+
+    const TestTempPath file1(".counts");
+    counts.save(file1.path.c_str());
+    BOOST_REQUIRE(isSequenceErrorCountsFile(file1.path));
+
+    SequenceErrorCounts counts2;
+    counts2.load(file1.path.c_str());
+
+    const TestTempPath file2(".counts");
+    counts2.save(file2.path.c_str());
+    BOOST_REQUIRE(getFileContent(file1.path) == getFileContent(file2.path));
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_loadArchive )
+{
+    SequenceErrorCounts counts;
+    addTestCounts(2, 100, counts);
+
+    const TestTempPath archiveFile(".counts");
+    {
+        std::ofstream ofs(archiveFile.path, std::ios::binary);
+        boost::archive::binary_oarchive oa(ofs);
+        oa << counts.getBaseCounts();
+        oa << counts.getIndelCounts();
+    }
+    BOOST_REQUIRE(not isSequenceErrorCountsFile(archiveFile.path));
+
+    SequenceErrorCounts archiveCounts;
+    archiveCounts.load(archiveFile.path.c_str());
+
+    const TestTempPath file1(".counts");
+    const TestTempPath file2(".counts");
+    counts.save(file1.path.c_str());
+    archiveCounts.save(file2.path.c_str());
+    BOOST_REQUIRE(getFileContent(file1.path) == getFileContent(file2.path));
+}
+
+
+
+/// check that a streaming merge of inputCount files, opening at most maxInputCount at once, is identical to an
+/// in-memory merge and leaves no intermediate files behind
+static
+void
+testMerge(
+    const unsigned inputCount,
+    const unsigned maxInputCount)
+{
+    const std::vector<TestTempPath> inputFiles(inputCount);
+    std::vector<std::string> inputFilenames;
+    SequenceErrorCounts mergedCounts;
+    for (unsigned inputIndex(0); inputIndex < inputFiles.size(); ++inputIndex)
+    {
+        SequenceErrorCounts inputCounts;
+        addTestCounts(inputIndex, (inputIndex == 1) ? 5000 : 200, inputCounts);
+        inputCounts.save(inputFiles[inputIndex].path.c_str());
+        inputFilenames.push_back(inputFiles[inputIndex].path);
+        mergedCounts.merge(inputCounts);
+    }
+
+    const TestTempPath expectedFile(".counts");
+    mergedCounts.save(expectedFile.path.c_str());
+
+    const TestTempPath mergeDir;
+    mergeDir.createDirectory();
+    const std::string mergedFilename(mergeDir.file("merged.counts"));
+    mergeSequenceErrorCountsFiles(inputFilenames, mergedFilename, maxInputCount);
+    BOOST_REQUIRE(getFileContent(expectedFile.path) == getFileContent(mergedFilename));
+
+    const unsigned mergeDirFileCount(std::distance(boost::filesystem::directory_iterator(mergeDir.path),
+                                                   boost::filesystem::directory_iterator()));
+    BOOST_REQUIRE_EQUAL(mergeDirFileCount, 1u);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_merge )
+{
+    testMerge(3, 256);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_multiLevelMerge )
+{
+    // with a fan-in of 2, 7 inputs are merged through two levels of intermediate files:
+    testMerge(7, 2);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_truncatedFile )
+{
+    SequenceErrorCounts counts;
+    addTestCounts(1, 100, counts);
+
+    const TestTempPath file(".counts");
+    counts.save(file.path.c_str());
+    const std::string content(getFileContent(file.path));
+    {
+        std::ofstream ofs(file.path, std::ios::binary);
+        ofs.write(content.data(), content.size()/2);
+    }
+
+    SequenceErrorCounts counts2;
+    BOOST_REQUIRE_THROW(counts2.load(file.path.c_str()), illumina::common::ExceptionData);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
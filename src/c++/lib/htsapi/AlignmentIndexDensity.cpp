@@ -0,0 +1,391 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "AlignmentIndexDensity.hh"
+
+#include "blt_util/blt_exception.hh"
+#include "htsapi/bam_streamer.hh"
+
+#include "boost/filesystem.hpp"
+#include "boost/utility.hpp"
+
+#include "zlib.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <sstream>
+
+
+
+static
+void
+indexError(
+    const std::string& indexFilename,
+    const char* msg)
+{
+    std::ostringstream oss;
+    oss << "ERROR: " << msg << " in alignment index file: '" << indexFilename << "'";
+    throw blt_exception(oss.str().c_str());
+}
+
+
+
+namespace
+{
+
+/// minimal reader for the binary and text fields of (optionally gzip compressed) index files
+struct IndexFileReader : private boost::noncopyable
+{
+    explicit
+    IndexFileReader(const std::string& filename)
+        : _filename(filename),
+          _gzfp(gzopen(filename.c_str(), "rb"))
+    {
+        if (nullptr == _gzfp)
+        {
+            indexError(filename, "Can't open file");
+        }
+    }
+
+    ~IndexFileReader()
+    {
+        gzclose(_gzfp);
+    }
+
+    void
+    read(void* data, const unsigned size)
+    {
+        if (gzread(_gzfp, data, size) != static_cast<int>(size))
+        {
+            indexError(_filename, "Unexpected end of file");
+        }
+    }
+
+    /// read a little-endian integer of size bytes
+    uint64_t
+    readUInt(const unsigned size)
+    {
+        assert(size <= 8);
+        uint8_t buffer[8];
+        read(buffer, size);
+        uint64_t val(0);
+        for (unsigned byteIndex(0); byteIndex<size; ++byteIndex)
+        {
+            val |= (static_cast<uint64_t>(buffer[byteIndex]) << (8*byteIndex));
+        }
+        return val;
+    }
+
+    int32_t
+    readInt32()
+    {
+        return static_cast<int32_t>(readUInt(4));
+    }
+
+    /// read a non-negative 32 bit count
+    unsigned
+    readCount()
+    {
+        const int32_t count(readInt32());
+        if (count < 0)
+        {
+            indexError(_filename, "Invalid count");
+        }
+        return count;
+    }
+
+    /// \return false at the end of the file
+    bool
+    readLine(std::string& line)
+    {
+        line.clear();
+        char buffer[4096];
+        while (nullptr != gzgets(_gzfp, buffer, sizeof(buffer)))
+        {
+            line += buffer;
+            if ((! line.empty()) && (line.back() == '\n')) break;
+        }
+        return (! line.empty());
+    }
+
+    const std::string&
+    filename() const
+    {
+        return _filename;
+    }
+
+private:
+    std::string _filename;
+    gzFile _gzfp;
+};
+
+}
+
+
+
+/// find the index of an alignment file, following the same naming conventions as bam_streamer
+static
+std::string
+getIndexFilename(const std::string& alignmentFilename)
+{
+    std::vector<std::string> prefixes = { alignmentFilename };
+    for (const char* ext : { ".bam", ".cram" })
+    {
+        const std::string extension(ext);
+        if ((alignmentFilename.size() > extension.size()) &&
+            (alignmentFilename.compare(alignmentFilename.size()-extension.size(), extension.size(), extension) == 0))
+        {
+            prefixes.push_back(alignmentFilename.substr(0, alignmentFilename.size()-extension.size()));
+        }
+    }
+
+    for (const std::string& prefix : prefixes)
+    {
+        for (const char* indexExtension : { ".bai", ".csi", ".crai" })
+        {
+            const std::string indexFilename(prefix + indexExtension);
+            if (boost::filesystem::exists(indexFilename)) return indexFilename;
+        }
+    }
+
+    std::ostringstream oss;
+    oss << "ERROR: BAM/CRAM index is not available for file: '" << alignmentFilename << "'";
+    throw blt_exception(oss.str().c_str());
+}
+
+
+
+AlignmentIndexDensity::
+AlignmentIndexDensity(const unsigned windowSize)
+    : _windowSize(windowSize)
+{
+    assert(windowSize > 0);
+}
+
+
+
+void
+AlignmentIndexDensity::
+addAlignmentFile(const std::string& alignmentFilename)
+{
+    const std::string indexFilename(getIndexFilename(alignmentFilename));
+
+    // map the contig ids of this file to the shared contig list:
+    std::vector<unsigned> contigIndexMap;
+    {
+        bam_streamer bamStream(alignmentFilename.c_str());
+        const bam_hdr_t& header(bamStream.get_header());
+        for (int32_t tid(0); tid < header.n_targets; ++tid)
+        {
+            const std::string name(header.target_name[tid]);
+            const unsigned length(header.target_len[tid]);
+            const auto iter(_contigIndex.find(name));
+            if (iter == _contigIndex.end())
+            {
+                contigIndexMap.push_back(_contigs.size());
+                _contigIndex.insert(std::make_pair(name, _contigs.size()));
+                _contigs.emplace_back();
+                Contig& contig(_contigs.back());
+                contig.name = name;
+                contig.length = length;
+                contig.windowBytes.resize((length + _windowSize - 1) / _windowSize, 0.);
+            }
+            else
+            {
+                if (_contigs[iter->second].length != length)
+                {
+                    std::ostringstream oss;
+                    oss << "ERROR: Length of contig '" << name << "' in alignment file '" << alignmentFilename
+                        << "' does not match the length in previous alignment files";
+                    throw blt_exception(oss.str().c_str());
+                }
+                contigIndexMap.push_back(iter->second);
+            }
+        }
+    }
+
+    char magic[4];
+    {
+        IndexFileReader reader(indexFilename);
+        reader.read(magic, sizeof(magic));
+    }
+
+    if ((std::memcmp(magic, "BAI\1", sizeof(magic)) == 0) || (std::memcmp(magic, "CSI\1", sizeof(magic)) == 0))
+    {
+        addBinIndex(indexFilename, contigIndexMap);
+    }
+    else
+    {
+        addCramIndex(indexFilename, contigIndexMap);
+    }
+}
+
+
+
+void
+AlignmentIndexDensity::
+addRangeBytes(
+    const unsigned contigIndex,
+    const uint64_t beginPos,
+    uint64_t endPos,
+    const double bytes)
+{
+    Contig& contig(_contigs[contigIndex]);
+    if (contig.windowBytes.empty() || (bytes <= 0.)) return;
+
+    // ranges outside of the contig are clipped to the last contig position:
+    const uint64_t lastPos(contig.length-1);
+    const uint64_t clippedBeginPos(std::min(beginPos, lastPos));
+    endPos = std::min(std::max(endPos, clippedBeginPos+1), lastPos+1);
+
+    const double bytesPerPos(bytes / (endPos - clippedBeginPos));
+    uint64_t windowBeginPos(clippedBeginPos);
+    while (windowBeginPos < endPos)
+    {
+        const uint64_t windowIndex(windowBeginPos / _windowSize);
+        const uint64_t windowEndPos(std::min((windowIndex+1) * _windowSize, endPos));
+        contig.windowBytes[windowIndex] += bytesPerPos * (windowEndPos - windowBeginPos);
+        windowBeginPos = windowEndPos;
+    }
+}
+
+
+
+void
+AlignmentIndexDensity::
+addBinIndex(
+    const std::string& indexFilename,
+    const std::vector<unsigned>& contigIndexMap)
+{
+    IndexFileReader reader(indexFilename);
+
+    char magic[4];
+    reader.read(magic, sizeof(magic));
+    const bool isCsi(std::memcmp(magic, "CSI\1", sizeof(magic)) == 0);
+
+    // BAI has fixed binning parameters, which are given in the header of CSI:
+    int32_t minShift(14);
+    int32_t depth(5);
+    if (isCsi)
+    {
+        minShift = reader.readInt32();
+        depth = reader.readInt32();
+        if ((minShift < 1) || (depth < 0) || ((minShift + 3*depth) > 62))
+        {
+            indexError(indexFilename, "Unsupported binning scheme");
+        }
+        std::vector<char> aux(reader.readCount());
+        if (! aux.empty()) reader.read(aux.data(), aux.size());
+    }
+
+    // bins are numbered from the root level down, followed by one unused bin number and a metadata bin:
+    auto getLevelOffset = [](const int32_t level)
+    {
+        return ((static_cast<uint64_t>(1) << (3*level)) - 1) / 7;
+    };
+    const uint64_t binCountLimit(getLevelOffset(depth+1));
+    const uint64_t metaBin(binCountLimit+1);
+
+    const unsigned refCount(reader.readCount());
+    if (refCount > contigIndexMap.size())
+    {
+        indexError(indexFilename, "More reference sequences than the alignment file header");
+    }
+
+    for (unsigned refIndex(0); refIndex<refCount; ++refIndex)
+    {
+        const unsigned contigIndex(contigIndexMap[refIndex]);
+        const unsigned binCount(reader.readCount());
+        for (unsigned binIndex(0); binIndex<binCount; ++binIndex)
+        {
+            const uint64_t bin(reader.readUInt(4));
+            if (isCsi) reader.readUInt(8);
+
+            double binBytes(0);
+            const unsigned chunkCount(reader.readCount());
+            for (unsigned chunkIndex(0); chunkIndex<chunkCount; ++chunkIndex)
+            {
+                const uint64_t chunkBegin(reader.readUInt(8));
+                const uint64_t chunkEnd(reader.readUInt(8));
+                if ((chunkEnd >> 16) > (chunkBegin >> 16))
+                {
+                    binBytes += ((chunkEnd >> 16) - (chunkBegin >> 16));
+                }
+            }
+
+            if (bin == metaBin) continue;
+            if (bin >= binCountLimit)
+            {
+                indexError(indexFilename, "Invalid bin number");
+            }
+
+            int32_t level(0);
+            while (bin >= getLevelOffset(level+1)) level++;
+            const unsigned binShift(minShift + 3*(depth-level));
+            const uint64_t binBeginPos((bin - getLevelOffset(level)) << binShift);
+            addRangeBytes(contigIndex, binBeginPos, binBeginPos + (static_cast<uint64_t>(1) << binShift), binBytes);
+        }
+
+        // skip the linear index:
+        if (! isCsi)
+        {
+            const unsigned intervalCount(reader.readCount());
+            for (unsigned intervalIndex(0); intervalIndex<intervalCount; ++intervalIndex)
+            {
+                reader.readUInt(8);
+            }
+        }
+    }
+}
+
+
+
+void
+AlignmentIndexDensity::
+addCramIndex(
+    const std::string& indexFilename,
+    const std::vector<unsigned>& contigIndexMap)
+{
+    IndexFileReader reader(indexFilename);
+
+    // each line describes one slice as: refId alignmentStart alignmentSpan containerOffset sliceOffset sliceSize
+    std::string line;
+    while (reader.readLine(line))
+    {
+        std::istringstream iss(line);
+        int64_t refId, alignmentStart, alignmentSpan, containerOffset, sliceOffset, sliceSize;
+        if (! (iss >> refId >> alignmentStart >> alignmentSpan >> containerOffset >> sliceOffset >> sliceSize))
+        {
+            indexError(indexFilename, "Unexpected line format");
+        }
+
+        // skip unmapped slices:
+        if (refId < 0) continue;
+        if (static_cast<uint64_t>(refId) >= contigIndexMap.size())
+        {
+            indexError(indexFilename, "Unknown reference sequence id");
+        }
+
+        const uint64_t beginPos(std::max(alignmentStart-1, static_cast<int64_t>(0)));
+        const uint64_t endPos(beginPos + std::max(alignmentSpan, static_cast<int64_t>(1)));
+        addRangeBytes(contigIndexMap[refId], beginPos, endPos, std::max(sliceSize, static_cast<int64_t>(0)));
+    }
+}
@@ -0,0 +1,96 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#pragma once
+
+#include <cstdint>
+
+#include <map>
+#include <string>
+#include <vector>
+
+
+/// estimate the density of alignment data along the genome from BAM/CRAM index files
+///
+/// The compressed bytes of alignment records in each fixed size window of each contig are estimated without
+/// reading the alignment records themselves: BAI and CSI indices give the file offset range of the records in
+/// each bin, and CRAI indices give the size of each slice. The bytes of any bin or slice which spans several
+/// windows are split between the windows in proportion to their overlap.
+///
+/// BAI and CSI chunk sizes are taken from the compressed part of the virtual file offsets, so these estimates
+/// are only resolved to the size of one BGZF block.
+///
+struct AlignmentIndexDensity
+{
+    struct Contig
+    {
+        std::string name;
+        unsigned length = 0;
+
+        /// estimated bytes in each window of the contig, the last window may be shorter than the window size
+        std::vector<double> windowBytes;
+    };
+
+    explicit
+    AlignmentIndexDensity(const unsigned windowSize);
+
+    /// add the estimated bytes of one BAM or CRAM file
+    ///
+    /// Contigs are matched to those of previously added files by name, any new contigs are appended.
+    /// Throws if no index is found for the file, or the index cannot be parsed.
+    void
+    addAlignmentFile(const std::string& alignmentFilename);
+
+    unsigned
+    getWindowSize() const
+    {
+        return _windowSize;
+    }
+
+    /// all contigs, in the order they first occur in the alignment file headers
+    const std::vector<Contig>&
+    getContigs() const
+    {
+        return _contigs;
+    }
+
+private:
+    /// add bytes to the windows overlapping the zero-indexed contig range [beginPos,endPos)
+    void
+    addRangeBytes(
+        const unsigned contigIndex,
+        const uint64_t beginPos,
+        uint64_t endPos,
+        const double bytes);
+
+    void
+    addBinIndex(
+        const std::string& indexFilename,
+        const std::vector<unsigned>& contigIndexMap);
+
+    void
+    addCramIndex(
+        const std::string& indexFilename,
+        const std::vector<unsigned>& contigIndexMap);
+
+    unsigned _windowSize;
+    std::vector<Contig> _contigs;
+    std::map<std::string,unsigned> _contigIndex;
+};
@@ -0,0 +1,809 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#include "BgzfIndexedOutput.hh"
+
+#include "blt_util/blt_exception.hh"
+#include "blt_util/log.hh"
+
+#include "blt_util/thirdparty_push.h"
+
+extern "C" {
+#include <unistd.h> // this simplifies zlib on windows
+#define __STDC_LIMIT_MACROS
+#include "htslib/bgzf.h"
+#include "htslib/hts.h"
+#include "htslib/kstring.h"
+#include "htslib/tbx.h"
+}
+
+#include "blt_util/thirdparty_pop.h"
+
+#include "boost/filesystem.hpp"
+
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+
+
+static
+uint64_t
+getBlockAddress(BGZF* bgzfPtr)
+{
+    return (bgzf_tell(bgzfPtr) >> 16);
+}
+
+
+
+BgzfIndexedStreamBuf::
+BgzfIndexedStreamBuf(
+    const std::string& filename,
+    const BgzfIndexFragment::index_t format,
+    const int compressionLevel)
+    : _filename(filename),
+      _format(format),
+      _bgzfPtr(nullptr),
+      _buffer(64*1024)
+{
+    using namespace BgzfIndexFragment;
+
+    std::string mode("w");
+    if (compressionLevel >= 0) mode += std::to_string(compressionLevel);
+    _bgzfPtr = bgzf_open(filename.c_str(), mode.c_str());
+    if (nullptr == _bgzfPtr)
+    {
+        std::ostringstream oss;
+        oss << "ERROR: Can't open BGZF output file: '" << filename << "'";
+        throw blt_exception(oss.str().c_str());
+    }
+
+    const std::string fragmentFilename(getFragmentFilename(filename));
+    _fragmentStream.open(fragmentFilename, std::ios::binary);
+    if (! _fragmentStream)
+    {
+        bgzf_close(_bgzfPtr);
+        _bgzfPtr = nullptr;
+
+        std::ostringstream oss;
+        oss << "ERROR: Can't open BGZF index fragment output file: '" << fragmentFilename << "'";
+        throw blt_exception(oss.str().c_str());
+    }
+
+    std::memset(&_fragmentHeader, 0, sizeof(_fragmentHeader));
+    std::memcpy(_fragmentHeader.magic, magic, sizeof(magic));
+    _fragmentHeader.version = formatVersion;
+    _fragmentHeader.format = format;
+
+    // the header is rewritten with final values on close:
+    _fragmentStream.write(reinterpret_cast<const char*>(&_fragmentHeader), sizeof(_fragmentHeader));
+
+    setp(_buffer.data(), _buffer.data()+_buffer.size());
+}
+
+
+
+BgzfIndexedStreamBuf::
+~BgzfIndexedStreamBuf()
+{
+    // only reached without close() if the output is being abandoned:
+    if (nullptr != _bgzfPtr) bgzf_close(_bgzfPtr);
+}
+
+
+
+void
+BgzfIndexedStreamBuf::
+close()
+{
+    using namespace BgzfIndexFragment;
+
+    if (nullptr == _bgzfPtr) return;
+
+    writeCompleteLines();
+    if (pptr() > pbase())
+    {
+        // terminate any final partial line:
+        std::string line(pbase(), pptr());
+        line.push_back('\n');
+        setp(_buffer.data(), _buffer.data()+_buffer.size());
+        writeLine(line.data(), line.data()+line.size());
+    }
+
+    if (bgzf_flush(_bgzfPtr) < 0) throwWriteError();
+    _fragmentHeader.dataEnd = getBlockAddress(_bgzfPtr);
+    if (not _isRecordStarted) _fragmentHeader.headerEnd = _fragmentHeader.dataEnd;
+
+    const int closeStatus(bgzf_close(_bgzfPtr));
+    _bgzfPtr = nullptr;
+    if (closeStatus != 0) throwWriteError();
+
+    _fragmentHeader.contigNameOffset = sizeof(FileHeader) + (_fragmentHeader.recordCount * sizeof(Record));
+    _fragmentHeader.contigCount = _contigNames.size();
+    for (const std::string& name : _contigNames)
+    {
+        _fragmentStream.write(name.c_str(), name.size()+1);
+    }
+    _fragmentStream.seekp(0);
+    _fragmentStream.write(reinterpret_cast<const char*>(&_fragmentHeader), sizeof(_fragmentHeader));
+    _fragmentStream.close();
+    if (! _fragmentStream) throwWriteError();
+}
+
+
+
+BgzfIndexedStreamBuf::int_type
+BgzfIndexedStreamBuf::
+overflow(int_type c)
+{
+    writeCompleteLines();
+    if (pptr() == epptr())
+    {
+        // the buffer holds a single partial line, so expand it:
+        const size_t lineSize(_buffer.size());
+        _buffer.resize(lineSize*2);
+        setp(_buffer.data(), _buffer.data()+_buffer.size());
+        pbump(lineSize);
+    }
+
+    if (not traits_type::eq_int_type(c, traits_type::eof()))
+    {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+    }
+    return traits_type::not_eof(c);
+}
+
+
+
+int
+BgzfIndexedStreamBuf::
+sync()
+{
+    writeCompleteLines();
+    return 0;
+}
+
+
+
+void
+BgzfIndexedStreamBuf::
+writeCompleteLines()
+{
+    const char* lineBegin(pbase());
+    const char* const bufferEnd(pptr());
+    while (true)
+    {
+        const char* lineEnd(static_cast<const char*>(std::memchr(lineBegin, '\n', bufferEnd-lineBegin)));
+        if (nullptr == lineEnd) break;
+        lineEnd++;
+        writeLine(lineBegin, lineEnd);
+        lineBegin = lineEnd;
+    }
+
+    const size_t partialLineSize(bufferEnd-lineBegin);
+    std::memmove(_buffer.data(), lineBegin, partialLineSize);
+    setp(_buffer.data(), _buffer.data()+_buffer.size());
+    pbump(partialLineSize);
+}
+
+
+
+void
+BgzfIndexedStreamBuf::
+writeLine(
+    const char* begin,
+    const char* end)
+{
+    assert(begin < end);
+
+    const bool isHeaderLine(*begin == '#');
+    if (isHeaderLine)
+    {
+        if (not _isRecordStarted) _isHeader = true;
+    }
+    else if (not _isRecordStarted)
+    {
+        // start records in a new block so that the header can be replaced without decompressing any records:
+        if (_isHeader)
+        {
+            if (bgzf_flush(_bgzfPtr) < 0) throwWriteError();
+        }
+        _fragmentHeader.headerEnd = getBlockAddress(_bgzfPtr);
+        _isRecordStarted = true;
+    }
+
+    const ssize_t size(end-begin);
+    if (bgzf_write(_bgzfPtr, begin, size) != size) throwWriteError();
+
+    if (not isHeaderLine) indexLine(begin, end-1);
+}
+
+
+
+/// parse the tabix interval of a line the same way as the tabix vcf and bed presets
+///
+/// \param[in] end points to the line's newline
+/// \return false if the line can't be parsed
+static
+bool
+parseTabixInterval(
+    const BgzfIndexFragment::index_t format,
+    const char* begin,
+    const char* end,
+    const char*& chromBegin,
+    const char*& chromEnd,
+    int64_t& beg,
+    int64_t& endPos)
+{
+    using namespace BgzfIndexFragment;
+
+    chromBegin = nullptr;
+    chromEnd = nullptr;
+    beg = -1;
+    endPos = -1;
+
+    unsigned columnNumber(1);
+    const char* fieldBegin(begin);
+    for (const char* fieldEnd(begin); fieldEnd <= end; ++fieldEnd)
+    {
+        if ((fieldEnd != end) and (*fieldEnd != '\t')) continue;
+
+        if (columnNumber == 1)
+        {
+            chromBegin = fieldBegin;
+            chromEnd = fieldEnd;
+        }
+        else if (columnNumber == 2)
+        {
+            char* parseEnd(nullptr);
+            beg = std::strtol(fieldBegin, &parseEnd, 0);
+            if (parseEnd == fieldBegin) return false;
+            endPos = beg;
+            if (format == VCF)
+            {
+                beg--;
+            }
+            else
+            {
+                endPos++;
+            }
+            if (beg < 0) beg = 0;
+            if (endPos < 1) endPos = 1;
+        }
+        else if (format == VCF)
+        {
+            if (columnNumber == 4)
+            {
+                if (fieldBegin < fieldEnd) endPos = beg + (fieldEnd - fieldBegin);
+            }
+            else if (columnNumber == 8)
+            {
+                static const char endKey[] = "END=";
+                static const unsigned endKeySize(sizeof(endKey)-1);
+                const std::string info(fieldBegin, fieldEnd);
+                size_t endKeyPos(std::string::npos);
+                if (0 == info.compare(0, endKeySize, endKey))
+                {
+                    endKeyPos = endKeySize;
+                }
+                else
+                {
+                    endKeyPos = info.find(";END=");
+                    if (endKeyPos != std::string::npos) endKeyPos += (endKeySize+1);
+                }
+                if (endKeyPos != std::string::npos)
+                {
+                    endPos = std::strtol(info.c_str()+endKeyPos, nullptr, 0);
+                }
+            }
+        }
+        else
+        {
+            if (columnNumber == 3)
+            {
+                char* parseEnd(nullptr);
+                endPos = std::strtol(fieldBegin, &parseEnd, 0);
+                if (parseEnd == fieldBegin) return false;
+            }
+        }
+
+        fieldBegin = fieldEnd+1;
+        columnNumber++;
+    }
+
+    return ((chromBegin != nullptr) and (beg >= 0) and (endPos >= 0));
+}
+
+
+
+void
+BgzfIndexedStreamBuf::
+indexLine(
+    const char* begin,
+    const char* end)
+{
+    using namespace BgzfIndexFragment;
+
+    const char* chromBegin;
+    const char* chromEnd;
+    int64_t beg, endPos;
+    if (not parseTabixInterval(_format, begin, end, chromBegin, chromEnd, beg, endPos))
+    {
+        std::ostringstream oss;
+        oss << "ERROR: Can't parse record interval for BGZF output file '" << _filename << "'. Record: '"
+            << std::string(begin, end) << "'";
+        throw blt_exception(oss.str().c_str());
+    }
+
+    const size_t chromSize(chromEnd-chromBegin);
+    if ((_lastTid < 0) or
+        (_contigNames[_lastTid].size() != chromSize) or
+        (0 != _contigNames[_lastTid].compare(0, chromSize, chromBegin, chromSize)))
+    {
+        const std::string chrom(chromBegin, chromEnd);
+        const auto iter(_contigIndex.find(chrom));
+        if (iter == _contigIndex.end())
+        {
+            _lastTid = _contigNames.size();
+            _contigIndex[chrom] = _lastTid;
+            _contigNames.push_back(chrom);
+        }
+        else
+        {
+            _lastTid = iter->second;
+        }
+    }
+
+    Record record;
+    record.tid = _lastTid;
+    record.beg = beg;
+    record.end = endPos;
+    record.reserved = 0;
+    record.offset = bgzf_tell(_bgzfPtr);
+    _fragmentStream.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    _fragmentHeader.recordCount++;
+}
+
+
+
+void
+BgzfIndexedStreamBuf::
+throwWriteError() const
+{
+    std::ostringstream oss;
+    oss << "ERROR: Failed to write BGZF output file: '" << _filename << "'";
+    throw blt_exception(oss.str().c_str());
+}
+
+
+
+BgzfIndexedOstream::
+BgzfIndexedOstream(
+    const std::string& filename,
+    const BgzfIndexFragment::index_t format,
+    const int compressionLevel)
+    : std::ostream(nullptr),
+      _buf(filename, format, compressionLevel)
+{
+    rdbuf(&_buf);
+
+    // write errors from the streambuf should not be silently turned into stream state:
+    exceptions(std::ios::badbit);
+}
+
+
+
+BgzfIndexedOstream::
+~BgzfIndexedOstream()
+{
+    try
+    {
+        _buf.close();
+    }
+    catch (const std::exception& e)
+    {
+        log_os << e.what() << "\n";
+        log_os << "Failed to close BGZF output file: '" << _buf.filename() << "'\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+
+
+bool
+getBgzfIndexFormat(
+    const std::string& filename,
+    BgzfIndexFragment::index_t& format)
+{
+    using namespace BgzfIndexFragment;
+
+    auto isSuffix = [&](const std::string& suffix)
+    {
+        return ((filename.size() >= suffix.size()) and
+                (0 == filename.compare(filename.size()-suffix.size(), suffix.size(), suffix)));
+    };
+
+    if (isSuffix(".vcf.gz"))
+    {
+        format = VCF;
+    }
+    else if (isSuffix(".bed.gz"))
+    {
+        format = BED;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+
+
+/// read and check the header and contig names of an index fragment file
+static
+void
+readIndexFragmentHeader(
+    const std::string& fragmentFilename,
+    std::ifstream& fragmentStream,
+    BgzfIndexFragment::FileHeader& header,
+    std::vector<std::string>& contigNames)
+{
+    using namespace BgzfIndexFragment;
+
+    auto throwFormatError = [&](const char* msg)
+    {
+        std::ostringstream oss;
+        oss << "ERROR: Invalid BGZF index fragment file '" << fragmentFilename << "': " << msg;
+        throw blt_exception(oss.str().c_str());
+    };
+
+    fragmentStream.open(fragmentFilename, std::ios::binary);
+    if (! fragmentStream)
+    {
+        std::ostringstream oss;
+        oss << "ERROR: Can't open BGZF index fragment file: '" << fragmentFilename << "'";
+        throw blt_exception(oss.str().c_str());
+    }
+
+    fragmentStream.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (! fragmentStream) throwFormatError("truncated header");
+    if (0 != std::memcmp(header.magic, magic, sizeof(magic))) throwFormatError("unexpected file type");
+    if (header.version != formatVersion) throwFormatError("unsupported format version");
+    if ((header.format != VCF) and (header.format != BED)) throwFormatError("unknown index format");
+    if (header.headerEnd > header.dataEnd) throwFormatError("inconsistent segment offsets");
+    if (header.contigNameOffset != (sizeof(FileHeader) + (header.recordCount * sizeof(Record))))
+    {
+        throwFormatError("inconsistent contig name offset");
+    }
+
+    fragmentStream.seekg(header.contigNameOffset);
+    contigNames.clear();
+    for (unsigned contigIndex(0); contigIndex < header.contigCount; ++contigIndex)
+    {
+        contigNames.emplace_back();
+        std::getline(fragmentStream, contigNames.back(), '\0');
+        if (! fragmentStream) throwFormatError("truncated contig names");
+    }
+
+    fragmentStream.seekg(sizeof(FileHeader));
+}
+
+
+
+/// copy the header lines of a segment to the merged output, replacing the cmdline header line if requested
+static
+void
+writeSegmentHeader(
+    const std::string& segmentFilename,
+    const uint64_t headerEnd,
+    const std::string& headerCmdline,
+    BGZF* outputPtr,
+    const std::string& outputFilename)
+{
+    BGZF* segmentPtr(bgzf_open(segmentFilename.c_str(), "r"));
+    if (nullptr == segmentPtr)
+    {
+        std::ostringstream oss;
+        oss << "ERROR: Can't open BGZF segment file: '" << segmentFilename << "'";
+        throw blt_exception(oss.str().c_str());
+    }
+
+    static const std::string cmdlinePrefix("##cmdline=");
+    const std::string cmdlineLine(cmdlinePrefix + headerCmdline + "\n");
+    bool isCmdlineWritten(false);
+
+    bool isError(false);
+    kstring_t str = { 0, 0, nullptr };
+    std::string line;
+    while (getBlockAddress(segmentPtr) < headerEnd)
+    {
+        if (bgzf_getline(segmentPtr, '\n', &str) < 0)
+        {
+            isError = true;
+            break;
+        }
+        line.assign(str.s, str.l);
+        line.push_back('\n');
+
+        if (not headerCmdline.empty())
+        {
+            if (0 == line.compare(0, 2, "##"))
+            {
+                if (0 == line.compare(0, cmdlinePrefix.size(), cmdlinePrefix))
+                {
+                    line = cmdlineLine;
+                    isCmdlineWritten = true;
+                }
+            }
+            else if (not isCmdlineWritten)
+            {
+                line = cmdlineLine + line;
+                isCmdlineWritten = true;
+            }
+        }
+
+        if (bgzf_write(outputPtr, line.data(), line.size()) != static_cast<ssize_t>(line.size()))
+        {
+            std::ostringstream oss;
+            oss << "ERROR: Failed to write merged BGZF file: '" << outputFilename << "'";
+            throw blt_exception(oss.str().c_str());
+        }
+    }
+    free(str.s);
+    bgzf_close(segmentPtr);
+
+    if (isError)
+    {
+        std::ostringstream oss;
+        oss << "ERROR: Can't read header from BGZF segment file: '" << segmentFilename << "'";
+        throw blt_exception(oss.str().c_str());
+    }
+}
+
+
+
+/// copy compressed segment blocks in [beginOffset,endOffset) to the merged output without modification
+static
+void
+copySegmentBlocks(
+    const std::string& segmentFilename,
+    const uint64_t beginOffset,
+    const uint64_t endOffset,
+    BGZF* outputPtr,
+    const std::string& outputFilename)
+{
+    if (beginOffset == endOffset) return;
+
+    std::ifstream segmentStream(segmentFilename, std::ios::binary);
+    segmentStream.seekg(beginOffset);
+
+    std::vector<char> buffer(1024*1024);
+    uint64_t remaining(endOffset-beginOffset);
+    while (remaining > 0)
+    {
+        const uint64_t size(std::min(remaining, static_cast<uint64_t>(buffer.size())));
+        segmentStream.read(buffer.data(), size);
+        if (! segmentStream)
+        {
+            std::ostringstream oss;
+            oss << "ERROR: Can't read BGZF segment file: '" << segmentFilename << "'";
+            throw blt_exception(oss.str().c_str());
+        }
+        if (bgzf_raw_write(outputPtr, buffer.data(), size) != static_cast<ssize_t>(size))
+        {
+            std::ostringstream oss;
+            oss << "ERROR: Failed to write merged BGZF file: '" << outputFilename << "'";
+            throw blt_exception(oss.str().c_str());
+        }
+        remaining -= size;
+    }
+}
+
+
+
+/// create tabix meta data in the same format as tbx_set_meta
+static
+void
+setTabixMeta(
+    const BgzfIndexFragment::index_t format,
+    const std::vector<std::string>& contigNames,
+    hts_idx_t* idx)
+{
+    static_assert(sizeof(tbx_conf_t) == 24, "Unexpected tabix configuration size");
+
+    uint32_t conf[7];
+    std::memcpy(conf, ((format == BgzfIndexFragment::VCF) ? &tbx_conf_vcf : &tbx_conf_bed), sizeof(tbx_conf_t));
+
+    uint32_t nameSize(0);
+    for (const std::string& name : contigNames)
+    {
+        nameSize += name.size()+1;
+    }
+    conf[6] = nameSize;
+    if (ed_is_big())
+    {
+        for (unsigned i(0); i < 7; ++i) conf[i] = ed_swap_4(conf[i]);
+    }
+
+    const unsigned metaSize(sizeof(conf) + nameSize);
+    uint8_t* meta(static_cast<uint8_t*>(malloc(metaSize)));
+    std::memcpy(meta, conf, sizeof(conf));
+    unsigned metaOffset(sizeof(conf));
+    for (const std::string& name : contigNames)
+    {
+        std::memcpy(meta+metaOffset, name.c_str(), name.size()+1);
+        metaOffset += name.size()+1;
+    }
+    hts_idx_set_meta(idx, metaSize, meta, 0);
+}
+
+
+
+void
+mergeBgzfSegments(
+    const std::vector<std::string>& segmentFilenames,
+    const std::string& outputFilename,
+    const std::string& headerCmdline)
+{
+    using namespace BgzfIndexFragment;
+
+    std::unique_ptr<BGZF,int(*)(BGZF*)> output(bgzf_open(outputFilename.c_str(), "w"), bgzf_close);
+    if (! output)
+    {
+        std::ostringstream oss;
+        oss << "ERROR: Can't open merged BGZF output file: '" << outputFilename << "'";
+        throw blt_exception(oss.str().c_str());
+    }
+
+    std::unique_ptr<hts_idx_t,void(*)(hts_idx_t*)> idx(nullptr, hts_idx_destroy);
+    static const int tabixMinShift(14);
+    static const int tabixLevelCount(5);
+
+    bool isFormatSet(false);
+    index_t format(VCF);
+    std::vector<std::string> contigNames;
+    std::unordered_map<std::string,int32_t> contigIndex;
+
+    // compressed offset of the next block in the output file:
+    uint64_t outputOffset(0);
+
+    std::vector<Record> records(4096);
+    for (const std::string& segmentFilename : segmentFilenames)
+    {
+        const std::string fragmentFilename(getFragmentFilename(segmentFilename));
+        std::ifstream fragmentStream;
+        FileHeader header;
+        std::vector<std::string> segmentContigNames;
+        readIndexFragmentHeader(fragmentFilename, fragmentStream, header, segmentContigNames);
+
+        if (not isFormatSet)
+        {
+            format = static_cast<index_t>(header.format);
+            isFormatSet = true;
+        }
+        else if (header.format != format)
+        {
+            std::ostringstream oss;
+            oss << "ERROR: BGZF segment file '" << segmentFilename << "' has a different index format than prior segments";
+            throw blt_exception(oss.str().c_str());
+        }
+
+        if (boost::filesystem::file_size(segmentFilename) < header.dataEnd)
+        {
+            std::ostringstream oss;
+            oss << "ERROR: BGZF segment file '" << segmentFilename << "' is smaller than expected from its index fragment";
+            throw blt_exception(oss.str().c_str());
+        }
+
+        // map segment contig indices to merged file contig indices:
+        std::vector<int32_t> tidMap;
+        for (const std::string& name : segmentContigNames)
+        {
+            const auto iter(contigIndex.find(name));
+            if (iter == contigIndex.end())
+            {
+                tidMap.push_back(contigNames.size());
+                contigIndex[name] = tidMap.back();
+                contigNames.push_back(name);
+            }
+            else
+            {
+                tidMap.push_back(iter->second);
+            }
+        }
+
+        if (header.headerEnd > 0)
+        {
+            const uint64_t headerBegin(getBlockAddress(output.get()));
+            writeSegmentHeader(segmentFilename, header.headerEnd, headerCmdline, output.get(), outputFilename);
+            if (bgzf_flush(output.get()) < 0)
+            {
+                std::ostringstream oss;
+                oss << "ERROR: Failed to write merged BGZF file: '" << outputFilename << "'";
+                throw blt_exception(oss.str().c_str());
+            }
+            outputOffset += (getBlockAddress(output.get()) - headerBegin);
+        }
+
+        if ((header.recordCount > 0) and (! idx))
+        {
+            idx.reset(hts_idx_init(0, HTS_FMT_TBI, (outputOffset << 16), tabixMinShift, tabixLevelCount));
+        }
+
+        uint64_t remainingRecords(header.recordCount);
+        while (remainingRecords > 0)
+        {
+            const uint64_t readCount(std::min(remainingRecords, static_cast<uint64_t>(records.size())));
+            fragmentStream.read(reinterpret_cast<char*>(records.data()), readCount*sizeof(Record));
+            if (! fragmentStream)
+            {
+                std::ostringstream oss;
+                oss << "ERROR: Can't read records from BGZF index fragment file: '" << fragmentFilename << "'";
+                throw blt_exception(oss.str().c_str());
+            }
+
+            for (unsigned recordIndex(0); recordIndex < readCount; ++recordIndex)
+            {
+                const Record& record(records[recordIndex]);
+                const uint64_t blockAddress((record.offset >> 16) - header.headerEnd + outputOffset);
+                const uint64_t offset((blockAddress << 16) | (record.offset & 0xFFFF));
+                if ((record.tid < 0) or (record.tid >= static_cast<int32_t>(tidMap.size())) or
+                    (hts_idx_push(idx.get(), tidMap[record.tid], record.beg, record.end, offset, 1) < 0))
+                {
+                    std::ostringstream oss;
+                    oss << "ERROR: Can't index BGZF segment file '" << segmentFilename
+                        << "', segment records may be unsorted or out of order with respect to prior segments";
+                    throw blt_exception(oss.str().c_str());
+                }
+            }
+            remainingRecords -= readCount;
+        }
+
+        copySegmentBlocks(segmentFilename, header.headerEnd, header.dataEnd, output.get(), outputFilename);
+        outputOffset += (header.dataEnd - header.headerEnd);
+    }
+
+    if (bgzf_close(output.release()) != 0)
+    {
+        std::ostringstream oss;
+        oss << "ERROR: Failed to write merged BGZF file: '" << outputFilename << "'";
+        throw blt_exception(oss.str().c_str());
+    }
+
+    // index positions follow the tabix convention for files without records:
+    if (! idx)
+    {
+        idx.reset(hts_idx_init(0, HTS_FMT_TBI, (outputOffset << 16), tabixMinShift, tabixLevelCount));
+    }
+    hts_idx_finish(idx.get(), (outputOffset << 16));
+    setTabixMeta(format, contigNames, idx.get());
+    if (hts_idx_save(idx.get(), outputFilename.c_str(), HTS_FMT_TBI) != 0)
+    {
+        std::ostringstream oss;
+        oss << "ERROR: Failed to write tabix index for merged BGZF file: '" << outputFilename << "'";
+        throw blt_exception(oss.str().c_str());
+    }
+}
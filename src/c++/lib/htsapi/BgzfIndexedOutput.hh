@@ -0,0 +1,211 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#pragma once
+
+#include <cstdint>
+
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+struct BGZF;
+
+
+/// BGZF index fragments allow tabix indexed files to be created from a series of genome segment files without
+/// decompressing or re-parsing any segment records.
+///
+/// Each segment file is written by BgzfIndexedOstream, which records the tabix interval and virtual file
+/// offset of every record in an index fragment file next to the segment. mergeBgzfSegments() then splices
+/// the compressed segment blocks together and builds the tabix index from the fragments.
+///
+/// Fragment file layout, all integers are in native byte order:
+///
+/// 1. FileHeader
+/// 2. FileHeader::recordCount Record entries
+/// 3. FileHeader::contigCount null terminated contig names, starting at FileHeader::contigNameOffset
+///
+namespace BgzfIndexFragment
+{
+
+static const char magic[8] = { 'S', 'T', 'K', 'I', 'D', 'X', 'F', '\0' };
+static const uint32_t formatVersion = 1;
+
+/// record formats supported by the fragment index, these correspond to the tabix 'vcf' and 'bed' presets
+enum index_t : uint32_t
+{
+    VCF,
+    BED
+};
+
+struct FileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t format;
+
+    /// compressed offset of the first block after the header, the header is always flushed to separate blocks
+    uint64_t headerEnd;
+
+    /// compressed size of the segment file, not including the BGZF EOF block
+    uint64_t dataEnd;
+
+    uint64_t recordCount;
+    uint64_t contigNameOffset;
+    uint32_t contigCount;
+    uint32_t reserved;
+};
+
+/// tabix interval of one record, the contig is an index into the fragment's contig names
+struct Record
+{
+    int32_t tid;
+    int32_t beg;
+    int32_t end;
+    uint32_t reserved;
+
+    /// virtual offset of the end of the record
+    uint64_t offset;
+};
+
+static_assert(sizeof(FileHeader) == 56, "Unexpected index fragment header size");
+static_assert(sizeof(Record) == 24, "Unexpected index fragment record size");
+
+inline
+std::string
+getFragmentFilename(const std::string& filename)
+{
+    return filename + ".idxfrag";
+}
+}
+
+
+
+/// streambuf which writes complete text lines to a BGZF file and records a BGZF index fragment for the file
+///
+/// Lines starting with '#' are treated as header lines. The first record following a header is always started
+/// in a new BGZF block so that the header can be rewritten when segments are merged.
+///
+struct BgzfIndexedStreamBuf : public std::streambuf
+{
+    BgzfIndexedStreamBuf(
+        const std::string& filename,
+        const BgzfIndexFragment::index_t format,
+        const int compressionLevel);
+
+    ~BgzfIndexedStreamBuf();
+
+    /// write any remaining output and close the BGZF and fragment files, throws on any write error
+    void
+    close();
+
+    const std::string&
+    filename() const
+    {
+        return _filename;
+    }
+
+protected:
+    int_type
+    overflow(int_type c) override;
+
+    int
+    sync() override;
+
+private:
+    /// write all complete lines in the put area to the BGZF file, and shift any partial line to the front
+    void
+    writeCompleteLines();
+
+    /// \param[in] end points to the end of the line, including the newline
+    void
+    writeLine(
+        const char* begin,
+        const char* end);
+
+    void
+    indexLine(
+        const char* begin,
+        const char* end);
+
+    void
+    throwWriteError() const;
+
+    std::string _filename;
+    BgzfIndexFragment::index_t _format;
+    BGZF* _bgzfPtr;
+    std::ofstream _fragmentStream;
+    BgzfIndexFragment::FileHeader _fragmentHeader;
+
+    bool _isHeader = false;
+    bool _isRecordStarted = false;
+    std::vector<std::string> _contigNames;
+    std::unordered_map<std::string,int32_t> _contigIndex;
+    int32_t _lastTid = -1;
+
+    std::vector<char> _buffer;
+};
+
+
+
+/// output stream for text files which are written as BGZF compressed segments of a larger tabix indexed file
+///
+/// If the stream cannot be closed without error when it is destroyed, the program exits with an error.
+///
+struct BgzfIndexedOstream : public std::ostream
+{
+    /// \param[in] compressionLevel zlib compression level, or -1 for the BGZF default
+    BgzfIndexedOstream(
+        const std::string& filename,
+        const BgzfIndexFragment::index_t format,
+        const int compressionLevel = -1);
+
+    ~BgzfIndexedOstream();
+
+private:
+    BgzfIndexedStreamBuf _buf;
+};
+
+
+
+/// get the index fragment format for a filename ending in '.vcf.gz' or '.bed.gz'
+///
+/// \return false if the filename does not have a BGZF text file extension
+bool
+getBgzfIndexFormat(
+    const std::string& filename,
+    BgzfIndexFragment::index_t& format);
+
+
+
+/// concatenate BGZF segment files written by BgzfIndexedOstream into outputFilename, and write the tabix index
+/// outputFilename.tbi from the segment index fragments
+///
+/// Only segment headers are decompressed, all record blocks are copied without modification.
+///
+/// \param[in] headerCmdline if not empty, replace the '##cmdline=' header line in the merged file with this
+///                          value, or add the line to the end of the meta-information lines if it is not found
+void
+mergeBgzfSegments(
+    const std::vector<std::string>& segmentFilenames,
+    const std::string& outputFilename,
+    const std::string& headerCmdline = "");
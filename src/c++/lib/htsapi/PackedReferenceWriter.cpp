@@ -0,0 +1,181 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#include "PackedReferenceWriter.hh"
+
+#include "blt_util/Fnv1aChecksum.hh"
+#include "blt_util/PackedReference.hh"
+#include "blt_util/blt_exception.hh"
+#include "blt_util/seq_util.hh"
+
+#include "boost/filesystem.hpp"
+
+extern "C"
+{
+#include "htslib/faidx.h"
+}
+
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+
+
+static
+uint64_t
+alignOffset(const uint64_t offset)
+{
+    return ((offset + 7) & ~static_cast<uint64_t>(7));
+}
+
+
+
+/// pack a standardized sequence into 2 bit bases and an N-mask
+static
+void
+packSequence(
+    const std::string& seq,
+    std::vector<uint8_t>& bases,
+    std::vector<uint8_t>& nMask)
+{
+    const uint64_t length(seq.size());
+    bases.assign(PackedReferenceFormat::getPackedBaseSize(length), 0);
+    nMask.assign(PackedReferenceFormat::getNMaskSize(length), 0);
+    for (uint64_t pos(0); pos < length; ++pos)
+    {
+        const char base(seq[pos]);
+        if (base == 'N')
+        {
+            nMask[pos>>3] |= (1 << (pos&7));
+        }
+        else
+        {
+            bases[pos>>2] |= (base_to_id(base) << ((pos&3)<<1));
+        }
+    }
+}
+
+
+
+void
+writePackedReference(
+    const std::string& fastaFilename,
+    const std::string& outputFilename)
+{
+    using namespace PackedReferenceFormat;
+
+    std::unique_ptr<faidx_t,void(*)(faidx_t*)> fai(fai_load(fastaFilename.c_str()), fai_destroy);
+    if (not fai)
+    {
+        std::ostringstream oss;
+        oss << "ERROR: Can't load index for reference file: '" << fastaFilename << "'\n";
+        throw blt_exception(oss.str().c_str());
+    }
+
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = formatVersion;
+    header.byteOrder = byteOrderMark;
+    {
+        uint64_t indexSize(0);
+        header.sourceIndexChecksum = getFileChecksum(fastaFilename + ".fai", indexSize);
+        header.sourceFastaSize = boost::filesystem::file_size(fastaFilename);
+    }
+    header.contigCount = faidx_nseq(fai.get());
+
+    // lay out all sections:
+    std::vector<std::string> contigNames;
+    std::vector<ContigRecord> records(header.contigCount);
+    uint64_t offset(sizeof(FileHeader) + (header.contigCount * sizeof(ContigRecord)));
+    for (unsigned contigIndex(0); contigIndex < header.contigCount; ++contigIndex)
+    {
+        contigNames.push_back(faidx_iseq(fai.get(), contigIndex));
+        ContigRecord& record(records[contigIndex]);
+        record.length = faidx_seq_len(fai.get(), contigNames.back().c_str());
+        record.nameOffset = alignOffset(offset);
+        record.nameSize = contigNames.back().size();
+        record.baseOffset = alignOffset(record.nameOffset + record.nameSize);
+        record.nMaskOffset = alignOffset(record.baseOffset + getPackedBaseSize(record.length));
+        offset = record.nMaskOffset + getNMaskSize(record.length);
+    }
+
+    std::ofstream ofs(outputFilename, std::ios::binary);
+    if (! ofs)
+    {
+        std::ostringstream oss;
+        oss << "ERROR: Can't open packed reference output file: '" << outputFilename << "'";
+        throw blt_exception(oss.str().c_str());
+    }
+
+    uint64_t writeOffset(0);
+    auto writeSection = [&](const uint64_t sectionOffset, const void* data, const uint64_t size)
+    {
+        static const char zeros[8] = {};
+        assert(sectionOffset >= writeOffset);
+        ofs.write(zeros, sectionOffset-writeOffset);
+        ofs.write(static_cast<const char*>(data), size);
+        writeOffset = sectionOffset+size;
+    };
+
+    writeSection(0, &header, sizeof(header));
+    writeSection(writeOffset, records.data(), records.size()*sizeof(ContigRecord));
+
+    std::string seq;
+    std::vector<uint8_t> bases;
+    std::vector<uint8_t> nMask;
+    for (unsigned contigIndex(0); contigIndex < header.contigCount; ++contigIndex)
+    {
+        const std::string& contigName(contigNames[contigIndex]);
+        const ContigRecord& record(records[contigIndex]);
+
+        seq.clear();
+        if (record.length > 0)
+        {
+            int len; // throwaway...
+            std::unique_ptr<char,void(*)(void*)> contigSeq(
+                faidx_fetch_seq(fai.get(), contigName.c_str(), 0, record.length-1, &len), free);
+            if ((not contigSeq) or (static_cast<uint64_t>(len) != record.length))
+            {
+                std::ostringstream oss;
+                oss << "ERROR: Can't read sequence '" << contigName << "' from reference file: '" << fastaFilename << "'\n";
+                throw blt_exception(oss.str().c_str());
+            }
+            seq.assign(contigSeq.get(), len);
+        }
+        standardize_ref_seq(fastaFilename.c_str(), contigName.c_str(), seq, 0);
+        packSequence(seq, bases, nMask);
+
+        writeSection(record.nameOffset, contigName.c_str(), record.nameSize);
+        writeSection(record.baseOffset, bases.data(), bases.size());
+        writeSection(record.nMaskOffset, nMask.data(), nMask.size());
+    }
+
+    if (! ofs)
+    {
+        std::ostringstream oss;
+        oss << "ERROR: Failed to write packed reference output file: '" << outputFilename << "'";
+        throw blt_exception(oss.str().c_str());
+    }
+}
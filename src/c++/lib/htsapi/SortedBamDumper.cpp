@@ -0,0 +1,196 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#include "SortedBamDumper.hh"
+
+#include "blt_util/blt_exception.hh"
+#include "blt_util/log.hh"
+#include "htsapi/bam_streamer.hh"
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <sstream>
+
+
+
+SortedBamDumper::
+SortedBamDumper(
+    const char* filename,
+    const bam_hdr_t& header,
+    const unsigned compressionThreadCount)
+    : _filename(filename),
+      _compressionThreadCount(compressionThreadCount),
+      _bamdPtr(new bam_dumper(filename, header, compressionThreadCount))
+{}
+
+
+
+SortedBamDumper::
+~SortedBamDumper()
+{
+    try
+    {
+        flush();
+        if (not _lateRecords.empty()) mergeLateRecords();
+    }
+    catch (const std::exception& e)
+    {
+        log_os << "ERROR: Failed to write buffered records to BAM file: '" << name() << "': " << e.what() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+
+
+void
+SortedBamDumper::
+put_record(const bam1_t* brec)
+{
+    const int32_t tid(brec->core.tid);
+    const pos_t pos(brec->core.pos);
+    if (_isWritten)
+    {
+        if ((tid < _writtenTid) or ((tid == _writtenTid) and (pos < _writtenPos)))
+        {
+            if (_lateRecords.empty())
+            {
+                log_os << "WARNING: Record '" << bam_get_qname(brec) << "' at tid: " << tid << " pos: " << pos
+                       << " starts before the last record written at tid: " << _writtenTid << " pos: " << _writtenPos
+                       << " in coordinate sorted BAM file: '" << name() << "'. Late records will be merged into the"
+                       << " file when it is completed.\n";
+            }
+            _lateRecords.push_back({tid, pos, _recordIndex++, bam_dup1(brec)});
+            return;
+        }
+    }
+
+    _lastTid = tid;
+    _buffer.push_back({tid, pos, _recordIndex++, bam_dup1(brec)});
+    std::push_heap(_buffer.begin(), _buffer.end());
+}
+
+
+
+void
+SortedBamDumper::
+flush(const pos_t pos)
+{
+    const int32_t tid(_lastTid);
+    while (not _buffer.empty())
+    {
+        const BufferedRecord& next(_buffer.front());
+        if ((next.tid > tid) or ((next.tid == tid) and (next.pos >= pos))) break;
+        writeNextRecord();
+    }
+}
+
+
+
+void
+SortedBamDumper::
+flush()
+{
+    while (not _buffer.empty())
+    {
+        writeNextRecord();
+    }
+}
+
+
+
+void
+SortedBamDumper::
+writeNextRecord()
+{
+    std::pop_heap(_buffer.begin(), _buffer.end());
+    BufferedRecord& record(_buffer.back());
+    try
+    {
+        _bamdPtr->put_record(record.bamRecord);
+    }
+    catch (...)
+    {
+        bam_destroy1(record.bamRecord);
+        _buffer.pop_back();
+        throw;
+    }
+    _isWritten = true;
+    _writtenTid = record.tid;
+    _writtenPos = record.pos;
+    bam_destroy1(record.bamRecord);
+    _buffer.pop_back();
+}
+
+
+
+void
+SortedBamDumper::
+mergeLateRecords()
+{
+    // late records are ordered after any written records at the same position:
+    std::stable_sort(_lateRecords.begin(), _lateRecords.end(),
+                     [](const BufferedRecord& lhs, const BufferedRecord& rhs)
+    {
+        return ((lhs.tid < rhs.tid) or ((lhs.tid == rhs.tid) and (lhs.pos < rhs.pos)));
+    });
+
+    log_os << "INFO: Merging " << _lateRecords.size() << " late records into coordinate sorted BAM file: '"
+           << name() << "'\n";
+
+    _bamdPtr.reset();
+    const std::string mergeFilename(_filename + ".mergeLateRecords.tmp");
+    {
+        bam_streamer written(_filename.c_str());
+        bam_dumper merged(mergeFilename.c_str(), written.get_header(), _compressionThreadCount);
+
+        auto lateIter(_lateRecords.begin());
+        while (written.next())
+        {
+            const bam1_t* brec(written.get_record_ptr()->get_data());
+            for (; lateIter != _lateRecords.end(); ++lateIter)
+            {
+                if ((lateIter->tid > brec->core.tid) or
+                    ((lateIter->tid == brec->core.tid) and (lateIter->pos >= brec->core.pos))) break;
+                merged.put_record(lateIter->bamRecord);
+            }
+            merged.put_record(brec);
+        }
+        for (; lateIter != _lateRecords.end(); ++lateIter)
+        {
+            merged.put_record(lateIter->bamRecord);
+        }
+    }
+
+    if (std::rename(mergeFilename.c_str(), _filename.c_str()) != 0)
+    {
+        std::ostringstream oss;
+        oss << "Failed to replace BAM file: '" << name() << "' with merged file: '" << mergeFilename << "'";
+        throw blt_exception(oss.str().c_str());
+    }
+
+    for (BufferedRecord& record : _lateRecords)
+    {
+        bam_destroy1(record.bamRecord);
+    }
+    _lateRecords.clear();
+}
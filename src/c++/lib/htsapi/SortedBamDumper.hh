@@ -0,0 +1,122 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#pragma once
+
+#include "bam_dumper.hh"
+#include "blt_util/blt_types.hh"
+
+#include "boost/utility.hpp"
+
+#include <cstdint>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+
+/// write BAM records in coordinate order from input which is only out of order within a bounded window
+///
+/// Records are copied into a reorder buffer, and written in (tid,pos) order once the client indicates that no
+/// further records will start before a given position. Records with equal positions are written in the order
+/// they were added. A record added behind the written output is held separately with a warning, and merged
+/// into the output when the file is completed, which rewrites the file once.
+///
+struct SortedBamDumper : private boost::noncopyable
+{
+    /// \param[in] compressionThreadCount number of BGZF compression threads, see bam_dumper
+    SortedBamDumper(
+        const char* filename,
+        const bam_hdr_t& header,
+        const unsigned compressionThreadCount = 1);
+
+    /// write all remaining buffered records, and merge any late records into the output
+    ~SortedBamDumper();
+
+    /// add a copy of brec to the reorder buffer, or to the late records if brec starts before the written output
+    void
+    put_record(const bam1_t* brec);
+
+    /// write all buffered records starting before pos on the contig of the last record added, and all buffered
+    /// records on preceding contigs
+    ///
+    /// records added after this call should not start before this point
+    void
+    flush(const pos_t pos);
+
+    /// write all buffered records
+    void
+    flush();
+
+    const char*
+    name() const
+    {
+        return _filename.c_str();
+    }
+
+    /// number of records added behind the written output so far
+    uint64_t
+    getLateRecordCount() const
+    {
+        return _lateRecords.size();
+    }
+
+private:
+    struct BufferedRecord
+    {
+        /// true if this record should be written after rhs, this orders the buffer as a min-heap
+        bool
+        operator<(const BufferedRecord& rhs) const
+        {
+            if (tid != rhs.tid) return (tid > rhs.tid);
+            if (pos != rhs.pos) return (pos > rhs.pos);
+            return (recordIndex > rhs.recordIndex);
+        }
+
+        int32_t tid;
+        pos_t pos;
+        uint64_t recordIndex;
+        bam1_t* bamRecord;
+    };
+
+    /// write the first record in the buffer
+    void
+    writeNextRecord();
+
+    /// close the output and rewrite it with the late records merged in
+    void
+    mergeLateRecords();
+
+    const std::string _filename;
+    const unsigned _compressionThreadCount;
+    std::unique_ptr<bam_dumper> _bamdPtr;
+    std::vector<BufferedRecord> _buffer;
+
+    /// records added behind the written output, in the order they were added
+    std::vector<BufferedRecord> _lateRecords;
+    uint64_t _recordIndex = 0;
+
+    /// contig of the last record added
+    int32_t _lastTid = 0;
+
+    /// position of the last record written
+    bool _isWritten = false;
+    int32_t _writtenTid = 0;
+    pos_t _writtenPos = 0;
+};
@@ -35,7 +35,8 @@
 
 bam_dumper::
 bam_dumper(const char* filename,
-           const bam_hdr_t& header)
+           const bam_hdr_t& header,
+           const unsigned compressionThreadCount)
     : _hdr(&header),
       _stream_name(filename)
 {
@@ -50,6 +51,16 @@ bam_dumper(const char* filename,
         throw blt_exception(oss.str().c_str());
     }
 
+    if (compressionThreadCount > 1)
+    {
+        if (hts_set_threads(_hfp, compressionThreadCount) != 0)
+        {
+            std::ostringstream oss;
+            oss << "Failed to start compression threads for SAM/BAM/CRAM file: '" << filename << "'";
+            throw blt_exception(oss.str().c_str());
+        }
+    }
+
     const int retval = sam_hdr_write(_hfp,_hdr);
     if (retval != 0)
     {
@@ -30,9 +30,12 @@
 
 struct bam_dumper
 {
+    /// \param[in] compressionThreadCount number of threads used for BGZF compression, values above one hand
+    ///                                   compression of completed blocks to an htslib thread pool
     bam_dumper(
         const char* filename,
-        const bam_hdr_t& header);
+        const bam_hdr_t& header,
+        const unsigned compressionThreadCount = 1);
 
     ~bam_dumper();
 
@@ -30,9 +30,77 @@
 #include <cassert>
 #include <cstdlib>
 
+#include <condition_variable>
+#include <deque>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <sstream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+
+/// background decode state for prefetch mode
+///
+/// Records are decoded by a single producer thread into fixed-size batches. Filled batches are handed to the
+/// consumer in stream order, and each batch is returned to the producer for reuse after the consumer has read
+/// it, so at most batchCount*batchSize decoded records are held ahead of the consumer.
+///
+/// Record buffers are exchanged with the consumer's current record rather than copied.
+///
+struct bam_streamer::PrefetchData
+{
+    struct Batch
+    {
+        std::vector<bam1_t*> records;
+        unsigned size = 0;
+    };
+
+    PrefetchData()
+    {
+        for (unsigned batchIndex(0); batchIndex < batchCount; ++batchIndex)
+        {
+            Batch batch;
+            for (unsigned recordIndex(0); recordIndex < batchSize; ++recordIndex)
+            {
+                batch.records.push_back(bam_init1());
+            }
+            emptyBatches.push_back(std::move(batch));
+        }
+    }
+
+    ~PrefetchData()
+    {
+        assert(not producer.joinable());
+        for (auto& batch : emptyBatches)
+        {
+            for (bam1_t* bp : batch.records) bam_destroy1(bp);
+        }
+    }
+
+    static const unsigned batchSize = 256;
+    static const unsigned batchCount = 8;
+
+    std::mutex dataMutex;
+    std::condition_variable filledCondition;
+    std::condition_variable emptyCondition;
+
+    /// batches ready for the consumer, in stream order:
+    std::deque<Batch> filledBatches;
+
+    /// batches available to the producer:
+    std::vector<Batch> emptyBatches;
+
+    bool isProducerDone = false;
+    bool isStop = false;
+    std::thread producer;
+
+    /// the batch currently being read by the consumer:
+    Batch currentBatch;
+    unsigned currentRecordIndex = 0;
+};
 
 
 
@@ -96,6 +164,7 @@ bam_streamer(
 bam_streamer::
 ~bam_streamer()
 {
+    stopPrefetch();
     if (nullptr != _hitr) hts_itr_destroy(_hitr);
     if (nullptr != _hidx) hts_idx_destroy(_hidx);
     if (nullptr != _hdr) bam_hdr_destroy(_hdr);
@@ -199,6 +268,8 @@ resetRegion(
     int beginPos,
     int endPos)
 {
+    stopPrefetch();
+
     if (nullptr != _hitr) hts_itr_destroy(_hitr);
 
     _load_index();
@@ -226,23 +297,152 @@ resetRegion(
 
 
 
+int
+bam_streamer::
+readRecord(bam1_t* bp)
+{
+    if (nullptr == _hitr)
+    {
+        return sam_read1(_hfp, _hdr, bp);
+    }
+    else
+    {
+        return sam_itr_next(_hfp, _hitr, bp);
+    }
+}
+
+
+
+void
+bam_streamer::
+enablePrefetch()
+{
+    if (_prefetch) return;
+    _prefetch.reset(new PrefetchData);
+}
+
+
+
+void
+bam_streamer::
+stopPrefetch()
+{
+    if (not _prefetch) return;
+
+    PrefetchData& pf(*_prefetch);
+    if (pf.producer.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(pf.dataMutex);
+            pf.isStop = true;
+        }
+        pf.emptyCondition.notify_all();
+        pf.producer.join();
+    }
+
+    // return all batches to the producer, any records decoded ahead of the consumer are discarded:
+    for (auto& batch : pf.filledBatches)
+    {
+        pf.emptyBatches.push_back(std::move(batch));
+    }
+    pf.filledBatches.clear();
+    if (not pf.currentBatch.records.empty())
+    {
+        pf.emptyBatches.push_back(std::move(pf.currentBatch));
+        pf.currentBatch = PrefetchData::Batch();
+    }
+    pf.currentRecordIndex = 0;
+    pf.isProducerDone = false;
+    pf.isStop = false;
+}
+
+
+
+bool
+bam_streamer::
+nextPrefetch()
+{
+    PrefetchData& pf(*_prefetch);
+
+    if (not (pf.producer.joinable() || pf.isProducerDone))
+    {
+        pf.producer = std::thread([this,&pf]()
+        {
+            while (true)
+            {
+                PrefetchData::Batch batch;
+                {
+                    std::unique_lock<std::mutex> lock(pf.dataMutex);
+                    pf.emptyCondition.wait(lock, [&] { return (pf.isStop || (not pf.emptyBatches.empty())); });
+                    if (pf.isStop) return;
+                    batch = std::move(pf.emptyBatches.back());
+                    pf.emptyBatches.pop_back();
+                }
+
+                bool isStreamEnd(false);
+                batch.size = 0;
+                while (batch.size < PrefetchData::batchSize)
+                {
+                    if (readRecord(batch.records[batch.size]) < 0)
+                    {
+                        isStreamEnd = true;
+                        break;
+                    }
+                    batch.size++;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(pf.dataMutex);
+                    pf.filledBatches.push_back(std::move(batch));
+                    pf.isProducerDone = isStreamEnd;
+                }
+                pf.filledCondition.notify_one();
+
+                if (isStreamEnd) return;
+            }
+        });
+    }
+
+    while (pf.currentRecordIndex >= pf.currentBatch.size)
+    {
+        std::unique_lock<std::mutex> lock(pf.dataMutex);
+        if (not pf.currentBatch.records.empty())
+        {
+            pf.emptyBatches.push_back(std::move(pf.currentBatch));
+            pf.currentBatch = PrefetchData::Batch();
+            pf.emptyCondition.notify_one();
+        }
+
+        pf.filledCondition.wait(lock, [&] { return (pf.isProducerDone || (not pf.filledBatches.empty())); });
+        if (pf.filledBatches.empty()) return false;
+
+        pf.currentBatch = std::move(pf.filledBatches.front());
+        pf.filledBatches.pop_front();
+        pf.currentRecordIndex = 0;
+    }
+
+    std::swap(_brec._bp, pf.currentBatch.records[pf.currentRecordIndex]);
+    pf.currentRecordIndex++;
+    return true;
+}
+
+
+
 bool
 bam_streamer::
 next()
 {
     if (nullptr == _hfp) return false;
 
-    int ret;
-    if (nullptr == _hitr)
+    if (_prefetch)
     {
-        ret = sam_read1(_hfp,_hdr, _brec._bp);
+        _is_record_set = nextPrefetch();
     }
     else
     {
-        ret = sam_itr_next(_hfp, _hitr, _brec._bp);
+        _is_record_set = (readRecord(_brec._bp) >= 0);
     }
 
-    _is_record_set=(ret >= 0);
     if (_is_record_set) _record_no++;
 
     return _is_record_set;
@@ -29,6 +29,7 @@
 
 #include "boost/utility.hpp"
 
+#include <memory>
 #include <string>
 
 
@@ -71,6 +72,16 @@ struct bam_streamer : public boost::noncopyable
         int beginPos,
         int endPos);
 
+    /// \brief decode records on a background thread ahead of the consumer
+    ///
+    /// In prefetch mode, a decode thread reads records into a bounded ring of record batches. next() then
+    /// only hands over records which have already been decoded, so that decompression can overlap with the
+    /// caller's processing of earlier records. The record stream is identical to that of the default mode.
+    ///
+    /// can be called at any point in the stream from the consumer thread
+    void
+    enablePrefetch();
+
     bool next();
 
     const bam_record* get_record_ptr() const
@@ -106,6 +117,20 @@ struct bam_streamer : public boost::noncopyable
 private:
     void _load_index();
 
+    /// read the next record from the current region or file into bp
+    ///
+    /// \return htslib read status, negative at end of stream or on error
+    int
+    readRecord(bam1_t* bp);
+
+    bool
+    nextPrefetch();
+
+    void
+    stopPrefetch();
+
+    struct PrefetchData;
+
     bool _is_record_set;
     htsFile* _hfp;
     bam_hdr_t* _hdr;
@@ -118,4 +143,6 @@ private:
     std::string _stream_name;
     bool _is_region;
     std::string _region;
+
+    std::unique_ptr<PrefetchData> _prefetch;
 };
@@ -102,6 +102,19 @@ resetRegion(
 
 
 
+std::vector<std::string>
+hts_streamer::
+getIndexSequenceNames() const
+{
+    int sequenceCount(0);
+    const char** sequenceNames(tbx_seqnames(_tidx, &sequenceCount));
+    std::vector<std::string> names(sequenceNames, sequenceNames+sequenceCount);
+    free(sequenceNames);
+    return names;
+}
+
+
+
 void
 hts_streamer::
 _load_index()
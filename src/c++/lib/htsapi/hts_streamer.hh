@@ -30,6 +30,7 @@
 #include "boost/utility.hpp"
 
 #include <string>
+#include <vector>
 
 
 struct hts_streamer : private boost::noncopyable
@@ -64,6 +65,10 @@ struct hts_streamer : private boost::noncopyable
     resetRegion(
         const char* region);
 
+    /// \return names of all sequences in the index of this file, in index order
+    std::vector<std::string>
+    getIndexSequenceNames() const;
+
 protected:
     /// load index if it hasn't been set already
     void
@@ -0,0 +1,190 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "test_config.h"
+
+#include "boost/test/unit_test.hpp"
+
+#include "blt_util/test/TestTempPath.hh"
+#include "htsapi/AlignmentIndexDensity.hh"
+
+#include "boost/filesystem.hpp"
+
+#include "zlib.h"
+
+#include <numeric>
+#include <string>
+
+
+BOOST_AUTO_TEST_SUITE( test_AlignmentIndexDensity )
+
+
+static
+std::string
+getTestBamPath()
+{
+    return std::string(TEST_DATA_PATH) + "/bam_streamer_test.bam";
+}
+
+
+
+/// copy the test bam into dir, so that a synthetic index can be written next to it
+static
+std::string
+copyTestBam(const TestTempPath& dir)
+{
+    const std::string bamPath(dir.file("test.bam"));
+    boost::filesystem::copy_file(getTestBamPath(), bamPath);
+    return bamPath;
+}
+
+
+
+static
+void
+writeGzip(
+    const std::string& filename,
+    const std::string& data)
+{
+    gzFile gzfp(gzopen(filename.c_str(), "wb"));
+    BOOST_REQUIRE(gzfp != nullptr);
+    BOOST_REQUIRE_EQUAL(gzwrite(gzfp, data.data(), data.size()), static_cast<int>(data.size()));
+    gzclose(gzfp);
+}
+
+
+
+static
+void
+appendUInt(
+    const uint64_t val,
+    const unsigned size,
+    std::string& data)
+{
+    for (unsigned byteIndex(0); byteIndex<size; ++byteIndex)
+    {
+        data.push_back(static_cast<char>((val >> (8*byteIndex)) & 0xff));
+    }
+}
+
+
+
+static
+double
+getTotalBytes(const AlignmentIndexDensity::Contig& contig)
+{
+    return std::accumulate(contig.windowBytes.begin(), contig.windowBytes.end(), 0.);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_BaiDensity )
+{
+    static const unsigned windowSize(16384);
+    AlignmentIndexDensity density(windowSize);
+    density.addAlignmentFile(getTestBamPath());
+
+    BOOST_REQUIRE_EQUAL(density.getContigs().size(), 1u);
+    const AlignmentIndexDensity::Contig& contig(density.getContigs()[0]);
+    BOOST_REQUIRE_EQUAL(contig.name, "chr20");
+    BOOST_REQUIRE_EQUAL(contig.windowBytes.size(), (contig.length+windowSize-1)/windowSize);
+
+    // all reads in the test file are within one window:
+    const double totalBytes(getTotalBytes(contig));
+    BOOST_REQUIRE(totalBytes > 0.);
+    BOOST_REQUIRE(totalBytes < boost::filesystem::file_size(getTestBamPath()));
+    BOOST_REQUIRE_EQUAL(contig.windowBytes[862900/windowSize], totalBytes);
+
+    // adding the same file again should double the estimate:
+    density.addAlignmentFile(getTestBamPath());
+    BOOST_REQUIRE_EQUAL(density.getContigs().size(), 1u);
+    BOOST_REQUIRE_CLOSE(getTotalBytes(density.getContigs()[0]), totalBytes*2, 0.0001);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_CsiDensity )
+{
+    const TestTempPath dir;
+    dir.createDirectory();
+    const std::string bamPath(copyTestBam(dir));
+
+    // CSI with 1kb leaf bins and two levels below the root:
+    std::string csi("CSI\1");
+    appendUInt(10, 4, csi);
+    appendUInt(2, 4, csi);
+    appendUInt(0, 4, csi);
+    appendUInt(1, 4, csi);
+    appendUInt(3, 4, csi);
+
+    auto appendBin = [&](const unsigned bin, const uint64_t chunkBegin, const uint64_t chunkEnd)
+    {
+        appendUInt(bin, 4, csi);
+        appendUInt(0, 8, csi);
+        appendUInt(1, 4, csi);
+        appendUInt(chunkBegin << 16, 8, csi);
+        appendUInt(chunkEnd << 16, 8, csi);
+    };
+
+    // leaf bin covering [3072,4096):
+    appendBin(9+3, 100, 150);
+    // level 1 bin covering [0,8192):
+    appendBin(1, 200, 280);
+    // metadata bin, which should be ignored:
+    appendBin(74, 0, 1000);
+
+    writeGzip(bamPath + ".csi", csi);
+
+    AlignmentIndexDensity density(1024);
+    density.addAlignmentFile(bamPath);
+
+    const AlignmentIndexDensity::Contig& contig(density.getContigs()[0]);
+    BOOST_REQUIRE_CLOSE(getTotalBytes(contig), 130., 0.0001);
+    BOOST_REQUIRE_CLOSE(contig.windowBytes[0], 10., 0.0001);
+    BOOST_REQUIRE_CLOSE(contig.windowBytes[3], 60., 0.0001);
+    BOOST_REQUIRE_CLOSE(contig.windowBytes[7], 10., 0.0001);
+    BOOST_REQUIRE_EQUAL(contig.windowBytes[8], 0.);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_CraiDensity )
+{
+    const TestTempPath dir;
+    dir.createDirectory();
+    const std::string bamPath(copyTestBam(dir));
+
+    // one mapped slice covering [1000,3000) and one unmapped slice:
+    writeGzip(bamPath + ".crai",
+              "0\t1001\t2000\t100\t10\t3000\n"
+              "-1\t0\t0\t5000\t0\t700\n");
+
+    AlignmentIndexDensity density(1000);
+    density.addAlignmentFile(bamPath);
+
+    const AlignmentIndexDensity::Contig& contig(density.getContigs()[0]);
+    BOOST_REQUIRE_CLOSE(getTotalBytes(contig), 3000., 0.0001);
+    BOOST_REQUIRE_EQUAL(contig.windowBytes[0], 0.);
+    BOOST_REQUIRE_CLOSE(contig.windowBytes[1], 1500., 0.0001);
+    BOOST_REQUIRE_CLOSE(contig.windowBytes[2], 1500., 0.0001);
+    BOOST_REQUIRE_EQUAL(contig.windowBytes[3], 0.);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,192 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#include "boost/test/unit_test.hpp"
+
+#include "blt_util/test/TestTempPath.hh"
+#include "htsapi/BgzfIndexedOutput.hh"
+#include "htsapi/vcf_streamer.hh"
+
+#include "blt_util/thirdparty_push.h"
+
+extern "C" {
+#include "htslib/bgzf.h"
+#include "htslib/kstring.h"
+#include "htslib/tbx.h"
+}
+
+#include "blt_util/thirdparty_pop.h"
+
+#include "boost/filesystem.hpp"
+
+#include <sstream>
+
+
+BOOST_AUTO_TEST_SUITE( test_BgzfIndexedOutput )
+
+
+static
+std::string
+readBgzfText(const std::string& filename)
+{
+    BGZF* bgzfPtr(bgzf_open(filename.c_str(), "r"));
+    BOOST_REQUIRE(bgzfPtr != nullptr);
+    std::string text;
+    kstring_t str = { 0, 0, nullptr };
+    while (bgzf_getline(bgzfPtr, '\n', &str) >= 0)
+    {
+        text.append(str.s, str.l);
+        text.push_back('\n');
+    }
+    free(str.s);
+    bgzf_close(bgzfPtr);
+    return text;
+}
+
+
+
+static
+void
+writeSegment(
+    const std::string& filename,
+    const std::string& text)
+{
+    BgzfIndexFragment::index_t format;
+    BOOST_REQUIRE(getBgzfIndexFormat(filename, format));
+    BgzfIndexedOstream os(filename, format);
+    os << text;
+}
+
+
+
+/// check that the merged index matches the index created by tabix for the same file
+static
+void
+checkMergedIndex(
+    const TestTempPath& tempDir,
+    const std::string& mergedFilename,
+    const tbx_conf_t& conf)
+{
+    const std::string tabixFilename(tempDir.file("tabix." + boost::filesystem::path(mergedFilename).filename().string()));
+    boost::filesystem::copy_file(mergedFilename, tabixFilename);
+    BOOST_REQUIRE_EQUAL(tbx_index_build(tabixFilename.c_str(), 0, &conf), 0);
+
+    BOOST_REQUIRE(readBgzfText(mergedFilename + ".tbi") == readBgzfText(tabixFilename + ".tbi"));
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_BgzfIndexFormat )
+{
+    BgzfIndexFragment::index_t format;
+    BOOST_REQUIRE(getBgzfIndexFormat("foo.vcf.gz", format));
+    BOOST_REQUIRE_EQUAL(format, BgzfIndexFragment::VCF);
+    BOOST_REQUIRE(getBgzfIndexFormat("foo.bed.gz", format));
+    BOOST_REQUIRE_EQUAL(format, BgzfIndexFragment::BED);
+    BOOST_REQUIRE(! getBgzfIndexFormat("foo.vcf", format));
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_BgzfMergeVcfSegments )
+{
+    const TestTempPath tempDir;
+    tempDir.createDirectory();
+
+    const std::string header(
+        "##fileformat=VCFv4.1\n"
+        "##cmdline=segment command\n"
+        "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO\n");
+
+    std::ostringstream segment1;
+    segment1 << "chr1\t10\t.\tA\tC\t.\tPASS\t.\n"
+             << "chr1\t20\t.\tACGT\tA\t.\tPASS\t.\n"
+             << "chr1\t30\t.\tA\t.\t.\tPASS\tEND=500;BLOCKAVG\n";
+
+    // write enough records to span several BGZF blocks:
+    std::ostringstream segment2;
+    for (unsigned pos(1000); pos < 40000; ++pos)
+    {
+        segment2 << "chr1\t" << pos << "\t.\tG\t.\t.\tPASS\tDP=30;END=" << pos << "\n";
+    }
+    segment2 << "chr2\t5\t.\tT\tG\t.\tPASS\tSNVHPOL=3;END=9\n";
+
+    const std::vector<std::string> segmentFilenames = { tempDir.file("s1.vcf.gz"), tempDir.file("s2.vcf.gz") };
+    writeSegment(segmentFilenames[0], header + segment1.str());
+    writeSegment(segmentFilenames[1], segment2.str());
+
+    const std::string mergedFilename(tempDir.file("merged.vcf.gz"));
+    mergeBgzfSegments(segmentFilenames, mergedFilename, "workflow command");
+
+    const std::string expectHeader(
+        "##fileformat=VCFv4.1\n"
+        "##cmdline=workflow command\n"
+        "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO\n");
+    BOOST_REQUIRE(readBgzfText(mergedFilename) == (expectHeader + segment1.str() + segment2.str()));
+
+    checkMergedIndex(tempDir, mergedFilename, tbx_conf_vcf);
+
+    vcf_streamer vcfs(mergedFilename.c_str(), "chr1:400-1001");
+    std::vector<int> positions;
+    while (vcfs.next())
+    {
+        positions.push_back(vcfs.get_record_ptr()->pos);
+    }
+    BOOST_REQUIRE_EQUAL(positions.size(), 3u);
+    BOOST_REQUIRE_EQUAL(positions[0], 30);
+    BOOST_REQUIRE_EQUAL(positions[1], 1000);
+    BOOST_REQUIRE_EQUAL(positions[2], 1001);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_BgzfMergeBedSegments )
+{
+    const TestTempPath tempDir;
+    tempDir.createDirectory();
+
+    const std::vector<std::string> segmentFilenames =
+    { tempDir.file("s1.bed.gz"), tempDir.file("s2.bed.gz"), tempDir.file("s3.bed.gz") };
+    writeSegment(segmentFilenames[0], "chr1\t0\t100\nchr1\t200\t300\n");
+    writeSegment(segmentFilenames[1], "");
+    writeSegment(segmentFilenames[2], "chr1\t400\t500\nchr3\t10\t20\n");
+
+    const std::string mergedFilename(tempDir.file("merged.bed.gz"));
+    mergeBgzfSegments(segmentFilenames, mergedFilename);
+
+    BOOST_REQUIRE(readBgzfText(mergedFilename) == "chr1\t0\t100\nchr1\t200\t300\nchr1\t400\t500\nchr3\t10\t20\n");
+    checkMergedIndex(tempDir, mergedFilename, tbx_conf_bed);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_BgzfMergeUnsortedSegments )
+{
+    const TestTempPath tempDir;
+    tempDir.createDirectory();
+
+    const std::vector<std::string> segmentFilenames = { tempDir.file("s1.bed.gz"), tempDir.file("s2.bed.gz") };
+    writeSegment(segmentFilenames[0], "chr1\t200\t300\n");
+    writeSegment(segmentFilenames[1], "chr1\t0\t100\n");
+
+    BOOST_REQUIRE_THROW(mergeBgzfSegments(segmentFilenames, tempDir.file("merged.bed.gz")), std::exception);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,111 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#include "boost/test/unit_test.hpp"
+
+#include "blt_util/PackedReference.hh"
+#include "blt_util/reference_contig_segment.hh"
+#include "blt_util/test/TestTempPath.hh"
+#include "htsapi/PackedReferenceWriter.hh"
+#include "htsapi/samtools_fasta_util.hh"
+
+#include <fstream>
+#include <memory>
+
+
+BOOST_AUTO_TEST_SUITE( test_PackedReferenceWriter )
+
+
+/// write a small two contig fasta reference to path
+static
+void
+writeTestFasta(const std::string& path)
+{
+    std::ofstream ofs(path);
+    ofs << ">chrA desc\n"
+        << "ACGTNacgtn\n"
+        << "RYKMSWacGT\n"
+        << "TTA\n"
+        << ">chrB\n"
+        << "NNNNNNNNGC\n"
+        << "A\n";
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_PackedReferenceRoundTrip )
+{
+    // the fasta, its samtools index and the packed reference are all removed with this directory:
+    const TestTempPath dir;
+    dir.createDirectory();
+    const std::string fastaPath(dir.file("test.fa"));
+    const std::string packedPath(dir.file("test.fa.packed"));
+    writeTestFasta(fastaPath);
+    writePackedReference(fastaPath, packedPath);
+
+    {
+        std::shared_ptr<const PackedReference> packedRef(new PackedReference(packedPath));
+        BOOST_REQUIRE_EQUAL(packedRef->header().contigCount, 2u);
+        BOOST_REQUIRE(packedRef->getContig("chrC") == nullptr);
+
+        for (const std::string chrom : { "chrA", "chrB" })
+        {
+            const PackedReferenceContig* contig(packedRef->getContig(chrom));
+            BOOST_REQUIRE(contig != nullptr);
+
+            std::string expect;
+            get_standardized_region_seq(fastaPath, chrom, 0, contig->length-1, expect);
+            BOOST_REQUIRE_EQUAL(contig->length, expect.size());
+
+            std::string packed;
+            for (uint64_t pos(0); pos < contig->length; ++pos)
+            {
+                packed.push_back(contig->get_base(pos));
+            }
+            BOOST_REQUIRE_EQUAL(packed, expect);
+
+            // check that a packed reference segment matches a segment read from the fasta:
+            const pos_t beginPos(2), endPos(contig->length+5);
+            reference_contig_segment stringSegment;
+            stringSegment.set_offset(beginPos);
+            get_standardized_region_seq(fastaPath, chrom, beginPos, endPos-1, stringSegment.seq());
+
+            reference_contig_segment packedSegment;
+            packedSegment.set_packed_contig(packedRef, *contig, beginPos, endPos);
+            BOOST_REQUIRE(packedSegment.is_packed());
+            BOOST_REQUIRE_EQUAL(packedSegment.get_offset(), stringSegment.get_offset());
+            BOOST_REQUIRE_EQUAL(packedSegment.end(), stringSegment.end());
+            for (pos_t pos(0); pos < endPos+2; ++pos)
+            {
+                BOOST_REQUIRE_EQUAL(packedSegment.get_base(pos), stringSegment.get_base(pos));
+            }
+
+            std::string packedSubstr, stringSubstr;
+            packedSegment.get_substring(0, endPos, packedSubstr);
+            stringSegment.get_substring(0, endPos, stringSubstr);
+            BOOST_REQUIRE_EQUAL(packedSubstr, stringSubstr);
+            packedSegment.get_substring(beginPos+1, 4, packedSubstr);
+            stringSegment.get_substring(beginPos+1, 4, stringSubstr);
+            BOOST_REQUIRE_EQUAL(packedSubstr, stringSubstr);
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,172 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "test_config.h"
+
+#include "boost/test/unit_test.hpp"
+
+#include "blt_util/test/TestTempPath.hh"
+#include "htsapi/SortedBamDumper.hh"
+#include "htsapi/bam_streamer.hh"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+
+BOOST_AUTO_TEST_SUITE( test_SortedBamDumper )
+
+
+static
+const char*
+getTestpath()
+{
+    static const std::string testPath(std::string(TEST_DATA_PATH) + "/bam_streamer_test.bam");
+    return testPath.c_str();
+}
+
+
+
+/// summarize all records in a bam file as "qname/read_no/pos"
+static
+std::vector<std::string>
+getRecordSummary(const char* filename)
+{
+    bam_streamer bams(filename);
+    std::vector<std::string> summary;
+    while (bams.next())
+    {
+        const bam_record& bamr(*bams.get_record_ptr());
+        summary.push_back(std::string(bamr.qname()) + "/" + std::to_string(bamr.read_no()) + "/" +
+                          std::to_string(bamr.pos()));
+    }
+    return summary;
+}
+
+
+
+/// check that the bam file at outPath holds the same records as expect, in position order
+static
+void
+checkSortedOutput(
+    const std::vector<std::string>& expect,
+    const std::string& outPath)
+{
+    const std::vector<std::string> result(getRecordSummary(outPath.c_str()));
+    BOOST_REQUIRE_EQUAL(result.size(), expect.size());
+
+    std::vector<std::string> sortedExpect(expect);
+    std::vector<std::string> sortedResult(result);
+    std::sort(sortedExpect.begin(), sortedExpect.end());
+    std::sort(sortedResult.begin(), sortedResult.end());
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(sortedExpect.begin(), sortedExpect.end(), sortedResult.begin(), sortedResult.end());
+
+    auto getPos = [](const std::string& summary)
+    {
+        return std::stoi(summary.substr(summary.rfind('/')+1));
+    };
+    for (unsigned recordIndex(1); recordIndex < result.size(); ++recordIndex)
+    {
+        BOOST_REQUIRE_LE(getPos(result[recordIndex-1]), getPos(result[recordIndex]));
+    }
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_SortedBamDumper_reorder )
+{
+    const TestTempPath outFile(".bam");
+    const std::string& outPath(outFile.path);
+    const std::vector<std::string> expect(getRecordSummary(getTestpath()));
+
+    static const unsigned windowSize(8);
+
+    {
+        bam_streamer bams(getTestpath());
+        SortedBamDumper sbamd(outPath.c_str(), bams.get_header(), 2);
+
+        // reverse the input order within each window of records:
+        std::vector<bam_record> window;
+        auto putWindow = [&]()
+        {
+            for (auto iter(window.rbegin()); iter != window.rend(); ++iter)
+            {
+                sbamd.put_record(iter->get_data());
+            }
+            window.clear();
+        };
+
+        while (bams.next())
+        {
+            window.push_back(*bams.get_record_ptr());
+            if (window.size() < windowSize) continue;
+
+            // the input is sorted, so no further records start before the current record:
+            putWindow();
+            sbamd.flush(bams.get_record_ptr()->pos()-1);
+        }
+        putWindow();
+    }
+
+    checkSortedOutput(expect, outPath);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_SortedBamDumper_lateRecords )
+{
+    // simulate a growth in the indel span per read in the middle of a region: output is flushed up to a bound
+    // computed from a small realignment span, then records realigned with the larger span land behind it:
+    const TestTempPath outFile(".bam");
+    const std::string& outPath(outFile.path);
+    const std::vector<std::string> expect(getRecordSummary(getTestpath()));
+    BOOST_REQUIRE(expect.size() > 4);
+
+    {
+        bam_streamer bams(getTestpath());
+        SortedBamDumper sbamd(outPath.c_str(), bams.get_header());
+
+        std::vector<bam_record> lateRecords;
+        unsigned recordIndex(0);
+        while (bams.next())
+        {
+            const bam_record& bamr(*bams.get_record_ptr());
+            if ((recordIndex++ % 4) == 1)
+            {
+                lateRecords.push_back(bamr);
+                continue;
+            }
+            sbamd.put_record(bamr.get_data());
+            sbamd.flush(bamr.pos()-1);
+        }
+        sbamd.flush();
+        BOOST_REQUIRE_EQUAL(sbamd.getLateRecordCount(), 0u);
+
+        for (const bam_record& bamr : lateRecords)
+        {
+            sbamd.put_record(bamr.get_data());
+        }
+        BOOST_REQUIRE(sbamd.getLateRecordCount() > 0);
+    }
+
+    checkSortedOutput(expect, outPath);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,106 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "test_config.h"
+
+#include "htsapi/bam_streamer.hh"
+
+#include "boost/test/unit_test.hpp"
+
+#include <string>
+#include <vector>
+
+
+
+BOOST_AUTO_TEST_SUITE( test_bam_streamer )
+
+static
+const char*
+getTestpath()
+{
+    static const std::string testPath(std::string(TEST_DATA_PATH) + "/bam_streamer_test.bam");
+    return testPath.c_str();
+}
+
+
+
+/// summarize all remaining records in the stream as "qname/read_no/pos"
+static
+std::vector<std::string>
+getRecordSummary(bam_streamer& bams)
+{
+    std::vector<std::string> summary;
+    while (bams.next())
+    {
+        const bam_record& bamr(*bams.get_record_ptr());
+        summary.push_back(std::string(bamr.qname()) + "/" + std::to_string(bamr.read_no()) + "/" +
+                          std::to_string(bamr.pos()));
+    }
+    BOOST_REQUIRE(bams.get_record_ptr() == nullptr);
+    return summary;
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_bam_streamer_prefetch )
+{
+    bam_streamer bams(getTestpath());
+    const std::vector<std::string> expect(getRecordSummary(bams));
+
+    // the test file should span several prefetch batches:
+    BOOST_REQUIRE_GT(expect.size(), 800u);
+
+    bam_streamer pbams(getTestpath());
+    pbams.enablePrefetch();
+    const std::vector<std::string> result(getRecordSummary(pbams));
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(expect.begin(), expect.end(), result.begin(), result.end());
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_bam_streamer_prefetch_region )
+{
+    static const char region1[] = "chr20:862000-863000";
+    static const char region2[] = "chr20:855000-866000";
+
+    bam_streamer bams(getTestpath(), region1);
+    const std::vector<std::string> expect1(getRecordSummary(bams));
+    bams.resetRegion(region2);
+    const std::vector<std::string> expect2(getRecordSummary(bams));
+
+    BOOST_REQUIRE(not expect1.empty());
+    BOOST_REQUIRE_GT(expect2.size(), expect1.size());
+
+    bam_streamer pbams(getTestpath(), region1);
+    pbams.enablePrefetch();
+
+    // switch regions in the middle of a prefetched stream:
+    BOOST_REQUIRE(pbams.next());
+    pbams.resetRegion(region2);
+    const std::vector<std::string> result2(getRecordSummary(pbams));
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(expect2.begin(), expect2.end(), result2.begin(), result2.end());
+
+    pbams.resetRegion(region1);
+    const std::vector<std::string> result1(getRecordSummary(pbams));
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(expect1.begin(), expect1.end(), result1.begin(), result1.end());
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -22,6 +22,8 @@
 
 #include "boost/test/unit_test.hpp"
 
+#include <string>
+
 
 BOOST_AUTO_TEST_SUITE( vcf_record_test )
 
@@ -43,6 +45,71 @@ BOOST_AUTO_TEST_CASE( test_site )
     BOOST_REQUIRE(vcfr.is_ref_site());
 }
 
+BOOST_AUTO_TEST_CASE( test_fields )
+{
+    vcf_record vcfr;
+    BOOST_REQUIRE(vcfr.set("chr1\t100\t.\tacg\tA,aCGT\t.\tPASS\t.\n"));
+    BOOST_REQUIRE_EQUAL(vcfr.pos, 100);
+    BOOST_REQUIRE_EQUAL(vcfr.getAltCount(), 2u);
+    BOOST_REQUIRE(vcfr.is_indel());
+    BOOST_REQUIRE(not vcfr.is_snv());
+    BOOST_REQUIRE(vcfr.isSimpleVariantLocus());
+    BOOST_REQUIRE(vcfr.is_normalized());
+
+    // REF and ALT are returned in upper case:
+    BOOST_REQUIRE_EQUAL(vcfr.getChrom(), "chr1");
+    BOOST_REQUIRE_EQUAL(vcfr.getRef(), "ACG");
+    BOOST_REQUIRE_EQUAL(vcfr.getAlt().size(), 2u);
+    BOOST_REQUIRE_EQUAL(vcfr.getAlt()[0], "A");
+    BOOST_REQUIRE_EQUAL(vcfr.getAlt()[1], "ACGT");
+
+    // fields of a reused record should be reparsed:
+    BOOST_REQUIRE(vcfr.set("chr2\t5\t.\tG\t.\n"));
+    BOOST_REQUIRE_EQUAL(vcfr.getChrom(), "chr2");
+    BOOST_REQUIRE_EQUAL(vcfr.getRef(), "G");
+    BOOST_REQUIRE_EQUAL(vcfr.getAltCount(), 0u);
+    BOOST_REQUIRE(vcfr.getAlt().empty());
+}
+
+BOOST_AUTO_TEST_CASE( test_normalized )
+{
+    vcf_record vcfr;
+    vcfr.set("chr1\t1\t.\tAC\tA\n");
+    BOOST_REQUIRE(vcfr.is_normalized());
+
+    // unnormalized because of the shared suffix:
+    vcfr.set("chr1\t1\t.\tACT\tAT\n");
+    BOOST_REQUIRE(not vcfr.is_normalized());
+
+    // reference-padded MNVs are accepted:
+    vcfr.set("chr1\t1\t.\tAAC\tAAT\n");
+    BOOST_REQUIRE(vcfr.is_normalized());
+
+    // symbolic alleles are not simple variants:
+    vcfr.set("chr1\t1\t.\tA\t<DEL>\n");
+    BOOST_REQUIRE(not vcfr.isSimpleVariantLocus());
+}
+
+BOOST_AUTO_TEST_CASE( test_copy )
+{
+    // a copied record should not depend on the source record string:
+    std::string line("chr1\t10\t.\tC\tT,G\n");
+    vcf_record vcfr;
+    vcfr.set(line.c_str());
+    const vcf_record vcfr2(vcfr);
+
+    line.assign("chr9\t20\t.\tAAA\tA\n");
+    vcfr.set(line.c_str());
+
+    BOOST_REQUIRE_EQUAL(vcfr2.pos, 10);
+    BOOST_REQUIRE_EQUAL(vcfr2.getChrom(), "chr1");
+    BOOST_REQUIRE_EQUAL(vcfr2.getRef(), "C");
+    BOOST_REQUIRE_EQUAL(vcfr2.getAlt().size(), 2u);
+    BOOST_REQUIRE_EQUAL(vcfr2.getAlt()[1], "G");
+    BOOST_REQUIRE(vcfr2.is_snv());
+    BOOST_REQUIRE(vcfr.is_indel());
+}
+
 
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -58,7 +58,7 @@ BOOST_AUTO_TEST_CASE( test_vcf_streamer_region )
     BOOST_REQUIRE( ! vptr->is_snv() );
 
     BOOST_REQUIRE_EQUAL(vptr->pos, 757807);
-    BOOST_REQUIRE_EQUAL(vptr->ref,"CCCTGGCCAGCAGATCCACCCTGTCTATACTACCTG");
+    BOOST_REQUIRE_EQUAL(vptr->getRef(),"CCCTGGCCAGCAGATCCACCCTGTCTATACTACCTG");
 
     // also check that a valid record returns true
     BOOST_REQUIRE( vcfs.next() );
@@ -74,8 +74,8 @@ BOOST_AUTO_TEST_CASE( test_vcf_streamer_region )
     BOOST_REQUIRE( vptr->is_normalized());
 
     BOOST_REQUIRE_EQUAL(vptr->pos, 758807);
-    BOOST_REQUIRE_EQUAL(vptr->alt.size(),2u);
-    BOOST_REQUIRE_EQUAL(vptr->alt[0],"T");
+    BOOST_REQUIRE_EQUAL(vptr->getAlt().size(),2u);
+    BOOST_REQUIRE_EQUAL(vptr->getAlt()[0],"T");
 
     BOOST_REQUIRE( vcfs.next() );
     vptr = vcfs.get_record_ptr();
@@ -90,8 +90,8 @@ BOOST_AUTO_TEST_CASE( test_vcf_streamer_region )
     BOOST_REQUIRE( vptr->is_normalized());
 
     BOOST_REQUIRE_EQUAL(vptr->pos, 821604);
-    BOOST_REQUIRE_EQUAL(vptr->alt.size(),1u);
-    BOOST_REQUIRE_EQUAL(vptr->alt[0],"TGCCCTTTGGCAGAGCAGGTGTGCTGTGCTG");
+    BOOST_REQUIRE_EQUAL(vptr->getAlt().size(),1u);
+    BOOST_REQUIRE_EQUAL(vptr->getAlt()[0],"TGCCCTTTGGCAGAGCAGGTGTGCTGTGCTG");
 
     vcfs.resetRegion("chr10:89717700-89717810");
 
@@ -108,8 +108,8 @@ BOOST_AUTO_TEST_CASE( test_vcf_streamer_region )
     BOOST_REQUIRE( ! vptr->is_snv() );
     BOOST_REQUIRE( vptr->is_normalized());
     BOOST_REQUIRE_EQUAL(vptr->pos, 89717769);
-    BOOST_REQUIRE_EQUAL(vptr->alt.size(),1u);
-    BOOST_REQUIRE_EQUAL(vptr->alt[0],"T");
+    BOOST_REQUIRE_EQUAL(vptr->getAlt().size(),1u);
+    BOOST_REQUIRE_EQUAL(vptr->getAlt()[0],"T");
 
     BOOST_REQUIRE_THROW( vcfs.next(), illumina::common::LogicException );
     vptr = vcfs.get_record_ptr();
@@ -123,8 +123,8 @@ BOOST_AUTO_TEST_CASE( test_vcf_streamer_region )
     BOOST_REQUIRE( ! vptr->is_snv() );
     BOOST_REQUIRE( ! vptr->is_normalized());
     BOOST_REQUIRE_EQUAL(vptr->pos, 89717774);
-    BOOST_REQUIRE_EQUAL(vptr->alt.size(),1u);
-    BOOST_REQUIRE_EQUAL(vptr->alt[0],"A");
+    BOOST_REQUIRE_EQUAL(vptr->getAlt().size(),1u);
+    BOOST_REQUIRE_EQUAL(vptr->getAlt()[0],"A");
 
     BOOST_REQUIRE_THROW( vcfs.next(), illumina::common::LogicException );
     vptr = vcfs.get_record_ptr();
@@ -138,8 +138,8 @@ BOOST_AUTO_TEST_CASE( test_vcf_streamer_region )
     BOOST_REQUIRE( ! vptr->is_snv() );
     BOOST_REQUIRE( ! vptr->is_normalized());
     BOOST_REQUIRE_EQUAL(vptr->pos, 89717775);
-    BOOST_REQUIRE_EQUAL(vptr->alt.size(),1u);
-    BOOST_REQUIRE_EQUAL(vptr->alt[0],"AA");
+    BOOST_REQUIRE_EQUAL(vptr->getAlt().size(),1u);
+    BOOST_REQUIRE_EQUAL(vptr->getAlt()[0],"AA");
 
     BOOST_REQUIRE( vcfs.next() );
     vptr = vcfs.get_record_ptr();
@@ -153,8 +153,8 @@ BOOST_AUTO_TEST_CASE( test_vcf_streamer_region )
     BOOST_REQUIRE( ! vptr->is_snv() );
     BOOST_REQUIRE( vptr->is_normalized());
     BOOST_REQUIRE_EQUAL(vptr->pos, 89717776);
-    BOOST_REQUIRE_EQUAL(vptr->alt.size(),1u);
-    BOOST_REQUIRE_EQUAL(vptr->alt[0],"AGT");
+    BOOST_REQUIRE_EQUAL(vptr->getAlt().size(),1u);
+    BOOST_REQUIRE_EQUAL(vptr->getAlt()[0],"AGT");
 
     BOOST_REQUIRE_THROW( vcfs.next(), illumina::common::LogicException );
     vptr = vcfs.get_record_ptr();
@@ -168,8 +168,8 @@ BOOST_AUTO_TEST_CASE( test_vcf_streamer_region )
     BOOST_REQUIRE( ! vptr->is_snv() );
     BOOST_REQUIRE( ! vptr->is_normalized());
     BOOST_REQUIRE_EQUAL(vptr->pos, 89717779);
-    BOOST_REQUIRE_EQUAL(vptr->alt.size(),1u);
-    BOOST_REQUIRE_EQUAL(vptr->alt[0],"AGG");
+    BOOST_REQUIRE_EQUAL(vptr->getAlt().size(),1u);
+    BOOST_REQUIRE_EQUAL(vptr->getAlt()[0],"AGG");
 
     BOOST_REQUIRE( vcfs.next() );
     vptr = vcfs.get_record_ptr();
@@ -185,8 +185,8 @@ BOOST_AUTO_TEST_CASE( test_vcf_streamer_region )
     BOOST_REQUIRE( ! vptr->is_snv() );
     BOOST_REQUIRE( vptr->is_normalized());
     BOOST_REQUIRE_EQUAL(vptr->pos, 89717782);
-    BOOST_REQUIRE_EQUAL(vptr->alt.size(),1u);
-    BOOST_REQUIRE_EQUAL(vptr->alt[0],"AGT");
+    BOOST_REQUIRE_EQUAL(vptr->getAlt().size(),1u);
+    BOOST_REQUIRE_EQUAL(vptr->getAlt()[0],"AGT");
 
     BOOST_REQUIRE_THROW( vcfs.next(), illumina::common::LogicException );
     vptr = vcfs.get_record_ptr();
@@ -200,8 +200,8 @@ BOOST_AUTO_TEST_CASE( test_vcf_streamer_region )
     BOOST_REQUIRE( vptr->is_snv() );
     BOOST_REQUIRE( ! vptr->is_normalized());
     BOOST_REQUIRE_EQUAL(vptr->pos, 89717785);
-    BOOST_REQUIRE_EQUAL(vptr->alt.size(),1u);
-    BOOST_REQUIRE_EQUAL(vptr->alt[0],"A");
+    BOOST_REQUIRE_EQUAL(vptr->getAlt().size(),1u);
+    BOOST_REQUIRE_EQUAL(vptr->getAlt()[0],"A");
 
     BOOST_REQUIRE_THROW( vcfs.next(), illumina::common::LogicException );
     vptr = vcfs.get_record_ptr();
@@ -215,8 +215,8 @@ BOOST_AUTO_TEST_CASE( test_vcf_streamer_region )
     BOOST_REQUIRE( ! vptr->is_snv() );
     BOOST_REQUIRE( ! vptr->is_normalized());
     BOOST_REQUIRE_EQUAL(vptr->pos, 89717785);
-    BOOST_REQUIRE_EQUAL(vptr->alt.size(),1u);
-    BOOST_REQUIRE_EQUAL(vptr->alt[0],"AC");
+    BOOST_REQUIRE_EQUAL(vptr->getAlt().size(),1u);
+    BOOST_REQUIRE_EQUAL(vptr->getAlt()[0],"AC");
 
     BOOST_REQUIRE( vcfs.next() );
     vptr = vcfs.get_record_ptr();
@@ -230,8 +230,8 @@ BOOST_AUTO_TEST_CASE( test_vcf_streamer_region )
     BOOST_REQUIRE( ! vptr->is_snv() );
     BOOST_REQUIRE( vptr->is_normalized());
     BOOST_REQUIRE_EQUAL(vptr->pos, 89717790);
-    BOOST_REQUIRE_EQUAL(vptr->alt.size(),1u);
-    BOOST_REQUIRE_EQUAL(vptr->alt[0],"AGCT");
+    BOOST_REQUIRE_EQUAL(vptr->getAlt().size(),1u);
+    BOOST_REQUIRE_EQUAL(vptr->getAlt()[0],"AGCT");
 
     BOOST_REQUIRE( vcfs.next() );
     vptr = vcfs.get_record_ptr();
@@ -51,6 +51,54 @@ stoupper(std::string& s)
 
 
 
+/// \return true if c is a valid base after conversion to upper case
+static
+bool
+isValidUpperBase(const char c)
+{
+    return is_valid_base(toupper((unsigned char)c));
+}
+
+
+
+static
+bool
+isEqualUpperBase(const char a, const char b)
+{
+    return (toupper((unsigned char)a) == toupper((unsigned char)b));
+}
+
+
+
+vcf_record&
+vcf_record::
+operator=(const vcf_record& rhs)
+{
+    if (this == &rhs) return *this;
+
+    pos = rhs.pos;
+    line = rhs.line;
+    _chromSpan = rhs._chromSpan;
+    _refSpan = rhs._refSpan;
+    _altSpan = rhs._altSpan;
+    _altCount = rhs._altCount;
+    _isChromParsed = false;
+    _isAlleleParsed = false;
+
+    if (nullptr == rhs._fields)
+    {
+        _fields = nullptr;
+    }
+    else
+    {
+        _fieldBuffer.assign(rhs._fields, (rhs._altSpan.offset + rhs._altSpan.size));
+        _fields = _fieldBuffer.c_str();
+    }
+    return *this;
+}
+
+
+
 bool
 vcf_record::
 set(const char* s)
@@ -61,11 +109,20 @@ set(const char* s)
     clear();
 
     line = s;
+    _fields = s;
 
     // simple tab parse:
     const char* start(s);
     const char* p(start);
 
+    auto getSpan = [&]()
+    {
+        FieldSpan span;
+        span.offset = (start-s);
+        span.size = (p-start);
+        return span;
+    };
+
     unsigned wordindex(0);
     while (wordindex<maxword)
     {
@@ -74,7 +131,7 @@ set(const char* s)
             switch (wordindex)
             {
             case 0:
-                chrom=std::string(start,p-start);
+                _chromSpan = getSpan();
                 break;
             case 1:
                 pos=illumina::blt_util::parse_int(start);
@@ -84,31 +141,21 @@ set(const char* s)
                 // skip this field...
                 break;
             case 3:
-                ref=std::string(start,p-start);
-                stoupper(ref);
+                _refSpan = getSpan();
                 break;
             case 4:
-                // additional parse loop for ',' character:
-            {
-                const char* p2(start);
+                _altSpan = getSpan();
 
-                while (p2<=p)
+                // recognize '.' value and leave alt empty in this case:
+                if ((_altSpan.size == 1) and (*start == '.'))
                 {
-                    if ((*p2 == ',') || (p2 == p))
-                    {
-                        // recognize '.' value and leave alt empty in this case:
-                        const bool isEmpty((p2==p) and alt.empty() and ((p2-start) == 1) and (*start == '.'));
-                        if (not isEmpty)
-                        {
-                            alt.emplace_back(start, p2 - start);
-                            stoupper(alt.back());
-                        }
-                        start = p2 + 1;
-                    }
-                    p2++;
+                    _altCount = 0;
                 }
-            }
-            break;
+                else
+                {
+                    _altCount = (1 + std::count(start, p, ','));
+                }
+                break;
             default:
                 assert(0);
                 break;
@@ -123,6 +170,171 @@ set(const char* s)
     return (wordindex >= maxword);
 }
 
+
+
+const std::string&
+vcf_record::
+getChrom() const
+{
+    if (not _isChromParsed)
+    {
+        if (nullptr == _fields)
+        {
+            _chrom.clear();
+        }
+        else
+        {
+            _chrom.assign(_chromSpan.begin(_fields), _chromSpan.size);
+        }
+        _isChromParsed = true;
+    }
+    return _chrom;
+}
+
+
+
+const std::string&
+vcf_record::
+getRef() const
+{
+    parseAlleles();
+    return _ref;
+}
+
+
+
+const std::vector<std::string>&
+vcf_record::
+getAlt() const
+{
+    parseAlleles();
+    return _alt;
+}
+
+
+
+bool
+vcf_record::
+getNextAltAllele(
+    unsigned& altIndex,
+    FieldSpan& allele) const
+{
+    if (altIndex >= _altCount) return false;
+
+    // each allele after the first starts just past the ',' which ends the previous allele:
+    const char* altBegin(_altSpan.begin(_fields));
+    const char* altEnd(altBegin+_altSpan.size);
+    const char* alleleBegin((altIndex == 0) ? altBegin : (allele.begin(_fields)+allele.size+1));
+    const char* alleleEnd(std::find(alleleBegin, altEnd, ','));
+    allele.offset = (alleleBegin-_fields);
+    allele.size = (alleleEnd-alleleBegin);
+    altIndex++;
+    return true;
+}
+
+
+
+void
+vcf_record::
+parseAlleles() const
+{
+    if (_isAlleleParsed) return;
+    _isAlleleParsed = true;
+
+    if (nullptr == _fields)
+    {
+        _ref.clear();
+        _alt.clear();
+        return;
+    }
+
+    _ref.assign(_refSpan.begin(_fields), _refSpan.size);
+    stoupper(_ref);
+
+    // reuse the existing allele strings to avoid reallocation from one record to the next:
+    _alt.resize(_altCount);
+    unsigned altIndex(0);
+    FieldSpan allele;
+    while (getNextAltAllele(altIndex, allele))
+    {
+        std::string& alt(_alt[altIndex-1]);
+        alt.assign(allele.begin(_fields), allele.size);
+        stoupper(alt);
+    }
+}
+
+
+
+bool
+vcf_record::
+isSimpleVariantLocus() const
+{
+    if (_refSpan.size == 0) return false;
+    if (_altCount == 0) return false;
+
+    auto isValidSpan = [&](const FieldSpan& span)
+    {
+        const char* begin(span.begin(_fields));
+        return std::all_of(begin, begin+span.size, isValidUpperBase);
+    };
+
+    if (! isValidSpan(_refSpan)) return false;
+    unsigned altIndex(0);
+    FieldSpan allele;
+    while (getNextAltAllele(altIndex, allele))
+    {
+        if (! isValidSpan(allele)) return false;
+    }
+    return true;
+}
+
+
+
+bool
+vcf_record::
+is_indel() const
+{
+    if (!isSimpleVariantLocus()) return false;
+    if ((_refSpan.size>1) && (_altCount>0)) return true;
+    unsigned altIndex(0);
+    FieldSpan allele;
+    while (getNextAltAllele(altIndex, allele))
+    {
+        if (allele.size>1) return true;
+    }
+    return false;
+}
+
+
+
+bool
+vcf_record::
+is_snv() const
+{
+    if (!isSimpleVariantLocus()) return false;
+    if (1 != _refSpan.size) return false;
+    unsigned altIndex(0);
+    FieldSpan allele;
+    while (getNextAltAllele(altIndex, allele))
+    {
+        if (1 != allele.size) return false;
+    }
+    return true;
+}
+
+
+
+bool
+vcf_record::
+is_ref_site() const
+{
+    if (1 != _refSpan.size) return false;
+    if (! isValidUpperBase(*_refSpan.begin(_fields))) return false;
+    return (_altCount == 0);
+}
+
+
+
 bool
 vcf_record::
 is_normalized() const
@@ -135,12 +347,16 @@ is_normalized() const
     // now, we're allowing variants to violate left-parsimony in MNVs and complex
     // alleles
     // see http://genome.sph.umich.edu/wiki/Variant_Normalization
-    unsigned ref_length = ref.size();
+    const char* ref(_refSpan.begin(_fields));
+    const unsigned ref_length(_refSpan.size);
     assert (ref_length != 0);
 
-    for (const auto& alt_allele : alt)
+    unsigned altIndex(0);
+    FieldSpan allele;
+    while (getNextAltAllele(altIndex, allele))
     {
-        unsigned alt_length = alt_allele.size();
+        const char* alt_allele(allele.begin(_fields));
+        const unsigned alt_length(allele.size);
         assert (alt_length != 0);
 
         // all normalized variants with the same length ref and alt
@@ -151,7 +367,7 @@ is_normalized() const
         if ((alt_length > 1 && ref_length > 1) ||
             alt_length == ref_length)
         {
-            if ((*alt_allele.rbegin()) == (*ref.rbegin()))
+            if (isEqualUpperBase(alt_allele[alt_length-1], ref[ref_length-1]))
             {
                 return false;
             }
@@ -160,12 +376,12 @@ is_normalized() const
         if (alt_length != ref_length)
         {
             // this checks that indels are reference-padded
-            if ( (*alt_allele.begin()) == (*ref.begin()))
+            if (isEqualUpperBase(alt_allele[0], ref[0]))
             {
                 // this checks that they're left-shifted
                 for (unsigned i = ref_length - 1, j = alt_length - 1; ; ++i, ++j)
                 {
-                    if (ref[i] != alt_allele[j])
+                    if (! isEqualUpperBase(ref[i], alt_allele[j]))
                     {
                         break;
                     }
@@ -185,16 +401,17 @@ is_normalized() const
 
 std::ostream& operator<<(std::ostream& os, const vcf_record& vcfr)
 {
-    os << vcfr.chrom << '\t'
+    os << vcfr.getChrom() << '\t'
        << vcfr.pos << '\t'
        << '.' << '\t'
-       << vcfr.ref << '\t';
+       << vcfr.getRef() << '\t';
 
-    const unsigned nalt(vcfr.alt.size());
+    const std::vector<std::string>& alt(vcfr.getAlt());
+    const unsigned nalt(alt.size());
     for (unsigned a(0); a<nalt; ++a)
     {
         if (a) os << ',';
-        os << vcfr.alt[a];
+        os << alt[a];
     }
     os << '\t'
        << '.' << '\t'
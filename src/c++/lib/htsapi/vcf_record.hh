@@ -31,6 +31,13 @@
 #include <vector>
 
 
+/// a vcf record parsed from a record string, such as the current line of a vcf_streamer
+///
+/// Only POS is parsed when the record is set. CHROM, REF and ALT are located in the record string without
+/// copying, so that the variant type tests below do not allocate, and owned copies of these fields are only
+/// created on first access. The record string must outlive all access to the record, copying the record
+/// copies the CHROM, REF and ALT text (but not the full record line).
+///
 struct vcf_record
 {
     vcf_record()
@@ -38,16 +45,45 @@ struct vcf_record
         clear();
     }
 
+    vcf_record(const vcf_record& rhs)
+    {
+        *this = rhs;
+    }
+
+    vcf_record&
+    operator=(const vcf_record& rhs);
+
     /// set the vcf record from record string s, return false on error
     bool set(const char* s);
 
     void clear()
     {
-        chrom.clear();
         pos=0;
-        ref.clear();
-        alt.clear();
         line=nullptr;
+        _fields=nullptr;
+        _chromSpan = FieldSpan();
+        _refSpan = FieldSpan();
+        _altSpan = FieldSpan();
+        _altCount = 0;
+        _isChromParsed=false;
+        _isAlleleParsed=false;
+    }
+
+    const std::string&
+    getChrom() const;
+
+    /// upper-case REF sequence
+    const std::string&
+    getRef() const;
+
+    /// upper-case ALT sequences, this is empty if the ALT field is '.'
+    const std::vector<std::string>&
+    getAlt() const;
+
+    unsigned
+    getAltCount() const
+    {
+        return _altCount;
     }
 
     /// test if the variant represents a "simple" SNV or small indel
@@ -58,61 +94,68 @@ struct vcf_record
     // the <DEL> symbolic allele and the END INFO field.  This
     // is probably fine, but worth noting
     bool
-    isSimpleVariantLocus() const
-    {
-        if (ref.empty()) return false;
-        if (alt.empty()) return false;
-        if (! is_valid_seq(ref.c_str())) return false;
-        for (const auto& alt_allele : alt)
-        {
-            if (! is_valid_seq(alt_allele.c_str())) return false;
-        }
-        return true;
-    }
+    isSimpleVariantLocus() const;
 
     /// check for REF or ALT alleles with a size > 1, alleles with equal length REF and ALT sequences will
     /// count as an indel
     bool
-    is_indel() const
-    {
-        if (!isSimpleVariantLocus()) return false;
-        if ((ref.size()>1) && (alt.size()>0)) return true;
-        for (const auto& alt_allele : alt)
-        {
-            if (alt_allele.size()>1) return true;
-        }
-        return false;
-    }
+    is_indel() const;
 
     bool
-    is_snv() const
-    {
-        if (!isSimpleVariantLocus()) return false;
-        if (1 != ref.size()) return false;
-        for (const auto& alt_allele : alt)
-        {
-            if (1 != alt_allele.size()) return false;
-        }
-        return true;
-    }
+    is_snv() const;
 
     /// complements is_snv() by taking case of the form: REF="A", ALT="."
     bool
-    is_ref_site() const
-    {
-        if (ref.empty()) return false;
-        if (! is_valid_seq(ref.c_str())) return false;
-        if (1 != ref.size()) return false;
-        return (alt.empty());
-    }
+    is_ref_site() const;
 
     bool is_normalized() const;
 
-    std::string chrom;
     int pos = 0;
-    std::string ref;
-    std::vector<std::string> alt;
     const char* line = nullptr;
+
+private:
+    /// location of one field, relative to _fields
+    struct FieldSpan
+    {
+        const char*
+        begin(const char* fields) const
+        {
+            return fields+offset;
+        }
+
+        unsigned offset = 0;
+        unsigned size = 0;
+    };
+
+    /// get the next ALT allele from the ALT field
+    ///
+    /// \param[in,out] altIndex number of alleles returned so far, start iteration from 0
+    /// \param[in,out] allele the previous allele, set to the next allele
+    /// \return false if there are no more ALT alleles
+    bool
+    getNextAltAllele(
+        unsigned& altIndex,
+        FieldSpan& allele) const;
+
+    void
+    parseAlleles() const;
+
+    /// start of the CHROM..ALT field text, in the record string or in _fieldBuffer
+    const char* _fields;
+
+    /// owned copy of the CHROM..ALT field text for copied records
+    std::string _fieldBuffer;
+
+    FieldSpan _chromSpan;
+    FieldSpan _refSpan;
+    FieldSpan _altSpan;
+    unsigned _altCount;
+
+    mutable bool _isChromParsed;
+    mutable bool _isAlleleParsed;
+    mutable std::string _chrom;
+    mutable std::string _ref;
+    mutable std::vector<std::string> _alt;
 };
 
 
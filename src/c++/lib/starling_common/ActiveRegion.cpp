@@ -25,6 +25,9 @@
 #include <boost/algorithm/string.hpp>
 #include "ActiveRegion.hh"
 
+#include <algorithm>
+#include <unordered_map>
+
 // adoptation of get_snp_hpol_size in blt_common
 static unsigned getHomoPolymerSize(const std::string& haplotype, const pos_t pos)
 {
@@ -82,16 +85,20 @@ static bool isHomoPolymer(const std::string& haplotype)
 
 void ActiveRegion::insertHaplotypeBase(align_id_t alignId, pos_t pos, const std::string& base)
 {
-    if (!_alignIdToHaplotype.count(alignId))
+    AlignHaplotype& alignHaplotype(_alignIdToHaplotype[alignId]);
+    if (!alignHaplotype.isStarted)
     {
         // first occurrence of this alignment
-        _alignIdToHaplotype[alignId] = std::string();
-        for (int i=_posRange.begin_pos; i<pos; ++i)
-            _alignIdToHaplotype[alignId] += missingPrefix;
+        alignHaplotype.isStarted = true;
+        alignHaplotype.isMissingPrefix = (pos > _posRange.begin_pos);
     }
-    _alignIdToHaplotype[alignId] += base;
+
+    // haplotypes of alignments which do not cover the start of the active region are never used
+    if (!alignHaplotype.isMissingPrefix)
+        alignHaplotype.haplotypeId = _haplotypes.extend(alignHaplotype.haplotypeId, base);
+
     if (pos == (_posRange.end_pos-1))
-        _alignIdReachingEnd.insert(alignId);
+        alignHaplotype.isReachingEnd = true;
 }
 
 void ActiveRegion::processHaplotypes(IndelBuffer& indelBuffer, RangeSet& polySites) const
@@ -103,10 +110,61 @@ void ActiveRegion::processHaplotypes(IndelBuffer& indelBuffer, RangeSet& polySit
     }
 }
 
+namespace
+{
+
+/// index of all prefixes and suffixes of a set of sequences, used to match haplotypes to soft-clipped reads
+struct PrefixSuffixIndex
+{
+    /// add all prefixes and suffixes of seq under sequence index seqIndex
+    void
+    addSequence(
+        const std::string& seq,
+        const unsigned seqIndex)
+    {
+        HaplotypeHash::getPrefixHashes(seq, _prefixHash);
+        HaplotypeHash::getBasePowers(seq.size(), _basePower);
+        const unsigned seqLength(seq.size());
+        for (unsigned length(1); length<=seqLength; ++length)
+        {
+            const uint64_t suffixHash(_prefixHash[seqLength] - (_prefixHash[seqLength-length] * _basePower[length]));
+            _index.emplace(HaplotypeKey(_prefixHash[length], length), seqIndex);
+            if (suffixHash != _prefixHash[length])
+                _index.emplace(HaplotypeKey(suffixHash, length), seqIndex);
+        }
+    }
+
+    /// get all sequence indices which may have a prefix or suffix matching key
+    ///
+    /// the result may contain duplicates and hash collisions, so matches must be verified by the caller
+    template <typename Func>
+    void
+    forEachCandidate(
+        const HaplotypeKey& key,
+        Func func) const
+    {
+        const auto range(_index.equal_range(key));
+        for (auto iter(range.first); iter != range.second; ++iter)
+        {
+            func(iter->second);
+        }
+    }
+
+private:
+    std::unordered_multimap<HaplotypeKey,unsigned,HaplotypeKey::Hasher> _index;
+    std::vector<uint64_t> _prefixHash;
+    std::vector<uint64_t> _basePower;
+};
+
+}
+
 void ActiveRegion::processHaplotypes(IndelBuffer& indelBuffer, RangeSet& polySites, unsigned sampleId) const
 {
-    std::map<std::string, std::vector<align_id_t>> haplotypeToAlignIdSet;
-    std::vector<std::pair<std::string, align_id_t>> softClippedReads;
+    typedef HaplotypeStore::haplotype_id_t haplotype_id_t;
+
+    // group alignments by interned haplotype
+    std::map<haplotype_id_t, std::vector<align_id_t>> haplotypeIdToAlignIdSet;
+    std::vector<std::pair<haplotype_id_t, align_id_t>> softClippedReads;
     for (const auto& entry : _alignIdToHaplotype)
     {
         align_id_t alignId = entry.first;
@@ -114,41 +172,95 @@ void ActiveRegion::processHaplotypes(IndelBuffer& indelBuffer, RangeSet& polySit
 
         if (currentSampleId != sampleId) continue;
 
-        const std::string& haplotype(entry.second);
+        const AlignHaplotype& alignHaplotype(entry.second);
 
         // ignore if the read does not cover the start of the active region
-        if (haplotype.empty() || haplotype[0] == missingPrefix) continue;
+        if (alignHaplotype.isMissingPrefix || (_haplotypes.getLength(alignHaplotype.haplotypeId) == 0)) continue;
 
         // ignore if the read does not reach the end of the active region
-        if (_alignIdReachingEnd.find(alignId) == _alignIdReachingEnd.end()) continue;
+        if (!alignHaplotype.isReachingEnd) continue;
 
         // separate soft-clipped reads
-        if (_alignIdSoftClipped.find(alignId) != _alignIdSoftClipped.end())
+        if (alignHaplotype.isSoftClipped)
         {
-            softClippedReads.push_back(std::pair<std::string, align_id_t>(haplotype, alignId));
+            softClippedReads.emplace_back(alignHaplotype.haplotypeId, alignId);
             continue;
         }
 
-        if (!haplotypeToAlignIdSet.count(haplotype))
-            haplotypeToAlignIdSet[haplotype] = std::vector<align_id_t>();
-        haplotypeToAlignIdSet[haplotype].push_back(alignId);
+        haplotypeIdToAlignIdSet[alignHaplotype.haplotypeId].push_back(alignId);
     }
 
-    // match soft-clipped reads to haplotypes
-    for (auto& entry : haplotypeToAlignIdSet)
+    // order haplotypes by sequence
+    struct HaplotypeAlignIds
     {
-        const std::string& haplotype(entry.first);
-        auto& alignIdList(entry.second);
+        haplotype_id_t haplotypeId;
+        std::string haplotype;
+        std::vector<align_id_t> alignIdList;
+    };
+    std::vector<HaplotypeAlignIds> haplotypeToAlignIdSet;
+    for (auto& entry : haplotypeIdToAlignIdSet)
+    {
+        haplotypeToAlignIdSet.emplace_back();
+        HaplotypeAlignIds& haplotypeAlignIds(haplotypeToAlignIdSet.back());
+        haplotypeAlignIds.haplotypeId = entry.first;
+        _haplotypes.getSequence(entry.first, haplotypeAlignIds.haplotype);
+        haplotypeAlignIds.alignIdList.swap(entry.second);
+    }
+    std::sort(haplotypeToAlignIdSet.begin(), haplotypeToAlignIdSet.end(),
+              [](const HaplotypeAlignIds& lhs, const HaplotypeAlignIds& rhs)
+    {
+        return (lhs.haplotype < rhs.haplotype);
+    });
 
+    // match soft-clipped reads to haplotypes
+    if (!softClippedReads.empty())
+    {
+        // index prefixes and suffixes of each distinct soft-clipped read haplotype
+        std::unordered_map<haplotype_id_t, unsigned> softClippedHaplotypeIndex;
+        std::vector<std::string> softClippedHaplotypes;
+        std::vector<unsigned> softClippedReadHaplotypeIndex;
+        PrefixSuffixIndex softClippedIndex;
         for (const auto& softClipEntry : softClippedReads)
         {
-            const std::string& softClippedRead(softClipEntry.first);
-            // checks if the haplotype matches a prefix or suffix
-            if (boost::starts_with(softClippedRead, haplotype)
-                or boost::ends_with(softClippedRead, haplotype))
+            const auto insertResult(softClippedHaplotypeIndex.insert(
+                std::make_pair(softClipEntry.first, softClippedHaplotypes.size())));
+            softClippedReadHaplotypeIndex.push_back(insertResult.first->second);
+            if (!insertResult.second) continue;
+
+            softClippedHaplotypes.emplace_back();
+            _haplotypes.getSequence(softClipEntry.first, softClippedHaplotypes.back());
+            softClippedIndex.addSequence(softClippedHaplotypes.back(), insertResult.first->second);
+        }
+
+        std::vector<bool> isMatched(softClippedHaplotypes.size());
+        for (auto& entry : haplotypeToAlignIdSet)
+        {
+            const std::string& haplotype(entry.haplotype);
+            const HaplotypeKey key(_haplotypes.getHash(entry.haplotypeId), haplotype.size());
+
+            std::fill(isMatched.begin(), isMatched.end(), false);
+            bool isAnyMatched(false);
+            softClippedIndex.forEachCandidate(key, [&](const unsigned haplotypeIndex)
             {
-                align_id_t alignId(softClipEntry.second);
-                alignIdList.push_back(alignId);
+                if (isMatched[haplotypeIndex]) return;
+                const std::string& softClippedRead(softClippedHaplotypes[haplotypeIndex]);
+                // checks if the haplotype matches a prefix or suffix
+                if (boost::starts_with(softClippedRead, haplotype)
+                    or boost::ends_with(softClippedRead, haplotype))
+                {
+                    isMatched[haplotypeIndex] = true;
+                    isAnyMatched = true;
+                }
+            });
+            if (!isAnyMatched) continue;
+
+            const unsigned softClippedReadCount(softClippedReads.size());
+            for (unsigned readIndex(0); readIndex<softClippedReadCount; ++readIndex)
+            {
+                if (isMatched[softClippedReadHaplotypeIndex[readIndex]])
+                {
+                    entry.alignIdList.push_back(softClippedReads[readIndex].second);
+                }
             }
         }
     }
@@ -160,7 +272,7 @@ void ActiveRegion::processHaplotypes(IndelBuffer& indelBuffer, RangeSet& polySit
     unsigned totalCount = 0;
     for (const auto& entry : haplotypeToAlignIdSet)
     {
-        auto count = entry.second.size();
+        auto count = entry.alignIdList.size();
 
         totalCount += count;
         if (count > thirdLargestCount)
@@ -188,13 +300,12 @@ void ActiveRegion::processHaplotypes(IndelBuffer& indelBuffer, RangeSet& polySit
 //    std::cout << '>' << _posRange.begin_pos+1 << '\t' << _posRange.end_pos << '\t' << _refSeq << '\t' << totalCount << std::endl;
     for (const auto& entry : haplotypeToAlignIdSet)
     {
-        const std::string& haplotype(entry.first);
-        if (haplotype.empty() || haplotype[0] == missingPrefix) continue;
+        const std::string& haplotype(entry.haplotype);
 
         // ignore if haplotype is a long homopolymer
         if (haplotype.length() > MaxSNVHpolSize and isHomoPolymer(haplotype)) continue;
 
-        const auto& alignIdList(entry.second);
+        const auto& alignIdList(entry.alignIdList);
         auto count = alignIdList.size();
 
 //        if (count >= thirdLargestCount)
@@ -219,7 +330,7 @@ void ActiveRegion::convertToPrimitiveAlleles(
     RangeSet& polySites) const
 {
     AlignmentResult<int> result;
-    _aligner.align(haploptypeSeq.begin(),haploptypeSeq.end(),_refSeq.begin(),_refSeq.end(),result);
+    _aligner.alignBanded(haploptypeSeq.begin(),haploptypeSeq.end(),_refSeq.begin(),_refSeq.end(),_maxIndelSize,result);
     const ALIGNPATH::path_t& alignPath = result.align.apath;
 
     pos_t referencePos = _posRange.begin_pos;
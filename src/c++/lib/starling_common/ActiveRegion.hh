@@ -28,11 +28,11 @@
 #include "starling_common/starling_types.hh"
 #include "alignment/GlobalAligner.hh"
 #include "blt_util/align_path.hh"
+#include "HaplotypeStore.hh"
 #include "IndelBuffer.hh"
 
 #include <string>
 #include <map>
-#include <set>
 
 typedef std::vector<RangeMap<pos_t,unsigned char>> RangeSet;
 
@@ -63,8 +63,6 @@ public:
     // minimum haplotype frequency to relax MMDF
     const float HaplotypeFrequencyThreshold = 0.4;
 
-    const char missingPrefix = '.';
-
     /// Creates an active region object
     /// \param posRange position range of the active region
     /// \param ref reference
@@ -113,7 +111,7 @@ public:
     /// \param alignId align id
     void setSoftClipped(const align_id_t alignId)
     {
-        _alignIdSoftClipped.insert(alignId);
+        _alignIdToHaplotype[alignId].isSoftClipped = true;
     }
 
 private:
@@ -125,9 +123,19 @@ private:
     const GlobalAligner<int> _aligner;
     const std::vector<AlignInfo>&  _alignIdToAlignInfo;
 
-    std::map<align_id_t, std::string> _alignIdToHaplotype;
-    std::set<align_id_t> _alignIdReachingEnd;
-    std::set<align_id_t> _alignIdSoftClipped;
+    /// haplotype of one alignment within the active region
+    struct AlignHaplotype
+    {
+        HaplotypeStore::haplotype_id_t haplotypeId = HaplotypeStore::emptyHaplotypeId;
+        bool isStarted = false;
+        // true if the alignment does not cover the start of the active region
+        bool isMissingPrefix = false;
+        bool isReachingEnd = false;
+        bool isSoftClipped = false;
+    };
+
+    HaplotypeStore _haplotypes;
+    std::map<align_id_t, AlignHaplotype> _alignIdToHaplotype;
 
     void processHaplotypes(IndelBuffer& indelBuffer, RangeSet& polySites, unsigned sampleId) const;
 
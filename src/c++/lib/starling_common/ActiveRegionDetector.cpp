@@ -151,11 +151,11 @@ ActiveRegionDetector::updateEndPosition(const pos_t pos, const bool isLastPos)
             _activeRegions.emplace_back(newActiveRegion, _ref, _maxIndelSize, _sampleCount, _aligner, _alignIdToAlignInfo);
             auto& activeRegion(_activeRegions.back());
             // add haplotype bases
+            std::string haplotypeBase;
             for (pos_t activeRegionPos(newActiveRegion.begin_pos); activeRegionPos<newActiveRegion.end_pos; ++activeRegionPos)
             {
                 for (const align_id_t alignId : getPositionToAlignIds(activeRegionPos))
                 {
-                    std::string haplotypeBase;
                     bool isSoftClipped = setHaplotypeBase(alignId, activeRegionPos, haplotypeBase);
                     if (isSoftClipped)
                         activeRegion.setSoftClipped(alignId);
@@ -279,7 +279,7 @@ void ActiveRegionDetector::setSoftClipSegment(const align_id_t id, const pos_t p
     unsigned idIndex = id % MaxDepth;
     unsigned posIndex = pos % MaxBufferSize;
     _variantInfo[idIndex][posIndex] = SOFT_CLIP;
-    _insertSeqBuffer[idIndex][posIndex] = segmentSeq;
+    setInsertSeq(idIndex, posIndex, segmentSeq);
 }
 
 void ActiveRegionDetector::setDelete(const align_id_t id, const pos_t pos)
@@ -292,7 +292,7 @@ void ActiveRegionDetector::setInsert(const align_id_t id, const pos_t pos, const
     unsigned idIndex = id % MaxDepth;
     unsigned posIndex = pos % MaxBufferSize;
     _variantInfo[idIndex][posIndex] = (_variantInfo[idIndex][posIndex] == MISMATCH ? MISMATCH_INSERT : INSERT);
-    _insertSeqBuffer[idIndex][posIndex] = insertSeq;
+    setInsertSeq(idIndex, posIndex, insertSeq);
 }
 
 bool ActiveRegionDetector::setHaplotypeBase(const align_id_t id, const pos_t pos, std::string& base) const
@@ -303,28 +303,71 @@ bool ActiveRegionDetector::setHaplotypeBase(const align_id_t id, const pos_t pos
     switch (variant)
     {
     case MATCH:
-        base = _ref.get_base(pos);
+        base.assign(1, _ref.get_base(pos));
         break;
     case MISMATCH:
-        base = std::string(1, _snvBuffer[idIndex][posIndex]);
+        base.assign(1, _snvBuffer[idIndex][posIndex]);
         break;
     case DELETE:
-        base = "";
+        base.clear();
         break;
     case INSERT:
-        base = _ref.get_base(pos) + _insertSeqBuffer[idIndex][posIndex];
+        base.assign(1, _ref.get_base(pos));
+        appendInsertSeq(idIndex, posIndex, base);
         break;
     case SOFT_CLIP:
-        base = _insertSeqBuffer[idIndex][posIndex];
+        base.clear();
+        appendInsertSeq(idIndex, posIndex, base);
         break;
     case MISMATCH_INSERT:
-        base = _snvBuffer[idIndex][posIndex] + _insertSeqBuffer[idIndex][posIndex];
+        base.assign(1, _snvBuffer[idIndex][posIndex]);
+        appendInsertSeq(idIndex, posIndex, base);
     }
 
     bool isSoftClipped = (variant == SOFT_CLIP);
     return isSoftClipped;
 }
 
+void ActiveRegionDetector::setInsertSeq(const unsigned idIndex, const unsigned posIndex, const std::string& insertSeq)
+{
+    if ((_insertSeqPool.size() + insertSeq.size()) > _maxInsertSeqPoolSize)
+    {
+        compactInsertSeqPool();
+        // keep the pool at least twice the size of its live content so that compaction cost is amortized
+        while ((_insertSeqPool.size() + insertSeq.size())*2 > _maxInsertSeqPoolSize)
+            _maxInsertSeqPoolSize *= 2;
+    }
+
+    InsertSeqRef& insertSeqRef(_insertSeqRefs[idIndex*MaxBufferSize + posIndex]);
+    insertSeqRef.offset = _insertSeqPool.size();
+    insertSeqRef.length = insertSeq.size();
+    _insertSeqPool.append(insertSeq);
+}
+
+void ActiveRegionDetector::compactInsertSeqPool()
+{
+    std::string newPool;
+    for (unsigned idIndex(0); idIndex<MaxDepth; ++idIndex)
+    {
+        for (unsigned posIndex(0); posIndex<MaxBufferSize; ++posIndex)
+        {
+            InsertSeqRef& insertSeqRef(_insertSeqRefs[idIndex*MaxBufferSize + posIndex]);
+            const auto variant = _variantInfo[idIndex][posIndex];
+            if ((variant == INSERT) or (variant == SOFT_CLIP) or (variant == MISMATCH_INSERT))
+            {
+                const uint32_t newOffset(newPool.size());
+                newPool.append(_insertSeqPool, insertSeqRef.offset, insertSeqRef.length);
+                insertSeqRef.offset = newOffset;
+            }
+            else
+            {
+                insertSeqRef = InsertSeqRef();
+            }
+        }
+    }
+    _insertSeqPool.swap(newPool);
+}
+
 bool
 ActiveRegionDetector::isCandidateVariant(const pos_t pos) const
 {
@@ -30,6 +30,8 @@
 #include "indel.hh"
 #include "IndelBuffer.hh"
 
+#include <cstdint>
+
 #include <vector>
 #include <list>
 #include <set>
@@ -99,7 +101,8 @@ public:
         _positionToAlignIds(MaxBufferSize),
         _alignIdToAlignInfo(MaxDepth),
         _variantInfo(MaxDepth, std::vector<VariantType>(MaxBufferSize, VariantType())),
-        _insertSeqBuffer(MaxDepth, std::vector<std::string>(MaxBufferSize, std::string())),
+        _insertSeqRefs(MaxDepth*MaxBufferSize),
+        _maxInsertSeqPoolSize(MinInsertSeqPoolCompactionSize),
         _polySites(sampleCount),
         _aligner(AlignmentScores<int>(ScoreMatch, ScoreMismatch, ScoreOpen, ScoreExtend, ScoreOffEdge, ScoreOpen, true, true))
     {
@@ -199,7 +202,22 @@ private:
     std::vector<AlignInfo> _alignIdToAlignInfo;
 
     std::vector<std::vector<VariantType>> _variantInfo;
-    std::vector<std::vector<std::string>> _insertSeqBuffer;
+
+    /// location of an insertion or soft-clip sequence in _insertSeqPool
+    struct InsertSeqRef
+    {
+        uint32_t offset = 0;
+        uint32_t length = 0;
+    };
+
+    // minimum pool size before stale sequences are compacted out of the insert sequence pool
+    static const unsigned MinInsertSeqPoolCompactionSize = 1u << 20;
+
+    // insertion and soft-clip sequences of each (align id, position) buffer slot are pooled in a single string,
+    // this is compacted when it grows past _maxInsertSeqPoolSize
+    std::vector<InsertSeqRef> _insertSeqRefs;
+    std::string _insertSeqPool;
+    unsigned _maxInsertSeqPoolSize;
     char _snvBuffer[MaxDepth][MaxBufferSize];
 
     // record polymorphic sites
@@ -262,6 +280,17 @@ private:
 
     bool setHaplotypeBase(const align_id_t id, const pos_t pos, std::string& base) const;
 
+    void setInsertSeq(const unsigned idIndex, const unsigned posIndex, const std::string& insertSeq);
+
+    inline void appendInsertSeq(const unsigned idIndex, const unsigned posIndex, std::string& base) const
+    {
+        const InsertSeqRef& insertSeqRef(_insertSeqRefs[idIndex*MaxBufferSize + posIndex]);
+        base.append(_insertSeqPool, insertSeqRef.offset, insertSeqRef.length);
+    }
+
+    /// remove sequences no longer referenced by any insert or soft-clip buffer slot from the insert sequence pool
+    void compactInsertSeqPool();
+
     inline void clearPos(pos_t pos)
     {
         _positionToAlignIds[pos % MaxBufferSize].clear();
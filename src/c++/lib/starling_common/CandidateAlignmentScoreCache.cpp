@@ -0,0 +1,58 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "CandidateAlignmentScoreCache.hh"
+#include "starling_read_align_score.hh"
+
+#include <tuple>
+
+
+
+bool
+CandidateAlignmentScoreCache::ExpectedBasesKeyCompare::
+operator()(
+    const candidate_alignment& lhs,
+    const candidate_alignment& rhs) const
+{
+    return (std::tie(lhs.al.pos, lhs.al.path, lhs.getIndels(), lhs.leading_indel_key, lhs.trailing_indel_key) <
+            std::tie(rhs.al.pos, rhs.al.path, rhs.getIndels(), rhs.leading_indel_key, rhs.trailing_indel_key));
+}
+
+
+
+double
+CandidateAlignmentScoreCache::
+score(
+    const IndelBuffer& indelBuffer,
+    const read_segment& rseg,
+    const candidate_alignment& cal,
+    const reference_contig_segment& ref,
+    bool& isCacheHit)
+{
+    auto iter(_expectedBases.find(cal));
+    isCacheHit = (iter != _expectedBases.end());
+    if (not isCacheHit)
+    {
+        std::vector<uint8_t> expectedBases;
+        get_candidate_alignment_expected_bases(indelBuffer, rseg.read_size(), cal, ref, expectedBases);
+        iter = _expectedBases.emplace(cal, std::move(expectedBases)).first;
+    }
+    return score_candidate_alignment_expected_bases(rseg, iter->second);
+}
@@ -0,0 +1,75 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#pragma once
+
+#include "candidate_alignment.hh"
+
+#include "starling_common/IndelBuffer.hh"
+#include "starling_common/starling_read.hh"
+
+#include <cstdint>
+
+#include <map>
+#include <vector>
+
+
+/// cache of the read bases expected under each candidate alignment evaluated in one realignment window
+///
+/// Reads starting at the same position frequently produce the same candidate alignments. The bases
+/// expected under a candidate alignment only depend on the alignment path, its indels and the reference,
+/// so these are cached and each subsequent read sharing the candidate only requires a base quality pass.
+///
+/// The cache must be cleared whenever the realignment window moves, or the indel buffer or reference change.
+///
+struct CandidateAlignmentScoreCache
+{
+    void
+    clear()
+    {
+        _expectedBases.clear();
+    }
+
+    /// return score of candidate alignment cal for read segment rseg, see score_candidate_alignment_expected_bases
+    ///
+    /// \param[out] isCacheHit true if the expected bases for cal were already in the cache
+    double
+    score(
+        const IndelBuffer& indelBuffer,
+        const read_segment& rseg,
+        const candidate_alignment& cal,
+        const reference_contig_segment& ref,
+        bool& isCacheHit);
+
+private:
+
+    /// order candidate alignments by all fields which determine the expected read bases
+    ///
+    /// this is the same as candidate_alignment ordering except that strand is ignored
+    struct ExpectedBasesKeyCompare
+    {
+        bool
+        operator()(
+            const candidate_alignment& lhs,
+            const candidate_alignment& rhs) const;
+    };
+
+    std::map<candidate_alignment,std::vector<uint8_t>,ExpectedBasesKeyCompare> _expectedBases;
+};
@@ -0,0 +1,167 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "HaplotypeStore.hh"
+
+#include <cassert>
+
+#include <algorithm>
+
+
+
+void
+HaplotypeHash::
+getPrefixHashes(
+    const std::string& seq,
+    std::vector<uint64_t>& prefixHash)
+{
+    prefixHash.resize(seq.size()+1);
+    prefixHash[0] = 0;
+    for (unsigned i(0); i<seq.size(); ++i)
+    {
+        prefixHash[i+1] = extend(prefixHash[i], seq[i]);
+    }
+}
+
+
+
+void
+HaplotypeHash::
+getBasePowers(
+    const unsigned maxLength,
+    std::vector<uint64_t>& basePower)
+{
+    if (basePower.size() > maxLength) return;
+    const unsigned startLength(basePower.size());
+    basePower.resize(maxLength+1);
+    if (startLength == 0) basePower[0] = 1;
+    for (unsigned i(std::max(1u,startLength)); i<=maxLength; ++i)
+    {
+        basePower[i] = basePower[i-1] * base;
+    }
+}
+
+
+
+void
+HaplotypeStore::
+clear()
+{
+    _haplotypes.clear();
+    _segmentPool.clear();
+    _haplotypeIndex.clear();
+
+    HaplotypeNode emptyHaplotype;
+    emptyHaplotype.parentId = emptyHaplotypeId;
+    emptyHaplotype.length = 0;
+    emptyHaplotype.hash = 0;
+    emptyHaplotype.segmentOffset = 0;
+    emptyHaplotype.segmentLength = 0;
+    _haplotypes.push_back(emptyHaplotype);
+}
+
+
+
+HaplotypeStore::haplotype_id_t
+HaplotypeStore::
+extend(
+    const haplotype_id_t parentId,
+    const std::string& segment)
+{
+    if (segment.empty()) return parentId;
+
+    assert(parentId < _haplotypes.size());
+
+    HaplotypeKey key;
+    key.hash = _haplotypes[parentId].hash;
+    for (const char c : segment)
+    {
+        key.hash = HaplotypeHash::extend(key.hash, c);
+    }
+    key.length = _haplotypes[parentId].length + segment.size();
+
+    const auto range(_haplotypeIndex.equal_range(key));
+    for (auto iter(range.first); iter != range.second; ++iter)
+    {
+        if (isSameHaplotype(iter->second, parentId, segment)) return iter->second;
+    }
+
+    HaplotypeNode haplotype;
+    haplotype.parentId = parentId;
+    haplotype.length = key.length;
+    haplotype.hash = key.hash;
+    haplotype.segmentOffset = _segmentPool.size();
+    haplotype.segmentLength = segment.size();
+    _segmentPool.append(segment);
+
+    const haplotype_id_t haplotypeId(_haplotypes.size());
+    _haplotypes.push_back(haplotype);
+    _haplotypeIndex.emplace(key, haplotypeId);
+    return haplotypeId;
+}
+
+
+
+void
+HaplotypeStore::
+getSequence(
+    const haplotype_id_t haplotypeId,
+    std::string& seq) const
+{
+    assert(haplotypeId < _haplotypes.size());
+
+    seq.resize(_haplotypes[haplotypeId].length);
+    unsigned endPos(seq.size());
+    haplotype_id_t id(haplotypeId);
+    while (id != emptyHaplotypeId)
+    {
+        const HaplotypeNode& haplotype(_haplotypes[id]);
+        endPos -= haplotype.segmentLength;
+        std::copy_n(_segmentPool.begin() + haplotype.segmentOffset, haplotype.segmentLength, seq.begin() + endPos);
+        id = haplotype.parentId;
+    }
+    assert(endPos == 0);
+}
+
+
+
+bool
+HaplotypeStore::
+isSameHaplotype(
+    const haplotype_id_t haplotypeId,
+    const haplotype_id_t parentId,
+    const std::string& segment) const
+{
+    const HaplotypeNode& haplotype(_haplotypes[haplotypeId]);
+
+    // common case: the haplotype was created from the same parent and segment
+    if (haplotype.parentId == parentId)
+    {
+        return (_segmentPool.compare(haplotype.segmentOffset, haplotype.segmentLength, segment) == 0);
+    }
+
+    // otherwise the haplotype was built from different segments or this is a hash collision, so compare sequences:
+    std::string haplotypeSeq;
+    getSequence(haplotypeId, haplotypeSeq);
+    std::string querySeq;
+    getSequence(parentId, querySeq);
+    querySeq.append(segment);
+    return (haplotypeSeq == querySeq);
+}
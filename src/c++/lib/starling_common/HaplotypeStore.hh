@@ -0,0 +1,171 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#pragma once
+
+#include <cstdint>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+/// polynomial rolling hash over a base sequence
+///
+/// The hash of a sequence does not depend on how it was split into appended segments, and the hash of any
+/// substring can be found from the prefix hashes, so this can be used to match haplotypes to read prefixes
+/// and suffixes. All arithmetic is modulo 2^64.
+struct HaplotypeHash
+{
+    static const uint64_t base = 0x100000001b3ull;
+
+    static
+    uint64_t
+    extend(
+        const uint64_t hash,
+        const char c)
+    {
+        return (hash * base) + static_cast<unsigned char>(c);
+    }
+
+    /// fill prefixHash so that prefixHash[i] is the hash of seq[0,i)
+    static
+    void
+    getPrefixHashes(
+        const std::string& seq,
+        std::vector<uint64_t>& prefixHash);
+
+    /// fill basePower so that basePower[i] is base^i, for i in [0,maxLength]
+    static
+    void
+    getBasePowers(
+        const unsigned maxLength,
+        std::vector<uint64_t>& basePower);
+};
+
+
+/// key for haplotype lookup by hash plus length
+struct HaplotypeKey
+{
+    HaplotypeKey(
+        const uint64_t initHash = 0,
+        const unsigned initLength = 0)
+        : hash(initHash), length(initLength)
+    {}
+
+    bool
+    operator==(const HaplotypeKey& rhs) const
+    {
+        return ((hash == rhs.hash) and (length == rhs.length));
+    }
+
+    struct Hasher
+    {
+        size_t
+        operator()(const HaplotypeKey& key) const
+        {
+            return static_cast<size_t>(key.hash ^ (static_cast<uint64_t>(key.length) << 32));
+        }
+    };
+
+    uint64_t hash;
+    unsigned length;
+};
+
+
+/// interned set of haplotype sequences built incrementally from alignment segments
+///
+/// Each haplotype is referred to by an id, and extending a haplotype by one segment returns the id of the
+/// extended haplotype. Haplotypes are keyed on their rolling hash plus length, so reads with the same
+/// haplotype sequence share one id and one copy of the sequence, even if the sequence was built from
+/// a different series of segments. Hash collisions are resolved by comparing sequences.
+///
+/// Each haplotype only stores the segment added to its parent, so storage is proportional to the number
+/// of distinct haplotype prefixes rather than the sum of all read haplotype lengths.
+///
+struct HaplotypeStore
+{
+    typedef unsigned haplotype_id_t;
+
+    /// id of the empty haplotype, which is always present
+    static const haplotype_id_t emptyHaplotypeId = 0;
+
+    HaplotypeStore()
+    {
+        clear();
+    }
+
+    void
+    clear();
+
+    /// \return id of the haplotype formed by appending segment to the haplotype with id haplotypeId
+    haplotype_id_t
+    extend(
+        const haplotype_id_t haplotypeId,
+        const std::string& segment);
+
+    unsigned
+    getLength(const haplotype_id_t haplotypeId) const
+    {
+        return _haplotypes[haplotypeId].length;
+    }
+
+    uint64_t
+    getHash(const haplotype_id_t haplotypeId) const
+    {
+        return _haplotypes[haplotypeId].hash;
+    }
+
+    /// get full haplotype sequence
+    void
+    getSequence(
+        const haplotype_id_t haplotypeId,
+        std::string& seq) const;
+
+    /// \return total number of interned haplotypes, including the empty haplotype
+    unsigned
+    size() const
+    {
+        return _haplotypes.size();
+    }
+
+private:
+
+    struct HaplotypeNode
+    {
+        haplotype_id_t parentId;
+        unsigned length;
+        uint64_t hash;
+        // location of the last appended segment in _segmentPool:
+        unsigned segmentOffset;
+        unsigned segmentLength;
+    };
+
+    /// \return true if the haplotype is the parent haplotype extended by segment
+    bool
+    isSameHaplotype(
+        const haplotype_id_t haplotypeId,
+        const haplotype_id_t parentId,
+        const std::string& segment) const;
+
+    std::vector<HaplotypeNode> _haplotypes;
+    std::string _segmentPool;
+    std::unordered_multimap<HaplotypeKey,haplotype_id_t,HaplotypeKey::Hasher> _haplotypeIndex;
+};
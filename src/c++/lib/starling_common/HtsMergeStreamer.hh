@@ -110,12 +110,17 @@ struct HtsMergeStreamer
     ///
     /// registration order will be used to order all inputs with the same position
     ///
+    /// \param isPrefetch if true, bam records are decoded on a separate thread ahead of the merged stream
+    ///
     const bam_streamer&
     registerBam(
         const char* bamFilename,
-        const unsigned index = 0)
+        const unsigned index = 0,
+        const bool isPrefetch = false)
     {
-        return registerHtsType(bamFilename,index,_data._bam);
+        const bam_streamer& bamStream(registerHtsType(bamFilename,index,_data._bam));
+        if (isPrefetch) _data._bam.back()->enablePrefetch();
+        return bamStream;
     }
 
     const bed_streamer&
@@ -53,10 +53,8 @@ rangeIterator(
     const pos_t begin_pos,
     const pos_t end_pos)
 {
-    const IndelKey end_range_key(end_pos);
-    const iterator end(_indelBuffer.lower_bound(end_range_key));
-    const IndelKey begin_range_key(begin_pos-static_cast<pos_t>(_opt.max_indel_size));
-    iterator begin(_indelBuffer.lower_bound(begin_range_key));
+    const iterator end(_indelBuffer.positionLowerBound(end_pos));
+    iterator begin(_indelBuffer.positionLowerBound(begin_pos-static_cast<pos_t>(_opt.max_indel_size)));
     for (; begin!=end; ++begin)
     {
         if (begin->first.right_pos() >= begin_pos) break;
@@ -70,20 +68,14 @@ rangeIterator(
 // range [begin_pos,end_pos]. Returning indels in addition to this set is
 // acceptable.
 //
-// The indels_keys: "end_range_key" and "begin_range_key" take
-// advantage of the indel NONE type, which sorts ahead of all other
-// types at the same position.
-//
 std::pair<IndelBuffer::const_iterator,IndelBuffer::const_iterator>
 IndelBuffer::
 rangeIterator(
     const pos_t begin_pos,
     const pos_t end_pos) const
 {
-    const IndelKey end_range_key(end_pos);
-    const const_iterator end(_indelBuffer.lower_bound(end_range_key));
-    const IndelKey begin_range_key(begin_pos-static_cast<pos_t>(_opt.max_indel_size));
-    const_iterator begin(_indelBuffer.lower_bound(begin_range_key));
+    const const_iterator end(_indelBuffer.positionLowerBound(end_pos));
+    const_iterator begin(_indelBuffer.positionLowerBound(begin_pos-static_cast<pos_t>(_opt.max_indel_size)));
     for (; begin!=end; ++begin)
     {
         if (begin->first.right_pos() >= begin_pos) break;
@@ -107,8 +99,7 @@ addIndelObservation(
     const bool isNovel(indelIter == _indelBuffer.end());
     if (isNovel)
     {
-        const auto retval = _indelBuffer.insert(std::make_pair(obs.key,IndelData(getSampleCount(), obs.key)));
-        indelIter = retval.first;
+        indelIter = _indelBuffer.insert(obs.key, IndelData(getSampleCount(), obs.key)).first;
     }
 
     IndelData& indelData(getIndelData(indelIter));
@@ -267,9 +258,7 @@ void
 IndelBuffer::
 clearIndelsAtPosition(const pos_t pos)
 {
-    const iterator i_begin(positionIterator(pos));
-    const iterator i_end(positionIterator(pos + 1));
-    _indelBuffer.erase(i_begin,i_end);
+    _indelBuffer.erasePosition(pos);
 }
 
 
@@ -27,6 +27,7 @@
 
 #include "blt_util/depth_buffer.hh"
 #include "starling_common/indel.hh"
+#include "starling_common/IndelPositionIndex.hh"
 #include "starling_common/min_count_binom_gte_cache.hh"
 #include "starling_common/starling_base_shared.hh"
 
@@ -75,7 +76,7 @@ struct IndelBuffer
     }
 
     typedef IndelData indel_buffer_value_t;
-    typedef std::map<IndelKey,indel_buffer_value_t> indel_buffer_data_t;
+    typedef IndelPositionIndex<indel_buffer_value_t> indel_buffer_data_t;
     typedef indel_buffer_data_t::iterator iterator;
     typedef indel_buffer_data_t::const_iterator const_iterator;
 
@@ -90,13 +91,13 @@ struct IndelBuffer
     iterator
     positionIterator(const pos_t pos)
     {
-        return _indelBuffer.lower_bound(IndelKey(pos));
+        return _indelBuffer.positionLowerBound(pos);
     }
 
     const_iterator
     positionIterator(const pos_t pos) const
     {
-        return _indelBuffer.lower_bound(IndelKey(pos));
+        return _indelBuffer.positionLowerBound(pos);
     }
 
     /// position iterators which return (at least) all indels with a
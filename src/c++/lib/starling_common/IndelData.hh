@@ -34,10 +34,11 @@
 
 #include <cassert>
 
+#include <algorithm>
 #include <iosfwd>
-#include <map>
 #include <string>
 #include <set>
+#include <utility>
 #include <vector>
 
 
@@ -113,6 +114,80 @@ struct ReadPathScores
 
 
 
+/// read path scores of one indel in one sample, keyed by read id
+///
+/// Scores are held in a single vector sorted by read id, so that iteration order is the same as
+/// std::map<align_id_t,ReadPathScores>. Reads are realigned in approximately increasing id order, so
+/// new scores are usually appended.
+///
+struct ReadPathScoreSet
+{
+    typedef std::pair<align_id_t,ReadPathScores> value_type;
+    typedef std::vector<value_type>::const_iterator const_iterator;
+
+    const_iterator
+    begin() const
+    {
+        return _scores.begin();
+    }
+
+    const_iterator
+    end() const
+    {
+        return _scores.end();
+    }
+
+    bool
+    empty() const
+    {
+        return _scores.empty();
+    }
+
+    unsigned
+    size() const
+    {
+        return _scores.size();
+    }
+
+    const_iterator
+    find(const align_id_t readId) const
+    {
+        const const_iterator iter(lowerBound(readId));
+        if ((iter == _scores.end()) || (iter->first != readId)) return _scores.end();
+        return iter;
+    }
+
+    /// \return the scores for readId, inserting default scores if readId is not found
+    ReadPathScores&
+    operator[](const align_id_t readId)
+    {
+        if (_scores.empty() || (_scores.back().first < readId))
+        {
+            _scores.emplace_back(readId, ReadPathScores());
+            return _scores.back().second;
+        }
+
+        const auto iter(_scores.begin() + (lowerBound(readId) - _scores.begin()));
+        if (iter->first == readId) return iter->second;
+        return _scores.insert(iter, value_type(readId, ReadPathScores()))->second;
+    }
+
+private:
+    const_iterator
+    lowerBound(const align_id_t readId) const
+    {
+        return std::lower_bound(_scores.begin(), _scores.end(), readId,
+                                [](const value_type& lhs, const align_id_t rhs)
+        {
+            return (lhs.first < rhs);
+        });
+    }
+
+    std::vector<value_type> _scores;
+};
+
+
+
 /// Accumulates evidence of a consensus breakpoint insert sequence.
 ///
 /// Assumes that long sequences for breakpoints will be noisy and that
@@ -175,10 +250,15 @@ struct BreakpointInsertSequenceManager
         static const unsigned max_obs_count(256);
         if (_obs_count>max_obs_count) return;
 
-        obs_t::iterator i(_obs.find(seq));
-        if (i == _obs.end())
+        // observations are kept in sequence order, so that consensus ties are resolved as before:
+        const obs_t::iterator i(std::lower_bound(_obs.begin(), _obs.end(), seq,
+                                                 [](const obs_t::value_type& lhs, const std::string& rhs)
+        {
+            return (lhs.first < rhs);
+        }));
+        if ((i == _obs.end()) || (i->first != seq))
         {
-            _obs[seq] = 1;
+            _obs.insert(i, std::make_pair(seq, 1u));
         }
         else
         {
@@ -193,7 +273,7 @@ private:
     void _finalize();
 
 
-    typedef std::map<std::string,unsigned> obs_t;
+    typedef std::vector<std::pair<std::string,unsigned>> obs_t;
     bool _is_consensus = false;
     std::string _consensus_seq;
     unsigned _obs_count = 0;
@@ -227,7 +307,7 @@ struct IndelSampleData
     // enumerates support for the indel among all reads
     // which cross an indel breakpoint by a sufficient margin after
     // re-alignment:
-    typedef std::map<align_id_t,ReadPathScores> score_t;
+    typedef ReadPathScoreSet score_t;
     score_t read_path_lnp;
 
     // the reads which cross an indel breakpoint, but not by enough
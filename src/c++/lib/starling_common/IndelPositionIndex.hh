@@ -0,0 +1,491 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#pragma once
+
+#include "starling_common/IndelKey.hh"
+
+#include "boost/utility.hpp"
+
+#include <cassert>
+#include <cstdint>
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+
+/// indel index ordered by IndelKey, with storage bucketed by indel position
+///
+/// Each indel position maps to one bucket in a ring addressed by position modulo the ring size. The ring is
+/// grown whenever the span of stored positions would exceed it, so that no two stored positions share a bucket.
+/// An occupancy bitmap over the ring allows iteration to skip empty positions a word at a time.
+///
+/// Indels are kept in IndelKey order within each bucket, so that iteration follows the same order as
+/// std::map<IndelKey,T>. As with std::map, values are never moved once inserted, so references and iterators
+/// to a value remain valid until its position is erased.
+///
+template <typename T>
+struct IndelPositionIndex : private boost::noncopyable
+{
+private:
+    struct Node;
+
+public:
+    typedef std::pair<const IndelKey,T> value_type;
+
+    template <typename V>
+    struct IteratorBase
+    {
+        IteratorBase() {}
+
+        IteratorBase(
+            const IndelPositionIndex* index,
+            Node* node)
+            : _index(index),
+              _node(node)
+        {}
+
+        /// allows conversion from iterator to const_iterator
+        template <typename V2>
+        IteratorBase(const IteratorBase<V2>& rhs)
+            : _index(rhs._index),
+              _node(rhs._node)
+        {}
+
+        V&
+        operator*() const
+        {
+            return _node->value;
+        }
+
+        V*
+        operator->() const
+        {
+            return &(_node->value);
+        }
+
+        IteratorBase&
+        operator++()
+        {
+            assert(nullptr != _node);
+            _node = _index->getNextNode(*_node);
+            return *this;
+        }
+
+        template <typename V2>
+        bool
+        operator==(const IteratorBase<V2>& rhs) const
+        {
+            return (_node == rhs._node);
+        }
+
+        template <typename V2>
+        bool
+        operator!=(const IteratorBase<V2>& rhs) const
+        {
+            return (_node != rhs._node);
+        }
+
+    private:
+        template <typename V2> friend struct IteratorBase;
+
+        const IndelPositionIndex* _index = nullptr;
+
+        /// nullptr for the end iterator
+        Node* _node = nullptr;
+    };
+
+    typedef IteratorBase<value_type> iterator;
+    typedef IteratorBase<const value_type> const_iterator;
+
+    iterator
+    begin()
+    {
+        return iterator(this, getFirstNode(_beginPos));
+    }
+
+    const_iterator
+    begin() const
+    {
+        return const_iterator(this, getFirstNode(_beginPos));
+    }
+
+    iterator
+    end()
+    {
+        return iterator(this, nullptr);
+    }
+
+    const_iterator
+    end() const
+    {
+        return const_iterator(this, nullptr);
+    }
+
+    /// \return iterator to the first indel with position pos or greater
+    iterator
+    positionLowerBound(const pos_t pos)
+    {
+        return iterator(this, getFirstNode(pos));
+    }
+
+    const_iterator
+    positionLowerBound(const pos_t pos) const
+    {
+        return const_iterator(this, getFirstNode(pos));
+    }
+
+    iterator
+    find(const IndelKey& indelKey)
+    {
+        return iterator(this, findNode(indelKey));
+    }
+
+    const_iterator
+    find(const IndelKey& indelKey) const
+    {
+        return const_iterator(this, findNode(indelKey));
+    }
+
+    /// insert value for indelKey if indelKey is not already in the index
+    ///
+    /// \return iterator to the value for indelKey, and true if the value was inserted
+    std::pair<iterator,bool>
+    insert(
+        const IndelKey& indelKey,
+        const T& value)
+    {
+        Node* existingNode(findNode(indelKey));
+        if (nullptr != existingNode) return std::make_pair(iterator(this, existingNode), false);
+
+        const pos_t pos(indelKey.pos);
+        reservePosition(pos);
+        Bucket& bucket(getSlot(pos));
+        if (not isOccupied(pos))
+        {
+            bucket.pos = pos;
+            assert(bucket.nodes.empty());
+            setOccupied(pos, true);
+        }
+
+        auto nodeIter(std::lower_bound(bucket.nodes.begin(), bucket.nodes.end(), indelKey,
+                                       [](const std::unique_ptr<Node>& lhs, const IndelKey& rhs)
+        {
+            return (lhs->value.first < rhs);
+        }));
+        nodeIter = bucket.nodes.emplace(nodeIter, new Node(indelKey, value));
+        Node* newNode(nodeIter->get());
+        if ((nodeIter+1) != bucket.nodes.end()) newNode->nextInBucket = (nodeIter+1)->get();
+        if (nodeIter != bucket.nodes.begin())
+        {
+            (*(nodeIter-1))->nextInBucket = newNode;
+        }
+        else
+        {
+            bucket.firstNode = newNode;
+        }
+        _size++;
+        return std::make_pair(iterator(this, newNode), true);
+    }
+
+    /// erase all indels at pos
+    void
+    erasePosition(const pos_t pos)
+    {
+        if (not isStoredPosition(pos)) return;
+        Bucket& bucket(getSlot(pos));
+        _size -= bucket.nodes.size();
+        bucket.nodes.clear();
+        bucket.firstNode = nullptr;
+        setOccupied(pos, false);
+
+        if (_size == 0)
+        {
+            _beginPos = 0;
+            _endPos = 0;
+            return;
+        }
+        if (pos == _beginPos) _beginPos = getNextOccupiedPos(pos+1);
+        if (pos == (_endPos-1)) _endPos = (getPrevOccupiedPos(pos-1)+1);
+    }
+
+    void
+    clear()
+    {
+        for (Bucket& bucket : _buckets)
+        {
+            bucket.nodes.clear();
+            bucket.firstNode = nullptr;
+        }
+        std::fill(_occupied.begin(), _occupied.end(), 0);
+        _size = 0;
+        _beginPos = 0;
+        _endPos = 0;
+    }
+
+    bool
+    empty() const
+    {
+        return (_size == 0);
+    }
+
+    unsigned
+    size() const
+    {
+        return _size;
+    }
+
+private:
+    struct Node
+    {
+        Node(
+            const IndelKey& indelKey,
+            const T& initValue)
+            : value(indelKey, initValue)
+        {}
+
+        value_type value;
+
+        /// next node in IndelKey order at the same position, or nullptr for the last node of the bucket
+        Node* nextInBucket = nullptr;
+    };
+
+    struct Bucket
+    {
+        pos_t pos = 0;
+
+        /// first node in the bucket, this is equivalent to nodes.front() but saves a load during iteration
+        Node* firstNode = nullptr;
+        std::vector<std::unique_ptr<Node>> nodes;
+    };
+
+    static const unsigned wordBits = 64;
+    static const unsigned minCapacity = 1024;
+
+    static
+    unsigned
+    getLowestSetBit(uint64_t word)
+    {
+        assert(word != 0);
+        unsigned bitIndex(0);
+        while ((word & 0xffff) == 0)
+        {
+            word >>= 16;
+            bitIndex += 16;
+        }
+        while ((word & 1) == 0)
+        {
+            word >>= 1;
+            bitIndex++;
+        }
+        return bitIndex;
+    }
+
+    static
+    unsigned
+    getHighestSetBit(uint64_t word)
+    {
+        assert(word != 0);
+        unsigned bitIndex(wordBits-1);
+        while ((word >> (wordBits-16)) == 0)
+        {
+            word <<= 16;
+            bitIndex -= 16;
+        }
+        while ((word >> (wordBits-1)) == 0)
+        {
+            word <<= 1;
+            bitIndex--;
+        }
+        return bitIndex;
+    }
+
+    unsigned
+    getSlotIndex(const pos_t pos) const
+    {
+        return (static_cast<uint64_t>(pos) & (_buckets.size()-1));
+    }
+
+    Bucket&
+    getSlot(const pos_t pos)
+    {
+        return _buckets[getSlotIndex(pos)];
+    }
+
+    const Bucket&
+    getSlot(const pos_t pos) const
+    {
+        return _buckets[getSlotIndex(pos)];
+    }
+
+    bool
+    isOccupied(const pos_t pos) const
+    {
+        const unsigned slotIndex(getSlotIndex(pos));
+        return ((_occupied[slotIndex/wordBits] >> (slotIndex%wordBits)) & 1);
+    }
+
+    void
+    setOccupied(
+        const pos_t pos,
+        const bool isSet)
+    {
+        const unsigned slotIndex(getSlotIndex(pos));
+        const uint64_t mask(static_cast<uint64_t>(1) << (slotIndex%wordBits));
+        if (isSet)
+        {
+            _occupied[slotIndex/wordBits] |= mask;
+        }
+        else
+        {
+            _occupied[slotIndex/wordBits] &= ~mask;
+        }
+    }
+
+    bool
+    isStoredPosition(const pos_t pos) const
+    {
+        if ((_size == 0) || (pos < _beginPos) || (pos >= _endPos)) return false;
+        return isOccupied(pos);
+    }
+
+    /// \return the lowest stored position at or after pos, or _endPos if there is none
+    pos_t
+    getNextOccupiedPos(pos_t pos) const
+    {
+        if (_size == 0) return _endPos;
+        pos = std::max(pos, _beginPos);
+        while (pos < _endPos)
+        {
+            const unsigned slotIndex(getSlotIndex(pos));
+            const unsigned bitIndex(slotIndex%wordBits);
+            const uint64_t word(_occupied[slotIndex/wordBits] >> bitIndex);
+            if (word != 0)
+            {
+                // all stored positions are less than _beginPos+capacity, so a set bit found beyond _endPos can't
+                // belong to this position:
+                return std::min(pos + static_cast<pos_t>(getLowestSetBit(word)), _endPos);
+            }
+            pos += (wordBits - bitIndex);
+        }
+        return _endPos;
+    }
+
+    /// \return the highest stored position at or before pos, or _beginPos-1 if there is none
+    pos_t
+    getPrevOccupiedPos(pos_t pos) const
+    {
+        pos = std::min(pos, _endPos-1);
+        while (pos >= _beginPos)
+        {
+            const unsigned slotIndex(getSlotIndex(pos));
+            const unsigned bitIndex(slotIndex%wordBits);
+            uint64_t word(_occupied[slotIndex/wordBits]);
+            if ((bitIndex+1) < wordBits) word &= ((static_cast<uint64_t>(1) << (bitIndex+1)) - 1);
+            if (word != 0)
+            {
+                return std::max(pos - static_cast<pos_t>(bitIndex - getHighestSetBit(word)), _beginPos-1);
+            }
+            pos -= (bitIndex + 1);
+        }
+        return _beginPos-1;
+    }
+
+    /// \return first node at pos or the next stored position, or nullptr if there is none
+    Node*
+    getFirstNode(const pos_t pos) const
+    {
+        const pos_t nextPos(getNextOccupiedPos(pos));
+        if (nextPos >= _endPos) return nullptr;
+        return getSlot(nextPos).firstNode;
+    }
+
+    Node*
+    getNextNode(const Node& node) const
+    {
+        if (nullptr != node.nextInBucket) return node.nextInBucket;
+        return getFirstNode(node.value.first.pos+1);
+    }
+
+    Node*
+    findNode(const IndelKey& indelKey) const
+    {
+        if (not isStoredPosition(indelKey.pos)) return nullptr;
+        const Bucket& bucket(getSlot(indelKey.pos));
+        for (const std::unique_ptr<Node>& node : bucket.nodes)
+        {
+            if (node->value.first == indelKey) return node.get();
+        }
+        return nullptr;
+    }
+
+    /// extend the stored position range to include pos, growing the ring if required
+    void
+    reservePosition(const pos_t pos)
+    {
+        if (_size == 0)
+        {
+            if (_buckets.empty()) resize(minCapacity);
+            _beginPos = pos;
+            _endPos = pos+1;
+            return;
+        }
+
+        const pos_t newBeginPos(std::min(_beginPos, pos));
+        const pos_t newEndPos(std::max(_endPos, pos+1));
+        const uint64_t span(newEndPos-newBeginPos);
+        if (span > _buckets.size())
+        {
+            uint64_t capacity(_buckets.size());
+            while (capacity < span) capacity *= 2;
+            resize(capacity);
+        }
+        _beginPos = newBeginPos;
+        _endPos = newEndPos;
+    }
+
+    /// move all stored positions to a ring of the given capacity
+    void
+    resize(const uint64_t capacity)
+    {
+        assert((capacity % wordBits) == 0);
+        std::vector<Bucket> buckets(capacity);
+        std::vector<uint64_t> occupied(capacity/wordBits, 0);
+        const uint64_t mask(capacity-1);
+        for (pos_t pos(getNextOccupiedPos(_beginPos)); pos < _endPos; pos = getNextOccupiedPos(pos+1))
+        {
+            const unsigned slotIndex(static_cast<uint64_t>(pos) & mask);
+            buckets[slotIndex] = std::move(getSlot(pos));
+            occupied[slotIndex/wordBits] |= (static_cast<uint64_t>(1) << (slotIndex%wordBits));
+        }
+        _buckets.swap(buckets);
+        _occupied.swap(occupied);
+    }
+
+    std::vector<Bucket> _buckets;
+    std::vector<uint64_t> _occupied;
+    unsigned _size = 0;
+
+    /// all stored positions are in [_beginPos,_endPos), and both bounds are stored positions when not empty
+    pos_t _beginPos = 0;
+    pos_t _endPos = 0;
+};
@@ -182,6 +182,12 @@ private:
     typedef RangeMap<pos_t,snp_pos_info,ClearT<snp_pos_info>> pdata_t;
 
     // inherit so that we can intercept the getRef calls:
+    //
+    // each base call updates the same position several times in succession (mapq, rank-sums, alt read positions,
+    // the call itself), so the most recently accessed position is cached to skip repeated range map lookups. The
+    // cache is dropped whenever positions are erased, and any access to a different position replaces it before
+    // the range map storage can be reallocated.
+    //
     struct PosData : public pdata_t
     {
         PosData(const reference_contig_segment& ref_init) : ref(ref_init) {}
@@ -190,12 +196,43 @@ private:
         getRef(
             const pos_t& pos)
         {
+            if ((nullptr != _lastPosInfo) && (pos == _lastPos)) return *_lastPosInfo;
+
             snp_pos_info& pi(pdata_t::getRef(pos));
             if (! pi.is_ref_set()) pi.set_ref_base(ref.get_base(pos));
+            _lastPos = pos;
+            _lastPosInfo = &pi;
             return pi;
         }
 
+        void
+        clear()
+        {
+            _lastPosInfo = nullptr;
+            pdata_t::clear();
+        }
+
+        void
+        erase(
+            const pos_t& pos)
+        {
+            _lastPosInfo = nullptr;
+            pdata_t::erase(pos);
+        }
+
+        void
+        eraseTo(
+            const pos_t& pos)
+        {
+            _lastPosInfo = nullptr;
+            pdata_t::eraseTo(pos);
+        }
+
         const reference_contig_segment& ref;
+
+    private:
+        pos_t _lastPos = 0;
+        snp_pos_info* _lastPosInfo = nullptr;
     };
 
     const reference_contig_segment& _ref;
@@ -67,6 +67,8 @@ get_starling_base_option_parser(
     core_opt.add_options()
     ("ref", po::value(&opt.referenceFilename),
      "fasta reference sequence, samtools index file must be present (required)")
+    ("packed-ref", po::value(&opt.packedReferenceFilename),
+     "packed copy of the fasta reference created by PackReference. If provided, reference sequence is read from this file instead of the fasta reference (optional)")
     ("region", po::value<regions_t>(),
      "samtools formatted region, eg. 'chr1:20-30'. May be supplied more than once but regions must not overlap. At least one entry required.")
     ;
@@ -83,6 +85,10 @@ get_starling_base_option_parser(
     realign_opt.add_options()
     ("max-indel-toggle-depth", po::value(&opt.max_read_indel_toggle)->default_value(opt.max_read_indel_toggle),
      "Controls the realignment stringency. Lowering this value will increase the realignment speed at the expense of indel-call quality")
+    ("max-read-realign-search-steps", po::value(&opt.max_read_realign_search_steps)->default_value(opt.max_read_realign_search_steps),
+     "Maximum candidate alignment search steps for each read before the read falls back to a search which only toggles one indel at a time. Zero disables the limit.")
+    ("max-window-realign-search-steps", po::value(&opt.max_window_realign_search_steps)->default_value(opt.max_window_realign_search_steps),
+     "Maximum candidate alignment search steps summed over all reads starting within the realignment window of a position. Once exceeded, reads at the position fall back to a search which only toggles one indel at a time. Zero disables the limit.")
     ;
 
     po::options_description indel_opt("indel-options");
@@ -123,6 +129,12 @@ get_starling_base_option_parser(
     other_opt.add_options()
     ("stats-file", po::value(&opt.segmentStatsFilename),
      "Write runtime stats to file")
+    ("threads", po::value(&opt.workerThreadCount)->default_value(opt.workerThreadCount),
+     "Number of worker threads used to analyze regions in parallel. Output is written in region order.")
+    ("alignment-prefetch", po::value(&opt.isAlignmentPrefetch)->zero_tokens(),
+     "Decode each input alignment file on a separate thread ahead of variant calling")
+    ("realigned-read-compression-threads", po::value(&opt.realignedReadCompressionThreadCount)->default_value(opt.realignedReadCompressionThreadCount),
+     "Number of threads used to compress each realigned read BAM file")
     ("report-evs-features", po::value(&opt.isReportEVSFeatures)->zero_tokens(),
      "Report empirical variant scoring (EVS) training features in VCF output")
     ("indel-error-models-file", po::value(&opt.indel_error_models_filename),
@@ -264,6 +276,13 @@ finalize_starling_base_options(
         pinfo.usage(oss.str().c_str());
     }
 
+    if ((! opt.packedReferenceFilename.empty()) and (! compat_realpath(opt.packedReferenceFilename)))
+    {
+        std::ostringstream oss;
+        oss << "can't resolve packed reference path: " << opt.packedReferenceFilename << "\n";
+        pinfo.usage(oss.str().c_str());
+    }
+
     // set analysis regions:
     if (vm.count("region"))
     {
@@ -303,6 +322,21 @@ finalize_starling_base_options(
 
     checkOptionalFile(pinfo,opt.indel_error_models_filename,"indel error models");
 
+    if (opt.workerThreadCount < 1)
+    {
+        pinfo.usage("Worker thread count must be at least 1");
+    }
+
+    if (opt.realignedReadCompressionThreadCount < 1)
+    {
+        pinfo.usage("Realigned read compression thread count must be at least 1");
+    }
+
+    if ((opt.workerThreadCount > 1) && opt.is_realigned_read_file())
+    {
+        pinfo.usage("Realigned read output is not supported with multiple worker threads");
+    }
+
     /// tier2 options are not parsed by starling_base, but need to live up here for now,
     /// so validate them together with the rest of starling_base
     std::string errorMsg;
@@ -71,6 +71,10 @@ struct starling_base_options : public blt_options
 
     std::string referenceFilename;
 
+    /// optional packed copy of the reference created by PackReference, if set reference segments are read
+    /// from this memory mapped file instead of the fasta
+    std::string packedReferenceFilename;
+
     // list of chromosome regions to be analyzed
     regions_t regions;
 
@@ -138,6 +142,15 @@ struct starling_base_options : public blt_options
     // the maximum number of candidate re-alignments for each read:
     unsigned max_realignment_candidates = 5000;
 
+    // the maximum number of candidate alignment search steps for each read. If exceeded, the search for the
+    // read is restarted with toggle depth curtailed to 1. Zero disables the limit.
+    unsigned max_read_realign_search_steps = 50000;
+
+    // the maximum number of candidate alignment search steps summed over all reads in one realignment
+    // window. Once exceeded, all remaining reads in the window are searched with toggle depth curtailed to 1.
+    // Zero disables the limit.
+    unsigned max_window_realign_search_steps = 2000000;
+
     // clip the section of a read which aligns equally well to two or
     // more paths before pileup or realigned read output
     bool is_clip_ambiguous_path = true;
@@ -196,6 +209,16 @@ struct starling_base_options : public blt_options
     /// Stores runtime stats
     std::string segmentStatsFilename;
 
+    /// number of worker threads used to process analysis regions in parallel, each thread
+    /// runs a full copy of the region analysis pipeline
+    unsigned workerThreadCount = 1;
+
+    /// if true, each input alignment file is decoded on a separate thread ahead of variant calling
+    bool isAlignmentPrefetch = false;
+
+    /// number of threads used for BGZF compression of each realigned read BAM file
+    unsigned realignedReadCompressionThreadCount = 2;
+
     bool
     isMaxBufferedReads() const
     {
@@ -38,6 +38,7 @@
 #include "htsapi/bam_seq_read_util.hh"
 #include "starling_common/AlleleReportInfo.hh"
 
+#include <algorithm>
 #include <iomanip>
 #include <applications/starling/starling_shared.hh>
 
@@ -361,6 +362,8 @@ reset()
     {
         _stagemanPtr->reset();
     }
+
+    _realignWindowSearchBudget.clear();
 }
 
 
@@ -372,6 +375,20 @@ resetRegionBase(
     const known_pos_range2& reportRange)
 {
     reset();
+
+    // sorted realigned read output is held back at the end of each region (see write_reads), so it only needs
+    // to be completed here if the new region does not continue forward on the same chromosome:
+    const bool isRegionContinued((chromName == _chromName) and (reportRange.begin_pos() >= _reportRange.end_pos()));
+    if (not isRegionContinued)
+    {
+        const unsigned sampleCount(getSampleCount());
+        for (unsigned sampleIndex(0); sampleIndex<sampleCount; ++sampleIndex)
+        {
+            SortedBamDumper* bamd_ptr(_streams.realign_bam_ptr(sampleIndex));
+            if (nullptr != bamd_ptr) bamd_ptr->flush();
+        }
+    }
+
     _chromName = chromName;
     _reportRange = reportRange;
 
@@ -771,6 +788,12 @@ align_pos(const pos_t pos)
 {
     known_pos_range realign_buffer_range(get_realignment_range(pos, _stagemanPtr->get_stage_data()));
 
+    // all reads starting at pos share a realignment window, so candidate alignments can only be reused
+    // within this call. The window search budget is shared with reads at earlier positions which start within
+    // the realignment window of pos:
+    _candidateAlignmentScoreCache.clear();
+    _realignWindowSearchBudget.setPos(pos, realign_buffer_range.begin_pos);
+
     const unsigned sampleCount(getSampleCount());
     for (unsigned sampleIndex(0); sampleIndex<sampleCount; ++sampleIndex)
     {
@@ -786,7 +809,8 @@ align_pos(const pos_t pos)
             try
             {
                 realign_and_score_read(_opt,_dopt,sif.sample_opt,_ref,realign_buffer_range,sampleIndex,rseg,
-                                       getIndelBuffer());
+                                       getIndelBuffer(),_candidateAlignmentScoreCache,
+                                       _realignWindowSearchBudget,_readRealignmentStats);
             }
             catch (...)
             {
@@ -1132,12 +1156,28 @@ void
 starling_pos_processor_base::
 write_reads(const pos_t pos)
 {
+    // reads buffered after pos are realigned within a range starting no earlier than the realignment range of
+    // pos, so all reads starting before this range can be written in coordinate order. The range is extended
+    // by the current indel span per read to allow for growth of the realignment range at later positions.
+    //
+    // This bound assumes that the largest indel span per read seen at the HEAD stage has already grown to cover
+    // any read realigned at a later position. A read which still lands behind the written output is not lost,
+    // SortedBamDumper holds it and merges it into the file when the output is completed:
+    const pos_t realignSpan(static_cast<pos_t>(get_largest_total_indel_ref_span_per_read()));
+    const known_pos_range realign_buffer_range(get_realignment_range(pos, _stagemanPtr->get_stage_data()));
+    pos_t sortedOutputPos(realign_buffer_range.begin_pos-realignSpan);
+
+    // a following region on this chromosome can realign reads from its leading flank, which starts up to one
+    // read length and the max indel size before the end of this region:
+    const pos_t nextRegionReadPos(_reportRange.end_pos()-static_cast<pos_t>(_opt.max_indel_size+get_largest_read_size()));
+    sortedOutputPos = std::min(sortedOutputPos, nextRegionReadPos-(2*realignSpan));
+
     const unsigned sampleCount(getSampleCount());
     for (unsigned sampleIndex(0); sampleIndex<sampleCount; ++sampleIndex)
     {
-        bam_dumper* bamd_ptr(_streams.realign_bam_ptr(sampleIndex));
+        SortedBamDumper* bamd_ptr(_streams.realign_bam_ptr(sampleIndex));
         if (NULL == bamd_ptr) continue;
-        bam_dumper& bamd(*bamd_ptr);
+        SortedBamDumper& bamd(*bamd_ptr);
 
         read_segment_iter ri(sample(sampleIndex).read_buff.get_pos_read_segment_iter(pos));
         read_segment_iter::ret_val r;
@@ -1152,6 +1192,7 @@ write_reads(const pos_t pos)
             }
             ri.next();
         }
+        bamd.flush(sortedOutputPos);
     }
 }
 
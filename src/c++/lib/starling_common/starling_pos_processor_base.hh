@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include "appstats/ReadRealignmentStats.hh"
 #include "blt_common/map_level.hh"
 #include "blt_util/depth_buffer.hh"
 #include "blt_util/depth_stream_stat_range.hh"
@@ -32,6 +33,7 @@
 #include "blt_util/RegionTracker.hh"
 #include "blt_util/stage_manager.hh"
 #include "blt_util/window_util.hh"
+#include "starling_common/CandidateAlignmentScoreCache.hh"
 #include "starling_common/indel_set.hh"
 #include "starling_common/IndelBuffer.hh"
 #include "starling_common/PileupCleaner.hh"
@@ -39,6 +41,7 @@
 #include "starling_common/read_mismatch_info.hh"
 #include "starling_common/starling_base_shared.hh"
 #include "starling_common/starling_pos_processor_win_avg_set.hh"
+#include "starling_common/starling_read_align.hh"
 #include "starling_common/starling_read_buffer.hh"
 #include "starling_common/starling_streams_base.hh"
 #include "starling_common/ActiveRegionDetector.hh"
@@ -120,6 +123,13 @@ struct starling_pos_processor_base : public pos_processor_base, private boost::n
         return (*_active_region_detector);
     }
 
+    /// read realignment statistics accumulated over all regions processed by this object
+    const ReadRealignmentStats&
+    getReadRealignmentStats() const
+    {
+        return _readRealignmentStats;
+    }
+
     // in range [begin,end), is the estimated depth always below
     // depth?
     bool
@@ -622,5 +632,10 @@ protected:
 private:
     IndelBuffer _indelBuffer;
 
+    // expected read bases of each candidate alignment in the current realignment window:
+    CandidateAlignmentScoreCache _candidateAlignmentScoreCache;
+    RealignWindowSearchBudget _realignWindowSearchBudget;
+    ReadRealignmentStats _readRealignmentStats;
+
     std::unique_ptr<ActiveRegionDetector> _active_region_detector;
 };
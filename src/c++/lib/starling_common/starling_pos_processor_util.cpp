@@ -52,7 +52,8 @@ std::vector<std::reference_wrapper<const bam_hdr_t> >
 registerAlignments(
     const std::vector<std::string>& alignmentFilename,
     const std::vector<unsigned>& registrationIndices,
-    HtsMergeStreamer& streamData)
+    HtsMergeStreamer& streamData,
+    const bool isPrefetch)
 {
     const unsigned alignmentFileCount(alignmentFilename.size());
     assert(registrationIndices.size() == alignmentFileCount);
@@ -62,7 +63,7 @@ registerAlignments(
     {
         const std::string& alignFile(alignmentFilename[alignmentFileIndex]);
         const unsigned bamIndex(registrationIndices[alignmentFileIndex]);
-        const bam_streamer& readStream(streamData.registerBam(alignFile.c_str(), bamIndex));
+        const bam_streamer& readStream(streamData.registerBam(alignFile.c_str(), bamIndex, isPrefetch));
 
         allHeaders.push_back(readStream.get_header());
 
@@ -444,12 +445,13 @@ convert_vcfrecord_to_indel_allele(
     IndelObservation& obs)
 {
     assert(vcf_indel.is_indel());
-    assert(altIndex<vcf_indel.alt.size());
+    assert(altIndex<vcf_indel.getAltCount());
 
-    const unsigned rs(vcf_indel.ref.size());
-    const auto& alt(vcf_indel.alt[altIndex]);
+    const std::string& ref(vcf_indel.getRef());
+    const unsigned rs(ref.size());
+    const auto& alt(vcf_indel.getAlt()[altIndex]);
     const unsigned as(alt.size());
-    const std::pair<unsigned,unsigned> xfix(common_xfix_length(vcf_indel.ref,alt));
+    const std::pair<unsigned,unsigned> xfix(common_xfix_length(ref,alt));
     const unsigned nfix(xfix.first+xfix.second);
     assert(nfix<=std::min(rs,as));
     const int insert_length(as-nfix);
@@ -488,7 +490,7 @@ process_candidate_indel(
 {
     assert (vcf_indel.is_indel());
 
-    const unsigned altCount(vcf_indel.alt.size());
+    const unsigned altCount(vcf_indel.getAltCount());
     for (unsigned altIndex(0); altIndex<altCount; ++altIndex)
     {
         IndelObservation obs;
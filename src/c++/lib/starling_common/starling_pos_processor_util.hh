@@ -36,11 +36,14 @@
 
 
 /// register a set of alignment files to the hts streamer and verify consistency conditions.
+///
+/// \param isPrefetch if true, each alignment file is decoded on its own thread ahead of the merged stream
 std::vector<std::reference_wrapper<const bam_hdr_t> >
 registerAlignments(
     const std::vector<std::string>& alignmentFilename,
     const std::vector<unsigned>& registrationIndices,
-    HtsMergeStreamer& streamData);
+    HtsMergeStreamer& streamData,
+    const bool isPrefetch = false);
 
 
 
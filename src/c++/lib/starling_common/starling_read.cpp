@@ -78,6 +78,22 @@ starling_read(const bam_record& br)
 
 
 
+void
+starling_read::
+reset(const bam_record& br)
+{
+    genome_align_maplev = MAPLEVEL::UNKNOWN;
+    _id = 0;
+    _read_rec = br;
+
+    // copy from a named object so that the alignment path vectors retain their storage:
+    const read_segment fullRead(_read_rec.read_size(),0,this);
+    _full_read = fullRead;
+    _segment_ptr.reset();
+}
+
+
+
 bool
 starling_read::
 is_tier1_mapping() const
@@ -237,7 +253,7 @@ update_full_segment()
 //
 void
 starling_read::
-write_bam(bam_dumper& bamd)
+write_bam(SortedBamDumper& bamd)
 {
     if (is_segmented()) update_full_segment();
 
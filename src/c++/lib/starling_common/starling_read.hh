@@ -25,7 +25,7 @@
 #pragma once
 
 #include "blt_common/map_level.hh"
-#include "htsapi/bam_dumper.hh"
+#include "htsapi/SortedBamDumper.hh"
 #include "starling_common/starling_base_shared.hh"
 #include "starling_common/starling_read_key.hh"
 #include "starling_common/starling_read_segment.hh"
@@ -75,6 +75,13 @@ struct starling_read : private boost::noncopyable
 {
     starling_read(const bam_record& br);
 
+    /// reinitialize this object to the state produced by starling_read(br)
+    ///
+    /// this allows read objects to be recycled without releasing the storage of the bam record
+    /// and alignment paths
+    void
+    reset(const bam_record& br);
+
     // enters full alignment, and handles segment setup for splice
     // sites:
     void
@@ -83,7 +90,7 @@ struct starling_read : private boost::noncopyable
     // nonconst because we update the BAM record with the best
     // alignment if the read has been realigned:
     void
-    write_bam(bam_dumper& bamd);
+    write_bam(SortedBamDumper& bamd);
 
     bool
     is_fwd_strand() const
@@ -181,6 +181,8 @@ is_usable_indel(
 
 /// find all indels in the indel_buffer which intersect a range (and
 /// meet candidacy/usability requirements)
+///
+/// \param[out] promotedIndels if non-null, existing indels promoted from remove-only status are appended here
 static
 void
 add_indels_in_range(
@@ -189,7 +191,8 @@ add_indels_in_range(
     const known_pos_range& pr,
     const unsigned sampleId,
     starling_align_indel_status& indel_status_map,
-    std::vector<IndelKey>& indel_order)
+    std::vector<IndelKey>& indel_order,
+    std::vector<IndelKey>* promotedIndels = nullptr)
 {
     const auto indelIterPair(indelBuffer.rangeIterator(pr.begin_pos, pr.end_pos));
 #ifdef DEBUG_ALIGN
@@ -223,6 +226,7 @@ add_indels_in_range(
             if ((! is_remove_only) && indel_status_map[indelKey].is_remove_only)
             {
                 indel_status_map[indelKey].is_remove_only = false;
+                if (nullptr != promotedIndels) promotedIndels->push_back(indelKey);
             }
         }
         else
@@ -591,6 +595,46 @@ struct mca_warnings
 {
     bool origin_skip = false;
     bool max_toggle_depth = false;
+
+    /// the search exceeded the read or window search budget, and the read fell back to the curtailed search
+    bool search_budget = false;
+};
+
+
+
+/// limits the candidate alignment search work for one read
+///
+struct CandidateSearchBudget
+{
+    /// \param initMaxSteps maximum search steps, zero for no limit
+    /// \param initMaxToggle upper bound on the indel toggle depth of the search
+    CandidateSearchBudget(
+        const unsigned initMaxSteps,
+        const int initMaxToggle)
+        : maxSteps(initMaxSteps),
+          maxToggle(initMaxToggle)
+    {}
+
+    /// count one search step
+    ///
+    /// \return false if the budget is exhausted and the search should stop
+    bool
+    consumeStep()
+    {
+        if (isExhausted) return false;
+        if ((maxSteps > 0) && (steps >= maxSteps))
+        {
+            isExhausted = true;
+            return false;
+        }
+        steps++;
+        return true;
+    }
+
+    const unsigned maxSteps;
+    const int maxToggle;
+    unsigned steps = 0;
+    bool isExhausted = false;
 };
 
 
@@ -621,9 +665,72 @@ add_pin_exception_info(
 
 
 
+/// restores the indel search state shared by all levels of candidate_alignment_search
+/// to its value on entry to one level of the search
+///
+/// this allows the search state to be passed by reference through the recursion, instead of
+/// copying the full indel status map and order at every depth
+///
+struct IndelSearchStateRestorer
+{
+    IndelSearchStateRestorer(
+        starling_align_indel_status& indel_status_map,
+        std::vector<IndelKey>& indel_order)
+        : _indel_status_map(indel_status_map),
+          _indel_order(indel_order),
+          _startSize(indel_order.size())
+    {
+        assert(_indel_status_map.size() == _startSize);
+    }
+
+    ~IndelSearchStateRestorer()
+    {
+        if (_isToggled) _indel_status_map[_toggledIndel].is_present = (! _indel_status_map[_toggledIndel].is_present);
+
+        for (const IndelKey& indelKey : promotedIndels)
+        {
+            _indel_status_map[indelKey].is_remove_only = true;
+        }
+
+        // indels added at this level are only ever appended to the order, and may have been re-sorted only
+        // among themselves:
+        const unsigned orderSize(_indel_order.size());
+        for (unsigned orderIndex(_startSize); orderIndex<orderSize; ++orderIndex)
+        {
+            _indel_status_map.erase(_indel_order[orderIndex]);
+        }
+        _indel_order.resize(_startSize);
+    }
+
+    /// toggle the presence of indelKey, this is reverted on exit from the search level
+    void
+    toggle(const IndelKey& indelKey)
+    {
+        assert(not _isToggled);
+        _toggledIndel = indelKey;
+        _isToggled = true;
+        _indel_status_map[_toggledIndel].is_present = (! _indel_status_map[_toggledIndel].is_present);
+    }
+
+    /// existing indels promoted from remove-only status at this search level
+    std::vector<IndelKey> promotedIndels;
+
+private:
+    starling_align_indel_status& _indel_status_map;
+    std::vector<IndelKey>& _indel_order;
+    const unsigned _startSize;
+    bool _isToggled = false;
+    IndelKey _toggledIndel;
+};
+
+
+
 /// Recursively build potential alignment paths and push them into the
 /// candidate alignment set:
 ///
+/// indel_status_map and indel_order are updated in place while searching deeper levels, but are always
+/// returned in their input state
+///
 static
 void
 candidate_alignment_search(
@@ -636,8 +743,9 @@ candidate_alignment_search(
     const known_pos_range& realign_buffer_range,
     std::set<candidate_alignment>& cal_set,
     mca_warnings& warn,
-    starling_align_indel_status indel_status_map,
-    std::vector<IndelKey> indel_order,
+    CandidateSearchBudget& budget,
+    starling_align_indel_status& indel_status_map,
+    std::vector<IndelKey>& indel_order,
     const unsigned depth,
     const unsigned toggle_depth,
     known_pos_range read_range,
@@ -649,6 +757,8 @@ candidate_alignment_search(
     std::cerr << "\twith cal: " << cal;
 #endif
 
+    if (not budget.consumeStep()) return;
+
     // first step is to check for new indel overlaps and extend the
     // indel_status_map as necessary:
     //
@@ -657,6 +767,8 @@ candidate_alignment_search(
     // previous range so that we correctly overlap all potential new
     // indels.
     //
+    IndelSearchStateRestorer searchState(indel_status_map, indel_order);
+
     bool is_new_indels(toggle_depth==0);
     {
         const unsigned start_ism_size(indel_status_map.size());
@@ -668,13 +780,13 @@ candidate_alignment_search(
         if (pr.begin_pos < read_range.begin_pos)
         {
             add_indels_in_range(read_id, indelBuffer, known_pos_range(pr.begin_pos, read_range.begin_pos + 1), sampleId,
-                                indel_status_map, indel_order);
+                                indel_status_map, indel_order, &searchState.promotedIndels);
             read_range.begin_pos = pr.begin_pos;
         }
         if (pr.end_pos > read_range.end_pos)
         {
             add_indels_in_range(read_id, indelBuffer, known_pos_range(read_range.end_pos - 1, pr.end_pos), sampleId,
-                                indel_status_map, indel_order);
+                                indel_status_map, indel_order, &searchState.promotedIndels);
             read_range.end_pos = pr.end_pos;
         }
 
@@ -740,6 +852,9 @@ candidate_alignment_search(
             const int max_toggle(dopt.sal.get_max_toggle(indel_status_map.size()));
             max_read_indel_toggle=std::min(max_read_indel_toggle,max_toggle);
         }
+
+        // the fallback search for reads which exceed the search budget is curtailed by the budget itself:
+        max_read_indel_toggle=std::min(max_read_indel_toggle,budget.maxToggle);
     }
 
     // check whether toggling the input alignment already exceeds the maximum
@@ -768,7 +883,9 @@ candidate_alignment_search(
     //
     // edge-indels can only be pinned on one side
     //
-    const IndelKey& cindel(indel_order[depth]);
+    // copy the current indel key because indel_order may be extended (and reallocated) by deeper levels
+    // of the search:
+    const IndelKey cindel(indel_order[depth]);
     const bool is_cindel_on(indel_status_map[cindel].is_present);
 
     // alignment 1) --> unchanged case:
@@ -776,7 +893,7 @@ candidate_alignment_search(
     {
         candidate_alignment_search(opt, dopt, read_id, read_length, indelBuffer, sampleId, realign_buffer_range,
                                    cal_set,
-                                   warn, indel_status_map,
+                                   warn, budget, indel_status_map,
                                    indel_order, depth + 1, toggle_depth, read_range, max_read_indel_toggle, cal);
     }
     catch (...)
@@ -813,7 +930,7 @@ candidate_alignment_search(
     }
 
     // changed cases:
-    indel_status_map[cindel].is_present=(! is_cindel_on);
+    searchState.toggle(cindel);
 
     // extract only those indels that are present in the next
     // alignment:
@@ -862,7 +979,7 @@ candidate_alignment_search(
 
                 candidate_alignment_search(opt, dopt, read_id, read_length, indelBuffer, sampleId,
                                            realign_buffer_range, cal_set,
-                                           warn, indel_status_map,
+                                           warn, budget, indel_status_map,
                                            indel_order, depth + 1, toggle_depth + 1, read_range, max_read_indel_toggle,
                                            start_cal);
             }
@@ -928,7 +1045,7 @@ candidate_alignment_search(
 
                     candidate_alignment_search(opt, dopt, read_id, read_length, indelBuffer, sampleId,
                                                realign_buffer_range, cal_set,
-                                               warn, indel_status_map,
+                                               warn, budget, indel_status_map,
                                                indel_order, depth + 1, toggle_depth + 1, read_range,
                                                max_read_indel_toggle, start_cal);
                 }
@@ -1133,6 +1250,8 @@ score_candidate_alignments(
     read_segment& rseg,
     IndelBuffer& indelBuffer,
     const std::set<candidate_alignment>& candAlignments,
+    CandidateAlignmentScoreCache& scoreCache,
+    unsigned& scoreCacheHitCount,
     std::vector<double>& candAlignmentScores,
     double& maxCandAlignmentScore,
     const candidate_alignment*& maxCandAlignmentPtr)
@@ -1158,7 +1277,9 @@ score_candidate_alignments(
     for (citer cal_iter(cal_set_begin); cal_iter!=cal_set_end; ++cal_iter)
     {
         const candidate_alignment& ical(*cal_iter);
-        const double path_lnp(score_candidate_alignment(opt,indelBuffer,rseg,ical,ref));
+        bool isCacheHit(false);
+        const double path_lnp(scoreCache.score(indelBuffer,rseg,ical,ref,isCacheHit));
+        if (isCacheHit) scoreCacheHitCount++;
 
         candAlignmentScores.push_back(path_lnp);
 
@@ -1317,7 +1438,9 @@ score_candidate_alignments_and_indels(
     IndelBuffer& indelBuffer,
     const unsigned sampleId,
     std::set<candidate_alignment>& candAlignments,
-    const bool is_incomplete_search)
+    const bool is_incomplete_search,
+    CandidateAlignmentScoreCache& scoreCache,
+    ReadRealignmentStats& realignStats)
 {
     assert(! candAlignments.empty());
 
@@ -1334,10 +1457,11 @@ score_candidate_alignments_and_indels(
     std::vector<double> candAlignmentScores;
     double maxCandAlignmentScore(0);
     const candidate_alignment* maxCandAlignmentPtr(nullptr);
+    unsigned scoreCacheHitCount(0);
 
     try
     {
-        score_candidate_alignments(opt, ref, rseg, indelBuffer, candAlignments,
+        score_candidate_alignments(opt, ref, rseg, indelBuffer, candAlignments, scoreCache, scoreCacheHitCount,
                                    candAlignmentScores, maxCandAlignmentScore, maxCandAlignmentPtr);
     }
     catch (...)
@@ -1346,6 +1470,8 @@ score_candidate_alignments_and_indels(
         throw;
     }
 
+    realignStats.addRead(candAlignments.size(), scoreCacheHitCount);
+
     // Realignment for snp-calling and visualization is complete here,
     // remaining task is to evaluate alternate alignments as required
     // by the indel calling model.
@@ -1445,6 +1571,7 @@ get_candidate_alignments(
     const alignment& inputAlignment,
     const known_pos_range realign_buffer_range,
     mca_warnings& warn,
+    CandidateSearchBudget& budget,
     std::set<candidate_alignment>& cal_set)
 {
     const unsigned read_length(rseg.read_size());
@@ -1553,7 +1680,7 @@ get_candidate_alignments(
     static const unsigned start_depth(0);
     static const unsigned start_toggle_depth(0);
     candidate_alignment_search(opt, dopt, rseg.id(), cal_read_length, indelBuffer, sampleId, realign_buffer_range, cal_set,
-                               warn, indel_status_map,
+                               warn, budget, indel_status_map,
                                indel_order, start_depth, start_toggle_depth, exemplar_pr, opt.max_read_indel_toggle,
                                cal);
 
@@ -1634,7 +1761,10 @@ realign_and_score_read(
     const known_pos_range& realign_buffer_range,
     const unsigned sampleId,
     read_segment& rseg,
-    IndelBuffer& indelBuffer)
+    IndelBuffer& indelBuffer,
+    CandidateAlignmentScoreCache& scoreCache,
+    RealignWindowSearchBudget& windowBudget,
+    ReadRealignmentStats& realignStats)
 {
     if (! rseg.is_valid())
     {
@@ -1679,11 +1809,43 @@ realign_and_score_read(
     // interpreted as "indel not present" rather than "reference", so
     // that all indels can be visited even if some conflict.
     //
+    // 6) the search work is limited by a budget for each read and for each realignment window. Reads
+    // which exceed either budget fall back to a search with toggle depth curtailed to 1, which still
+    // allows simple calls (distance 1 from input alignment).
+    //
     std::set<candidate_alignment> cal_set;
     mca_warnings warn;
 
-    get_candidate_alignments(opt, dopt, rseg, indelBuffer, sampleId, normedAlignment,
-                             realign_buffer_range, warn, cal_set);
+    static const int fallbackMaxToggle(1);
+    const bool isWindowBudgetExhausted((opt.max_window_realign_search_steps > 0) &&
+                                       (windowBudget.searchSteps >= opt.max_window_realign_search_steps));
+    unsigned searchSteps(0);
+    bool isReadBudgetExhausted(false);
+    if (! isWindowBudgetExhausted)
+    {
+        CandidateSearchBudget budget(opt.max_read_realign_search_steps, opt.max_read_indel_toggle);
+        get_candidate_alignments(opt, dopt, rseg, indelBuffer, sampleId, normedAlignment,
+                                 realign_buffer_range, warn, budget, cal_set);
+        searchSteps += budget.steps;
+        isReadBudgetExhausted = budget.isExhausted;
+    }
+
+    if (isWindowBudgetExhausted || isReadBudgetExhausted)
+    {
+        // restart from the input alignment so that the result does not depend on where the budget ran out:
+        cal_set.clear();
+        warn = mca_warnings();
+        warn.search_budget = true;
+
+        static const unsigned noStepLimit(0);
+        CandidateSearchBudget fallbackBudget(noStepLimit, fallbackMaxToggle);
+        get_candidate_alignments(opt, dopt, rseg, indelBuffer, sampleId, normedAlignment,
+                                 realign_buffer_range, warn, fallbackBudget, cal_set);
+        searchSteps += fallbackBudget.steps;
+    }
+
+    windowBudget.addSearchSteps(searchSteps);
+    realignStats.addSearch(searchSteps, isReadBudgetExhausted, isWindowBudgetExhausted);
 
     if ( cal_set.empty() )
     {
@@ -1692,15 +1854,16 @@ realign_and_score_read(
         throw blt_exception(oss.str().c_str());
     }
 
-    const bool is_incomplete_search(warn.origin_skip || warn.max_toggle_depth);
+    const bool is_incomplete_search(warn.origin_skip || warn.max_toggle_depth || warn.search_budget);
 
     // the max_toggle event is too common in genomic resequencing to have a
     // default warning:
     //
     const bool is_max_toggle_warn_enabled(opt.verbosity >= LOG_LEVEL::ALLWARN);
     const bool is_max_toggle_warn(warn.max_toggle_depth && is_max_toggle_warn_enabled);
+    const bool is_search_budget_warn(warn.search_budget && is_max_toggle_warn_enabled);
 
-    if (warn.origin_skip || (is_max_toggle_warn))
+    if (warn.origin_skip || is_max_toggle_warn || is_search_budget_warn)
     {
         auto writeSkipWarning = [&rseg](
                                     const char* reason)
@@ -1712,8 +1875,10 @@ realign_and_score_read(
 
         if (warn.origin_skip) writeSkipWarning("alignments crossed chromosome origin");
         if (is_max_toggle_warn) writeSkipWarning("exceeded max number of indel switches");
+        if (is_search_budget_warn) writeSkipWarning("exceeded realignment search budget");
     }
 
     score_candidate_alignments_and_indels(opt, dopt, sample_opt, ref,
-                                          rseg, indelBuffer, sampleId, cal_set, is_incomplete_search);
+                                          rseg, indelBuffer, sampleId, cal_set, is_incomplete_search,
+                                          scoreCache, realignStats);
 }
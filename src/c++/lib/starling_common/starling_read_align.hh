@@ -25,10 +25,68 @@
 #pragma once
 
 
+#include "appstats/ReadRealignmentStats.hh"
+#include "starling_common/CandidateAlignmentScoreCache.hh"
 #include "starling_common/IndelBuffer.hh"
 #include "starling_common/starling_read.hh"
 #include "starling_common/starling_base_shared.hh"
 
+#include <cassert>
+
+#include <deque>
+#include <utility>
+
+
+/// candidate alignment search work summed over all reads starting within the realignment window of the current
+/// position
+///
+/// Positions must be set in increasing order, the work of reads starting before the window is dropped as the
+/// window moves forward.
+///
+struct RealignWindowSearchBudget
+{
+    void
+    clear()
+    {
+        _posSearchSteps.clear();
+        searchSteps = 0;
+    }
+
+    /// set the start position of the reads to be searched, and the start of its realignment window
+    void
+    setPos(
+        const pos_t pos,
+        const pos_t windowBeginPos)
+    {
+        while ((not _posSearchSteps.empty()) && (_posSearchSteps.front().first < windowBeginPos))
+        {
+            searchSteps -= _posSearchSteps.front().second;
+            _posSearchSteps.pop_front();
+        }
+        if (_posSearchSteps.empty() || (_posSearchSteps.back().first != pos))
+        {
+            _posSearchSteps.emplace_back(pos, 0);
+        }
+    }
+
+    /// add search work for a read starting at the current position
+    void
+    addSearchSteps(const uint64_t steps)
+    {
+        assert(not _posSearchSteps.empty());
+        _posSearchSteps.back().second += steps;
+        searchSteps += steps;
+    }
+
+    /// search work of all reads in the window
+    uint64_t searchSteps = 0;
+
+private:
+    /// search work of the reads at each start position in the window
+    std::deque<std::pair<pos_t,uint64_t>> _posSearchSteps;
+};
+
+
 
 /// search for most likely realignments of the read and score alternate
 /// indel states in preparation for indel genotype calling
@@ -39,6 +97,11 @@
 /// realignment wrt the reference haplotype.
 ///
 /// \param realign_buffer_range range in reference coordinates in which read is allowed to realign to (due to buffering constraints)
+/// \param scoreCache candidate alignment score cache shared by all reads in the current realignment window
+/// \param windowBudget search work of all reads in the current realignment window, reads fall back to a
+///                     curtailed search once this exceeds the window search budget. The position of the read
+///                     must already be set.
+/// \param realignStats accumulates candidate alignment counts for the read
 ///
 void
 realign_and_score_read(
@@ -49,4 +112,7 @@ realign_and_score_read(
     const known_pos_range& realign_buffer_range,
     const unsigned sampleId,
     read_segment& rseg,
-    IndelBuffer& indelBuffer);
+    IndelBuffer& indelBuffer,
+    CandidateAlignmentScoreCache& scoreCache,
+    RealignWindowSearchBudget& windowBudget,
+    ReadRealignmentStats& realignStats);
@@ -40,100 +40,22 @@
 
 
 
-#ifdef DEBUG_SCORE
-#include <sstream>
-#include <iostream>
-
-struct align_position
-{
-
-    align_position(const char r,
-                   const char f,
-                   const char i) : read(r), ref(f), insert(i) {}
-    char read;
-    char ref;
-    char insert;
-};
-
-
-struct align_printer
-{
-
-    void
-    push(const char r, const char f, const char i)
-    {
-        _seq.push_back(align_position(r,f,i));
-    }
-
-    void
-    dump(std::ostream& os) const
-    {
-        os << "scoring alignment:\n";
-        const unsigned ss(_seq.size());
-        os << "read:   ";
-        for (unsigned i(0); i<ss; ++i) os << _seq[i].read;
-        os << "\n";
-        os << "        ";
-        for (unsigned i(0); i<ss; ++i)
-        {
-            char c(' ');
-            if (_seq[i].read != '-')
-            {
-                char r(_seq[i].ref);
-                if (r == '-') r=_seq[i].insert;
-                c=(_seq[i].read == r ? '|' : 'X');
-            }
-            os << c;
-        }
-        os << "\n";
-        os << "ref:    ";
-        for (unsigned i(0); i<ss; ++i) os << _seq[i].ref;
-        os << "\n";
-        os << "insert: ";
-        for (unsigned i(0); i<ss; ++i) os << _seq[i].insert;
-        os << "\n";
-    }
-
-private:
-    std::vector<align_position> _seq;
-};
-#endif
-
-
-// score a contiguous matching alignment segment
-//
-// note that running the lnp value through as a reference creates more
-// floating point stability for ambiguous alignments which have the
-// same score by definition.
-//
+/// record the expected read bases for a contiguous matching alignment segment
+///
 static
 void
-score_segment(const starling_base_options& /*opt*/,
-              const unsigned seg_length,
-              const bam_seq_base& seq,
-              const uint8_t* qual,
-              const unsigned read_offset,
-              const bam_seq_base& ref,
-              const pos_t ref_head_pos,
-              double& lnp)
+set_segment_expected_bases(
+    const unsigned seg_length,
+    const unsigned read_offset,
+    const bam_seq_base& ref,
+    const pos_t ref_head_pos,
+    std::vector<uint8_t>& expectedBases)
 {
-    static const double lnthird(-std::log(3.));
-
+    assert((read_offset+seg_length) <= expectedBases.size());
     for (unsigned i(0); i<seg_length; ++i)
     {
-        const pos_t readi(static_cast<pos_t>(read_offset+i));
-        const uint8_t sbase(seq.get_code(readi));
-        if (sbase == BAM_BASE::ANY) continue;
-        const uint8_t qscore(qual[readi]);
-        bool is_ref(sbase == BAM_BASE::REF);
-        if (! is_ref)
-        {
-            const pos_t refi(ref_head_pos+static_cast<pos_t>(i));
-            is_ref=(sbase == ref.get_code(refi));
-        }
-        lnp += ( is_ref ?
-                 qphred_to_ln_comp_error_prob(qscore) :
-                 qphred_to_ln_error_prob(qscore)+lnthird );
+        const pos_t refi(ref_head_pos+static_cast<pos_t>(i));
+        expectedBases[read_offset+i] = ref.get_code(refi);
     }
 }
 
@@ -222,31 +144,21 @@ getInsertSeq(
 
 
 
-double
-score_candidate_alignment(
-    const starling_base_options& opt,
+void
+get_candidate_alignment_expected_bases(
     const IndelBuffer& indelBuffer,
-    const read_segment& rseg,
+    const unsigned read_length,
     const candidate_alignment& cal,
-    const reference_contig_segment& ref)
+    const reference_contig_segment& ref,
+    std::vector<uint8_t>& expectedBases)
 {
     using namespace ALIGNPATH;
 
-#ifdef DEBUG_SCORE
-    static const char GAP('-');
-    align_printer ap;
-#endif
-
-    double al_lnp(0.);
+    expectedBases.assign(read_length, UNSCORED_READ_BASE);
     const rc_segment_bam_seq ref_bseq(ref);
-    const bam_seq read_bseq(rseg.get_bam_read());
-    const uint8_t* qual(rseg.qual());
 
     const path_t& path(cal.al.path);
-
-#ifdef DEBUG_SCORE
-    log_os << "LLAMA: path: " << path << "\n";
-#endif
+    assert(apath_read_length(path) == read_length);
 
     unsigned read_offset(0);
     pos_t ref_head_pos(cal.al.pos);
@@ -261,10 +173,6 @@ score_candidate_alignment(
         unsigned n_seg(1); // number of path segments consumed
         const path_segment& ps(path[path_index]);
 
-#ifdef DEBUG_SCORE
-        log_os << "LLAMA: path_index: " << path_index << " read_offset: " << read_offset << " ref_head_pos: " << ref_head_pos << "\n";
-#endif
-
         if       (is_swap_start)
         {
             const swap_info sinfo(path,path_index);
@@ -287,50 +195,19 @@ score_candidate_alignment(
                 insert_seq_head_pos=static_cast<int>(insert_bseq.size())-static_cast<int>(ps.length);
             }
 
-            score_segment(opt,
-                          sinfo.insert_length,
-                          read_bseq,
-                          qual,
-                          read_offset,
-                          insert_bseq,
-                          insert_seq_head_pos,
-                          al_lnp);
-
-#ifdef DEBUG_SCORE
-            for (unsigned ii(0); ii<sinfo.insert_length; ++ii)
-            {
-                ap.push(read_bseq.get_char(static_cast<pos_t>(read_offset+ii)),
-                        GAP,
-                        insert_bseq.get_char(insert_seq_head_pos+static_cast<pos_t>(ii)));
-            }
-            for (unsigned ii(0); ii<sinfo.delete_length; ++ii)
-            {
-                ap.push(GAP,
-                        ref_bseq.get_char(ref_head_pos+static_cast<pos_t>(ii)),
-                        GAP);
-            }
-#endif
-
+            set_segment_expected_bases(sinfo.insert_length,
+                                       read_offset,
+                                       insert_bseq,
+                                       insert_seq_head_pos,
+                                       expectedBases);
         }
         else if (is_segment_align_match(ps.type))
         {
-            score_segment(opt,
-                          ps.length,
-                          read_bseq,
-                          qual,
-                          read_offset,
-                          ref_bseq,
-                          ref_head_pos,
-                          al_lnp);
-#ifdef DEBUG_SCORE
-            for (unsigned ii(0); ii<ps.length; ++ii)
-            {
-                ap.push(read_bseq.get_char(static_cast<pos_t>(read_offset+ii)),
-                        ref_bseq.get_char(ref_head_pos+static_cast<pos_t>(ii)),
-                        GAP);
-            }
-#endif
-
+            set_segment_expected_bases(ps.length,
+                                       read_offset,
+                                       ref_bseq,
+                                       ref_head_pos,
+                                       expectedBases);
         }
         else if (ps.type==INSERT)
         {
@@ -348,38 +225,16 @@ score_candidate_alignment(
                 insert_seq_head_pos=static_cast<int>(insert_bseq.size())-static_cast<int>(ps.length);
             }
 
-            score_segment(opt,
-                          ps.length,
-                          read_bseq,
-                          qual,
-                          read_offset,
-                          insert_bseq,
-                          insert_seq_head_pos,
-                          al_lnp);
-
-#ifdef DEBUG_SCORE
-            for (unsigned ii(0); ii<ps.length; ++ii)
-            {
-                ap.push(read_bseq.get_char(static_cast<pos_t>(read_offset+ii)),
-                        GAP,
-                        insert_bseq.get_char(insert_seq_head_pos+static_cast<pos_t>(ii)));
-            }
-#endif
-
+            set_segment_expected_bases(ps.length,
+                                       read_offset,
+                                       insert_bseq,
+                                       insert_seq_head_pos,
+                                       expectedBases);
         }
         else if ((ps.type==DELETE) || (ps.type==SKIP))
         {
             // no read segment to worry about in this case
             //
-#ifdef DEBUG_SCORE
-            for (unsigned ii(0); ii<ps.length; ++ii)
-            {
-                ap.push(GAP,
-                        ref_bseq.get_char(ref_head_pos+static_cast<pos_t>(ii)),
-                        GAP);
-            }
-#endif
-
         }
         else if (ps.type==SOFT_CLIP)
         {
@@ -413,9 +268,49 @@ score_candidate_alignment(
             increment_path(path,path_index,read_offset,ref_head_pos);
         }
     }
+}
+
+
+
+double
+score_candidate_alignment_expected_bases(
+    const read_segment& rseg,
+    const std::vector<uint8_t>& expectedBases)
+{
+    static const double lnthird(-std::log(3.));
+
+    const bam_seq read_bseq(rseg.get_bam_read());
+    const uint8_t* qual(rseg.qual());
+
+    // note that accumulating the lnp value in read order for every candidate
+    // creates more floating point stability for ambiguous alignments which
+    // have the same score by definition.
+    //
+    double al_lnp(0.);
+    const unsigned read_length(expectedBases.size());
+    for (unsigned readi(0); readi<read_length; ++readi)
+    {
+        const uint8_t expectedBase(expectedBases[readi]);
+        if (expectedBase == UNSCORED_READ_BASE) continue;
+        const uint8_t sbase(read_bseq.get_code(static_cast<pos_t>(readi)));
+        if (sbase == BAM_BASE::ANY) continue;
+        const uint8_t qscore(qual[readi]);
+        const bool is_ref((sbase == BAM_BASE::REF) || (sbase == expectedBase));
+        al_lnp += ( is_ref ?
+                    qphred_to_ln_comp_error_prob(qscore) :
+                    qphred_to_ln_error_prob(qscore)+lnthird );
+    }
 
 #ifdef DEBUG_SCORE
-    ap.dump(log_os);
+    log_os << "LLAMA: read:     ";
+    for (unsigned readi(0); readi<read_length; ++readi) log_os << read_bseq.get_char(static_cast<pos_t>(readi));
+    log_os << "\nLLAMA: expected: ";
+    for (const uint8_t expectedBase : expectedBases)
+    {
+        log_os << ((expectedBase == UNSCORED_READ_BASE) ? '-' : get_bam_seq_char(expectedBase));
+    }
+    log_os << "\nLLAMA: score: " << al_lnp << "\n";
 #endif
+
     return al_lnp;
 }
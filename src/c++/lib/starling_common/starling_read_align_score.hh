@@ -30,16 +30,36 @@
 #include "starling_common/starling_read.hh"
 #include "starling_common/starling_base_shared.hh"
 
+#include <cstdint>
 
-/// return score of candidate alignment cal for read segment rseg
+#include <vector>
+
+
+/// sentinel expected base value for read positions which are not scored (ie. soft-clipped)
+static const uint8_t UNSCORED_READ_BASE(0xFF);
+
+
+/// get the read bases expected under candidate alignment cal
 ///
-/// essentially this is P(read | haplotype), where read=rseg and haplotype=ref+candidate alignment
+/// the expected bases only depend on the candidate alignment and its indels (ie. the haplotype), so they
+/// can be reused to score any read of the same length with the same candidate alignment.
 ///
-double
-score_candidate_alignment(
-    const starling_base_options& opt,
+/// \param[out] expectedBases bam 4-bit base code expected at each read position, or UNSCORED_READ_BASE
+///
+void
+get_candidate_alignment_expected_bases(
     const IndelBuffer& indelBuffer,
-    const read_segment& rseg,
+    const unsigned read_length,
     const candidate_alignment& cal,
-    const reference_contig_segment& ref);
+    const reference_contig_segment& ref,
+    std::vector<uint8_t>& expectedBases);
+
 
+/// return score of read segment rseg given its expected bases under a candidate alignment
+///
+/// essentially this is P(read | haplotype), where read=rseg and haplotype=ref+candidate alignment
+///
+double
+score_candidate_alignment_expected_bases(
+    const read_segment& rseg,
+    const std::vector<uint8_t>& expectedBases);
@@ -32,6 +32,7 @@
 
 #include <cassert>
 
+#include <algorithm>
 #include <iostream>
 
 
@@ -42,7 +43,115 @@ const starling_read_buffer::segment_group_t starling_read_buffer::_empty_segment
 starling_read_buffer::
 ~starling_read_buffer()
 {
-    for (auto& val : _read_data) delete val.second;
+    for (starling_read* srp : _readIndex) delete srp;
+    for (starling_read* srp : _readPool) delete srp;
+}
+
+
+
+starling_read*
+starling_read_buffer::
+getNewRead(const bam_record& br)
+{
+    if (_readPool.empty()) return new starling_read(br);
+
+    starling_read* srp(_readPool.back());
+    _readPool.pop_back();
+    srp->reset(br);
+    return srp;
+}
+
+
+
+void
+starling_read_buffer::
+releaseRead(const align_id_t read_id)
+{
+    assert(isReadIndexed(read_id));
+    starling_read*& srp(_readIndex[read_id-_readIndexBeginId]);
+    assert(nullptr != srp);
+    _readPool.push_back(srp);
+    srp = nullptr;
+    _readCount--;
+
+    // trim empty entries from the front of the id window:
+    while ((not _readIndex.empty()) && (nullptr == _readIndex.front()))
+    {
+        _readIndex.pop_front();
+        _readIndexBeginId++;
+    }
+}
+
+
+
+starling_read_buffer::pos_group_t::iterator
+starling_read_buffer::
+lowerBoundSegmentGroup(const pos_t pos)
+{
+    return std::lower_bound(_pos_group.begin(), _pos_group.end(), pos,
+                            [](const pos_group_t::value_type& posGroup, const pos_t p)
+    {
+        return (posGroup.first < p);
+    });
+}
+
+
+
+starling_read_buffer::pos_group_t::iterator
+starling_read_buffer::
+findSegmentGroup(const pos_t pos)
+{
+    const pos_group_t::iterator iter(lowerBoundSegmentGroup(pos));
+    if ((iter == _pos_group.end()) || (iter->first != pos)) return _pos_group.end();
+    return iter;
+}
+
+
+
+starling_read_buffer::pos_group_t::const_iterator
+starling_read_buffer::
+findSegmentGroup(const pos_t pos) const
+{
+    return const_cast<starling_read_buffer*>(this)->findSegmentGroup(pos);
+}
+
+
+
+starling_read_buffer::segment_group_t&
+starling_read_buffer::
+getSegmentGroup(const pos_t pos)
+{
+    // new reads are almost always added at or after the highest buffered position, so check this case first:
+    pos_group_t::iterator iter(_pos_group.end());
+    if ((not _pos_group.empty()) && (_pos_group.back().first >= pos))
+    {
+        iter = lowerBoundSegmentGroup(pos);
+    }
+
+    if ((iter == _pos_group.end()) || (iter->first != pos))
+    {
+        iter = _pos_group.insert(iter, std::make_pair(pos, segment_group_t()));
+        if (not _segmentGroupPool.empty())
+        {
+            iter->second.swap(_segmentGroupPool.back());
+            _segmentGroupPool.pop_back();
+        }
+    }
+    return iter->second;
+}
+
+
+
+void
+starling_read_buffer::
+insertSegment(
+    const pos_t pos,
+    const segment_t& segment)
+{
+    segment_group_t& segGroup(getSegmentGroup(pos));
+    const segment_group_t::iterator iter(std::lower_bound(segGroup.begin(), segGroup.end(), segment));
+    assert((iter == segGroup.end()) || (*iter != segment));
+    segGroup.insert(iter, segment);
 }
 
 
@@ -56,11 +165,16 @@ add_read_alignment(
 {
     assert(! br.is_unmapped());
 
-    align_id_t this_read_id;
+    const align_id_t this_read_id(next_id());
 
-    this_read_id=next_id();
-    _read_data[this_read_id] = new starling_read(br);
-    starling_read& sread(*(_read_data[this_read_id]));
+    // add read to the id index:
+    if (_readIndex.empty()) _readIndexBeginId = this_read_id;
+    assert(this_read_id >= (_readIndexBeginId+_readIndex.size()));
+    _readIndex.resize(this_read_id-_readIndexBeginId, nullptr);
+    _readIndex.push_back(getNewRead(br));
+    _readCount++;
+
+    starling_read& sread(*(_readIndex.back()));
 
     sread.id() = this_read_id;
 
@@ -76,7 +190,7 @@ add_read_alignment(
             const uint8_t seg_no(i+1);
             const pos_t seg_buffer_pos(get_alignment_buffer_pos(sread.get_segment(seg_no).genome_align()));
             sread.get_segment(seg_no).buffer_pos = seg_buffer_pos;
-            (_pos_group[seg_buffer_pos]).insert(std::make_pair(this_read_id,seg_no));
+            insertSegment(seg_buffer_pos, std::make_pair(this_read_id,seg_no));
         }
     }
     else
@@ -84,7 +198,7 @@ add_read_alignment(
         const pos_t buffer_pos(get_alignment_buffer_pos(al));
         const seg_id_t seg_id(0);
         sread.get_full_segment().buffer_pos = buffer_pos;
-        (_pos_group[buffer_pos]).insert(std::make_pair(this_read_id,seg_id));
+        insertSegment(buffer_pos, std::make_pair(this_read_id,seg_id));
     }
 
     return this_read_id;
@@ -99,23 +213,25 @@ rebuffer_read_segment(const align_id_t read_id,
                       const pos_t new_buffer_pos)
 {
     // double check that the read exists:
-    const read_data_t::iterator i(_read_data.find(read_id));
-    if (i == _read_data.end()) return;
+    starling_read* srp(get_read(read_id));
+    if (nullptr == srp) return;
 
-    read_segment& rseg(i->second->get_segment(seg_id));
+    read_segment& rseg(srp->get_segment(seg_id));
 
     // remove from old pos list:
-    const pos_group_t::iterator j(_pos_group.find(rseg.buffer_pos));
+    const pos_group_t::iterator j(findSegmentGroup(rseg.buffer_pos));
     assert(j != _pos_group.end());
     const segment_t segkey(std::make_pair(read_id,seg_id));
-    assert(j->second.count(segkey)==1);
-    j->second.erase(segkey);
+    segment_group_t& segGroup(j->second);
+    const segment_group_t::iterator k(std::lower_bound(segGroup.begin(), segGroup.end(), segkey));
+    assert((k != segGroup.end()) && (*k == segkey));
+    segGroup.erase(k);
 
     // alter data within read:
     rseg.buffer_pos=new_buffer_pos;
 
     // add to new pos list:
-    (_pos_group[new_buffer_pos]).insert(segkey);
+    insertSegment(new_buffer_pos, segkey);
 }
 #endif
 
@@ -126,7 +242,7 @@ starling_read_buffer::
 get_pos_read_segment_iter(const pos_t pos)
 {
     const segment_group_t* g(&(_empty_segment_group));
-    const pos_group_t::const_iterator j(_pos_group.find(pos));
+    const pos_group_t::const_iterator j(findSegmentGroup(pos));
     if (j != _pos_group.end()) g=(&(j->second));
     return read_segment_iter(*this,g->begin(),g->end());
 }
@@ -135,19 +251,17 @@ get_pos_read_segment_iter(const pos_t pos)
 
 void
 starling_read_buffer::
-clear_iter(
-    const pos_group_t::iterator i)
+clear_front()
 {
-    segment_group_t& seg_group(i->second);
+    assert(not _pos_group.empty());
+    segment_group_t& seg_group(_pos_group.front().second);
     for (const auto& val : seg_group)
     {
         const align_id_t read_id(val.first);
         const seg_id_t seg_id(val.second);
 
-        const read_data_t::iterator k(_read_data.find(read_id));
-        if (k == _read_data.end()) continue;
-
-        const starling_read* srp(k->second);
+        const starling_read* srp(get_read(read_id));
+        if (nullptr == srp) continue;
 
         // only remove read from data structure when we find the last
         // segment: -- note this assumes that two segments will not
@@ -155,12 +269,12 @@ clear_iter(
         //
         if (seg_id != srp->segment_count()) continue;
 
-        // remove from simple lookup structures and delete read itself:
-        _read_data.erase(k);
-
-        delete srp;
+        // remove from simple lookup structures and recycle read itself:
+        releaseRead(read_id);
     }
-    _pos_group.erase(i);
+    seg_group.clear();
+    _segmentGroupPool.push_back(std::move(seg_group));
+    _pos_group.pop_front();
 }
 
 
@@ -170,7 +284,7 @@ starling_read_buffer::
 dump_pos(const pos_t pos,
          std::ostream& os) const
 {
-    const pos_group_t::const_iterator i(_pos_group.find(pos));
+    const pos_group_t::const_iterator i(findSegmentGroup(pos));
     if (i == _pos_group.end()) return;
 
     os << "READ_BUFFER_POSITION: " << pos << " DUMP ON\n";
@@ -181,10 +295,10 @@ dump_pos(const pos_t pos,
     {
         const align_id_t read_id(j->first);
         const seg_id_t seg_id(j->second);
-        const read_data_t::const_iterator k(_read_data.find(read_id));
-        if (k == _read_data.end()) continue;
+        const starling_read* srp(get_read(read_id));
+        if (nullptr == srp) continue;
 
-        const starling_read& sr(*(k->second));
+        const starling_read& sr(*srp);
         os << "READ_BUFFER_POSITION: " << pos << " read_segment_no: " << ++r << " seg_id: " << seg_id << "\n";
         os << sr.get_segment(seg_id);
     }
@@ -201,7 +315,7 @@ get_ptr()
     if (_head==_end) return null_ret;
     const align_id_t read_id(_head->first);
     const seg_id_t seg_id(_head->second);
-    const starling_read_buffer::read_data_t::iterator i(_buff._read_data.find(read_id));
-    if (i==_buff._read_data.end()) return null_ret;
-    return std::make_pair(i->second,seg_id);
+    starling_read* srp(_buff.get_read(read_id));
+    if (nullptr == srp) return null_ret;
+    return std::make_pair(srp,seg_id);
 }
@@ -29,8 +29,8 @@
 
 #include "boost/utility.hpp"
 
-#include <map>
-#include <set>
+#include <deque>
+#include <vector>
 
 
 // Simple id incrementer, by default starling read buffer uses this
@@ -68,6 +68,11 @@ struct read_segment_iter;
 // multiple reads may be associated with (1) and (4), but (2) and (3)
 // can produce at most a single result.
 //
+// read objects and segment lists are recycled through free lists as the
+// buffer window slides, and both read id and position lookup use flat
+// sorted windows rather than node based maps, so that steady-state
+// buffering of reads performs few heap allocations.
+//
 struct starling_read_buffer : private boost::noncopyable
 {
     starling_read_buffer(read_id_counter* ricp = nullptr)
@@ -103,18 +108,16 @@ struct starling_read_buffer : private boost::noncopyable
     starling_read*
     get_read(const align_id_t read_id)
     {
-        const read_data_t::iterator k(_read_data.find(read_id));
-        if (k == _read_data.end()) return nullptr;
-        return (k->second);
+        if (not isReadIndexed(read_id)) return nullptr;
+        return _readIndex[read_id-_readIndexBeginId];
     }
 
     // returns nullptr if read_id isn't present:
     const starling_read*
     get_read(const align_id_t read_id) const
     {
-        const read_data_t::const_iterator k(_read_data.find(read_id));
-        if (k == _read_data.end()) return nullptr;
-        return (k->second);
+        if (not isReadIndexed(read_id)) return nullptr;
+        return _readIndex[read_id-_readIndexBeginId];
     }
 
     /// clear contents of read buffer up to and including position pos
@@ -122,12 +125,9 @@ struct starling_read_buffer : private boost::noncopyable
     clear_to_pos(
         const pos_t pos)
     {
-        pos_group_t::iterator iter(_pos_group.begin());
-        const pos_group_t::iterator end(_pos_group.upper_bound(pos));
-
-        while (iter != end)
+        while ((not _pos_group.empty()) && (_pos_group.front().first <= pos))
         {
-            clear_iter(iter++);
+            clear_front();
         }
     }
 
@@ -138,12 +138,9 @@ struct starling_read_buffer : private boost::noncopyable
     void
     clear()
     {
-        pos_group_t::iterator iter(_pos_group.begin());
-        const pos_group_t::iterator end(_pos_group.end());
-
-        while (iter != end)
+        while (not _pos_group.empty())
         {
-            clear_iter(iter++);
+            clear_front();
         }
     }
 
@@ -151,7 +148,7 @@ struct starling_read_buffer : private boost::noncopyable
     unsigned
     size() const
     {
-        return _read_data.size();
+        return _readCount;
     }
 
     bool
@@ -161,16 +158,51 @@ struct starling_read_buffer : private boost::noncopyable
     }
 
 private:
-    typedef std::map<align_id_t,starling_read*> read_data_t;
     typedef std::pair<align_id_t,seg_id_t> segment_t;
-    typedef std::set<segment_t> segment_group_t;
-    typedef std::map<pos_t,segment_group_t> pos_group_t;
 
+    /// read segments at one buffer position, sorted by (read_id,seg_id)
+    typedef std::vector<segment_t> segment_group_t;
+
+    /// segment groups for each buffer position, sorted by position
+    typedef std::deque<std::pair<pos_t,segment_group_t>> pos_group_t;
+
+    bool
+    isReadIndexed(const align_id_t read_id) const
+    {
+        return ((read_id >= _readIndexBeginId) && ((read_id-_readIndexBeginId) < _readIndex.size()));
+    }
+
+    /// get a recycled read object if available, otherwise allocate a new one
+    starling_read*
+    getNewRead(const bam_record& br);
 
-    /// the input iterator will be invalidated by this method!
+    /// remove read from the id index and return it to the free list
     void
-    clear_iter(
-        const pos_group_t::iterator i);
+    releaseRead(const align_id_t read_id);
+
+    /// first segment group at or after pos
+    pos_group_t::iterator
+    lowerBoundSegmentGroup(const pos_t pos);
+
+    /// find the segment group at pos, or return end() if pos is not present
+    pos_group_t::iterator
+    findSegmentGroup(const pos_t pos);
+
+    pos_group_t::const_iterator
+    findSegmentGroup(const pos_t pos) const;
+
+    /// get the segment group at pos, creating it if necessary
+    segment_group_t&
+    getSegmentGroup(const pos_t pos);
+
+    void
+    insertSegment(
+        const pos_t pos,
+        const segment_t& segment);
+
+    /// clear all read segments at the lowest buffered position
+    void
+    clear_front();
 
     align_id_t
     next_id() const
@@ -189,8 +221,15 @@ private:
     read_id_counter _ric; // only used if a counter isn't specified on the cmdline
     read_id_counter* _ricp;
 
-    // read id to read data structure pointer map:
-    read_data_t _read_data;
+    // read id to read data structure pointer lookup, this is a window over the read id range
+    // starting at _readIndexBeginId, where ids which are not present in this buffer are nullptr:
+    std::deque<starling_read*> _readIndex;
+    align_id_t _readIndexBeginId = 0;
+    unsigned _readCount = 0;
+
+    // recycled read objects and segment group storage:
+    std::vector<starling_read*> _readPool;
+    std::vector<segment_group_t> _segmentGroupPool;
 
     // storage position to read segment id map
     //
@@ -24,10 +24,50 @@
 
 #include "starling_common/starling_ref_seq.hh"
 
+#include "blt_util/Fnv1aChecksum.hh"
 #include "common/Exceptions.hh"
 #include "htsapi/samtools_fasta_util.hh"
 #include "htsapi/bam_header_util.hh"
 
+#include "boost/filesystem.hpp"
+
+#include <mutex>
+
+
+
+/// get the packed reference, this is mapped once per process and shared by all regions and threads
+///
+/// the packed reference is checked against the fasta reference when it is first mapped
+static
+std::shared_ptr<const PackedReference>
+getPackedReference(
+    const starling_base_options& opt)
+{
+    static std::mutex packedRefMutex;
+    static std::shared_ptr<const PackedReference> packedRef;
+
+    std::lock_guard<std::mutex> lock(packedRefMutex);
+    if (packedRef and (packedRef->filename() == opt.packedReferenceFilename)) return packedRef;
+
+    std::shared_ptr<const PackedReference> newRef(new PackedReference(opt.packedReferenceFilename));
+
+    uint64_t indexSize(0);
+    const uint64_t indexChecksum(getFileChecksum(opt.referenceFilename + ".fai", indexSize));
+    if ((newRef->header().sourceIndexChecksum != indexChecksum) or
+        (newRef->header().sourceFastaSize != boost::filesystem::file_size(opt.referenceFilename)))
+    {
+        using namespace illumina::common;
+
+        std::ostringstream oss;
+        oss << "ERROR: packed reference file '" << opt.packedReferenceFilename
+            << "' was not created from reference file '" << opt.referenceFilename << "'";
+        BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+    }
+
+    packedRef = newRef;
+    return packedRef;
+}
+
 
 
 void
@@ -39,6 +79,23 @@ setRefSegment(
 {
     assert(! chrom.empty());
 
+    if (! opt.packedReferenceFilename.empty())
+    {
+        std::shared_ptr<const PackedReference> packedRef(getPackedReference(opt));
+        const PackedReferenceContig* contig(packedRef->getContig(chrom));
+        if (nullptr == contig)
+        {
+            using namespace illumina::common;
+
+            std::ostringstream oss;
+            oss << "ERROR: Can't find sequence '" << chrom << "' in packed reference file: '" << opt.packedReferenceFilename << "'";
+            BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+        }
+        ref.set_packed_contig(packedRef, *contig, range.begin_pos(), range.end_pos());
+        return;
+    }
+
+    ref.clear();
     ref.set_offset(range.begin_pos());
     // note: the ref function below takes closed-closed endpoints, so we subtract one from endPos
     get_standardized_region_seq(opt.referenceFilename, chrom, range.begin_pos(), range.end_pos()-1, ref.seq());
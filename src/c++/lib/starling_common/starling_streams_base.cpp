@@ -23,8 +23,10 @@
 
 #include "starling_common/starling_streams_base.hh"
 #include "blt_util/digt.hh"
+#include "htsapi/BgzfIndexedOutput.hh"
 #include "htsapi/vcf_util.hh"
 
+#include <algorithm>
 #include <cassert>
 #include <ctime>
 
@@ -157,9 +159,10 @@ open_ofstream(const prog_info& pinfo,
 
 
 
-std::unique_ptr<bam_dumper>
+std::unique_ptr<SortedBamDumper>
 starling_streams_base::
 initialize_realign_bam(
+    const starling_base_options& opt,
     const std::string& filename,
     const bam_hdr_t& header)
 {
@@ -168,7 +171,39 @@ initialize_realign_bam(
     //fp->header = bam_header_dup((const bam_header_t*)aux);
     //fos << "@PG\tID:" << pinfo.name() << "\tVN:" << pinfo.version() << "\tCL:" << cmdline << "\n";
 
-    return std::unique_ptr<bam_dumper>(new bam_dumper(filename.c_str(),header));
+    return std::unique_ptr<SortedBamDumper>(new SortedBamDumper(filename.c_str(),header,
+                                                                opt.realignedReadCompressionThreadCount));
+}
+
+
+
+std::ostream*
+starling_streams_base::
+initialize_text_stream(
+    const prog_info& pinfo,
+    const std::string& filename,
+    const char* label,
+    const int bgzfCompressionLevel)
+{
+    std::ostream* osPtr(nullptr);
+    BgzfIndexFragment::index_t bgzfIndexFormat;
+    if (_isRegionBuffer)
+    {
+        osPtr = new std::ostringstream;
+    }
+    else if (getBgzfIndexFormat(filename, bgzfIndexFormat))
+    {
+        osPtr = new BgzfIndexedOstream(filename, bgzfIndexFormat, bgzfCompressionLevel);
+    }
+    else
+    {
+        std::ofstream* fosPtr(new std::ofstream);
+        open_ofstream(pinfo,filename,label,*fosPtr);
+        osPtr = fosPtr;
+    }
+    _textStreams.push_back(osPtr);
+    _textStreamBedRangeMerge.push_back(nullptr);
+    return osPtr;
 }
 
 
@@ -182,17 +217,80 @@ initialize_candidate_indel_file(
 {
     const char* const cmdline(opt.cmdline.c_str());
 
-    std::ofstream* fosptr(new std::ofstream);
-    std::ofstream& fos(*fosptr);
-    open_ofstream(pinfo,filename,"candidate-indel",fos);
+    std::ostream* osPtr(initialize_text_stream(pinfo,filename,"candidate-indel"));
+    if (_isRegionBuffer) return osPtr;
 
+    std::ostream& fos(*osPtr);
     fos << "# ** " << pinfo.name();
     fos << " candidate-indel file **\n";
     write_file_audit(opt,pinfo,cmdline,fos);
     fos << "#\n";
     fos << "#$ COLUMNS seq_name pos type length seq\n";
 
-    return fosptr;
+    return osPtr;
+}
+
+
+
+void
+starling_streams_base::
+transferRegionOutput(TaskOutput& regionOutput) const
+{
+    assert(_isRegionBuffer);
+
+    regionOutput.clear();
+    for (std::ostream* osPtr : _textStreams)
+    {
+        std::ostringstream& oss(static_cast<std::ostringstream&>(*osPtr));
+        regionOutput.push_back(oss.str());
+        oss.str("");
+    }
+}
+
+
+
+void
+starling_streams_base::
+writeRegionOutput(const TaskOutput& regionOutput) const
+{
+    assert(not _isRegionBuffer);
+    assert(regionOutput.size() == _textStreams.size());
+
+    const unsigned streamCount(_textStreams.size());
+    for (unsigned streamIndex(0); streamIndex < streamCount; ++streamIndex)
+    {
+        RegionProcessor* mergePtr(_textStreamBedRangeMerge[streamIndex]);
+        if (nullptr == mergePtr)
+        {
+            *(_textStreams[streamIndex]) << regionOutput[streamIndex];
+            continue;
+        }
+
+        std::istringstream iss(regionOutput[streamIndex]);
+        std::string chrom;
+        pos_t beginPos;
+        pos_t endPos;
+        while (iss >> chrom >> beginPos >> endPos)
+        {
+            mergePtr->addRange(chrom, beginPos, endPos);
+        }
+        assert(iss.eof());
+    }
+}
+
+
+
+void
+starling_streams_base::
+setBedRangeMerge(
+    const std::ostream* osPtr,
+    RegionProcessor& merger)
+{
+    assert(not _isRegionBuffer);
+
+    const auto iter(std::find(_textStreams.begin(), _textStreams.end(), osPtr));
+    assert(iter != _textStreams.end());
+    _textStreamBedRangeMerge[iter-_textStreams.begin()] = &merger;
 }
 
 
@@ -201,9 +299,11 @@ starling_streams_base::
 starling_streams_base(
     const starling_base_options& opt,
     const prog_info& pinfo,
-    const unsigned sampleCount)
+    const unsigned sampleCount,
+    const bool isRegionBuffer)
     : _realign_bam_ptr(sampleCount),
-      _sampleCount(sampleCount)
+      _sampleCount(sampleCount),
+      _isRegionBuffer(isRegionBuffer)
 {
     assert(_sampleCount > 0);
 
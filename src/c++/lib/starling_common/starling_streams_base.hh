@@ -24,9 +24,11 @@
 
 #pragma once
 
+#include "blt_util/OrderedTaskRunner.hh"
 #include "blt_util/prog_info.hh"
+#include "blt_util/RegionProcessor.hh"
 #include "htsapi/bam_util.hh"
-#include "htsapi/bam_dumper.hh"
+#include "htsapi/SortedBamDumper.hh"
 #include "starling_common/starling_base_shared.hh"
 #include "starling_common/starling_types.hh"
 
@@ -36,14 +38,21 @@
 #include <vector>
 
 
+/// manages all output streams for the small variant callers
+///
+/// In region buffer mode, all text output streams are in-memory buffers without any header content. This is used
+/// to accumulate the output of one analysis region on a worker thread, the buffered output is later appended to the
+/// file streams of the primary streams object in region order.
+///
 struct starling_streams_base
 {
     starling_streams_base(
         const starling_base_options& opt,
         const prog_info& pinfo,
-        const unsigned sampleCount);
+        const unsigned sampleCount,
+        const bool isRegionBuffer = false);
 
-    bam_dumper*
+    SortedBamDumper*
     realign_bam_ptr(const unsigned sampleIndex) const
     {
         return _realign_bam_ptr[sampleIndex].get();
@@ -61,13 +70,55 @@ struct starling_streams_base
         return _sampleCount;
     }
 
+    bool
+    isRegionBuffer() const
+    {
+        return _isRegionBuffer;
+    }
+
+    /// move all text output accumulated since the last call into regionOutput, with one entry per text stream
+    ///
+    /// only valid in region buffer mode
+    void
+    transferRegionOutput(TaskOutput& regionOutput) const;
+
+    /// append region output transferred from a region buffer streams object to the corresponding text streams
+    ///
+    /// BED range output registered with setBedRangeMerge is passed through its range merger instead, so that
+    /// ranges which abut across a region boundary are written as one range, as they are without region buffers
+    void
+    writeRegionOutput(const TaskOutput& regionOutput) const;
+
 protected:
-    std::unique_ptr<bam_dumper>
+    /// open a text output file, or create an in-memory buffer in region buffer mode
+    ///
+    /// all text streams must be created through this method, and in the same order for a given set of options
+    ///
+    /// files with a '.vcf.gz' or '.bed.gz' extension are written as BGZF segments with index fragments, see
+    /// htsapi/BgzfIndexedOutput.hh
+    ///
+    /// \param[in] bgzfCompressionLevel zlib compression level for BGZF output, or -1 for the BGZF default
+    std::ostream*
+    initialize_text_stream(
+        const prog_info& pinfo,
+        const std::string& filename,
+        const char* label,
+        const int bgzfCompressionLevel = -1);
+
+    /// open a realigned read BAM file, reads are written in coordinate order through a reorder buffer
+    std::unique_ptr<SortedBamDumper>
     initialize_realign_bam(
+        const starling_base_options& opt,
         const std::string& filename,
         const bam_hdr_t& header);
 
-    static
+    /// route region output appended to the BED text stream osPtr through merger, merger must write to osPtr and
+    /// be destroyed before it
+    void
+    setBedRangeMerge(
+        const std::ostream* osPtr,
+        RegionProcessor& merger);
+
     std::ostream*
     initialize_candidate_indel_file(
         const starling_base_options& opt,
@@ -101,8 +152,15 @@ protected:
                     const bam_hdr_t& header,
                     std::ostream& os);
 
-    std::vector<std::unique_ptr<bam_dumper>> _realign_bam_ptr;
+    std::vector<std::unique_ptr<SortedBamDumper>> _realign_bam_ptr;
 private:
     std::unique_ptr<std::ostream> _candidate_indel_osptr;
     unsigned _sampleCount;
+    bool _isRegionBuffer;
+
+    /// all text streams in creation order, used to transfer region buffer output
+    std::vector<std::ostream*> _textStreams;
+
+    /// optional BED range merger for each text stream, see setBedRangeMerge
+    std::vector<RegionProcessor*> _textStreamBedRangeMerge;
 };
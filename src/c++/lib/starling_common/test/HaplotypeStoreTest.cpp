@@ -0,0 +1,97 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "boost/test/unit_test.hpp"
+
+#include "starling_common/HaplotypeStore.hh"
+
+
+BOOST_AUTO_TEST_SUITE( test_HaplotypeStore )
+
+
+static
+HaplotypeStore::haplotype_id_t
+addSegments(
+    HaplotypeStore& store,
+    const std::vector<std::string>& segments)
+{
+    HaplotypeStore::haplotype_id_t haplotypeId(HaplotypeStore::emptyHaplotypeId);
+    for (const auto& segment : segments)
+    {
+        haplotypeId = store.extend(haplotypeId, segment);
+    }
+    return haplotypeId;
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_HaplotypeStoreIntern )
+{
+    HaplotypeStore store;
+
+    const auto id1(addSegments(store, {"A","C","","GT","T"}));
+    const auto id2(addSegments(store, {"A","C","","GT","T"}));
+    BOOST_REQUIRE_EQUAL(id1, id2);
+
+    // same sequence from a different series of segments:
+    const auto id3(addSegments(store, {"AC","G","","TT"}));
+    BOOST_REQUIRE_EQUAL(id1, id3);
+
+    const auto id4(addSegments(store, {"A","C","G","TA"}));
+    BOOST_REQUIRE_NE(id1, id4);
+
+    std::string seq;
+    store.getSequence(id1, seq);
+    BOOST_REQUIRE_EQUAL(seq, "ACGTT");
+    BOOST_REQUIRE_EQUAL(store.getLength(id1), 5u);
+    store.getSequence(id4, seq);
+    BOOST_REQUIRE_EQUAL(seq, "ACGTA");
+
+    store.getSequence(HaplotypeStore::emptyHaplotypeId, seq);
+    BOOST_REQUIRE(seq.empty());
+
+    // empty, A, AC, ACG, ACGT, ACGTT and ACGTA
+    BOOST_REQUIRE_EQUAL(store.size(), 7u);
+
+    store.clear();
+    BOOST_REQUIRE_EQUAL(store.size(), 1u);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_HaplotypeHashSubstring )
+{
+    const std::string seq("GATTACA");
+    std::vector<uint64_t> prefixHash;
+    HaplotypeHash::getPrefixHashes(seq, prefixHash);
+    std::vector<uint64_t> basePower;
+    HaplotypeHash::getBasePowers(seq.size(), basePower);
+
+    HaplotypeStore store;
+    const auto suffixId(addSegments(store, {"TA","CA"}));
+    const uint64_t suffixHash(prefixHash[7] - (prefixHash[3] * basePower[4]));
+    BOOST_REQUIRE_EQUAL(suffixHash, store.getHash(suffixId));
+
+    const auto prefixId(addSegments(store, {"GAT"}));
+    BOOST_REQUIRE_EQUAL(prefixHash[3], store.getHash(prefixId));
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
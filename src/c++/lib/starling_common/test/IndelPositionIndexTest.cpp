@@ -0,0 +1,192 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "boost/test/unit_test.hpp"
+
+#include "starling_common/IndelPositionIndex.hh"
+
+#include <map>
+#include <random>
+
+
+BOOST_AUTO_TEST_SUITE( test_IndelPositionIndex )
+
+
+typedef IndelPositionIndex<unsigned> TestIndex;
+typedef std::map<IndelKey,unsigned> TestMap;
+
+
+
+static
+IndelKey
+getRandomIndelKey(
+    const pos_t pos,
+    std::mt19937& rng)
+{
+    static const char* insertSequences[] = { "A", "C", "AC", "GTT" };
+    std::uniform_int_distribution<unsigned> variantDist(0,7);
+    const unsigned variantIndex(variantDist(rng));
+    if (variantIndex < 4) return IndelKey(pos, INDEL::INDEL, variantIndex+1);
+    return IndelKey(pos, INDEL::INDEL, 0, insertSequences[variantIndex-4]);
+}
+
+
+
+/// check that iteration of the index from each position matches the equivalent std::map
+static
+void
+checkIndexMatchesMap(
+    const TestIndex& index,
+    const TestMap& expected,
+    const pos_t beginPos,
+    const pos_t endPos)
+{
+    BOOST_REQUIRE_EQUAL(index.size(), expected.size());
+    BOOST_REQUIRE_EQUAL(index.empty(), expected.empty());
+
+    for (pos_t pos(beginPos); pos < endPos; ++pos)
+    {
+        auto indexIter(index.positionLowerBound(pos));
+        auto mapIter(expected.lower_bound(IndelKey(pos)));
+
+        // compare up to the next few indels following pos:
+        for (unsigned stepIndex(0); stepIndex < 4; ++stepIndex)
+        {
+            if (mapIter == expected.end())
+            {
+                BOOST_REQUIRE(indexIter == index.end());
+                break;
+            }
+            BOOST_REQUIRE(indexIter != index.end());
+            BOOST_REQUIRE_EQUAL(indexIter->first, mapIter->first);
+            BOOST_REQUIRE_EQUAL(indexIter->second, mapIter->second);
+            ++indexIter;
+            ++mapIter;
+        }
+    }
+
+    unsigned count(0);
+    auto mapIter(expected.begin());
+    for (const auto& value : index)
+    {
+        BOOST_REQUIRE_EQUAL(value.first, mapIter->first);
+        ++mapIter;
+        ++count;
+    }
+    BOOST_REQUIRE_EQUAL(count, expected.size());
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_IndelPositionIndexInsertFind )
+{
+    TestIndex index;
+    BOOST_REQUIRE(index.empty());
+    BOOST_REQUIRE(index.begin() == index.end());
+    BOOST_REQUIRE(index.positionLowerBound(10) == index.end());
+
+    const IndelKey deletion(10, INDEL::INDEL, 2);
+    const IndelKey insertion(10, INDEL::INDEL, 0, "AC");
+    const IndelKey laterDeletion(12, INDEL::INDEL, 1);
+
+    BOOST_REQUIRE(index.insert(laterDeletion, 3).second);
+    BOOST_REQUIRE(index.insert(deletion, 1).second);
+    BOOST_REQUIRE(index.insert(insertion, 2).second);
+
+    // repeated insertion leaves the existing value:
+    const auto insertResult(index.insert(deletion, 4));
+    BOOST_REQUIRE(not insertResult.second);
+    BOOST_REQUIRE_EQUAL(insertResult.first->second, 1u);
+    BOOST_REQUIRE_EQUAL(index.size(), 3u);
+
+    BOOST_REQUIRE(index.find(IndelKey(11, INDEL::INDEL, 2)) == index.end());
+    BOOST_REQUIRE_EQUAL(index.find(insertion)->second, 2u);
+
+    // iteration follows IndelKey order:
+    auto iter(index.positionLowerBound(9));
+    BOOST_REQUIRE_EQUAL(iter->first, std::min(deletion, insertion));
+    ++iter;
+    BOOST_REQUIRE_EQUAL(iter->first, std::max(deletion, insertion));
+    ++iter;
+    BOOST_REQUIRE_EQUAL(iter->first, laterDeletion);
+    ++iter;
+    BOOST_REQUIRE(iter == index.end());
+    BOOST_REQUIRE(index.positionLowerBound(11)->first == laterDeletion);
+
+    // iterators and values are stable when other indels are inserted:
+    const TestIndex::const_iterator laterIter(index.find(laterDeletion));
+    const unsigned* laterValuePtr(&(laterIter->second));
+    for (pos_t pos(0); pos < 5000; pos += 7)
+    {
+        index.insert(IndelKey(pos, INDEL::INDEL, 1), 0);
+    }
+    BOOST_REQUIRE(laterIter == index.find(laterDeletion));
+    BOOST_REQUIRE_EQUAL(laterValuePtr, &(index.find(laterDeletion)->second));
+
+    index.erasePosition(10);
+    BOOST_REQUIRE(index.find(deletion) == index.end());
+    BOOST_REQUIRE(index.find(laterDeletion) != index.end());
+
+    index.clear();
+    BOOST_REQUIRE(index.empty());
+    BOOST_REQUIRE(index.begin() == index.end());
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_IndelPositionIndexSlidingWindow )
+{
+    // follow the pattern of the indel buffer, where indels are added near a moving head position and
+    // positions are cleared behind it, and occasionally a distant indel extends the stored span:
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<pos_t> offsetDist(0,300);
+    std::uniform_int_distribution<unsigned> distantDist(0,200);
+
+    TestIndex index;
+    TestMap expected;
+    pos_t clearPos(0);
+    unsigned value(0);
+    for (pos_t headPos(500); headPos < 12000; headPos += 3)
+    {
+        for (unsigned indelIndex(0); indelIndex < 2; ++indelIndex)
+        {
+            pos_t pos(headPos - offsetDist(rng));
+            if (distantDist(rng) == 0) pos += 3000;
+            const IndelKey indelKey(getRandomIndelKey(pos, rng));
+            const bool isInserted(expected.insert(std::make_pair(indelKey, value)).second);
+            BOOST_REQUIRE_EQUAL(index.insert(indelKey, value).second, isInserted);
+            value++;
+        }
+
+        for (; clearPos < (headPos - 400); ++clearPos)
+        {
+            index.erasePosition(clearPos);
+            expected.erase(expected.lower_bound(IndelKey(clearPos)), expected.lower_bound(IndelKey(clearPos+1)));
+        }
+
+        if ((headPos % 999) == 0)
+        {
+            checkIndexMatchesMap(index, expected, clearPos-10, headPos+3500);
+        }
+    }
+    checkIndexMatchesMap(index, expected, clearPos-10, 16000);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
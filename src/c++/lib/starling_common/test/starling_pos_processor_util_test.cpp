@@ -34,11 +34,7 @@ BOOST_AUTO_TEST_CASE( test_vcf_to_allele )
     {
         // "chr20 4329513 . ATT AT,A 9114 PASS LEN=1,2;TYPE=del,del GT 2|1"
         vcf_record vr;
-        vr.chrom = "chr20";
-        vr.pos = 4329513;
-        vr.ref = "ATT";
-        vr.alt.push_back("AT");
-        vr.alt.push_back("A");
+        vr.set("chr20\t4329513\t.\tATT\tAT,A\t9114\tPASS\tLEN=1,2;TYPE=del,del\tGT\t2|1");
 
         isConverted = convert_vcfrecord_to_indel_allele(max_indel_size,vr,0,obs);
         IndelKey k0expect(4329513,INDEL::INDEL,1);
@@ -54,12 +50,7 @@ BOOST_AUTO_TEST_CASE( test_vcf_to_allele )
     {
         // "chr20 4329513 . ATT A,ATTT,AG"
         vcf_record vr;
-        vr.chrom = "chr20";
-        vr.pos = 4329513;
-        vr.ref = "ATT";
-        vr.alt.push_back("A");
-        vr.alt.push_back("ATTT");
-        vr.alt.push_back("AG");
+        vr.set("chr20\t4329513\t.\tATT\tA,ATTT,AG");
 
         isConverted = convert_vcfrecord_to_indel_allele(max_indel_size,vr,0,obs);
         IndelKey k0expect(4329513,INDEL::INDEL,2);
@@ -0,0 +1,104 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "boost/test/unit_test.hpp"
+
+#include "starling_read_align_score.hh"
+
+
+BOOST_AUTO_TEST_SUITE( starling_read_align_score )
+
+
+/// minimal indel buffer required to look up breakpoint insert sequences
+struct TestIndelBuffer
+{
+    explicit
+    TestIndelBuffer(
+        const reference_contig_segment& ref)
+    {
+        _opt.is_user_genome_size = true;
+        _opt.user_genome_size = ref.seq().size();
+        _doptPtr.reset(new starling_base_deriv_options(_opt));
+        _indelBufferPtr.reset(new IndelBuffer(_opt, *_doptPtr, ref));
+    }
+
+    const IndelBuffer&
+    getIndelBuffer() const
+    {
+        return *_indelBufferPtr;
+    }
+
+private:
+    starling_base_options _opt;
+    std::unique_ptr<starling_base_deriv_options> _doptPtr;
+    std::unique_ptr<IndelBuffer> _indelBufferPtr;
+};
+
+
+
+static
+std::string
+getExpectedBasesString(
+    const reference_contig_segment& ref,
+    const pos_t pos,
+    const char* cigar,
+    const indel_set_t& indels)
+{
+    candidate_alignment cal;
+    cal.al.pos = pos;
+    cigar_to_apath(cigar, cal.al.path);
+    cal.setIndels(indels);
+
+    const TestIndelBuffer testBuffer(ref);
+    std::vector<uint8_t> expectedBases;
+    get_candidate_alignment_expected_bases(testBuffer.getIndelBuffer(), apath_read_length(cal.al.path), cal, ref,
+                                           expectedBases);
+
+    std::string result;
+    for (const uint8_t expectedBase : expectedBases)
+    {
+        result.push_back((expectedBase == UNSCORED_READ_BASE) ? '-' : get_bam_seq_char(expectedBase));
+    }
+    return result;
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_get_candidate_alignment_expected_bases )
+{
+    reference_contig_segment ref;
+    ref.seq() = "ACGTACGTAC";
+
+    // match only:
+    BOOST_REQUIRE_EQUAL(getExpectedBasesString(ref, 2, "5M", indel_set_t()), "GTACG");
+
+    // soft-clipped read positions are not scored:
+    BOOST_REQUIRE_EQUAL(getExpectedBasesString(ref, 2, "1S3M1S", indel_set_t()), "-GTA-");
+
+    // insertion and deletion:
+    {
+        indel_set_t indels;
+        indels.insert(IndelKey(3, INDEL::INDEL, 0, "TT"));
+        indels.insert(IndelKey(5, INDEL::INDEL, 1));
+        BOOST_REQUIRE_EQUAL(getExpectedBasesString(ref, 1, "2M2I2M1D2M", indels), "CGTTTAGT");
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -22,6 +22,9 @@
 
 #include "starling_read_align.cpp"
 
+#include "htsapi/align_path_bam_util.hh"
+#include "htsapi/bam_util.hh"
+
 
 
 BOOST_AUTO_TEST_SUITE( starling_read_align )
@@ -331,4 +334,124 @@ BOOST_AUTO_TEST_CASE( test_end_pin_start_pos )
 }
 
 
+BOOST_AUTO_TEST_CASE( test_RealignWindowSearchBudget )
+{
+    // search work should only count reads starting within the realignment window of the current position:
+    RealignWindowSearchBudget budget;
+    budget.setPos(100, 50);
+    budget.addSearchSteps(10);
+    budget.setPos(100, 50);
+    budget.addSearchSteps(5);
+    BOOST_REQUIRE_EQUAL(budget.searchSteps, 15u);
+
+    budget.setPos(120, 100);
+    budget.addSearchSteps(7);
+    BOOST_REQUIRE_EQUAL(budget.searchSteps, 22u);
+
+    budget.setPos(150, 101);
+    BOOST_REQUIRE_EQUAL(budget.searchSteps, 7u);
+
+    budget.clear();
+    BOOST_REQUIRE_EQUAL(budget.searchSteps, 0u);
+}
+
+
+
+/// realign one read against a set of candidate deletions
+///
+/// \param[in] windowSearchSteps search work already spent in the realignment window before this read
+static
+void
+realignTestRead(
+    const starling_base_options& opt,
+    const unsigned windowSearchSteps,
+    alignment& realignment,
+    ReadRealignmentStats& realignStats)
+{
+    reference_contig_segment ref;
+    ref.seq() = "GATTACAGCTTGACCGTAGCATCGGATCCTAGGCTTAACGCATGGTCAAGTCCGATGCAT";
+
+    const starling_base_deriv_options dopt(opt);
+    const starling_sample_options sampleOpt(opt);
+
+    const depth_buffer db;
+    IndelBuffer indelBuffer(opt, dopt, ref);
+    const unsigned sampleId(indelBuffer.registerSample(db, db, true));
+    indelBuffer.finalizeSamples();
+
+    // several candidate deletions within the read, so that a full search toggles many indel combinations:
+    for (const pos_t deletionPos : { 15, 20, 25, 30, 35 })
+    {
+        IndelObservation obs;
+        obs.key = IndelKey(deletionPos, INDEL::INDEL, 1);
+        obs.data.is_external_candidate = true;
+        obs.data.iat = INDEL_ALIGN_TYPE::GENOME_TIER1_READ;
+        indelBuffer.addIndelObservation(sampleId, obs);
+    }
+
+    const pos_t readPos(10);
+    const std::string readSeq(ref.seq().substr(readPos, 40));
+    bam_record bamRead;
+    bam1_t& br(*bamRead.get_data());
+    br.core.pos = readPos;
+    br.core.qual = 60;
+    const std::vector<uint8_t> qual(readSeq.size(), 30);
+    edit_bam_read_and_quality(readSeq.c_str(), qual.data(), br);
+    ALIGNPATH::path_t inputPath;
+    cigar_to_apath("40M", inputPath);
+    edit_bam_cigar(inputPath, br);
+
+    starling_read sread(bamRead);
+    alignment al;
+    al.pos = readPos;
+    al.path = inputPath;
+    sread.set_genome_align(al);
+    read_segment& rseg(sread.get_full_segment());
+
+    CandidateAlignmentScoreCache scoreCache;
+    RealignWindowSearchBudget windowBudget;
+    windowBudget.setPos(readPos, 0);
+    windowBudget.addSearchSteps(windowSearchSteps);
+
+    const known_pos_range realignBufferRange(0, ref.seq().size());
+    realign_and_score_read(opt, dopt, sampleOpt, ref, realignBufferRange, sampleId, rseg, indelBuffer,
+                           scoreCache, windowBudget, realignStats);
+    realignment = rseg.realignment;
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_windowSearchBudgetFallback )
+{
+    // a read searched after the window budget is exhausted should get the same result as a search with toggle
+    // depth curtailed to 1:
+    starling_base_options opt;
+    opt.is_user_genome_size = true;
+    opt.user_genome_size = 1000;
+    opt.max_window_realign_search_steps = 100;
+
+    alignment fallbackAlignment;
+    ReadRealignmentStats fallbackStats;
+    realignTestRead(opt, opt.max_window_realign_search_steps, fallbackAlignment, fallbackStats);
+    BOOST_REQUIRE_EQUAL(fallbackStats.windowBudgetExhaustedReads, 1u);
+    BOOST_REQUIRE_EQUAL(fallbackStats.readBudgetExhaustedReads, 0u);
+
+    alignment fullAlignment;
+    ReadRealignmentStats fullStats;
+    realignTestRead(opt, 0, fullAlignment, fullStats);
+    BOOST_REQUIRE_EQUAL(fullStats.windowBudgetExhaustedReads, 0u);
+    BOOST_REQUIRE(fullStats.candidateAlignments > fallbackStats.candidateAlignments);
+
+    starling_base_options toggleOpt(opt);
+    toggleOpt.max_window_realign_search_steps = 0;
+    toggleOpt.max_read_realign_search_steps = 0;
+    toggleOpt.max_read_indel_toggle = 1;
+    alignment toggleAlignment;
+    ReadRealignmentStats toggleStats;
+    realignTestRead(toggleOpt, 0, toggleAlignment, toggleStats);
+    BOOST_REQUIRE_EQUAL(toggleStats.candidateAlignments, fallbackStats.candidateAlignments);
+    BOOST_REQUIRE_EQUAL(toggleAlignment, fallbackAlignment);
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,57 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#include "BasecallQscoreCounts.hh"
+
+#include <cassert>
+#include <cstdint>
+
+
+
+BasecallQscoreCounts::
+BasecallQscoreCounts(const snp_pos_info& pi)
+{
+    static const uint8_t noIndex(MAX_QSCORE);
+    std::array<uint8_t,MAX_QSCORE> qscoreIndex;
+    qscoreIndex.fill(noIndex);
+
+    for (const base_call& bc : pi.calls)
+    {
+        const uint16_t qscore(bc.get_qscore());
+        assert(qscore < MAX_QSCORE);
+        assert(bc.base_id < N_BASE);
+
+        uint8_t& index(qscoreIndex[qscore]);
+        if (index == noIndex)
+        {
+            index = _qscoreCount++;
+            QscoreCounts& counts(_counts[index]);
+            counts.qscore = qscore;
+            counts.baseCount.fill(0);
+            for (auto& strandCount : counts.strandBaseCount)
+            {
+                strandCount.fill(0);
+            }
+        }
+
+        QscoreCounts& counts(_counts[index]);
+        counts.baseCount[bc.base_id]++;
+        counts.strandBaseCount[bc.is_fwd_strand][bc.base_id]++;
+    }
+}
@@ -0,0 +1,73 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#pragma once
+
+#include "blt_common/snp_pos_info.hh"
+
+#include <array>
+
+
+/// counts of the base calls in a pileup for each distinct (qscore, base id) combination
+///
+/// The cached genotype likelihood kernels add a term which depends only on a base call's qscore and base id
+/// (and sometimes strand) for every call in the pileup. With these counts each term can be added once per
+/// distinct combination weighted by its count, so the cost of evaluating many genotype or grid states no
+/// longer grows with pileup depth.
+///
+/// All calls are assumed to have a known base id, as in a cleaned pileup.
+///
+struct BasecallQscoreCounts
+{
+    /// count all calls in pi.calls
+    explicit
+    BasecallQscoreCounts(const snp_pos_info& pi);
+
+    enum { MAX_QSCORE = 64 };
+
+    struct QscoreCounts
+    {
+        uint16_t qscore;
+
+        /// call counts indexed by base id
+        std::array<unsigned,N_BASE> baseCount;
+
+        /// call counts indexed by [is_fwd_strand][base id]
+        std::array<std::array<unsigned,N_BASE>,2> strandBaseCount;
+    };
+
+    typedef const QscoreCounts* const_iterator;
+
+    /// iterate over the distinct qscores observed in the pileup, in order of first observation
+    const_iterator
+    begin() const
+    {
+        return _counts.data();
+    }
+
+    const_iterator
+    end() const
+    {
+        return _counts.data() + _qscoreCount;
+    }
+
+private:
+    unsigned _qscoreCount = 0;
+    std::array<QscoreCounts,MAX_QSCORE> _counts;
+};
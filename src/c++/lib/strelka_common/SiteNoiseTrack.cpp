@@ -0,0 +1,223 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "SiteNoiseTrack.hh"
+
+#include "blt_util/blt_exception.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <sstream>
+
+
+
+static
+void
+siteNoiseTrackError(
+    const std::string& filename,
+    const char* msg)
+{
+    std::ostringstream oss;
+    oss << "ERROR: " << msg << " in site noise track file: '" << filename << "'";
+    throw blt_exception(oss.str().c_str());
+}
+
+
+
+SiteNoiseTrack::
+SiteNoiseTrack(const std::string& filename)
+    : _file(filename)
+{
+    using namespace SiteNoiseTrackFormat;
+
+    if ((_file.size() < sizeof(FileHeader)) or
+        (std::memcmp(_file.data(), magic, sizeof(magic)) != 0))
+    {
+        siteNoiseTrackError(filename, "Unrecognized header");
+    }
+    if (header().byteOrder != byteOrderMark)
+    {
+        siteNoiseTrackError(filename, "Incompatible byte order");
+    }
+    if (header().version != formatVersion)
+    {
+        siteNoiseTrackError(filename, "Unsupported format version");
+    }
+    if (header().indexStride == 0)
+    {
+        siteNoiseTrackError(filename, "Invalid run index stride");
+    }
+
+    const uint64_t fileSize(_file.size());
+    auto isValidSection = [&](const uint64_t offset, const uint64_t count, const uint64_t elementSize)
+    {
+        return ((offset <= fileSize) and (count <= ((fileSize-offset)/elementSize)));
+    };
+
+    const uint32_t contigCount(header().contigCount);
+    const uint64_t contigTableOffset(header().contigTableOffset);
+    if (not isValidSection(contigTableOffset, contigCount, sizeof(ContigRecord)))
+    {
+        siteNoiseTrackError(filename, "Invalid contig table");
+    }
+
+    const ContigRecord* records(reinterpret_cast<const ContigRecord*>(_file.data()+contigTableOffset));
+    for (unsigned contigIndex(0); contigIndex < contigCount; ++contigIndex)
+    {
+        const ContigRecord& record(records[contigIndex]);
+        const uint64_t expectedIndexCount((record.runCount+header().indexStride-1)/header().indexStride);
+        if ((not isValidSection(record.nameOffset, record.nameSize, 1)) or
+            (not isValidSection(record.runOffset, record.runCount, sizeof(NoiseRun))) or
+            (not isValidSection(record.valueOffset, record.valueCount, sizeof(NoiseValue))) or
+            (not isValidSection(record.indexOffset, record.indexCount, sizeof(RunIndexEntry))) or
+            (record.indexCount != expectedIndexCount))
+        {
+            siteNoiseTrackError(filename, "Invalid contig record");
+        }
+
+        _contigs.emplace_back();
+        SiteNoiseTrackContig& contig(_contigs.back());
+        contig.name.assign(_file.data()+record.nameOffset, record.nameSize);
+        contig.runs = reinterpret_cast<const NoiseRun*>(_file.data()+record.runOffset);
+        contig.runCount = record.runCount;
+        contig.values = reinterpret_cast<const NoiseValue*>(_file.data()+record.valueOffset);
+        contig.valueCount = record.valueCount;
+        contig.index = reinterpret_cast<const RunIndexEntry*>(_file.data()+record.indexOffset);
+        contig.indexCount = record.indexCount;
+
+        if (not _contigIndex.insert(std::make_pair(contig.name, contigIndex)).second)
+        {
+            siteNoiseTrackError(filename, "Duplicate contig name");
+        }
+    }
+}
+
+
+
+const SiteNoiseTrackContig*
+SiteNoiseTrack::
+getContig(const std::string& name) const
+{
+    const auto iter(_contigIndex.find(name));
+    if (iter == _contigIndex.end()) return nullptr;
+    return &(_contigs[iter->second]);
+}
+
+
+
+void
+SiteNoiseTrackRegionReader::
+resetRegion(
+    const std::string& chromName,
+    const pos_t beginPos,
+    const pos_t endPos)
+{
+    using namespace SiteNoiseTrackFormat;
+
+    _contigPtr = _track.getContig(chromName);
+    _endPos = endPos;
+    _valueIndex = 0;
+    _valueEnd = 0;
+
+    if ((nullptr == _contigPtr) or (_contigPtr->runCount == 0) or (beginPos >= endPos)) return;
+    const SiteNoiseTrackContig& contig(*_contigPtr);
+
+    // start from the last indexed run which begins at or before beginPos:
+    const RunIndexEntry* indexEnd(contig.index+contig.indexCount);
+    const RunIndexEntry* indexIter(std::upper_bound(contig.index, indexEnd, static_cast<uint64_t>(std::max(beginPos,0)),
+                                                    [](const uint64_t pos, const RunIndexEntry& entry)
+    {
+        return (pos < entry.pos);
+    }));
+    if (indexIter == contig.index)
+    {
+        _runIndex = 0;
+        _valueIndex = 0;
+        _pos = contig.runs[0].skip;
+    }
+    else
+    {
+        --indexIter;
+        _runIndex = (indexIter-contig.index)*_track.header().indexStride;
+        _valueIndex = std::min(indexIter->valueIndex, contig.valueCount);
+        _pos = indexIter->pos;
+    }
+
+    // scan forward to the first run which ends after beginPos:
+    while ((_pos + static_cast<pos_t>(contig.runs[_runIndex].length)) <= beginPos)
+    {
+        _valueIndex += contig.runs[_runIndex].length;
+        _pos += contig.runs[_runIndex].length;
+        _runIndex++;
+        if (_runIndex >= contig.runCount) return;
+        _pos += contig.runs[_runIndex].skip;
+    }
+
+    const uint64_t runValueEnd(_valueIndex+contig.runs[_runIndex].length);
+    if (_pos < beginPos)
+    {
+        _valueIndex += (beginPos-_pos);
+        _pos = beginPos;
+    }
+    setValueRange(runValueEnd);
+}
+
+
+
+void
+SiteNoiseTrackRegionReader::
+setValueRange(const uint64_t runValueEnd)
+{
+    // clipping to the contig value count keeps a corrupt run table from reading outside of the value section:
+    if (_pos >= _endPos)
+    {
+        _valueEnd = _valueIndex;
+    }
+    else
+    {
+        _valueEnd = std::min({runValueEnd, (_valueIndex + (_endPos - _pos)), _contigPtr->valueCount});
+    }
+}
+
+
+
+void
+SiteNoiseTrackRegionReader::
+next(SiteNoise& sn)
+{
+    assert(isNextPos());
+    const SiteNoiseTrackContig& contig(*_contigPtr);
+    const SiteNoiseTrackFormat::NoiseValue& value(contig.values[_valueIndex]);
+    sn.total = value.total;
+    sn.noise = value.noise;
+    sn.noise2 = value.noise2;
+
+    _valueIndex++;
+    _pos++;
+    if (_valueIndex < _valueEnd) return;
+
+    // the current run is finished, or the region end has been reached:
+    if (_pos >= _endPos) return;
+    _runIndex++;
+    if (_runIndex >= contig.runCount) return;
+    _pos += contig.runs[_runIndex].skip;
+    setValueRange(_valueIndex+contig.runs[_runIndex].length);
+}
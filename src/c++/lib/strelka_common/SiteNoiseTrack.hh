@@ -0,0 +1,211 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#pragma once
+
+#include "SiteNoise.hh"
+#include "blt_util/blt_types.hh"
+#include "blt_util/MemoryMappedFile.hh"
+
+#include "boost/utility.hpp"
+
+#include <cstdint>
+
+#include <map>
+#include <string>
+#include <vector>
+
+
+/// Site noise track files hold the per-position SiteNoise values of a noise panel VCF, so that the somatic
+/// caller can read the panel for each analysis region directly from a memory map.
+///
+/// File layout, all integers are in native byte order and all sections are 8 byte aligned:
+///
+/// 1. FileHeader
+/// 2. for each contig: values, runs, run index, name
+/// 3. FileHeader::contigCount ContigRecord entries, starting at FileHeader::contigTableOffset
+///
+/// Each contig is a series of runs, where each run skips a stretch of positions without noise and then covers a
+/// stretch of consecutive positions with one NoiseValue each. The values for all runs are stored in run order.
+/// The run index holds the start position of every FileHeader::indexStride'th run and the offset of its first
+/// value, so that a region can be found without decoding the contig from the beginning.
+///
+namespace SiteNoiseTrackFormat
+{
+
+static const char magic[8] = { 'S', 'T', 'K', 'N', 'O', 'I', 'S', 'E' };
+static const uint32_t formatVersion = 1;
+static const uint32_t byteOrderMark = 0x01020304;
+static const uint32_t defaultIndexStride = 256;
+
+struct FileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t contigCount;
+    uint32_t indexStride;
+    uint64_t contigTableOffset;
+};
+
+struct ContigRecord
+{
+    uint64_t nameOffset;
+    uint64_t nameSize;
+    uint64_t runOffset;
+    uint64_t runCount;
+    uint64_t valueOffset;
+    uint64_t valueCount;
+    uint64_t indexOffset;
+    uint64_t indexCount;
+};
+
+struct NoiseRun
+{
+    /// number of positions without noise preceding this run
+    uint32_t skip;
+
+    /// number of consecutive positions with noise in this run
+    uint32_t length;
+};
+
+struct NoiseValue
+{
+    uint16_t total;
+    uint16_t noise;
+    uint16_t noise2;
+};
+
+struct RunIndexEntry
+{
+    /// position of the first value in the indexed run
+    uint64_t pos;
+
+    /// index of the first value in the indexed run
+    uint64_t valueIndex;
+};
+
+static_assert(sizeof(FileHeader) == 32, "Unexpected site noise track header size");
+static_assert(sizeof(ContigRecord) == 64, "Unexpected site noise track contig record size");
+static_assert(sizeof(NoiseRun) == 8, "Unexpected site noise track run size");
+static_assert(sizeof(NoiseValue) == 6, "Unexpected site noise track value size");
+static_assert(sizeof(RunIndexEntry) == 16, "Unexpected site noise track index entry size");
+}
+
+
+
+/// read-only view of one contig in a site noise track
+struct SiteNoiseTrackContig
+{
+    std::string name;
+    const SiteNoiseTrackFormat::NoiseRun* runs = nullptr;
+    uint64_t runCount = 0;
+    const SiteNoiseTrackFormat::NoiseValue* values = nullptr;
+    uint64_t valueCount = 0;
+    const SiteNoiseTrackFormat::RunIndexEntry* index = nullptr;
+    uint64_t indexCount = 0;
+};
+
+
+
+/// read-only access to a memory mapped site noise track file
+///
+struct SiteNoiseTrack : private boost::noncopyable
+{
+    /// maps the file and checks its layout, throws if this is not a valid site noise track file
+    explicit
+    SiteNoiseTrack(const std::string& filename);
+
+    const SiteNoiseTrackFormat::FileHeader&
+    header() const
+    {
+        return *reinterpret_cast<const SiteNoiseTrackFormat::FileHeader*>(_file.data());
+    }
+
+    const std::string&
+    filename() const
+    {
+        return _file.filename();
+    }
+
+    /// \return nullptr if the contig has no noise in this track
+    const SiteNoiseTrackContig*
+    getContig(const std::string& name) const;
+
+private:
+    MemoryMappedFile _file;
+    std::vector<SiteNoiseTrackContig> _contigs;
+    std::map<std::string,unsigned> _contigIndex;
+};
+
+
+
+/// iterate through the site noise of one region of a site noise track in position order
+///
+struct SiteNoiseTrackRegionReader
+{
+    explicit
+    SiteNoiseTrackRegionReader(const SiteNoiseTrack& track)
+        : _track(track)
+    {}
+
+    /// move the reader to the zero-indexed region [beginPos,endPos) of a contig, a contig which is not in
+    /// the track produces an empty region
+    void
+    resetRegion(
+        const std::string& chromName,
+        const pos_t beginPos,
+        const pos_t endPos);
+
+    /// \return true if the region has more site noise
+    bool
+    isNextPos() const
+    {
+        return (_valueIndex < _valueEnd);
+    }
+
+    /// position of the next site noise in the region, only valid if isNextPos() is true
+    pos_t
+    getNextPos() const
+    {
+        return _pos;
+    }
+
+    /// get the next site noise in the region and advance the reader
+    void
+    next(SiteNoise& sn);
+
+private:
+    /// set the value range from the current value to runValueEnd, clipped to the region end
+    void
+    setValueRange(const uint64_t runValueEnd);
+
+    const SiteNoiseTrack& _track;
+    const SiteNoiseTrackContig* _contigPtr = nullptr;
+    pos_t _endPos = 0;
+
+    /// position of value _valueIndex
+    pos_t _pos = 0;
+    uint64_t _runIndex = 0;
+    uint64_t _valueIndex = 0;
+
+    /// end of the values in the current run, equal to _valueIndex once the region is exhausted
+    uint64_t _valueEnd = 0;
+};
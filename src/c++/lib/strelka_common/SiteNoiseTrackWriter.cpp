@@ -0,0 +1,216 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "SiteNoiseTrackWriter.hh"
+
+#include "blt_util/blt_exception.hh"
+
+#include <cassert>
+#include <cstring>
+#include <limits>
+#include <sstream>
+
+
+
+SiteNoiseTrackWriter::
+SiteNoiseTrackWriter(
+    const std::string& filename,
+    const uint32_t indexStride)
+    : _filename(filename),
+      _ofs(filename, std::ios::binary)
+{
+    using namespace SiteNoiseTrackFormat;
+
+    assert(indexStride > 0);
+
+    if (! _ofs)
+    {
+        std::ostringstream oss;
+        oss << "ERROR: Can't open site noise track output file: '" << filename << "'";
+        throw blt_exception(oss.str().c_str());
+    }
+
+    std::memset(&_header, 0, sizeof(_header));
+    std::memcpy(_header.magic, magic, sizeof(magic));
+    _header.version = formatVersion;
+    _header.byteOrder = byteOrderMark;
+    _header.indexStride = indexStride;
+
+    // the header is written again with the contig table offset once the output is complete:
+    _ofs.write(reinterpret_cast<const char*>(&_header), sizeof(_header));
+    _offset = sizeof(_header);
+}
+
+
+
+void
+SiteNoiseTrackWriter::
+addSiteNoise(
+    const std::string& chromName,
+    const pos_t pos,
+    const SiteNoise& sn)
+{
+    using namespace SiteNoiseTrackFormat;
+
+    assert(not _isFinalized);
+    assert(pos >= 0);
+
+    if ((not _isContig) or (chromName != _contigNames.back()))
+    {
+        if (_isContig) finishContig();
+        startContig(chromName);
+    }
+
+    if (pos <= _lastPos)
+    {
+        std::ostringstream oss;
+        oss << "ERROR: Site noise positions are not sorted at " << chromName << ":" << (pos+1)
+            << " when writing site noise track file: '" << _filename << "'";
+        throw blt_exception(oss.str().c_str());
+    }
+
+    if (sn.total == 0) return;
+
+    const bool isNewRun(_runs.empty() or (pos != (_lastPos+1)) or
+                        (_runs.back().length == std::numeric_limits<uint32_t>::max()));
+    if (isNewRun)
+    {
+        if ((_runs.size() % _header.indexStride) == 0)
+        {
+            _index.push_back({static_cast<uint64_t>(pos), _valueCount});
+        }
+        const pos_t skipStart(_runs.empty() ? 0 : (_lastPos+1));
+        _runs.push_back({static_cast<uint32_t>(pos-skipStart), 0});
+    }
+    _runs.back().length++;
+
+    const NoiseValue value = { sn.total, sn.noise, sn.noise2 };
+    _ofs.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    _offset += sizeof(value);
+    _valueCount++;
+    _lastPos = pos;
+}
+
+
+
+void
+SiteNoiseTrackWriter::
+finalize()
+{
+    assert(not _isFinalized);
+    if (_isContig) finishContig();
+
+    alignOutput();
+    _header.contigCount = _records.size();
+    _header.contigTableOffset = _offset;
+    _ofs.write(reinterpret_cast<const char*>(_records.data()), _records.size()*sizeof(_records[0]));
+
+    _ofs.seekp(0);
+    _ofs.write(reinterpret_cast<const char*>(&_header), sizeof(_header));
+    _ofs.close();
+    checkOutput();
+    _isFinalized = true;
+}
+
+
+
+void
+SiteNoiseTrackWriter::
+startContig(const std::string& chromName)
+{
+    if (_finishedContigNames.count(chromName))
+    {
+        std::ostringstream oss;
+        oss << "ERROR: Site noise for contig '" << chromName << "' is not contiguous"
+            << " when writing site noise track file: '" << _filename << "'";
+        throw blt_exception(oss.str().c_str());
+    }
+
+    alignOutput();
+    _contigNames.push_back(chromName);
+    _records.emplace_back();
+    SiteNoiseTrackFormat::ContigRecord& record(_records.back());
+    std::memset(&record, 0, sizeof(record));
+    record.valueOffset = _offset;
+
+    _isContig = true;
+    _lastPos = -1;
+    _valueCount = 0;
+    _runs.clear();
+    _index.clear();
+}
+
+
+
+void
+SiteNoiseTrackWriter::
+finishContig()
+{
+    assert(_isContig);
+    SiteNoiseTrackFormat::ContigRecord& record(_records.back());
+    const std::string& chromName(_contigNames.back());
+    record.valueCount = _valueCount;
+
+    auto writeSection = [&](const void* data, const uint64_t size)
+    {
+        alignOutput();
+        const uint64_t sectionOffset(_offset);
+        _ofs.write(static_cast<const char*>(data), size);
+        _offset += size;
+        return sectionOffset;
+    };
+
+    record.runOffset = writeSection(_runs.data(), _runs.size()*sizeof(_runs[0]));
+    record.runCount = _runs.size();
+    record.indexOffset = writeSection(_index.data(), _index.size()*sizeof(_index[0]));
+    record.indexCount = _index.size();
+    record.nameOffset = writeSection(chromName.c_str(), chromName.size());
+    record.nameSize = chromName.size();
+
+    checkOutput();
+    _finishedContigNames.insert(chromName);
+    _isContig = false;
+}
+
+
+
+void
+SiteNoiseTrackWriter::
+alignOutput()
+{
+    static const char zeros[8] = {};
+    const uint64_t alignedOffset((_offset + 7) & ~static_cast<uint64_t>(7));
+    _ofs.write(zeros, alignedOffset-_offset);
+    _offset = alignedOffset;
+}
+
+
+
+void
+SiteNoiseTrackWriter::
+checkOutput() const
+{
+    if (! _ofs)
+    {
+        std::ostringstream oss;
+        oss << "ERROR: Failed to write site noise track output file: '" << _filename << "'";
+        throw blt_exception(oss.str().c_str());
+    }
+}
@@ -0,0 +1,89 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#pragma once
+
+#include "SiteNoiseTrack.hh"
+
+#include "boost/utility.hpp"
+
+#include <fstream>
+#include <set>
+#include <string>
+#include <vector>
+
+
+/// write a site noise track file from site noise supplied in contig and position order
+///
+/// See SiteNoiseTrack.hh for the output format. Values are written as they are added, so only the run
+/// table and index of the current contig are held in memory.
+///
+struct SiteNoiseTrackWriter : private boost::noncopyable
+{
+    explicit
+    SiteNoiseTrackWriter(
+        const std::string& filename,
+        const uint32_t indexStride = SiteNoiseTrackFormat::defaultIndexStride);
+
+    /// add site noise for one zero-indexed position
+    ///
+    /// positions must increase within each contig and all positions of a contig must be added together,
+    /// sites with zero total are skipped because they are equivalent to sites missing from the track
+    void
+    addSiteNoise(
+        const std::string& chromName,
+        const pos_t pos,
+        const SiteNoise& sn);
+
+    /// complete the output file, no site noise can be added after this call
+    void
+    finalize();
+
+private:
+    void
+    startContig(const std::string& chromName);
+
+    void
+    finishContig();
+
+    /// pad the output file to the next section boundary
+    void
+    alignOutput();
+
+    void
+    checkOutput() const;
+
+    std::string _filename;
+    std::ofstream _ofs;
+    uint64_t _offset = 0;
+    bool _isFinalized = false;
+
+    SiteNoiseTrackFormat::FileHeader _header;
+    std::vector<SiteNoiseTrackFormat::ContigRecord> _records;
+    std::vector<std::string> _contigNames;
+    std::set<std::string> _finishedContigNames;
+
+    // current contig state:
+    bool _isContig = false;
+    pos_t _lastPos = -1;
+    uint64_t _valueCount = 0;
+    std::vector<SiteNoiseTrackFormat::NoiseRun> _runs;
+    std::vector<SiteNoiseTrackFormat::RunIndexEntry> _index;
+};
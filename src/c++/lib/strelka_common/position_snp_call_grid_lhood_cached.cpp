@@ -22,6 +22,7 @@
 ///
 
 #include "position_snp_call_grid_lhood_cached.hh"
+#include "BasecallQscoreCounts.hh"
 
 #include "blt_util/digt.hh"
 #include "blt_util/math_util.hh"
@@ -43,7 +44,7 @@ static const blt_float_t ln_one_half(std::log(one_half));
 static
 void
 get_high_low_het_ratio_lhood_cached(
-    const snp_pos_info& pi,
+    const BasecallQscoreCounts& counts,
     const blt_float_t het_ratio,
     const unsigned het_ratio_index,
     het_ratio_cache<3>& hrcache,
@@ -52,37 +53,34 @@ get_high_low_het_ratio_lhood_cached(
 {
     const blt_float_t chet_ratio(1.-het_ratio);
 
-    const unsigned n_calls(pi.calls.size());
-
-    //    cache_val cv;
     static const uint8_t remap[3] = {0,2,1};
 
-    for (unsigned i(0); i<n_calls; ++i)
+    for (const auto& qcounts : counts)
     {
-        const base_call& bc(pi.calls[i]);
-
-        std::pair<bool,cache_val<3>*> ret(hrcache.get_val(bc.get_qscore(),het_ratio_index));
+        std::pair<bool,cache_val<3>*> ret(hrcache.get_val(qcounts.qscore,het_ratio_index));
         cache_val<3>& cv(*ret.second);
         if (! ret.first)
         {
-            const blt_float_t eprob(bc.error_prob());
+            const blt_float_t eprob(qphred_to_error_prob(qcounts.qscore));
             const blt_float_t ceprob(1-eprob);
-            //const blt_float_t lne(bc.ln_error_prob());
-            //const blt_float_t lnce(bc.ln_comp_error_prob());
 
             // precalculate the result for expect values of 0.0, het_ratio, chet_ratio, 1.0
-            cv.val[0] = bc.ln_error_prob()+ln_one_third;
+            cv.val[0] = qphred_to_ln_error_prob(qcounts.qscore)+ln_one_third;
             cv.val[1] = std::log((ceprob)*het_ratio+((eprob)*one_third)*chet_ratio);
             cv.val[2] = std::log((ceprob)*chet_ratio+((eprob)*one_third)*het_ratio);
         }
 
-        const uint8_t obs_id(bc.base_id);
-
-        for (unsigned gt(N_BASE); gt<DIGT::SIZE; ++gt)
+        for (unsigned obs_id(0); obs_id<N_BASE; ++obs_id)
         {
-            const unsigned key(DIGT::expect2_bias(obs_id,gt));
-            lhood_high[gt] += cv.val[key];
-            lhood_low[gt] += cv.val[remap[key]];
+            const unsigned count(qcounts.baseCount[obs_id]);
+            if (count == 0) continue;
+
+            for (unsigned gt(N_BASE); gt<DIGT::SIZE; ++gt)
+            {
+                const unsigned key(DIGT::expect2_bias(obs_id,gt));
+                lhood_high[gt] += count*cv.val[key];
+                lhood_low[gt] += count*cv.val[remap[key]];
+            }
         }
     }
 }
@@ -94,7 +92,7 @@ get_high_low_het_ratio_lhood_cached(
 static
 void
 increment_het_ratio_lhood_cached(
-    const snp_pos_info& pi,
+    const BasecallQscoreCounts& counts,
     const blt_float_t het_ratio,
     const unsigned het_ratio_index,
     het_ratio_cache<3>& hrcache,
@@ -115,7 +113,7 @@ increment_het_ratio_lhood_cached(
         lhood_high[gt] = 0.;
         lhood_low[gt] = 0.;
     }
-    get_high_low_het_ratio_lhood_cached(pi,het_ratio,het_ratio_index,hrcache,lhood_high,lhood_low);
+    get_high_low_het_ratio_lhood_cached(counts,het_ratio,het_ratio_index,hrcache,lhood_high,lhood_low);
 
     for (unsigned gt(0); gt<DIGT::SIZE; ++gt)
     {
@@ -135,22 +133,22 @@ get_diploid_gt_lhood_cached(
     const blt_float_t het_bias,
     blt_float_t* const lhood)
 {
-    // ! not thread-safe !
-    static het_ratio_cache<3> hrcache;
+    static thread_local het_ratio_cache<3> hrcache;
 
     // get likelihood of each genotype
     for (unsigned gt(0); gt<DIGT::SIZE; ++gt) lhood[gt] = 0.;
 
-    for (const base_call& bc : pi.calls)
+    const BasecallQscoreCounts counts(pi);
+    for (const auto& qcounts : counts)
     {
-        std::pair<bool,cache_val<3>*> ret(hrcache.get_val(bc.get_qscore(),0));
+        std::pair<bool,cache_val<3>*> ret(hrcache.get_val(qcounts.qscore,0));
         cache_val<3>& cv(*ret.second);
         if (! ret.first)
         {
-            const blt_float_t eprob(bc.error_prob());
+            const blt_float_t eprob(qphred_to_error_prob(qcounts.qscore));
             const blt_float_t ceprob(1-eprob);
-            const blt_float_t lne(bc.ln_error_prob());
-            const blt_float_t lnce(bc.ln_comp_error_prob());
+            const blt_float_t lne(qphred_to_ln_error_prob(qcounts.qscore));
+            const blt_float_t lnce(qphred_to_ln_comp_error_prob(qcounts.qscore));
 
             // precalculate the result for expect values of 0.0, 0.5 & 1.0
             cv.val[0] = lne+ln_one_third;
@@ -158,10 +156,15 @@ get_diploid_gt_lhood_cached(
             cv.val[2] = lnce;
         }
 
-        const uint8_t obs_id(bc.base_id);
-        for (unsigned gt(0); gt<DIGT::SIZE; ++gt)
+        for (unsigned obs_id(0); obs_id<N_BASE; ++obs_id)
         {
-            lhood[gt] += cv.val[DIGT::expect2(obs_id,gt)];
+            const unsigned count(qcounts.baseCount[obs_id]);
+            if (count == 0) continue;
+
+            for (unsigned gt(0); gt<DIGT::SIZE; ++gt)
+            {
+                lhood[gt] += count*cv.val[DIGT::expect2(obs_id,gt)];
+            }
         }
     }
 
@@ -172,8 +175,7 @@ get_diploid_gt_lhood_cached(
     //
     if (is_het_bias)
     {
-        // ! not thread-safe !
-        static het_ratio_cache<3> hrcache_bias;
+        static thread_local het_ratio_cache<3> hrcache_bias;
 
         // loop is currently setup to assume a uniform het ratio subgenotype prior
         const unsigned n_bias_steps(1+static_cast<unsigned>(het_bias/opt.het_bias_max_ratio_inc));
@@ -181,7 +183,7 @@ get_diploid_gt_lhood_cached(
         for (unsigned i(0); i<n_bias_steps; ++i)
         {
             const blt_float_t het_ratio(0.5+(i+1)*ratio_increment);
-            increment_het_ratio_lhood_cached(pi,het_ratio,i,hrcache_bias,lhood);
+            increment_het_ratio_lhood_cached(counts,het_ratio,i,hrcache_bias,lhood);
         }
 
         const unsigned n_het_subgt(1+2*n_bias_steps);
@@ -206,8 +208,7 @@ get_diploid_het_grid_lhood_cached(
     const unsigned hetResolution,
     blt_float_t* const lhood)
 {
-    // ! not thread-safe !
-    static het_ratio_cache<3> hrcache;
+    static thread_local het_ratio_cache<3> hrcache;
 
     // get likelihood of each genotype
     const unsigned totalHetRatios(hetResolution*2);
@@ -215,11 +216,13 @@ get_diploid_het_grid_lhood_cached(
 
     blt_float_t* lhood_off=lhood-N_BASE;
 
+    const BasecallQscoreCounts counts(pi);
+
     const blt_float_t ratio_increment(0.5/static_cast<blt_float_t>(hetResolution+1));
     for (unsigned hetIndex(0); hetIndex<hetResolution; ++hetIndex)
     {
         const blt_float_t het_ratio((hetIndex+1)*ratio_increment);
-        get_high_low_het_ratio_lhood_cached(pi,het_ratio,hetIndex,hrcache,
+        get_high_low_het_ratio_lhood_cached(counts,het_ratio,hetIndex,hrcache,
                                             lhood_off+(hetIndex*DIGT::HET_SIZE),
                                             lhood_off+((totalHetRatios-(hetIndex+1))*DIGT::HET_SIZE));
     }
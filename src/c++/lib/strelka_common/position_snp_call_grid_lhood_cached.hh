@@ -38,6 +38,11 @@
 /// note lhood is expected to follow the standard genotype order defined
 /// in blt_util/digt.hh
 ///
+/// base calls are grouped by qscore and base before their cached terms
+/// are accumulated, so the cost of this function is nearly independent
+/// of depth. Relative to a sum over each base call, the result differs
+/// only by float rounding (relative error below 1e-5).
+///
 void
 get_diploid_gt_lhood_cached(
     const blt_options& opt,
@@ -63,6 +68,8 @@ get_diploid_gt_lhood_cached(
 ///
 /// lhood ordering follows (undocumented) strelka conventions
 ///
+/// base calls are grouped by qscore and base as described for get_diploid_gt_lhood_cached
+///
 /// \param hetresolution how many intermediates between 0-0.5 should we sample per half-axis?
 void
 get_diploid_het_grid_lhood_cached(
@@ -0,0 +1,166 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#include "boost/test/unit_test.hpp"
+
+#include "SiteNoiseTrack.hh"
+#include "SiteNoiseTrackWriter.hh"
+
+#include "blt_util/blt_exception.hh"
+#include "blt_util/test/TestTempPath.hh"
+
+#include <fstream>
+#include <map>
+
+
+BOOST_AUTO_TEST_SUITE( SiteNoiseTrack_test )
+
+
+typedef std::map<pos_t,SiteNoise> noise_map_t;
+
+
+static
+SiteNoise
+getSiteNoise(const pos_t pos)
+{
+    SiteNoise sn;
+    sn.total = 10;
+    sn.noise = (pos % 7);
+    sn.noise2 = (pos % 3);
+    return sn;
+}
+
+
+
+static
+noise_map_t
+readRegion(
+    const SiteNoiseTrack& track,
+    const std::string& chromName,
+    const pos_t beginPos,
+    const pos_t endPos)
+{
+    SiteNoiseTrackRegionReader reader(track);
+    reader.resetRegion(chromName, beginPos, endPos);
+
+    noise_map_t noise;
+    SiteNoise sn;
+    while (reader.isNextPos())
+    {
+        const pos_t pos(reader.getNextPos());
+        reader.next(sn);
+        noise[pos] = sn;
+    }
+    return noise;
+}
+
+
+
+static
+void
+checkRegion(
+    const noise_map_t& expectedNoise,
+    const noise_map_t& noise,
+    const pos_t beginPos,
+    const pos_t endPos)
+{
+    auto expectedIter(expectedNoise.lower_bound(beginPos));
+    const auto expectedEnd(expectedNoise.lower_bound(endPos));
+    BOOST_REQUIRE_EQUAL(noise.size(), std::distance(expectedIter, expectedEnd));
+    for (const auto& value : noise)
+    {
+        BOOST_REQUIRE_EQUAL(value.first, expectedIter->first);
+        BOOST_REQUIRE_EQUAL(value.second.total, expectedIter->second.total);
+        BOOST_REQUIRE_EQUAL(value.second.noise, expectedIter->second.noise);
+        BOOST_REQUIRE_EQUAL(value.second.noise2, expectedIter->second.noise2);
+        ++expectedIter;
+    }
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_SiteNoiseTrackRoundTrip )
+{
+    // runs of various lengths separated by gaps, including sites without noise:
+    noise_map_t chrANoise;
+    for (pos_t pos(3); pos < 200; ++pos)
+    {
+        if (((pos/5) % 3) == 1) continue;
+        chrANoise[pos] = getSiteNoise(pos);
+    }
+    chrANoise[1000] = getSiteNoise(1000);
+
+    const TestTempPath trackFile(".snoise");
+    {
+        // a short index stride exercises region lookups which start from the run index:
+        static const uint32_t indexStride(2);
+        SiteNoiseTrackWriter writer(trackFile.path, indexStride);
+        for (const auto& value : chrANoise)
+        {
+            writer.addSiteNoise("chrA", value.first, value.second);
+        }
+
+        // sites without noise are not stored:
+        writer.addSiteNoise("chrB", 5, SiteNoise());
+        writer.addSiteNoise("chrC", 0, getSiteNoise(0));
+        writer.finalize();
+    }
+
+    const SiteNoiseTrack track(trackFile.path);
+    BOOST_REQUIRE_EQUAL(track.header().contigCount, 3u);
+
+    const pos_t regions[][2] = { {0, 2000}, {0, 3}, {0, 4}, {3, 4}, {9, 10}, {10, 11}, {11, 47}, {47, 999},
+        {150, 1000}, {199, 1001}, {1001, 2000}
+    };
+    for (const auto& region : regions)
+    {
+        checkRegion(chrANoise, readRegion(track, "chrA", region[0], region[1]), region[0], region[1]);
+    }
+
+    BOOST_REQUIRE(readRegion(track, "chrB", 0, 100).empty());
+    BOOST_REQUIRE_EQUAL(readRegion(track, "chrC", 0, 100).size(), 1u);
+    BOOST_REQUIRE(readRegion(track, "chrD", 0, 100).empty());
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_SiteNoiseTrackWriterOrder )
+{
+    const TestTempPath trackFile(".snoise");
+    SiteNoiseTrackWriter writer(trackFile.path);
+    writer.addSiteNoise("chrA", 10, getSiteNoise(10));
+    BOOST_REQUIRE_THROW(writer.addSiteNoise("chrA", 10, getSiteNoise(10)), blt_exception);
+
+    writer.addSiteNoise("chrB", 10, getSiteNoise(10));
+    BOOST_REQUIRE_THROW(writer.addSiteNoise("chrA", 20, getSiteNoise(20)), blt_exception);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_SiteNoiseTrackInvalidFile )
+{
+    const TestTempPath trackFile(".snoise");
+    {
+        std::ofstream ofs(trackFile.path);
+        ofs << "not a site noise track";
+    }
+    BOOST_REQUIRE_THROW(SiteNoiseTrack track(trackFile.path), blt_exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,198 @@
+// -*- mode: c++; indent-tabs-mode: nil; -*-
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2016 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+#include "boost/test/unit_test.hpp"
+
+#include "position_snp_call_grid_lhood_cached.hh"
+
+#include "blt_util/digt.hh"
+#include "blt_util/math_util.hh"
+
+#include <cmath>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+
+BOOST_AUTO_TEST_SUITE( position_snp_call_grid_lhood_cached )
+
+
+// the cached kernels add each qscore's likelihood terms once per distinct (qscore,base) pair weighted by call
+// count, so they are expected to match a per-call sum to within float rounding:
+static const double lhoodTolerance(1e-5);
+
+
+/// simulate a pileup with a reference base of 0, a het alt base of 1 and random errors
+static
+void
+getSimulatedPileup(
+    const unsigned depth,
+    std::mt19937& rng,
+    snp_pos_info& pi)
+{
+    std::uniform_int_distribution<unsigned> qscoreDist(2,40);
+    std::uniform_int_distribution<unsigned> baseDist(0,N_BASE-1);
+    std::uniform_real_distribution<double> fracDist(0,1);
+
+    pi.clear();
+    pi.set_ref_base(id_to_base(0));
+    for (unsigned callIndex(0); callIndex < depth; ++callIndex)
+    {
+        const unsigned qscore(qscoreDist(rng));
+        unsigned baseId((fracDist(rng) < 0.3) ? 1 : 0);
+        if (fracDist(rng) < qphred_to_error_prob(qscore)) baseId = baseDist(rng);
+        const bool isFwdStrand(fracDist(rng) < 0.5);
+        pi.calls.push_back(base_call(baseId,qscore,isFwdStrand,0,0,false,false,false,false,false));
+    }
+}
+
+
+
+/// straightforward per-call versions of the het ratio terms used by the cached likelihood kernels:
+static
+void
+getHetRatioTerms(
+    const base_call& bc,
+    const blt_float_t het_ratio,
+    blt_float_t* vals)
+{
+    static const blt_float_t one_third(1./3.);
+    const blt_float_t chet_ratio(1.-het_ratio);
+    const blt_float_t eprob(bc.error_prob());
+    const blt_float_t ceprob(1-eprob);
+    vals[0] = bc.ln_error_prob()+std::log(one_third);
+    vals[1] = std::log((ceprob)*het_ratio+((eprob)*one_third)*chet_ratio);
+    vals[2] = std::log((ceprob)*chet_ratio+((eprob)*one_third)*het_ratio);
+}
+
+
+
+static
+void
+getExpectedDiploidLhood(
+    const snp_pos_info& pi,
+    blt_float_t* lhood)
+{
+    static const blt_float_t one_third(1./3.);
+    std::fill(lhood,lhood+DIGT::SIZE,0);
+    for (const base_call& bc : pi.calls)
+    {
+        const blt_float_t eprob(bc.error_prob());
+        const blt_float_t vals[3] = { static_cast<blt_float_t>(bc.ln_error_prob()+std::log(one_third)),
+                                      static_cast<blt_float_t>(std::log((1-eprob)+(eprob*one_third))+std::log(0.5)),
+                                      static_cast<blt_float_t>(bc.ln_comp_error_prob())
+                                    };
+        for (unsigned gt(0); gt<DIGT::SIZE; ++gt)
+        {
+            lhood[gt] += vals[DIGT::expect2(bc.base_id,gt)];
+        }
+    }
+}
+
+
+
+static
+void
+getExpectedHetGridLhood(
+    const snp_pos_info& pi,
+    const unsigned hetResolution,
+    blt_float_t* lhood)
+{
+    static const uint8_t remap[3] = {0,2,1};
+    const unsigned totalHetRatios(hetResolution*2);
+    std::fill(lhood,lhood+(totalHetRatios*DIGT::HET_SIZE),0);
+
+    const blt_float_t ratio_increment(0.5/static_cast<blt_float_t>(hetResolution+1));
+    for (unsigned hetIndex(0); hetIndex<hetResolution; ++hetIndex)
+    {
+        blt_float_t* lhood_high(lhood+(hetIndex*DIGT::HET_SIZE));
+        blt_float_t* lhood_low(lhood+((totalHetRatios-(hetIndex+1))*DIGT::HET_SIZE));
+        for (const base_call& bc : pi.calls)
+        {
+            blt_float_t vals[3];
+            getHetRatioTerms(bc,(hetIndex+1)*ratio_increment,vals);
+            for (unsigned gt(N_BASE); gt<DIGT::SIZE; ++gt)
+            {
+                const unsigned key(DIGT::expect2_bias(bc.base_id,gt));
+                lhood_high[gt-N_BASE] += vals[key];
+                lhood_low[gt-N_BASE] += vals[remap[key]];
+            }
+        }
+    }
+}
+
+
+
+static
+void
+checkLhoods(
+    const blt_float_t* lhood,
+    const blt_float_t* expectLhood,
+    const unsigned size)
+{
+    for (unsigned index(0); index<size; ++index)
+    {
+        const double scale(std::max(1.,std::abs(static_cast<double>(expectLhood[index]))));
+        BOOST_REQUIRE_SMALL((lhood[index]-expectLhood[index])/scale, lhoodTolerance);
+    }
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_diploid_gt_lhood_cached )
+{
+    blt_options opt;
+    std::mt19937 rng(1);
+    snp_pos_info pi;
+    for (const unsigned depth : { 0, 1, 7, 50, 400, 3000 })
+    {
+        getSimulatedPileup(depth, rng, pi);
+
+        blt_float_t lhood[DIGT::SIZE];
+        blt_float_t expectLhood[DIGT::SIZE];
+        get_diploid_gt_lhood_cached(opt, pi, lhood);
+        getExpectedDiploidLhood(pi, expectLhood);
+        checkLhoods(lhood, expectLhood, DIGT::SIZE);
+    }
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_diploid_het_grid_lhood_cached )
+{
+    static const unsigned hetResolution(4);
+    static const unsigned lhoodSize(hetResolution*2*DIGT::HET_SIZE);
+
+    std::mt19937 rng(2);
+    snp_pos_info pi;
+    for (const unsigned depth : { 0, 1, 7, 50, 400, 3000 })
+    {
+        getSimulatedPileup(depth, rng, pi);
+
+        blt_float_t lhood[lhoodSize];
+        blt_float_t expectLhood[lhoodSize];
+        get_diploid_het_grid_lhood_cached(pi, hetResolution, lhood);
+        getExpectedHetGridLhood(pi, hetResolution, expectLhood);
+        checkLhoods(lhood, expectLhood, lhoodSize);
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -68,6 +68,9 @@ You must specify an alignment file (BAM or CRAM) for each sample of a matched tu
                          help="Provide a custom EVS model file for somatic Indels (default: %default)")
         group.add_option("--noiseVcf", type="string",dest="noiseVcfList",metavar="FILE", action="append",
                          help="Noise vcf file (submit argument multiple times for more than one file)")
+        group.add_option("--noiseTrack", type="string",dest="noiseTrack",metavar="FILE",
+                         help="Noise panel in the binary site noise track format created by PackNoisePanel, "
+                              "this can be used in place of --noiseVcf")
 
         StrelkaSharedWorkflowOptionsBase.addExtendedGroupOptions(self,group)
 
@@ -85,7 +88,8 @@ You must specify an alignment file (BAM or CRAM) for each sample of a matched tu
             'somaticSnvScoringModelFile' : joinFile(configDir,'somaticVariantScoringModels.json'),
             'somaticIndelScoringModelFile' : None, #joinFile(configDir,'somaticVariantScoringModels.json'),
             'isOutputCallableRegions' : False,
-            'noiseVcfList' : None
+            'noiseVcfList' : None,
+            'noiseTrack' : None
             })
         return defaults
 
@@ -98,6 +102,7 @@ You must specify an alignment file (BAM or CRAM) for each sample of a matched tu
         groomBamList(options.tumorBamList, "tumor sample")
 
         checkFixTabixListOption(options.noiseVcfList,"noise vcf")
+        options.noiseTrack=validateFixExistingFileArg(options.noiseTrack,"Noise track")
 
         options.somaticSnvScoringModelFile=validateFixExistingFileArg(options.somaticSnvScoringModelFile,"Somatic SNV empirical scoring file")
         options.somaticIndelScoringModelFile=validateFixExistingFileArg(options.somaticIndelScoringModelFile,"Somatic indel empirical scoring file")
@@ -113,6 +118,9 @@ You must specify an alignment file (BAM or CRAM) for each sample of a matched tu
 
         checkRequired(options.tumorBamList,"tumor")
 
+        if (options.noiseVcfList is not None) and (options.noiseTrack is not None) :
+            raise OptParseException("Noise panel can be provided with --noiseVcf or --noiseTrack but not both")
+
         bcheck = BamSetChecker()
 
         def singleAppender(bamList,label):
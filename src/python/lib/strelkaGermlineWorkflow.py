@@ -37,7 +37,7 @@ from configBuildTimeInfo import workflowVersion
 from configureUtil import safeSetBool, joinFile
 from pyflow import WorkflowRunner
 from sharedWorkflow import getMkdirCmd, getRmdirCmd, runDepthFromAlignments
-from strelkaSharedWorkflow import runCount, SharedPathInfo, \
+from strelkaSharedWorkflow import runCount, runGenomeSegments, ScoringModelFiles, SharedPathInfo, \
                            StrelkaSharedCallWorkflow, StrelkaSharedWorkflow
 from workflowUtil import ensureDir, preJoin, \
                          getGenomeSegmentGroups, bamListCatCmd
@@ -87,12 +87,12 @@ def runIndelModel(self,taskPrefix="",dependencies=None) :
 class TempSegmentFilesPerSample :
     def __init__(self) :
         self.gvcf = []
+        self.bamRealign = []
 
 
 class TempSegmentFiles :
     def __init__(self, sampleCount) :
         self.variants = []
-        self.bamRealign = []
         self.stats = []
         self.sample = [TempSegmentFilesPerSample() for _ in range(sampleCount)]
 
@@ -106,7 +106,7 @@ def gvcfSampleLabel(sampleIndex) :
     return "gVCF_S%i" % (sampleIndex+1)
 
 
-def callGenomeSegment(self, gsegGroup, segFiles, taskPrefix="", dependencies=None) :
+def callGenomeSegment(self, gsegGroup, segFiles, scoringModels, packedRef, taskPrefix="", dependencies=None) :
 
     assert(len(gsegGroup) != 0)
     gid=gsegGroup[0].id
@@ -121,11 +121,14 @@ def callGenomeSegment(self, gsegGroup, segFiles, taskPrefix="", dependencies=Non
 
     segCmd.extend(["-min-mapping-quality",self.params.minMapq])
     segCmd.extend(["--ref", self.params.referenceFasta ])
+    if packedRef is not None :
+        segCmd.extend(["--packed-ref", packedRef ])
     segCmd.extend(["-max-window-mismatch", "2", "20" ])
     segCmd.extend(["-genome-size", str(self.params.knownSize)] )
     segCmd.extend(["-max-indel-size", "50"] )
 
     segCmd.extend(["--gvcf-output-prefix", self.paths.getTmpSegmentGvcfPrefix(gid)])
+    segCmd.append("--gvcf-bgzf-output")
     segCmd.extend(['--gvcf-min-gqx','15'])
     segCmd.extend(['--gvcf-max-snv-strand-bias','10'])
     segCmd.extend(['-min-qscore','17'])
@@ -144,10 +147,10 @@ def callGenomeSegment(self, gsegGroup, segFiles, taskPrefix="", dependencies=Non
 
     # Empirical Variant Scoring(EVS):
     if self.params.isEVS :
-        if self.params.germlineSnvScoringModelFile is not None :
-            segCmd.extend(['--snv-scoring-model-file', self.params.germlineSnvScoringModelFile])
-        if self.params.germlineIndelScoringModelFile is not None :
-            segCmd.extend(['--indel-scoring-model-file', self.params.germlineIndelScoringModelFile])
+        if scoringModels.snv is not None :
+            segCmd.extend(['--snv-scoring-model-file', scoringModels.snv])
+        if scoringModels.indel is not None :
+            segCmd.extend(['--indel-scoring-model-file', scoringModels.indel])
 
     if self.params.indelErrorModelName is not None :
         segCmd.extend(['--indel-error-model-name',self.params.indelErrorModelName])
@@ -168,9 +171,9 @@ def callGenomeSegment(self, gsegGroup, segFiles, taskPrefix="", dependencies=Non
     if self.params.isHighDepthFilter :
         segCmd.extend(["--chrom-depth-file", self.paths.getChromDepth()])
 
-    # TODO STREL-125 come up with new solution for outbams
+    # realigned reads are written in coordinate order by the caller, to one BAM file per sample:
     if self.params.isWriteRealignedBam :
-        segCmd.extend(["-realigned-read-file", self.paths.getTmpUnsortRealignBamPath(gid)])
+        segCmd.extend(["-realigned-read-file", self.paths.getTmpRealignBamPrefix(gid)])
 
     def addListCmdOption(optList,arg) :
         if optList is None : return
@@ -203,57 +206,19 @@ def callGenomeSegment(self, gsegGroup, segFiles, taskPrefix="", dependencies=Non
     segTaskLabel=preJoin(taskPrefix,"callGenomeSegment_"+gid)
     self.addTask(segTaskLabel,segCmd,dependencies=dependencies,memMb=self.params.callMemMb)
 
-    # clean up and compress genome segment files:
-    nextStepWait = set()
-
-    def compressRawVcf(rawVcfFilename, label) :
-        """
-        process each raw vcf file with header modifications and bgzip compression
-        """
-
-        compressedVariantsPath = rawVcfFilename +".gz"
-        compressCmd = "cat "+quote(rawVcfFilename)
-
-        if isFirstSegment :
-            def getHeaderFixCmd() :
-                cmd  = "\"%s\" -E \"%s\"" % (sys.executable, self.params.vcfCmdlineSwapper)
-                cmd += ' "' + " ".join(self.params.configCommandLine) + '"'
-                return cmd
-            compressCmd += " | " + getHeaderFixCmd()
-
-        compressCmd += " | \"%s\" -c >| \"%s\"" % (self.params.bgzip9Bin, compressedVariantsPath)
-
-        compressTaskLabel=preJoin(taskPrefix,"compressGenomeSegment_"+gid+"_"+label)
-        self.addTask(compressTaskLabel, compressCmd, dependencies=segTaskLabel, memMb=self.params.callMemMb)
-        nextStepWait.add(compressTaskLabel)
-        return compressedVariantsPath
+    # genome segment files are written as BGZF segments by the caller:
+    nextStepWait = set([segTaskLabel])
 
-    rawVariantsPath = self.paths.getTmpSegmentVariantsPath(gid)
-    compressedVariantsPath = compressRawVcf(rawVariantsPath, "variants")
-    segFiles.variants.append(compressedVariantsPath)
+    segFiles.variants.append(self.paths.getTmpSegmentVariantsPath(gid))
 
     sampleCount = len(self.params.bamList)
     for sampleIndex in range(sampleCount) :
-        rawVariantsPath = self.paths.getTmpSegmentGvcfPath(gid, sampleIndex)
-        compressedVariantsPath = compressRawVcf(rawVariantsPath, gvcfSampleLabel(sampleIndex))
-        segFiles.sample[sampleIndex].gvcf.append(compressedVariantsPath)
+        segFiles.sample[sampleIndex].gvcf.append(self.paths.getTmpSegmentGvcfPath(gid, sampleIndex))
 
 
     if self.params.isWriteRealignedBam :
-        def sortRealignBam(sortList) :
-            unsorted = self.paths.getTmpUnsortRealignBamPath(gid)
-            sorted   = self.paths.getTmpRealignBamPath(gid)
-            sortList.append(sorted)
-
-            # adjust sorted to remove the ".bam" suffix
-            sorted = sorted[:-4]
-            sortCmd="\"%s\" sort \"%s\" \"%s\" && rm -f \"%s\"" % (self.params.samtoolsBin,unsorted,sorted,unsorted)
-
-            sortTaskLabel=preJoin(taskPrefix,"sortRealignedSegment_"+gid)
-            self.addTask(sortTaskLabel,sortCmd,dependencies=segTaskLabel,memMb=self.params.callMemMb)
-            nextStepWait.add(sortTaskLabel)
-
-        sortRealignBam(segFiles.bamRealign)
+        for sampleIndex in range(sampleCount) :
+            segFiles.sample[sampleIndex].bamRealign.append(self.paths.getTmpRealignBamPath(gid, sampleIndex))
 
     return nextStepWait
 
@@ -267,13 +232,24 @@ def callGenome(self,taskPrefix="",dependencies=None):
     tmpSegmentDir=self.paths.getTmpSegmentDir()
     dirTask=self.addTask(preJoin(taskPrefix,"makeTmpDir"), getMkdirCmd() + [tmpSegmentDir], dependencies=dependencies, isForceLocal=True)
 
+    scoringModels = ScoringModelFiles()
+    segmentDependencies = set([dirTask])
+    if self.params.isEVS :
+        (scoringModels.snv, convertTasks) = self.convertScoringModel(taskPrefix, dirTask, self.params.germlineSnvScoringModelFile, "snv")
+        segmentDependencies |= convertTasks
+        (scoringModels.indel, convertTasks) = self.convertScoringModel(taskPrefix, dirTask, self.params.germlineIndelScoringModelFile, "indel")
+        segmentDependencies |= convertTasks
+
+    (packedRef, packTasks) = self.packReference(taskPrefix, dirTask)
+    segmentDependencies |= packTasks
+
     segmentTasks = set()
 
     sampleCount = len(self.params.bamList)
 
     segFiles = TempSegmentFiles(sampleCount)
     for gsegGroup in getGenomeSegmentGroups(self.params, excludedContigs = self.params.callContinuousVf) :
-        segmentTasks |= callGenomeSegment(self, gsegGroup, segFiles, dependencies=dirTask)
+        segmentTasks |= callGenomeSegment(self, gsegGroup, segFiles, scoringModels, packedRef, dependencies=segmentDependencies)
 
     if len(segmentTasks) == 0 :
         raise Exception("No genome regions to analyze. Possible target region parse error.")
@@ -284,11 +260,11 @@ def callGenome(self,taskPrefix="",dependencies=None):
     finishTasks = set()
 
     # merge various VCF outputs
-    finishTasks.add(self.concatIndexVcf(taskPrefix, completeSegmentsTask, segFiles.variants,
-                                        self.paths.getVariantsOutputPath(), "variants"))
+    finishTasks.add(self.mergeBgzfSegments(taskPrefix, completeSegmentsTask, segFiles.variants,
+                                           self.paths.getVariantsOutputPath(), "variants"))
     for sampleIndex in range(sampleCount) :
-        concatTask = self.concatIndexVcf(taskPrefix, completeSegmentsTask, segFiles.sample[sampleIndex].gvcf,
-                                         self.paths.getGvcfOutputPath(sampleIndex), gvcfSampleLabel(sampleIndex))
+        concatTask = self.mergeBgzfSegments(taskPrefix, completeSegmentsTask, segFiles.sample[sampleIndex].gvcf,
+                                            self.paths.getGvcfOutputPath(sampleIndex), gvcfSampleLabel(sampleIndex))
         finishTasks.add(concatTask)
         if sampleIndex == 0 :
             outputPath = self.paths.getGvcfOutputPath(sampleIndex)
@@ -308,7 +284,9 @@ def callGenome(self,taskPrefix="",dependencies=None):
             cmd = bamListCatCmd(self.params.samtoolsBin, tmpList, output)
             finishTasks.add(self.addTask(preJoin(taskPrefix,label+"_finalizeBAM"), cmd, dependencies=completeSegmentsTask))
 
-        finishBam(segFiles.bamRealign, self.paths.getRealignedBamPath(), "realigned")
+        for sampleIndex in range(sampleCount) :
+            finishBam(segFiles.sample[sampleIndex].bamRealign, self.paths.getRealignedBamPath(sampleIndex),
+                      "realigned_S%i" % (sampleIndex+1))
 
     if not self.params.isRetainTempFiles :
         rmStatsTmpCmd = getRmdirCmd() + [tmpSegmentDir]
@@ -342,6 +320,9 @@ class CallWorkflow(StrelkaSharedCallWorkflow) :
 
             self.params.knownSize = knownSize
 
+        if self.params.isBalanceSegments :
+            self.readGenomeSegments()
+
         callGenome(self)
 
 
@@ -364,16 +345,19 @@ class PathInfo(SharedPathInfo):
         return os.path.join( self.getTmpSegmentDir(), "segment.%s." % (segStr))
 
     def getTmpSegmentVariantsPath(self, segStr) :
-        return self.getTmpSegmentGvcfPrefix(segStr) + "variants.vcf"
+        return self.getTmpSegmentGvcfPrefix(segStr) + "variants.vcf.gz"
 
     def getTmpSegmentGvcfPath(self, segStr, sampleIndex) :
-        return self.getTmpSegmentGvcfPrefix(segStr) + "genome.S%i.vcf" % (sampleIndex+1)
+        return self.getTmpSegmentGvcfPrefix(segStr) + "genome.S%i.vcf.gz" % (sampleIndex+1)
 
-    def getTmpUnsortRealignBamPath(self, segStr) :
-        return os.path.join( self.getTmpSegmentDir(), "%s.unsorted.realigned.bam" % (segStr))
+    def getTmpRealignBamPrefix(self, segStr) :
+        return os.path.join( self.getTmpSegmentDir(), "%s.realigned" % (segStr))
 
-    def getTmpRealignBamPath(self, segStr,) :
-        return os.path.join( self.getTmpSegmentDir(), "%s.realigned.bam" % (segStr))
+    def getTmpRealignBamPath(self, segStr, sampleIndex) :
+        """
+        the caller appends the sample index and suffix to the realigned read file prefix
+        """
+        return self.getTmpRealignBamPrefix(segStr) + ".S%i.bam" % (sampleIndex)
 
     def getVariantsOutputPath(self) :
         return os.path.join( self.params.variantsDir, "variants.vcf.gz")
@@ -384,8 +368,8 @@ class PathInfo(SharedPathInfo):
     def getGvcfLegacyFilename(self) :
         return "genome.vcf.gz"
 
-    def getRealignedBamPath(self) :
-        return os.path.join( self.params.realignedDir, 'realigned.bam')
+    def getRealignedBamPath(self, sampleIndex) :
+        return os.path.join( self.params.realignedDir, "realigned.S%i.bam" % (sampleIndex+1))
 
 
 
@@ -430,6 +414,7 @@ class StrelkaGermlineWorkflow(StrelkaSharedWorkflow) :
 
         callPreReqs = set()
         callPreReqs |= runCount(self)
+        callPreReqs |= runGenomeSegments(self, self.params.bamList)
         if self.params.isHighDepthFilter :
             callPreReqs |= strelkaGermlineRunDepthFromAlignments(self)
         self.addWorkflowTask("CallGenome", CallWorkflow(self.params, self.paths), dependencies=callPreReqs)
@@ -37,7 +37,7 @@ from configBuildTimeInfo import workflowVersion
 from configureUtil import safeSetBool, getIniSections, dumpIniSections
 from pyflow import WorkflowRunner
 from sharedWorkflow import getMkdirCmd, getRmdirCmd, runDepthFromAlignments
-from strelkaSharedWorkflow import runCount, SharedPathInfo, \
+from strelkaSharedWorkflow import runCount, runGenomeSegments, SharedPathInfo, \
                            StrelkaSharedCallWorkflow, StrelkaSharedWorkflow
 from workflowUtil import checkFile, ensureDir, preJoin, which, \
                          getNextGenomeSegment, bamListCatCmd
@@ -232,6 +232,9 @@ class CallWorkflow(StrelkaSharedCallWorkflow) :
 
             self.params.knownSize = knownSize
 
+        if self.params.isBalanceSegments :
+            self.readGenomeSegments()
+
         callGenome(self)
 
 
@@ -309,6 +312,7 @@ class StrelkaPedigreeWorkflow(StrelkaSharedWorkflow) :
 
         callPreReqs = set()
         callPreReqs |= runCount(self)
+        callPreReqs |= runGenomeSegments(self, self.params.probandBamList + self.params.parentBamList + self.params.siblingBamList)
         if self.params.isHighDepthFilter :
             callPreReqs |= strelkaPedigreeRunDepthFromAlignments(self)
 
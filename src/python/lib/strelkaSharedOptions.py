@@ -94,6 +94,13 @@ class StrelkaSharedWorkflowOptionsBase(ConfigureWorkflowOptions) :
                          help="Disable empirical variant scoring.")
         group.add_option("--reportEVSFeatures", dest="isReportEVSFeatures", action="store_true",
                          help="Report all Empirical Variant Scoring (EVS) features in VCF output.")
+        group.add_option("--packReference", dest="isPackReference", action="store_true",
+                         help="Create a packed copy of the reference at the start of the run, which is shared "
+                              "by all variant calling processes instead of each reading reference sequence "
+                              "from the fasta file.")
+        group.add_option("--balanceSegments", dest="isBalanceSegments", action="store_true",
+                         help="Split the genome into variant calling segments of similar estimated work, based on "
+                              "alignment density from the BAM/CRAM index files, instead of segments of equal length.")
 
         ConfigureWorkflowOptions.addExtendedGroupOptions(self,group)
 
@@ -118,6 +125,10 @@ class StrelkaSharedWorkflowOptionsBase(ConfigureWorkflowOptions) :
 
         countFastaBin=joinFile(libexecDir,exeFile("countFastaBases"))
         getChromDepthBin=joinFile(libexecDir,exeFile("GetChromDepth"))
+        convertScoringModelBin=joinFile(libexecDir,exeFile("ConvertScoringModel"))
+        packReferenceBin=joinFile(libexecDir,exeFile("PackReference"))
+        getGenomeSegmentsBin=joinFile(libexecDir,exeFile("GetGenomeSegments"))
+        mergeBgzfSegmentsBin=joinFile(libexecDir,exeFile("MergeBgzfSegments"))
 
         mergeChromDepth=joinFile(libexecDir,"mergeChromDepth.py")
         catScript=joinFile(libexecDir,"cat.py")
@@ -157,6 +168,10 @@ class StrelkaSharedWorkflowOptionsBase(ConfigureWorkflowOptions) :
 
         isRetainTempFiles = False
 
+        isPackReference = False
+
+        isBalanceSegments = False
+
         # Empirical Variant Scoring:
         isEVS = True
         isReportEVSFeatures = False
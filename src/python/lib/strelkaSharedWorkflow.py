@@ -34,7 +34,7 @@ sys.path.append(os.path.join(scriptDir,"pyflow"))
 
 from pyflow import WorkflowRunner
 from sharedWorkflow import getMvCmd
-from workflowUtil import checkFile, ensureDir, getFastaChromOrderSize, cleanPyEnv, preJoin
+from workflowUtil import checkFile, ensureDir, getFastaChromOrderSize, cleanPyEnv, preJoin, readSegmentEnds
 
 
 
@@ -51,6 +51,38 @@ def runCount(self, taskPrefix="", dependencies=None) :
 
 
 
+def runGenomeSegments(self, bamList, taskPrefix="", dependencies=None) :
+    """
+    split the genome into segments of similar estimated work from the alignment file indexes, no task is added
+    unless balanced segments are enabled
+    """
+    if (not self.params.isBalanceSegments) or (len(bamList) == 0) :
+        return set()
+
+    MEGABASE = 1000000
+    cmd = [self.params.getGenomeSegmentsBin]
+    for bamFile in bamList :
+        cmd.extend(["--align-file", bamFile])
+    cmd.extend(["--segment-size", str(self.params.scanSizeMb * MEGABASE)])
+    cmd.extend(["--output-file", self.paths.getGenomeSegmentsPath()])
+
+    nextStepWait = set()
+    nextStepWait.add(self.addTask(preJoin(taskPrefix,"GenomeSegments"), cmd, dependencies=dependencies, isForceLocal=True))
+
+    return nextStepWait
+
+
+
+class ScoringModelFiles :
+    """
+    scoring model files used by genome segment calls, these are None when no model is used
+    """
+    def __init__(self) :
+        self.snv = None
+        self.indel = None
+
+
+
 class StrelkaSharedCallWorkflow(WorkflowRunner) :
 
     def __init__(self,params) :
@@ -105,6 +137,76 @@ class StrelkaSharedCallWorkflow(WorkflowRunner) :
 
 
 
+    def mergeBgzfSegments(self, taskPrefix, dependencies, inputList, output, label, isReplaceCmdline=True) :
+        """
+        Merge BGZF segment files written directly by the variant callers, and index the merged file from the
+        segment index fragments. No segment records are decompressed.
+        @param inputList BGZF segment files to be merged (in order)
+        @param output output filename
+        @param label used for task id
+        @param isReplaceCmdline if true, replace the segment cmdline in the vcf header with the workflow cmdline
+        """
+        assert(len(inputList) > 0)
+
+        mergeCmd = [self.params.mergeBgzfSegmentsBin]
+        for segmentFile in inputList :
+            mergeCmd.extend(["--segment-file", segmentFile])
+        mergeCmd.extend(["--output-file", output])
+        if isReplaceCmdline :
+            mergeCmd.extend(["--header-cmdline", " ".join(self.params.configCommandLine)])
+        return self.addTask(preJoin(taskPrefix,label+"_mergeSegments"), mergeCmd,
+                            dependencies=dependencies, isForceLocal=True)
+
+
+
+    def convertScoringModel(self, taskPrefix, dependencies, modelFile, label) :
+        """
+        Convert a json scoring model file to the binary scoring model format, so that all genome segment
+        processes share one memory mapped copy of the model instead of each parsing the json file
+        @param modelFile json scoring model file, if None no conversion task is added
+        @param label used for task id and the binary model filename
+        @return tuple of (model file to use for segment calls, set of conversion tasks)
+        """
+        if modelFile is None :
+            return (None, set())
+
+        binaryModelFile=self.paths.getTmpBinaryScoringModelPath(label)
+        convertCmd=[self.params.convertScoringModelBin, "--model-file", modelFile, "--output-file", binaryModelFile]
+        convertTask=self.addTask(preJoin(taskPrefix,"convertScoringModel_"+label), convertCmd,
+                                 dependencies=dependencies, isForceLocal=True)
+        return (binaryModelFile, set([convertTask]))
+
+
+
+    def packReference(self, taskPrefix, dependencies) :
+        """
+        Create a packed copy of the reference, so that all genome segment processes share one memory
+        mapped copy of the reference sequence
+        @return tuple of (packed reference file to use for segment calls, set of packing tasks), the packed
+                reference file is None if the packed reference is not enabled
+        """
+        if not self.params.isPackReference :
+            return (None, set())
+
+        packedRefFile=self.paths.getTmpPackedReferencePath()
+        packCmd=[self.params.packReferenceBin, "--ref", self.params.referenceFasta, "--output-file", packedRefFile]
+        packTask=self.addTask(preJoin(taskPrefix,"packReference"), packCmd,
+                              dependencies=dependencies, isForceLocal=True)
+        return (packedRefFile, set([packTask]))
+
+
+
+    def readGenomeSegments(self) :
+        """
+        set the balanced genome segment ends written by runGenomeSegments, so that all segment iteration
+        follows them
+        """
+        self.params.segmentEnds = None
+        if os.path.isfile(self.paths.getGenomeSegmentsPath()) :
+            self.params.segmentEnds = readSegmentEnds(self.paths.getGenomeSegmentsPath())
+
+
+
     def mergeRunStats(self, taskPrefix, dependencies, runStatsLogPaths) :
         """
         merge run stats:
@@ -136,6 +238,12 @@ class SharedPathInfo(object):
     def getTmpRunStatsPath(self, segStr) :
         return os.path.join( self.getTmpSegmentDir(), "runStats.%s.xml" % (segStr))
 
+    def getTmpBinaryScoringModelPath(self, label) :
+        return os.path.join( self.getTmpSegmentDir(), "scoringModel.%s.bin" % (label))
+
+    def getTmpPackedReferencePath(self) :
+        return os.path.join( self.getTmpSegmentDir(), "reference.packed")
+
     def getRunStatsPath(self) :
         return os.path.join(self.params.statsDir,"runStats.xml")
 
@@ -145,6 +253,9 @@ class SharedPathInfo(object):
     def getRefCountFile(self) :
         return os.path.join( self.params.workDir, "refCount.txt")
 
+    def getGenomeSegmentsPath(self) :
+        return os.path.join( self.params.workDir, "genomeSegments.bed")
+
 
 
 class StrelkaSharedWorkflow(WorkflowRunner) :
@@ -37,7 +37,7 @@ from configBuildTimeInfo import workflowVersion
 from configureUtil import safeSetBool
 from pyflow import WorkflowRunner
 from sharedWorkflow import getMkdirCmd, getRmdirCmd, runDepthFromAlignments
-from strelkaSharedWorkflow import runCount, SharedPathInfo, \
+from strelkaSharedWorkflow import runCount, runGenomeSegments, ScoringModelFiles, SharedPathInfo, \
                            StrelkaSharedCallWorkflow, StrelkaSharedWorkflow
 from workflowUtil import ensureDir, preJoin, \
                          getGenomeSegmentGroups, bamListCatCmd
@@ -72,7 +72,7 @@ class TempSegmentFiles :
 
 
 
-def callGenomeSegment(self, gsegGroup, segFiles, taskPrefix="", dependencies=None) :
+def callGenomeSegment(self, gsegGroup, segFiles, scoringModels, packedRef, taskPrefix="", dependencies=None) :
 
     assert(len(gsegGroup) != 0)
     gid=gsegGroup[0].id
@@ -89,6 +89,8 @@ def callGenomeSegment(self, gsegGroup, segFiles, taskPrefix="", dependencies=Non
     segCmd.extend(["-min-mapping-quality",str(self.params.minTier1Mapq)])
     segCmd.extend(["-min-qscore","0"])
     segCmd.extend(["--ref", self.params.referenceFasta ])
+    if packedRef is not None :
+        segCmd.extend(["--packed-ref", packedRef ])
     segCmd.extend(["-max-window-mismatch", "3", "20" ])
     segCmd.extend(["-genome-size", str(self.params.knownSize)] )
     segCmd.extend(["-max-indel-size", "50"] )
@@ -121,10 +123,10 @@ def callGenomeSegment(self, gsegGroup, segFiles, taskPrefix="", dependencies=Non
     segCmd.extend(["--indel-contam-tolerance", str(self.params.indelContamTolerance) ] )
 
     if self.params.isEVS :
-        if self.params.somaticSnvScoringModelFile is not None :
-            segCmd.extend(['--somatic-snv-scoring-model-file', self.params.somaticSnvScoringModelFile])
-        if self.params.somaticIndelScoringModelFile is not None :
-            segCmd.extend(['--somatic-indel-scoring-model-file', self.params.somaticIndelScoringModelFile])
+        if scoringModels.snv is not None :
+            segCmd.extend(['--somatic-snv-scoring-model-file', scoringModels.snv])
+        if scoringModels.indel is not None :
+            segCmd.extend(['--somatic-indel-scoring-model-file', scoringModels.indel])
 
     if self.params.isReportEVSFeatures :
         segCmd.append("--report-evs-features")
@@ -135,21 +137,21 @@ def callGenomeSegment(self, gsegGroup, segFiles, taskPrefix="", dependencies=Non
         segCmd.extend(["--tumor-align-file", bamPath])
 
     tmpSnvPath = self.paths.getTmpSegmentSnvPath(gid)
-    segFiles.snv.append(tmpSnvPath+".gz")
+    segFiles.snv.append(tmpSnvPath)
     segCmd.extend(["--somatic-snv-file ", tmpSnvPath ] )
 
     tmpIndelPath = self.paths.getTmpSegmentIndelPath(gid)
-    segFiles.indel.append(tmpIndelPath+".gz")
+    segFiles.indel.append(tmpIndelPath)
     segCmd.extend(["--somatic-indel-file", tmpIndelPath ] )
 
     if self.params.isOutputCallableRegions :
         tmpCallablePath = self.paths.getTmpSegmentRegionPath(gid)
-        segFiles.callable.append(tmpCallablePath+".gz")
+        segFiles.callable.append(tmpCallablePath)
         segCmd.extend(["--somatic-callable-regions-file", tmpCallablePath ])
 
     if self.params.isWriteRealignedBam :
-        segCmd.extend(["-realigned-read-file", self.paths.getTmpUnsortRealignBamPath(gid, "normal")])
-        segCmd.extend(["--tumor-realigned-read-file",self.paths.getTmpUnsortRealignBamPath(gid, "tumor")])
+        segCmd.extend(["-realigned-read-file", self.paths.getTmpRealignBamPath(gid, "normal")])
+        segCmd.extend(["--tumor-realigned-read-file",self.paths.getTmpRealignBamPath(gid, "tumor")])
 
     def addListCmdOption(optList,arg) :
         if optList is None : return
@@ -159,6 +161,8 @@ def callGenomeSegment(self, gsegGroup, segFiles, taskPrefix="", dependencies=Non
     addListCmdOption(self.params.indelCandidatesList, '--candidate-indel-input-vcf')
     addListCmdOption(self.params.forcedGTList, '--force-output-vcf')
     addListCmdOption(self.params.noiseVcfList, '--noise-vcf')
+    if self.params.noiseTrack is not None :
+        segCmd.extend(['--noise-track', self.params.noiseTrack])
 
     segFiles.stats.append(self.paths.getTmpRunStatsPath(gid))
     segCmd.extend(["--stats-file", segFiles.stats[-1]])
@@ -180,49 +184,13 @@ def callGenomeSegment(self, gsegGroup, segFiles, taskPrefix="", dependencies=Non
     callTask=preJoin(taskPrefix,"callGenomeSegment_"+gid)
     self.addTask(callTask,segCmd,dependencies=dependencies,memMb=self.params.callMemMb)
 
-    # fix vcf header to use parent pyflow cmdline instead of random segment command:
-    compressWaitFor=callTask
-    if isFirstSegment :
-        headerFixTask=preJoin(taskPrefix,"fixVcfHeader_"+gid)
-        def getHeaderFixCmd(fileName) :
-            tmpName=fileName+".reheader.tmp"
-            cmd  = "\"%s\" -E \"%s\"" % (sys.executable, self.params.vcfCmdlineSwapper)
-            cmd += ' "' + " ".join(self.params.configCommandLine) + '"'
-            cmd += " < \"%s\" > \"%s\" && mv \"%s\" \"%s\"" % (fileName,tmpName,
-                                                               tmpName, fileName)
-            return cmd
-
-        headerFixCmd  = getHeaderFixCmd(tmpSnvPath)
-        headerFixCmd += " && "
-        headerFixCmd += getHeaderFixCmd(tmpIndelPath)
-
-        self.addTask(headerFixTask, headerFixCmd, dependencies=callTask, isForceLocal=True)
-        compressWaitFor=headerFixTask
-
-    compressTask=preJoin(taskPrefix,"compressSegmentOutput_"+gid)
-    compressCmd="\"%s\" \"%s\" && \"%s\" \"%s\"" % (self.params.bgzipBin, tmpSnvPath, self.params.bgzipBin, tmpIndelPath)
-    if self.params.isOutputCallableRegions :
-        compressCmd += " && \"%s\" \"%s\"" % (self.params.bgzipBin, self.paths.getTmpSegmentRegionPath(gid))
-
-    self.addTask(compressTask, compressCmd, dependencies=compressWaitFor, isForceLocal=True)
-    nextStepWait.add(compressTask)
+    # segment output is written as BGZF segments by the caller, vcf headers are updated when segments are merged:
+    nextStepWait.add(callTask)
 
+    # realigned reads are written in coordinate order by the caller:
     if self.params.isWriteRealignedBam :
-        def sortRealignBam(label, sortList) :
-            unsorted = self.paths.getTmpUnsortRealignBamPath(gid, label)
-            sorted   = self.paths.getTmpRealignBamPath(gid, label)
-            sortList.append(sorted)
-
-            # adjust sorted to remove the ".bam" suffix
-            sorted = sorted[:-4]
-            sortCmd="\"%s\" sort \"%s\" \"%s\" && rm -f \"%s\"" % (self.params.samtoolsBin,unsorted,sorted,unsorted)
-
-            sortTaskLabel=preJoin(taskPrefix,"sortRealignedSegment_"+label+"_"+gid)
-            self.addTask(sortTaskLabel,sortCmd,dependencies=callTask,memMb=self.params.callMemMb)
-            nextStepWait.add(sortTaskLabel)
-
-        sortRealignBam("normal", segFiles.normalRealign)
-        sortRealignBam("tumor", segFiles.tumorRealign)
+        segFiles.normalRealign.append(self.paths.getTmpRealignBamPath(gid, "normal"))
+        segFiles.tumorRealign.append(self.paths.getTmpRealignBamPath(gid, "tumor"))
 
     return nextStepWait
 
@@ -236,12 +204,23 @@ def callGenome(self,taskPrefix="",dependencies=None):
     tmpSegmentDir=self.paths.getTmpSegmentDir()
     dirTask=self.addTask(preJoin(taskPrefix,"makeTmpDir"), getMkdirCmd() + [tmpSegmentDir], dependencies=dependencies, isForceLocal=True)
 
+    scoringModels = ScoringModelFiles()
+    segmentDependencies = set([dirTask])
+    if self.params.isEVS :
+        (scoringModels.snv, convertTasks) = self.convertScoringModel(taskPrefix, dirTask, self.params.somaticSnvScoringModelFile, "snv")
+        segmentDependencies |= convertTasks
+        (scoringModels.indel, convertTasks) = self.convertScoringModel(taskPrefix, dirTask, self.params.somaticIndelScoringModelFile, "indel")
+        segmentDependencies |= convertTasks
+
+    (packedRef, packTasks) = self.packReference(taskPrefix, dirTask)
+    segmentDependencies |= packTasks
+
     segmentTasks = set()
 
     segFiles = TempSegmentFiles()
     for gsegGroup in getGenomeSegmentGroups(self.params) :
 
-        segmentTasks |= callGenomeSegment(self, gsegGroup, segFiles, dependencies=dirTask)
+        segmentTasks |= callGenomeSegment(self, gsegGroup, segFiles, scoringModels, packedRef, dependencies=segmentDependencies)
 
     if len(segmentTasks) == 0 :
         raise Exception("No genome regions to analyze. Possible target region parse error.")
@@ -251,17 +230,18 @@ def callGenome(self,taskPrefix="",dependencies=None):
 
     finishTasks = set()
 
-    finishTasks.add(self.concatIndexVcf(taskPrefix, completeSegmentsTask, segFiles.snv,
-                                        self.paths.getSnvOutputPath(),"SNV"))
-    finishTasks.add(self.concatIndexVcf(taskPrefix, completeSegmentsTask, segFiles.indel,
-                                        self.paths.getIndelOutputPath(),"Indel"))
+    finishTasks.add(self.mergeBgzfSegments(taskPrefix, completeSegmentsTask, segFiles.snv,
+                                           self.paths.getSnvOutputPath(),"SNV"))
+    finishTasks.add(self.mergeBgzfSegments(taskPrefix, completeSegmentsTask, segFiles.indel,
+                                           self.paths.getIndelOutputPath(),"Indel"))
 
     # merge segment stats:
     finishTasks.add(self.mergeRunStats(taskPrefix,completeSegmentsTask, segFiles.stats))
 
     if self.params.isOutputCallableRegions :
-        finishTasks.add(self.concatIndexBed(taskPrefix, completeSegmentsTask, segFiles.callable,
-                                            self.paths.getRegionOutputPath(), "callableRegions"))
+        finishTasks.add(self.mergeBgzfSegments(taskPrefix, completeSegmentsTask, segFiles.callable,
+                                               self.paths.getRegionOutputPath(), "callableRegions",
+                                               isReplaceCmdline=False))
 
     if self.params.isWriteRealignedBam :
         def finishBam(tmpList, output, label) :
@@ -303,6 +283,9 @@ class CallWorkflow(StrelkaSharedCallWorkflow) :
 
             self.params.knownSize = knownSize
 
+        if self.params.isBalanceSegments :
+            self.readGenomeSegments()
+
         callGenome(self)
 
 
@@ -316,16 +299,13 @@ class PathInfo(SharedPathInfo):
         super(PathInfo,self).__init__(params)
 
     def getTmpSegmentSnvPath(self, segStr) :
-        return os.path.join( self.getTmpSegmentDir(), "somatic.snvs.unfiltered.%s.vcf" % (segStr))
+        return os.path.join( self.getTmpSegmentDir(), "somatic.snvs.unfiltered.%s.vcf.gz" % (segStr))
 
     def getTmpSegmentIndelPath(self, segStr) :
-        return os.path.join( self.getTmpSegmentDir(), "somatic.indels.unfiltered.%s.vcf" % (segStr))
+        return os.path.join( self.getTmpSegmentDir(), "somatic.indels.unfiltered.%s.vcf.gz" % (segStr))
 
     def getTmpSegmentRegionPath(self, segStr) :
-        return os.path.join( self.getTmpSegmentDir(), "somatic.callable.regions.%s.bed" % (segStr))
-
-    def getTmpUnsortRealignBamPath(self, segStr, label) :
-        return os.path.join( self.getTmpSegmentDir(), "%s.%s.unsorted.realigned.bam" % (label, segStr))
+        return os.path.join( self.getTmpSegmentDir(), "somatic.callable.regions.%s.bed.gz" % (segStr))
 
     def getTmpRealignBamPath(self, segStr, label) :
         return os.path.join( self.getTmpSegmentDir(), "%s.%s.realigned.bam" % (label, segStr))
@@ -384,6 +364,7 @@ class StrelkaSomaticWorkflow(StrelkaSharedWorkflow) :
 
         callPreReqs = set()
         callPreReqs |= runCount(self)
+        callPreReqs |= runGenomeSegments(self, self.params.normalBamList + self.params.tumorBamList)
         if self.params.isHighDepthFilter :
             callPreReqs |= strelkaSomaticRunDepthFromAlignments(self)
 
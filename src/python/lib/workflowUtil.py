@@ -181,13 +181,15 @@ def getFastaChromOrderSize(faiFile) :
 
 
 
-def getChromIntervals(chromOrder,chromSizes,segmentSize, genomeRegion = None) :
+def getChromIntervals(chromOrder,chromSizes,segmentSize, genomeRegion = None, segmentEnds = None) :
     """
     generate chromosome intervals no greater than segmentSize
 
     chromOrder - iterable object of chromosome names
     chromSizes - a hash of chrom sizes
     genomeRegionList - optionally restrict chrom intervals to only cover a list of specified chromosome region
+    segmentEnds - optional hash of sorted segment end positions (1-indexed) for each chromosome, if provided the
+                  intervals of each listed chromosome are cut at these positions instead of split by segmentSize
 
     return chromIndex,chromLabel,start,end,chromSegment
     where start and end are formated for use with samtools
@@ -207,6 +209,15 @@ def getChromIntervals(chromOrder,chromSizes,segmentSize, genomeRegion = None) :
                 if genomeRegion["end"] is not None :
                     chromEnd=genomeRegion["end"]
 
+        if (segmentEnds is not None) and (chromLabel in segmentEnds) :
+            ends = [end for end in segmentEnds[chromLabel] if (end >= chromStart) and (end < chromEnd)]
+            ends.append(chromEnd)
+            start=chromStart
+            for (i, end) in enumerate(ends) :
+                yield (chromIndex,chromLabel,start,end,i,genomeRegion)
+                start=end+1
+            continue
+
         chromSize=(chromEnd-chromStart+1)
         chromSegments=1+((chromSize-1)/segmentSize)
         segmentBaseSize=chromSize/chromSegments
@@ -220,6 +231,25 @@ def getChromIntervals(chromOrder,chromSizes,segmentSize, genomeRegion = None) :
             start=end+1
 
 
+def readSegmentEnds(filename) :
+    """
+    read the genome segments written by GetGenomeSegments
+
+    return a hash of the sorted segment end positions (1-indexed) for each chromosome
+    """
+    segmentEnds = {}
+    for line in open(filename) :
+        word = line.strip().split('\t')
+        if len(word) != 3 :
+            raise Exception("Unexpected format in genome segment file: '%s'" % (filename))
+        # the zero-indexed half-open bed end is equal to the 1-indexed closed end:
+        segmentEnds.setdefault(word[0], []).append(int(word[2]))
+    for ends in segmentEnds.values() :
+        ends.sort()
+    return segmentEnds
+
+
+
 class PathDigger(object) :
     """
     Digs into a well-defined directory structure with prefixed
@@ -321,13 +351,14 @@ def getNextGenomeSegment(params) :
     """
     MEGABASE = 1000000
     scanSize = params.scanSizeMb * MEGABASE
+    segmentEnds = getattr(params, "segmentEnds", None)
 
     if params.genomeRegionList is None :
-        for segval in getChromIntervals(params.chromOrder,params.chromSizes, scanSize) :
+        for segval in getChromIntervals(params.chromOrder,params.chromSizes, scanSize, segmentEnds=segmentEnds) :
             yield GenomeSegment(*segval)
     else :
         for genomeRegion in params.genomeRegionList :
-            for segval in getChromIntervals(params.chromOrder,params.chromSizes, scanSize, genomeRegion) :
+            for segval in getChromIntervals(params.chromOrder,params.chromSizes, scanSize, genomeRegion, segmentEnds) :
                 yield GenomeSegment(*segval)
 
 